@@ -0,0 +1,696 @@
+/****************************************************************************
+ * cansat_apps/flightrec/flightrec.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <ringbuffer/ringbuffer.h>
+
+#include "flightrec.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLIGHTREC_MAX_CHANNELS  CONFIG_CANSAT_APPS_FLIGHTREC_MAX_CHANNELS
+#define FLIGHTREC_BLOCK_SIZE    CONFIG_CANSAT_APPS_FLIGHTREC_BLOCK_SIZE
+
+#define FLIGHTREC_HDR_SIZE      sizeof(struct flightrec_hdr_s)
+
+/* Partial blocks are flushed up to the next sector boundary only */
+
+#define FLIGHTREC_SECTOR_SIZE   512
+
+#if FLIGHTREC_BLOCK_SIZE % FLIGHTREC_SECTOR_SIZE != 0
+#  error "CONFIG_CANSAT_APPS_FLIGHTREC_BLOCK_SIZE must be a multiple of 512"
+#endif
+
+#define ALIGN_UP(n)             (((n) + FLIGHTREC_ALIGN - 1) & \
+                                 ~(FLIGHTREC_ALIGN - 1))
+
+#ifndef MIN
+#  define MIN(a,b)  (((a) < (b)) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct flightrec_channel_s
+{
+  struct ringbuf_spsc_s ring;
+  uint32_t records;            /* Updated by the producer only */
+  uint32_t dropped;            /* Updated by the producer only */
+};
+
+struct flightrec_s
+{
+  pthread_mutex_t lock;        /* Channel table and statistics */
+  pthread_t writer;
+  volatile bool running;
+  int fd;
+  off_t offset;                /* File offset of block */
+
+  /* Owned by the writer thread.  Records are moved into the block under
+   * the lock, which is dropped before the block is written.
+   */
+
+  FAR uint8_t *block;
+  size_t fill;                 /* Bytes used in block */
+  size_t limit;                /* Bytes up to the next block boundary */
+  size_t pending;              /* Bytes of a record split by a boundary */
+  FAR struct flightrec_channel_s *pending_ch;
+  int next;                    /* Channel to drain first */
+  uint64_t last_flush;         /* us */
+  struct flightrec_stats_s stats;
+  FAR struct flightrec_channel_s *channels[FLIGHTREC_MAX_CHANNELS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct flightrec_s g_flightrec =
+{
+  PTHREAD_MUTEX_INITIALIZER,
+};
+
+static const uint8_t g_zero[FLIGHTREC_ALIGN];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flightrec_now_us
+ ****************************************************************************/
+
+static uint64_t flightrec_now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: flightrec_write_block
+ *
+ * Description:
+ *   Write the used part of the block buffer.  Called without the lock, so
+ *   a slow card neither blocks channel open and close nor statistics; the
+ *   producers never take the lock and only see their rings fill up.
+ *
+ *   After a partial flush the next block is cut short so that full blocks
+ *   keep ending at multiples of FLIGHTREC_BLOCK_SIZE in the file.
+ *
+ ****************************************************************************/
+
+static void flightrec_write_block(FAR struct flightrec_s *priv)
+{
+  FAR struct flightrec_stats_s *stats = &priv->stats;
+  uint64_t start;
+  uint32_t elapsed;
+  uint32_t ms;
+  int bucket;
+  ssize_t ret;
+
+  if (priv->fill > 0)
+    {
+      start = flightrec_now_us();
+      ret = write(priv->fd, priv->block, priv->fill);
+      elapsed = (uint32_t)(flightrec_now_us() - start);
+
+      for (bucket = 0, ms = elapsed / 1000;
+           ms > 0 && bucket < FLIGHTREC_LATENCY_BUCKETS - 1;
+           ms >>= 1)
+        {
+          bucket++;
+        }
+
+      pthread_mutex_lock(&priv->lock);
+
+      if (ret != (ssize_t)priv->fill)
+        {
+          stats->errors++;
+        }
+      else
+        {
+          stats->blocks++;
+        }
+
+      stats->latency_hist[bucket]++;
+      if (elapsed > stats->latency_max_us)
+        {
+          stats->latency_max_us = elapsed;
+        }
+
+      pthread_mutex_unlock(&priv->lock);
+
+      if (ret > 0)
+        {
+          priv->offset += ret;
+        }
+    }
+
+  priv->fill  = 0;
+  priv->limit = FLIGHTREC_BLOCK_SIZE - priv->offset % FLIGHTREC_BLOCK_SIZE;
+  priv->last_flush = flightrec_now_us();
+}
+
+/****************************************************************************
+ * Name: flightrec_copy
+ *
+ * Description:
+ *   Move up to count bytes from a ring into the block, or zeros if the ring
+ *   is gone or has less.  Returns the number of bytes which did not fit.
+ *
+ ****************************************************************************/
+
+static size_t flightrec_copy(FAR struct flightrec_s *priv,
+                             FAR struct ringbuf_spsc_s *ring, size_t count)
+{
+  size_t chunk = MIN(count, priv->limit - priv->fill);
+  ssize_t got = 0;
+
+  if (ring)
+    {
+      got = ringbuf_spsc_read(ring, priv->block + priv->fill, chunk);
+      if (got < 0)
+        {
+          got = 0;
+        }
+    }
+
+  /* The record was complete in the ring, but keep the length its header
+   * announces on a short read, so the stream stays in sync.
+   */
+
+  memset(priv->block + priv->fill + got, 0, chunk - got);
+
+  priv->fill += chunk;
+  return count - chunk;
+}
+
+/****************************************************************************
+ * Name: flightrec_drain
+ *
+ * Description:
+ *   Move complete records of a channel into the block until it is full.
+ *   Returns false if the block is full.
+ *
+ ****************************************************************************/
+
+static bool flightrec_drain(FAR struct flightrec_s *priv,
+                            FAR struct flightrec_channel_s *ch)
+{
+  FAR struct flightrec_hdr_s *hdr;
+  FAR uint8_t *span;
+  size_t stored;
+
+  /* Records are 8 byte aligned in a ring whose size is a multiple of 8, so
+   * a header never wraps and can be looked at in place.
+   */
+
+  while (priv->fill < priv->limit &&
+         ringbuf_spsc_peek(&ch->ring, &span) >= FLIGHTREC_HDR_SIZE)
+    {
+      hdr = (FAR struct flightrec_hdr_s *)span;
+      stored = FLIGHTREC_HDR_SIZE + ALIGN_UP(hdr->len);
+
+      /* The producer publishes header, payload and padding separately,
+       * leave the record until it is complete.
+       */
+
+      if (ringbuf_spsc_bytesused(&ch->ring) < stored)
+        {
+          break;
+        }
+
+      priv->pending = flightrec_copy(priv, &ch->ring, stored);
+      priv->pending_ch = ch;
+    }
+
+  return priv->fill < priv->limit;
+}
+
+/****************************************************************************
+ * Name: flightrec_fill
+ *
+ * Description:
+ *   Finish a record split by the last block boundary, then drain the
+ *   channels round robin.  Called with the lock held.  Returns true if the
+ *   block is full and must be written before draining more.
+ *
+ ****************************************************************************/
+
+static bool flightrec_fill(FAR struct flightrec_s *priv)
+{
+  FAR struct flightrec_channel_s *ch;
+  int i;
+
+  if (priv->pending > 0)
+    {
+      ch = priv->pending_ch;
+      priv->pending = flightrec_copy(priv, ch ? &ch->ring : NULL,
+                                     priv->pending);
+      if (priv->pending > 0)
+        {
+          return true;
+        }
+    }
+
+  for (i = 0; i < FLIGHTREC_MAX_CHANNELS; i++)
+    {
+      ch = priv->channels[priv->next];
+      if (ch && !flightrec_drain(priv, ch))
+        {
+          return true;
+        }
+
+      priv->next = (priv->next + 1) % FLIGHTREC_MAX_CHANNELS;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: flightrec_pad
+ *
+ * Description:
+ *   Pad a partial block up to the next sector boundary of the file with a
+ *   single padding record.
+ *
+ ****************************************************************************/
+
+static void flightrec_pad(FAR struct flightrec_s *priv)
+{
+  FAR struct flightrec_hdr_s *hdr;
+  size_t remain;
+
+  remain = (priv->offset + priv->fill) % FLIGHTREC_SECTOR_SIZE;
+  if (remain == 0)
+    {
+      return;
+    }
+
+  /* A file which did not end on a record boundary can not be aligned */
+
+  remain = (FLIGHTREC_SECTOR_SIZE - remain) & ~(FLIGHTREC_ALIGN - 1);
+  if (remain == 0)
+    {
+      return;
+    }
+
+  hdr = (FAR struct flightrec_hdr_s *)(priv->block + priv->fill);
+  hdr->tag       = FLIGHTREC_TAG_PAD;
+  hdr->len       = (uint16_t)(remain - FLIGHTREC_HDR_SIZE);
+  hdr->timestamp = 0;
+  memset(hdr + 1, 0, remain - FLIGHTREC_HDR_SIZE);
+
+  priv->fill += remain;
+}
+
+/****************************************************************************
+ * Name: flightrec_sample
+ *
+ * Description:
+ *   Add the peak ring fill level to the histogram.  Called with the lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void flightrec_sample(FAR struct flightrec_s *priv)
+{
+  FAR struct flightrec_channel_s *ch;
+  unsigned int peak = 0;
+  unsigned int level;
+  int i;
+
+  for (i = 0; i < FLIGHTREC_MAX_CHANNELS; i++)
+    {
+      ch = priv->channels[i];
+      if (!ch)
+        {
+          continue;
+        }
+
+      level = ringbuf_spsc_bytesused(&ch->ring) * FLIGHTREC_FILL_BUCKETS /
+              (ch->ring.mask + 1);
+      if (level > peak)
+        {
+          peak = level;
+        }
+    }
+
+  priv->stats.fill_hist[MIN(peak, FLIGHTREC_FILL_BUCKETS - 1)]++;
+}
+
+/****************************************************************************
+ * Name: flightrec_pass
+ ****************************************************************************/
+
+static void flightrec_pass(FAR struct flightrec_s *priv, bool flush)
+{
+  bool full;
+
+  pthread_mutex_lock(&priv->lock);
+  flightrec_sample(priv);
+
+  for (; ; )
+    {
+      full = flightrec_fill(priv);
+      if (!full)
+        {
+          if (!flush && flightrec_now_us() - priv->last_flush <
+              CONFIG_CANSAT_APPS_FLIGHTREC_FLUSH_MS * 1000ull)
+            {
+              break;
+            }
+
+          flightrec_pad(priv);
+        }
+
+      pthread_mutex_unlock(&priv->lock);
+
+      flightrec_write_block(priv);
+      if (!full)
+        {
+          return;
+        }
+
+      pthread_mutex_lock(&priv->lock);
+    }
+
+  pthread_mutex_unlock(&priv->lock);
+}
+
+/****************************************************************************
+ * Name: flightrec_writer
+ ****************************************************************************/
+
+static FAR void *flightrec_writer(FAR void *arg)
+{
+  FAR struct flightrec_s *priv = (FAR struct flightrec_s *)arg;
+
+  while (priv->running)
+    {
+      flightrec_pass(priv, false);
+      usleep(CONFIG_CANSAT_APPS_FLIGHTREC_POLL_MS * 1000);
+    }
+
+  flightrec_pass(priv, true);
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flightrec_start
+ ****************************************************************************/
+
+int flightrec_start(FAR const char *path)
+{
+  FAR struct flightrec_s *priv = &g_flightrec;
+  struct sched_param param;
+  pthread_attr_t attr;
+  int ret;
+
+  if (priv->running)
+    {
+      return -EBUSY;
+    }
+
+  priv->block = (FAR uint8_t *)memalign(FLIGHTREC_ALIGN,
+                                        FLIGHTREC_BLOCK_SIZE);
+  if (!priv->block)
+    {
+      return -ENOMEM;
+    }
+
+  priv->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0666);
+  if (priv->fd < 0)
+    {
+      ret = -errno;
+      free(priv->block);
+      priv->block = NULL;
+      return ret;
+    }
+
+  priv->offset = lseek(priv->fd, 0, SEEK_END);
+  if (priv->offset < 0)
+    {
+      priv->offset = 0;
+    }
+
+  priv->fill       = 0;
+  priv->limit      = FLIGHTREC_BLOCK_SIZE -
+                     priv->offset % FLIGHTREC_BLOCK_SIZE;
+  priv->pending    = 0;
+  priv->pending_ch = NULL;
+  priv->last_flush = flightrec_now_us();
+  priv->running    = true;
+
+  pthread_attr_init(&attr);
+  param.sched_priority = CONFIG_CANSAT_APPS_FLIGHTREC_PRIORITY;
+  pthread_attr_setschedparam(&attr, &param);
+  pthread_attr_setstacksize(&attr, CONFIG_CANSAT_APPS_FLIGHTREC_STACKSIZE);
+
+  ret = pthread_create(&priv->writer, &attr, flightrec_writer, priv);
+  if (ret != 0)
+    {
+      priv->running = false;
+      close(priv->fd);
+      free(priv->block);
+      priv->block = NULL;
+      return -ret;
+    }
+
+  pthread_setname_np(priv->writer, "flightrec");
+  return 0;
+}
+
+/****************************************************************************
+ * Name: flightrec_stop
+ ****************************************************************************/
+
+void flightrec_stop(void)
+{
+  FAR struct flightrec_s *priv = &g_flightrec;
+
+  if (!priv->running)
+    {
+      return;
+    }
+
+  priv->running = false;
+  pthread_join(priv->writer, NULL);
+
+  fsync(priv->fd);
+  close(priv->fd);
+  free(priv->block);
+  priv->block = NULL;
+}
+
+/****************************************************************************
+ * Name: flightrec_channel_open
+ ****************************************************************************/
+
+FAR struct flightrec_channel_s *flightrec_channel_open(size_t size)
+{
+  FAR struct flightrec_s *priv = &g_flightrec;
+  FAR struct flightrec_channel_s *ch;
+  FAR void *buf;
+  int i;
+
+  if (size < FLIGHTREC_HDR_SIZE || (size & (size - 1)) != 0)
+    {
+      return NULL;
+    }
+
+  ch = (FAR struct flightrec_channel_s *)
+       calloc(1, sizeof(struct flightrec_channel_s));
+  buf = memalign(FLIGHTREC_ALIGN, size);
+  if (!ch || !buf || ringbuf_spsc_init(&ch->ring, buf, size) < 0)
+    {
+      free(buf);
+      free(ch);
+      return NULL;
+    }
+
+  pthread_mutex_lock(&priv->lock);
+
+  for (i = 0; i < FLIGHTREC_MAX_CHANNELS; i++)
+    {
+      if (!priv->channels[i])
+        {
+          priv->channels[i] = ch;
+          break;
+        }
+    }
+
+  pthread_mutex_unlock(&priv->lock);
+
+  if (i == FLIGHTREC_MAX_CHANNELS)
+    {
+      free(buf);
+      free(ch);
+      return NULL;
+    }
+
+  return ch;
+}
+
+/****************************************************************************
+ * Name: flightrec_channel_close
+ ****************************************************************************/
+
+void flightrec_channel_close(FAR struct flightrec_channel_s *ch)
+{
+  FAR struct flightrec_s *priv = &g_flightrec;
+  int i;
+
+  pthread_mutex_lock(&priv->lock);
+
+  for (i = 0; i < FLIGHTREC_MAX_CHANNELS; i++)
+    {
+      if (priv->channels[i] == ch)
+        {
+          priv->channels[i] = NULL;
+
+          /* The rest of a record split by a block boundary goes with the
+           * ring, the writer completes it with zeros.
+           */
+
+          if (priv->pending_ch == ch)
+            {
+              priv->pending_ch = NULL;
+            }
+
+          /* Keep the counters of closed channels in the totals */
+
+          priv->stats.records += ch->records;
+          priv->stats.dropped += ch->dropped;
+          break;
+        }
+    }
+
+  pthread_mutex_unlock(&priv->lock);
+
+  if (i < FLIGHTREC_MAX_CHANNELS)
+    {
+      free(ch->ring.buf);
+      free(ch);
+    }
+}
+
+/****************************************************************************
+ * Name: flightrec_append
+ ****************************************************************************/
+
+int flightrec_append(FAR struct flightrec_channel_s *ch, uint16_t tag,
+                     FAR const void *data, uint16_t len)
+{
+  struct flightrec_hdr_s hdr;
+  struct timespec ts;
+  size_t pad;
+
+  if (len > FLIGHTREC_MAX_PAYLOAD || tag == FLIGHTREC_TAG_PAD)
+    {
+      return -EINVAL;
+    }
+
+  pad = ALIGN_UP(len) - len;
+  if (ringbuf_spsc_bytesavail(&ch->ring) < FLIGHTREC_HDR_SIZE + len + pad)
+    {
+      ch->dropped++;
+      return -ENOSPC;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  hdr.tag       = tag;
+  hdr.len       = len;
+  hdr.timestamp = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+
+  /* Space was checked above and only this producer writes the ring, so
+   * none of these can fail.
+   */
+
+  ringbuf_spsc_write(&ch->ring, &hdr, FLIGHTREC_HDR_SIZE);
+  ringbuf_spsc_write(&ch->ring, data, len);
+  ringbuf_spsc_write(&ch->ring, g_zero, pad);
+
+  ch->records++;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: flightrec_channel_fill
+ ****************************************************************************/
+
+unsigned int flightrec_channel_fill(FAR struct flightrec_channel_s *ch)
+{
+  return ringbuf_spsc_bytesused(&ch->ring) * 100 / (ch->ring.mask + 1);
+}
+
+/****************************************************************************
+ * Name: flightrec_get_stats
+ ****************************************************************************/
+
+void flightrec_get_stats(FAR struct flightrec_stats_s *stats)
+{
+  FAR struct flightrec_s *priv = &g_flightrec;
+  FAR struct flightrec_channel_s *ch;
+  int i;
+
+  /* The writer never holds the lock across a write, so a snapshot taken
+   * here only waits for records being moved into the block.
+   */
+
+  pthread_mutex_lock(&priv->lock);
+
+  *stats = priv->stats;
+  for (i = 0; i < FLIGHTREC_MAX_CHANNELS; i++)
+    {
+      ch = priv->channels[i];
+      if (ch)
+        {
+          stats->records += ch->records;
+          stats->dropped += ch->dropped;
+        }
+    }
+
+  pthread_mutex_unlock(&priv->lock);
+}
@@ -0,0 +1,183 @@
+/****************************************************************************
+ * cansat_apps/flightrec/flightrec.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_FLIGHTREC_FLIGHTREC_H
+#define __CANSAT_APPS_FLIGHTREC_FLIGHTREC_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* On storage every record is an 8 byte header followed by the payload,
+ * padded to a multiple of 8 bytes.  Blocks flushed before they are full
+ * are completed up to the next 512 byte sector with a single
+ * FLIGHTREC_TAG_PAD record.
+ */
+
+#define FLIGHTREC_ALIGN          8
+#define FLIGHTREC_TAG_PAD        0xffff
+#define FLIGHTREC_MAX_PAYLOAD    (UINT16_MAX - FLIGHTREC_ALIGN)
+
+/* Write latency histogram: bucket n counts writes that took less than
+ * 2^n ms, the last bucket collects everything slower.
+ */
+
+#define FLIGHTREC_LATENCY_BUCKETS 12
+
+/* Fill level histogram: peak staging ring fill sampled on every writer
+ * pass, in 1/8 steps of the ring size.
+ */
+
+#define FLIGHTREC_FILL_BUCKETS    8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct flightrec_hdr_s
+{
+  uint16_t tag;        /* Producer defined, FLIGHTREC_TAG_PAD is reserved */
+  uint16_t len;        /* Payload length, without padding */
+  uint32_t timestamp;  /* ms since boot */
+};
+
+struct flightrec_channel_s;
+
+struct flightrec_stats_s
+{
+  uint32_t records;     /* Records accepted from producers */
+  uint32_t dropped;     /* Records refused because a ring was full */
+  uint32_t blocks;      /* Blocks written */
+  uint32_t errors;      /* Failed block writes */
+  uint32_t latency_hist[FLIGHTREC_LATENCY_BUCKETS];
+  uint32_t fill_hist[FLIGHTREC_FILL_BUCKETS];
+  uint32_t latency_max_us;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: flightrec_start
+ *
+ * Description:
+ *   Open (create or append to) path and start the writer thread.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int flightrec_start(FAR const char *path);
+
+/****************************************************************************
+ * Name: flightrec_stop
+ *
+ * Description:
+ *   Drain every channel, write the last partial block and close the file.
+ *   Channels stay registered and can be reused after the next start.
+ *
+ ****************************************************************************/
+
+void flightrec_stop(void);
+
+/****************************************************************************
+ * Name: flightrec_channel_open
+ *
+ * Description:
+ *   Register a producer.  Each channel is a single producer ring: a task,
+ *   ISR or callback must own its channel and never share it.
+ *
+ * Input Parameters:
+ *   size - Staging ring size, a power of two and a multiple of 8.
+ *
+ * Returned Value:
+ *   The channel, or NULL if no slot or memory is left.
+ *
+ ****************************************************************************/
+
+FAR struct flightrec_channel_s *flightrec_channel_open(size_t size);
+
+/****************************************************************************
+ * Name: flightrec_channel_close
+ *
+ * Description:
+ *   Unregister a producer.  Records not yet drained are lost.
+ *
+ ****************************************************************************/
+
+void flightrec_channel_close(FAR struct flightrec_channel_s *ch);
+
+/****************************************************************************
+ * Name: flightrec_append
+ *
+ * Description:
+ *   Append one record.  O(1), never blocks and may be called from an
+ *   interrupt handler as long as the channel belongs to it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the staging ring is full, the record
+ *   is counted as dropped in that case.
+ *
+ ****************************************************************************/
+
+int flightrec_append(FAR struct flightrec_channel_s *ch, uint16_t tag,
+                     FAR const void *data, uint16_t len);
+
+/****************************************************************************
+ * Name: flightrec_channel_fill
+ *
+ * Returned Value:
+ *   Current fill level of the channel ring in percent.
+ *
+ ****************************************************************************/
+
+unsigned int flightrec_channel_fill(FAR struct flightrec_channel_s *ch);
+
+/****************************************************************************
+ * Name: flightrec_get_stats
+ ****************************************************************************/
+
+void flightrec_get_stats(FAR struct flightrec_stats_s *stats);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_FLIGHTREC_FLIGHTREC_H */
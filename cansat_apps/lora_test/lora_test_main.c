@@ -24,8 +24,19 @@
 
 #include <nuttx/config.h>
 #include <stdio.h>
-#include <assert.h>
-#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "telemetry.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LORA_TEST_FRAME_TYPE    0x01
+#define LORA_TEST_PAYLOAD_SIZE  24
+#define LORA_TEST_DEFAULT_COUNT 50
 
 /****************************************************************************
  * Public Functions
@@ -36,26 +47,67 @@
  ****************************************************************************/
 
 /*
- * Test SPI driver before writing a stable library
- * library will offer a fast and easy way to use rfm95 device.
+ * Push a burst of frames through the telemetry daemon.  If the queue keeps
+ * the radio fed, busy time equals the summed airtime of the frames.
  */
 int main(int argc, FAR char *argv[])
 {
-  printf("RFM95 driver test app\n");
+  struct telemetry_stats_s stats;
+  uint8_t payload[LORA_TEST_PAYLOAD_SIZE];
+  int count = LORA_TEST_DEFAULT_COUNT;
+  int queued = 0;
+  int ret;
+
+  if (argc > 1)
+    {
+      count = atoi(argv[1]);
+    }
+
+  printf("RFM95 telemetry test, %d frames\n", count);
+
+  ret = telemetry_start();
+  if (ret < 0)
+    {
+      printf("telemetry_start failed: %d\n", ret);
+      return EXIT_FAILURE;
+    }
+
+  memset(payload, 0x55, sizeof(payload));
+  while (queued < count)
+    {
+      payload[0] = (uint8_t)queued;
+      if (telemetry_send(LORA_TEST_FRAME_TYPE, payload, sizeof(payload)) < 0)
+        {
+          /* Queue full, give the radio a slot time */
+
+          usleep(10000);
+          continue;
+        }
 
-  /* Open SPI Test Driver */
+      queued++;
+    }
 
-  int fd = open("/dev/radio0", O_RDWR);
-  assert(fd >= 0);
+  do
+    {
+      usleep(100000);
+      telemetry_get_stats(&stats);
+    }
+  while (stats.sent + stats.timeouts + 1 < stats.queued);
 
-  /* Write to SPI Test Driver */
+  telemetry_stop();
+  telemetry_get_stats(&stats);
 
-  static char data[] = "Ciao RFM95"; /* Maybe send something more meaningfull.. */
-  int bytes_written = write(fd, data, sizeof(data));
-  assert(bytes_written == sizeof(data));
+  printf("queued %lu sent %lu dropped %lu timeouts %lu\n",
+         (unsigned long)stats.queued, (unsigned long)stats.sent,
+         (unsigned long)stats.dropped, (unsigned long)stats.timeouts);
 
-  /* Close SPI Test Driver */
+  if (stats.busy_us)
+    {
+      printf("airtime %lu us busy %lu us duty %lu%%\n",
+             (unsigned long)stats.airtime_us, (unsigned long)stats.busy_us,
+             (unsigned long)((uint64_t)stats.airtime_us * 100 /
+                             stats.busy_us));
+    }
 
-  close(fd);
-  return 0;
-}
\ No newline at end of file
+  return stats.timeouts ? EXIT_FAILURE : EXIT_SUCCESS;
+}
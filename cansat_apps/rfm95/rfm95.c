@@ -0,0 +1,445 @@
+/****************************************************************************
+ * cansat_apps/rfm95/rfm95.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <arch/board/board.h>
+#include <arch/chip/pin.h>
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "rfm95.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_CANSAT_APPS_RFM95_SPI_FREQUENCY
+#  define CONFIG_CANSAT_APPS_RFM95_SPI_FREQUENCY 8000000
+#endif
+
+#define RFM95_SPI_WRITE         0x80
+
+/* Register map (LoRa mode) */
+
+#define RFM95_REG_FIFO          0x00
+#define RFM95_REG_OPMODE        0x01
+#define RFM95_REG_FRF_MSB       0x06
+#define RFM95_REG_FRF_MID       0x07
+#define RFM95_REG_FRF_LSB       0x08
+#define RFM95_REG_PACONFIG      0x09
+#define RFM95_REG_FIFOADDRPTR   0x0d
+#define RFM95_REG_FIFOTXBASE    0x0e
+#define RFM95_REG_FIFORXBASE    0x0f
+#define RFM95_REG_IRQFLAGSMASK  0x11
+#define RFM95_REG_IRQFLAGS      0x12
+#define RFM95_REG_MODEMCONFIG1  0x1d
+#define RFM95_REG_MODEMCONFIG2  0x1e
+#define RFM95_REG_PREAMBLEMSB   0x20
+#define RFM95_REG_PREAMBLELSB   0x21
+#define RFM95_REG_PAYLOADLEN    0x22
+#define RFM95_REG_MODEMCONFIG3  0x26
+#define RFM95_REG_DIOMAPPING1   0x40
+#define RFM95_REG_VERSION       0x42
+#define RFM95_REG_PADAC         0x4d
+
+#define RFM95_OPMODE_LORA       0x80
+#define RFM95_OPMODE_SLEEP      0x00
+#define RFM95_OPMODE_STDBY      0x01
+#define RFM95_OPMODE_TX         0x03
+
+#define RFM95_IRQ_TXDONE        0x08
+#define RFM95_DIO0_TXDONE       0x40
+#define RFM95_PA_BOOST          0x80
+#define RFM95_LOWDATARATE       0x08
+#define RFM95_AGC_AUTO          0x04
+
+#define RFM95_VERSION           0x12
+#define RFM95_FXOSC             32000000ull
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* board_gpio_intconfig() handlers do not receive an argument, so the
+ * instance that owns DIO0 is kept here.
+ */
+
+static FAR struct rfm95_dev_s *g_rfm95;
+
+static const uint32_t g_bw_hz[] =
+{
+  7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rfm95_lock
+ ****************************************************************************/
+
+static void rfm95_lock(FAR struct spi_dev_s *spi)
+{
+  SPI_LOCK(spi, true);
+  SPI_SETMODE(spi, SPIDEV_MODE0);
+  SPI_SETBITS(spi, 8);
+  SPI_SETFREQUENCY(spi, CONFIG_CANSAT_APPS_RFM95_SPI_FREQUENCY);
+}
+
+/****************************************************************************
+ * Name: rfm95_unlock
+ ****************************************************************************/
+
+static void rfm95_unlock(FAR struct spi_dev_s *spi)
+{
+  SPI_LOCK(spi, false);
+}
+
+/****************************************************************************
+ * Name: rfm95_putreg
+ ****************************************************************************/
+
+static void rfm95_putreg(FAR struct rfm95_dev_s *dev, uint8_t reg,
+                         uint8_t val)
+{
+  uint8_t buf[2];
+
+  buf[0] = reg | RFM95_SPI_WRITE;
+  buf[1] = val;
+
+  rfm95_lock(dev->spi);
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), true);
+  SPI_SNDBLOCK(dev->spi, buf, sizeof(buf));
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), false);
+  rfm95_unlock(dev->spi);
+}
+
+/****************************************************************************
+ * Name: rfm95_getreg
+ ****************************************************************************/
+
+static uint8_t rfm95_getreg(FAR struct rfm95_dev_s *dev, uint8_t reg)
+{
+  uint8_t txbuf[2];
+  uint8_t rxbuf[2];
+
+  txbuf[0] = reg & ~RFM95_SPI_WRITE;
+  txbuf[1] = 0;
+
+  rfm95_lock(dev->spi);
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), true);
+  SPI_EXCHANGE(dev->spi, txbuf, rxbuf, sizeof(txbuf));
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), false);
+  rfm95_unlock(dev->spi);
+
+  return rxbuf[1];
+}
+
+/****************************************************************************
+ * Name: rfm95_dio0_handler
+ ****************************************************************************/
+
+static int rfm95_dio0_handler(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct rfm95_dev_s *dev = g_rfm95;
+
+  /* Only acknowledge the edge here, the IRQ flags are cleared over SPI by
+   * the next rfm95_transmit() call since SPI cannot be used from interrupt
+   * context.
+   */
+
+  if (dev && dev->busy)
+    {
+      dev->busy = false;
+      sem_post(&dev->txdone);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: rfm95_configure
+ ****************************************************************************/
+
+static void rfm95_configure(FAR struct rfm95_dev_s *dev)
+{
+  FAR const struct rfm95_config_s *cfg = &dev->config;
+  uint64_t frf;
+  int8_t power;
+  uint8_t cfg3;
+
+  frf = ((uint64_t)cfg->frequency << 19) / RFM95_FXOSC;
+  rfm95_putreg(dev, RFM95_REG_FRF_MSB, (uint8_t)(frf >> 16));
+  rfm95_putreg(dev, RFM95_REG_FRF_MID, (uint8_t)(frf >> 8));
+  rfm95_putreg(dev, RFM95_REG_FRF_LSB, (uint8_t)frf);
+
+  /* RFM95 only brings out PA_BOOST */
+
+  power = cfg->power;
+  if (power < 2)
+    {
+      power = 2;
+    }
+  else if (power > 17)
+    {
+      power = 17;
+    }
+
+  rfm95_putreg(dev, RFM95_REG_PACONFIG, RFM95_PA_BOOST | (power - 2));
+
+  rfm95_putreg(dev, RFM95_REG_MODEMCONFIG1, (cfg->bw << 4) | (cfg->cr << 1));
+  rfm95_putreg(dev, RFM95_REG_MODEMCONFIG2,
+               (cfg->sf << 4) | (cfg->crc ? 0x04 : 0));
+
+  cfg3 = RFM95_AGC_AUTO;
+  if ((1000000ull << cfg->sf) / g_bw_hz[cfg->bw] > 16000)
+    {
+      cfg3 |= RFM95_LOWDATARATE;
+    }
+
+  rfm95_putreg(dev, RFM95_REG_MODEMCONFIG3, cfg3);
+  rfm95_putreg(dev, RFM95_REG_PREAMBLEMSB, cfg->preamble >> 8);
+  rfm95_putreg(dev, RFM95_REG_PREAMBLELSB, cfg->preamble & 0xff);
+
+  /* Use the whole FIFO for TX and leave only TxDone on DIO0 */
+
+  rfm95_putreg(dev, RFM95_REG_FIFOTXBASE, 0);
+  rfm95_putreg(dev, RFM95_REG_FIFORXBASE, 0);
+  rfm95_putreg(dev, RFM95_REG_IRQFLAGSMASK, (uint8_t)~RFM95_IRQ_TXDONE);
+  rfm95_putreg(dev, RFM95_REG_DIOMAPPING1, RFM95_DIO0_TXDONE);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rfm95_initialize
+ ****************************************************************************/
+
+int rfm95_initialize(FAR struct rfm95_dev_s *dev, FAR struct spi_dev_s *spi,
+                     int dio0_pin, FAR const struct rfm95_config_s *config)
+{
+  int ret;
+
+  /* SF6 needs implicit header mode and its own detection settings; only
+   * explicit header is supported here.
+   */
+
+  if (!dev || !spi || !config || config->sf < 7 || config->sf > 12 ||
+      config->bw > RFM95_BW_500K || config->cr < RFM95_CR_4_5 ||
+      config->cr > RFM95_CR_4_8)
+    {
+      return -EINVAL;
+    }
+
+  if (g_rfm95)
+    {
+      return -EBUSY;
+    }
+
+  memset(dev, 0, sizeof(struct rfm95_dev_s));
+  dev->spi      = spi;
+  dev->dio0_pin = dio0_pin;
+  dev->config   = *config;
+  sem_init(&dev->txdone, 0, 0);
+  sem_setprotocol(&dev->txdone, SEM_PRIO_NONE);
+
+  if (rfm95_getreg(dev, RFM95_REG_VERSION) != RFM95_VERSION)
+    {
+      sem_destroy(&dev->txdone);
+      return -ENODEV;
+    }
+
+  /* LongRangeMode can only be changed in sleep mode */
+
+  rfm95_putreg(dev, RFM95_REG_OPMODE, RFM95_OPMODE_LORA | RFM95_OPMODE_SLEEP);
+  rfm95_putreg(dev, RFM95_REG_OPMODE, RFM95_OPMODE_LORA | RFM95_OPMODE_STDBY);
+  rfm95_configure(dev);
+
+  g_rfm95 = dev;
+
+  board_gpio_config(dio0_pin, 0, true, false, PIN_FLOAT);
+  ret = board_gpio_intconfig(dio0_pin, INT_RISING_EDGE, false,
+                             rfm95_dio0_handler);
+  if (ret < 0)
+    {
+      g_rfm95 = NULL;
+      sem_destroy(&dev->txdone);
+      return ret;
+    }
+
+  board_gpio_int(dio0_pin, true);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: rfm95_uninitialize
+ ****************************************************************************/
+
+void rfm95_uninitialize(FAR struct rfm95_dev_s *dev)
+{
+  board_gpio_int(dev->dio0_pin, false);
+  board_gpio_intconfig(dev->dio0_pin, 0, false, NULL);
+
+  rfm95_putreg(dev, RFM95_REG_OPMODE, RFM95_OPMODE_LORA | RFM95_OPMODE_SLEEP);
+
+  g_rfm95 = NULL;
+  sem_destroy(&dev->txdone);
+}
+
+/****************************************************************************
+ * Name: rfm95_transmit
+ ****************************************************************************/
+
+int rfm95_transmit(FAR struct rfm95_dev_s *dev, FAR const uint8_t *data,
+                   size_t len)
+{
+  if (len == 0 || len > RFM95_MAX_PAYLOAD)
+    {
+      return -EINVAL;
+    }
+
+  if (dev->busy)
+    {
+      return -EBUSY;
+    }
+
+  /* Rearm DIO0: the previous TxDone is still latched in RegIrqFlags */
+
+  rfm95_putreg(dev, RFM95_REG_IRQFLAGS, 0xff);
+  rfm95_putreg(dev, RFM95_REG_FIFOADDRPTR, 0);
+  rfm95_putreg(dev, RFM95_REG_PAYLOADLEN, (uint8_t)len);
+
+  /* Move the whole payload in a single chip select cycle.  The CXD56 SPI
+   * driver hands blocks of this size to the DMAC when CXD56_DMAC_SPIx_TX
+   * is enabled for the bus.
+   */
+
+  dev->burst[0] = RFM95_REG_FIFO | RFM95_SPI_WRITE;
+  memcpy(&dev->burst[1], data, len);
+
+  rfm95_lock(dev->spi);
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), true);
+  SPI_SNDBLOCK(dev->spi, dev->burst, len + 1);
+  SPI_SELECT(dev->spi, SPIDEV_USER(0), false);
+  rfm95_unlock(dev->spi);
+
+  dev->busy = true;
+  rfm95_putreg(dev, RFM95_REG_OPMODE, RFM95_OPMODE_LORA | RFM95_OPMODE_TX);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: rfm95_wait_txdone
+ ****************************************************************************/
+
+int rfm95_wait_txdone(FAR struct rfm95_dev_s *dev, uint32_t timeout_ms)
+{
+  struct timespec abstime;
+  int ret;
+
+  if (timeout_ms == 0)
+    {
+      while (sem_wait(&dev->txdone) < 0)
+        {
+          if (errno != EINTR)
+            {
+              return -errno;
+            }
+        }
+
+      return 0;
+    }
+
+  clock_gettime(CLOCK_REALTIME, &abstime);
+  abstime.tv_sec  += timeout_ms / 1000;
+  abstime.tv_nsec += (timeout_ms % 1000) * 1000000;
+  if (abstime.tv_nsec >= 1000000000)
+    {
+      abstime.tv_sec++;
+      abstime.tv_nsec -= 1000000000;
+    }
+
+  while ((ret = sem_timedwait(&dev->txdone, &abstime)) < 0)
+    {
+      if (errno != EINTR)
+        {
+          break;
+        }
+    }
+
+  if (ret < 0)
+    {
+      ret = -errno;
+
+      /* The modem never reported TxDone, drop back to standby so the next
+       * transmit starts from a known state.
+       */
+
+      dev->busy = false;
+      rfm95_putreg(dev, RFM95_REG_OPMODE,
+                   RFM95_OPMODE_LORA | RFM95_OPMODE_STDBY);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rfm95_airtime_us
+ ****************************************************************************/
+
+uint32_t rfm95_airtime_us(FAR const struct rfm95_config_s *config,
+                          size_t len)
+{
+  uint32_t bw = g_bw_hz[config->bw];
+  int32_t sf = config->sf;
+  int32_t de;
+  int32_t num;
+  int32_t den;
+  int32_t nsym;
+  uint64_t quarters;
+
+  de = ((1000000ull << sf) / bw > 16000) ? 1 : 0;
+
+  /* Explicit header is always used */
+
+  num = 8 * (int32_t)len - 4 * sf + 28 + (config->crc ? 16 : 0);
+  den = 4 * (sf - 2 * de);
+  nsym = 8;
+  if (num > 0)
+    {
+      nsym += ((num + den - 1) / den) * (config->cr + 4);
+    }
+
+  /* Preamble adds 4.25 symbols, count in quarter symbols to stay integer */
+
+  quarters = 4ull * (config->preamble + nsym) + 17;
+  return (uint32_t)((quarters * (1000000ull << sf)) / (4ull * bw));
+}
@@ -0,0 +1,177 @@
+/****************************************************************************
+ * cansat_apps/rfm95/rfm95.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_RFM95_RFM95_H
+#define __CANSAT_APPS_RFM95_RFM95_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/spi/spi.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The modem FIFO is 256 bytes, the whole of it is used as TX area */
+
+#define RFM95_FIFO_SIZE        256
+#define RFM95_MAX_PAYLOAD      255
+
+/* Bandwidth settings (RegModemConfig1 BW field) */
+
+#define RFM95_BW_7K8           0
+#define RFM95_BW_10K4          1
+#define RFM95_BW_15K6          2
+#define RFM95_BW_20K8          3
+#define RFM95_BW_31K25         4
+#define RFM95_BW_41K7          5
+#define RFM95_BW_62K5          6
+#define RFM95_BW_125K          7
+#define RFM95_BW_250K          8
+#define RFM95_BW_500K          9
+
+/* Coding rate settings (RegModemConfig1 CR field) */
+
+#define RFM95_CR_4_5           1
+#define RFM95_CR_4_6           2
+#define RFM95_CR_4_7           3
+#define RFM95_CR_4_8           4
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct rfm95_config_s
+{
+  uint32_t frequency;  /* Carrier frequency in Hz */
+  uint8_t  sf;         /* Spreading factor, 7..12 */
+  uint8_t  bw;         /* One of RFM95_BW_* */
+  uint8_t  cr;         /* One of RFM95_CR_* */
+  int8_t   power;      /* PA_BOOST output power in dBm, 2..17 */
+  uint16_t preamble;   /* Preamble length in symbols */
+  bool     crc;        /* Append payload CRC */
+};
+
+struct rfm95_dev_s
+{
+  FAR struct spi_dev_s *spi;
+  int dio0_pin;
+  sem_t txdone;                      /* Posted from the DIO0 interrupt */
+  volatile bool busy;                /* A packet is on air */
+  struct rfm95_config_s config;
+  uint8_t burst[RFM95_FIFO_SIZE + 1]; /* Address byte + FIFO image */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rfm95_initialize
+ *
+ * Description:
+ *   Probe the modem on the given SPI bus, switch it to LoRa mode, apply
+ *   the radio configuration and route TxDone to DIO0.  Only one instance
+ *   may be initialized at a time because the board GPIO interrupt API does
+ *   not carry a user argument.  Packets always use an explicit header, so
+ *   SF6, which requires implicit header mode, is refused with -EINVAL.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rfm95_initialize(FAR struct rfm95_dev_s *dev, FAR struct spi_dev_s *spi,
+                     int dio0_pin, FAR const struct rfm95_config_s *config);
+
+/****************************************************************************
+ * Name: rfm95_uninitialize
+ *
+ * Description:
+ *   Disable the DIO0 interrupt and put the modem to sleep.
+ *
+ ****************************************************************************/
+
+void rfm95_uninitialize(FAR struct rfm95_dev_s *dev);
+
+/****************************************************************************
+ * Name: rfm95_transmit
+ *
+ * Description:
+ *   Load a packet into the FIFO with one SPI burst and start transmission.
+ *   The call returns as soon as the modem is in TX mode; completion is
+ *   signalled through DIO0 and collected with rfm95_wait_txdone().
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if a packet is still on air, -EINVAL on a
+ *   bad length.
+ *
+ ****************************************************************************/
+
+int rfm95_transmit(FAR struct rfm95_dev_s *dev, FAR const uint8_t *data,
+                   size_t len);
+
+/****************************************************************************
+ * Name: rfm95_wait_txdone
+ *
+ * Description:
+ *   Block until the packet started by rfm95_transmit() has left the modem.
+ *   timeout_ms of zero waits forever.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ETIMEDOUT if DIO0 did not fire in time.
+ *
+ ****************************************************************************/
+
+int rfm95_wait_txdone(FAR struct rfm95_dev_s *dev, uint32_t timeout_ms);
+
+/****************************************************************************
+ * Name: rfm95_airtime_us
+ *
+ * Description:
+ *   Time on air of a packet of len bytes with the given configuration,
+ *   following the formula in the SX1276 datasheet (section 4.1.1.7).
+ *
+ ****************************************************************************/
+
+uint32_t rfm95_airtime_us(FAR const struct rfm95_config_s *config,
+                          size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_RFM95_RFM95_H */
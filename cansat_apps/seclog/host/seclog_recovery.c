@@ -0,0 +1,443 @@
+/****************************************************************************
+ * cansat_apps/seclog/host/seclog_recovery.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Host torn write and recovery test of seclog.
+ *
+ * For several log geometries and every number of appends up to three laps
+ * of the log (a sample of them for large logs), a log is filled, the last
+ * append is torn and the log is reopened as after a reset.  The tear keeps
+ * either a prefix of the new sector image, as a file system writing the
+ * sector in order would, or a random mix of 16 byte chunks of the old and
+ * the new image, as a card programming pages in any order would.
+ *
+ * After reopening, appends must continue right after the newest complete
+ * sector: the torn append is lost unless every byte of it landed, no older
+ * sequence number is reused and every sector of the run up to the newest
+ * one reads back with its payload.  The log must then keep working across
+ * another lap and another reopen.
+ *
+ * Logs of the wrong size and logs of the right size holding garbage must
+ * come back empty and usable.
+ *
+ * A log of one sector can not survive a torn write, it restarts from
+ * sequence 0; it is only tested without tears.
+ *
+ *   seclog_recovery [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "seclog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CHUNK_SIZE  16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum tear_e
+{
+  TEAR_NONE = 0,
+  TEAR_PREFIX,
+  TEAR_CHUNKS,
+  TEAR_NUM
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_tear_names[TEAR_NUM] =
+{
+  "none", "prefix", "chunks"
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+static unsigned long g_cases;
+static char g_path[64];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static void fail(const char *what, uint32_t nsectors, uint16_t sector_size,
+                 uint32_t appends, enum tear_e tear)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%u x %u, %u appends, tear %s: %s\n", nsectors, sector_size,
+             appends, g_tear_names[tear], what);
+    }
+}
+
+/* Payload of sequence number seq */
+
+static size_t payload(uint32_t seq, size_t max, uint8_t *data)
+{
+  size_t len = seq % (max + 1);
+  size_t k;
+
+  for (k = 0; k < len; k++)
+    {
+      data[k] = (uint8_t)(seq * 7 + k);
+    }
+
+  return len;
+}
+
+static bool append(struct seclog_s *log, uint32_t seq)
+{
+  uint8_t data[UINT16_MAX];
+  size_t len = payload(seq, seclog_payload_size(log), data);
+
+  return seclog_append(log, data, len) == (int32_t)seq;
+}
+
+static bool read_sector(uint32_t index, uint16_t sector_size, uint8_t *buf)
+{
+  int fd = open(g_path, O_RDONLY);
+  bool ok;
+
+  ok = fd >= 0 && pread(fd, buf, sector_size, (off_t)index * sector_size) ==
+                  sector_size;
+  close(fd);
+  return ok;
+}
+
+static bool write_sector(uint32_t index, uint16_t sector_size,
+                         const uint8_t *buf)
+{
+  int fd = open(g_path, O_WRONLY);
+  bool ok;
+
+  ok = fd >= 0 && pwrite(fd, buf, sector_size, (off_t)index * sector_size) ==
+                  sector_size;
+  close(fd);
+  return ok;
+}
+
+/* Check that sequence numbers [first, end) read back with their payload */
+
+static bool check_run(uint32_t first, uint32_t end, uint32_t nsectors,
+                      uint16_t sector_size)
+{
+  uint8_t sector[UINT16_MAX];
+  uint8_t data[UINT16_MAX];
+  struct seclog_hdr_s hdr;
+  uint32_t seq;
+  size_t len;
+
+  for (; first < end; first++)
+    {
+      if (!read_sector(first % nsectors, sector_size, sector) ||
+          !seclog_check(sector, sector_size, first % nsectors, nsectors,
+                        &seq) || seq != first)
+        {
+          return false;
+        }
+
+      memcpy(&hdr, sector, SECLOG_HDR_SIZE);
+      len = payload(seq, sector_size - SECLOG_HDR_SIZE, data);
+      if (hdr.len != len ||
+          memcmp(sector + SECLOG_HDR_SIZE, data, len) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/* Replace parts of the new image of a sector with the old image.  Return
+ * true if the header and the payload of the new image are still complete;
+ * the padding after the payload is not covered by the CRC.
+ */
+
+static bool tear(enum tear_e mode, uint16_t sector_size, const uint8_t *old,
+                 uint8_t *image)
+{
+  uint8_t new[UINT16_MAX];
+  struct seclog_hdr_s hdr;
+  size_t cut;
+  size_t k;
+
+  memcpy(new, image, sector_size);
+  memcpy(&hdr, image, SECLOG_HDR_SIZE);
+
+  if (mode == TEAR_PREFIX)
+    {
+      cut = rnd() % (sector_size + 1);
+      memcpy(image + cut, old + cut, sector_size - cut);
+    }
+  else
+    {
+      for (k = 0; k < sector_size; k += CHUNK_SIZE)
+        {
+          if (rnd() & 1)
+            {
+              cut = sector_size - k < CHUNK_SIZE ? sector_size - k :
+                                                   CHUNK_SIZE;
+              memcpy(image + k, old + k, cut);
+            }
+        }
+    }
+
+  return memcmp(new, image, SECLOG_HDR_SIZE + hdr.len) == 0;
+}
+
+static void test_case(uint32_t nsectors, uint16_t sector_size,
+                      uint32_t appends, enum tear_e mode)
+{
+  uint8_t old[UINT16_MAX];
+  uint8_t image[UINT16_MAX];
+  struct seclog_s log;
+  uint32_t expect;
+  uint32_t first;
+  uint32_t index;
+  uint32_t i;
+
+  g_cases++;
+  unlink(g_path);
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0 || !log.empty)
+    {
+      fail("create", nsectors, sector_size, appends, mode);
+      return;
+    }
+
+  for (i = 0; i < appends; i++)
+    {
+      if (!append(&log, i))
+        {
+          fail("append", nsectors, sector_size, appends, mode);
+          seclog_close(&log);
+          return;
+        }
+    }
+
+  /* A torn append may also have destroyed the sector it was overwriting,
+   * that one is not checked then.
+   */
+
+  expect = appends;
+  first  = appends > nsectors ? appends - nsectors : 0;
+  if (mode != TEAR_NONE)
+    {
+      index = appends % nsectors;
+      read_sector(index, sector_size, old);
+      append(&log, appends);
+      read_sector(index, sector_size, image);
+      if (tear(mode, sector_size, old, image))
+        {
+          expect++;
+          first = expect > nsectors ? expect - nsectors : 0;
+        }
+      else if (appends >= nsectors)
+        {
+          first++;
+        }
+
+      write_sector(index, sector_size, image);
+    }
+
+  seclog_close(&log);
+
+  /* Reset: the log must continue after the newest complete sector */
+
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0)
+    {
+      fail("reopen", nsectors, sector_size, appends, mode);
+      return;
+    }
+
+  if (log.next_seq != expect || log.empty != (expect == 0))
+    {
+      fail("next sequence number", nsectors, sector_size, appends, mode);
+    }
+
+  if (!check_run(first, expect, nsectors, sector_size))
+    {
+      fail("run after reopen", nsectors, sector_size, appends, mode);
+    }
+
+  /* One more lap overwrites the torn sector */
+
+  for (i = 0; i < nsectors + 1; i++)
+    {
+      if (!append(&log, log.next_seq))
+        {
+          fail("append after reopen", nsectors, sector_size, appends, mode);
+          break;
+        }
+    }
+
+  expect += nsectors + 1;
+  seclog_close(&log);
+
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0 ||
+      log.next_seq != expect ||
+      !check_run(expect - nsectors, expect, nsectors, sector_size))
+    {
+      fail("second reopen", nsectors, sector_size, appends, mode);
+    }
+
+  seclog_close(&log);
+}
+
+/* A file of the wrong size, or of the right size without a valid sector,
+ * must be taken as an empty log.
+ */
+
+static void test_garbage(uint32_t nsectors, uint16_t sector_size)
+{
+  uint8_t sector[UINT16_MAX];
+  struct seclog_s log;
+  uint32_t i;
+  size_t k;
+
+  for (k = 0; k < sector_size; k++)
+    {
+      sector[k] = (uint8_t)rnd();
+    }
+
+  /* Valid sectors from a log with a different sector count */
+
+  unlink(g_path);
+  seclog_open(&log, g_path, nsectors + 1, sector_size);
+  append(&log, 0);
+  append(&log, 1);
+  seclog_close(&log);
+
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0 ||
+      !log.empty || log.next_seq != 0 || !append(&log, 0))
+    {
+      fail("wrong size", nsectors, sector_size, 0, TEAR_NONE);
+    }
+
+  seclog_close(&log);
+
+  for (i = 0; i < nsectors; i++)
+    {
+      write_sector(i, sector_size, sector);
+    }
+
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0 ||
+      !log.empty || log.next_seq != 0 || !append(&log, 0) ||
+      !append(&log, 1))
+    {
+      fail("garbage", nsectors, sector_size, 0, TEAR_NONE);
+    }
+
+  seclog_close(&log);
+
+  if (seclog_open(&log, g_path, nsectors, sector_size) != 0 ||
+      log.next_seq != 2 || !check_run(nsectors > 1 ? 0 : 1, 2, nsectors,
+                                      sector_size))
+    {
+      fail("appends after garbage", nsectors, sector_size, 2, TEAR_NONE);
+    }
+
+  seclog_close(&log);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const uint32_t nsectors[] =
+  {
+    1, 2, 3, 5, 8, 64
+  };
+
+  static const uint16_t sector_sizes[] =
+  {
+    SECLOG_HDR_SIZE + 1, 64, 512
+  };
+
+  const char *tmpdir = getenv("TMPDIR");
+  uint32_t appends;
+  uint32_t n;
+  size_t i;
+  size_t s;
+  int mode;
+  int r;
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+  snprintf(g_path, sizeof(g_path), "%s/seclog_recovery.%d",
+           tmpdir ? tmpdir : "/tmp", (int)getpid());
+
+  for (i = 0; i < sizeof(nsectors) / sizeof(nsectors[0]); i++)
+    {
+      n = nsectors[i];
+
+      for (s = 0; s < sizeof(sector_sizes) / sizeof(sector_sizes[0]); s++)
+        {
+          test_garbage(n, sector_sizes[s]);
+
+          for (mode = 0; mode < TEAR_NUM; mode++)
+            {
+              if (n == 1 && mode != TEAR_NONE)
+                {
+                  continue;
+                }
+
+              for (r = 0; r < 3; r++)
+                {
+                  for (appends = 0; appends <= 3 * n; appends++)
+                    {
+                      if (n > 8 && rnd() % 8)
+                        {
+                          continue;
+                        }
+
+                      test_case(n, sector_sizes[s], appends,
+                                (enum tear_e)mode);
+                    }
+                }
+            }
+        }
+    }
+
+  unlink(g_path);
+
+  printf("%lu cases, %lu errors\n", g_cases, g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * cansat_apps/seclog/host/seclog_verify.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Log verifier.  Scans every sector of a log pulled from the SD card,
+ * reports bad and out of order sectors, cross-checks the result against
+ * the binary search used on the target and optionally writes the payloads,
+ * oldest first, to stdout.
+ *
+ *   seclog_verify [-s sector_size] [-d] file
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "seclog.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void usage(const char *prog)
+{
+  fprintf(stderr, "usage: %s [-s sector_size] [-d] file\n", prog);
+  exit(2);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  unsigned long sector_size = 512;
+  uint32_t nsectors;
+  uint32_t valid = 0;
+  uint32_t blank = 0;
+  uint32_t bad = 0;
+  uint32_t order = 0;
+  uint32_t newest = 0;
+  uint32_t newest_seq = 0;
+  uint32_t head_seq;
+  uint32_t oldest;
+  uint32_t count;
+  uint32_t seq;
+  uint32_t i;
+  uint8_t *buf;
+  uint8_t *map;
+  FILE *out;
+  int32_t head;
+  off_t size;
+  int dump = 0;
+  int opt;
+  int fd;
+  int ret = 0;
+
+  while ((opt = getopt(argc, argv, "s:d")) != -1)
+    {
+      switch (opt)
+        {
+          case 's':
+            sector_size = strtoul(optarg, NULL, 0);
+            break;
+
+          case 'd':
+            dump = 1;
+            break;
+
+          default:
+            usage(argv[0]);
+        }
+    }
+
+  if (optind != argc - 1 || sector_size <= SECLOG_HDR_SIZE ||
+      sector_size > UINT16_MAX)
+    {
+      usage(argv[0]);
+    }
+
+  fd = open(argv[optind], O_RDONLY);
+  if (fd < 0)
+    {
+      perror(argv[optind]);
+      return 1;
+    }
+
+  size = lseek(fd, 0, SEEK_END);
+  if (size <= 0 || size % sector_size != 0)
+    {
+      fprintf(stderr, "%s: size %lld is not a multiple of %lu\n",
+              argv[optind], (long long)size, sector_size);
+      return 1;
+    }
+
+  nsectors = size / sector_size;
+  buf = malloc(sector_size);
+  map = malloc(nsectors);
+  if (!buf || !map)
+    {
+      return 1;
+    }
+
+  /* Full scan */
+
+  for (i = 0; i < nsectors; i++)
+    {
+      if (pread(fd, buf, sector_size, (off_t)i * sector_size) !=
+          (ssize_t)sector_size)
+        {
+          perror("read");
+          return 1;
+        }
+
+      map[i] = seclog_check(buf, sector_size, i, nsectors, &seq);
+      if (map[i])
+        {
+          valid++;
+          if (valid == 1 || (int32_t)(seq - newest_seq) > 0)
+            {
+              newest     = i;
+              newest_seq = seq;
+            }
+        }
+      else if (buf[0] == 0 && !memcmp(buf, buf + 1, sector_size - 1))
+        {
+          blank++;
+        }
+      else
+        {
+          bad++;
+        }
+    }
+
+  /* Keep stdout clean for the payloads when dumping */
+
+  out = dump ? stderr : stdout;
+
+  fprintf(out, "sectors  %u x %lu\n", nsectors, sector_size);
+  fprintf(out, "valid    %u\n", valid);
+  fprintf(out, "blank    %u\n", blank);
+  fprintf(out, "bad      %u\n", bad);
+
+  head = seclog_find_head(fd, nsectors, sector_size, buf, &head_seq);
+  if (valid == 0)
+    {
+      fprintf(out, "log is empty\n");
+      if (head != -ENOENT)
+        {
+          fprintf(out, "MISMATCH: search found sector %d\n", head);
+          ret = 1;
+        }
+
+      goto errout;
+    }
+
+  fprintf(out, "newest   sector %u seq %u\n", newest, newest_seq);
+  if (head < 0 || (uint32_t)head != newest || head_seq != newest_seq)
+    {
+      fprintf(out, "MISMATCH: search found sector %d seq %u\n", head,
+              head < 0 ? 0 : head_seq);
+      ret = 1;
+    }
+
+  /* Walk back from the newest sector while the sequence stays contiguous,
+   * everything valid beyond that run is stale or out of order.
+   */
+
+  count = 1;
+  while (count < nsectors && newest_seq >= count &&
+         map[(newest_seq - count) % nsectors])
+    {
+      count++;
+    }
+
+  oldest = newest_seq - count + 1;
+  for (i = 0; i < nsectors; i++)
+    {
+      seq = oldest + i;
+      if (i >= count && map[seq % nsectors])
+        {
+          order++;
+        }
+    }
+
+  fprintf(out, "run      seq %u..%u (%u sectors)\n",
+          oldest, newest_seq, count);
+  fprintf(out, "stale    %u\n", order);
+
+  if (dump)
+    {
+      for (i = 0; i < count; i++)
+        {
+          seq = oldest + i;
+          pread(fd, buf, sector_size,
+                (off_t)(seq % nsectors) * sector_size);
+          fwrite(buf + SECLOG_HDR_SIZE, 1,
+                 ((struct seclog_hdr_s *)buf)->len, stdout);
+        }
+    }
+
+errout:
+  free(map);
+  free(buf);
+  close(fd);
+  return ret;
+}
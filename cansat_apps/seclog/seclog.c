@@ -0,0 +1,365 @@
+/****************************************************************************
+ * cansat_apps/seclog/seclog.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/* This file is also built on the host by seclog/host, keep it to POSIX
+ * file I/O.
+ */
+
+#ifdef __NuttX__
+#  include <nuttx/config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "seclog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef O_BINARY
+#  define O_BINARY 0
+#endif
+
+#define SECLOG_CRC_OFFSET  12
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: seclog_read_sector
+ ****************************************************************************/
+
+static bool seclog_read_sector(int fd, uint32_t index, uint16_t sector_size,
+                               FAR uint8_t *buf)
+{
+  return pread(fd, buf, sector_size, (off_t)index * sector_size) ==
+         sector_size;
+}
+
+/****************************************************************************
+ * Name: seclog_probe
+ *
+ * Description:
+ *   Read and validate one sector.
+ *
+ ****************************************************************************/
+
+static bool seclog_probe(int fd, uint32_t index, uint32_t nsectors,
+                         uint16_t sector_size, FAR uint8_t *buf,
+                         FAR uint32_t *seq)
+{
+  return seclog_read_sector(fd, index, sector_size, buf) &&
+         seclog_check(buf, sector_size, index, nsectors, seq);
+}
+
+/****************************************************************************
+ * Name: seclog_format
+ *
+ * Description:
+ *   Create the file at its final size.  This is the only time the file
+ *   grows, so the allocation cost and the FAT updates are paid here at boot
+ *   rather than on every append.
+ *
+ ****************************************************************************/
+
+static int seclog_format(FAR struct seclog_s *log, FAR const char *path)
+{
+  uint32_t i;
+  int ret;
+
+  log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_BINARY, 0666);
+  if (log->fd < 0)
+    {
+      return -errno;
+    }
+
+  memset(log->buf, 0, log->sector_size);
+  for (i = 0; i < log->nsectors; i++)
+    {
+      if (write(log->fd, log->buf, log->sector_size) != log->sector_size)
+        {
+          ret = -errno;
+          close(log->fd);
+          return ret;
+        }
+    }
+
+  if (fsync(log->fd) < 0)
+    {
+      ret = -errno;
+      close(log->fd);
+      return ret;
+    }
+
+  log->next_seq = 0;
+  log->empty    = true;
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: seclog_crc32
+ ****************************************************************************/
+
+uint32_t seclog_crc32(uint32_t crc, FAR const uint8_t *data, size_t len)
+{
+  int bit;
+
+  crc = ~crc;
+  while (len--)
+    {
+      crc ^= *data++;
+      for (bit = 0; bit < 8; bit++)
+        {
+          crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+        }
+    }
+
+  return ~crc;
+}
+
+/****************************************************************************
+ * Name: seclog_check
+ ****************************************************************************/
+
+bool seclog_check(FAR const uint8_t *sector, uint16_t sector_size,
+                  uint32_t index, uint32_t nsectors, FAR uint32_t *seq)
+{
+  static const uint8_t zero[4];
+  struct seclog_hdr_s hdr;
+  uint32_t crc;
+
+  memcpy(&hdr, sector, SECLOG_HDR_SIZE);
+
+  if (hdr.magic != SECLOG_MAGIC || hdr.sector_size != sector_size ||
+      hdr.len > sector_size - SECLOG_HDR_SIZE ||
+      hdr.seq % nsectors != index)
+    {
+      return false;
+    }
+
+  crc = seclog_crc32(0, sector, SECLOG_CRC_OFFSET);
+  crc = seclog_crc32(crc, zero, sizeof(zero));
+  crc = seclog_crc32(crc, sector + SECLOG_HDR_SIZE, hdr.len);
+  if (crc != hdr.crc)
+    {
+      return false;
+    }
+
+  *seq = hdr.seq;
+  return true;
+}
+
+/****************************************************************************
+ * Name: seclog_find_head
+ ****************************************************************************/
+
+int32_t seclog_find_head(int fd, uint32_t nsectors, uint16_t sector_size,
+                         FAR uint8_t *buf, FAR uint32_t *seq)
+{
+  uint32_t first;
+  uint32_t s;
+  uint32_t lo;
+  uint32_t hi;
+  uint32_t mid;
+
+  if (!seclog_probe(fd, 0, nsectors, sector_size, buf, &first))
+    {
+      /* Either nothing was ever written, or the log had wrapped and the
+       * write of sector 0 was torn; then the newest sector is the last one.
+       */
+
+      if (nsectors > 1 &&
+          seclog_probe(fd, nsectors - 1, nsectors, sector_size, buf, &s))
+        {
+          *seq = s;
+          return nsectors - 1;
+        }
+
+      return -ENOENT;
+    }
+
+  /* Sector i belongs to the current run iff it holds first + i.  That holds
+   * for [0, head] and fails for every sector after it, search the boundary.
+   */
+
+  lo = 0;
+  hi = nsectors;
+  while (hi - lo > 1)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (seclog_probe(fd, mid, nsectors, sector_size, buf, &s) &&
+          s == first + mid)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  *seq = first + lo;
+  return lo;
+}
+
+/****************************************************************************
+ * Name: seclog_open
+ ****************************************************************************/
+
+int seclog_open(FAR struct seclog_s *log, FAR const char *path,
+                uint32_t nsectors, uint16_t sector_size)
+{
+  uint32_t seq;
+  off_t size;
+  int ret;
+
+  if (!log || nsectors == 0 || sector_size <= SECLOG_HDR_SIZE)
+    {
+      return -EINVAL;
+    }
+
+  memset(log, 0, sizeof(struct seclog_s));
+  log->nsectors    = nsectors;
+  log->sector_size = sector_size;
+  log->buf         = (FAR uint8_t *)malloc(sector_size);
+  if (!log->buf)
+    {
+      return -ENOMEM;
+    }
+
+  log->fd = open(path, O_RDWR | O_BINARY);
+  if (log->fd >= 0)
+    {
+      size = lseek(log->fd, 0, SEEK_END);
+      if (size == (off_t)nsectors * sector_size)
+        {
+          if (seclog_find_head(log->fd, nsectors, sector_size, log->buf,
+                               &seq) >= 0)
+            {
+              log->next_seq = seq + 1;
+            }
+          else
+            {
+              log->empty = true;
+            }
+
+          return 0;
+        }
+
+      close(log->fd);
+    }
+
+  ret = seclog_format(log, path);
+  if (ret < 0)
+    {
+      free(log->buf);
+      log->buf = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: seclog_close
+ ****************************************************************************/
+
+void seclog_close(FAR struct seclog_s *log)
+{
+  if (log->buf)
+    {
+      fsync(log->fd);
+      close(log->fd);
+      free(log->buf);
+      log->buf = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: seclog_payload_size
+ ****************************************************************************/
+
+size_t seclog_payload_size(FAR struct seclog_s *log)
+{
+  return log->sector_size - SECLOG_HDR_SIZE;
+}
+
+/****************************************************************************
+ * Name: seclog_append
+ ****************************************************************************/
+
+int32_t seclog_append(FAR struct seclog_s *log, FAR const void *data,
+                      size_t len)
+{
+  struct seclog_hdr_s hdr;
+  uint32_t index;
+
+  if (len > seclog_payload_size(log))
+    {
+      return -EINVAL;
+    }
+
+  hdr.magic       = SECLOG_MAGIC;
+  hdr.seq         = log->next_seq;
+  hdr.len         = (uint16_t)len;
+  hdr.sector_size = log->sector_size;
+  hdr.crc         = 0;
+
+  memcpy(log->buf, &hdr, SECLOG_HDR_SIZE);
+  memcpy(log->buf + SECLOG_HDR_SIZE, data, len);
+  memset(log->buf + SECLOG_HDR_SIZE + len, 0,
+         seclog_payload_size(log) - len);
+
+  hdr.crc = seclog_crc32(0, log->buf, SECLOG_HDR_SIZE + len);
+  memcpy(log->buf + SECLOG_CRC_OFFSET, &hdr.crc, sizeof(hdr.crc));
+
+  index = hdr.seq % log->nsectors;
+  if (pwrite(log->fd, log->buf, log->sector_size,
+             (off_t)index * log->sector_size) != log->sector_size)
+    {
+      return -errno;
+    }
+
+  log->next_seq++;
+  log->empty = false;
+  return (int32_t)hdr.seq;
+}
+
+/****************************************************************************
+ * Name: seclog_sync
+ ****************************************************************************/
+
+int seclog_sync(FAR struct seclog_s *log)
+{
+  return fsync(log->fd) < 0 ? -errno : 0;
+}
@@ -0,0 +1,192 @@
+/****************************************************************************
+ * cansat_apps/seclog/seclog.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_SECLOG_SECLOG_H
+#define __CANSAT_APPS_SECLOG_SECLOG_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef FAR
+#  define FAR
+#endif
+
+/* Log file layout
+ *
+ * The file is nsectors * sector_size bytes and is written in full once when
+ * it is created.  Sequence number s always lives in sector s % nsectors, so
+ * the log wraps around and overwrites the oldest sector when it is full.
+ * Every sector starts with struct seclog_hdr_s (little endian) followed by
+ * the payload; crc is the CRC-32 (IEEE 802.3) of the header with crc set
+ * to zero and the len payload bytes.
+ *
+ * Because sectors are written in sequence order the valid sectors, read
+ * from sector 0, hold increasing sequence numbers up to the newest one and
+ * older (or no) data after it.  A torn write only invalidates the sector
+ * that was being written, so the newest sector is found with a binary
+ * search instead of a scan.
+ */
+
+#define SECLOG_MAGIC      0x474f4c53  /* "SLOG" */
+#define SECLOG_HDR_SIZE   16
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct seclog_hdr_s
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint16_t len;          /* Payload bytes in this sector */
+  uint16_t sector_size;
+  uint32_t crc;
+};
+
+struct seclog_s
+{
+  int fd;
+  uint32_t nsectors;
+  uint16_t sector_size;
+  uint32_t next_seq;     /* Sequence number of the next append */
+  bool empty;            /* No valid sector was found on open */
+  FAR uint8_t *buf;      /* One sector */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: seclog_open
+ *
+ * Description:
+ *   Open a log for appending.  If the file does not exist or does not have
+ *   the expected size it is (re)created and preallocated.  Otherwise the
+ *   newest valid sector is located and appends continue after it, so a log
+ *   survives resets in flight.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int seclog_open(FAR struct seclog_s *log, FAR const char *path,
+                uint32_t nsectors, uint16_t sector_size);
+
+/****************************************************************************
+ * Name: seclog_close
+ ****************************************************************************/
+
+void seclog_close(FAR struct seclog_s *log);
+
+/****************************************************************************
+ * Name: seclog_payload_size
+ *
+ * Returned Value:
+ *   Maximum payload of one sector.
+ *
+ ****************************************************************************/
+
+size_t seclog_payload_size(FAR struct seclog_s *log);
+
+/****************************************************************************
+ * Name: seclog_append
+ *
+ * Description:
+ *   Write one sector holding len bytes.  The write lands inside the
+ *   preallocated file, so no file system metadata is updated.
+ *
+ * Returned Value:
+ *   The sequence number of the sector on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int32_t seclog_append(FAR struct seclog_s *log, FAR const void *data,
+                      size_t len);
+
+/****************************************************************************
+ * Name: seclog_sync
+ ****************************************************************************/
+
+int seclog_sync(FAR struct seclog_s *log);
+
+/****************************************************************************
+ * Name: seclog_check
+ *
+ * Description:
+ *   Validate a sector image read from position index.
+ *
+ * Returned Value:
+ *   true if magic, size, CRC and position all match; the sequence number
+ *   is returned in seq.
+ *
+ ****************************************************************************/
+
+bool seclog_check(FAR const uint8_t *sector, uint16_t sector_size,
+                  uint32_t index, uint32_t nsectors, FAR uint32_t *seq);
+
+/****************************************************************************
+ * Name: seclog_find_head
+ *
+ * Description:
+ *   Binary search for the newest valid sector of an existing log.  buf must
+ *   hold one sector.  Costs O(log nsectors) sector reads.
+ *
+ * Returned Value:
+ *   The index of the newest sector, its sequence number in seq, or -ENOENT
+ *   if the log holds no valid sector.
+ *
+ ****************************************************************************/
+
+int32_t seclog_find_head(int fd, uint32_t nsectors, uint16_t sector_size,
+                         FAR uint8_t *buf, FAR uint32_t *seq);
+
+/****************************************************************************
+ * Name: seclog_crc32
+ ****************************************************************************/
+
+uint32_t seclog_crc32(uint32_t crc, FAR const uint8_t *data, size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_SECLOG_SECLOG_H */
@@ -0,0 +1,361 @@
+/****************************************************************************
+ * cansat_apps/telemetry/telemetry.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+#include "rfm95.h"
+#include "telemetry.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TELEMETRY_QUEUE_DEPTH  CONFIG_CANSAT_APPS_TELEMETRY_QUEUE_DEPTH
+
+/* TxDone is expected well within twice the computed airtime */
+
+#define TELEMETRY_TIMEOUT_MS(us) (2 * ((us) / 1000) + 10)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct telemetry_slot_s
+{
+  uint8_t len;
+  uint8_t data[RFM95_MAX_PAYLOAD];
+};
+
+struct telemetry_s
+{
+  struct rfm95_dev_s radio;
+  pthread_t daemon;
+  pthread_mutex_t lock;
+  sem_t items;                 /* Counts queued frames */
+  volatile bool running;
+  unsigned int head;           /* Next slot to fill */
+  unsigned int tail;           /* Next slot to send */
+  unsigned int count;
+  uint16_t seq;
+  struct telemetry_stats_s stats;
+  struct telemetry_slot_s queue[TELEMETRY_QUEUE_DEPTH];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct telemetry_s g_telemetry;
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+/* Provided by arch/arm/src/cxd56xx/cxd56_spi.h, which is not exported to
+ * the application include path.
+ */
+
+FAR struct spi_dev_s *cxd56_spibus_initialize(int port);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: telemetry_now_us
+ ****************************************************************************/
+
+static uint64_t telemetry_now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: telemetry_daemon
+ ****************************************************************************/
+
+static FAR void *telemetry_daemon(FAR void *arg)
+{
+  FAR struct telemetry_s *priv = (FAR struct telemetry_s *)arg;
+  FAR struct telemetry_slot_s *slot;
+  uint64_t start = 0;
+  uint64_t now;
+  uint32_t airtime = 0;
+  bool onair = false;
+  int ret;
+
+  while (priv->running)
+    {
+      if (sem_wait(&priv->items) < 0)
+        {
+          continue;
+        }
+
+      if (!priv->running)
+        {
+          break;
+        }
+
+      /* The slot at tail stays owned by the daemon until it is handed to
+       * the modem, producers only ever write at head.
+       */
+
+      slot = &priv->queue[priv->tail];
+
+      if (onair)
+        {
+          /* Wait outside the lock, only the update of the statistics is
+           * shared with telemetry_get_stats().
+           */
+
+          ret = rfm95_wait_txdone(&priv->radio,
+                                  TELEMETRY_TIMEOUT_MS(airtime));
+          now = telemetry_now_us();
+
+          pthread_mutex_lock(&priv->lock);
+          if (ret < 0)
+            {
+              priv->stats.timeouts++;
+            }
+          else
+            {
+              priv->stats.sent++;
+              priv->stats.airtime_us += airtime;
+              priv->stats.busy_us = now - start;
+            }
+
+          pthread_mutex_unlock(&priv->lock);
+        }
+
+      /* Only the daemon writes sent, so it is read without the lock */
+
+      if (priv->stats.sent == 0)
+        {
+          start = telemetry_now_us();
+        }
+
+      airtime = rfm95_airtime_us(&priv->radio.config, slot->len);
+      onair = rfm95_transmit(&priv->radio, slot->data, slot->len) == 0;
+
+      pthread_mutex_lock(&priv->lock);
+      priv->tail = (priv->tail + 1) % TELEMETRY_QUEUE_DEPTH;
+      priv->count--;
+      pthread_mutex_unlock(&priv->lock);
+    }
+
+  if (onair && rfm95_wait_txdone(&priv->radio,
+                                 TELEMETRY_TIMEOUT_MS(airtime)) == 0)
+    {
+      now = telemetry_now_us();
+
+      pthread_mutex_lock(&priv->lock);
+      priv->stats.sent++;
+      priv->stats.airtime_us += airtime;
+      priv->stats.busy_us = now - start;
+      pthread_mutex_unlock(&priv->lock);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: telemetry_start
+ ****************************************************************************/
+
+int telemetry_start(void)
+{
+  FAR struct telemetry_s *priv = &g_telemetry;
+  FAR struct spi_dev_s *spi;
+  struct rfm95_config_s config;
+  struct sched_param param;
+  pthread_attr_t attr;
+  int ret;
+
+  if (priv->running)
+    {
+      return -EBUSY;
+    }
+
+  spi = cxd56_spibus_initialize(CONFIG_CANSAT_APPS_RFM95_SPI_PORT);
+  if (!spi)
+    {
+      return -ENODEV;
+    }
+
+  config.frequency = CONFIG_CANSAT_APPS_TELEMETRY_FREQUENCY;
+  config.sf        = CONFIG_CANSAT_APPS_TELEMETRY_SF;
+  config.bw        = CONFIG_CANSAT_APPS_TELEMETRY_BW;
+  config.cr        = CONFIG_CANSAT_APPS_TELEMETRY_CR;
+  config.power     = CONFIG_CANSAT_APPS_TELEMETRY_POWER;
+  config.preamble  = CONFIG_CANSAT_APPS_TELEMETRY_PREAMBLE;
+  config.crc       = true;
+
+  ret = rfm95_initialize(&priv->radio, spi,
+                         CONFIG_CANSAT_APPS_RFM95_DIO0_PIN, &config);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  priv->head  = 0;
+  priv->tail  = 0;
+  priv->count = 0;
+  priv->seq   = 0;
+  memset(&priv->stats, 0, sizeof(priv->stats));
+  pthread_mutex_init(&priv->lock, NULL);
+  sem_init(&priv->items, 0, 0);
+  sem_setprotocol(&priv->items, SEM_PRIO_NONE);
+  priv->running = true;
+
+  pthread_attr_init(&attr);
+  param.sched_priority = CONFIG_CANSAT_APPS_TELEMETRY_PRIORITY;
+  pthread_attr_setschedparam(&attr, &param);
+  pthread_attr_setstacksize(&attr, CONFIG_CANSAT_APPS_TELEMETRY_STACKSIZE);
+
+  ret = pthread_create(&priv->daemon, &attr, telemetry_daemon, priv);
+  if (ret != 0)
+    {
+      priv->running = false;
+      sem_destroy(&priv->items);
+      pthread_mutex_destroy(&priv->lock);
+      rfm95_uninitialize(&priv->radio);
+      return -ret;
+    }
+
+  pthread_setname_np(priv->daemon, "telemetry");
+  return 0;
+}
+
+/****************************************************************************
+ * Name: telemetry_stop
+ ****************************************************************************/
+
+void telemetry_stop(void)
+{
+  FAR struct telemetry_s *priv = &g_telemetry;
+
+  if (!priv->running)
+    {
+      return;
+    }
+
+  priv->running = false;
+  sem_post(&priv->items);
+  pthread_join(priv->daemon, NULL);
+
+  sem_destroy(&priv->items);
+  pthread_mutex_destroy(&priv->lock);
+  rfm95_uninitialize(&priv->radio);
+}
+
+/****************************************************************************
+ * Name: telemetry_send
+ ****************************************************************************/
+
+int telemetry_send(uint8_t type, FAR const void *payload, size_t len)
+{
+  FAR struct telemetry_s *priv = &g_telemetry;
+  FAR struct telemetry_slot_s *slot;
+  struct timespec ts;
+  uint32_t ms;
+  uint16_t seq;
+
+  if (!priv->running)
+    {
+      return -ENODEV;
+    }
+
+  if (len > TELEMETRY_MAX_PAYLOAD)
+    {
+      return -EINVAL;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  ms = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+
+  pthread_mutex_lock(&priv->lock);
+
+  if (priv->count == TELEMETRY_QUEUE_DEPTH)
+    {
+      priv->stats.dropped++;
+      pthread_mutex_unlock(&priv->lock);
+      return -EAGAIN;
+    }
+
+  seq  = priv->seq++;
+  slot = &priv->queue[priv->head];
+
+  slot->data[0] = TELEMETRY_MAGIC;
+  slot->data[1] = type;
+  slot->data[2] = (uint8_t)seq;
+  slot->data[3] = (uint8_t)(seq >> 8);
+  slot->data[4] = (uint8_t)ms;
+  slot->data[5] = (uint8_t)(ms >> 8);
+  slot->data[6] = (uint8_t)(ms >> 16);
+  slot->data[7] = (uint8_t)(ms >> 24);
+  memcpy(&slot->data[TELEMETRY_HDR_SIZE], payload, len);
+  slot->len = TELEMETRY_HDR_SIZE + len;
+
+  priv->head = (priv->head + 1) % TELEMETRY_QUEUE_DEPTH;
+  priv->count++;
+  priv->stats.queued++;
+
+  pthread_mutex_unlock(&priv->lock);
+
+  sem_post(&priv->items);
+  return seq;
+}
+
+/****************************************************************************
+ * Name: telemetry_get_stats
+ ****************************************************************************/
+
+void telemetry_get_stats(FAR struct telemetry_stats_s *stats)
+{
+  FAR struct telemetry_s *priv = &g_telemetry;
+
+  if (!priv->running)
+    {
+      *stats = priv->stats;
+      return;
+    }
+
+  pthread_mutex_lock(&priv->lock);
+  *stats = priv->stats;
+  pthread_mutex_unlock(&priv->lock);
+}
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * cansat_apps/telemetry/telemetry.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_TELEMETRY_TELEMETRY_H
+#define __CANSAT_APPS_TELEMETRY_TELEMETRY_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Every frame starts with an 8 byte header, little endian:
+ *
+ *   0      magic (TELEMETRY_MAGIC)
+ *   1      frame type
+ *   2..3   sequence number
+ *   4..7   milliseconds since boot
+ */
+
+#define TELEMETRY_MAGIC        0xca
+#define TELEMETRY_HDR_SIZE     8
+#define TELEMETRY_MAX_PAYLOAD  (255 - TELEMETRY_HDR_SIZE)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct telemetry_stats_s
+{
+  uint32_t queued;     /* Frames accepted by telemetry_send() */
+  uint32_t sent;       /* Frames that reported TxDone */
+  uint32_t dropped;    /* Frames refused because the queue was full */
+  uint32_t timeouts;   /* TxDone did not arrive in time */
+  uint32_t airtime_us; /* Sum of the computed airtime of sent frames */
+  uint32_t busy_us;    /* Wall time from first TX start to last TxDone */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: telemetry_start
+ *
+ * Description:
+ *   Bring up the RFM95 on the configured SPI bus and start the daemon that
+ *   drains the TX queue.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int telemetry_start(void);
+
+/****************************************************************************
+ * Name: telemetry_stop
+ *
+ * Description:
+ *   Stop the daemon once the frame on air has completed and release the
+ *   radio.  Frames still queued are discarded.
+ *
+ ****************************************************************************/
+
+void telemetry_stop(void);
+
+/****************************************************************************
+ * Name: telemetry_send
+ *
+ * Description:
+ *   Queue one frame.  The header is filled in here, the payload is copied
+ *   into the queue and the call never waits for the radio.
+ *
+ * Returned Value:
+ *   The sequence number on success; -EAGAIN if the queue is full, -EINVAL
+ *   if the payload is too long, -ENODEV if the daemon is not running.
+ *
+ ****************************************************************************/
+
+int telemetry_send(uint8_t type, FAR const void *payload, size_t len);
+
+/****************************************************************************
+ * Name: telemetry_get_stats
+ ****************************************************************************/
+
+void telemetry_get_stats(FAR struct telemetry_stats_s *stats);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_TELEMETRY_TELEMETRY_H */
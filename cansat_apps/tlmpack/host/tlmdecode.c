@@ -0,0 +1,152 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/host/tlmdecode.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Ground station decoder.  Reads one received LoRa frame per line as hex
+ * (the whole frame, telemetry header included) and prints the flight
+ * samples as CSV.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tlmpack_flight.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Must match cansat_apps/telemetry/telemetry.h */
+
+#define TELEMETRY_MAGIC    0xca
+#define TELEMETRY_HDR_SIZE 8
+
+#define LINE_MAX_LEN       1024
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int hexval(int c)
+{
+  if (c >= '0' && c <= '9')
+    {
+      return c - '0';
+    }
+
+  c = tolower(c);
+  if (c >= 'a' && c <= 'f')
+    {
+      return c - 'a' + 10;
+    }
+
+  return -1;
+}
+
+static size_t parse_hex(const char *line, uint8_t *buf, size_t size)
+{
+  size_t len = 0;
+  int hi = -1;
+  int v;
+
+  for (; *line && len < size; line++)
+    {
+      v = hexval(*line);
+      if (v < 0)
+        {
+          continue;
+        }
+
+      if (hi < 0)
+        {
+          hi = v;
+        }
+      else
+        {
+          buf[len++] = (uint8_t)(hi << 4 | v);
+          hi = -1;
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(void)
+{
+  const struct tlmpack_schema_s *schema = &tlmpack_flight_schema;
+  struct tlmpack_decoder_s dec;
+  int32_t values[TLMPACK_MAX_FIELDS];
+  char line[LINE_MAX_LEN];
+  uint8_t frame[256];
+  unsigned int seq;
+  size_t len;
+  int ret;
+  int i;
+
+  printf("seq");
+  for (i = 0; i < schema->nfields; i++)
+    {
+      printf(",%s", schema->fields[i].name);
+    }
+
+  printf("\n");
+
+  while (fgets(line, sizeof(line), stdin))
+    {
+      len = parse_hex(line, frame, sizeof(frame));
+      if (len <= TELEMETRY_HDR_SIZE || frame[0] != TELEMETRY_MAGIC ||
+          frame[1] != TLMPACK_FLIGHT_FRAME_TYPE)
+        {
+          continue;
+        }
+
+      seq = frame[2] | frame[3] << 8;
+
+      tlmpack_decoder_init(&dec, schema, &frame[TELEMETRY_HDR_SIZE],
+                           len - TELEMETRY_HDR_SIZE);
+
+      while ((ret = tlmpack_next(&dec, values)) > 0)
+        {
+          printf("%u", seq);
+          for (i = 0; i < schema->nfields; i++)
+            {
+              printf(",%ld", (long)values[i]);
+            }
+
+          printf("\n");
+        }
+
+      if (ret < 0)
+        {
+          fprintf(stderr, "frame %u: malformed payload\n", seq);
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
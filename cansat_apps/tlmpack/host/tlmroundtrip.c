@@ -0,0 +1,310 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/host/tlmroundtrip.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Host round trip test of tlmpack.
+ *
+ * Flight-like samples (a parachute descent with GNSS noise and the odd
+ * jump that forces an absolute sample) are packed into telemetry payloads
+ * of TELEMETRY_MAX_PAYLOAD bytes with tlmpack_flight_schema, decoded and
+ * compared.  The average number of samples per payload is printed and
+ * checked against the figure the schema is sized for.
+ *
+ * Random schemas with random values that fit their fields are then round
+ * tripped the same way, and every truncation of a payload must decode to
+ * -EBADMSG or to a prefix of the samples, never past the buffer.
+ *
+ *   tlmroundtrip [frames]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tlmpack_flight.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Must match cansat_apps/telemetry/telemetry.h */
+
+#define TELEMETRY_MAX_PAYLOAD  (255 - 8)
+
+/* A payload carries one keyframe and then deltas, so at least this many
+ * smooth flight samples must fit.
+ */
+
+#define FLIGHT_MIN_SAMPLES     32
+
+#define MAX_SAMPLES            UINT8_MAX
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static uint32_t rnd32(void)
+{
+  return rnd() << 16 ^ rnd();
+}
+
+static void fail(const char *what, int frame)
+{
+  if (g_errors++ < 8)
+    {
+      printf("frame %d: %s\n", frame, what);
+    }
+}
+
+/* Pack samples into one payload until it is full, decode and compare.
+ * Returns the number of samples packed.
+ */
+
+static int round_trip(const struct tlmpack_schema_s *schema,
+                      int32_t (*samples)[TLMPACK_MAX_FIELDS], int avail,
+                      int frame)
+{
+  static int32_t values[TLMPACK_MAX_FIELDS];
+  struct tlmpack_encoder_s enc;
+  struct tlmpack_decoder_s dec;
+  uint8_t buf[TELEMETRY_MAX_PAYLOAD];
+  size_t len;
+  size_t cut;
+  int count = 0;
+  int ret;
+  int i;
+
+  tlmpack_encoder_init(&enc, schema, buf, sizeof(buf));
+  while (count < avail && tlmpack_append(&enc, samples[count]) == 0)
+    {
+      count++;
+    }
+
+  len = tlmpack_finish(&enc);
+
+  if (tlmpack_decoder_init(&dec, schema, buf, len) != count)
+    {
+      fail("wrong sample count", frame);
+      return count;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if (tlmpack_next(&dec, values) != 1 ||
+          memcmp(values, samples[i],
+                 schema->nfields * sizeof(int32_t)) != 0)
+        {
+          fail("decoded sample differs", frame);
+          return count;
+        }
+    }
+
+  if (tlmpack_next(&dec, values) != 0)
+    {
+      fail("samples past the count", frame);
+    }
+
+  /* Truncated payloads */
+
+  for (cut = 1; cut < len; cut += 1 + rnd() % 16)
+    {
+      tlmpack_decoder_init(&dec, schema, buf, cut);
+      for (i = 0; (ret = tlmpack_next(&dec, values)) == 1; i++)
+        {
+          if (memcmp(values, samples[i],
+                     schema->nfields * sizeof(int32_t)) != 0)
+            {
+              fail("truncated payload decoded wrong data", frame);
+              break;
+            }
+        }
+
+      if (ret != -EBADMSG || dec.bits.pos > cut * 8)
+        {
+          fail("truncated payload not rejected", frame);
+        }
+    }
+
+  return count;
+}
+
+static void test_flight(int frames)
+{
+  static int32_t samples[MAX_SAMPLES][TLMPACK_MAX_FIELDS];
+  int32_t time_ms = 120000;
+  int32_t pressure = 92000;
+  int32_t temp = 1850;
+  int32_t lat = 356000000;
+  int32_t lon = 1397000000;
+  int32_t alt = 8000;
+  long total = 0;
+  int min = MAX_SAMPLES;
+  int max = 0;
+  int count;
+  int frame;
+  int i;
+
+  for (frame = 0; frame < frames; frame++)
+    {
+      for (i = 0; i < MAX_SAMPLES; i++)
+        {
+          /* 10 Hz, ~5 m/s descent, 0.1 degC steps, GNSS jitter of a few
+           * metres, one fix jump in 200 samples
+           */
+
+          time_ms  += 100 + rnd() % 3;
+          pressure += 5 + rnd() % 3 - 1;
+          temp     += rnd() % 3 - 1;
+          lat      += rnd() % 401 - 200;
+          lon      += rnd() % 401 - 200;
+          alt      -= 5 + rnd() % 3 - 1;
+
+          if (rnd() % 200 == 0)
+            {
+              lat += 50000;
+            }
+
+          if (alt < 0)
+            {
+              alt = 8000;
+              pressure = 92000;
+            }
+
+          samples[i][TLMPACK_FLIGHT_TIME]        = time_ms;
+          samples[i][TLMPACK_FLIGHT_PRESSURE]    = pressure;
+          samples[i][TLMPACK_FLIGHT_TEMPERATURE] = temp;
+          samples[i][TLMPACK_FLIGHT_LATITUDE]    = lat;
+          samples[i][TLMPACK_FLIGHT_LONGITUDE]   = lon;
+          samples[i][TLMPACK_FLIGHT_ALTITUDE]    = alt;
+        }
+
+      count = round_trip(&tlmpack_flight_schema, samples, MAX_SAMPLES,
+                         frame);
+      total += count;
+      min = (count < min) ? count : min;
+      max = (count > max) ? count : max;
+    }
+
+  printf("flight: %ld samples in %d payloads of %d bytes, "
+         "%.1f per payload (%d..%d)\n",
+         total, frames, TELEMETRY_MAX_PAYLOAD, (double)total / frames, min,
+         max);
+
+  /* A fix jump costs an absolute sample, so only payloads without one
+   * reach the full count.
+   */
+
+  if (max < FLIGHT_MIN_SAMPLES)
+    {
+      fail("fewer flight samples per payload than expected", -1);
+    }
+}
+
+static void test_random(int frames)
+{
+  static int32_t samples[MAX_SAMPLES][TLMPACK_MAX_FIELDS];
+  struct tlmpack_field_s fields[TLMPACK_MAX_FIELDS];
+  struct tlmpack_schema_s schema;
+  int frame;
+  int f;
+  int i;
+
+  for (frame = 0; frame < frames; frame++)
+    {
+      schema.fields  = fields;
+      schema.nfields = 1 + rnd() % TLMPACK_MAX_FIELDS;
+
+      for (f = 0; f < schema.nfields; f++)
+        {
+          fields[f].name       = "f";
+          fields[f].bits       = 1 + rnd() % 32;
+          fields[f].delta_bits = rnd() % 4 ? rnd() % (fields[f].bits + 1)
+                                           : 0;
+          fields[f].is_signed  = rnd() & 1;
+        }
+
+      for (i = 0; i < MAX_SAMPLES; i++)
+        {
+          for (f = 0; f < schema.nfields; f++)
+            {
+              uint8_t bits = fields[f].bits;
+              uint32_t v;
+
+              /* Mostly small steps, sometimes anywhere in the field */
+
+              if (i > 0 && rnd() % 8)
+                {
+                  v = (uint32_t)samples[i - 1][f] + rnd() % 33 - 16;
+                }
+              else
+                {
+                  v = rnd32();
+                }
+
+              if (bits < 32)
+                {
+                  v &= (1u << bits) - 1;
+                  if (fields[f].is_signed && (v & (1u << (bits - 1))))
+                    {
+                      v |= ~((1u << bits) - 1);
+                    }
+                }
+
+              samples[i][f] = (int32_t)v;
+            }
+        }
+
+      round_trip(&schema, samples, MAX_SAMPLES, frame);
+    }
+
+  printf("random: %d schemas\n", frames);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+
+  test_flight(frames);
+  test_random(frames);
+
+  printf("%lu errors\n", g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
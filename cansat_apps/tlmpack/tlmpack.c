@@ -0,0 +1,386 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/tlmpack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+/* This file is also built on the host by tlmpack/host, keep it free of
+ * NuttX only interfaces.
+ */
+
+#ifdef __NuttX__
+#  include <nuttx/config.h>
+#endif
+
+#include <string.h>
+#include <errno.h>
+
+#include "tlmpack.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tlmpack_mask
+ ****************************************************************************/
+
+static inline uint32_t tlmpack_mask(uint8_t bits)
+{
+  return bits >= 32 ? 0xffffffffu : ((1u << bits) - 1);
+}
+
+/****************************************************************************
+ * Name: tlmpack_put
+ *
+ * Description:
+ *   Append the low 'bits' bits of val.  Space must have been checked.
+ *
+ ****************************************************************************/
+
+static void tlmpack_put(FAR struct tlmpack_bits_s *bs, uint32_t val,
+                        uint8_t bits)
+{
+  size_t byte;
+  unsigned int shift;
+  unsigned int n;
+
+  val &= tlmpack_mask(bits);
+
+  while (bits > 0)
+    {
+      byte  = bs->pos >> 3;
+      shift = bs->pos & 7;
+      n     = 8 - shift;
+      if (n > bits)
+        {
+          n = bits;
+        }
+
+      if (shift == 0)
+        {
+          bs->buf[byte] = 0;
+        }
+
+      bs->buf[byte] |= (uint8_t)((val & tlmpack_mask(n)) << shift);
+      val     >>= n;
+      bits     -= n;
+      bs->pos  += n;
+    }
+}
+
+/****************************************************************************
+ * Name: tlmpack_get
+ ****************************************************************************/
+
+static uint32_t tlmpack_get(FAR struct tlmpack_bits_s *bs, uint8_t bits)
+{
+  uint32_t val = 0;
+  unsigned int done = 0;
+  unsigned int shift;
+  unsigned int n;
+
+  while (done < bits)
+    {
+      shift = bs->pos & 7;
+      n     = 8 - shift;
+      if (n > bits - done)
+        {
+          n = bits - done;
+        }
+
+      val     |= ((uint32_t)(bs->buf[bs->pos >> 3] >> shift) &
+                  tlmpack_mask(n)) << done;
+      done    += n;
+      bs->pos += n;
+    }
+
+  return val;
+}
+
+/****************************************************************************
+ * Name: tlmpack_zigzag
+ ****************************************************************************/
+
+static inline uint32_t tlmpack_zigzag(int32_t v)
+{
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+/****************************************************************************
+ * Name: tlmpack_unzigzag
+ ****************************************************************************/
+
+static inline int32_t tlmpack_unzigzag(uint32_t v)
+{
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/****************************************************************************
+ * Name: tlmpack_extend
+ *
+ * Description:
+ *   Sign (or zero) extend a 'bits' wide field back to 32 bits.
+ *
+ ****************************************************************************/
+
+static inline int32_t tlmpack_extend(uint32_t v,
+                                     FAR const struct tlmpack_field_s *f)
+{
+  if (f->is_signed && f->bits < 32 && (v & (1u << (f->bits - 1))))
+    {
+      v |= ~tlmpack_mask(f->bits);
+    }
+
+  return (int32_t)v;
+}
+
+/****************************************************************************
+ * Name: tlmpack_delta_fits
+ ****************************************************************************/
+
+static bool tlmpack_delta_fits(FAR const struct tlmpack_encoder_s *enc,
+                               FAR const int32_t *values)
+{
+  FAR const struct tlmpack_field_s *f;
+  uint8_t i;
+
+  for (i = 0; i < enc->schema->nfields; i++)
+    {
+      f = &enc->schema->fields[i];
+      if (f->delta_bits == 0)
+        {
+          continue;
+        }
+
+      /* Wrapping subtraction, the decoder adds back modulo 2^32 */
+
+      if (tlmpack_zigzag((int32_t)((uint32_t)values[i] -
+                                   (uint32_t)enc->prev[i])) >
+          tlmpack_mask(f->delta_bits))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tlmpack_sample_bits
+ ****************************************************************************/
+
+size_t tlmpack_sample_bits(FAR const struct tlmpack_schema_s *schema,
+                           bool absolute)
+{
+  FAR const struct tlmpack_field_s *f;
+  size_t bits = 1;
+  uint8_t i;
+
+  for (i = 0; i < schema->nfields; i++)
+    {
+      f = &schema->fields[i];
+      bits += (absolute || f->delta_bits == 0) ? f->bits : f->delta_bits;
+    }
+
+  return bits;
+}
+
+/****************************************************************************
+ * Name: tlmpack_encoder_init
+ ****************************************************************************/
+
+int tlmpack_encoder_init(FAR struct tlmpack_encoder_s *enc,
+                         FAR const struct tlmpack_schema_s *schema,
+                         FAR uint8_t *buf, size_t size)
+{
+  uint8_t i;
+
+  if (!enc || !schema || !buf || size < 1 ||
+      schema->nfields == 0 || schema->nfields > TLMPACK_MAX_FIELDS)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < schema->nfields; i++)
+    {
+      if (schema->fields[i].bits == 0 || schema->fields[i].bits > 32 ||
+          schema->fields[i].delta_bits > 32)
+        {
+          return -EINVAL;
+        }
+    }
+
+  memset(enc, 0, sizeof(struct tlmpack_encoder_s));
+  enc->schema    = schema;
+  enc->bits.buf  = buf;
+  enc->bits.size = size;
+  enc->bits.pos  = 8;
+  buf[0] = 0;
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tlmpack_append
+ ****************************************************************************/
+
+int tlmpack_append(FAR struct tlmpack_encoder_s *enc,
+                   FAR const int32_t *values)
+{
+  FAR const struct tlmpack_schema_s *schema = enc->schema;
+  FAR const struct tlmpack_field_s *f;
+  bool absolute;
+  uint8_t i;
+
+  if (enc->count == UINT8_MAX)
+    {
+      return -ENOSPC;
+    }
+
+  absolute = (enc->count == 0) || !tlmpack_delta_fits(enc, values);
+
+  if (enc->bits.pos + tlmpack_sample_bits(schema, absolute) >
+      enc->bits.size * 8)
+    {
+      return -ENOSPC;
+    }
+
+  tlmpack_put(&enc->bits, absolute ? 1 : 0, 1);
+
+  for (i = 0; i < schema->nfields; i++)
+    {
+      f = &schema->fields[i];
+      if (absolute || f->delta_bits == 0)
+        {
+          /* Track what the decoder will see, not the caller value, in case
+           * the value does not fit the field width.
+           */
+
+          tlmpack_put(&enc->bits, (uint32_t)values[i], f->bits);
+          enc->prev[i] = tlmpack_extend((uint32_t)values[i] &
+                                        tlmpack_mask(f->bits), f);
+        }
+      else
+        {
+          tlmpack_put(&enc->bits,
+                      tlmpack_zigzag((int32_t)((uint32_t)values[i] -
+                                               (uint32_t)enc->prev[i])),
+                      f->delta_bits);
+          enc->prev[i] = values[i];
+        }
+    }
+
+  enc->count++;
+  enc->bits.buf[0] = enc->count;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tlmpack_finish
+ ****************************************************************************/
+
+size_t tlmpack_finish(FAR struct tlmpack_encoder_s *enc)
+{
+  return (enc->bits.pos + 7) >> 3;
+}
+
+/****************************************************************************
+ * Name: tlmpack_decoder_init
+ ****************************************************************************/
+
+int tlmpack_decoder_init(FAR struct tlmpack_decoder_s *dec,
+                         FAR const struct tlmpack_schema_s *schema,
+                         FAR const uint8_t *buf, size_t len)
+{
+  if (!dec || !schema || !buf || len < 1 ||
+      schema->nfields == 0 || schema->nfields > TLMPACK_MAX_FIELDS)
+    {
+      return -EINVAL;
+    }
+
+  memset(dec, 0, sizeof(struct tlmpack_decoder_s));
+  dec->schema    = schema;
+  dec->bits.buf  = (FAR uint8_t *)buf;
+  dec->bits.size = len;
+  dec->bits.pos  = 8;
+  dec->count     = buf[0];
+
+  return dec->count;
+}
+
+/****************************************************************************
+ * Name: tlmpack_next
+ ****************************************************************************/
+
+int tlmpack_next(FAR struct tlmpack_decoder_s *dec, FAR int32_t *values)
+{
+  FAR const struct tlmpack_schema_s *schema = dec->schema;
+  FAR const struct tlmpack_field_s *f;
+  bool absolute;
+  uint8_t i;
+
+  if (dec->index == dec->count)
+    {
+      return 0;
+    }
+
+  if (dec->bits.pos + 1 > dec->bits.size * 8)
+    {
+      return -EBADMSG;
+    }
+
+  absolute = tlmpack_get(&dec->bits, 1) != 0;
+  if (dec->index == 0 && !absolute)
+    {
+      return -EBADMSG;
+    }
+
+  if (dec->bits.pos + tlmpack_sample_bits(schema, absolute) - 1 >
+      dec->bits.size * 8)
+    {
+      return -EBADMSG;
+    }
+
+  for (i = 0; i < schema->nfields; i++)
+    {
+      f = &schema->fields[i];
+      if (absolute || f->delta_bits == 0)
+        {
+          values[i] = tlmpack_extend(tlmpack_get(&dec->bits, f->bits), f);
+        }
+      else
+        {
+          values[i] = (int32_t)((uint32_t)dec->prev[i] +
+                                (uint32_t)tlmpack_unzigzag(
+                                  tlmpack_get(&dec->bits, f->delta_bits)));
+        }
+
+      dec->prev[i] = values[i];
+    }
+
+  dec->index++;
+  return 1;
+}
@@ -0,0 +1,196 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/tlmpack.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_TLMPACK_TLMPACK_H
+#define __CANSAT_APPS_TLMPACK_TLMPACK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef FAR
+#  define FAR
+#endif
+
+#define TLMPACK_MAX_FIELDS  16
+
+/* Packed frame layout, bits are written LSB first:
+ *
+ *   byte 0   number of samples in the frame
+ *   then for every sample
+ *     1 bit  1 = absolute values, 0 = deltas against the previous sample
+ *     fields in schema order, 'bits' wide when absolute, 'delta_bits'
+ *     wide (zigzag coded) otherwise
+ *
+ * The first sample of a frame is always absolute so each frame decodes on
+ * its own even if the previous one was lost on the link.
+ */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct tlmpack_field_s
+{
+  FAR const char *name;
+  uint8_t bits;        /* Width of the absolute value, 1..32 */
+  uint8_t delta_bits;  /* Width of a delta, 0 to always send absolute */
+  bool    is_signed;   /* Absolute value is two's complement */
+};
+
+struct tlmpack_schema_s
+{
+  FAR const struct tlmpack_field_s *fields;
+  uint8_t nfields;
+};
+
+struct tlmpack_bits_s
+{
+  FAR uint8_t *buf;
+  size_t size;         /* Buffer size in bytes */
+  size_t pos;          /* Current position in bits */
+};
+
+struct tlmpack_encoder_s
+{
+  FAR const struct tlmpack_schema_s *schema;
+  struct tlmpack_bits_s bits;
+  int32_t prev[TLMPACK_MAX_FIELDS];
+  uint8_t count;
+};
+
+struct tlmpack_decoder_s
+{
+  FAR const struct tlmpack_schema_s *schema;
+  struct tlmpack_bits_s bits;
+  int32_t prev[TLMPACK_MAX_FIELDS];
+  uint8_t count;
+  uint8_t index;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: tlmpack_encoder_init
+ *
+ * Description:
+ *   Start a new frame in buf.  The buffer must be at least one byte long.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL on a bad schema or buffer.
+ *
+ ****************************************************************************/
+
+int tlmpack_encoder_init(FAR struct tlmpack_encoder_s *enc,
+                         FAR const struct tlmpack_schema_s *schema,
+                         FAR uint8_t *buf, size_t size);
+
+/****************************************************************************
+ * Name: tlmpack_append
+ *
+ * Description:
+ *   Pack one sample (schema->nfields values) into the frame.  A sample is
+ *   sent as deltas when every field delta fits its delta_bits, otherwise
+ *   it is sent absolute.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSPC if the sample does not fit, in which case
+ *   the frame is left unchanged and should be finished and sent.
+ *
+ ****************************************************************************/
+
+int tlmpack_append(FAR struct tlmpack_encoder_s *enc,
+                   FAR const int32_t *values);
+
+/****************************************************************************
+ * Name: tlmpack_finish
+ *
+ * Description:
+ *   Close the frame.
+ *
+ * Returned Value:
+ *   Number of bytes used in the buffer.
+ *
+ ****************************************************************************/
+
+size_t tlmpack_finish(FAR struct tlmpack_encoder_s *enc);
+
+/****************************************************************************
+ * Name: tlmpack_sample_bits
+ *
+ * Description:
+ *   Size in bits of a sample, absolute or as deltas.  Useful to size frames
+ *   against the link budget.
+ *
+ ****************************************************************************/
+
+size_t tlmpack_sample_bits(FAR const struct tlmpack_schema_s *schema,
+                           bool absolute);
+
+/****************************************************************************
+ * Name: tlmpack_decoder_init
+ *
+ * Returned Value:
+ *   Number of samples in the frame; -EINVAL on an empty buffer.
+ *
+ ****************************************************************************/
+
+int tlmpack_decoder_init(FAR struct tlmpack_decoder_s *dec,
+                         FAR const struct tlmpack_schema_s *schema,
+                         FAR const uint8_t *buf, size_t len);
+
+/****************************************************************************
+ * Name: tlmpack_next
+ *
+ * Description:
+ *   Unpack the next sample into values.
+ *
+ * Returned Value:
+ *   1 if a sample was decoded, 0 at the end of the frame, -EBADMSG if the
+ *   frame is truncated or does not start with an absolute sample.
+ *
+ ****************************************************************************/
+
+int tlmpack_next(FAR struct tlmpack_decoder_s *dec, FAR int32_t *values);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_TLMPACK_TLMPACK_H */
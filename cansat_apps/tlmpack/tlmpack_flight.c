@@ -0,0 +1,58 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/tlmpack_flight.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#ifdef __NuttX__
+#  include <nuttx/config.h>
+#endif
+
+#include "tlmpack_flight.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Widths are sized for a CanSat descent: pressure 0..131071 Pa, temperature
+ * -163.84..163.83 degC, altitude -26214..26214 m.  Deltas are per sample at
+ * 10 Hz or faster.  A delta sample is 57 bits, a keyframe 148 bits.
+ */
+
+static const struct tlmpack_field_s g_flight_fields[TLMPACK_FLIGHT_NFIELDS] =
+{
+  { "time_ms",     32, 10, false },
+  { "pressure_pa", 17,  8, false },
+  { "temp_cdegc",  15,  6, true  },
+  { "lat_e7",      32, 12, true  },
+  { "lon_e7",      32, 12, true  },
+  { "alt_dm",      19,  8, true  },
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tlmpack_schema_s tlmpack_flight_schema =
+{
+  g_flight_fields,
+  TLMPACK_FLIGHT_NFIELDS
+};
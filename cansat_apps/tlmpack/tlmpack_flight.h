@@ -0,0 +1,67 @@
+/****************************************************************************
+ * cansat_apps/tlmpack/tlmpack_flight.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CANSAT_APPS_TLMPACK_TLMPACK_FLIGHT_H
+#define __CANSAT_APPS_TLMPACK_TLMPACK_FLIGHT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "tlmpack.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Telemetry frame type carrying tlmpack_flight_schema samples */
+
+#define TLMPACK_FLIGHT_FRAME_TYPE  0x10
+
+/* Field order of tlmpack_flight_schema */
+
+#define TLMPACK_FLIGHT_TIME        0  /* ms since boot */
+#define TLMPACK_FLIGHT_PRESSURE    1  /* Pa, BarometerClass::compensatePressure */
+#define TLMPACK_FLIGHT_TEMPERATURE 2  /* 0.01 degC */
+#define TLMPACK_FLIGHT_LATITUDE    3  /* 1e-7 deg */
+#define TLMPACK_FLIGHT_LONGITUDE   4  /* 1e-7 deg */
+#define TLMPACK_FLIGHT_ALTITUDE    5  /* dm above MSL */
+#define TLMPACK_FLIGHT_NFIELDS     6
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+EXTERN const struct tlmpack_schema_s tlmpack_flight_schema;
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CANSAT_APPS_TLMPACK_TLMPACK_FLIGHT_H */
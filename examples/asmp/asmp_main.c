@@ -51,6 +51,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -84,6 +85,17 @@
 
 #define MSG_ID_SAYHELLO 1
 
+/* Messages of mqbench worker */
+
+#define MSG_ID_DOORBELL 1
+#define MSG_ID_PING     2
+#define MSG_ID_STREAM   3
+#define MSG_ID_DONE     4
+#define MSG_ID_RING     5
+#define MSG_ID_QUIT     6
+
+#define RING_MEMSIZE    (sizeof(mpmq_ringhdr_t) + 1024)
+
 #define message(format, ...)    printf(format, ##__VA_ARGS__)
 #define err(format, ...)        fprintf(stderr, format, ##__VA_ARGS__)
 
@@ -249,6 +261,179 @@ finish:
   return ret;
 }
 
+static uint64_t bench_usec(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void bench_report(const char *name, uint64_t pingpong,
+                         uint64_t stream, uint32_t count)
+{
+  message("%s: %lu ns/round trip, %lu msg/s\n", name,
+          (unsigned long)(pingpong * 1000 / count),
+          (unsigned long)((uint64_t)count * 1000000 / (stream ? stream : 1)));
+}
+
+static void ring_send(mpmq_ring_t *ring, int8_t msgid, uint32_t data)
+{
+  while (mpmq_ring_trysend(ring, msgid, &data, sizeof(data)) == -EAGAIN);
+}
+
+static int ring_receive(mpmq_ring_t *ring, uint32_t *data)
+{
+  size_t len = sizeof(*data);
+
+  return mpmq_ring_receive(ring, data, &len);
+}
+
+static int run_bench(const char *filename, uint32_t count)
+{
+  mptask_t mptask;
+  mpshm_t shm;
+  mpmq_t mq;
+  mpmq_ring_t tx;
+  mpmq_ring_t rx;
+  uint64_t start;
+  uint64_t pingpong;
+  uint64_t stream;
+  uint32_t msgdata;
+  uint32_t i;
+  int ret, wret;
+  char *buf;
+
+  ret = mptask_init(&mptask, filename);
+  if (ret != 0)
+    {
+      err("mptask_init() failure. %d\n", ret);
+      return ret;
+    }
+
+  ret = mptask_assign(&mptask);
+  if (ret != 0)
+    {
+      err("mptask_assign() failure. %d\n", ret);
+      return ret;
+    }
+
+  ret = mpmq_init(&mq, KEY_MQ, mptask_getcpuid(&mptask));
+  if (ret < 0)
+    {
+      err("mpmq_init() failure. %d\n", ret);
+      return ret;
+    }
+  ret = mptask_bindobj(&mptask, &mq);
+  if (ret < 0)
+    {
+      err("mptask_bindobj(mq) failure. %d\n", ret);
+      return ret;
+    }
+
+  ret = mpshm_init(&shm, KEY_SHM, 2 * RING_MEMSIZE);
+  if (ret < 0)
+    {
+      err("mpshm_init() failure. %d\n", ret);
+      return ret;
+    }
+  ret = mptask_bindobj(&mptask, &shm);
+  if (ret < 0)
+    {
+      err("mptask_binobj(shm) failure. %d\n", ret);
+      return ret;
+    }
+
+  buf = mpshm_attach(&shm, 0);
+  if (!buf)
+    {
+      err("mpshm_attach() failure.\n");
+      return ret;
+    }
+
+  /* Rings must be zero filled before either side uses them */
+
+  memset(buf, 0, 2 * RING_MEMSIZE);
+  mpmq_ring_init(&tx, &mq, MSG_ID_DOORBELL, buf, RING_MEMSIZE);
+  mpmq_ring_init(&rx, &mq, MSG_ID_DOORBELL, buf + RING_MEMSIZE,
+                 RING_MEMSIZE);
+
+  ret = mptask_exec(&mptask);
+  if (ret < 0)
+    {
+      err("mptask_exec() failure. %d\n", ret);
+      goto finish;
+    }
+
+  /* Plain message queue, every message is a FIFO interrupt */
+
+  start = bench_usec();
+  for (i = 0; i < count; i++)
+    {
+      mpmq_send(&mq, MSG_ID_PING, i);
+      mpmq_receive(&mq, &msgdata);
+    }
+  pingpong = bench_usec() - start;
+
+  start = bench_usec();
+  for (i = 0; i < count; i++)
+    {
+      mpmq_send(&mq, MSG_ID_STREAM, i);
+    }
+  mpmq_send(&mq, MSG_ID_DONE, 0);
+  mpmq_receive(&mq, &msgdata);
+  stream = bench_usec() - start;
+
+  if (msgdata != count)
+    {
+      err("mpmq: worker got %lu of %lu messages\n", msgdata, count);
+    }
+  bench_report("mpmq", pingpong, stream, count);
+
+  /* Same through the rings, only the first message of a burst rings */
+
+  mpmq_send(&mq, MSG_ID_RING, 0);
+
+  start = bench_usec();
+  for (i = 0; i < count; i++)
+    {
+      ring_send(&tx, MSG_ID_PING, i);
+      ring_receive(&rx, &msgdata);
+    }
+  pingpong = bench_usec() - start;
+
+  start = bench_usec();
+  for (i = 0; i < count; i++)
+    {
+      ring_send(&tx, MSG_ID_STREAM, i);
+    }
+  ring_send(&tx, MSG_ID_DONE, 0);
+  ring_receive(&rx, &msgdata);
+  stream = bench_usec() - start;
+
+  if (msgdata != count)
+    {
+      err("ring: worker got %lu of %lu messages\n", msgdata, count);
+    }
+  bench_report("ring", pingpong, stream, count);
+
+  ring_send(&tx, MSG_ID_QUIT, 0);
+
+  wret = -1;
+  ret = mptask_destroy(&mptask, false, &wret);
+  if (ret < 0)
+    {
+      err("mptask_destroy() failure. %d\n", ret);
+    }
+
+finish:
+  mpshm_detach(&shm);
+  mpshm_destroy(&shm);
+  mpmq_destroy(&mq);
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -259,6 +444,8 @@ finish:
 
 int main(int argc, FAR char *argv[])
 {
+  uint32_t count;
+
 #ifdef CONFIG_FS_ROMFS
   int ret;
   struct stat buf;
@@ -287,6 +474,20 @@ int main(int argc, FAR char *argv[])
     }
 #endif
 
+  /* asmp bench [count]: mpmq and MP message ring benchmark */
+
+  if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+#ifdef CONFIG_FS_ROMFS
+      snprintf(fullpath, 128, "%s/%s", MOUNTPT, "mqbench");
+#else
+      snprintf(fullpath, 128, "%s/%s", MOUNTPT, "MQBENCH");
+#endif
+      count = argc > 2 ? strtoul(argv[2], NULL, 0) : 0;
+      (void) run_bench(fullpath, count ? count : 10000);
+      return 0;
+    }
+
   if (argc > 1)
     {
       snprintf(fullpath, 128, "%s/%s", MOUNTPT, argv[1]);
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * asmp/worker/mqbench/mqbench.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <nuttx/config.h>
+#include <errno.h>
+
+#include <asmp/types.h>
+#include <asmp/mpshm.h>
+#include <asmp/mpmq.h>
+
+#include "asmp.h"
+
+/* MP object keys and messages. Must be synchronized with supervisor. */
+
+#define KEY_SHM   1
+#define KEY_MQ    2
+
+#define MSG_ID_DOORBELL 1
+#define MSG_ID_PING     2
+#define MSG_ID_STREAM   3
+#define MSG_ID_DONE     4
+#define MSG_ID_RING     5
+#define MSG_ID_QUIT     6
+
+#define RING_MEMSIZE    (sizeof(mpmq_ringhdr_t) + 1024)
+
+#define ASSERT(cond) if (!(cond)) wk_abort()
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void ring_send(mpmq_ring_t *ring, int8_t msgid, uint32_t data)
+{
+  while (mpmq_ring_trysend(ring, msgid, &data, sizeof(data)) == -EAGAIN);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(void)
+{
+  mpshm_t shm;
+  mpmq_t mq;
+  mpmq_ring_t rx;
+  mpmq_ring_t tx;
+  uint32_t data;
+  uint32_t count = 0;
+  size_t len;
+  char *buf;
+  int ret;
+
+  ret = mpmq_init(&mq, KEY_MQ, 0);
+  ASSERT(ret == 0);
+
+  ret = mpshm_init(&shm, KEY_SHM, 2 * RING_MEMSIZE);
+  ASSERT(ret == 0);
+
+  buf = (char *)mpshm_attach(&shm, 0);
+  ASSERT(buf);
+
+  /* First ring carries supervisor to worker, second one the replies */
+
+  ret = mpmq_ring_init(&rx, &mq, MSG_ID_DOORBELL, buf, RING_MEMSIZE);
+  ASSERT(ret == 0);
+  ret = mpmq_ring_init(&tx, &mq, MSG_ID_DOORBELL, buf + RING_MEMSIZE,
+                       RING_MEMSIZE);
+  ASSERT(ret == 0);
+
+  /* Plain message queue, one FIFO message per call */
+
+  for (; ; )
+    {
+      ret = mpmq_receive(&mq, &data);
+      if (ret == MSG_ID_PING)
+        {
+          mpmq_send(&mq, MSG_ID_PING, data);
+        }
+      else if (ret == MSG_ID_STREAM)
+        {
+          count++;
+        }
+      else if (ret == MSG_ID_DONE)
+        {
+          mpmq_send(&mq, MSG_ID_DONE, count);
+          count = 0;
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  /* Same through the rings, the FIFO only carries doorbells */
+
+  for (; ; )
+    {
+      len = sizeof(data);
+      ret = mpmq_ring_receive(&rx, &data, &len);
+      if (ret == MSG_ID_PING)
+        {
+          ring_send(&tx, MSG_ID_PING, data);
+        }
+      else if (ret == MSG_ID_STREAM)
+        {
+          count++;
+        }
+      else if (ret == MSG_ID_DONE)
+        {
+          ring_send(&tx, MSG_ID_DONE, count);
+          count = 0;
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  mpshm_detach(&shm);
+
+  return 0;
+}
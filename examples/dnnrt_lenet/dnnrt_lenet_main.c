@@ -54,6 +54,9 @@ typedef struct
   char *nnb_path;
   char *pgm_path;
   bool skip_norm;
+  unsigned char cpu_num;
+  int repeat;
+  bool profile;
 } my_setting_t;
 
 /****************************************************************************
@@ -62,12 +65,27 @@ typedef struct
 #define DNN_PNM_PATH    "/mnt/sd0/0.pgm"
 #define DNN_NNB_PATH    "/mnt/sd0/lenet-5.nnb"
 #define MNIST_SIZE_PX (28*28)
+#define LAYER_MAX     64
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 static float s_img_buffer[MNIST_SIZE_PX];
 
+#ifdef CONFIG_DNN_RT_PROFILE
+/* one forward propagation of up to LAYER_MAX functions fits in the ring,
+ * the fastest time of each function is kept over the repetitions */
+static dnn_profile_record_t s_prof_records[LAYER_MAX];
+static dnn_profile_t s_prof;
+static uint32_t s_layer_cycles[LAYER_MAX];
+static uint16_t s_layer_type[LAYER_MAX];
+static int s_layer_num;
+#endif
+
+#ifdef CONFIG_ARCH_CHIP_CXD56XX
+extern uint32_t cxd56_get_cpu_baseclk(void);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -103,17 +121,89 @@ static void convert_datatype(dnn_runtime_t * rt)
     }
 }
 
+#ifdef CONFIG_DNN_RT_PROFILE
+static void collect_layers(void)
+{
+  /* fold the records of the last forward propagation into the minimum */
+  const dnn_profile_record_t *rec;
+  uint32_t num;
+  uint32_t i;
+
+  num = s_prof.count < s_prof.capacity ? s_prof.count : s_prof.capacity;
+  for (i = s_prof.count - num; i != s_prof.count; i++)
+    {
+      rec = &s_prof_records[i % s_prof.capacity];
+      if (rec->forward != s_prof.forwards || rec->index >= LAYER_MAX)
+        {
+          continue;
+        }
+      if (s_prof.forwards == 1 || rec->cycles < s_layer_cycles[rec->index])
+        {
+          s_layer_cycles[rec->index] = rec->cycles;
+        }
+      s_layer_type[rec->index] = rec->type;
+      if (rec->index >= s_layer_num)
+        {
+          s_layer_num = rec->index + 1;
+        }
+    }
+}
+
+static void print_layers(unsigned char cpu_num)
+{
+  uint32_t total = 0;
+  uint32_t mhz = 0;
+  int i;
+
+#ifdef CONFIG_ARCH_CHIP_CXD56XX
+  mhz = cxd56_get_cpu_baseclk() / 1000000;
+#endif
+  for (i = 0; i < s_layer_num; i++)
+    {
+      total += s_layer_cycles[i];
+    }
+
+  printf("per-layer latency with %u CPU(s), fastest of %lu:\n",
+         cpu_num, (unsigned long)s_prof.forwards);
+  printf("layer type     cycles     usec  share\n");
+  for (i = 0; i < s_layer_num; i++)
+    {
+      printf("%5d %4u %10lu %8lu %5.1f%%\n", i, s_layer_type[i],
+             (unsigned long)s_layer_cycles[i],
+             mhz ? (unsigned long)(s_layer_cycles[i] / mhz) : 0ul,
+             total ? 100.0f * s_layer_cycles[i] / total : 0.0f);
+    }
+  printf("total %15lu %8lu\n", (unsigned long)total,
+         mhz ? (unsigned long)(total / mhz) : 0ul);
+}
+#endif
+
 static void parse_args(int argc, char *argv[], my_setting_t * setting)
 {
   /* parse options by getopt() */
   int opt;
-  while ((opt = getopt(argc, argv, "s")) != -1)
+  setting->cpu_num = 1;
+  setting->repeat = 1;
+  while ((opt = getopt(argc, argv, "sc:n:p")) != -1)
     {
       switch (opt)
         {
         case 's':              /* skip normalization */
           setting->skip_norm = true;
           break;
+        case 'c':              /* number of CPUs for forward propagation */
+          setting->cpu_num = (unsigned char)atoi(optarg);
+          break;
+        case 'n':              /* number of forward propagations */
+          setting->repeat = atoi(optarg) > 0 ? atoi(optarg) : 1;
+          break;
+        case 'p':              /* per-layer latency */
+#ifdef CONFIG_DNN_RT_PROFILE
+          setting->profile = true;
+#else
+          printf("-p needs CONFIG_DNN_RT_PROFILE, ignored\n");
+#endif
+          break;
         }
     }
 
@@ -132,6 +222,10 @@ static void parse_args(int argc, char *argv[], my_setting_t * setting)
     {
       printf("Image Normalization (1.0/255.0): enabled\n");
     }
+  if (setting->cpu_num != 1 || setting->repeat != 1 || setting->profile)
+    {
+      printf("CPUs: %u, repeat: %d\n", setting->cpu_num, setting->repeat);
+    }
 }
 
 /****************************************************************************
@@ -141,7 +235,8 @@ int main(int argc, FAR char *argv[])
 {
   int ret;
   unsigned char i;
-  float *output_buffer, proc_time, norm_factor;
+  int n;
+  float *output_buffer, proc_time, min_time, total_time, norm_factor;
   const void *inputs[1] = { s_img_buffer };
   dnn_runtime_t rt;
   dnn_config_t config = {.cpu_num = 1 };
@@ -150,6 +245,7 @@ int main(int argc, FAR char *argv[])
   struct timeval begin, end;
 
   parse_args(argc, argv, &setting);
+  config.cpu_num = setting.cpu_num;
 
   /* load an hand-written digit image into s_img_buffer,
    * and then divide the pixels by 255.0 for normalization */
@@ -191,15 +287,49 @@ int main(int argc, FAR char *argv[])
   /* convert the image data to datatype this dnn_runtime_t expects */
   convert_datatype(&rt);
 
+#ifdef CONFIG_DNN_RT_PROFILE
+  /* time each function of the network */
+  if (setting.profile)
+    {
+      s_prof.records = s_prof_records;
+      s_prof.capacity = LAYER_MAX;
+      ret = dnn_set_profile(&s_prof);
+      if (ret)
+        {
+          printf("dnn_set_profile() failed due to %d\n", ret);
+          goto fin;
+        }
+    }
+#endif
+
   /* Step-C: perform inference after feeding inputs */
   printf("start dnn_runtime_forward()\n");
-  gettimeofday(&begin, 0);
-  ret = dnn_runtime_forward(&rt, inputs, 1);
-  gettimeofday(&end, 0);
-  if (ret)
+  min_time = 0.0f;
+  total_time = 0.0f;
+  for (n = 0; n < setting.repeat; n++)
     {
-      printf("dnn_runtime_forward() failed due to %d\n", ret);
-      goto fin;
+      gettimeofday(&begin, 0);
+      ret = dnn_runtime_forward(&rt, inputs, 1);
+      gettimeofday(&end, 0);
+      if (ret)
+        {
+          printf("dnn_runtime_forward() failed due to %d\n", ret);
+          goto fin;
+        }
+
+      proc_time = (float)end.tv_sec + (float)end.tv_usec / 1.0e6;
+      proc_time -= (float)begin.tv_sec + (float)begin.tv_usec / 1.0e6;
+      if (n == 0 || proc_time < min_time)
+        {
+          min_time = proc_time;
+        }
+      total_time += proc_time;
+#ifdef CONFIG_DNN_RT_PROFILE
+      if (setting.profile)
+        {
+          collect_layers();
+        }
+#endif
     }
 
   /* Step-D: obtain the output from this dnn_runtime_t */
@@ -210,11 +340,23 @@ int main(int argc, FAR char *argv[])
     {
       printf("output[%u]=%.6f\n", i, output_buffer[i]);
     }
-  proc_time = (float)end.tv_sec + (float)end.tv_usec / 1.0e6;
-  proc_time -= (float)begin.tv_sec + (float)begin.tv_usec / 1.0e6;
   printf("inference time=%.3f\n", proc_time);
+  if (setting.repeat > 1)
+    {
+      printf("inference time min=%.3f avg=%.3f\n", min_time,
+             total_time / setting.repeat);
+    }
+#ifdef CONFIG_DNN_RT_PROFILE
+  if (setting.profile)
+    {
+      print_layers(setting.cpu_num);
+    }
+#endif
 
 fin:
+#ifdef CONFIG_DNN_RT_PROFILE
+  dnn_set_profile(NULL);
+#endif
   /* Step-F: free memories allocated to dnn_runtime_t */
   dnn_runtime_finalize(&rt);
 rt_error:
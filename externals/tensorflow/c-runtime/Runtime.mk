@@ -1 +1,5 @@
 THIRD_PARTY_CC_SRCS = $(SPRESENSE_CURDIR)/c-runtime/tf_runtime.cc
+
+ifeq ($(SPRESENSE_TF_PROFILE),y)
+CXXFLAGS += -DCONFIG_TFLM_RT_PROFILE=1
+endif
@@ -42,11 +42,30 @@
 
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+
+#include "tf_runtime.h"
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_TFLM_RT_PROFILE
+/* Passes the operator events of the interpreter to tf_rt_op_hook_t */
+
+class tf_rt_profiler : public tflite::MicroProfilerInterface
+{
+public:
+  uint32_t BeginEvent(const char *tag) override;
+  void EndEvent(uint32_t event_handle) override;
+
+  const tflite::Model *model;
+  tf_rt_op_hook_t hook;
+  const char *tag;
+  int index;
+};
+#endif
+
 typedef struct
 {
   tflite::ErrorReporter *error_reporter;
@@ -54,6 +73,9 @@ typedef struct
   tflite::MicroInterpreter *interpreter;
   int tensor_arena_size;
   uint8_t *tensor_arena;
+#ifdef CONFIG_TFLM_RT_PROFILE
+  tf_rt_profiler profiler;
+#endif
 } tf_rt_context_t;
 
 #endif /* __EXTERNALS_TENSORFLOW_C_RUNTIME_TF_CONTEXT_H */
@@ -37,6 +37,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <new>
 #include <stdlib.h>
 
 #include "tf_runtime.h"
@@ -51,6 +52,96 @@
 void *(*tf_rt_malloc_func)(size_t size) = malloc;
 void (*tf_rt_free_func)(void *ptr) = free;
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+static size_t tensor_bytes(const tflite::Tensor *tensor)
+{
+  size_t bytes;
+
+  switch (tensor->type())
+    {
+      case tflite::TensorType_FLOAT32:
+      case tflite::TensorType_INT32:
+      case tflite::TensorType_UINT32:
+        bytes = 4;
+        break;
+      case tflite::TensorType_INT16:
+      case tflite::TensorType_FLOAT16:
+        bytes = 2;
+        break;
+      case tflite::TensorType_INT64:
+      case tflite::TensorType_FLOAT64:
+        bytes = 8;
+        break;
+      default:
+        bytes = 1;
+        break;
+    }
+
+  if (tensor->shape() != nullptr)
+    {
+      for (int32_t dim : *tensor->shape())
+        {
+          bytes *= dim;
+        }
+    }
+
+  return bytes;
+}
+
+/* Only the operators of the primary subgraph are looked up. Events of
+ * nested subgraphs get indexes beyond them and report no output size.
+ */
+
+static size_t operator_output_bytes(const tflite::Model *model, int index)
+{
+  const tflite::SubGraph *subgraph = model->subgraphs()->Get(0);
+  size_t bytes = 0;
+
+  if (subgraph->operators() == nullptr ||
+      index >= (int)subgraph->operators()->size())
+    {
+      return 0;
+    }
+
+  const tflite::Operator *op = subgraph->operators()->Get(index);
+  for (int32_t t : *op->outputs())
+    {
+      if (t >= 0)
+        {
+          bytes += tensor_bytes(subgraph->tensors()->Get(t));
+        }
+    }
+
+  return bytes;
+}
+
+uint32_t tf_rt_profiler::BeginEvent(const char *tag)
+{
+  this->tag = tag;
+  if (hook.begin != nullptr)
+    {
+      hook.begin(hook.arg, index);
+    }
+
+  return index;
+}
+
+void tf_rt_profiler::EndEvent(uint32_t event_handle)
+{
+  if (hook.end != nullptr)
+    {
+      hook.end(hook.arg, event_handle, tag,
+               operator_output_bytes(model, event_handle));
+    }
+
+  index++;
+}
+#endif /* CONFIG_TFLM_RT_PROFILE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +156,9 @@ int tf_rt_allocate_context(tf_rt_context_pointer *context)
     }
 
   memset(c, 0, sizeof(tf_rt_context_t));
+#ifdef CONFIG_TFLM_RT_PROFILE
+  new (&c->profiler) tf_rt_profiler();
+#endif
   *context = c;
 
   return 0;
@@ -84,6 +178,9 @@ int tf_rt_initialize_context(tf_rt_context_pointer context,
    */
 
   c->model = tflite::GetModel(n);
+#ifdef CONFIG_TFLM_RT_PROFILE
+  c->profiler.model = c->model;
+#endif
   if (c->model->version() != TFLITE_SCHEMA_VERSION)
     {
       TF_LITE_REPORT_ERROR(c->error_reporter,
@@ -104,11 +201,19 @@ int tf_rt_initialize_context(tf_rt_context_pointer context,
 
   memset(c->tensor_arena, 0, c->tensor_arena_size);
 
-  /* Build an interpreter to run the model with. */
+  /* Build an interpreter to run the model with. Without profiling, the
+   * interpreter gets no profiler and skips the operator events.
+   */
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+  tflite::MicroProfilerInterface *profiler = &c->profiler;
+#else
+  tflite::MicroProfilerInterface *profiler = nullptr;
+#endif
 
   tflite::MicroInterpreter interpreter(
       c->model, resolver, c->tensor_arena,
-      c->tensor_arena_size, c->error_reporter);
+      c->tensor_arena_size, c->error_reporter, nullptr, profiler);
   c->interpreter = &interpreter;
 
   /* Allocate memory from the tensor_arena for the model's tensors. */
@@ -134,6 +239,9 @@ int tf_rt_free_context(tf_rt_context_pointer *context)
       c->tensor_arena_size = 0;
     }
 
+#ifdef CONFIG_TFLM_RT_PROFILE
+  c->profiler.~tf_rt_profiler();
+#endif
   tf_rt_free_func(*context);
 
   return 0;
@@ -216,6 +324,10 @@ int tf_rt_forward(tf_rt_context_pointer context)
 {
   tf_rt_context_t *c = (tf_rt_context_t *) context;
 
+#ifdef CONFIG_TFLM_RT_PROFILE
+  c->profiler.index = 0;
+#endif
+
   /* Run inference, and report any error */
 
   TfLiteStatus invoke_status = c->interpreter->Invoke();
@@ -251,3 +363,23 @@ void tf_rt_set_free(void (*user_free)(void *ptr))
       tf_rt_free_func = user_free;
     }
 }
+
+void tf_rt_set_op_hook(tf_rt_context_pointer context,
+                       const tf_rt_op_hook_t *hook)
+{
+#ifdef CONFIG_TFLM_RT_PROFILE
+  tf_rt_context_t *c = (tf_rt_context_t *) context;
+
+  if (hook == 0)
+    {
+      memset(&c->profiler.hook, 0, sizeof(tf_rt_op_hook_t));
+    }
+  else
+    {
+      c->profiler.hook = *hook;
+    }
+#else
+  (void)context;
+  (void)hook;
+#endif
+}
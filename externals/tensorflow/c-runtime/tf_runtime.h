@@ -52,6 +52,19 @@ extern "C" {
 
 typedef void *tf_rt_context_pointer;
 
+/* Called around each operator executed by tf_rt_forward(). index counts
+ * the operators from 0 in every forward, output_bytes is the total size
+ * of the outputs of the operator. Only called when the runtime is built
+ * with CONFIG_TFLM_RT_PROFILE.
+ */
+
+typedef struct tf_rt_op_hook
+{
+  void (*begin)(void *arg, int index);
+  void (*end)(void *arg, int index, const char *tag, size_t output_bytes);
+  void *arg;
+} tf_rt_op_hook_t;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -80,6 +93,8 @@ int tf_rt_forward(tf_rt_context_pointer context);
 void tf_rt_set_malloc(void *(*user_malloc)(size_t size));
 void tf_rt_set_free(void (*user_free)(void *ptr));
 size_t tf_rt_arenasize(tf_rt_context_pointer context);
+void tf_rt_set_op_hook(tf_rt_context_pointer context,
+                       const tf_rt_op_hook_t *hook);
 
 #ifdef __cplusplus
 }
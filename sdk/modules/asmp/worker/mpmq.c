@@ -56,6 +56,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* MP message ring records start with a 4 bytes header and are padded to 4
+ * bytes. A record never wraps around, RING_WRAP fills the end of the area
+ * instead.
+ */
+
+#define RING_HDRSIZE         4
+#define RING_WRAP            0xffffffffu
+#define RING_ALIGN(n)        (((n) + 3) & ~3u)
+#define RING_RECORD(id, len) (((uint32_t)(uint8_t)(id) << 16) | (len))
+#define RING_MSGID(r)        ((int)(((r) >> 16) & 0xff))
+#define RING_LEN(r)          ((r) & 0xffff)
+
 union msg {
   uint32_t   word[2];
   struct {
@@ -74,6 +86,38 @@ union msg {
  * Private Functions
  ****************************************************************************/
 
+/* Ring the doorbell if the receiver asked for one since the last doorbell
+ * and has taken that one. The fence pairs with the ones in
+ * mpmq_ring_receive(), so either the receiver sees the new head or we see
+ * its request. The receiver only asks for a doorbell in
+ * mpmq_ring_receive(), so a receiver which polls with
+ * mpmq_ring_tryreceive() gets none, and at most one doorbell is in the
+ * CPU FIFO at any time.
+ */
+
+static int mpmq_ring_doorbell(mpmq_ring_t *ring)
+{
+  uint32_t wait;
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  wait = __atomic_load_n(&ring->hdr->wait, __ATOMIC_RELAXED);
+  if (wait == ring->rung ||
+      __atomic_load_n(&ring->hdr->woken, __ATOMIC_RELAXED) != ring->sent)
+    {
+      return OK;
+    }
+
+  if (mpmq_trysend(ring->mq, ring->doorbell, 0))
+    {
+      return -EAGAIN;
+    }
+
+  ring->rung = wait;
+  ring->sent++;
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -261,3 +305,216 @@ int mpmq_tryreceive(mpmq_t *mq, uint32_t *data)
 
   return ret;
 }
+
+/**
+ * Initialize MP message ring
+ */
+
+int mpmq_ring_init(mpmq_ring_t *ring, mpmq_t *mq, int8_t doorbell,
+                   void *mem, size_t size)
+{
+  uint32_t n;
+
+  if (!ring || !mq || !mem || ((uintptr_t)mem & 3) || doorbell < 0)
+    {
+      return -EINVAL;
+    }
+  if (size < sizeof(mpmq_ringhdr_t) + 8)
+    {
+      return -EINVAL;
+    }
+
+  /* Use the largest power of 2 that fits, so both sides derive the same
+   * size from the same memory.
+   */
+
+  size -= sizeof(mpmq_ringhdr_t);
+  for (n = 8; n <= size / 2; n <<= 1);
+
+  ring->mq       = mq;
+  ring->hdr      = (mpmq_ringhdr_t *)mem;
+  ring->data     = (uint8_t *)mem + sizeof(mpmq_ringhdr_t);
+  ring->size     = n;
+  ring->doorbell = doorbell;
+  ring->rung     = 0;
+  ring->sent     = 0;
+
+  return OK;
+}
+
+/**
+ * Try send message via MP message ring
+ */
+
+int mpmq_ring_trysend(mpmq_ring_t *ring, int8_t msgid, const void *buf,
+                      size_t len)
+{
+  uint32_t need;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t off;
+  uint32_t pad;
+
+  if (!ring || msgid < 0 || len > 0xffff || (len && !buf))
+    {
+      return -EINVAL;
+    }
+
+  /* Limit records to half of the ring, then an empty ring always has room
+   * for the record and its wrap padding.
+   */
+
+  need = RING_HDRSIZE + RING_ALIGN(len);
+  if (need > ring->size / 2)
+    {
+      return -EINVAL;
+    }
+
+  head = ring->hdr->head;
+  tail = __atomic_load_n(&ring->hdr->tail, __ATOMIC_ACQUIRE);
+  off  = head & (ring->size - 1);
+  pad  = (off + need > ring->size) ? ring->size - off : 0;
+
+  if (pad + need > ring->size - (head - tail))
+    {
+      return -EAGAIN;
+    }
+
+  if (pad)
+    {
+      *(uint32_t *)(ring->data + off) = RING_WRAP;
+      off = 0;
+    }
+
+  *(uint32_t *)(ring->data + off) = RING_RECORD(msgid, len);
+  if (len)
+    {
+      wk_memcpy(ring->data + off + RING_HDRSIZE, buf, len);
+    }
+
+  __atomic_store_n(&ring->hdr->head, head + pad + need, __ATOMIC_RELEASE);
+
+  /* The record is committed, a doorbell which doesn't fit in the CPU FIFO
+   * now is sent by the next call or by mpmq_ring_flush().
+   */
+
+  mpmq_ring_doorbell(ring);
+
+  return OK;
+}
+
+/**
+ * Send pending doorbell of MP message ring
+ */
+
+int mpmq_ring_flush(mpmq_ring_t *ring)
+{
+  if (!ring)
+    {
+      return -EINVAL;
+    }
+
+  return mpmq_ring_doorbell(ring);
+}
+
+/**
+ * Try receive message via MP message ring
+ */
+
+int mpmq_ring_tryreceive(mpmq_ring_t *ring, void *buf, size_t *len)
+{
+  uint32_t head;
+  uint32_t tail;
+  uint32_t off;
+  uint32_t rec;
+  uint32_t rlen;
+
+  if (!ring || !len)
+    {
+      return -EINVAL;
+    }
+
+  tail = ring->hdr->tail;
+  head = __atomic_load_n(&ring->hdr->head, __ATOMIC_ACQUIRE);
+  if (head == tail)
+    {
+      return -EAGAIN;
+    }
+
+  off = tail & (ring->size - 1);
+  rec = *(uint32_t *)(ring->data + off);
+  if (rec == RING_WRAP)
+    {
+      /* Published together with the record that follows it */
+
+      tail += ring->size - off;
+      off   = 0;
+      rec   = *(uint32_t *)ring->data;
+    }
+
+  rlen = RING_LEN(rec);
+  if (rlen > *len)
+    {
+      *len = rlen;
+      return -EMSGSIZE;
+    }
+
+  if (rlen)
+    {
+      wk_memcpy(buf, ring->data + off + RING_HDRSIZE, rlen);
+    }
+  *len = rlen;
+
+  __atomic_store_n(&ring->hdr->tail, tail + RING_HDRSIZE + RING_ALIGN(rlen),
+                   __ATOMIC_RELEASE);
+
+  return RING_MSGID(rec);
+}
+
+/**
+ * Receive message via MP message ring
+ */
+
+int mpmq_ring_receive(mpmq_ring_t *ring, void *buf, size_t *len)
+{
+  uint32_t data;
+  int ret;
+
+  for (; ; )
+    {
+      ret = mpmq_ring_tryreceive(ring, buf, len);
+      if (ret != -EAGAIN)
+        {
+          return ret;
+        }
+
+      /* Ask for a doorbell before looking at head again, see
+       * mpmq_ring_doorbell(). If the ring is still empty, the sender will
+       * ring the doorbell for its next record.
+       */
+
+      __atomic_store_n(&ring->hdr->wait, ring->hdr->wait + 1,
+                       __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&ring->hdr->head, __ATOMIC_RELAXED) !=
+          ring->hdr->tail)
+        {
+          continue;
+        }
+
+      ret = mpmq_receive(ring->mq, &data);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The doorbell may be a late one for an earlier request, the sender
+       * holds back further doorbells until it sees this count, and we look
+       * at head again after it.
+       */
+
+      __atomic_store_n(&ring->hdr->woken, ring->hdr->woken + 1,
+                       __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+}
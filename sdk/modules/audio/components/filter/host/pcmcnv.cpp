@@ -0,0 +1,485 @@
+/****************************************************************************
+ * modules/audio/components/filter/host/pcmcnv.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of PcmConverter.
+ *
+ * Random conversions are compared bit for bit against a scalar model of
+ * the documented behavior: samples are widened to 32bit MSB aligned,
+ * multiplied by the Q16.16 gain with saturation and narrowed by
+ * truncation, a float is scaled by 2^31 and clamped, and equal formats
+ * at unity gain are copied as they are. Every case is run with buffers at
+ * all four byte alignments, so both the word kernels and the generic
+ * path are covered, and in place where that is allowed.
+ *
+ * The S32 <-> S24 results are also checked against the loops that
+ * PackingComponent used before the converter, and dithered output against
+ * its +-1 LSB bound and for bias.
+ *
+ *   pcmcnv [cases]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "components/filter/pcm_converter.h"
+
+using namespace Wien2;
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_SAMPLES  512
+#define BUF_BYTES    (MAX_SAMPLES * 4 + 16)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const float g_gains[] =
+{
+  1.0f, 0.5f, 2.0f, 0.25f, 0.7071f, 3.3f, -1.0f
+};
+
+static uint32_t g_seed = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static int64_t load(const uint8_t *p, PcmFormat f)
+{
+  switch (f)
+    {
+      case PcmFormatS16:
+        return (int32_t)((uint32_t)(p[0] | p[1] << 8) << 16);
+
+      case PcmFormatS24:
+        return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 |
+                         (uint32_t)p[2] << 24);
+
+      case PcmFormatS32:
+        {
+          int32_t v;
+
+          memcpy(&v, p, 4);
+          return v;
+        }
+
+      default:
+        {
+          float x;
+
+          memcpy(&x, p, 4);
+          if (x != x)
+            {
+              return 0;
+            }
+
+          if (x >= 1.0f)
+            {
+              return INT32_MAX;
+            }
+
+          if (x < -1.0f)
+            {
+              return INT32_MIN;
+            }
+
+          return (int32_t)(x * 2147483648.0f);
+        }
+    }
+}
+
+static void store(uint8_t *p, PcmFormat f, int32_t v)
+{
+  uint32_t u = (uint32_t)v;
+
+  switch (f)
+    {
+      case PcmFormatS16:
+        p[0] = u >> 16;
+        p[1] = u >> 24;
+        break;
+
+      case PcmFormatS24:
+        p[0] = u >> 8;
+        p[1] = u >> 16;
+        p[2] = u >> 24;
+        break;
+
+      case PcmFormatS32:
+        memcpy(p, &u, 4);
+        break;
+
+      default:
+        {
+          float x = (float)v * (1.0f / 2147483648.0f);
+
+          memcpy(p, &x, 4);
+        }
+        break;
+    }
+}
+
+/* Scalar model, out receives samples * sample_bytes(out_format) bytes */
+
+static void model(const PcmConvertParam &pr, const uint8_t *in, uint8_t *out,
+                  int samples)
+{
+  int bi = PcmConverter::sample_bytes(pr.in_format);
+  int bo = PcmConverter::sample_bytes(pr.out_format);
+  int ch = pr.ch_num;
+  int frames = samples / ch;
+  bool relayout = (ch > 1) && (pr.in_layout != pr.out_layout);
+  int32_t gain = (int32_t)lrintf(pr.gain * 65536.0f);
+
+  for (int s = 0; s < samples; s++)
+    {
+      int d = s;
+
+      if (relayout)
+        {
+          d = (pr.in_layout == PcmInterleaved) ?
+              (s % ch) * frames + s / ch : (s % frames) * ch + s / frames;
+        }
+
+      if ((pr.in_format == pr.out_format) && (gain == 0x10000))
+        {
+          memcpy(out + d * bo, in + s * bi, bi);
+          continue;
+        }
+
+      int64_t v = load(in + s * bi, pr.in_format);
+
+      if (gain != 0x10000)
+        {
+          v = (v * gain) >> 16;
+          v = (v > INT32_MAX) ? INT32_MAX : (v < INT32_MIN) ? INT32_MIN : v;
+        }
+
+      store(out + d * bo, pr.out_format, (int32_t)v);
+    }
+}
+
+/* PackingComponent::cnv32to24() and cnv24to32() before PcmConverter */
+
+static void old_cnv32to24(uint32_t samples, const uint32_t *p_in,
+                          uint32_t *p_out)
+{
+  for (uint32_t cnt = 0; cnt < samples / 4; cnt++)
+    {
+      p_out[0] = ((p_in[0] & 0xffffff00) >> 8) +
+                 ((p_in[1] & 0x0000ff00) << 16);
+      p_out[1] = ((p_in[1] & 0xffff0000) >> 16) +
+                 ((p_in[2] & 0x00ffff00) << 8);
+      p_out[2] = ((p_in[2] & 0xff000000) >> 24) +
+                 ((p_in[3] & 0xffffff00) >> 0);
+      p_out += 3;
+      p_in  += 4;
+    }
+}
+
+static void old_cnv24to32(uint32_t samples, const uint32_t *p_in,
+                          uint32_t *p_out)
+{
+  for (uint32_t cnt = 0; cnt < samples / 4; cnt++)
+    {
+      p_out[0] = (p_in[0] & 0x00ffffff) << 8;
+      p_out[1] = ((p_in[0] & 0xff000000) >> 16) +
+                 ((p_in[1] & 0x0000ffff) << 16);
+      p_out[2] = ((p_in[1] & 0xffff0000) >> 8) +
+                 ((p_in[2] & 0x000000ff) << 24);
+      p_out[3] = p_in[2] & 0xffffff00;
+      p_out += 4;
+      p_in  += 3;
+    }
+}
+
+static void fill_input(uint8_t *in, PcmFormat f, int samples)
+{
+  int bi = PcmConverter::sample_bytes(f);
+
+  for (int i = 0; i < samples * bi; i++)
+    {
+      in[i] = (uint8_t)rnd();
+    }
+
+  if (f == PcmFormatF32)
+    {
+      /* Mostly in range, some beyond full scale, the odd NaN */
+
+      for (int i = 0; i < samples; i++)
+        {
+          float x = (float)(rnd() & 0xffff) / 32768.0f * 1.1f - 1.1f;
+
+          if ((rnd() & 255) == 0)
+            {
+              x = NAN;
+            }
+
+          memcpy(in + 4 * i, &x, 4);
+        }
+    }
+}
+
+static int run_case(void)
+{
+  static uint8_t in_buf[BUF_BYTES];
+  static uint8_t out_buf[BUF_BYTES];
+  static uint8_t ref[BUF_BYTES];
+  PcmConvertParam pr;
+  PcmConverter cnv;
+  int errors = 0;
+
+  pr.in_format  = (PcmFormat)(rnd() % 4);
+  pr.out_format = (PcmFormat)(rnd() % 4);
+  pr.in_layout  = (PcmLayout)(rnd() % 2);
+  pr.out_layout = (PcmLayout)(rnd() % 2);
+  pr.ch_num     = 1 + rnd() % 4;
+  pr.gain       = g_gains[rnd() % (sizeof(g_gains) / sizeof(g_gains[0]))];
+  pr.dither     = false;
+
+  if (!cnv.init(pr))
+    {
+      printf("init failed\n");
+      return 1;
+    }
+
+  int frames  = rnd() % (MAX_SAMPLES / pr.ch_num + 1);
+  int samples = frames * pr.ch_num;
+  int bi      = PcmConverter::sample_bytes(pr.in_format);
+  int bo      = PcmConverter::sample_bytes(pr.out_format);
+  bool relayout = (pr.ch_num > 1) && (pr.in_layout != pr.out_layout);
+
+  uint8_t *src = in_buf + 8;
+
+  fill_input(src, pr.in_format, samples);
+  memset(ref, 0xaa, sizeof(ref));
+  model(pr, src, ref, samples);
+
+  for (int align = 0; align < 4; align++)
+    {
+      uint8_t *in  = in_buf + 8 + align;
+      uint8_t *out = out_buf + 8 + ((align * 3) & 3);
+
+      memmove(in, src, samples * bi);
+      src = in;
+      memset(out_buf, 0xaa, sizeof(out_buf));
+
+      if (!cnv.exec(in, out, samples) ||
+          memcmp(out, ref, samples * bo) != 0 ||
+          out[samples * bo] != 0xaa || out[-1] != 0xaa)
+        {
+          errors++;
+          if (errors < 4)
+            {
+              printf("mismatch: %d->%d layout %d->%d ch %d gain %g "
+                     "samples %d align %d\n", pr.in_format, pr.out_format,
+                     pr.in_layout, pr.out_layout, pr.ch_num, pr.gain,
+                     samples, align);
+            }
+        }
+
+      /* In place, when the converter allows it */
+
+      if (!relayout && bo <= bi)
+        {
+          memcpy(out, in, samples * bi);
+          if (!cnv.exec(out, out, samples) ||
+              memcmp(out, ref, samples * bo) != 0)
+            {
+              errors++;
+              printf("in place mismatch: %d->%d gain %g samples %d "
+                     "align %d\n", pr.in_format, pr.out_format, pr.gain,
+                     samples, align);
+            }
+        }
+      else
+        {
+          if (cnv.exec(out, out, samples))
+            {
+              errors++;
+              printf("in place accepted: %d->%d\n", pr.in_format,
+                     pr.out_format);
+            }
+        }
+    }
+
+  return errors;
+}
+
+static int test_old_loops(void)
+{
+  static uint32_t in[MAX_SAMPLES];
+  static uint32_t out[MAX_SAMPLES];
+  static uint32_t ref[MAX_SAMPLES];
+  PcmConvertParam pr;
+  PcmConverter cnv32to24;
+  PcmConverter cnv24to32;
+  int errors = 0;
+
+  pr.in_format  = PcmFormatS32;
+  pr.out_format = PcmFormatS24;
+  pr.in_layout  = PcmInterleaved;
+  pr.out_layout = PcmInterleaved;
+  pr.ch_num     = 1;
+  pr.gain       = 1.0f;
+  pr.dither     = false;
+  cnv32to24.init(pr);
+
+  pr.in_format  = PcmFormatS24;
+  pr.out_format = PcmFormatS32;
+  cnv24to32.init(pr);
+
+  for (int i = 0; i < 10000; i++)
+    {
+      uint32_t samples = (rnd() % (MAX_SAMPLES / 4 + 1)) * 4;
+
+      for (uint32_t j = 0; j < samples; j++)
+        {
+          in[j] = rnd() << 8 ^ rnd();
+        }
+
+      old_cnv32to24(samples, in, ref);
+      cnv32to24.exec(in, out, samples);
+      errors += memcmp(out, ref, samples * 3) != 0;
+
+      old_cnv24to32(samples, in, ref);
+      cnv24to32.exec(in, out, samples);
+      errors += memcmp(out, ref, samples * 4) != 0;
+    }
+
+  if (errors)
+    {
+      printf("old loops: %d mismatches\n", errors);
+    }
+
+  return errors;
+}
+
+static int test_dither(PcmFormat out_format)
+{
+  static int32_t in[MAX_SAMPLES];
+  static uint8_t out[MAX_SAMPLES * 4];
+  PcmConvertParam pr;
+  PcmConverter cnv;
+  double lsb = (out_format == PcmFormatS16) ? 65536.0 : 256.0;
+  double sum = 0;
+  long count = 0;
+  int errors = 0;
+
+  pr.in_format  = PcmFormatS32;
+  pr.out_format = out_format;
+  pr.in_layout  = PcmInterleaved;
+  pr.out_layout = PcmInterleaved;
+  pr.ch_num     = 1;
+  pr.gain       = 1.0f;
+  pr.dither     = true;
+  cnv.init(pr);
+
+  for (int i = 0; i < 2000; i++)
+    {
+      for (int j = 0; j < MAX_SAMPLES; j++)
+        {
+          in[j] = (int32_t)(rnd() << 8 ^ rnd()) / 2;
+        }
+
+      cnv.exec(in, out, MAX_SAMPLES);
+
+      for (int j = 0; j < MAX_SAMPLES; j++)
+        {
+          double err = (double)load(out + j * PcmConverter::sample_bytes(
+                                    out_format), out_format) - in[j];
+
+          /* +-1 LSB of noise around rounding to nearest */
+
+          if (fabs(err) > 1.5 * lsb)
+            {
+              errors++;
+            }
+
+          sum += err;
+          count++;
+        }
+    }
+
+  if (fabs(sum / count) > 0.01 * lsb)
+    {
+      printf("dither %d: bias %f LSB\n", out_format, sum / count / lsb);
+      errors++;
+    }
+
+  if (errors)
+    {
+      printf("dither %d: %d errors\n", out_format, errors);
+    }
+
+  return errors;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  int cases = (argc > 1) ? atoi(argv[1]) : 200000;
+  int errors = 0;
+
+  for (int i = 0; i < cases; i++)
+    {
+      errors += run_case();
+    }
+
+  errors += test_old_loops();
+  errors += test_dither(PcmFormatS16);
+  errors += test_dither(PcmFormatS24);
+
+  printf("%d cases, %d errors\n", cases, errors);
+  return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/****************************************************************************
+ * modules/audio/components/filter/host/pcmcnv_bench.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of PcmConverter: time per sample of every format pair
+ * on aligned buffers (word kernels where there is one) and on buffers
+ * one byte off (generic path), then gain, dither and a planar output.
+ *
+ * Cycles are the x86 time stamp counter, which runs at the nominal clock
+ * rate; on other hosts only ns/sample is shown. The numbers compare paths
+ * with each other, Cortex-M4 figures have to be measured on the target.
+ *
+ *   pcmcnv_bench [samples per call] [calls]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define HAVE_TSC 1
+#endif
+
+#include "components/filter/pcm_converter.h"
+
+using namespace Wien2;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_names[] =
+{
+  "s16", "s24", "s32", "f32"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void bench(const char *label, const PcmConvertParam &pr, int offset,
+                  uint32_t samples, int calls)
+{
+  static uint8_t in[65536 * 4 + 8];
+  static uint8_t out[65536 * 4 + 8];
+  PcmConverter cnv;
+  uint64_t t0;
+  uint64_t c0;
+  double total;
+
+  cnv.init(pr);
+
+  for (uint32_t i = 0; i < samples * 4; i++)
+    {
+      in[offset + i] = (uint8_t)(i * 37);
+    }
+
+  if (pr.in_format == PcmFormatF32)
+    {
+      for (uint32_t i = 0; i < samples; i++)
+        {
+          float x = (float)((int)(i * 7919 % 65536) - 32768) / 32768.0f;
+
+          memcpy(in + offset + 4 * i, &x, 4);
+        }
+    }
+
+  cnv.exec(in + offset, out + offset, samples);
+
+  t0 = now_ns();
+  c0 = cycles();
+
+  for (int i = 0; i < calls; i++)
+    {
+      cnv.exec(in + offset, out + offset, samples);
+    }
+
+  c0 = cycles() - c0;
+  t0 = now_ns() - t0;
+  total = (double)samples * calls;
+
+#ifdef HAVE_TSC
+  printf("%-24s %8.3f ns/sample %8.2f cycles/sample\n", label,
+         t0 / total, c0 / total);
+#else
+  (void)c0;
+  printf("%-24s %8.3f ns/sample\n", label, t0 / total);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  uint32_t samples = (argc > 1) ? atoi(argv[1]) : 1024;
+  int calls = (argc > 2) ? atoi(argv[2]) : 20000;
+  PcmConvertParam pr;
+  char label[64];
+
+  if (samples == 0 || samples > 65536)
+    {
+      printf("samples must be 1..65536\n");
+      return EXIT_FAILURE;
+    }
+
+  pr.in_layout  = PcmInterleaved;
+  pr.out_layout = PcmInterleaved;
+  pr.ch_num     = 1;
+  pr.gain       = 1.0f;
+  pr.dither     = false;
+
+  for (int fi = 0; fi < 4; fi++)
+    {
+      for (int fo = 0; fo < 4; fo++)
+        {
+          if (fi == fo)
+            {
+              continue;
+            }
+
+          pr.in_format  = (PcmFormat)fi;
+          pr.out_format = (PcmFormat)fo;
+
+          snprintf(label, sizeof(label), "%s->%s", g_names[fi], g_names[fo]);
+          bench(label, pr, 0, samples, calls);
+
+          snprintf(label, sizeof(label), "%s->%s unaligned", g_names[fi],
+                   g_names[fo]);
+          bench(label, pr, 1, samples, calls);
+        }
+    }
+
+  pr.in_format  = PcmFormatS16;
+  pr.out_format = PcmFormatS16;
+  pr.gain       = 0.5f;
+  bench("s16 gain", pr, 0, samples, calls);
+  bench("s16 gain unaligned", pr, 1, samples, calls);
+
+  pr.in_format  = PcmFormatS32;
+  pr.gain       = 1.0f;
+  pr.dither     = true;
+  bench("s32->s16 dither", pr, 0, samples, calls);
+
+  pr.out_format = PcmFormatS24;
+  bench("s32->s24 dither", pr, 0, samples, calls);
+
+  pr.dither     = false;
+  pr.out_format = PcmFormatS16;
+  pr.ch_num     = 2;
+  pr.out_layout = PcmPlanar;
+  bench("s32->s16 2ch to planar", pr, 0, samples & ~1u, calls);
+
+  return EXIT_SUCCESS;
+}
@@ -37,6 +37,28 @@
 
 __WIEN2_BEGIN_NAMESPACE
 
+/*--------------------------------------------------------------------*/
+static bool bitwidth_to_format(uint16_t bitwidth, PcmFormat *format)
+{
+  switch (bitwidth)
+    {
+      case BitWidth16bit:
+        *format = PcmFormatS16;
+        return true;
+
+      case BitWidth24bit:
+        *format = PcmFormatS24;
+        return true;
+
+      case BitWidth32bit:
+        *format = PcmFormatS32;
+        return true;
+
+      default:
+        return false;
+    }
+}
+
 /*--------------------------------------------------------------------*/
 /* Methods of PackingComponent class */
 /*--------------------------------------------------------------------*/
@@ -70,7 +92,26 @@ uint32_t PackingComponent::init(const InitComponentParam& param)
   m_in_bitwidth  = param.common.in_bitlength;
   m_out_bitwidth = param.common.out_bitlength;
 
-  /* Hold dummy. */
+  /* Sample format conversion only, layout and level are kept */
+
+  PcmConvertParam cnv_param;
+
+  cnv_param.in_layout  = PcmInterleaved;
+  cnv_param.out_layout = PcmInterleaved;
+  cnv_param.ch_num     = 1;
+  cnv_param.gain       = 1.0f;
+  cnv_param.dither     = false;
+
+  if (!bitwidth_to_format(m_in_bitwidth, &cnv_param.in_format)
+   || !bitwidth_to_format(m_out_bitwidth, &cnv_param.out_format)
+   || !m_converter.init(cnv_param))
+    {
+      return AS_ECODE_COMMAND_PARAM_BIT_LENGTH;
+    }
+
+  /* Hold dummy only once the widths are accepted, so that a failed init
+   * leaves no request behind.
+   */
 
   AsPcmDataParam dummy;
 
@@ -104,7 +145,8 @@ bool PackingComponent::set(const SetComponentParam& param)
 /*--------------------------------------------------------------------*/
 bool PackingComponent::exec(const ExecComponentParam& param)
 {
-  void (PackingComponent::*convfunc)(uint32_t, int8_t *, int8_t *);
+  PcmFormat in_format;
+  PcmFormat out_format;
   uint32_t outsize = 0;
   bool result = false;
 
@@ -119,29 +161,21 @@ bool PackingComponent::exec(const ExecComponentParam& param)
 
   /* Execute packing */
 
-  if ((m_in_bitwidth == BitWidth32bit) && (m_out_bitwidth == BitWidth24bit))
-    {
-      convfunc = &PackingComponent::cnv32to24;
-      outsize  = param.input.size * BitWidth24bit / BitWidth32bit;
-    }
-  else if ((m_in_bitwidth == BitWidth24bit) && (m_out_bitwidth == BitWidth32bit))
-    {
-      convfunc = &PackingComponent::cnv24to32;
-      outsize  = param.input.size * BitWidth32bit / BitWidth24bit;
-    }
-  else
+  if (!bitwidth_to_format(m_in_bitwidth, &in_format)
+   || !bitwidth_to_format(m_out_bitwidth, &out_format))
     {
       return false;
     }
 
+  outsize = m_converter.out_size(param.input.size);
+
   /* Excec convert */
 
   if (outsize <= param.output.getSize())
     {
-      (this->*convfunc)(param.input.size / (m_in_bitwidth / 8),
-                        reinterpret_cast<int8_t *>(param.input.mh.getPa()),
-                        reinterpret_cast<int8_t *>(param.output.getPa()));
-      result = true;
+      result = m_converter.exec(param.input.mh.getPa(),
+                                param.output.getPa(),
+                                param.input.size / (m_in_bitwidth / 8));
     }
  
   /* Hold result */
@@ -231,45 +265,6 @@ bool PackingComponent::recv_done(void)
   return true;
 }
 
-/*--------------------------------------------------------------------*/
-void PackingComponent::cnv32to24(uint32_t samples, int8_t *in, int8_t *out)
-{
-  /** For Little endian data ! **/
-
-  uint32_t *p_in  = (uint32_t *)in;
-  uint32_t *p_out = (uint32_t *)out;
-
-  for (uint32_t cnt = 0; cnt < samples / 4; cnt++)
-    {
-      *(p_out+0) = (uint32_t)(((*(p_in+0) & 0xFFFFFF00) >> 8 ) + ((*(p_in+1) & 0x0000FF00) << 16));
-      *(p_out+1) = (uint32_t)(((*(p_in+1) & 0xFFFF0000) >> 16) + ((*(p_in+2) & 0x00FFFF00) << 8 ));
-      *(p_out+2) = (uint32_t)(((*(p_in+2) & 0xFF000000) >> 24) + ((*(p_in+3) & 0xFFFFFF00) >> 0 ));
-
-      p_out +=3;
-      p_in  +=4;
-    }
-}
-
-/*--------------------------------------------------------------------*/
-void PackingComponent::cnv24to32(uint32_t samples, int8_t *in, int8_t *out)
-{
-  /** For Little endian data ! **/
-
-  uint32_t *p_in  = (uint32_t *)in;
-  uint32_t *p_out = (uint32_t *)out;
-
-  for (uint32_t cnt = 0; cnt < samples / 4; cnt++)
-    {
-      *(p_out+0) = (uint32_t)( (*(p_in+0) & 0x00FFFFFF) << 8 );
-      *(p_out+1) = (uint32_t)(((*(p_in+0) & 0xFF000000) >> 16) + ((*(p_in+1) & 0x0000FFFF) << 16));
-      *(p_out+2) = (uint32_t)(((*(p_in+1) & 0xFFFF0000) >> 8 ) + ((*(p_in+2) & 0x000000FF) << 24));
-      *(p_out+3) = (uint32_t)(  *(p_in+2) & 0xFFFFFF00);
-
-      p_out +=4;
-      p_in  +=3;
-    }
-}
-
 /*--------------------------------------------------------------------*/
 void PackingComponent::send_resp(ComponentEventType evt, bool result)
 {
@@ -0,0 +1,550 @@
+/****************************************************************************
+ * modules/audio/components/filter/pcm_converter.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "components/filter/pcm_converter.h"
+
+__WIEN2_BEGIN_NAMESPACE
+
+/*--------------------------------------------------------------------*/
+/* DSP extension instructions. The C versions give identical results. */
+/*--------------------------------------------------------------------*/
+
+/* (a * bottom half of b) >> 16 */
+
+static inline int32_t smulwb(int32_t a, uint32_t b)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t r;
+  __asm__ ("smulwb %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+  return r;
+#else
+  return (int32_t)(((int64_t)a * (int16_t)b) >> 16);
+#endif
+}
+
+/* (a * top half of b) >> 16 */
+
+static inline int32_t smulwt(int32_t a, uint32_t b)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t r;
+  __asm__ ("smulwt %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+  return r;
+#else
+  return (int32_t)(((int64_t)a * (int16_t)(b >> 16)) >> 16);
+#endif
+}
+
+/* Saturate to 16bit */
+
+static inline int32_t ssat16(int32_t a)
+{
+#ifdef __ARM_FEATURE_DSP
+  int32_t r;
+  __asm__ ("ssat %0, #16, %1" : "=r" (r) : "r" (a));
+  return r;
+#else
+  return (a < -32768) ? -32768 : (a > 32767) ? 32767 : a;
+#endif
+}
+
+/* Bottom half of lo and bottom half of hi, as bottom and top halves */
+
+static inline uint32_t pkhbt(uint32_t lo, uint32_t hi)
+{
+#ifdef __ARM_FEATURE_DSP
+  uint32_t r;
+  __asm__ ("pkhbt %0, %1, %2, lsl #16" : "=r" (r) : "r" (lo), "r" (hi));
+  return r;
+#else
+  return (lo & 0x0000ffff) | (hi << 16);
+#endif
+}
+
+/* Top half of lo and top half of hi, as bottom and top halves */
+
+static inline uint32_t pkhtb(uint32_t hi, uint32_t lo)
+{
+#ifdef __ARM_FEATURE_DSP
+  uint32_t r;
+  __asm__ ("pkhtb %0, %1, %2, asr #16" : "=r" (r) : "r" (hi), "r" (lo));
+  return r;
+#else
+  return (hi & 0xffff0000) | (lo >> 16);
+#endif
+}
+
+static inline int32_t sat32(int64_t v)
+{
+  return (v < INT32_MIN) ? INT32_MIN : (v > INT32_MAX) ? INT32_MAX : v;
+}
+
+/*--------------------------------------------------------------------*/
+/* Word kernels, 4 samples per loop. Each group is read completely    */
+/* before it is written, so they also work in place when the output  */
+/* is not larger.                                                     */
+/*--------------------------------------------------------------------*/
+
+static void cnv_s32_s24(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 4, out += 3)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+      uint32_t i2 = in[2];
+      uint32_t i3 = in[3];
+
+      out[0] = (i0 >> 8)  | ((i1 & 0x0000ff00) << 16);
+      out[1] = (i1 >> 16) | ((i2 & 0x00ffff00) << 8);
+      out[2] = (i2 >> 24) |  (i3 & 0xffffff00);
+    }
+}
+
+static void cnv_s24_s32(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 3, out += 4)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+      uint32_t i2 = in[2];
+
+      out[0] =  i0 << 8;
+      out[1] = ((i0 >> 16) & 0x0000ff00) | (i1 << 16);
+      out[2] = ((i1 >> 8)  & 0x00ffff00) | (i2 << 24);
+      out[3] =   i2 & 0xffffff00;
+    }
+}
+
+static void cnv_s32_s16(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 4, out += 2)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+      uint32_t i2 = in[2];
+      uint32_t i3 = in[3];
+
+      out[0] = pkhtb(i1, i0);
+      out[1] = pkhtb(i3, i2);
+    }
+}
+
+static void cnv_s16_s32(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 2, out += 4)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+
+      out[0] = i0 << 16;
+      out[1] = i0 & 0xffff0000;
+      out[2] = i1 << 16;
+      out[3] = i1 & 0xffff0000;
+    }
+}
+
+static void cnv_s24_s16(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 3, out += 2)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+      uint32_t i2 = in[2];
+
+      out[0] = pkhbt(i0 >> 8, i1);
+      out[1] = (i1 >> 24) | ((i2 & 0xff) << 8) | (i2 & 0xffff0000);
+    }
+}
+
+static void cnv_s16_s24(uint32_t groups, const uint32_t *in, uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 2, out += 3)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+
+      out[0] = (i0 & 0x0000ffff) << 8;
+      out[1] = (i0 >> 16) | (i1 << 24);
+      out[2] = ((i1 >> 8) & 0xff) | (i1 & 0xffff0000);
+    }
+}
+
+static void gain_s16(uint32_t groups, int32_t gain, const uint32_t *in,
+                     uint32_t *out)
+{
+  for (; groups > 0; groups--, in += 2, out += 2)
+    {
+      uint32_t i0 = in[0];
+      uint32_t i1 = in[1];
+
+      out[0] = pkhbt(ssat16(smulwb(gain, i0)), ssat16(smulwt(gain, i0)));
+      out[1] = pkhbt(ssat16(smulwb(gain, i1)), ssat16(smulwt(gain, i1)));
+    }
+}
+
+/*--------------------------------------------------------------------*/
+/* Methods of PcmConverter class */
+/*--------------------------------------------------------------------*/
+uint32_t PcmConverter::sample_bytes(PcmFormat format)
+{
+  switch (format)
+    {
+      case PcmFormatS16:
+        return 2;
+
+      case PcmFormatS24:
+        return 3;
+
+      case PcmFormatS32:
+      case PcmFormatF32:
+        return 4;
+
+      default:
+        return 0;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+bool PcmConverter::init(const PcmConvertParam& param)
+{
+  float gain = param.gain * 65536.0f;
+
+  if ((sample_bytes(param.in_format) == 0)
+   || (sample_bytes(param.out_format) == 0)
+   || (param.ch_num == 0))
+    {
+      return false;
+    }
+
+  m_param     = param;
+  m_in_bytes  = sample_bytes(param.in_format);
+  m_out_bytes = sample_bytes(param.out_format);
+
+  if (gain > 2147483647.0f)
+    {
+      gain = 2147483647.0f;
+    }
+  else if (gain < -2147483647.0f)
+    {
+      gain = -2147483647.0f;
+    }
+
+  m_gain = (int32_t)((gain >= 0) ? gain + 0.5f : gain - 0.5f);
+
+  return true;
+}
+
+/*--------------------------------------------------------------------*/
+bool PcmConverter::exec(const void *in, void *out, uint32_t samples)
+{
+  const uint8_t *p_in  = static_cast<const uint8_t *>(in);
+  uint8_t       *p_out = static_cast<uint8_t *>(out);
+  uint32_t ch = m_param.ch_num;
+  uint32_t frames;
+
+  bool relayout = (ch > 1) && (m_param.in_layout != m_param.out_layout);
+
+  if ((in == out) && (relayout || (m_out_bytes > m_in_bytes)))
+    {
+      return false;
+    }
+
+  if (!relayout)
+    {
+      if (!exec_fast(in, out, samples))
+        {
+          exec_chunk(p_in, 0, 1, p_out, 0, 1, samples);
+        }
+
+      return true;
+    }
+
+  /* Walk one channel at a time, contiguous on the planar side and with
+   * a stride of ch on the interleaved side.
+   */
+
+  frames = samples / ch;
+
+  for (uint32_t c = 0; c < ch; c++)
+    {
+      if (m_param.in_layout == PcmInterleaved)
+        {
+          exec_chunk(p_in, c, ch, p_out, c * frames, 1, frames);
+        }
+      else
+        {
+          exec_chunk(p_in, c * frames, 1, p_out, c, ch, frames);
+        }
+    }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------*/
+bool PcmConverter::exec_fast(const void *in, void *out, uint32_t samples)
+{
+  void (*kernel)(uint32_t, const uint32_t *, uint32_t *) = NULL;
+  uint32_t groups = samples / 4;
+  uint32_t done   = groups * 4;
+
+  const uint32_t *p_in  = static_cast<const uint32_t *>(in);
+  uint32_t       *p_out = static_cast<uint32_t *>(out);
+
+  if (m_param.dither || (((uintptr_t)in | (uintptr_t)out) & 3))
+    {
+      return false;
+    }
+
+  if (m_gain != 0x10000)
+    {
+      /* Only 16bit gain has a kernel */
+
+      if ((m_param.in_format != PcmFormatS16)
+       || (m_param.out_format != PcmFormatS16))
+        {
+          return false;
+        }
+
+      gain_s16(groups, m_gain, p_in, p_out);
+    }
+  else if (m_param.in_format == m_param.out_format)
+    {
+      if (in != out)
+        {
+          memmove(out, in, samples * m_in_bytes);
+        }
+
+      return true;
+    }
+  else
+    {
+      switch (m_param.in_format * 4 + m_param.out_format)
+        {
+          case PcmFormatS32 * 4 + PcmFormatS24:
+            kernel = cnv_s32_s24;
+            break;
+
+          case PcmFormatS24 * 4 + PcmFormatS32:
+            kernel = cnv_s24_s32;
+            break;
+
+          case PcmFormatS32 * 4 + PcmFormatS16:
+            kernel = cnv_s32_s16;
+            break;
+
+          case PcmFormatS16 * 4 + PcmFormatS32:
+            kernel = cnv_s16_s32;
+            break;
+
+          case PcmFormatS24 * 4 + PcmFormatS16:
+            kernel = cnv_s24_s16;
+            break;
+
+          case PcmFormatS16 * 4 + PcmFormatS24:
+            kernel = cnv_s16_s24;
+            break;
+
+          default:
+            return false;
+        }
+
+      kernel(groups, p_in, p_out);
+    }
+
+  /* Remainder of less than 4 samples */
+
+  exec_chunk(static_cast<const uint8_t *>(in), done, 1,
+             static_cast<uint8_t *>(out), done, 1, samples - done);
+
+  return true;
+}
+
+/*--------------------------------------------------------------------*/
+void PcmConverter::exec_chunk(const uint8_t *in, uint32_t in_idx,
+                              uint32_t in_stride, uint8_t *out,
+                              uint32_t out_idx, uint32_t out_stride,
+                              uint32_t samples)
+{
+  int32_t buf[ChunkSamples];
+  int shift = 0;
+
+  if ((m_param.in_format == m_param.out_format) && (m_gain == 0x10000))
+    {
+      /* Plain copy, so that float keeps values beyond full scale and
+       * the result does not depend on the buffer alignment.
+       */
+
+      for (; samples > 0; samples--, in_idx += in_stride,
+                          out_idx += out_stride)
+        {
+          memmove(out + out_idx * m_out_bytes, in + in_idx * m_in_bytes,
+                  m_in_bytes);
+        }
+
+      return;
+    }
+
+  if (m_param.dither)
+    {
+      shift = (m_param.out_format == PcmFormatS16) ? 16 :
+              (m_param.out_format == PcmFormatS24) ? 8 : 0;
+    }
+
+  while (samples > 0)
+    {
+      uint32_t n = (samples < ChunkSamples) ? samples : ChunkSamples;
+      uint32_t i;
+
+      /* Load as 32bit, MSB aligned. This path also serves unaligned
+       * buffers, so samples are accessed with memcpy() : an unaligned
+       * VLDR (float) faults on Cortex-M4.
+       */
+
+      for (i = 0; i < n; i++)
+        {
+          const uint8_t *p = in + (in_idx + i * in_stride) * m_in_bytes;
+
+          switch (m_param.in_format)
+            {
+              case PcmFormatS16:
+                {
+                  uint16_t h;
+
+                  memcpy(&h, p, sizeof(h));
+                  buf[i] = (int32_t)((uint32_t)h << 16);
+                }
+                break;
+
+              case PcmFormatS24:
+                buf[i] = (int32_t)(((uint32_t)p[0] << 8)
+                                 | ((uint32_t)p[1] << 16)
+                                 | ((uint32_t)p[2] << 24));
+                break;
+
+              case PcmFormatS32:
+                memcpy(&buf[i], p, sizeof(buf[i]));
+                break;
+
+              default:
+                {
+                  float f;
+
+                  memcpy(&f, p, sizeof(f));
+
+                  buf[i] = (f >= 1.0f)  ? INT32_MAX :
+                           (f < -1.0f)  ? INT32_MIN :
+                           (f != f)     ? 0 :
+                           (int32_t)(f * 2147483648.0f);
+                }
+                break;
+            }
+        }
+
+      if (m_gain != 0x10000)
+        {
+          for (i = 0; i < n; i++)
+            {
+              buf[i] = sat32(((int64_t)buf[i] * m_gain) >> 16);
+            }
+        }
+
+      if (shift)
+        {
+          /* TPDF noise of +-1 LSB plus 1/2 LSB, so that the truncation
+           * below rounds.
+           */
+
+          for (i = 0; i < n; i++)
+            {
+              uint32_t r = m_seed;
+
+              r ^= r << 13;
+              r ^= r >> 17;
+              r ^= r << 5;
+              m_seed = r;
+
+              buf[i] = sat32((int64_t)buf[i]
+                             + ((r & 0xffff) >> (16 - shift))
+                             + ((r >> 16) >> (16 - shift))
+                             - (1 << (shift - 1)));
+            }
+        }
+
+      /* Store */
+
+      for (i = 0; i < n; i++)
+        {
+          uint8_t *p = out + (out_idx + i * out_stride) * m_out_bytes;
+          uint32_t v = (uint32_t)buf[i];
+
+          switch (m_param.out_format)
+            {
+              case PcmFormatS16:
+                {
+                  uint16_t h = (uint16_t)(v >> 16);
+
+                  memcpy(p, &h, sizeof(h));
+                }
+                break;
+
+              case PcmFormatS24:
+                p[0] = (uint8_t)(v >> 8);
+                p[1] = (uint8_t)(v >> 16);
+                p[2] = (uint8_t)(v >> 24);
+                break;
+
+              case PcmFormatS32:
+                memcpy(p, &v, sizeof(v));
+                break;
+
+              default:
+                {
+                  float f = (float)buf[i] * (1.0f / 2147483648.0f);
+
+                  memcpy(p, &f, sizeof(f));
+                }
+                break;
+            }
+        }
+
+      in_idx  += n * in_stride;
+      out_idx += n * out_stride;
+      samples -= n;
+    }
+}
+
+__WIEN2_END_NAMESPACE
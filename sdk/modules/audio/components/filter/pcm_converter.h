@@ -0,0 +1,146 @@
+/****************************************************************************
+ * modules/audio/components/filter/pcm_converter.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef PCM_CONVERTER_H
+#define PCM_CONVERTER_H
+
+#include <stdint.h>
+
+#include "wien2_common_defs.h"
+
+__WIEN2_BEGIN_NAMESPACE
+
+/*--------------------------------------------------------------------*/
+/* Sample formats, all little endian */
+
+enum PcmFormat
+{
+  PcmFormatS16 = 0, /* 16bit signed */
+  PcmFormatS24,     /* 24bit signed, packed into 3 bytes */
+  PcmFormatS32,     /* 32bit signed, 24bit data is MSB aligned */
+  PcmFormatF32,     /* float, full scale is [-1.0, 1.0) */
+};
+
+enum PcmLayout
+{
+  PcmInterleaved = 0,
+  PcmPlanar,        /* One block of samples per channel */
+};
+
+/*--------------------------------------------------------------------*/
+/* Data structure definitions                                         */
+/*--------------------------------------------------------------------*/
+
+struct PcmConvertParam
+{
+  PcmFormat in_format;
+  PcmFormat out_format;
+  PcmLayout in_layout;
+  PcmLayout out_layout;
+  uint8_t   ch_num;
+  float     gain;     /* Linear gain, 1.0f for none */
+  bool      dither;   /* TPDF dither and rounding for 16/24bit output */
+};
+
+/*--------------------------------------------------------------------*/
+/* Class definitions                                                  */
+/*--------------------------------------------------------------------*/
+
+/* Sample format, layout and gain conversion.
+ *
+ * Word kernels handle the plain integer format changes and 16bit gain,
+ * using the DSP extension instructions when available. Everything else
+ * goes through 32bit intermediate samples in small chunks. Any number of
+ * samples is converted. Conversion in place (in == out) is possible when
+ * the layout does not change and the output samples are not larger than
+ * the input samples.
+ */
+
+class PcmConverter
+{
+private:
+
+  static const uint32_t ChunkSamples = 64;
+
+  PcmConvertParam m_param;
+  int32_t  m_gain;    /* Q16.16 */
+  uint32_t m_seed;    /* Dither noise */
+  uint8_t  m_in_bytes;
+  uint8_t  m_out_bytes;
+
+  bool exec_fast(const void *in, void *out, uint32_t samples);
+  void exec_chunk(const uint8_t *in, uint32_t in_idx, uint32_t in_stride,
+                  uint8_t *out, uint32_t out_idx, uint32_t out_stride,
+                  uint32_t samples);
+
+public:
+
+  PcmConverter() :
+      m_gain(0x10000)
+    , m_seed(0x12345678)
+    , m_in_bytes(4)
+    , m_out_bytes(3)
+    {
+      m_param.in_format  = PcmFormatS32;
+      m_param.out_format = PcmFormatS24;
+      m_param.in_layout  = PcmInterleaved;
+      m_param.out_layout = PcmInterleaved;
+      m_param.ch_num     = 1;
+      m_param.gain       = 1.0f;
+      m_param.dither     = false;
+    }
+  ~PcmConverter() {}
+
+  static uint32_t sample_bytes(PcmFormat format);
+
+  bool init(const PcmConvertParam& param);
+
+  /* Output size in bytes for the given input size */
+
+  uint32_t out_size(uint32_t in_size) const
+  {
+    return in_size / m_in_bytes * m_out_bytes;
+  }
+
+  /* Convert samples (of all channels). Returns false for an in place
+   * request that is not possible.
+   */
+
+  bool exec(const void *in, void *out, uint32_t samples);
+};
+
+__WIEN2_END_NAMESPACE
+
+#endif /* PCM_CONVERTER_H */
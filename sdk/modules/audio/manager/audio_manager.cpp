@@ -2581,6 +2581,7 @@ void AudioManager::setRecorder(AudioCommand &cmd)
   switch (cmd.set_recorder_status_param.output_device)
     {
       case AS_SETRECDR_STS_OUTPUTDEVICE_RAM:
+      case AS_SETRECDR_STS_OUTPUTDEVICE_FILE:
         break;
 
       default:
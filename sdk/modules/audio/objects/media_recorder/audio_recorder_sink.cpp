@@ -37,6 +37,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/kmalloc.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "memutils/simple_fifo/CMN_SimpleFifo.h"
 #include "memutils/memory_manager/MemHandle.h"
 #include "audio_recorder_sink.h"
@@ -48,6 +54,14 @@ __WIEN2_BEGIN_NAMESPACE
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Writer thread of file output, below the audio tasks. */
+
+#define REC_FILE_SINK_PRIORITY     100
+#define REC_FILE_SINK_STACK_SIZE   (1024 * 2)
+
+#define REC_FILE_SINK_BUFFER_SIZE  (16 * 1024)
+#define REC_FILE_SINK_SECTOR_SIZE  512
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,15 +82,151 @@ __WIEN2_BEGIN_NAMESPACE
  * Private Functions
  ****************************************************************************/
 
+static uint64_t get_time_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*--------------------------------------------------------------------------*/
 bool AudioRecorderSink::init(const InitAudioRecSinkParam_s &param)
 {
-  m_output_device_hdlr = param.init_audio_ram_sink.output_device_hdlr;
+  m_output_device = param.output_device;
+
+  if (m_output_device != AS_SETRECDR_STS_OUTPUTDEVICE_FILE)
+    {
+      m_output_device_hdlr = param.init_audio_ram_sink.output_device_hdlr;
+      return true;
+    }
+
+  m_file_hdlr = param.init_audio_file_sink.output_device_hdlr;
+  if (m_file_hdlr == NULL)
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_UNEXPECTED_PARAM);
+      return false;
+    }
+
+  m_buf_size = (m_file_hdlr->buffer_size) ?
+                 m_file_hdlr->buffer_size : REC_FILE_SINK_BUFFER_SIZE;
+  m_buf_size = (m_buf_size + REC_FILE_SINK_SECTOR_SIZE - 1) &
+               ~(REC_FILE_SINK_SECTOR_SIZE - 1);
+
+  m_buf[0] = static_cast<uint8_t *>(kmm_malloc(m_buf_size));
+  m_buf[1] = static_cast<uint8_t *>(kmm_malloc(m_buf_size));
+  if ((m_buf[0] == NULL) || (m_buf[1] == NULL))
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_ALLOC_HEAP_MEMORY);
+      deinit();
+      return false;
+    }
+
+  m_stats     = &m_local_stats;
+  m_io_len[0] = 0;
+  m_io_len[1] = 0;
+  m_io_idx    = 0;
+  m_io_exit   = false;
+  m_io_wait   = false;
+  m_armed     = false;
+
+  sem_init(&m_io_req, 0, 0);
+  sem_init(&m_io_done, 0, 0);
+
+  pthread_attr_t attr;
+  struct sched_param sch_param;
+
+  pthread_attr_init(&attr);
+
+  sch_param.sched_priority = REC_FILE_SINK_PRIORITY;
+  attr.stacksize           = REC_FILE_SINK_STACK_SIZE;
+
+  pthread_attr_setschedparam(&attr, &sch_param);
+
+  int ret = pthread_create(&m_io_pid,
+                           &attr,
+                           AudioRecorderSink::ioEntry,
+                           static_cast<pthread_addr_t>(this));
+  if (ret != 0)
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_TASK_CREATE_ERROR);
+      sem_destroy(&m_io_req);
+      sem_destroy(&m_io_done);
+      deinit();
+      return false;
+    }
+
+  pthread_setname_np(m_io_pid, "rec_file_sink");
+
+  m_io_running = true;
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+bool AudioRecorderSink::start(void)
+{
+  if (m_output_device != AS_SETRECDR_STS_OUTPUTDEVICE_FILE)
+    {
+      return true;
+    }
+
+  if (!m_io_running || m_armed)
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_INTERNAL_STATE_ERROR);
+      return false;
+    }
+
+  m_fd    = m_file_hdlr->fd;
+  m_stats = (m_file_hdlr->stats != NULL) ?
+              m_file_hdlr->stats : &m_local_stats;
+
+  memset(m_stats, 0, sizeof(AsRecorderFileStatistics));
+
+  off_t pos = lseek(m_fd, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_UNEXPECTED_PARAM);
+      return false;
+    }
+
+  /* Reserve the file area now, not while recording. */
+
+  m_trim = false;
+
+  if (m_file_hdlr->prealloc_size > 0)
+    {
+      struct stat st;
+      off_t end = pos + m_file_hdlr->prealloc_size;
+
+      if ((fstat(m_fd, &st) == 0) && (st.st_size < end))
+        {
+          m_trim = (ftruncate(m_fd, end) == 0);
+        }
+    }
+
+  /* End the first buffer at a multiple of the buffer size in the file,
+   * so that following writes are aligned even after a header.
+   */
+
+  m_fill_idx   = 0;
+  m_fill_pos   = 0;
+  m_fill_limit = m_buf_size - static_cast<uint32_t>(pos % m_buf_size);
+  m_io_idx     = 0;
+  m_armed      = true;
+
   return true;
 }
 
 /*--------------------------------------------------------------------------*/
 bool AudioRecorderSink::write(const AudioRecSinkData_s &param)
 {
+  if (m_output_device == AS_SETRECDR_STS_OUTPUTDEVICE_FILE)
+    {
+      return writeFile(param);
+    }
+
   if (param.byte_size > 0) {
     if (CMN_SimpleFifoGetVacantSize(static_cast<CMN_SimpleFifoHandle *>
         (m_output_device_hdlr.simple_fifo_handler)) < param.byte_size)
@@ -101,9 +251,243 @@ bool AudioRecorderSink::write(const AudioRecSinkData_s &param)
 /*--------------------------------------------------------------------------*/
 bool AudioRecorderSink::finalize(void)
 {
+  if (m_output_device == AS_SETRECDR_STS_OUTPUTDEVICE_FILE)
+    {
+      return finalizeFile();
+    }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+void AudioRecorderSink::deinit(void)
+{
+  if (m_io_running)
+    {
+      m_io_exit = true;
+      sem_post(&m_io_req);
+      pthread_join(m_io_pid, NULL);
+
+      sem_destroy(&m_io_req);
+      sem_destroy(&m_io_done);
+
+      m_io_running = false;
+    }
+
+  for (int i = 0; i < 2; i++)
+    {
+      if (m_buf[i] != NULL)
+        {
+          kmm_free(m_buf[i]);
+          m_buf[i] = NULL;
+        }
+    }
+
+  m_armed = false;
+}
+
+/*--------------------------------------------------------------------------*/
+bool AudioRecorderSink::writeFile(const AudioRecSinkData_s &param)
+{
+  const uint8_t *src = static_cast<const uint8_t *>(param.mh.getVa());
+  uint32_t size = param.byte_size;
+
+  if (!m_armed)
+    {
+      MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_INTERNAL_STATE_ERROR);
+      return false;
+    }
+
+  /* A failed write to the file stops recording, same as RAM output. */
+
+  if (m_stats->write_errors > 0)
+    {
+      return false;
+    }
+
+  if (size == 0)
+    {
+      return true;
+    }
+
+  /* The frame has to fit in the buffer being filled, and the rest in the
+   * other one. If the I/O thread is behind, drop the whole frame but keep
+   * recording, so a slow card makes a gap instead of stopping.
+   */
+
+  uint32_t room = m_fill_limit - m_fill_pos;
+  bool     fits = (__atomic_load_n(&m_io_len[m_fill_idx],
+                                   __ATOMIC_ACQUIRE) == 0);
+
+  if (fits && (size > room))
+    {
+      fits = (size - room <= m_buf_size)
+          && (__atomic_load_n(&m_io_len[m_fill_idx ^ 1],
+                              __ATOMIC_ACQUIRE) == 0);
+    }
+
+  if (!fits)
+    {
+      m_stats->overrun_frames++;
+      m_stats->overrun_bytes += size;
+      MEDIA_RECORDER_WARN(AS_ATTENTION_SUB_CODE_SIMPLE_FIFO_OVERFLOW);
+      return true;
+    }
+
+  while (size > 0)
+    {
+      uint32_t len = m_fill_limit - m_fill_pos;
+
+      len = (size < len) ? size : len;
+
+      memcpy(m_buf[m_fill_idx] + m_fill_pos, src, len);
+
+      m_fill_pos += len;
+      src        += len;
+      size       -= len;
+
+      if (m_fill_pos == m_fill_limit)
+        {
+          submit();
+        }
+    }
+
   return true;
 }
 
+/*--------------------------------------------------------------------------*/
+bool AudioRecorderSink::finalizeFile(void)
+{
+  bool ret = true;
+
+  if (!m_armed)
+    {
+      return true;
+    }
+
+  /* Write out the rest and wait for both buffers. The I/O thread posts
+   * m_io_done only while m_io_wait is set, so it does not pile up while
+   * recording. Take back the posts which came after the last check.
+   */
+
+  submit();
+
+  __atomic_store_n(&m_io_wait, true, __ATOMIC_SEQ_CST);
+
+  while ((__atomic_load_n(&m_io_len[0], __ATOMIC_SEQ_CST) != 0)
+      || (__atomic_load_n(&m_io_len[1], __ATOMIC_SEQ_CST) != 0))
+    {
+      sem_wait(&m_io_done);
+    }
+
+  __atomic_store_n(&m_io_wait, false, __ATOMIC_SEQ_CST);
+
+  while (sem_trywait(&m_io_done) == 0);
+
+  /* Drop the reserved area which was not used. */
+
+  if (m_trim)
+    {
+      off_t pos = lseek(m_fd, 0, SEEK_CUR);
+
+      if ((pos < 0) || (ftruncate(m_fd, pos) != 0))
+        {
+          MEDIA_RECORDER_WARN(AS_ATTENTION_SUB_CODE_RESOURCE_ERROR);
+          ret = false;
+        }
+    }
+
+  m_armed = false;
+
+  return ret && (m_stats->write_errors == 0);
+}
+
+/*--------------------------------------------------------------------------*/
+void AudioRecorderSink::submit(void)
+{
+  if (m_fill_pos == 0)
+    {
+      return;
+    }
+
+  __atomic_store_n(&m_io_len[m_fill_idx], m_fill_pos, __ATOMIC_RELEASE);
+  sem_post(&m_io_req);
+
+  m_fill_idx  ^= 1;
+  m_fill_pos   = 0;
+  m_fill_limit = m_buf_size;
+}
+
+/*--------------------------------------------------------------------------*/
+void AudioRecorderSink::ioLoop(void)
+{
+  while (true)
+    {
+      if (sem_wait(&m_io_req) != 0)
+        {
+          continue;
+        }
+
+      if (m_io_exit)
+        {
+          break;
+        }
+
+      /* Buffers are queued alternately, so take them in the same order. */
+
+      uint32_t idx = m_io_idx;
+      uint32_t len = __atomic_load_n(&m_io_len[idx], __ATOMIC_ACQUIRE);
+
+      if (len == 0)
+        {
+          continue;
+        }
+
+      uint64_t begin = get_time_us();
+      ssize_t  ret   = ::write(m_fd, m_buf[idx], len);
+      uint32_t time  = static_cast<uint32_t>(get_time_us() - begin);
+
+      m_stats->write_count++;
+      m_stats->last_latency_us   = time;
+      m_stats->total_latency_us += time;
+      if (time > m_stats->max_latency_us)
+        {
+          m_stats->max_latency_us = time;
+        }
+
+      if (ret == static_cast<ssize_t>(len))
+        {
+          m_stats->written_bytes += len;
+
+          if (m_file_hdlr->callback_function != NULL)
+            {
+              m_file_hdlr->callback_function(len);
+            }
+        }
+      else
+        {
+          m_stats->write_errors++;
+          MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_RESOURCE_ERROR);
+        }
+
+      m_io_idx ^= 1;
+
+      __atomic_store_n(&m_io_len[idx], 0, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&m_io_wait, __ATOMIC_SEQ_CST))
+        {
+          sem_post(&m_io_done);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+void *AudioRecorderSink::ioEntry(void *arg)
+{
+  static_cast<AudioRecorderSink *>(arg)->ioLoop();
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -40,6 +40,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <pthread.h>
+#include <semaphore.h>
+
 #include "wien2_common_defs.h"
 #include "wien2_internal_packet.h"
 
@@ -65,12 +68,24 @@ public:
   AsRecorderOutputDeviceHdlr output_device_hdlr;
 };
 
+/* Parameters for initializing sinker of voice recorder
+ * that writes output data to a file.
+ */
+
+struct InitAudioRecFileSinkParam_s
+{
+public:
+  AsRecorderOutputDeviceHdlr *output_device_hdlr;
+};
+
 /* Parameters for initializing sinker of voice recorder. */
 
 struct InitAudioRecSinkParam_s
 {
 public:
-  InitAudioRecRamSinkParam_s init_audio_ram_sink;
+  AsSetRecorderStsOutputDevice output_device;
+  InitAudioRecRamSinkParam_s  init_audio_ram_sink;
+  InitAudioRecFileSinkParam_s init_audio_file_sink;
 };
 
 /* Data to the sinker of voice recorder. */
@@ -85,16 +100,77 @@ public:
 class AudioRecorderSink
 {
 public:
-  AudioRecorderSink() {}
-
-  ~AudioRecorderSink() {}
+  AudioRecorderSink()
+    : m_output_device(AS_SETRECDR_STS_OUTPUTDEVICE_RAM)
+    , m_file_hdlr(NULL)
+    , m_stats(NULL)
+    , m_buf_size(0)
+    , m_fill_idx(0)
+    , m_fill_pos(0)
+    , m_fill_limit(0)
+    , m_io_idx(0)
+    , m_io_exit(false)
+    , m_io_wait(false)
+    , m_io_running(false)
+    , m_fd(-1)
+    , m_armed(false)
+    , m_trim(false)
+  {
+    m_buf[0]    = NULL;
+    m_buf[1]    = NULL;
+    m_io_len[0] = 0;
+    m_io_len[1] = 0;
+  }
+
+  ~AudioRecorderSink()
+  {
+    deinit();
+  }
 
   bool init(const InitAudioRecSinkParam_s &param);
+  bool start(void);
   bool write(const AudioRecSinkData_s &param);
   bool finalize(void);
+  void deinit(void);
 
 private:
+  bool writeFile(const AudioRecSinkData_s &param);
+  bool finalizeFile(void);
+  void submit(void);
+  void ioLoop(void);
+
+  static void *ioEntry(void *arg);
+
+  AsSetRecorderStsOutputDevice m_output_device;
   AsRecorderOutputDeviceHdlr m_output_device_hdlr;
+
+  /* File output. A buffer is filled by write() while the other one is
+   * written by the I/O thread. m_io_len[] is the size queued to the I/O
+   * thread, and the buffer is free again when it returns to 0.
+   */
+
+  AsRecorderOutputDeviceHdlr *m_file_hdlr;
+  AsRecorderFileStatistics   m_local_stats;
+  AsRecorderFileStatistics   *m_stats;
+
+  uint8_t  *m_buf[2];
+  uint32_t m_buf_size;
+  uint32_t m_fill_idx;
+  uint32_t m_fill_pos;
+  uint32_t m_fill_limit;
+  uint32_t m_io_len[2];
+  uint32_t m_io_idx;
+
+  pthread_t m_io_pid;
+  sem_t     m_io_req;
+  sem_t     m_io_done;
+  bool      m_io_exit;
+  bool      m_io_wait;
+  bool      m_io_running;
+
+  int      m_fd;
+  bool     m_armed;
+  bool     m_trim;
 };
 
 /****************************************************************************
@@ -406,6 +406,7 @@ void MediaRecorderObject::activateOnBooted(MsgPacket *msg)
   switch (m_output_device)
     {
       case AS_SETRECDR_STS_OUTPUTDEVICE_RAM:
+      case AS_SETRECDR_STS_OUTPUTDEVICE_FILE:
         m_p_output_device_handler =
           act.param.output_device_handler;
         break;
@@ -419,13 +420,25 @@ void MediaRecorderObject::activateOnBooted(MsgPacket *msg)
   /* Init Sink */
 
   InitAudioRecSinkParam_s init_sink;
+  init_sink.output_device = m_output_device;
   if (m_output_device == AS_SETRECDR_STS_OUTPUTDEVICE_RAM)
     {
       init_sink.init_audio_ram_sink.output_device_hdlr =
         *m_p_output_device_handler;
     }
+  else
+    {
+      init_sink.init_audio_file_sink.output_device_hdlr =
+        m_p_output_device_handler;
+    }
 
-  m_rec_sink.init(init_sink);
+  if (!m_rec_sink.init(init_sink))
+    {
+      reply(AsRecorderEventAct,
+            msg->getType(),
+            AS_ECODE_COMMAND_PARAM_OUTPUT_DEVICE);
+      return;
+    }
 
   /* Transit to Ready */
 
@@ -449,6 +462,8 @@ void MediaRecorderObject::deactivateOnReady(MsgPacket *msg)
       return;
     }
 
+  m_rec_sink.deinit();
+
   m_state = Booted;
 
   reply(AsRecorderEventDeact, msg->getType(), AS_ECODE_OK);
@@ -649,6 +664,16 @@ void MediaRecorderObject::startOnReady(MsgPacket *msg)
 
   msg->moveParam<RecorderCommand>();
 
+  /* Prepare output device */
+
+  if (!m_rec_sink.start())
+    {
+      reply(AsRecorderEventStart,
+            msg->getType(),
+            AS_ECODE_COMMAND_PARAM_OUTPUT_DEVICE);
+      return;
+    }
+
   /* Transit to Active */
 
   m_state = Active;
@@ -720,9 +745,11 @@ void MediaRecorderObject::execOnActive(MsgPacket *msg)
       if (!stop_result)
         {
           /* If stop failed, transition to WaitStop.
-           * Because reply of stop never returns.
+           * Because reply of stop never returns, close the output here.
            */
 
+          m_rec_sink.finalize();
+
           m_state = WaitStop;
         }
       else
@@ -891,6 +918,8 @@ void MediaRecorderObject::filterDoneOnActive(MsgPacket *msg)
 
           if (!stop_result)
             {
+              m_rec_sink.finalize();
+
               if (checkExternalCmd())
                 {
                   AsRecorderEvent ext_evt = getExternalCmd();
@@ -1136,6 +1165,8 @@ void MediaRecorderObject::encDoneOnActive(MsgPacket *msg)
 
           if (!stop_result)
             {
+              m_rec_sink.finalize();
+
               if (checkExternalCmd())
                 {
                   AsRecorderEvent ext_evt = getExternalCmd();
@@ -1479,6 +1510,16 @@ uint32_t MediaRecorderObject::isValidActivateParam(
         m_output_device = AS_SETRECDR_STS_OUTPUTDEVICE_RAM;
         break;
 
+      case AS_SETRECDR_STS_OUTPUTDEVICE_FILE:
+        if (param.output_device_handler == NULL)
+          {
+            MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_UNEXPECTED_PARAM);
+            return AS_ECODE_COMMAND_PARAM_OUTPUT_DEVICE;
+          }
+
+        m_output_device = AS_SETRECDR_STS_OUTPUTDEVICE_FILE;
+        break;
+
       default:
         MEDIA_RECORDER_ERR(AS_ATTENTION_SUB_CODE_UNEXPECTED_PARAM);
         return AS_ECODE_COMMAND_PARAM_OUTPUT_DEVICE;
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * modules/audio/playlist/host/include/audio/audio_high_level_api.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host replacement of the audio API used by the playlist. Only the values
+ * of the track attributes, as in audio/audio_common_defs.h, are needed.
+ */
+
+#ifndef HOST_AUDIO_AUDIO_HIGH_LEVEL_API_H
+#define HOST_AUDIO_AUDIO_HIGH_LEVEL_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AS_CODECTYPE_MP3        0
+#define AS_CODECTYPE_WAV        1
+#define AS_CODECTYPE_AAC        2
+#define AS_CODECTYPE_OPUS       3
+
+#define AS_BITLENGTH_16         16
+#define AS_BITLENGTH_24         24
+
+#define AS_CHANNEL_MONO         1
+#define AS_CHANNEL_STEREO       2
+
+#define AS_SAMPLINGRATE_AUTO    0
+#define AS_SAMPLINGRATE_8000    8000
+#define AS_SAMPLINGRATE_16000   16000
+#define AS_SAMPLINGRATE_24000   24000
+#define AS_SAMPLINGRATE_32000   32000
+#define AS_SAMPLINGRATE_44100   44100
+#define AS_SAMPLINGRATE_48000   48000
+#define AS_SAMPLINGRATE_64000   64000
+#define AS_SAMPLINGRATE_88200   88200
+#define AS_SAMPLINGRATE_96000   96000
+#define AS_SAMPLINGRATE_176400  176400
+#define AS_SAMPLINGRATE_192000  192000
+
+#endif /* HOST_AUDIO_AUDIO_HIGH_LEVEL_API_H */
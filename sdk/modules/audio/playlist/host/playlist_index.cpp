@@ -0,0 +1,628 @@
+/****************************************************************************
+ * modules/audio/playlist/host/playlist_index.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of the binary index of the playlist track database.
+ *
+ * Track databases are generated in a temporary directory, with random
+ * artists and albums (some names are prefixes of others), CR LF and LF
+ * line ends and titles longer than a Track holds. Each database is read
+ * twice:
+ *
+ *   - by the CSV path, with a directory in place of "<csv>.idx" so that
+ *     the index can neither be read nor built
+ *   - by the index, which init() builds
+ *
+ * The all track list and the list of every artist and album, also of
+ * names which are not in the database, must give the tracks of the
+ * database in CSV order, in both ways, with getNextTrack() and back
+ * with getPrevTrack(). A user list made on the CSV path must give the
+ * same tracks from the index.
+ *
+ * The index is then truncated, given a bad magic, or left stale by a
+ * change of the CSV of the same size and a newer time stamp. Each time
+ * init() must rebuild it instead of using it.
+ *
+ *   playlist_index [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "audio/utilities/playlist.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CSV_NAME        "tracks.csv"
+#define USER_LIST       "mix"
+#define USER_TRACKS     20
+#define HDR_SIZE        36    /* Size and offsets of the index header */
+#define HDR_TRACK_NUM   8
+#define HDR_CSV_MTIME   32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct case_s
+{
+  const char *name;
+  int tracks;             /* At most 256, the size of an alias list */
+  int artists;            /* Names taken from the head of g_names */
+  int albums;             /* Names taken from the tail of g_names */
+};
+
+typedef std::vector<Track> tracks_t;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct case_s g_cases[] =
+{
+  { "empty",  0,   1, 1  },
+  { "single", 1,   1, 1  },
+  { "few",    12,  3, 4  },
+  { "many",   250, 9, 10 },
+  { "album",  200, 9, 1  },
+};
+
+/* Names in strcmp() order, with common prefixes */
+
+static const char *g_names[] =
+{
+  "A", "AB", "ABC", "ABD", "B side", "Zed", "alpha", "alpha beta",
+  "the longest name of an artist or an album here", "~"
+};
+
+static const char *g_missing[] =
+{
+  "", "AA", "ABCD", "B", "zzz"
+};
+
+static const int g_rates[] =
+{
+  0, 8000, 16000, 24000, 32000, 44100, 48000, 64000, 88200, 96000, 176400,
+  192000
+};
+
+static const char *g_codecs[] =
+{
+  "mp3", "MP3", "wav", "WAV", "aac", "AAC", "opus", "OPUS"
+};
+
+static const uint8_t g_codec_types[] =
+{
+  AS_CODECTYPE_MP3, AS_CODECTYPE_MP3, AS_CODECTYPE_WAV, AS_CODECTYPE_WAV,
+  AS_CODECTYPE_AAC, AS_CODECTYPE_AAC, AS_CODECTYPE_OPUS, AS_CODECTYPE_OPUS
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+static char g_dir[64];
+static std::string g_csv;
+static std::string g_idx;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static void fail(const struct case_s &c, const char *what, const char *key,
+                 long a, long b)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%s: %s [%s] (%ld, %ld)\n", c.name, what, key, a, b);
+    }
+}
+
+static bool same_track(const Track &a, const Track &b)
+{
+  return strcmp(a.title, b.title) == 0
+      && strcmp(a.author, b.author) == 0
+      && strcmp(a.album, b.album) == 0
+      && a.channel_number == b.channel_number
+      && a.bit_length == b.bit_length
+      && a.sampling_rate == b.sampling_rate
+      && a.codec_type == b.codec_type;
+}
+
+static std::string read_file(const std::string &path)
+{
+  std::string data;
+  FILE *fp = fopen(path.c_str(), "r");
+  char buf[1024];
+  size_t n;
+
+  if (fp != NULL)
+    {
+      while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        {
+          data.append(buf, n);
+        }
+
+      fclose(fp);
+    }
+
+  return data;
+}
+
+static void write_file(const std::string &path, const std::string &data)
+{
+  FILE *fp = fopen(path.c_str(), "w");
+
+  if (fp == NULL || fwrite(data.data(), 1, data.size(), fp) != data.size())
+    {
+      perror(path.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+  fclose(fp);
+}
+
+static uint32_t get_le32(const std::string &data, size_t pos)
+{
+  uint32_t val = 0;
+
+  for (int i = 3; i >= 0; i--)
+    {
+      val = (val << 8) | (uint8_t)data[pos + i];
+    }
+
+  return val;
+}
+
+/* Remove the CSV, the index and the alias lists */
+
+static void clean_dir(void)
+{
+  DIR *dir = opendir(g_dir);
+  struct dirent *ent;
+
+  rmdir(g_idx.c_str());
+
+  while (dir != NULL && (ent = readdir(dir)) != NULL)
+    {
+      if (ent->d_name[0] != '.')
+        {
+          unlink((std::string(g_dir) + "/" + ent->d_name).c_str());
+        }
+    }
+
+  if (dir != NULL)
+    {
+      closedir(dir);
+    }
+}
+
+/* Write a database and return its tracks as parseTrackInfo() gives them */
+
+static tracks_t make_csv(const struct case_s &c)
+{
+  tracks_t truth;
+  std::string csv;
+
+  for (int i = 0; i < c.tracks; i++)
+    {
+      Track t;
+      char line[256];
+      int ch = 1 + rnd() % 2;
+      int bits = (rnd() % 2) ? 24 : 16;
+      int rate = g_rates[rnd() % (sizeof(g_rates) / sizeof(g_rates[0]))];
+      int codec = rnd() % (sizeof(g_codecs) / sizeof(g_codecs[0]));
+      int title_len = 8 + rnd() % 70;
+      std::string title;
+
+      /* Titles are unique by their number */
+
+      title = "track" + std::to_string(i) + "_";
+      while ((int)title.size() < title_len)
+        {
+          title += (char)('a' + rnd() % 26);
+        }
+
+      title += "." + std::string(g_codecs[codec]);
+
+      memset(&t, 0, sizeof(t));
+      strncpy(t.title, title.c_str(), sizeof(t.title) - 1);
+      strcpy(t.author, g_names[rnd() % c.artists]);
+      strcpy(t.album, g_names[sizeof(g_names) / sizeof(g_names[0]) - 1 -
+                              rnd() % c.albums]);
+      t.channel_number = ch;
+      t.bit_length = bits;
+      t.sampling_rate = rate;
+      t.codec_type = g_codec_types[codec];
+      truth.push_back(t);
+
+      snprintf(line, sizeof(line), "%s,%s,%s,%d,%d,%d,%s,0%s",
+               title.c_str(), t.author, t.album, ch, bits, rate,
+               g_codecs[codec], (rnd() % 2) ? "\r\n" : "\n");
+      csv += line;
+    }
+
+  write_file(g_csv, csv);
+
+  return truth;
+}
+
+/* Tracks of a list by getNextTrack(), then getPrevTrack() from the end */
+
+static tracks_t walk(const struct case_s &c, Playlist &pl,
+                     Playlist::ListType type, const char *key)
+{
+  tracks_t next;
+  tracks_t prev;
+  Track t;
+
+  if (type != Playlist::ListTypeUser && !pl.updatePlaylist(type, key))
+    {
+      fail(c, "updatePlaylist", key, type, 0);
+    }
+
+  /* select() keeps the position in the former list */
+
+  if (!pl.select(type, key) || !pl.restart())
+    {
+      fail(c, "select", key, type, 0);
+    }
+
+  while (pl.getNextTrack(&t))
+    {
+      next.push_back(t);
+    }
+
+  while (pl.getPrevTrack(&t))
+    {
+      prev.push_back(t);
+    }
+
+  /* The walk back starts from the track before the last */
+
+  if (prev.size() + (next.empty() ? 0 : 1) != next.size())
+    {
+      fail(c, "getPrevTrack count", key, prev.size(), next.size());
+    }
+
+  for (size_t i = 0; i < prev.size() && i + 1 < next.size(); i++)
+    {
+      if (!same_track(prev[i], next[next.size() - 2 - i]))
+        {
+          fail(c, "getPrevTrack track", key, i, type);
+          break;
+        }
+    }
+
+  return next;
+}
+
+static void check_list(const struct case_s &c, const char *what,
+                       const char *key, const tracks_t &got,
+                       const tracks_t &expect)
+{
+  if (got.size() != expect.size())
+    {
+      fail(c, what, key, got.size(), expect.size());
+      return;
+    }
+
+  for (size_t i = 0; i < got.size(); i++)
+    {
+      if (!same_track(got[i], expect[i]))
+        {
+          fail(c, what, key, i, got.size());
+          return;
+        }
+    }
+}
+
+/* Compare every list with the database, and with the lists of a former
+ * read if given.
+ */
+
+static void check_lists(const struct case_s &c, const char *what,
+                        Playlist &pl, const tracks_t &truth,
+                        const std::vector<tracks_t> *former,
+                        std::vector<tracks_t> *lists)
+{
+  size_t n = 0;
+
+  if (!former)
+    {
+      lists->clear();
+    }
+
+  for (int type = 0; type < 3; type++)
+    {
+      std::vector<const char *> keys;
+
+      if (type == Playlist::ListTypeAllTrack)
+        {
+          keys.push_back("");
+        }
+      else
+        {
+          keys.assign(g_names, g_names + sizeof(g_names) / sizeof(g_names[0]));
+          keys.insert(keys.end(), g_missing,
+                      g_missing + sizeof(g_missing) / sizeof(g_missing[0]));
+        }
+
+      for (const char *key : keys)
+        {
+          tracks_t expect;
+          tracks_t got;
+
+          for (const Track &t : truth)
+            {
+              if (type == Playlist::ListTypeAllTrack
+               || (type == Playlist::ListTypeArtist &&
+                   strcmp(t.author, key) == 0)
+               || (type == Playlist::ListTypeAlbum &&
+                   strcmp(t.album, key) == 0))
+                {
+                  expect.push_back(t);
+                }
+            }
+
+          got = walk(c, pl, (Playlist::ListType)type, key);
+          check_list(c, what, key, got, expect);
+
+          if (former)
+            {
+              check_list(c, "CSV and index differ", key, got, (*former)[n]);
+            }
+          else
+            {
+              lists->push_back(got);
+            }
+
+          n++;
+        }
+    }
+}
+
+/* Read the database by the CSV path, and make the user list */
+
+static void read_csv(const struct case_s &c, const tracks_t &truth,
+                     std::vector<tracks_t> *lists, tracks_t *user)
+{
+  Playlist pl(CSV_NAME);
+
+  unlink(g_idx.c_str());
+  if (mkdir(g_idx.c_str(), 0700) != 0)
+    {
+      perror(g_idx.c_str());
+      exit(EXIT_FAILURE);
+    }
+
+  if (!pl.init(g_dir))
+    {
+      fail(c, "init", "csv", 0, 0);
+    }
+
+  check_lists(c, "CSV list", pl, truth, NULL, lists);
+
+  /* addTrack() appends to the list */
+
+  unlink((std::string(g_dir) + "/alias_list_user_" USER_LIST ".bin").c_str());
+  user->clear();
+  for (int i = 0; !truth.empty() && i < USER_TRACKS; i++)
+    {
+      int no = rnd() % truth.size();
+
+      pl.addTrack(USER_LIST, no);
+      user->push_back(truth[no]);
+    }
+
+  if (!truth.empty())
+    {
+      check_list(c, "CSV user list", USER_LIST,
+                 walk(c, pl, Playlist::ListTypeUser, USER_LIST), *user);
+    }
+
+  rmdir(g_idx.c_str());
+}
+
+/* Read the database by the index, which must be valid after init() */
+
+static void read_index(const struct case_s &c, const char *what,
+                       const tracks_t &truth,
+                       const std::vector<tracks_t> &lists,
+                       const tracks_t &user)
+{
+  Playlist pl(CSV_NAME);
+  struct stat st;
+  std::string idx;
+
+  if (!pl.init(g_dir))
+    {
+      fail(c, "init", what, 0, 0);
+    }
+
+  idx = read_file(g_idx);
+  stat(g_csv.c_str(), &st);
+  if (idx.size() <= HDR_SIZE
+   || get_le32(idx, 0) != 0x31424454
+   || get_le32(idx, HDR_TRACK_NUM) != truth.size()
+   || get_le32(idx, HDR_CSV_MTIME) != (uint32_t)st.st_mtime)
+    {
+      fail(c, "index not rebuilt", what, idx.size(), 0);
+    }
+
+  check_lists(c, what, pl, truth, &lists, NULL);
+
+  if (!truth.empty())
+    {
+      check_list(c, "index user list", what,
+                 walk(c, pl, Playlist::ListTypeUser, USER_LIST), user);
+    }
+}
+
+static void test_case(const struct case_s &c)
+{
+  std::vector<tracks_t> lists;
+  tracks_t truth;
+  tracks_t user;
+  std::string idx;
+  std::string csv;
+  struct stat st;
+  struct utimbuf ut;
+
+  truth = make_csv(c);
+  read_csv(c, truth, &lists, &user);
+
+  /* Built by init(), then loaded as it is */
+
+  read_index(c, "index", truth, lists, user);
+  idx = read_file(g_idx);
+  if (idx.size() <= HDR_SIZE)
+    {
+      clean_dir();
+      return;
+    }
+
+  read_index(c, "loaded index", truth, lists, user);
+  if (read_file(g_idx) != idx)
+    {
+      fail(c, "valid index rewritten", "", 0, 0);
+    }
+
+  /* Truncated, in the header and in the strings */
+
+  write_file(g_idx, idx.substr(0, 20));
+  read_index(c, "header truncated", truth, lists, user);
+  write_file(g_idx, idx.substr(0, idx.size() - 1));
+  read_index(c, "strings truncated", truth, lists, user);
+  if (read_file(g_idx) != idx)
+    {
+      fail(c, "truncated index not rebuilt", "", 0, 0);
+    }
+
+  /* Bad magic */
+
+  write_file(g_idx, "X" + idx.substr(1));
+  read_index(c, "bad magic", truth, lists, user);
+  if (read_file(g_idx) != idx)
+    {
+      fail(c, "bad magic not rebuilt", "", 0, 0);
+    }
+
+  /* Stale, the CSV changes in place with a newer time stamp. The artists
+   * move by one track, so the size stays.
+   */
+
+  if (truth.size() > 1)
+    {
+      tracks_t moved = truth;
+
+      for (size_t i = 0; i < truth.size(); i++)
+        {
+          strcpy(moved[i].author, truth[(i + 1) % truth.size()].author);
+        }
+
+      csv = read_file(g_csv);
+      for (size_t i = 0, pos = 0; i < truth.size(); i++)
+        {
+          size_t start = csv.find(',', pos) + 1;
+
+          csv.replace(start, strlen(truth[i].author), moved[i].author);
+          pos = csv.find('\n', pos) + 1;
+        }
+
+      stat(g_csv.c_str(), &st);
+      write_file(g_csv, csv);
+      ut.actime = st.st_atime;
+      ut.modtime = st.st_mtime + 10;
+      utime(g_csv.c_str(), &ut);
+
+      /* Once more by the CSV for the lists, the user list is remade */
+
+      read_csv(c, moved, &lists, &user);
+      write_file(g_idx, idx);
+      read_index(c, "stale", moved, lists, user);
+    }
+
+  clean_dir();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  const char *tmpdir = getenv("TMPDIR");
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+  snprintf(g_dir, sizeof(g_dir), "%s/playlist_index.XXXXXX",
+           tmpdir ? tmpdir : "/tmp");
+  if (mkdtemp(g_dir) == NULL)
+    {
+      perror(g_dir);
+      return EXIT_FAILURE;
+    }
+
+  g_csv = std::string(g_dir) + "/" CSV_NAME;
+  g_idx = g_csv + ".idx";
+
+  for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++)
+    {
+      test_case(g_cases[i]);
+    }
+
+  rmdir(g_dir);
+
+  printf("%zu databases, %lu errors\n", sizeof(g_cases) / sizeof(g_cases[0]),
+         g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -44,6 +44,257 @@
 
 #include <audio/utilities/playlist.h>
 
+/* Binary index of the track database.
+ *
+ * It is built from the CSV track database and saved next to it as
+ * "<track db>.idx". All references are offsets from the top of the image,
+ * so the file is loaded with a single read and used in place.
+ *
+ *   TrackDbHeader
+ *   TrackDbRecord[track_num]  : In CSV order, i.e. sorted by csv_offset.
+ *   uint16_t[track_num]       : Record numbers sorted by artist name.
+ *   uint16_t[track_num]       : Record numbers sorted by album name.
+ *   char[str_size]            : NUL terminated strings. Artist and album
+ *                               names are stored once.
+ *
+ * The index is rebuilt when the size or time stamp of the CSV changes.
+ */
+
+#define TRACKDB_INDEX_MAGIC   0x31424454  /* "TDB1" */
+#define TRACKDB_INDEX_VERSION 1
+#define TRACKDB_INDEX_MAX     0xffff
+
+struct TrackDbHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint32_t track_num;
+  uint32_t artist_offset;
+  uint32_t album_offset;
+  uint32_t str_offset;
+  uint32_t str_size;
+  uint32_t csv_size;
+  uint32_t csv_mtime;
+};
+
+struct TrackDbRecord
+{
+  uint32_t csv_offset;
+  uint32_t title;
+  uint32_t author;
+  uint32_t album;
+  uint32_t sampling_rate;
+  uint8_t  channel_number;
+  uint8_t  bit_length;
+  uint8_t  codec_type;
+  uint8_t  reserved;
+};
+
+/* Work area to build an index */
+
+struct TrackDbBuilder
+{
+  FAR TrackDbRecord *rec;
+  uint32_t          rec_num;
+  uint32_t          rec_cap;
+  FAR char          *str;
+  uint32_t          str_size;
+  uint32_t          str_cap;
+  FAR uint32_t      *name;
+  uint32_t          name_num;
+  uint32_t          name_cap;
+};
+
+/* Sort context of qsort(), which has no user argument */
+
+static FAR const TrackDbRecord *s_sort_rec;
+static FAR const char          *s_sort_str;
+
+/*--------------------------------------------------------------------------*/
+static inline uint32_t trackdb_align(uint32_t size)
+{
+  return (size + 3) & ~3;
+}
+
+/*--------------------------------------------------------------------------*/
+template <typename T>
+static bool trackdb_reserve(FAR T **buf, FAR uint32_t *cap, uint32_t num)
+{
+  uint32_t new_cap = (*cap) ? *cap : 64;
+
+  if (num <= *cap)
+    {
+      return true;
+    }
+
+  while (new_cap < num)
+    {
+      new_cap *= 2;
+    }
+
+  FAR T *new_buf = static_cast<FAR T *>(realloc(*buf, new_cap * sizeof(T)));
+  if (new_buf == NULL)
+    {
+      return false;
+    }
+
+  *buf = new_buf;
+  *cap = new_cap;
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+static bool trackdb_put_str(FAR TrackDbBuilder *builder,
+                            FAR const char     *str,
+                            bool               intern,
+                            FAR uint32_t       *offset)
+{
+  uint32_t len = strlen(str) + 1;
+
+  if (intern)
+    {
+      /* Artists and albums are few, a linear search is enough. */
+
+      for (uint32_t i = 0; i < builder->name_num; i++)
+        {
+          if (strcmp(builder->str + builder->name[i], str) == 0)
+            {
+              *offset = builder->name[i];
+              return true;
+            }
+        }
+
+      if (!trackdb_reserve(&builder->name,
+                           &builder->name_cap,
+                           builder->name_num + 1))
+        {
+          return false;
+        }
+    }
+
+  if (!trackdb_reserve(&builder->str,
+                       &builder->str_cap,
+                       builder->str_size + len))
+    {
+      return false;
+    }
+
+  memcpy(builder->str + builder->str_size, str, len);
+  *offset = builder->str_size;
+  builder->str_size += len;
+
+  if (intern)
+    {
+      builder->name[builder->name_num++] = *offset;
+    }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+static bool trackdb_add(FAR TrackDbBuilder *builder,
+                        uint32_t           csv_offset,
+                        FAR const Track    *track)
+{
+  if (builder->rec_num >= TRACKDB_INDEX_MAX
+   || !trackdb_reserve(&builder->rec, &builder->rec_cap, builder->rec_num + 1))
+    {
+      return false;
+    }
+
+  FAR TrackDbRecord *rec = &builder->rec[builder->rec_num];
+
+  memset(rec, 0, sizeof(TrackDbRecord));
+  rec->csv_offset     = csv_offset;
+  rec->sampling_rate  = track->sampling_rate;
+  rec->channel_number = track->channel_number;
+  rec->bit_length     = track->bit_length;
+  rec->codec_type     = track->codec_type;
+
+  if (!trackdb_put_str(builder, track->title, false, &rec->title)
+   || !trackdb_put_str(builder, track->author, true, &rec->author)
+   || !trackdb_put_str(builder, track->album, true, &rec->album))
+    {
+      return false;
+    }
+
+  builder->rec_num++;
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+static int trackdb_cmp_artist(FAR const void *a, FAR const void *b)
+{
+  uint16_t ia = *static_cast<FAR const uint16_t *>(a);
+  uint16_t ib = *static_cast<FAR const uint16_t *>(b);
+
+  /* Same names share an offset, the record order is kept among them. */
+
+  if (s_sort_rec[ia].author != s_sort_rec[ib].author)
+    {
+      return strcmp(s_sort_str + s_sort_rec[ia].author,
+                    s_sort_str + s_sort_rec[ib].author);
+    }
+
+  return ia - ib;
+}
+
+/*--------------------------------------------------------------------------*/
+static int trackdb_cmp_album(FAR const void *a, FAR const void *b)
+{
+  uint16_t ia = *static_cast<FAR const uint16_t *>(a);
+  uint16_t ib = *static_cast<FAR const uint16_t *>(b);
+
+  if (s_sort_rec[ia].album != s_sort_rec[ib].album)
+    {
+      return strcmp(s_sort_str + s_sort_rec[ia].album,
+                    s_sort_str + s_sort_rec[ib].album);
+    }
+
+  return ia - ib;
+}
+
+/*--------------------------------------------------------------------------*/
+static uint32_t trackdb_bound(FAR const uint8_t *index,
+                              FAR const uint16_t *sorted,
+                              uint32_t TrackDbRecord::*field,
+                              FAR const char     *key_str,
+                              bool               upper)
+{
+  FAR const TrackDbHeader *hdr =
+    reinterpret_cast<FAR const TrackDbHeader *>(index);
+  FAR const TrackDbRecord *rec =
+    reinterpret_cast<FAR const TrackDbRecord *>(hdr + 1);
+  FAR const char *str =
+    reinterpret_cast<FAR const char *>(index + hdr->str_offset);
+  uint32_t lo = 0;
+  uint32_t hi = hdr->track_num;
+
+  /* First position whose name is not less (lower) or greater (upper)
+   * than the key.
+   */
+
+  while (lo < hi)
+    {
+      uint32_t mid = (lo + hi) / 2;
+      int      cmp = strcmp(str + rec[sorted[mid]].*field, key_str);
+
+      if ((cmp < 0) || (upper && (cmp == 0)))
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return lo;
+}
+
 /*--------------------------------------------------------------------------*/
 bool Playlist::init(const char *playlist_path)
 {
@@ -62,6 +313,10 @@ bool Playlist::init(const char *playlist_path)
 
   this->open("r");
 
+  /* Load binary index of track database, build it if necessary. */
+
+  this->loadTrackDbIndex();
+
   /* Create alias list. */
 
   this->updatePlaylist(ListTypeAllTrack, "");
@@ -112,9 +367,15 @@ bool Playlist::open(FAR const char *mode)
 /*--------------------------------------------------------------------------*/
 bool Playlist::close(void)
 {
+  this->freeTrackDbIndex();
+
   if (this->m_track_db_fp != NULL)
   {
-    if (fclose(this->m_track_db_fp) != 0)
+    FAR FILE *fp = this->m_track_db_fp;
+
+    this->m_track_db_fp = NULL;
+
+    if (fclose(fp) != 0)
       {
         return false;
       }
@@ -221,37 +482,19 @@ bool Playlist::getNextTrack(FAR Track *track)
         }
     }
 
-  /* Clear EOF indicator. (Calling fseek() dows not clear them.) */
-
-  clearerr(this->m_track_db_fp);
-
   /* Increment index. */
 
   this->m_play_idx++;
 
-  /* Move a file pointer of track database to the head of next track. */
-
-  int seek_rst = fseek(this->m_track_db_fp,
-                       this->m_alias_list.at(this->m_play_idx),
-                       SEEK_SET);
-  if (seek_rst != 0)
-    {
-      this->m_play_idx--;
-      return false;
-    }
-
-
   /* Get track info. */
 
-  char line[LineMaxLength] = { '\0' };
-  bool ret = this->readLine(line, sizeof(line));
-  if (ret != true)
+  if (!this->readTrack(this->m_alias_list.at(this->m_play_idx), track))
     {
       this->m_play_idx--;
       return false;
     }
 
-  return this->parseTrackInfo(track, line, sizeof(line));
+  return true;
 }
 
 /*--------------------------------------------------------------------------*/
@@ -289,39 +532,19 @@ bool Playlist::getPrevTrack(Track *track)
         }
     }
 
-  /* Clear EOF indicator. (Calling fseek() dows not clear them.) */
-
-  clearerr(this->m_track_db_fp);
-
   /* Decrement index. */
 
   this->m_play_idx--;
 
-  /* Move a file pointer of track database to the head of next track. */
-
-  int seek_rst = fseek(this->m_track_db_fp,
-                       this->m_alias_list.at(this->m_play_idx),
-                       SEEK_SET);
-  if (seek_rst != 0)
-    {
-      this->m_play_idx++;
-      return false;
-    }
-
   /* Get track info. */
 
-  char line[LineMaxLength] =
-    {
-      '\0'
-    };
-  bool ret = this->readLine(line, sizeof(line));
-  if (ret != true)
+  if (!this->readTrack(this->m_alias_list.at(this->m_play_idx), track))
     {
       this->m_play_idx++;
       return false;
     }
 
-  return this->parseTrackInfo(track, line, sizeof(line));
+  return true;
 }
 
 /*--------------------------------------------------------------------------*/
@@ -366,6 +589,55 @@ bool Playlist::updatePlaylist(ListType type, FAR const char *key_str)
       return false;
     }
 
+  if (this->m_track_db_index != NULL)
+    {
+      /* Take the range of the key from the sorted list of the index. */
+
+      FAR const TrackDbHeader *hdr =
+        reinterpret_cast<FAR const TrackDbHeader *>(this->m_track_db_index);
+      FAR const TrackDbRecord *rec =
+        reinterpret_cast<FAR const TrackDbRecord *>(hdr + 1);
+      FAR const uint16_t *sorted = NULL;
+      uint32_t TrackDbRecord::*field = NULL;
+      uint32_t top = 0;
+      uint32_t end = hdr->track_num;
+
+      if (type == ListTypeArtist)
+        {
+          sorted = reinterpret_cast<FAR const uint16_t *>
+                     (this->m_track_db_index + hdr->artist_offset);
+          field  = &TrackDbRecord::author;
+        }
+      else if (type == ListTypeAlbum)
+        {
+          sorted = reinterpret_cast<FAR const uint16_t *>
+                     (this->m_track_db_index + hdr->album_offset);
+          field  = &TrackDbRecord::album;
+        }
+
+      if (sorted != NULL)
+        {
+          top = trackdb_bound(this->m_track_db_index, sorted, field,
+                              key_str, false);
+          end = trackdb_bound(this->m_track_db_index, sorted, field,
+                              key_str, true);
+        }
+
+      for (uint32_t i = top; i < end; i++)
+        {
+          uint32_t offset = rec[(sorted != NULL) ? sorted[i] : i].csv_offset;
+          size_t wsize = fwrite(&offset, sizeof(offset), 1, list_fp);
+          if (wsize != 1)
+            {
+              printf("File write error. [%d]\n", wsize);
+            }
+        }
+
+      fclose(list_fp);
+
+      return true;
+    }
+
   /* Move file pointer to top of file. */
 
   if (fseek(this->m_track_db_fp, 0, SEEK_SET) != 0)
@@ -960,11 +1232,16 @@ bool Playlist::parseTrackInfo(FAR Track *track,
 
   /* Get track name. */
 
-  strncpy(track->title, strtok(token_buffer, ","), sizeof(track->title) - 1);
+  FAR char *tp = strtok(token_buffer, ",");
+  if (tp == NULL)
+    {
+      return false;
+    }
+  strncpy(track->title, tp, sizeof(track->title) - 1);
 
   /* Get author. */
 
-  FAR char *tp = strtok(NULL, ",");
+  tp = strtok(NULL, ",");
   if (tp == NULL)
     {
       return false;
@@ -1192,3 +1469,351 @@ bool Playlist::getFileName(ListType       type,
 
   return true;
 }
+
+/*--------------------------------------------------------------------------*/
+bool Playlist::readTrack(uint32_t offset, FAR Track *track)
+{
+  if (this->m_track_db_index != NULL)
+    {
+      /* Records are in CSV order, look up the offset by binary search. */
+
+      FAR const TrackDbHeader *hdr =
+        reinterpret_cast<FAR const TrackDbHeader *>(this->m_track_db_index);
+      FAR const TrackDbRecord *rec =
+        reinterpret_cast<FAR const TrackDbRecord *>(hdr + 1);
+      FAR const char *str = reinterpret_cast<FAR const char *>
+                              (this->m_track_db_index + hdr->str_offset);
+      uint32_t lo = 0;
+      uint32_t hi = hdr->track_num;
+
+      while (lo < hi)
+        {
+          uint32_t mid = (lo + hi) / 2;
+
+          if (rec[mid].csv_offset < offset)
+            {
+              lo = mid + 1;
+            }
+          else
+            {
+              hi = mid;
+            }
+        }
+
+      if ((lo == hdr->track_num) || (rec[lo].csv_offset != offset))
+        {
+          _err("Track at %ld is not in index.\n", offset);
+          return false;
+        }
+
+      rec = &rec[lo];
+
+      memset(track, 0, sizeof(Track));
+      strncpy(track->title, str + rec->title, sizeof(track->title) - 1);
+      strncpy(track->author, str + rec->author, sizeof(track->author) - 1);
+      strncpy(track->album, str + rec->album, sizeof(track->album) - 1);
+      track->channel_number = rec->channel_number;
+      track->bit_length     = rec->bit_length;
+      track->sampling_rate  = rec->sampling_rate;
+      track->codec_type     = rec->codec_type;
+
+      return true;
+    }
+
+  /* Clear EOF indicator. (Calling fseek() dows not clear them.) */
+
+  clearerr(this->m_track_db_fp);
+
+  /* Move a file pointer of track database to the head of the track. */
+
+  if (fseek(this->m_track_db_fp, offset, SEEK_SET) != 0)
+    {
+      return false;
+    }
+
+  char line[LineMaxLength] =
+    {
+      '\0'
+    };
+  if (!this->readLine(line, sizeof(line)))
+    {
+      return false;
+    }
+
+  return this->parseTrackInfo(track, line, sizeof(line));
+}
+
+/*--------------------------------------------------------------------------*/
+bool Playlist::loadTrackDbIndex(void)
+{
+  char        csv_path[FileNameMaxLength];
+  char        index_path[FileNameMaxLength + 4];
+  struct stat csv_stat;
+  struct stat index_stat;
+  bool        built = false;
+
+  this->freeTrackDbIndex();
+
+  if (this->m_track_db_fp == NULL)
+    {
+      return false;
+    }
+
+  snprintf(csv_path, sizeof(csv_path), "%s/%s",
+           m_playlist_path, this->m_track_db_file_name);
+  snprintf(index_path, sizeof(index_path), "%s.idx", csv_path);
+
+  if (stat(csv_path, &csv_stat) != 0)
+    {
+      return false;
+    }
+
+  uint32_t csv_size  = static_cast<uint32_t>(csv_stat.st_size);
+  uint32_t csv_mtime = static_cast<uint32_t>(csv_stat.st_mtime);
+
+  while (true)
+    {
+      if (stat(index_path, &index_stat) == 0
+       && index_stat.st_size > (off_t)sizeof(TrackDbHeader))
+        {
+          /* Whole index in one read */
+
+          uint32_t size = static_cast<uint32_t>(index_stat.st_size);
+          FAR uint8_t *index = static_cast<FAR uint8_t *>(malloc(size));
+          FAR FILE *fp = fopen(index_path, "r");
+          bool valid = false;
+
+          if (index != NULL && fp != NULL)
+            {
+              valid = (fread(index, 1, size, fp) == size);
+            }
+
+          if (fp != NULL)
+            {
+              fclose(fp);
+            }
+
+          /* Check consistency, so that any offset is safe to use later. */
+
+          FAR TrackDbHeader *hdr =
+            reinterpret_cast<FAR TrackDbHeader *>(index);
+          uint32_t n = valid ? hdr->track_num : 0;
+          uint32_t list_size = trackdb_align(n * sizeof(uint16_t));
+
+          valid = valid
+               && hdr->magic == TRACKDB_INDEX_MAGIC
+               && hdr->version == TRACKDB_INDEX_VERSION
+               && hdr->record_size == sizeof(TrackDbRecord)
+               && n <= TRACKDB_INDEX_MAX
+               && hdr->artist_offset ==
+                    sizeof(TrackDbHeader) + n * sizeof(TrackDbRecord)
+               && hdr->album_offset == hdr->artist_offset + list_size
+               && hdr->str_offset == hdr->album_offset + list_size
+               && hdr->str_size > 0
+               && hdr->str_offset + hdr->str_size == size
+               && index[size - 1] == '\0'
+               && hdr->csv_size == csv_size
+               && hdr->csv_mtime == csv_mtime;
+
+          if (valid)
+            {
+              FAR const TrackDbRecord *rec =
+                reinterpret_cast<FAR const TrackDbRecord *>(hdr + 1);
+              FAR const uint16_t *artist =
+                reinterpret_cast<FAR const uint16_t *>
+                  (index + hdr->artist_offset);
+              FAR const uint16_t *album =
+                reinterpret_cast<FAR const uint16_t *>
+                  (index + hdr->album_offset);
+
+              for (uint32_t i = 0; valid && i < n; i++)
+                {
+                  valid = rec[i].title < hdr->str_size
+                       && rec[i].author < hdr->str_size
+                       && rec[i].album < hdr->str_size
+                       && artist[i] < n
+                       && album[i] < n
+                       && (i == 0
+                           || rec[i - 1].csv_offset < rec[i].csv_offset);
+                }
+            }
+
+          if (valid)
+            {
+              this->m_track_db_index = index;
+              _info("Track db index loaded. %ld tracks\n", n);
+              return true;
+            }
+
+          free(index);
+        }
+
+      /* Missing, stale or broken. Build it once and retry. */
+
+      if (built)
+        {
+          break;
+        }
+
+      if (!this->buildTrackDbIndex(index_path, csv_size, csv_mtime))
+        {
+          break;
+        }
+
+      built = true;
+    }
+
+  _warn("Track db index is not available, use %s directly.\n", csv_path);
+
+  return false;
+}
+
+/*--------------------------------------------------------------------------*/
+bool Playlist::buildTrackDbIndex(FAR const char *index_path,
+                                 uint32_t       csv_size,
+                                 uint32_t       csv_mtime)
+{
+  TrackDbBuilder builder;
+  TrackDbHeader  hdr;
+  FAR uint16_t   *artist = NULL;
+  FAR uint16_t   *album = NULL;
+  FAR FILE       *fp = NULL;
+  char           line[LineMaxLength];
+  bool           ret = true;
+
+  memset(&builder, 0, sizeof(builder));
+
+  if (fseek(this->m_track_db_fp, 0, SEEK_SET) != 0)
+    {
+      return false;
+    }
+
+  /* Parse the CSV in a single sequential pass. */
+
+  while (ret)
+    {
+      long offset = ftell(this->m_track_db_fp);
+
+      if (fgets(line, sizeof(line), this->m_track_db_fp) == NULL)
+        {
+          break;
+        }
+
+      size_t len = strcspn(line, "\r\n");
+
+      if ((line[len] == '\0') && !feof(this->m_track_db_fp))
+        {
+          /* Too long, the rest of the line is dropped as readLine() does. */
+
+          int c;
+          do
+            {
+              c = fgetc(this->m_track_db_fp);
+            }
+          while (c != EOF && c != '\n');
+        }
+
+      line[len] = '\0';
+
+      if (len == 0)
+        {
+          continue;
+        }
+
+      Track track;
+      if (!this->parseTrackInfo(&track, line, sizeof(line)))
+        {
+          _warn("Invalid track at %ld is skipped.\n", offset);
+          continue;
+        }
+
+      ret = trackdb_add(&builder, static_cast<uint32_t>(offset), &track);
+    }
+
+  fseek(this->m_track_db_fp, 0, SEEK_SET);
+
+  /* An empty string table is not allowed. */
+
+  if (ret && builder.str_size == 0)
+    {
+      uint32_t dummy;
+      ret = trackdb_put_str(&builder, "", false, &dummy);
+    }
+
+  /* Sort lists of artist and album. */
+
+  uint32_t n = builder.rec_num;
+  uint32_t list_size = trackdb_align(n * sizeof(uint16_t));
+
+  if (ret)
+    {
+      /* One more word, since calloc(0) may return NULL. */
+
+      artist = static_cast<FAR uint16_t *>(calloc(1, list_size + 4));
+      album  = static_cast<FAR uint16_t *>(calloc(1, list_size + 4));
+      ret = (artist != NULL) && (album != NULL);
+    }
+
+  if (ret)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          artist[i] = i;
+          album[i]  = i;
+        }
+
+      s_sort_rec = builder.rec;
+      s_sort_str = builder.str;
+      qsort(artist, n, sizeof(uint16_t), trackdb_cmp_artist);
+      qsort(album, n, sizeof(uint16_t), trackdb_cmp_album);
+
+      memset(&hdr, 0, sizeof(hdr));
+      hdr.magic         = TRACKDB_INDEX_MAGIC;
+      hdr.version       = TRACKDB_INDEX_VERSION;
+      hdr.record_size   = sizeof(TrackDbRecord);
+      hdr.track_num     = n;
+      hdr.artist_offset = sizeof(TrackDbHeader) + n * sizeof(TrackDbRecord);
+      hdr.album_offset  = hdr.artist_offset + list_size;
+      hdr.str_offset    = hdr.album_offset + list_size;
+      hdr.str_size      = builder.str_size;
+      hdr.csv_size      = csv_size;
+      hdr.csv_mtime     = csv_mtime;
+
+      fp = fopen(index_path, "w");
+      ret = (fp != NULL)
+         && (fwrite(&hdr, sizeof(hdr), 1, fp) == 1)
+         && (n == 0 || fwrite(builder.rec, sizeof(TrackDbRecord), n, fp) == n)
+         && (fwrite(artist, 1, list_size, fp) == list_size)
+         && (fwrite(album, 1, list_size, fp) == list_size)
+         && (fwrite(builder.str, 1, builder.str_size, fp) == builder.str_size);
+
+      if (fp != NULL && fclose(fp) != 0)
+        {
+          ret = false;
+        }
+
+      if (!ret)
+        {
+          printf("Cannot write %s\n", index_path);
+          unlink(index_path);
+        }
+    }
+
+  free(album);
+  free(artist);
+  free(builder.name);
+  free(builder.str);
+  free(builder.rec);
+
+  return ret;
+}
+
+/*--------------------------------------------------------------------------*/
+void Playlist::freeTrackDbIndex(void)
+{
+  if (this->m_track_db_index != NULL)
+    {
+      free(this->m_track_db_index);
+      this->m_track_db_index = NULL;
+    }
+}
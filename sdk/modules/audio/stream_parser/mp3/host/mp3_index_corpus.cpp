@@ -0,0 +1,705 @@
+/****************************************************************************
+ * modules/audio/stream_parser/mp3/host/mp3_index_corpus.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of Mp3FrameIndex over a generated corpus.
+ *
+ * The corpus is written to a temporary directory. Each file is made of
+ * Layer III frames with random payloads, and the offset of every frame is
+ * kept as the truth:
+ *
+ *   cbr_tags   : MPEG1 CBR with padding, ID3v2 and ID3v1 tags
+ *   cbr_info   : MPEG1 mono CBR with an Info header
+ *   vbr_xing   : MPEG1 VBR with a Xing header and TOC
+ *   vbr_vbri   : MPEG1 VBR with a VBRI header and TOC
+ *   mpeg2_xing : MPEG2 VBR with a Xing header without TOC
+ *   mpeg2_junk : MPEG2 VBR without header, with garbage between frames
+ *   long_cbr   : 20000 frames, so the index interval is doubled
+ *   tiny       : 3 frames
+ *
+ * For each file:
+ *
+ *   - before indexing, seek() and getTime() must land on frames, with an
+ *     error bounded by the TOC, and getDuration() must be exact when the
+ *     header has the frame count
+ *   - feed() with random chunk sizes (down to 1 byte, so headers are
+ *     split) and replayed old data, with exact results for the indexed
+ *     part on the way
+ *   - every result exact once the index is complete, also after reload
+ *     of the saved index
+ *   - the saved index is ignored when the file changed or the index file
+ *     is damaged
+ *   - build() after a gap in the fed data
+ *
+ *   mp3_index_corpus [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "audio/utilities/mp3_frame_index.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SEEK_CASES   300
+#define APPROX_CASES 100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct corpus_s
+{
+  const char *name;
+  int frames;
+  bool mpeg1;
+  int fs_index;
+  bool mono;
+  bool vbr;
+  const char *tag;        /* "Xing", "Info", "VBRI" or NULL */
+  bool toc;               /* Xing TOC */
+  int id3v2;              /* ID3v2 tag size */
+  bool id3v1;
+  int junk;               /* Maximum garbage bytes between frames */
+
+  /* Maximum error of the time of a seek before indexing, in per mille
+   * of the duration. 0 if not checked.
+   */
+
+  int approx_permil;
+};
+
+struct truth_s
+{
+  std::string path;
+  uint32_t fs;
+  uint32_t spf;
+  uint32_t audio_start;     /* Header frame or first frame */
+  std::vector<uint32_t> frames;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const int g_v1_bitrate[15] =
+{
+  0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320
+};
+
+static const int g_v2_bitrate[15] =
+{
+  0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160
+};
+
+static const int g_v1_fs[3] =
+{
+  44100, 48000, 32000
+};
+
+static const int g_v2_fs[3] =
+{
+  22050, 24000, 16000
+};
+
+static const struct corpus_s g_corpus[] =
+{
+  { "cbr_tags",   3000,  true,  0, false, false, NULL,   false, 1000,
+    true,  0,  10 },
+  { "cbr_info",   2000,  true,  2, true,  false, "Info", true,  0,
+    false, 0,  10 },
+  { "vbr_xing",   5000,  true,  0, false, true,  "Xing", true,  0,
+    false, 0,  20 },
+  { "vbr_vbri",   400,   true,  1, false, true,  "VBRI", false, 300,
+    false, 0,  20 },
+  { "mpeg2_xing", 1500,  false, 2, false, true,  "Xing", false, 0,
+    false, 0,  0 },
+  { "mpeg2_junk", 3000,  false, 0, false, true,  NULL,   false, 0,
+    false, 40, 0 },
+  { "long_cbr",   20000, true,  1, false, false, NULL,   false, 0,
+    false, 0,  10 },
+  { "tiny",       3,     true,  0, false, true,  NULL,   false, 0,
+    false, 0,  0 },
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+static char g_dir[64];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static void fail(const struct truth_s &t, const char *what, long a, long b)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%s: %s (%ld, %ld)\n", t.path.c_str(), what, a, b);
+    }
+}
+
+static uint32_t to_ms(const struct truth_s &t, uint32_t frame)
+{
+  return (uint64_t)frame * t.spf * 1000 / t.fs;
+}
+
+static void put_be(std::vector<uint8_t> &v, size_t pos, uint32_t val,
+                   int size)
+{
+  for (int i = 0; i < size; i++)
+    {
+      v[pos + i] = (uint8_t)(val >> (8 * (size - 1 - i)));
+    }
+}
+
+/* Layer III frame without CRC */
+
+static std::vector<uint8_t> make_frame(const struct corpus_s &c, int br,
+                                       int pad, bool empty)
+{
+  int fs = c.mpeg1 ? g_v1_fs[c.fs_index] : g_v2_fs[c.fs_index];
+  int kbps = c.mpeg1 ? g_v1_bitrate[br] : g_v2_bitrate[br];
+  size_t size = (c.mpeg1 ? 144 : 72) * kbps * 1000 / fs + pad;
+  std::vector<uint8_t> frame(size);
+
+  frame[0] = 0xff;
+  frame[1] = 0xf0 | (c.mpeg1 ? 0x08 : 0) | 0x02 | 0x01;
+  frame[2] = (uint8_t)(br << 4 | c.fs_index << 2 | pad << 1);
+  frame[3] = c.mono ? 0xc0 : 0x00;
+  for (size_t i = 4; i < size; i++)
+    {
+      frame[i] = empty ? 0 : (uint8_t)rnd();
+    }
+
+  return frame;
+}
+
+static bool make_file(const struct corpus_s &c, struct truth_s &t)
+{
+  std::vector<uint8_t> audio;
+  std::vector<uint32_t> offsets;
+  std::vector<uint8_t> out;
+  std::vector<uint8_t> info;
+  int br;
+  int pad;
+
+  t.path = std::string(g_dir) + "/" + c.name + ".mp3";
+  t.fs = c.mpeg1 ? g_v1_fs[c.fs_index] : g_v2_fs[c.fs_index];
+  t.spf = c.mpeg1 ? 1152 : 576;
+
+  if (c.id3v2)
+    {
+      static const uint8_t id3[6] =
+      {
+        'I', 'D', '3', 3, 0, 0
+      };
+
+      out.insert(out.end(), id3, id3 + 6);
+      out.push_back((c.id3v2 >> 21) & 0x7f);
+      out.push_back((c.id3v2 >> 14) & 0x7f);
+      out.push_back((c.id3v2 >> 7) & 0x7f);
+      out.push_back(c.id3v2 & 0x7f);
+      out.resize(out.size() + c.id3v2);
+    }
+
+  for (int i = 0; i < c.frames; i++)
+    {
+      /* Not after the first frame, which open() takes as the first frame
+       * only if the next header follows.
+       */
+
+      if (c.junk && i > 1 && rnd() % 100 == 0)
+        {
+          audio.resize(audio.size() + 1 + rnd() % c.junk);
+        }
+
+      br = c.vbr ? 1 + rnd() % 14 : 9;
+      pad = c.vbr ? 0 : rnd() % 2;
+      offsets.push_back(audio.size());
+
+      std::vector<uint8_t> frame = make_frame(c, br, pad, false);
+      audio.insert(audio.end(), frame.begin(), frame.end());
+    }
+
+  if (c.tag && strcmp(c.tag, "VBRI") == 0)
+    {
+      /* Header at 32 bytes after the frame header, then the byte size of
+       * every 2 frames.
+       */
+
+      size_t entries = (c.frames + 1) / 2;
+      size_t pos = 36;
+
+      info = make_frame(c, 14, 0, true);
+      uint32_t total = info.size() + audio.size();
+
+      memcpy(&info[pos], "VBRI", 4);
+      put_be(info, pos + 4, 1, 2);
+      put_be(info, pos + 6, 0, 2);
+      put_be(info, pos + 8, 75, 2);
+      put_be(info, pos + 10, total, 4);
+      put_be(info, pos + 14, c.frames, 4);
+      put_be(info, pos + 18, entries, 2);
+      put_be(info, pos + 20, 1, 2);
+      put_be(info, pos + 22, 2, 2);
+      put_be(info, pos + 24, 2, 2);
+      pos += 26;
+      for (size_t e = 0; e < entries; e++)
+        {
+          uint32_t a = offsets[e * 2];
+          uint32_t b = (e + 1) * 2 < (size_t)c.frames ?
+                       offsets[(e + 1) * 2] : audio.size();
+
+          if (pos + 2 > info.size())
+            {
+              return false;
+            }
+
+          put_be(info, pos, b - a, 2);
+          pos += 2;
+        }
+    }
+  else if (c.tag)
+    {
+      /* Header after the side information, with frame count, byte count
+       * and optionally the TOC.
+       */
+
+      size_t pos = 4 + (c.mpeg1 ? (c.mono ? 17 : 32) : (c.mono ? 9 : 17));
+
+      info = make_frame(c, 9, 0, true);
+      uint32_t total = info.size() + audio.size();
+
+      memcpy(&info[pos], c.tag, 4);
+      put_be(info, pos + 4, c.toc ? 7 : 3, 4);
+      put_be(info, pos + 8, c.frames, 4);
+      put_be(info, pos + 12, total, 4);
+      if (c.toc)
+        {
+          for (int i = 0; i < 100; i++)
+            {
+              uint64_t v = (uint64_t)(info.size() +
+                                      offsets[(uint64_t)c.frames * i / 100])
+                           * 256 / total;
+              info[pos + 16 + i] = v > 255 ? 255 : v;
+            }
+        }
+    }
+
+  uint32_t start = out.size() + info.size();
+
+  t.audio_start = out.size();
+
+  out.insert(out.end(), info.begin(), info.end());
+  out.insert(out.end(), audio.begin(), audio.end());
+  if (c.id3v1)
+    {
+      out.push_back('T');
+      out.push_back('A');
+      out.push_back('G');
+      out.resize(out.size() + 125);
+    }
+
+  t.frames.clear();
+  for (size_t i = 0; i < offsets.size(); i++)
+    {
+      t.frames.push_back(start + offsets[i]);
+    }
+
+  FILE *fp = fopen(t.path.c_str(), "wb");
+
+  if (fp == NULL)
+    {
+      return false;
+    }
+
+  bool ok = fwrite(out.data(), 1, out.size(), fp) == out.size();
+
+  return (fclose(fp) == 0) && ok;
+}
+
+static long frame_of(const struct truth_s &t, uint32_t offset)
+{
+  for (size_t i = 0; i < t.frames.size(); i++)
+    {
+      if (t.frames[i] == offset)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/* Results before indexing */
+
+static void check_approx(Mp3FrameIndex &ix, const struct corpus_s &c,
+                         const struct truth_s &t)
+{
+  uint32_t n = t.frames.size();
+  uint32_t duration = to_ms(t, n);
+  uint32_t bound = (uint64_t)duration * c.approx_permil / 1000 +
+                   to_ms(t, 2);
+  Mp3FrameIndex::Accuracy expect =
+    c.tag ? Mp3FrameIndex::AccuracyToc : Mp3FrameIndex::AccuracyEstimated;
+  Mp3FrameIndex::Accuracy a;
+  uint32_t offset;
+  uint32_t ms;
+  long frame;
+
+  a = ix.getDuration(&ms);
+  if (a != expect || (c.tag && ms != duration))
+    {
+      fail(t, "approximate duration", a, ms);
+    }
+
+  /* After the end, the last frame, as the TOC ends at the end of audio.
+   * Without TOC, the estimation from the first frame can be anywhere.
+   */
+
+  a = ix.seek(duration + 1000, &offset, &ms);
+  if (a != expect || frame_of(t, offset) < 0 ||
+      (c.tag && offset != t.frames[n - 1]))
+    {
+      fail(t, "approximate seek after end", a, offset);
+    }
+
+  for (int i = 0; i < APPROX_CASES; i++)
+    {
+      uint32_t f = rnd() % n;
+
+      a = ix.seek(to_ms(t, f), &offset, &ms);
+      frame = frame_of(t, offset);
+      if (a != expect || frame < 0)
+        {
+          fail(t, "approximate seek", a, offset);
+          continue;
+        }
+
+      /* The time of the frame found, and the frame found for the time */
+
+      if (c.approx_permil &&
+          (labs((long)ms - (long)to_ms(t, frame)) > (long)bound ||
+           labs((long)to_ms(t, frame) - (long)to_ms(t, f)) > (long)bound))
+        {
+          fail(t, "approximate seek error", f, frame);
+        }
+
+      a = ix.getTime(t.frames[f], &ms);
+      if (a != expect ||
+          (c.approx_permil &&
+           labs((long)ms - (long)to_ms(t, f)) > (long)bound))
+        {
+          fail(t, "approximate time", f, ms);
+        }
+    }
+}
+
+/* Exact results for the first frames indexed frames */
+
+static void check_exact(Mp3FrameIndex &ix, const struct truth_s &t,
+                        uint32_t frames)
+{
+  uint32_t n = t.frames.size();
+  Mp3FrameIndex::Accuracy a;
+  uint32_t offset;
+  uint32_t ms;
+
+  if (frames == n)
+    {
+      a = ix.getDuration(&ms);
+      if (a != Mp3FrameIndex::AccuracyExact || ms != to_ms(t, n))
+        {
+          fail(t, "duration", a, ms);
+        }
+
+      /* After the end, the last frame */
+
+      a = ix.seek(to_ms(t, n) + 1000, &offset, &ms);
+      if (a != Mp3FrameIndex::AccuracyExact || offset != t.frames[n - 1])
+        {
+          fail(t, "seek after end", a, offset);
+        }
+    }
+
+  for (int i = 0; i < SEEK_CASES; i++)
+    {
+      uint32_t f = (i == 0) ? 0 : (i == 1) ? frames - 1 : rnd() % frames;
+      uint32_t time = to_ms(t, f);
+
+      /* A time inside of frame f */
+
+      if (f + 1 < n)
+        {
+          time += (to_ms(t, f + 1) - time) / 2;
+        }
+
+      uint32_t expect = (uint64_t)time * t.fs / ((uint64_t)t.spf * 1000);
+
+      a = ix.seek(time, &offset, &ms);
+      if (a != Mp3FrameIndex::AccuracyExact ||
+          offset != t.frames[expect] || ms != to_ms(t, expect))
+        {
+          fail(t, "seek", time, offset);
+        }
+
+      /* An offset inside of frame f */
+
+      offset = t.frames[f];
+      if (f + 1 < n)
+        {
+          offset += rnd() % (t.frames[f + 1] - t.frames[f]);
+        }
+
+      a = ix.getTime(offset, &ms);
+      if (a != Mp3FrameIndex::AccuracyExact || ms != to_ms(t, f))
+        {
+          fail(t, "time", offset, ms);
+        }
+    }
+}
+
+static void feed_file(Mp3FrameIndex &ix, const struct truth_s &t)
+{
+  std::vector<uint8_t> buf(9000);
+  FILE *fp = fopen(t.path.c_str(), "rb");
+  uint32_t half = t.frames[t.frames.size() / 2];
+  uint32_t pos = 0;
+  bool checked = false;
+  size_t size;
+
+  if (fp == NULL)
+    {
+      fail(t, "open", 0, 0);
+      return;
+    }
+
+  while ((size = fread(buf.data(), 1,
+                       1 + rnd() % ((rnd() % 4) ? 8000 : 5), fp)) > 0)
+    {
+      ix.feed(pos, buf.data(), size);
+
+      /* Data which was already indexed is skipped */
+
+      if (rnd() % 10 == 0 && pos > 200)
+        {
+          ix.feed(pos - 200, buf.data(), 10);
+        }
+
+      pos += size;
+
+      /* Exact results for the frames indexed so far */
+
+      if (!checked && !ix.isComplete() && t.frames.size() > 10 &&
+          pos > half)
+        {
+          check_exact(ix, t, t.frames.size() / 2 - 2);
+          checked = true;
+        }
+    }
+
+  fclose(fp);
+}
+
+static void test_file(const struct corpus_s &c)
+{
+  struct truth_s t;
+  std::string idx;
+  struct stat st;
+  uint32_t ms;
+
+  if (!make_file(c, t))
+    {
+      fail(t, "corpus", 0, 0);
+      return;
+    }
+
+  idx = t.path + ".idx";
+
+  Mp3FrameIndex ix;
+
+  if (!ix.open(t.path.c_str()) || ix.getSamplingRate() != t.fs ||
+      ix.getAudioOffset() != t.audio_start)
+    {
+      fail(t, "open", ix.getSamplingRate(), ix.getAudioOffset());
+      return;
+    }
+
+  check_approx(ix, c, t);
+  feed_file(ix, t);
+  if (!ix.isComplete())
+    {
+      fail(t, "not complete after feed", 0, 0);
+      return;
+    }
+
+  check_exact(ix, t, t.frames.size());
+  ix.close();
+
+  /* Reload of the saved index */
+
+  Mp3FrameIndex ix2;
+
+  if (access(idx.c_str(), F_OK) != 0 || !ix2.open(t.path.c_str()) ||
+      !ix2.isComplete())
+    {
+      fail(t, "reload", 0, 0);
+    }
+  else
+    {
+      check_exact(ix2, t, t.frames.size());
+    }
+
+  ix2.close();
+
+  /* The index is not used when the file changed */
+
+  if (stat(t.path.c_str(), &st) == 0)
+    {
+      struct utimbuf ut;
+
+      ut.actime = st.st_atime;
+      ut.modtime = st.st_mtime + 10;
+      utime(t.path.c_str(), &ut);
+    }
+
+  Mp3FrameIndex ix3;
+
+  if (!ix3.open(t.path.c_str()) || ix3.isComplete() ||
+      ix3.getDuration(&ms) == Mp3FrameIndex::AccuracyExact)
+    {
+      fail(t, "index of changed file used", 0, 0);
+    }
+
+  /* build() after a gap in the fed data makes a new index */
+
+  std::vector<uint8_t> buf(5000);
+  FILE *fp = fopen(t.path.c_str(), "rb");
+  size_t size = fp ? fread(buf.data(), 1, buf.size(), fp) : 0;
+
+  if (fp)
+    {
+      fclose(fp);
+    }
+
+  ix3.feed(0, buf.data(), size);
+  ix3.feed(9000, buf.data(), size);
+  if (!ix3.build() || !ix3.isComplete())
+    {
+      fail(t, "build", 0, 0);
+    }
+  else
+    {
+      check_exact(ix3, t, t.frames.size());
+    }
+
+  ix3.close();
+
+  /* A damaged index is not used */
+
+  fp = fopen(idx.c_str(), "r+b");
+  if (fp)
+    {
+      uint32_t garbage = 0x12345678;
+
+      /* One of the header fields or of the first 3 entries */
+
+      fseek(fp, 4 * (rnd() % 13), SEEK_SET);
+      fwrite(&garbage, sizeof(garbage), 1, fp);
+      fclose(fp);
+    }
+
+  Mp3FrameIndex ix4;
+
+  if (!ix4.open(t.path.c_str()) || ix4.isComplete())
+    {
+      fail(t, "damaged index used", 0, 0);
+    }
+
+  ix4.close();
+
+  printf("%-10s %5zu frames, %7u ms\n", c.name, t.frames.size(),
+         to_ms(t, t.frames.size()));
+
+  unlink(t.path.c_str());
+  unlink(idx.c_str());
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  const char *tmpdir = getenv("TMPDIR");
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+  snprintf(g_dir, sizeof(g_dir), "%s/mp3_index.XXXXXX",
+           tmpdir ? tmpdir : "/tmp");
+  if (mkdtemp(g_dir) == NULL)
+    {
+      perror(g_dir);
+      return EXIT_FAILURE;
+    }
+
+  for (size_t i = 0; i < sizeof(g_corpus) / sizeof(g_corpus[0]); i++)
+    {
+      test_file(g_corpus[i]);
+    }
+
+  rmdir(g_dir);
+
+  printf("%zu files, %lu errors\n", sizeof(g_corpus) / sizeof(g_corpus[0]),
+         g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
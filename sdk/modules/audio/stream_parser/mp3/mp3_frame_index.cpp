@@ -0,0 +1,1296 @@
+/****************************************************************************
+ * modules/audio/stream_parser/mp3/mp3_frame_index.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/utilities/mp3_frame_index.h"
+#include "common/Mp3Parser.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Index file
+ *
+ *   Mp3FrameIndexHeader
+ *   uint32_t entry[entry_num]  offset of frame (i * interval)
+ *
+ * It is only used when size, modification time and first audio frame of
+ * the MP3 file are the same as when it was made.
+ */
+
+#define MP3_FRAME_INDEX_MAGIC    0x4946334d  /* "M3FI" */
+#define MP3_FRAME_INDEX_VERSION  1
+
+/* Size of read buffer for build() */
+
+#define MP3_FRAME_INDEX_READ_SIZE    4096
+
+/* Size of read buffer for frame search */
+
+#define MP3_FRAME_INDEX_SEARCH_SIZE  256
+
+/* Bytes of first frame needed to find Xing/Info or VBRI header */
+
+#define MP3_FRAME_INDEX_TAG_READ_SIZE  156
+
+/* Xing/Info header flags */
+
+#define MP3_FRAME_INDEX_XING_FRAMES  0x01
+#define MP3_FRAME_INDEX_XING_BYTES   0x02
+#define MP3_FRAME_INDEX_XING_TOC     0x04
+#define MP3_FRAME_INDEX_XING_TOC_NUM 100
+
+/* VBRI header is always 32 bytes after the frame header */
+
+#define MP3_FRAME_INDEX_VBRI_OFFSET  (MP3PARSER_HEADSIZE + 32)
+#define MP3_FRAME_INDEX_VBRI_SIZE    26
+
+/* Channel mode "single channel" */
+
+#define MP3_FRAME_INDEX_MODE_MONO    3
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct Mp3FrameIndexHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t file_size;
+  uint32_t file_mtime;
+  uint32_t signature;
+  uint32_t audio_first;
+  uint32_t audio_next;
+  uint32_t frames;
+  uint32_t interval;
+  uint32_t entry_num;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Check a frame header as Mp3Parser does, and get the stream signature
+ * (version, layer and sampling frequency, which must not change in a
+ * stream) and the frame size.
+ */
+
+static bool mp3_frame_index_check_header(const uint8_t *head,
+                                         uint32_t *signature,
+                                         uint32_t *frame_size)
+{
+  if ((head[0] != MP3PARSER_SYNCWORD_1) ||
+      ((head[1] & MP3PARSER_SYNCWORD_2) != MP3PARSER_SYNCWORD_2))
+    {
+      return false;
+    }
+
+  uint8_t id    = MP3PARSER_GET_ID(head[1]);
+  uint8_t layer = MP3PARSER_GET_LAYER(head[1]);
+  uint8_t br    = MP3PARSER_GET_BR(head[2]);
+  uint8_t fs    = MP3PARSER_GET_FS(head[2]);
+
+  if ((layer == Mp3ParserLayerReserved) ||
+      (fs == MP3PARSER_FS_RESERVED) ||
+      (br == MP3PARSER_BITRATE_FREE) ||
+      (br == MP3PARSER_BITRATE_UNUSED) ||
+      (MP3PARSER_GET_PRIVATE(head[2]) == MP3PARSER_PRIVATEBIT_ISOUSED) ||
+      (MP3PARSER_GET_EMPHAS(head[3]) == MP3PARSER_EMPHASIS_RESERVED))
+    {
+      return false;
+    }
+
+  *signature = ((uint32_t)(head[1] & 0x0e) << 8) | (head[2] & 0x0c);
+  *frame_size =
+    MP3PARSER_CALC_FRAME_SIZE(id, layer, br, fs,
+                              MP3PARSER_GET_PADDING(head[2]));
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+static uint32_t mp3_frame_index_get_be(const uint8_t *ptr, uint32_t size)
+{
+  uint32_t val = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+    {
+      val = (val << 8) | ptr[i];
+    }
+
+  return val;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+Mp3FrameIndex::Mp3FrameIndex() :
+  m_fp(NULL),
+  m_index_path(NULL),
+  m_entry(NULL),
+  m_complete(false)
+{
+  this->close();
+}
+
+/*--------------------------------------------------------------------------*/
+Mp3FrameIndex::~Mp3FrameIndex()
+{
+  this->close();
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::open(const char *file_path)
+{
+  struct stat file_stat;
+
+  this->close();
+
+  if (file_path == NULL || stat(file_path, &file_stat) != 0)
+    {
+      return false;
+    }
+
+  m_file_size  = static_cast<uint32_t>(file_stat.st_size);
+  m_file_mtime = static_cast<uint32_t>(file_stat.st_mtime);
+
+  m_fp = fopen(file_path, "rb");
+  m_index_path = static_cast<char *>(malloc(strlen(file_path) + 5));
+  m_entry = static_cast<uint32_t *>
+              (malloc(MP3_FRAME_INDEX_MAX_ENTRIES * sizeof(uint32_t)));
+
+  if (m_fp == NULL || m_index_path == NULL || m_entry == NULL)
+    {
+      this->close();
+      return false;
+    }
+
+  sprintf(m_index_path, "%s.idx", file_path);
+
+  if (!this->parseFirstFrame())
+    {
+      this->close();
+      return false;
+    }
+
+  if (this->loadIndex())
+    {
+      m_indexing = false;
+      m_complete = true;
+      m_saved    = true;
+    }
+  else
+    {
+      this->resetIndex();
+    }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::close(void)
+{
+  if (m_complete && !m_saved)
+    {
+      this->save();
+    }
+
+  if (m_fp != NULL)
+    {
+      fclose(m_fp);
+    }
+
+  free(m_index_path);
+  free(m_entry);
+
+  m_fp                = NULL;
+  m_index_path        = NULL;
+  m_entry             = NULL;
+  m_file_size         = 0;
+  m_file_mtime        = 0;
+  m_signature         = 0;
+  m_sampling_rate     = 0;
+  m_samples_per_frame = 0;
+  m_audio_start       = 0;
+  m_audio_first       = 0;
+  m_audio_end         = 0;
+  m_toc_frames        = 0;
+  m_toc_num           = 0;
+  m_entry_num         = 0;
+  m_interval          = 1;
+  m_frames            = 0;
+  m_next              = 0;
+  m_fed_end           = 0;
+  m_head_len          = 0;
+  m_indexing          = false;
+  m_complete          = false;
+  m_saved             = false;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::feed(uint32_t offset, const void *data, uint32_t size)
+{
+  const uint8_t *ptr = static_cast<const uint8_t *>(data);
+
+  if (!m_indexing)
+    {
+      return;
+    }
+
+  if (offset > m_fed_end)
+    {
+      /* Frames in the gap are unknown, the index can only be completed
+       * by build() now.
+       */
+
+      m_indexing = false;
+      return;
+    }
+
+  if (offset + size <= m_fed_end)
+    {
+      return;
+    }
+
+  /* Skip data which was already indexed */
+
+  ptr  += m_fed_end - offset;
+  size -= m_fed_end - offset;
+  offset = m_fed_end;
+
+  uint32_t end = offset + size;
+  m_fed_end = end;
+
+  while (m_next < end && m_next < m_audio_end)
+    {
+      const uint8_t *head;
+      uint32_t signature;
+      uint32_t frame_size;
+
+      if (m_head_len == 0 && m_next + MP3PARSER_HEADSIZE <= end)
+        {
+          head = ptr + (m_next - offset);
+        }
+      else
+        {
+          /* Header is split between feeds. Bytes before offset are kept
+           * in m_head by the previous feed.
+           */
+
+          while (m_head_len < MP3PARSER_HEADSIZE && m_next + m_head_len < end)
+            {
+              m_head[m_head_len] = ptr[m_next + m_head_len - offset];
+              m_head_len++;
+            }
+
+          if (m_head_len < MP3PARSER_HEADSIZE)
+            {
+              break;
+            }
+
+          head = m_head;
+        }
+
+      if (mp3_frame_index_check_header(head, &signature, &frame_size) &&
+          signature == m_signature)
+        {
+          if (m_next + frame_size > m_audio_end)
+            {
+              /* Truncated last frame */
+
+              m_next = m_audio_end;
+              break;
+            }
+
+          m_head_len = 0;
+          this->addFrame(m_next);
+          m_next += frame_size;
+        }
+      else if (head == m_head)
+        {
+          memmove(m_head, m_head + 1, MP3PARSER_HEADSIZE - 1);
+          m_head_len--;
+          m_next++;
+        }
+      else
+        {
+          /* Resync to next syncword candidate */
+
+          const uint8_t *sync =
+            static_cast<const uint8_t *>(memchr(head + 1,
+                                                MP3PARSER_SYNCWORD_1,
+                                                end - m_next - 1));
+          m_next = (sync != NULL) ? offset + (sync - ptr) : end;
+        }
+    }
+
+  if (m_next >= m_audio_end || m_fed_end >= m_file_size)
+    {
+      this->finishIndex();
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::build(void)
+{
+  if (m_fp == NULL)
+    {
+      return false;
+    }
+
+  if (m_complete)
+    {
+      return true;
+    }
+
+  /* Continue from where feed() stopped */
+
+  m_indexing = true;
+
+  uint8_t *buf = static_cast<uint8_t *>(malloc(MP3_FRAME_INDEX_READ_SIZE));
+
+  if (buf == NULL)
+    {
+      return false;
+    }
+
+  bool result = (fseek(m_fp, m_fed_end, SEEK_SET) == 0);
+
+  while (result && m_indexing)
+    {
+      uint32_t offset = m_fed_end;
+      size_t size = fread(buf, 1, MP3_FRAME_INDEX_READ_SIZE, m_fp);
+
+      if (size == 0)
+        {
+          result = (feof(m_fp) != 0);
+          break;
+        }
+
+      this->feed(offset, buf, size);
+    }
+
+  free(buf);
+
+  if (result && m_indexing)
+    {
+      /* File is shorter than when it was opened */
+
+      this->finishIndex();
+    }
+
+  return m_complete;
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::save(void)
+{
+  if (!m_complete)
+    {
+      return false;
+    }
+
+  Mp3FrameIndexHeader hdr;
+
+  hdr.magic       = MP3_FRAME_INDEX_MAGIC;
+  hdr.version     = MP3_FRAME_INDEX_VERSION;
+  hdr.file_size   = m_file_size;
+  hdr.file_mtime  = m_file_mtime;
+  hdr.signature   = m_signature;
+  hdr.audio_first = m_audio_first;
+  hdr.audio_next  = m_next;
+  hdr.frames      = m_frames;
+  hdr.interval    = m_interval;
+  hdr.entry_num   = m_entry_num;
+
+  FILE *fp = fopen(m_index_path, "wb");
+
+  if (fp == NULL)
+    {
+      return false;
+    }
+
+  bool result =
+    (fwrite(&hdr, sizeof(hdr), 1, fp) == 1) &&
+    (fwrite(m_entry, sizeof(uint32_t), m_entry_num, fp) == m_entry_num);
+
+  if (fclose(fp) != 0)
+    {
+      result = false;
+    }
+
+  if (!result)
+    {
+      remove(m_index_path);
+    }
+
+  m_saved = true;
+
+  return result;
+}
+
+/*--------------------------------------------------------------------------*/
+Mp3FrameIndex::Accuracy Mp3FrameIndex::seek(uint32_t time_ms,
+                                            uint32_t *offset,
+                                            uint32_t *frame_ms)
+{
+  uint32_t frame = this->msToFrame(time_ms);
+  uint32_t found;
+  uint32_t walked;
+
+  if (m_fp == NULL)
+    {
+      return AccuracyNone;
+    }
+
+  if (m_frames > 0 && (frame < m_frames || m_complete))
+    {
+      if (frame >= m_frames)
+        {
+          frame = m_frames - 1;
+        }
+
+      uint32_t idx = frame / m_interval;
+
+      if (this->walkFrames(m_entry[idx], frame - idx * m_interval,
+                           UINT32_MAX, &found, &walked))
+        {
+          *offset   = found;
+          *frame_ms = this->frameToMs(frame);
+          return AccuracyExact;
+        }
+    }
+
+  if (m_toc_num == 0)
+    {
+      return AccuracyNone;
+    }
+
+  uint32_t estimated = this->tocOffset(frame);
+
+  if (!this->findFrame(estimated, true, &found))
+    {
+      /* The estimated offset is after the start of the last frame, e.g.
+       * when the estimation is too long. Search before it and take the
+       * last frame.
+       */
+
+      uint32_t back = MP3_FRAME_INDEX_READ_SIZE;
+      uint32_t last;
+      bool result = false;
+
+      while (!result && estimated > m_audio_first)
+        {
+          estimated = (estimated - m_audio_first > back) ?
+                        estimated - back : m_audio_first;
+          back *= 2;
+          result = this->findFrame(estimated, true, &found);
+        }
+
+      if (!result)
+        {
+          return AccuracyNone;
+        }
+
+      if (this->walkFrames(found, UINT32_MAX, m_audio_end - 1, &last,
+                           &walked))
+        {
+          found = last;
+        }
+    }
+
+  *offset   = found;
+  *frame_ms = this->frameToMs(this->tocFrame(found));
+
+  return (m_toc_frames != 0) ? AccuracyToc : AccuracyEstimated;
+}
+
+/*--------------------------------------------------------------------------*/
+Mp3FrameIndex::Accuracy Mp3FrameIndex::getTime(uint32_t offset,
+                                               uint32_t *time_ms)
+{
+  if (m_fp == NULL)
+    {
+      return AccuracyNone;
+    }
+
+  if (m_frames > 0 && offset < m_next)
+    {
+      if (offset < m_entry[0])
+        {
+          *time_ms = 0;
+          return AccuracyExact;
+        }
+
+      /* Last entry at or before offset */
+
+      uint32_t lo = 0;
+      uint32_t hi = m_entry_num;
+
+      while (hi - lo > 1)
+        {
+          uint32_t mid = lo + (hi - lo) / 2;
+
+          if (m_entry[mid] <= offset)
+            {
+              lo = mid;
+            }
+          else
+            {
+              hi = mid;
+            }
+        }
+
+      uint32_t found;
+      uint32_t walked;
+
+      if (this->walkFrames(m_entry[lo], m_interval, offset, &found, &walked))
+        {
+          *time_ms = this->frameToMs(lo * m_interval + walked);
+          return AccuracyExact;
+        }
+    }
+
+  if (m_toc_num == 0)
+    {
+      return AccuracyNone;
+    }
+
+  *time_ms = this->frameToMs(this->tocFrame(offset));
+
+  return (m_toc_frames != 0) ? AccuracyToc : AccuracyEstimated;
+}
+
+/*--------------------------------------------------------------------------*/
+Mp3FrameIndex::Accuracy Mp3FrameIndex::getDuration(uint32_t *duration_ms)
+{
+  if (m_fp == NULL)
+    {
+      return AccuracyNone;
+    }
+
+  if (m_complete)
+    {
+      *duration_ms = this->frameToMs(m_frames);
+      return AccuracyExact;
+    }
+
+  if (m_toc_num == 0)
+    {
+      return AccuracyNone;
+    }
+
+  *duration_ms = this->frameToMs(m_toc[m_toc_num - 1].frame);
+
+  return (m_toc_frames != 0) ? AccuracyToc : AccuracyEstimated;
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+bool Mp3FrameIndex::parseFirstFrame(void)
+{
+  uint8_t  buf[MP3_FRAME_INDEX_TAG_READ_SIZE];
+  uint32_t pos = 0;
+
+  /* Skip ID3v2 tag */
+
+  if (this->readAt(0, buf, Mp3ParserID3v2HeaderLength) &&
+      buf[Mp3ParserID3v2HeadIndexID1] == MP3PARSER_ID3V2_ID1 &&
+      buf[Mp3ParserID3v2HeadIndexID2] == MP3PARSER_ID3V2_ID2 &&
+      buf[Mp3ParserID3v2HeadIndexID3] == MP3PARSER_ID3V2_ID3)
+    {
+      pos = Mp3ParserID3v2HeaderLength +
+            MP3PARSER_ID3v2_GET_LENGTH(buf[Mp3ParserID3v2HeadIndexLen1],
+                                       buf[Mp3ParserID3v2HeadIndexLen2],
+                                       buf[Mp3ParserID3v2HeadIndexLen3],
+                                       buf[Mp3ParserID3v2HeadIndexLen4]);
+
+      /* Footer present */
+
+      if (buf[Mp3ParserID3v2HeadIndexFlag] & 0x10)
+        {
+          pos += Mp3ParserID3v2HeaderLength;
+        }
+    }
+
+  /* Exclude ID3v1 tag */
+
+  m_audio_end = m_file_size;
+
+  if (m_file_size >= MP3PARSER_ID3v1_FIXED_LENGTH &&
+      this->readAt(m_file_size - MP3PARSER_ID3v1_FIXED_LENGTH, buf, 3) &&
+      buf[Mp3ParserID3v1HeadIndexID1] == MP3PARSER_ID3V1_ID1 &&
+      buf[Mp3ParserID3v1HeadIndexID2] == MP3PARSER_ID3V1_ID2 &&
+      buf[Mp3ParserID3v1HeadIndexID3] == MP3PARSER_ID3V1_ID3)
+    {
+      m_audio_end -= MP3PARSER_ID3v1_FIXED_LENGTH;
+    }
+
+  if (!this->findFrame(pos, true, &m_audio_start))
+    {
+      return false;
+    }
+
+  uint32_t size = m_audio_end - m_audio_start;
+
+  if (size > sizeof(buf))
+    {
+      size = sizeof(buf);
+    }
+
+  uint32_t frame_size;
+
+  if (!this->readAt(m_audio_start, buf, size) ||
+      !mp3_frame_index_check_header(buf, &m_signature, &frame_size))
+    {
+      return false;
+    }
+
+  uint8_t id    = MP3PARSER_GET_ID(buf[1]);
+  uint8_t layer = MP3PARSER_GET_LAYER(buf[1]);
+  uint8_t fs    = MP3PARSER_GET_FS(buf[2]);
+
+  if (id == Mp3ParserMpeg1)
+    {
+      m_sampling_rate     = mp3_parser_v1_sampling_frequency[fs];
+      m_samples_per_frame = mp3_parser_v1_num_samples_frame[layer];
+    }
+  else
+    {
+      m_sampling_rate     = mp3_parser_v2_sampling_frequency[fs];
+      m_samples_per_frame = mp3_parser_v2_num_samples_frame[layer];
+    }
+
+  m_audio_first = m_audio_start;
+
+  if (size > frame_size)
+    {
+      size = frame_size;
+    }
+
+  if (layer == Mp3ParserLayer3)
+    {
+      this->parseXing(buf, size);
+
+      if (m_toc_num == 0)
+        {
+          this->parseVbri(buf, size);
+        }
+    }
+
+  if (m_toc_num == 0)
+    {
+      /* Estimate from the bitrate of the first frame, assuming CBR */
+
+      uint8_t br = MP3PARSER_GET_BR(buf[2]);
+      uint64_t bitrate = (id == Mp3ParserMpeg1) ?
+                           mp3_parser_v1_bitrate[layer][br] :
+                           mp3_parser_v2_bitrate[layer][br];
+      uint64_t frames = (uint64_t)(m_audio_end - m_audio_first) *
+                        MP3PARSER_BITLENGTH_BYTE * m_sampling_rate /
+                        (bitrate * m_samples_per_frame);
+
+      this->addTocPoint(0, m_audio_first);
+      this->addTocPoint(static_cast<uint32_t>(frames), m_audio_end);
+    }
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::parseXing(const uint8_t *frame, uint32_t size)
+{
+  bool mono = (MP3PARSER_GET_MODE(frame[3]) == MP3_FRAME_INDEX_MODE_MONO);
+  uint32_t pos = MP3PARSER_HEADSIZE;
+  uint32_t frame_size;
+  uint32_t signature;
+
+  /* Xing/Info header follows side information */
+
+  if (MP3PARSER_GET_ID(frame[1]) == Mp3ParserMpeg1)
+    {
+      pos += mono ? 17 : 32;
+    }
+  else
+    {
+      pos += mono ? 9 : 17;
+    }
+
+  if (pos + 8 > size ||
+      (memcmp(frame + pos, "Xing", 4) != 0 &&
+       memcmp(frame + pos, "Info", 4) != 0))
+    {
+      return;
+    }
+
+  uint32_t flags = mp3_frame_index_get_be(frame + pos + 4, 4);
+  uint32_t frames = 0;
+  uint32_t bytes = 0;
+  const uint8_t *toc = NULL;
+
+  pos += 8;
+
+  if (flags & MP3_FRAME_INDEX_XING_FRAMES)
+    {
+      if (pos + 4 > size)
+        {
+          return;
+        }
+
+      frames = mp3_frame_index_get_be(frame + pos, 4);
+      pos += 4;
+    }
+
+  if (flags & MP3_FRAME_INDEX_XING_BYTES)
+    {
+      if (pos + 4 > size)
+        {
+          return;
+        }
+
+      bytes = mp3_frame_index_get_be(frame + pos, 4);
+      pos += 4;
+    }
+
+  if ((flags & MP3_FRAME_INDEX_XING_TOC) &&
+      pos + MP3_FRAME_INDEX_XING_TOC_NUM <= size)
+    {
+      toc = frame + pos;
+    }
+
+  /* The Xing/Info frame has no audio even without frame count */
+
+  mp3_frame_index_check_header(frame, &signature, &frame_size);
+  m_audio_first = m_audio_start + frame_size;
+
+  if (frames == 0)
+    {
+      return;
+    }
+
+  if (bytes == 0 || bytes > m_audio_end - m_audio_start)
+    {
+      bytes = m_audio_end - m_audio_start;
+    }
+
+  m_toc_frames = frames;
+
+  if (toc != NULL)
+    {
+      /* TOC is byte position of each percent of play time in 1/256 of
+       * bytes, from the top of the Xing/Info frame.
+       */
+
+      for (uint32_t i = 0; i < MP3_FRAME_INDEX_XING_TOC_NUM; i++)
+        {
+          this->addTocPoint(static_cast<uint32_t>
+                              ((uint64_t)frames * i /
+                               MP3_FRAME_INDEX_XING_TOC_NUM),
+                            m_audio_start + static_cast<uint32_t>
+                              ((uint64_t)toc[i] * bytes / 256));
+        }
+    }
+  else
+    {
+      this->addTocPoint(0, m_audio_first);
+    }
+
+  this->addTocPoint(frames, m_audio_start + bytes);
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::parseVbri(const uint8_t *frame, uint32_t size)
+{
+  const uint8_t *vbri = frame + MP3_FRAME_INDEX_VBRI_OFFSET;
+  uint32_t frame_size;
+  uint32_t signature;
+
+  if (MP3_FRAME_INDEX_VBRI_OFFSET + MP3_FRAME_INDEX_VBRI_SIZE > size ||
+      memcmp(vbri, "VBRI", 4) != 0)
+    {
+      return;
+    }
+
+  uint32_t bytes      = mp3_frame_index_get_be(vbri + 10, 4);
+  uint32_t frames     = mp3_frame_index_get_be(vbri + 14, 4);
+  uint32_t entry_num  = mp3_frame_index_get_be(vbri + 18, 2);
+  uint32_t scale      = mp3_frame_index_get_be(vbri + 20, 2);
+  uint32_t entry_size = mp3_frame_index_get_be(vbri + 22, 2);
+  uint32_t entry_frames = mp3_frame_index_get_be(vbri + 24, 2);
+
+  mp3_frame_index_check_header(frame, &signature, &frame_size);
+  m_audio_first = m_audio_start + frame_size;
+
+  if (frames == 0)
+    {
+      return;
+    }
+
+  if (bytes == 0 || bytes > m_audio_end - m_audio_start)
+    {
+      bytes = m_audio_end - m_audio_start;
+    }
+
+  m_toc_frames = frames;
+
+  /* TOC is byte size of each entry_frames frames. Keep every step-th
+   * entry to fit in m_toc.
+   */
+
+  if (entry_size < 1 || entry_size > 4 || entry_frames == 0)
+    {
+      entry_num = 0;
+    }
+
+  uint32_t step = (entry_num + MP3_FRAME_INDEX_MAX_TOC - 2) /
+                  (MP3_FRAME_INDEX_MAX_TOC - 1);
+  uint32_t pos  = m_audio_start + MP3_FRAME_INDEX_VBRI_OFFSET +
+                  MP3_FRAME_INDEX_VBRI_SIZE;
+  uint64_t offset = m_audio_first;
+  uint8_t  buf[60];
+  uint32_t buf_len = 0;
+  uint32_t buf_pos = 0;
+
+  for (uint32_t i = 0; i < entry_num; i++)
+    {
+      uint64_t frame_no = (uint64_t)i * entry_frames;
+
+      if (frame_no >= frames)
+        {
+          break;
+        }
+
+      if (buf_pos == buf_len)
+        {
+          buf_len = (entry_num - i) * entry_size;
+
+          if (buf_len > sizeof(buf) / entry_size * entry_size)
+            {
+              buf_len = sizeof(buf) / entry_size * entry_size;
+            }
+
+          if (!this->readAt(pos, buf, buf_len))
+            {
+              break;
+            }
+
+          pos += buf_len;
+          buf_pos = 0;
+        }
+
+      if (i % step == 0)
+        {
+          this->addTocPoint(static_cast<uint32_t>(frame_no),
+                            static_cast<uint32_t>(offset));
+        }
+
+      offset += (uint64_t)mp3_frame_index_get_be(buf + buf_pos, entry_size) *
+                scale;
+      buf_pos += entry_size;
+    }
+
+  if (m_toc_num == 0)
+    {
+      this->addTocPoint(0, m_audio_first);
+    }
+
+  this->addTocPoint(frames, m_audio_start + bytes);
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::addTocPoint(uint32_t frame, uint32_t offset)
+{
+  /* Keep points increasing in frame and not decreasing in offset,
+   * inside of audio frames.
+   */
+
+  if (offset < m_audio_first)
+    {
+      offset = m_audio_first;
+    }
+
+  if (offset > m_audio_end)
+    {
+      offset = m_audio_end;
+    }
+
+  if (m_toc_num > 0)
+    {
+      TocPoint *last = &m_toc[m_toc_num - 1];
+
+      if (frame <= last->frame)
+        {
+          return;
+        }
+
+      if (offset < last->offset)
+        {
+          offset = last->offset;
+        }
+    }
+
+  if (m_toc_num < MP3_FRAME_INDEX_MAX_TOC)
+    {
+      m_toc[m_toc_num].frame  = frame;
+      m_toc[m_toc_num].offset = offset;
+      m_toc_num++;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::loadIndex(void)
+{
+  Mp3FrameIndexHeader hdr;
+  FILE *fp = fopen(m_index_path, "rb");
+
+  if (fp == NULL)
+    {
+      return false;
+    }
+
+  bool valid =
+    (fread(&hdr, sizeof(hdr), 1, fp) == 1) &&
+    hdr.magic == MP3_FRAME_INDEX_MAGIC &&
+    hdr.version == MP3_FRAME_INDEX_VERSION &&
+    hdr.file_size == m_file_size &&
+    hdr.file_mtime == m_file_mtime &&
+    hdr.signature == m_signature &&
+    hdr.audio_first == m_audio_first &&
+    hdr.frames > 0 &&
+    hdr.interval > 0 &&
+    (hdr.interval & (hdr.interval - 1)) == 0 &&
+    hdr.entry_num <= MP3_FRAME_INDEX_MAX_ENTRIES &&
+    hdr.entry_num == (hdr.frames - 1) / hdr.interval + 1 &&
+    (fread(m_entry, sizeof(uint32_t), hdr.entry_num, fp) == hdr.entry_num);
+
+  fclose(fp);
+
+  /* Offsets must increase, so that binary search works */
+
+  for (uint32_t i = 0; valid && i < hdr.entry_num; i++)
+    {
+      valid = (i == 0) ? (m_entry[i] == m_audio_first) :
+                         (m_entry[i - 1] < m_entry[i]);
+    }
+
+  if (valid && hdr.audio_next > m_entry[hdr.entry_num - 1] &&
+      hdr.audio_next <= m_file_size)
+    {
+      m_entry_num = hdr.entry_num;
+      m_interval  = hdr.interval;
+      m_frames    = hdr.frames;
+      m_next      = hdr.audio_next;
+      m_fed_end   = m_file_size;
+      return true;
+    }
+
+  return false;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::resetIndex(void)
+{
+  m_entry_num = 0;
+  m_interval  = 1;
+  m_frames    = 0;
+  m_next      = m_audio_first;
+  m_fed_end   = m_audio_first;
+  m_head_len  = 0;
+  m_indexing  = true;
+  m_complete  = false;
+  m_saved     = false;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::addFrame(uint32_t offset)
+{
+  if ((m_frames & (m_interval - 1)) == 0)
+    {
+      if (m_entry_num == MP3_FRAME_INDEX_MAX_ENTRIES)
+        {
+          /* Double the interval, keeping even entries */
+
+          for (uint32_t i = 1; i < MP3_FRAME_INDEX_MAX_ENTRIES / 2; i++)
+            {
+              m_entry[i] = m_entry[i * 2];
+            }
+
+          m_entry_num = MP3_FRAME_INDEX_MAX_ENTRIES / 2;
+          m_interval *= 2;
+        }
+
+      if ((m_frames & (m_interval - 1)) == 0)
+        {
+          m_entry[m_entry_num++] = offset;
+        }
+    }
+
+  m_frames++;
+}
+
+/*--------------------------------------------------------------------------*/
+void Mp3FrameIndex::finishIndex(void)
+{
+  m_indexing = false;
+  m_head_len = 0;
+
+  if (m_frames > 0)
+    {
+      m_complete = true;
+      m_saved    = false;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::readAt(uint32_t offset, void *buf, uint32_t size)
+{
+  return (fseek(m_fp, offset, SEEK_SET) == 0) &&
+         (fread(buf, 1, size, m_fp) == size);
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::findFrame(uint32_t offset, bool strict, uint32_t *found)
+{
+  uint8_t buf[MP3_FRAME_INDEX_SEARCH_SIZE];
+
+  /* Same search as feed() does, i.e. the first header of this stream.
+   * If strict, the next header must follow too, as at a random offset
+   * a syncword is often found in audio data.
+   */
+
+  while (offset + MP3PARSER_HEADSIZE <= m_audio_end)
+    {
+      uint32_t size = m_audio_end - offset;
+
+      if (size > sizeof(buf))
+        {
+          size = sizeof(buf);
+        }
+
+      if (!this->readAt(offset, buf, size))
+        {
+          return false;
+        }
+
+      for (uint32_t i = 0; i + MP3PARSER_HEADSIZE <= size; i++)
+        {
+          uint32_t signature;
+          uint32_t frame_size;
+          uint8_t  next[MP3PARSER_HEADSIZE];
+          uint32_t next_signature;
+          uint32_t next_size;
+
+          if (buf[i] != MP3PARSER_SYNCWORD_1 ||
+              !mp3_frame_index_check_header(&buf[i], &signature,
+                                            &frame_size) ||
+              (m_signature != 0 && signature != m_signature))
+            {
+              continue;
+            }
+
+          if (strict)
+            {
+              uint32_t next_offset = offset + i + frame_size;
+
+              if (next_offset + MP3PARSER_HEADSIZE <= m_audio_end &&
+                  (!this->readAt(next_offset, next, sizeof(next)) ||
+                   !mp3_frame_index_check_header(next, &next_signature,
+                                                 &next_size) ||
+                   next_signature != signature))
+                {
+                  continue;
+                }
+            }
+
+          *found = offset + i;
+          return true;
+        }
+
+      offset += size - (MP3PARSER_HEADSIZE - 1);
+    }
+
+  return false;
+}
+
+/*--------------------------------------------------------------------------*/
+bool Mp3FrameIndex::walkFrames(uint32_t offset, uint32_t count,
+                               uint32_t limit, uint32_t *end,
+                               uint32_t *walked)
+{
+  uint32_t num = 0;
+
+  uint32_t prev = offset;
+
+  /* Walk at most count frames from offset, and stop at the last frame
+   * which starts at or before limit. Only headers are read.
+   */
+
+  while (true)
+    {
+      uint8_t  head[MP3PARSER_HEADSIZE];
+      uint32_t signature;
+      uint32_t frame_size;
+
+      if (!this->readAt(offset, head, sizeof(head)))
+        {
+          return false;
+        }
+
+      if (!mp3_frame_index_check_header(head, &signature, &frame_size) ||
+          signature != m_signature)
+        {
+          /* Garbage between frames, skipped as feed() did */
+
+          if (!this->findFrame(offset + 1, false, &offset))
+            {
+              return false;
+            }
+
+          if (num > 0 && limit < offset)
+            {
+              offset = prev;
+              num--;
+              break;
+            }
+
+          continue;
+        }
+
+      if (num == count || limit < offset + frame_size)
+        {
+          break;
+        }
+
+      prev    = offset;
+      offset += frame_size;
+      num++;
+    }
+
+  *end    = offset;
+  *walked = num;
+
+  return true;
+}
+
+/*--------------------------------------------------------------------------*/
+uint32_t Mp3FrameIndex::tocOffset(uint32_t frame)
+{
+  uint32_t lo = 0;
+  uint32_t hi = m_toc_num;
+
+  while (hi - lo > 1)
+    {
+      uint32_t mid = lo + (hi - lo) / 2;
+
+      if (m_toc[mid].frame <= frame)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  if (lo + 1 >= m_toc_num || frame <= m_toc[lo].frame)
+    {
+      return m_toc[lo].offset;
+    }
+
+  const TocPoint *p0 = &m_toc[lo];
+  const TocPoint *p1 = &m_toc[lo + 1];
+
+  return p0->offset +
+         static_cast<uint32_t>((uint64_t)(frame - p0->frame) *
+                               (p1->offset - p0->offset) /
+                               (p1->frame - p0->frame));
+}
+
+/*--------------------------------------------------------------------------*/
+uint32_t Mp3FrameIndex::tocFrame(uint32_t offset)
+{
+  uint32_t lo = 0;
+  uint32_t hi = m_toc_num;
+
+  while (hi - lo > 1)
+    {
+      uint32_t mid = lo + (hi - lo) / 2;
+
+      if (m_toc[mid].offset <= offset)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  if (lo + 1 >= m_toc_num || offset <= m_toc[lo].offset)
+    {
+      return m_toc[lo].frame;
+    }
+
+  const TocPoint *p0 = &m_toc[lo];
+  const TocPoint *p1 = &m_toc[lo + 1];
+
+  return p0->frame +
+         static_cast<uint32_t>((uint64_t)(offset - p0->offset) *
+                               (p1->frame - p0->frame) /
+                               (p1->offset - p0->offset));
+}
+
+/*--------------------------------------------------------------------------*/
+uint32_t Mp3FrameIndex::frameToMs(uint32_t frame)
+{
+  return static_cast<uint32_t>((uint64_t)frame * m_samples_per_frame *
+                               1000 / m_sampling_rate);
+}
+
+/*--------------------------------------------------------------------------*/
+uint32_t Mp3FrameIndex::msToFrame(uint32_t time_ms)
+{
+  return static_cast<uint32_t>((uint64_t)time_ms * m_sampling_rate /
+                               ((uint64_t)m_samples_per_frame * 1000));
+}
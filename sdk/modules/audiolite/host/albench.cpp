@@ -0,0 +1,328 @@
+/****************************************************************************
+ * modules/audiolite/host/albench.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Producer/consumer benchmark of audiolite_mempoolapbuf.  Every pair of
+ * threads passes blocks through a ring, as a decoder passes frames to the
+ * worker: the producer allocates a block, writes a sequence number in it
+ * and queues it, and the consumer checks the number and releases it.  The
+ * producer holds its own reference until the block is queued, so the two
+ * releases race as they do in the pipeline.  Rings are deeper than the
+ * pool, so producers wait for free blocks.  Build it with and without the
+ * lock-free pool to compare them, see the Makefile.
+ *
+ * A block given to two owners, a lost block or wrong statistics is an
+ * error, and the program fails if there is any.
+ *
+ *   albench [pairs] [blocks] [ops] [n]
+ *
+ * With "n" allocate() does not block, and producers retry while the pool
+ * is empty.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <audiolite/al_memalloc.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_PAIRS   16
+#define MAX_BLOCKS  256
+#define BLOCK_SIZE  256
+#define RING_SIZE   64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ring_s
+{
+  uint32_t head;
+  uint32_t tail;
+  audiolite_mem *slot[RING_SIZE];
+};
+
+struct pair_s
+{
+  int id;
+  pthread_t producer;
+  pthread_t consumer;
+  struct ring_s ring;
+  uint32_t fails;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static audiolite_mempoolapbuf s_pool;
+static char s_mem[MAX_BLOCKS * BLOCK_SIZE];
+static uint8_t s_owned[MAX_BLOCKS];
+static struct pair_s s_pairs[MAX_PAIRS];
+static long s_ops = 1000000;
+static bool s_blocking = true;
+static bool s_start;
+static int s_errors;
+
+#ifdef CONFIG_SMP_NCPUS
+static int s_next_cpu;
+static __thread int s_cpu = -1;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void fail(const char *what, int pair, long seq)
+{
+  if (__atomic_fetch_add(&s_errors, 1, __ATOMIC_RELAXED) < 8)
+    {
+      fprintf(stderr, "pair %d op %ld: %s\n", pair, seq, what);
+    }
+}
+
+static uint64_t time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int block_of(audiolite_mem *mem)
+{
+  return ((char *)mem->get_data() - s_mem) / BLOCK_SIZE;
+}
+
+static void *producer(void *arg)
+{
+  struct pair_s *p = (struct pair_s *)arg;
+  struct ring_s *r = &p->ring;
+  audiolite_mem *mem;
+  uint32_t *data;
+  long seq = 0;
+
+  while (!__atomic_load_n(&s_start, __ATOMIC_ACQUIRE))
+    {
+    }
+
+  while (seq < s_ops)
+    {
+      if (r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) ==
+          RING_SIZE)
+        {
+          sched_yield();
+          continue;
+        }
+
+      mem = s_pool.allocate(s_blocking);
+      if (mem == NULL)
+        {
+          if (s_blocking)
+            {
+              fail("allocate failed", p->id, seq);
+              break;
+            }
+
+          p->fails++;
+          sched_yield();
+          continue;
+        }
+
+      if (__atomic_exchange_n(&s_owned[block_of(mem)], 1, __ATOMIC_ACQ_REL))
+        {
+          fail("block allocated twice", p->id, seq);
+        }
+
+      data = (uint32_t *)mem->get_data();
+      data[0] = p->id;
+      data[1] = seq;
+      data[BLOCK_SIZE / 4 - 1] = seq;
+
+      mem->reference();
+      r->slot[r->head % RING_SIZE] = mem;
+      __atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+      mem->release();
+      seq++;
+    }
+
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  struct pair_s *p = (struct pair_s *)arg;
+  struct ring_s *r = &p->ring;
+  audiolite_mem *mem;
+  uint32_t *data;
+  long seq = 0;
+
+  while (seq < s_ops)
+    {
+      if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == r->tail)
+        {
+          sched_yield();
+          continue;
+        }
+
+      mem = r->slot[r->tail % RING_SIZE];
+      data = (uint32_t *)mem->get_data();
+
+      if (data[0] != (uint32_t)p->id || data[1] != (uint32_t)seq ||
+          data[BLOCK_SIZE / 4 - 1] != (uint32_t)seq)
+        {
+          fail("data overwritten", p->id, seq);
+        }
+
+      __atomic_store_n(&s_owned[block_of(mem)], 0, __ATOMIC_RELEASE);
+      __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+      mem->release();
+      seq++;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Every thread runs on the next CPU in turn */
+
+int up_cpu_index(void)
+{
+#ifdef CONFIG_SMP_NCPUS
+  if (s_cpu < 0)
+    {
+      s_cpu = __atomic_fetch_add(&s_next_cpu, 1, __ATOMIC_RELAXED) %
+              CONFIG_SMP_NCPUS;
+    }
+
+  return s_cpu;
+#else
+  return 0;
+#endif
+}
+
+int main(int argc, char **argv)
+{
+  int pairs = (argc > 1) ? atoi(argv[1]) : 1;
+  int blocks = (argc > 2) ? atoi(argv[2]) : 8;
+  struct audiolite_mempool_stats_s st;
+  uint32_t fails = 0;
+  int i;
+
+  if (argc > 3)
+    {
+      s_ops = atol(argv[3]);
+    }
+
+  if (argc > 4)
+    {
+      s_blocking = strcmp(argv[4], "n") != 0;
+    }
+
+  if (pairs < 1 || pairs > MAX_PAIRS || blocks < 1 || blocks > MAX_BLOCKS ||
+      s_ops < 1)
+    {
+      fprintf(stderr, "usage: %s [pairs(1-%d)] [blocks(1-%d)] [ops] [n]\n",
+              argv[0], MAX_PAIRS, MAX_BLOCKS);
+      return 2;
+    }
+
+  if (!s_pool.create_instance(BLOCK_SIZE, blocks, s_mem, sizeof(s_mem)))
+    {
+      fprintf(stderr, "pool creation failed\n");
+      return 1;
+    }
+
+  for (i = 0; i < pairs; i++)
+    {
+      s_pairs[i].id = i;
+      pthread_create(&s_pairs[i].producer, NULL, producer, &s_pairs[i]);
+      pthread_create(&s_pairs[i].consumer, NULL, consumer, &s_pairs[i]);
+    }
+
+  uint64_t start = time_ns();
+  __atomic_store_n(&s_start, true, __ATOMIC_RELEASE);
+
+  for (i = 0; i < pairs; i++)
+    {
+      pthread_join(s_pairs[i].producer, NULL);
+      pthread_join(s_pairs[i].consumer, NULL);
+      fails += s_pairs[i].fails;
+    }
+
+  double elapsed = time_ns() - start;
+
+  /* Every block is back, and every allocation was counted */
+
+  s_pool.get_stats(&st);
+
+  if (st.blocks != blocks || st.used != 0 || st.peak < 1 ||
+      st.allocs != (uint32_t)(pairs * s_ops) || st.frees != st.allocs ||
+      st.alloc_fails != fails)
+    {
+      fprintf(stderr, "stats: blocks %d used %d peak %d allocs %u "
+              "fails %u frees %u\n", st.blocks, st.used, st.peak,
+              st.allocs, st.alloc_fails, st.frees);
+      s_errors++;
+    }
+
+  for (i = 0; i < blocks; i++)
+    {
+      audiolite_mem *mem = s_pool.allocate(false);
+
+      if (mem == NULL)
+        {
+          fprintf(stderr, "block %d lost\n", i);
+          s_errors++;
+          break;
+        }
+    }
+
+  printf("%s: %d pairs, %d blocks%s: %.1f ns/block, peak %d, %u fails, "
+         "%d errors\n", argv[0], pairs, blocks,
+         s_blocking ? "" : " (non-blocking)", elapsed / (pairs * s_ops),
+         st.peak, st.alloc_fails, s_errors);
+
+  return s_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
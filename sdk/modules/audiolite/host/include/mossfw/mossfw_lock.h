@@ -0,0 +1,54 @@
+/****************************************************************************
+ * modules/audiolite/host/include/mossfw/mossfw_lock.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host replacement of the mossfw lock, on pthread */
+
+#ifndef HOST_MOSSFW_LOCK_H
+#define HOST_MOSSFW_LOCK_H
+
+#include <pthread.h>
+
+typedef pthread_mutex_t mossfw_lock_t;
+typedef pthread_cond_t  mossfw_condition_t;
+
+#define mossfw_lock_init(l)        pthread_mutex_init(l, NULL)
+#define mossfw_lock_fin(l)         pthread_mutex_destroy(l)
+#define mossfw_lock_take(l)        pthread_mutex_lock(l)
+#define mossfw_lock_give(l)        pthread_mutex_unlock(l)
+#define mossfw_condition_init(c)   pthread_cond_init(c, NULL)
+#define mossfw_condition_wait(c,l) pthread_cond_wait(c, l)
+#define mossfw_condition_notice(c) pthread_cond_signal(c)
+
+#endif /* HOST_MOSSFW_LOCK_H */
@@ -0,0 +1,69 @@
+/****************************************************************************
+ * modules/audiolite/host/include/nuttx/audio/audio.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host replacement of the NuttX audio buffer, only the members used by
+ * audiolite_memapbuf.
+ */
+
+#ifndef HOST_NUTTX_AUDIO_AUDIO_H
+#define HOST_NUTTX_AUDIO_AUDIO_H
+
+#include <stdint.h>
+#include <semaphore.h>
+
+#include <nuttx/queue.h>
+
+#define AUDIO_APB_FINAL (1 << 1)
+
+struct audio_info_s
+{
+  uint32_t samplerate;
+  uint8_t  channels;
+};
+
+struct ap_buffer_s
+{
+  dq_entry_t          dq_entry;
+  struct audio_info_s i;
+  uint8_t            *samp;
+  uint32_t            nmaxbytes;
+  uint32_t            nbytes;
+  uint32_t            curbyte;
+  sem_t               sem;
+  uint16_t            flags;
+  uint8_t             crefs;
+};
+
+#endif /* HOST_NUTTX_AUDIO_AUDIO_H */
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * modules/audiolite/host/include/nuttx/queue.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host replacement of the NuttX doubly linked queue */
+
+#ifndef HOST_NUTTX_QUEUE_H
+#define HOST_NUTTX_QUEUE_H
+
+#include <stddef.h>
+
+typedef struct dq_entry_s
+{
+  struct dq_entry_s *flink;
+  struct dq_entry_s *blink;
+} dq_entry_t;
+
+struct dq_queue_s
+{
+  dq_entry_t *head;
+  dq_entry_t *tail;
+};
+
+typedef struct dq_queue_s dq_queue_t;
+
+static inline void dq_init(dq_queue_t *queue)
+{
+  queue->head = NULL;
+  queue->tail = NULL;
+}
+
+static inline void dq_addlast(dq_entry_t *node, dq_queue_t *queue)
+{
+  node->flink = NULL;
+  node->blink = queue->tail;
+
+  if (queue->tail)
+    {
+      queue->tail->flink = node;
+    }
+  else
+    {
+      queue->head = node;
+    }
+
+  queue->tail = node;
+}
+
+static inline dq_entry_t *dq_remfirst(dq_queue_t *queue)
+{
+  dq_entry_t *node = queue->head;
+
+  if (node)
+    {
+      queue->head = node->flink;
+
+      if (queue->head)
+        {
+          queue->head->blink = NULL;
+        }
+      else
+        {
+          queue->tail = NULL;
+        }
+    }
+
+  return node;
+}
+
+static inline size_t dq_count(dq_queue_t *queue)
+{
+  dq_entry_t *node;
+  size_t count = 0;
+
+  for (node = queue->head; node; node = node->flink)
+    {
+      count++;
+    }
+
+  return count;
+}
+
+#endif /* HOST_NUTTX_QUEUE_H */
@@ -50,6 +50,10 @@
 #include <audiolite/al_debug.h>
 #include <audiolite/al_memalloc.h>
 
+#ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+#include <nuttx/arch.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -127,9 +131,13 @@ int audiolite_mem::unrefer()
 {
   int rcnt;
 
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+  rcnt = __atomic_sub_fetch(&this->refcnt, 1, __ATOMIC_ACQ_REL);
+#else
   mossfw_lock_take(&this->lock);
   rcnt = --this->refcnt;
   mossfw_lock_give(&this->lock);
+#endif
 
   return rcnt;
 }
@@ -178,9 +186,13 @@ void audiolite_mem::release(void)
 
 audiolite_mem *audiolite_mem::reference(void)
 {
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+  __atomic_add_fetch(&this->refcnt, 1, __ATOMIC_RELAXED);
+#else
   mossfw_lock_take(&this->lock);
   this->refcnt++;
   mossfw_lock_give(&this->lock);
+#endif
 
   return this;
 }
@@ -296,13 +308,153 @@ audiolite_memapbuf *audiolite_memapbuf::local_cast(dq_entry_t *ent)
  * Private Class audiolite_mempoolapbuf Methods
  ***********************************************/
 
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+uint16_t audiolite_mempoolapbuf::_pop_stack(void)
+{
+  uint32_t top = __atomic_load_n(&_free_top, __ATOMIC_ACQUIRE);
+  uint32_t next;
+  uint16_t blk;
+
+  do
+    {
+      blk = (uint16_t)(top & 0xffff);
+      if (blk == 0)
+        {
+          break;
+        }
+
+      /* The link may be stale if another thread popped blk meanwhile,
+       * the tag then differs and the CAS below fails.
+       */
+
+      next = ((top + 0x10000) & 0xffff0000) |
+             __atomic_load_n(&_free_next[blk - 1], __ATOMIC_RELAXED);
+    }
+  while (!__atomic_compare_exchange_n(&_free_top, &top, next, true,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+  return blk;
+}
+
+void audiolite_mempoolapbuf::_push_stack(uint16_t blk)
+{
+  uint32_t top = __atomic_load_n(&_free_top, __ATOMIC_RELAXED);
+  uint32_t next;
+
+  do
+    {
+      __atomic_store_n(&_free_next[blk - 1], (uint16_t)(top & 0xffff),
+                       __ATOMIC_RELAXED);
+      next = ((top + 0x10000) & 0xffff0000) | blk;
+    }
+  while (!__atomic_compare_exchange_n(&_free_top, &top, next, true,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+audiolite_memapbuf *audiolite_mempoolapbuf::_pop_freemem(void)
+{
+  uint16_t blk = 0;
+
+#ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+  uint16_t *cache = &_cpu_cache[up_cpu_index() * CONFIG_AL_MEMPOOL_CPU_CACHE];
+  int i;
+
+  for (i = 0; blk == 0 && i < CONFIG_AL_MEMPOOL_CPU_CACHE; i++)
+    {
+      if (__atomic_load_n(&cache[i], __ATOMIC_RELAXED) != 0)
+        {
+          blk = __atomic_exchange_n(&cache[i], 0, __ATOMIC_ACQUIRE);
+        }
+    }
+#endif
+
+  if (blk == 0)
+    {
+      blk = _pop_stack();
+    }
+
+#ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+  /* Blocks parked in caches of other CPUs are still free */
+
+  for (i = 0; blk == 0 && i < AL_MEMPOOL_CPU_CACHE_SLOTS; i++)
+    {
+      if (__atomic_load_n(&_cpu_cache[i], __ATOMIC_RELAXED) != 0)
+        {
+          blk = __atomic_exchange_n(&_cpu_cache[i], 0, __ATOMIC_ACQUIRE);
+        }
+    }
+#endif
+
+  return (blk != 0) ? &_insts[blk - 1] : NULL;
+}
+
+void audiolite_mempoolapbuf::_update_peak(int used)
+{
+  int peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+
+  while (peak < used &&
+         !__atomic_compare_exchange_n(&_peak, &peak, used, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+void audiolite_mempoolapbuf::_add_freemem(audiolite_memapbuf *mem)
+{
+  uint16_t blk = (uint16_t)(mem - _insts + 1);
+  bool parked = false;
+
+#ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+  uint16_t *cache = &_cpu_cache[up_cpu_index() * CONFIG_AL_MEMPOOL_CPU_CACHE];
+  int i;
+
+  for (i = 0; !parked && i < CONFIG_AL_MEMPOOL_CPU_CACHE; i++)
+    {
+      uint16_t empty = 0;
+      parked = __atomic_compare_exchange_n(&cache[i], &empty, blk, false,
+                                           __ATOMIC_RELEASE,
+                                           __ATOMIC_RELAXED);
+    }
+#endif
+
+  if (!parked)
+    {
+      _push_stack(blk);
+    }
+
+  __atomic_add_fetch(&_frees, 1, __ATOMIC_RELAXED);
+
+  if (__atomic_fetch_add(&_free_cnt, 1, __ATOMIC_SEQ_CST) == 0)
+    {
+      /* Free mem block is one after memfree() means
+       * the ZERO period is finished.
+       * So stop measure of zero period.
+       */
+
+      mossfw_lock_take(&_lock);
+      measure_stop();
+      mossfw_lock_give(&_lock);
+    }
+
+  /* Pair with allocate(): either a waiter sees the block, or this sees
+   * the waiter.
+   */
+
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&_waiters, __ATOMIC_RELAXED) > 0)
+    {
+      mossfw_lock_take(&_lock);
+      mossfw_condition_notice(&_cond);
+      mossfw_lock_give(&_lock);
+    }
+}
+#else
 void audiolite_mempoolapbuf::_add_freemem(audiolite_memapbuf *mem)
 {
   mossfw_lock_take(&_lock);
 
   dq_addlast(mem->get_link(), &_free_mem);
+  _frees++;
 
-  if (dq_count(&_free_mem) == 1)
+  if (++_free_cnt == 1)
     {
       /* Free mem block is one after memfree() means
        * the ZERO period is finished.
@@ -315,6 +467,7 @@ void audiolite_mempoolapbuf::_add_freemem(audiolite_memapbuf *mem)
   mossfw_condition_notice(&_cond);
   mossfw_lock_give(&_lock);
 }
+#endif
 
 bool audiolite_mempoolapbuf::_create_instance(int block_size, int block_num,
                       char *mem, int memsize)
@@ -327,6 +480,33 @@ bool audiolite_mempoolapbuf::_create_instance(int block_size, int block_num,
       _insts = NULL;
     }
 
+  dq_init(&_free_mem);
+  _free_cnt = 0;
+
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+  if (_free_next)
+    {
+      delete [] _free_next;
+      _free_next = NULL;
+    }
+
+  _free_top = 0;
+#  ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+  memset(_cpu_cache, 0, sizeof(_cpu_cache));
+#  endif
+
+  if (block_num > 0xffff)
+    {
+      return false;
+    }
+
+  _free_next = new uint16_t[block_num];
+  if (!_free_next)
+    {
+      return false;
+    }
+#endif
+
   block_size = ALIGNMENT(block_size);
   _insts = new audiolite_memapbuf[block_num];
   if (_insts)
@@ -339,6 +519,7 @@ bool audiolite_mempoolapbuf::_create_instance(int block_size, int block_num,
 
       _blknum = block_num;
       reflesh(_blknum);
+      reset_stats();
 
       return true;
     }
@@ -350,8 +531,16 @@ bool audiolite_mempoolapbuf::_create_instance(int block_size, int block_num,
  * Public Class audiolite_mempoolapbuf Methods
  ***********************************************/
 
-audiolite_mempoolapbuf::audiolite_mempoolapbuf(void) : _insts(NULL), _blknum(0), _ownmem(NULL), _pool_enable(true)
+audiolite_mempoolapbuf::audiolite_mempoolapbuf(void) : _insts(NULL), _blknum(0), _ownmem(NULL), _pool_enable(true),
+  _free_cnt(0), _peak(0), _allocs(0), _alloc_fails(0), _frees(0)
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+  , _free_next(NULL), _free_top(0), _waiters(0)
+#endif
 {
+#ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+  memset(_cpu_cache, 0, sizeof(_cpu_cache));
+#endif
+
   dq_init(&_free_mem);
   mossfw_lock_init(&_lock);
   mossfw_condition_init(&_cond);
@@ -364,6 +553,13 @@ audiolite_mempoolapbuf::~audiolite_mempoolapbuf(void)
       delete [] _insts;
     }
 
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+  if (_free_next)
+    {
+      delete [] _free_next;
+    }
+#endif
+
   if (_ownmem)
     {
       free(_ownmem);
@@ -413,6 +609,65 @@ bool audiolite_mempoolapbuf::create_instance(int block_size, int block_num,
   return false;
 }
 
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+audiolite_mem *audiolite_mempoolapbuf::allocate(bool blocking)
+{
+  int qsz;
+  audiolite_memapbuf *ret;
+
+  ret = _pop_freemem();
+  if (ret == NULL && blocking)
+    {
+      /* Only waiting for a free block takes the lock */
+
+      mossfw_lock_take(&_lock);
+      __atomic_add_fetch(&_waiters, 1, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+      ret = _pop_freemem();
+      while (_pool_enable && ret == NULL)
+        {
+          mossfw_condition_wait(&_cond, &_lock);
+          ret = _pop_freemem();
+        }
+
+      __atomic_sub_fetch(&_waiters, 1, __ATOMIC_RELAXED);
+      mossfw_lock_give(&_lock);
+    }
+
+  if (ret == NULL)
+    {
+      __atomic_add_fetch(&_alloc_fails, 1, __ATOMIC_RELAXED);
+      return NULL;
+    }
+
+  qsz = __atomic_fetch_sub(&_free_cnt, 1, __ATOMIC_SEQ_CST);
+  __atomic_add_fetch(&_allocs, 1, __ATOMIC_RELAXED);
+  _update_peak(_blknum - qsz + 1);
+
+  if (qsz == 1 || qsz < __atomic_load_n(&min_remain, __ATOMIC_RELAXED))
+    {
+      mossfw_lock_take(&_lock);
+      if (qsz == 1)
+        {
+          /* Remaining free memory block is 1.
+           * And called allocate(), so it will be ZERO.
+           * Start measure zero period then.
+           */
+
+          measure_start();
+        }
+
+      update_remain(qsz);
+      mossfw_lock_give(&_lock);
+    }
+
+  ret->reset_audiodata();
+  ret->reference();
+
+  return ret;
+}
+#else
 audiolite_mem *audiolite_mempoolapbuf::allocate(bool blocking)
 {
   int qsz;
@@ -421,7 +676,7 @@ audiolite_mem *audiolite_mempoolapbuf::allocate(bool blocking)
 
   mossfw_lock_take(&_lock);
 
-  qsz = dq_count(&_free_mem);
+  qsz = _free_cnt;
   if (qsz == 1)
     {
       /* Remaining free memory block is 1.
@@ -439,6 +694,20 @@ audiolite_mem *audiolite_mempoolapbuf::allocate(bool blocking)
       tmp = dq_remfirst(&_free_mem);
     }
 
+  if (tmp)
+    {
+      _free_cnt--;
+      _allocs++;
+      if (_peak < _blknum - _free_cnt)
+        {
+          _peak = _blknum - _free_cnt;
+        }
+    }
+  else
+    {
+      _alloc_fails++;
+    }
+
   update_remain(qsz);
   mossfw_lock_give(&_lock);
 
@@ -451,6 +720,7 @@ audiolite_mem *audiolite_mempoolapbuf::allocate(bool blocking)
 
   return ret;
 }
+#endif
 
 void audiolite_mempoolapbuf::memfree(audiolite_mem *mem)
 {
@@ -474,6 +744,50 @@ void audiolite_mempoolapbuf::enable_pool()
   mossfw_lock_give(&_lock);
 }
 
+void audiolite_mempoolapbuf::get_stats(
+                              struct audiolite_mempool_stats_s *stats)
+{
+  /* A snapshot, counters of the lock-free pool may be updated
+   * concurrently.
+   */
+
+  mossfw_lock_take(&_lock);
+  stats->blocks      = _blknum;
+  stats->used        = _blknum -
+                       __atomic_load_n(&_free_cnt, __ATOMIC_RELAXED);
+  stats->peak        = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+  stats->allocs      = __atomic_load_n(&_allocs, __ATOMIC_RELAXED);
+  stats->alloc_fails = __atomic_load_n(&_alloc_fails, __ATOMIC_RELAXED);
+  stats->frees       = __atomic_load_n(&_frees, __ATOMIC_RELAXED);
+  mossfw_lock_give(&_lock);
+
+  if (stats->used < 0)
+    {
+      stats->used = 0;
+    }
+  else if (stats->used > stats->blocks)
+    {
+      stats->used = stats->blocks;
+    }
+
+  if (stats->peak > stats->blocks)
+    {
+      stats->peak = stats->blocks;
+    }
+}
+
+void audiolite_mempoolapbuf::reset_stats(void)
+{
+  mossfw_lock_take(&_lock);
+  __atomic_store_n(&_peak,
+                   _blknum - __atomic_load_n(&_free_cnt, __ATOMIC_RELAXED),
+                   __ATOMIC_RELAXED);
+  __atomic_store_n(&_allocs, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&_alloc_fails, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&_frees, 0, __ATOMIC_RELAXED);
+  mossfw_lock_give(&_lock);
+}
+
 /****************************************************************************
  * class: audiolite_sysmsg
  ****************************************************************************/
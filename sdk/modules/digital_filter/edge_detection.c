@@ -41,145 +41,123 @@
 
 #include <stdlib.h>
 #include <errno.h>
-#include <arm_math.h>
 
 #include <digital_filter/edge_detection.h>
 
-#define SBIT(x) (1<<(x))
+/* The boundary is made of prev_width leading samples followed by
+ * width - prev_width samples of its last value. Window samples at the
+ * leading part should be on the other side of the boundary than the
+ * ones at the trailing part. As all trailing samples are compared with
+ * the same value, a run counter of the latest samples on the detected
+ * side replaces the comparison of the whole trailing part, and the
+ * leading part is only compared while the run is long enough.
+ *
+ * For a rising edge, the leading samples should be lower than the
+ * boundary and the trailing samples should be equal or higher than it.
+ * A falling edge is the opposite.
+ */
 
 /****************************************************************************
  * Private functions
  ****************************************************************************/
 
-static int check_the_edges(edge_detects_t *detector)
+static int edge_steps(edge_detects_t *detector, int16_t data)
 {
   uint32_t i;
-  uint32_t prevw = detector->prev_width;
   uint32_t width = detector->width;
-  int16_t *sub = detector->sub_buf;
-
-  if (detector->type == EDGE_DETECT_TYPE_RISE)
-    {
+  int rise = (detector->type == EDGE_DETECT_TYPE_RISE);
+  int16_t *bound = detector->boundary;
+  int16_t *hist = detector->history;
 
-      /* First data should be lower than lowvalue
-       * So the value sould be lower than 0.
-       */
+  /* Store the new sample over the oldest one */
 
-      for (i = 0; i < prevw; i++)
-        {
-          if (!(sub[i] & SBIT(15)))  /* is positive */
-            {
-              return 0;
-            }
-        }
-
-      /* Other data should be higher than highvalue
-       * So all substraction value is higher than 0.
-       */
+  hist[detector->pos] = data;
+  if (++detector->pos == width)
+    {
+      detector->pos = 0;
+    }
 
-      for (; i < width; i++)
+  if ((data < bound[width - 1]) != rise)
+    {
+      if (detector->run < width)
         {
-          if (sub[i] & SBIT(15)) /* is negative */
-            {
-              return 0;
-            }
+          detector->run++;
         }
     }
-  else /* Case of Falling type edge */
+  else
     {
-      /* First data should be higher than ops_device
-       * So the value sould be lower than 0.
-       */
+      detector->run = 0;
+    }
 
-      for (i = 0; i < prevw; i++)
-        {
-          if (sub[i] & SBIT(15)) /* is negative */
-            {
-              return 0;
-            }
-        }
+  if (detector->run < width - detector->prev_width)
+    {
+      return 0;
+    }
 
-      /* Other data should be higher than highvalue
-       * So all substraction value is higher than 0.
-       */
+  /* Now pos is the oldest sample of the window. Check the leading part
+   * from the sample next to the trailing part, which rejects most of
+   * the windows at once.
+   */
 
-      for (; i < width; i++)
+  for (i = detector->prev_width; i > 0; i--)
+    {
+      data = hist[(detector->pos + i - 1) % width];
+      if ((data < bound[i - 1]) != rise)
         {
-          if (!(sub[i] & SBIT(15))) /* is positive */
-            {
-              return 0;
-            }
+          return 0;
         }
     }
 
-  /* Detect the edge */
-
   return 1;
 }
 
-static int check_the_edgef(edge_detectf_t *detector)
+static int edge_stepf(edge_detectf_t *detector, float data)
 {
   uint32_t i;
-  uint32_t prevw = detector->prev_width;
   uint32_t width = detector->width;
-  int32_t *sub = (int32_t *)detector->sub_buf;
-
-  if (detector->type == EDGE_DETECT_TYPE_RISE)
-    {
-
-      /* First data should be lower than lowvalue
-       * So the value sould be lower than 0.
-       */
+  int rise = (detector->type == EDGE_DETECT_TYPE_RISE);
+  float *bound = detector->boundary;
+  float *hist = detector->history;
 
-      for (i = 0; i < prevw; i++)
-        {
-          if (!(sub[i] & SBIT(31))) /* is positive */
-            {
-              return 0;
-            }
-        }
+  /* Store the new sample over the oldest one */
 
-      /* Other data should be higher than highvalue
-       * So all substraction value is higher than 0.
-       */
+  hist[detector->pos] = data;
+  if (++detector->pos == width)
+    {
+      detector->pos = 0;
+    }
 
-      for (; i < width; i++)
+  if ((data < bound[width - 1]) != rise)
+    {
+      if (detector->run < width)
         {
-          if (sub[i] & SBIT(31))  /* is negative */
-            {
-              return 0;
-            }
+          detector->run++;
         }
     }
-  else /* Case of Falling type edge */
+  else
     {
-      /* First data should be higher than ops_device
-       * So the value sould be lower than 0.
-       */
+      detector->run = 0;
+    }
 
-      for (i = 0; i < prevw; i++)
-        {
-          if (sub[i] & SBIT(31))  /* is negative */
-            {
-              return 0;
-            }
-        }
+  if (detector->run < width - detector->prev_width)
+    {
+      return 0;
+    }
 
-      /* Other data should be higher than highvalue
-       * So all substraction value is higher than 0.
-       */
+  /* Now pos is the oldest sample of the window. Check the leading part
+   * from the sample next to the trailing part, which rejects most of
+   * the windows at once.
+   */
 
-      for (; i < width; i++)
+  for (i = detector->prev_width; i > 0; i--)
+    {
+      data = hist[(detector->pos + i - 1) % width];
+      if ((data < bound[i - 1]) != rise)
         {
-          if (!(sub[i] & SBIT(31)))  /* is positive */
-            {
-              return 0;
-            }
+          return 0;
         }
     }
 
-  /* Detect the edge */
-
   return 1;
 }
 
@@ -220,29 +198,9 @@ edge_detects_t *edge_detection_creates(int16_t *boundary_data,
       return NULL;
     }
 
-  if ((datalen + keep_width) > 1)
-    {
-      ret->remain_data = (int16_t *)malloc(
-          sizeof(int16_t) * (datalen + keep_width - 1));
-      if (ret->remain_data == NULL)
-        {
-          free(ret->boundary);
-          free(ret);
-          return NULL;
-        }
-    }
-  else
-    {
-      ret->remain_data = NULL;
-    }
-
-  ret->sub_buf = (int16_t *)malloc(sizeof(int16_t) * (datalen + keep_width));
-  if (ret->sub_buf == NULL)
+  ret->history = (int16_t *)malloc(sizeof(int16_t) * (datalen + keep_width));
+  if (ret->history == NULL)
     {
-      if (ret->remain_data)
-        {
-          free(ret->remain_data);
-        }
       free(ret->boundary);
       free(ret);
       return NULL;
@@ -263,15 +221,7 @@ edge_detects_t *edge_detection_creates(int16_t *boundary_data,
       ret->boundary[i + datalen] = boundary_data[datalen - 1];
     }
 
-  /* initialize remain data */
-
-  if (ret->remain_data != NULL)
-    {
-      for (i = 0; i < (ret->width - 1); i++)
-        {
-          ret->remain_data[i] = boundary_data[0];
-        }
-    }
+  edge_detection_resets(ret);
 
   return ret;
 }
@@ -286,13 +236,9 @@ void edge_detection_deletes(edge_detects_t *detector)
         {
           free(detector->boundary);
         }
-      if (detector->remain_data)
-        {
-          free(detector->remain_data);
-        }
-      if (detector->sub_buf)
+      if (detector->history)
         {
-          free(detector->sub_buf);
+          free(detector->history);
         }
       free(detector);
     }
@@ -303,20 +249,32 @@ void edge_detection_deletes(edge_detects_t *detector)
 int edge_detection_resets(edge_detects_t *detector)
 {
   int i;
+  int16_t init;
 
   if (detector == NULL)
     {
       return -1;
     }
 
-  /* initialize remain data */
+  /* Fill the window with the first boundary value as if it had been
+   * input for a while.
+   */
 
-  if (detector->remain_data != NULL)
+  init = detector->boundary[0];
+  for (i = 0; i < detector->width; i++)
     {
-      for (i = 0; i < (detector->width - 1); i++)
-        {
-          detector->remain_data[i] = detector->boundary[0];
-        }
+      detector->history[i] = init;
+    }
+
+  detector->pos = 0;
+  if ((init < detector->boundary[detector->width - 1])
+      != (detector->type == EDGE_DETECT_TYPE_RISE))
+    {
+      detector->run = detector->width - 1;
+    }
+  else
+    {
+      detector->run = 0;
     }
 
   return 0;
@@ -326,92 +284,46 @@ int edge_detection_resets(edge_detects_t *detector)
 
 int edge_detects(edge_detects_t *detector, int16_t *input, uint32_t len)
 {
-  int i;
-  int j;
-  int ret;
-  uint32_t width;
-  int16_t *bound;
-  int16_t *remain;
-  int16_t *sub;
+  uint32_t i;
 
-  if (detector == NULL || input == NULL || len < detector->width)
+  if (detector == NULL || input == NULL)
     {
       return -EINVAL;
     }
 
-  width = detector->width;
-  bound = detector->boundary;
-  remain = detector->remain_data;
-  sub = detector->sub_buf;
-
-  /* At first, find edge with remained data */
-
-  if (remain != NULL)
+  for (i = 0; i < len; i++)
     {
-      for (i = 0; i < (width - 1); i++)
+      if (edge_steps(detector, input[i]))
         {
-          arm_sub_q15(&remain[i], bound, sub, width - i - 1);
-          arm_sub_q15(input, &bound[width - i - 1], &sub[width - i - 1], i + 1);
-          if (check_the_edges(detector))
-            {
-              ret = i;
-
-              /* Update remain data for next scan. */
-
-              if (i < (width - 2))
-                {
-                  for (j = 0; j < (width - i - 2); j++)
-                    {
-                      remain[j] = remain[j + i + 1];
-                    }
-                  for (i = 0; j < width - 1; j++, i++)
-                    {
-                      remain[j] = input[i];
-                    }
-                }
-              else
-                {
-                  for (j = 0; j < (width - 1); j++)
-                    {
-                      remain[j] = input[j];
-                    }
-                }
-              return ret;
-            }
+          return i;
         }
     }
 
-  /* And now input data will be checked */
+  return -1;
+}
 
-  for (i = 0; i <= len - width; i++)
-    {
-      arm_sub_q15(&input[i], bound, sub, width + 1);
-      if (check_the_edges(detector))
-        {
-          ret = i + width - 1;
+/** edge_detect_alls() */
 
-          /* Update remain data for next scan. */
-          
-          i++;
+int edge_detect_alls(edge_detects_t *detector, int16_t *input, uint32_t len,
+    uint32_t *edges, int max_edges)
+{
+  uint32_t i;
+  int num = 0;
 
-          for (j = 0; j < (width - 1); j++)
-            {
-              remain[j] = input[i + j];
-            }
-          return ret;
-        }
+  if (detector == NULL || input == NULL || edges == NULL || max_edges < 1)
+    {
+      return -EINVAL;
     }
 
-  /* End of input data is not checked yet.
-   * so save it in remain buffer for checking with next data.
-   */
-
-  for (i = 0; i < (width - 1); i++)
+  for (i = 0; (i < len) && (num < max_edges); i++)
     {
-      remain[i] = input[len - width + 1 + i];
+      if (edge_steps(detector, input[i]))
+        {
+          edges[num++] = i;
+        }
     }
 
-  return -1;
+  return num;
 }
 
 /**
@@ -445,29 +357,9 @@ edge_detectf_t *edge_detection_createf(float *boundary_data,
       return NULL;
     }
 
-  if ((datalen + keep_width) > 1)
-    {
-      ret->remain_data = (float *)malloc(
-          sizeof(float) * (datalen + keep_width - 1));
-      if (ret->remain_data == NULL)
-        {
-          free(ret->boundary);
-          free(ret);
-          return NULL;
-        }
-    }
-  else
+  ret->history = (float *)malloc(sizeof(float) * (datalen + keep_width));
+  if (ret->history == NULL)
     {
-      ret->remain_data = NULL;
-    }
-
-  ret->sub_buf = (float *)malloc(sizeof(float) * (datalen + keep_width));
-  if (ret->sub_buf == NULL)
-    {
-      if (ret->remain_data)
-        {
-          free(ret->remain_data);
-        }
       free(ret->boundary);
       free(ret);
       return NULL;
@@ -488,15 +380,7 @@ edge_detectf_t *edge_detection_createf(float *boundary_data,
       ret->boundary[i + datalen] = boundary_data[datalen - 1];
     }
 
-  /* initialize remain data */
-
-  if (ret->remain_data != NULL)
-    {
-      for (i = 0; i < (ret->width - 1); i++)
-        {
-          ret->remain_data[i] = boundary_data[0];
-        }
-    }
+  edge_detection_resetf(ret);
 
   return ret;
 }
@@ -511,13 +395,9 @@ void edge_detection_deletef(edge_detectf_t *detector)
         {
           free(detector->boundary);
         }
-      if (detector->remain_data)
-        {
-          free(detector->remain_data);
-        }
-      if (detector->sub_buf)
+      if (detector->history)
         {
-          free(detector->sub_buf);
+          free(detector->history);
         }
       free(detector);
     }
@@ -528,20 +408,32 @@ void edge_detection_deletef(edge_detectf_t *detector)
 int edge_detection_resetf(edge_detectf_t *detector)
 {
   int i;
+  float init;
 
   if (detector == NULL)
     {
       return -1;
     }
 
-  /* initialize remain data */
+  /* Fill the window with the first boundary value as if it had been
+   * input for a while.
+   */
 
-  if (detector->remain_data != NULL)
+  init = detector->boundary[0];
+  for (i = 0; i < detector->width; i++)
     {
-      for (i = 0; i < (detector->width - 1); i++)
-        {
-          detector->remain_data[i] = detector->boundary[0];
-        }
+      detector->history[i] = init;
+    }
+
+  detector->pos = 0;
+  if ((init < detector->boundary[detector->width - 1])
+      != (detector->type == EDGE_DETECT_TYPE_RISE))
+    {
+      detector->run = detector->width - 1;
+    }
+  else
+    {
+      detector->run = 0;
     }
 
   return 0;
@@ -551,92 +443,46 @@ int edge_detection_resetf(edge_detectf_t *detector)
 
 int edge_detectf(edge_detectf_t *detector, float *input, uint32_t len)
 {
-  int i;
-  int j;
-  int ret;
-  uint32_t width;
-  float *bound;
-  float *remain;
-  float *sub;
+  uint32_t i;
 
-  if (detector == NULL || input == NULL || len < detector->width)
+  if (detector == NULL || input == NULL)
     {
       return -EINVAL;
     }
 
-  width = detector->width;
-  bound = detector->boundary;
-  remain = detector->remain_data;
-  sub = detector->sub_buf;
-
-  /* At first, find edge with remained data */
-
-  if (remain != NULL)
+  for (i = 0; i < len; i++)
     {
-      for (i = 0; i < (width - 1); i++)
+      if (edge_stepf(detector, input[i]))
         {
-          arm_sub_f32(&remain[i], bound, sub, width - i - 1);
-          arm_sub_f32(input, &bound[width - i - 1], &sub[width - i - 1], i + 1);
-          if (check_the_edgef(detector))
-            {
-              ret = i;
-
-              /* Update remain data for next scan. */
-
-              if (i < (width - 2))
-                {
-                  for (j = 0; j < (width - i - 2); j++)
-                    {
-                      remain[j] = remain[j + i + 1];
-                    }
-                  for (i = 0; j < width - 1; j++, i++)
-                    {
-                      remain[j] = input[i];
-                    }
-                }
-              else
-                {
-                  for (j = 0; j < (width - 1); j++)
-                    {
-                      remain[j] = input[j];
-                    }
-                }
-              return ret;
-            }
+          return i;
         }
     }
 
-  /* And now input data will be checked */
-
-  for (i = 0; i <= len - width; i++)
-    {
-      arm_sub_f32(&input[i], bound, sub, width + 1);
-      if (check_the_edgef(detector))
-        {
-          ret = i + width - 1;
+  return -1;
+}
 
-          /* Update remain data for next scan. */
+/** edge_detect_allf() */
 
-          i++;
+int edge_detect_allf(edge_detectf_t *detector, float *input, uint32_t len,
+    uint32_t *edges, int max_edges)
+{
+  uint32_t i;
+  int num = 0;
 
-          for (j = 0; j < (width - 1); j++)
-            {
-              remain[j] = input[i + j];
-            }
-          return ret;
-        }
+  if (detector == NULL || input == NULL || edges == NULL || max_edges < 1)
+    {
+      return -EINVAL;
     }
 
-  /* End of input data is not checked yet.
-   * so save it in remain buffer for checking with next data.
-   */
-
-  for (i = 0; i < (width - 1); i++)
+  for (i = 0; (i < len) && (num < max_edges); i++)
     {
-      remain[i] = input[len - width + 1 + i];
+      if (edge_stepf(detector, input[i]))
+        {
+          edges[num++] = i;
+        }
     }
 
-  return -1;
+  return num;
 }
 
 #endif  /* CONFIG_DIGITAL_FILTER_EDGE_DETECT */
@@ -47,11 +47,13 @@
 #include <digital_filter/fir_filter.h>
 #include <digital_filter/fir_decimator.h>
 
+#include "fir_design.h"
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static int tap_number(int fs, int tr_width)
+int fir_tap_number(int fs, int tr_width)
 {
   int taps;
 
@@ -129,7 +131,7 @@ static decimator_instancef_t * prepare_decimator(int dec_factor, int taps,
   return S;
 }
 
-static float * fir_coeffs_lpf(float fe, int taps)
+float * fir_coeffs_lpf(float fe, int taps)
 {
   int i;
   int half = (taps - 1) / 2;
@@ -219,6 +221,222 @@ static float * fir_coeffs_bef(float fe1, float fe2, int taps)
   return coeffs;
 }
 
+/* Fixed point coefficients are scaled down by 2^shift when the float
+ * design does not fit, and the outputs are shifted back up with
+ * saturation by the execute functions.
+ *
+ * q15: arm_fir_q15() accumulates in 64 bits and never overflows, so the
+ *      coefficients only have to be representable, max|h| < 1.
+ * q31: arm_fir_q31() and arm_fir_decimate_q31() cast the sum to 1.31
+ *      without saturation, so it wraps as soon as it reaches 1. Bounding
+ *      sum|h| below 1 keeps it safe for any input.
+ */
+
+static uint8_t coeffs_shift(const float *coeffs, int taps, int q31)
+{
+  float bound = 0.f;
+  uint8_t shift = 0;
+  int i;
+
+  for (i = 0; i < taps; i++)
+    {
+      if (q31)
+        {
+          bound += fabsf(coeffs[i]);
+        }
+      else if (fabsf(coeffs[i]) > bound)
+        {
+          bound = fabsf(coeffs[i]);
+        }
+    }
+
+  while (bound >= 1.f)
+    {
+      bound *= 0.5f;
+      shift++;
+    }
+
+  return shift;
+}
+
+static void quantize_q15(const float *coeffs, int taps, uint8_t shift,
+                         q15_t *qcoeffs)
+{
+  float scale = 32768.f / (float)(1 << shift);
+  float v;
+  int i;
+
+  for (i = 0; i < taps; i++)
+    {
+      v = roundf(coeffs[i] * scale);
+      qcoeffs[i] = (v >= 32767.f) ? 32767 :
+                   (v <= -32768.f) ? -32768 : (q15_t)v;
+    }
+}
+
+static void quantize_q31(const float *coeffs, int taps, uint8_t shift,
+                         q31_t *qcoeffs)
+{
+  double scale = 2147483648.0 / (double)(1 << shift);
+  double v;
+  int i;
+
+  for (i = 0; i < taps; i++)
+    {
+      v = round((double)coeffs[i] * scale);
+      qcoeffs[i] = (v >= 2147483647.0) ? 0x7fffffff :
+                   (v <= -2147483648.0) ? (q31_t)0x80000000 : (q31_t)v;
+    }
+}
+
+/* The prepare functions below take over coeffs and free it */
+
+static fir_instanceq15_t * prepare_fir_q15(int taps, float *coeffs,
+                                           int blocksz)
+{
+  fir_instanceq15_t *S;
+  q15_t *qcoeffs;
+  q15_t *state;
+  int qtaps;
+
+  if (coeffs == NULL)
+    {
+      return NULL;
+    }
+
+  /* arm_fir_q15() needs an even number of taps. The extra coefficient
+   * is put on the oldest sample so the group delay stays the same as the
+   * float filter.
+   */
+
+  qtaps = taps + (taps & 0x01);
+  if (qtaps < 4)
+    {
+      qtaps = 4;
+    }
+
+  S = (fir_instanceq15_t *)malloc(sizeof(fir_instanceq15_t));
+  qcoeffs = (q15_t *)calloc(qtaps, sizeof(q15_t));
+  state = (q15_t *)malloc(sizeof(q15_t) * (qtaps + blocksz));
+  if (S == NULL || qcoeffs == NULL || state == NULL)
+    {
+      free(S);
+      free(qcoeffs);
+      free(state);
+      free(coeffs);
+      return NULL;
+    }
+
+  S->shift = coeffs_shift(coeffs, taps, 0);
+  quantize_q15(coeffs, taps, S->shift, qcoeffs + qtaps - taps);
+  free(coeffs);
+
+  arm_fir_init_q15(&S->inst, qtaps, qcoeffs, state, blocksz);
+
+  return S;
+}
+
+static fir_instanceq31_t * prepare_fir_q31(int taps, float *coeffs,
+                                           int blocksz)
+{
+  fir_instanceq31_t *S;
+  q31_t *qcoeffs;
+  q31_t *state;
+
+  if (coeffs == NULL)
+    {
+      return NULL;
+    }
+
+  S = (fir_instanceq31_t *)malloc(sizeof(fir_instanceq31_t));
+  qcoeffs = (q31_t *)malloc(sizeof(q31_t) * taps);
+  state = (q31_t *)malloc(sizeof(q31_t) * (taps + blocksz - 1));
+  if (S == NULL || qcoeffs == NULL || state == NULL)
+    {
+      free(S);
+      free(qcoeffs);
+      free(state);
+      free(coeffs);
+      return NULL;
+    }
+
+  S->shift = coeffs_shift(coeffs, taps, 1);
+  quantize_q31(coeffs, taps, S->shift, qcoeffs);
+  free(coeffs);
+
+  arm_fir_init_q31(&S->inst, taps, qcoeffs, state, blocksz);
+
+  return S;
+}
+
+static decimator_instanceq15_t * prepare_decimator_q15(int dec_factor,
+    int taps, float *coeffs, int blocksz)
+{
+  decimator_instanceq15_t *S;
+  q15_t *qcoeffs;
+  q15_t *state;
+
+  if (coeffs == NULL)
+    {
+      return NULL;
+    }
+
+  S = (decimator_instanceq15_t *)malloc(sizeof(decimator_instanceq15_t));
+  qcoeffs = (q15_t *)malloc(sizeof(q15_t) * taps);
+  state = (q15_t *)malloc(sizeof(q15_t) * (taps + blocksz - 1));
+  if (S == NULL || qcoeffs == NULL || state == NULL)
+    {
+      free(S);
+      free(qcoeffs);
+      free(state);
+      free(coeffs);
+      return NULL;
+    }
+
+  S->shift = coeffs_shift(coeffs, taps, 0);
+  quantize_q15(coeffs, taps, S->shift, qcoeffs);
+  free(coeffs);
+
+  arm_fir_decimate_init_q15(&S->inst, taps, dec_factor, qcoeffs, state,
+                            blocksz);
+
+  return S;
+}
+
+static decimator_instanceq31_t * prepare_decimator_q31(int dec_factor,
+    int taps, float *coeffs, int blocksz)
+{
+  decimator_instanceq31_t *S;
+  q31_t *qcoeffs;
+  q31_t *state;
+
+  if (coeffs == NULL)
+    {
+      return NULL;
+    }
+
+  S = (decimator_instanceq31_t *)malloc(sizeof(decimator_instanceq31_t));
+  qcoeffs = (q31_t *)malloc(sizeof(q31_t) * taps);
+  state = (q31_t *)malloc(sizeof(q31_t) * (taps + blocksz - 1));
+  if (S == NULL || qcoeffs == NULL || state == NULL)
+    {
+      free(S);
+      free(qcoeffs);
+      free(state);
+      free(coeffs);
+      return NULL;
+    }
+
+  S->shift = coeffs_shift(coeffs, taps, 1);
+  quantize_q31(coeffs, taps, S->shift, qcoeffs);
+  free(coeffs);
+
+  arm_fir_decimate_init_q31(&S->inst, taps, dec_factor, qcoeffs, state,
+                            blocksz);
+
+  return S;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -240,7 +458,7 @@ fir_instancef_t * fir_create_lpff(int fs, int cutoff_freq, int tr_width,
     }
 
   return fir_create_lpff_tap(fs, cutoff_freq,
-                             tap_number(fs, tr_width), blocksz);
+                             fir_tap_number(fs, tr_width), blocksz);
 }
 
 /** fir_create_lpff_tap() */
@@ -284,7 +502,7 @@ fir_instancef_t * fir_create_hpff(int fs, int cutoff_freq, int tr_width,
     }
 
   return fir_create_hpff_tap(fs, cutoff_freq,
-                             tap_number(fs, tr_width), blocksz);
+                             fir_tap_number(fs, tr_width), blocksz);
 }
 
 /** fir_create_hpff_tap() */
@@ -328,7 +546,7 @@ fir_instancef_t * fir_create_bpff(int fs, int lower_cutfreq,
     }
 
   return fir_create_bpff_tap(fs, lower_cutfreq, higher_cutfreq,
-                             tap_number(fs, tr_width), blocksz);
+                             fir_tap_number(fs, tr_width), blocksz);
 }
 
 /** fir_create_bpff_tap() */
@@ -373,7 +591,7 @@ fir_instancef_t * fir_create_beff(int fs, int lower_cutfreq,
     }
 
   return fir_create_beff_tap(fs, lower_cutfreq, higher_cutfreq,
-                             tap_number(fs, tr_width), blocksz);
+                             fir_tap_number(fs, tr_width), blocksz);
 }
 
 /** fir_create_beff_tap() */
@@ -433,7 +651,7 @@ void firabs_executef(fir_instancef_t *fir, float *input, float *output, int len)
 
 int fir_calc_tapnumber(int fs, int tr_width)
 {
-  return tap_number(fs, tr_width);
+  return fir_tap_number(fs, tr_width);
 }
 
 /** fir_delete() */
@@ -448,109 +666,668 @@ void fir_deletef(fir_instancef_t *fir)
     }
 }
 
-#endif  /* CONFIG_DIGITAL_FILTER_FIR */
+/** fir_create_lpfq15() */
 
-/****************************************************************************
- * Decimation Filter
- ****************************************************************************/
+fir_instanceq15_t * fir_create_lpfq15(int fs, int cutoff_freq, int tr_width,
+    int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
 
-#ifdef CONFIG_DIGITAL_FILTER_DECIMATOR
+  return fir_create_lpfq15_tap(fs, cutoff_freq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
 
-/** create_decimatorf() */
+/** fir_create_lpfq15_tap() */
 
-decimator_instancef_t *create_decimatorf(int fs, int dec_factor,
-    int tr_width, int blocksz)
+fir_instanceq15_t * fir_create_lpfq15_tap(int fs, int cutoff_freq, int taps,
+    int blocksz)
 {
-  decimator_instancef_t *S;
+  float *coeffs;
 
-  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
     {
       return NULL;
     }
 
-  S = create_decimatorf_tap(fs, dec_factor, tap_number(fs, tr_width), blocksz);
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_lpf((float)cutoff_freq / (float)fs, taps);
 
-  return S;
+  return prepare_fir_q15(taps, coeffs, blocksz);
 }
 
-/** create_decimatorf_tap() */
+/** fir_create_hpfq15() */
 
-decimator_instancef_t *create_decimatorf_tap(int fs, int dec_factor,
-    int taps, int blocksz)
+fir_instanceq15_t * fir_create_hpfq15(int fs, int cutoff_freq, int tr_width,
+    int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return fir_create_hpfq15_tap(fs, cutoff_freq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_hpfq15_tap() */
+
+fir_instanceq15_t * fir_create_hpfq15_tap(int fs, int cutoff_freq, int taps,
+    int blocksz)
 {
-  decimator_instancef_t *S;
   float *coeffs;
 
-  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
     {
       return NULL;
     }
 
-  if (taps > 0)
-    {
-      taps = (taps & 0x01) ? taps : taps + 1;
+  taps = (taps & 0x01) ? taps : taps + 1;
 
-      coeffs = fir_coeffs_lpf(1.f / (float)(2 * dec_factor), taps);
-      if (coeffs == NULL)
-        {
-          return NULL;
-        }
+  coeffs = fir_coeffs_hpf((float)cutoff_freq / (float)fs, taps);
 
-      S = prepare_decimator(dec_factor, taps, coeffs, blocksz);
-    }
-  else
+  return prepare_fir_q15(taps, coeffs, blocksz);
+}
+
+/** fir_create_bpfq15() */
+
+fir_instanceq15_t * fir_create_bpfq15(int fs, int lower_cutfreq,
+    int higher_cutfreq, int tr_width, int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
     {
-      S = (decimator_instancef_t *)malloc(sizeof(decimator_instancef_t));
-      if (S)
-        {
-          S->inst.numTaps = 0;
-          S->inst.M = dec_factor;
-        }
+      return NULL;
     }
 
-  return S;
+  return fir_create_bpfq15_tap(fs, lower_cutfreq, higher_cutfreq,
+                               fir_tap_number(fs, tr_width), blocksz);
 }
 
-/** decimator_execute() */
+/** fir_create_bpfq15_tap() */
 
-int decimator_executef(decimator_instancef_t *dec, float *input, int input_len,
-    float *output, int output_len)
+fir_instanceq15_t * fir_create_bpfq15_tap(int fs, int lower_cutfreq,
+    int higher_cutfreq, int taps, int blocksz)
 {
-  int i;
-  int output_sz = input_len / dec->inst.M;
+  float *coeffs;
 
-  if (output_len < output_sz)
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
     {
-      return -1;
+      return NULL;
     }
 
-  if (dec->inst.numTaps)
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_bpf((float)lower_cutfreq / (float)fs,
+                          (float)higher_cutfreq / (float)fs, taps);
+
+  return prepare_fir_q15(taps, coeffs, blocksz);
+}
+
+/** fir_create_befq15() */
+
+fir_instanceq15_t * fir_create_befq15(int fs, int lower_cutfreq,
+    int higher_cutfreq, int tr_width, int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
     {
-      arm_fir_decimate_f32(&dec->inst, input, output, input_len);
+      return NULL;
     }
-  else
+
+  return fir_create_befq15_tap(fs, lower_cutfreq, higher_cutfreq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_befq15_tap() */
+
+fir_instanceq15_t * fir_create_befq15_tap(int fs, int lower_cutfreq,
+    int higher_cutfreq, int taps, int blocksz)
+{
+  float *coeffs;
+
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
     {
-      /* Do without filter */
+      return NULL;
+    }
 
-      for (i = 0; i < output_sz; i++)
-        {
-          output[i] = input[i * dec->inst.M];
-        }
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_bef((float)lower_cutfreq / (float)fs,
+                          (float)higher_cutfreq / (float)fs, taps);
+
+  return prepare_fir_q15(taps, coeffs, blocksz);
+}
+
+/** fir_get_tapnumq15() */
+
+int fir_get_tapnumq15(fir_instanceq15_t *fir)
+{
+  return fir->inst.numTaps;
+}
+
+/** fir_executeq15() */
+
+void fir_executeq15(fir_instanceq15_t *fir, q15_t *input, q15_t *output,
+    int len)
+{
+  arm_fir_q15(&fir->inst, input, output, len);
+  if (fir->shift)
+    {
+      arm_shift_q15(output, fir->shift, output, len);
     }
+}
 
-  return output_sz;
+/** firabs_executeq15() */
+
+void firabs_executeq15(fir_instanceq15_t *fir, q15_t *input, q15_t *output,
+    int len)
+{
+  fir_executeq15(fir, input, output, len);
+  arm_abs_q15(output, output, len);
 }
 
-/** decimator_tapnumf() */
+/** fir_deleteq15() */
 
-int decimator_tapnumf(decimator_instancef_t *dec)
+void fir_deleteq15(fir_instanceq15_t *fir)
 {
-  return dec->inst.numTaps;
+  if (fir)
+    {
+      free(fir->inst.pState);
+      free((void *)fir->inst.pCoeffs);
+      free(fir);
+    }
 }
 
-/** decimator_deletef() */
+/** fir_create_lpfq31() */
 
-void decimator_deletef(decimator_instancef_t *dec)
+fir_instanceq31_t * fir_create_lpfq31(int fs, int cutoff_freq, int tr_width,
+    int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return fir_create_lpfq31_tap(fs, cutoff_freq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_lpfq31_tap() */
+
+fir_instanceq31_t * fir_create_lpfq31_tap(int fs, int cutoff_freq, int taps,
+    int blocksz)
+{
+  float *coeffs;
+
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_lpf((float)cutoff_freq / (float)fs, taps);
+
+  return prepare_fir_q31(taps, coeffs, blocksz);
+}
+
+/** fir_create_hpfq31() */
+
+fir_instanceq31_t * fir_create_hpfq31(int fs, int cutoff_freq, int tr_width,
+    int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return fir_create_hpfq31_tap(fs, cutoff_freq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_hpfq31_tap() */
+
+fir_instanceq31_t * fir_create_hpfq31_tap(int fs, int cutoff_freq, int taps,
+    int blocksz)
+{
+  float *coeffs;
+
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_hpf((float)cutoff_freq / (float)fs, taps);
+
+  return prepare_fir_q31(taps, coeffs, blocksz);
+}
+
+/** fir_create_bpfq31() */
+
+fir_instanceq31_t * fir_create_bpfq31(int fs, int lower_cutfreq,
+    int higher_cutfreq, int tr_width, int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return fir_create_bpfq31_tap(fs, lower_cutfreq, higher_cutfreq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_bpfq31_tap() */
+
+fir_instanceq31_t * fir_create_bpfq31_tap(int fs, int lower_cutfreq,
+    int higher_cutfreq, int taps, int blocksz)
+{
+  float *coeffs;
+
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_bpf((float)lower_cutfreq / (float)fs,
+                          (float)higher_cutfreq / (float)fs, taps);
+
+  return prepare_fir_q31(taps, coeffs, blocksz);
+}
+
+/** fir_create_befq31() */
+
+fir_instanceq31_t * fir_create_befq31(int fs, int lower_cutfreq,
+    int higher_cutfreq, int tr_width, int blocksz)
+{
+  if ((tr_width <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return fir_create_befq31_tap(fs, lower_cutfreq, higher_cutfreq,
+                               fir_tap_number(fs, tr_width), blocksz);
+}
+
+/** fir_create_befq31_tap() */
+
+fir_instanceq31_t * fir_create_befq31_tap(int fs, int lower_cutfreq,
+    int higher_cutfreq, int taps, int blocksz)
+{
+  float *coeffs;
+
+  if ((taps <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  taps = (taps & 0x01) ? taps : taps + 1;
+
+  coeffs = fir_coeffs_bef((float)lower_cutfreq / (float)fs,
+                          (float)higher_cutfreq / (float)fs, taps);
+
+  return prepare_fir_q31(taps, coeffs, blocksz);
+}
+
+/** fir_get_tapnumq31() */
+
+int fir_get_tapnumq31(fir_instanceq31_t *fir)
+{
+  return fir->inst.numTaps;
+}
+
+/** fir_executeq31() */
+
+void fir_executeq31(fir_instanceq31_t *fir, q31_t *input, q31_t *output,
+    int len)
+{
+  arm_fir_q31(&fir->inst, input, output, len);
+  if (fir->shift)
+    {
+      arm_shift_q31(output, fir->shift, output, len);
+    }
+}
+
+/** firabs_executeq31() */
+
+void firabs_executeq31(fir_instanceq31_t *fir, q31_t *input, q31_t *output,
+    int len)
+{
+  fir_executeq31(fir, input, output, len);
+  arm_abs_q31(output, output, len);
+}
+
+/** fir_deleteq31() */
+
+void fir_deleteq31(fir_instanceq31_t *fir)
+{
+  if (fir)
+    {
+      free(fir->inst.pState);
+      free((void *)fir->inst.pCoeffs);
+      free(fir);
+    }
+}
+
+#endif  /* CONFIG_DIGITAL_FILTER_FIR */
+
+/****************************************************************************
+ * Decimation Filter
+ ****************************************************************************/
+
+#ifdef CONFIG_DIGITAL_FILTER_DECIMATOR
+
+/** create_decimatorf() */
+
+decimator_instancef_t *create_decimatorf(int fs, int dec_factor,
+    int tr_width, int blocksz)
+{
+  decimator_instancef_t *S;
+
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  S = create_decimatorf_tap(fs, dec_factor, fir_tap_number(fs, tr_width),
+                            blocksz);
+
+  return S;
+}
+
+/** create_decimatorf_tap() */
+
+decimator_instancef_t *create_decimatorf_tap(int fs, int dec_factor,
+    int taps, int blocksz)
+{
+  decimator_instancef_t *S;
+  float *coeffs;
+
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  if (taps > 0)
+    {
+      taps = (taps & 0x01) ? taps : taps + 1;
+
+      coeffs = fir_coeffs_lpf(1.f / (float)(2 * dec_factor), taps);
+      if (coeffs == NULL)
+        {
+          return NULL;
+        }
+
+      S = prepare_decimator(dec_factor, taps, coeffs, blocksz);
+    }
+  else
+    {
+      S = (decimator_instancef_t *)malloc(sizeof(decimator_instancef_t));
+      if (S)
+        {
+          S->inst.numTaps = 0;
+          S->inst.M = dec_factor;
+        }
+    }
+
+  return S;
+}
+
+/** decimator_execute() */
+
+int decimator_executef(decimator_instancef_t *dec, float *input, int input_len,
+    float *output, int output_len)
+{
+  int i;
+  int output_sz = input_len / dec->inst.M;
+
+  if (output_len < output_sz)
+    {
+      return -1;
+    }
+
+  if (dec->inst.numTaps)
+    {
+      arm_fir_decimate_f32(&dec->inst, input, output, input_len);
+    }
+  else
+    {
+      /* Do without filter */
+
+      for (i = 0; i < output_sz; i++)
+        {
+          output[i] = input[i * dec->inst.M];
+        }
+    }
+
+  return output_sz;
+}
+
+/** decimator_tapnumf() */
+
+int decimator_tapnumf(decimator_instancef_t *dec)
+{
+  return dec->inst.numTaps;
+}
+
+/** decimator_deletef() */
+
+void decimator_deletef(decimator_instancef_t *dec)
+{
+  if (dec)
+    {
+      if (dec->inst.numTaps)
+        {
+          free(dec->inst.pState);
+          free((void *)dec->inst.pCoeffs);
+        }
+
+      free(dec);
+    }
+}
+
+/** create_decimatorq15() */
+
+decimator_instanceq15_t *create_decimatorq15(int fs, int dec_factor,
+    int tr_width, int blocksz)
+{
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return create_decimatorq15_tap(fs, dec_factor, fir_tap_number(fs, tr_width),
+                                 blocksz);
+}
+
+/** create_decimatorq15_tap() */
+
+decimator_instanceq15_t *create_decimatorq15_tap(int fs, int dec_factor,
+    int taps, int blocksz)
+{
+  decimator_instanceq15_t *S;
+  float *coeffs;
+
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  if (taps > 0)
+    {
+      taps = (taps & 0x01) ? taps : taps + 1;
+
+      coeffs = fir_coeffs_lpf(1.f / (float)(2 * dec_factor), taps);
+      S = prepare_decimator_q15(dec_factor, taps, coeffs, blocksz);
+    }
+  else
+    {
+      S = (decimator_instanceq15_t *)malloc(sizeof(decimator_instanceq15_t));
+      if (S)
+        {
+          S->inst.numTaps = 0;
+          S->inst.M = dec_factor;
+          S->shift = 0;
+        }
+    }
+
+  return S;
+}
+
+/** decimator_executeq15() */
+
+int decimator_executeq15(decimator_instanceq15_t *dec, q15_t *input,
+    int input_len, q15_t *output, int output_len)
+{
+  int i;
+  int output_sz = input_len / dec->inst.M;
+
+  if (output_len < output_sz)
+    {
+      return -1;
+    }
+
+  if (dec->inst.numTaps)
+    {
+      arm_fir_decimate_q15(&dec->inst, input, output, input_len);
+      if (dec->shift)
+        {
+          arm_shift_q15(output, dec->shift, output, output_sz);
+        }
+    }
+  else
+    {
+      /* Do without filter */
+
+      for (i = 0; i < output_sz; i++)
+        {
+          output[i] = input[i * dec->inst.M];
+        }
+    }
+
+  return output_sz;
+}
+
+/** decimator_tapnumq15() */
+
+int decimator_tapnumq15(decimator_instanceq15_t *dec)
+{
+  return dec->inst.numTaps;
+}
+
+/** decimator_deleteq15() */
+
+void decimator_deleteq15(decimator_instanceq15_t *dec)
+{
+  if (dec)
+    {
+      if (dec->inst.numTaps)
+        {
+          free(dec->inst.pState);
+          free((void *)dec->inst.pCoeffs);
+        }
+
+      free(dec);
+    }
+}
+
+/** create_decimatorq31() */
+
+decimator_instanceq31_t *create_decimatorq31(int fs, int dec_factor,
+    int tr_width, int blocksz)
+{
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  return create_decimatorq31_tap(fs, dec_factor, fir_tap_number(fs, tr_width),
+                                 blocksz);
+}
+
+/** create_decimatorq31_tap() */
+
+decimator_instanceq31_t *create_decimatorq31_tap(int fs, int dec_factor,
+    int taps, int blocksz)
+{
+  decimator_instanceq31_t *S;
+  float *coeffs;
+
+  if ((dec_factor <= 0) || (fs <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  if (taps > 0)
+    {
+      taps = (taps & 0x01) ? taps : taps + 1;
+
+      coeffs = fir_coeffs_lpf(1.f / (float)(2 * dec_factor), taps);
+      S = prepare_decimator_q31(dec_factor, taps, coeffs, blocksz);
+    }
+  else
+    {
+      S = (decimator_instanceq31_t *)malloc(sizeof(decimator_instanceq31_t));
+      if (S)
+        {
+          S->inst.numTaps = 0;
+          S->inst.M = dec_factor;
+          S->shift = 0;
+        }
+    }
+
+  return S;
+}
+
+/** decimator_executeq31() */
+
+int decimator_executeq31(decimator_instanceq31_t *dec, q31_t *input,
+    int input_len, q31_t *output, int output_len)
+{
+  int i;
+  int output_sz = input_len / dec->inst.M;
+
+  if (output_len < output_sz)
+    {
+      return -1;
+    }
+
+  if (dec->inst.numTaps)
+    {
+      arm_fir_decimate_q31(&dec->inst, input, output, input_len);
+      if (dec->shift)
+        {
+          arm_shift_q31(output, dec->shift, output, output_sz);
+        }
+    }
+  else
+    {
+      /* Do without filter */
+
+      for (i = 0; i < output_sz; i++)
+        {
+          output[i] = input[i * dec->inst.M];
+        }
+    }
+
+  return output_sz;
+}
+
+/** decimator_tapnumq31() */
+
+int decimator_tapnumq31(decimator_instanceq31_t *dec)
+{
+  return dec->inst.numTaps;
+}
+
+/** decimator_deleteq31() */
+
+void decimator_deleteq31(decimator_instanceq31_t *dec)
 {
   if (dec)
     {
@@ -0,0 +1,713 @@
+/****************************************************************************
+ * modules/digital_filter/host/fir_accuracy.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of the q15 and q31 FIR filters and decimators.
+ *
+ * Filters of every type are made with random sampling rates, cut off
+ * frequencies, transition widths and block sizes, in float, q15 and q31,
+ * and checked for:
+ *
+ *   design : the tap number, each quantized coefficient within half a
+ *            step of the float design, and the smallest shift which
+ *            keeps the CMSIS kernel from overflowing
+ *   kernel : the outputs against an integer model of the quantized
+ *            filter, with random call lengths. The last part of the
+ *            input has the sign pattern of the coefficients at full
+ *            scale, the worst case which must saturate and not wrap.
+ *   float  : the RMS error of the outputs against the float filter,
+ *            over the part of the input which does not saturate
+ *
+ * The decimators are checked the same way. The source is included so
+ * that its allocations are counted, the delete functions must free all
+ * of them.
+ *
+ *   fir_accuracy [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static long g_allocs;
+
+static void *counted_malloc(size_t size)
+{
+  void *p = malloc(size);
+
+  g_allocs += (p != NULL);
+  return p;
+}
+
+static void *counted_calloc(size_t n, size_t size)
+{
+  void *p = calloc(n, size);
+
+  g_allocs += (p != NULL);
+  return p;
+}
+
+static void counted_free(void *p)
+{
+  g_allocs -= (p != NULL);
+  free(p);
+}
+
+#define malloc(s)    counted_malloc(s)
+#define calloc(n, s) counted_calloc(n, s)
+#define free(p)      counted_free(p)
+
+#include "../fir_base_filters.c"
+
+#undef malloc
+#undef calloc
+#undef free
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SIGNAL_LEN  3072      /* Samples of test signal */
+#define WORST_LEN   1024      /* Samples of full scale worst case */
+#define INPUT_LEN   (SIGNAL_LEN + WORST_LEN)
+#define WORST_SEG   (WORST_LEN / 2)
+#define MAX_TAPS    (WORST_SEG - 16)
+
+/* Maximum RMS error against the float filter [dBFS]. q15 is limited by
+ * its coefficients on long filters, q31 by the float filter itself.
+ */
+
+#define MAX_ERR_Q15 -80.0
+#define MAX_ERR_Q31 -140.0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum type_e
+{
+  TYPE_LPF = 0,
+  TYPE_HPF,
+  TYPE_BPF,
+  TYPE_BEF,
+  TYPE_DEC,
+  TYPE_NUM
+};
+
+struct filter_s
+{
+  enum type_e type;
+  int fs;
+  int f1;
+  int f2;
+  int tr_width;
+  int taps;             /* Use the _tap create functions if not 0 */
+  int dec;
+  int blocksz;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_type_name[TYPE_NUM] =
+{
+  "lpf", "hpf", "bpf", "bef", "decimator"
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+static unsigned long g_cases;
+static double g_worst_err[TYPE_NUM][2];
+
+static float g_inf[INPUT_LEN];
+static float g_outf[INPUT_LEN];
+static q15_t g_in15[INPUT_LEN];
+static q15_t g_out15[INPUT_LEN];
+static q31_t g_in31[INPUT_LEN];
+static q31_t g_out31[INPUT_LEN];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static double frnd(void)
+{
+  return (double)(rnd() & 0xffff) / 65536.0;
+}
+
+static void fail(const struct filter_s *f, const char *what, long pos)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%s fs %d f1 %d f2 %d tr %d taps %d dec %d block %d: "
+             "%s at %ld\n", g_type_name[f->type], f->fs, f->f1, f->f2,
+             f->tr_width, f->taps, f->dec, f->blocksz, what, pos);
+    }
+}
+
+static int64_t sat(int64_t v, int bits)
+{
+  int64_t max = ((int64_t)1 << (bits - 1)) - 1;
+
+  return v > max ? max : (v < -max - 1 ? -max - 1 : v);
+}
+
+/* Fill the inputs: a sum of two tones and noise, then twice the signs of
+ * the coefficients at full scale, once positive and once negative. The
+ * output n is the sum of pCoeffs[j] * input[n - taps + 1 + j], and a
+ * decimator keeps the outputs n = k * step, so the pattern is placed
+ * to end on such an output.
+ */
+
+static void make_input(const float *coeffs, int taps, int step)
+{
+  double a1 = 2.0 * M_PI * frnd() * 0.5;
+  double a2 = 2.0 * M_PI * frnd() * 0.5;
+  int32_t v;
+  int start;
+  int sign;
+  int i;
+  int j;
+
+  for (i = 0; i < SIGNAL_LEN; i++)
+    {
+      g_inf[i] = 0.15 * sin(a1 * i) + 0.1 * sin(a2 * i) +
+                 0.05 * (frnd() - 0.5);
+    }
+
+  for (i = SIGNAL_LEN; i < INPUT_LEN; i++)
+    {
+      start = i - (i - SIGNAL_LEN) % WORST_SEG;
+      sign = start == SIGNAL_LEN ? 1 : -1;
+      start += (step - (start + taps - 1) % step) % step;
+      j = i - start;
+      g_inf[i] = (j >= 0 && j < taps && coeffs[j] < 0.f) ? -sign : sign;
+    }
+
+  for (i = 0; i < INPUT_LEN; i++)
+    {
+      v = (int32_t)lrint(g_inf[i] * 32768.0);
+      g_in15[i] = (q15_t)sat(v, 16);
+      g_in31[i] = (q31_t)g_in15[i] << 16;
+      g_inf[i] = g_in15[i] / 32768.f;
+    }
+}
+
+/* Quantized coefficients: within half a step of the design, and the
+ * smallest shift which keeps max|h| < 1 (q15) or sum|h| < 1 (q31).
+ */
+
+static void check_design(const struct filter_s *f, const float *coeffs,
+                         int taps, const void *qcoeffs, int qtaps,
+                         int shift, int q31)
+{
+  double scale = ldexp(1.0, (q31 ? 31 : 15) - shift);
+  double max = q31 ? 2147483647.0 : 32767.0;
+  double bound = 0.0;
+  double q;
+  int pad = qtaps - taps;
+  int i;
+
+  if (pad < 0 || ((q31 || f->type == TYPE_DEC) && pad) ||
+      (!q31 && f->type != TYPE_DEC && ((qtaps & 1) || qtaps < 4)))
+    {
+      fail(f, "tap number", qtaps);
+      return;
+    }
+
+  for (i = 0; i < qtaps; i++)
+    {
+      q = q31 ? ((const q31_t *)qcoeffs)[i] : ((const q15_t *)qcoeffs)[i];
+      if (i < pad)
+        {
+          if (q != 0.0)
+            {
+              fail(f, "padding coefficient", i);
+            }
+
+          continue;
+        }
+
+      if (fabs(q - coeffs[i - pad] * scale) > 0.5 &&
+          !(q == max && coeffs[i - pad] * scale > max))
+        {
+          fail(f, "coefficient", i);
+        }
+
+      if (q31)
+        {
+          bound += fabs(coeffs[i - pad]);
+        }
+      else if (fabs(coeffs[i - pad]) > bound)
+        {
+          bound = fabs(coeffs[i - pad]);
+        }
+    }
+
+  if (ldexp(bound, -shift) >= 1.0 ||
+      (shift > 0 && ldexp(bound, 1 - shift) < 1.0))
+    {
+      fail(f, "shift", shift);
+    }
+}
+
+/* Model of the kernel: exact products, the sum truncated to the output
+ * format, saturated, and shifted up with saturation.
+ */
+
+static int64_t model(const void *qcoeffs, int qtaps, int shift, int q31,
+                     int n)
+{
+  int frac = q31 ? 31 : 15;
+  int bits = q31 ? 32 : 16;
+  int64_t acc = 0;
+  int64_t x;
+  int j;
+  int k;
+
+  for (j = 0; j < qtaps; j++)
+    {
+      k = n - (qtaps - 1) + j;
+      if (k < 0)
+        {
+          continue;
+        }
+
+      x = q31 ? g_in31[k] : g_in15[k];
+      acc += x * (q31 ? ((const q31_t *)qcoeffs)[j] :
+                        ((const q15_t *)qcoeffs)[j]);
+    }
+
+  return sat(sat(acc >> frac, bits) * ((int64_t)1 << shift), bits);
+}
+
+static void check_outputs(const struct filter_s *f, const void *qcoeffs,
+                          int qtaps, int shift, int q31, int outputs)
+{
+  double scale = q31 ? 2147483648.0 : 32768.0;
+  double sum = 0.0;
+  double err;
+  int64_t expect;
+  int64_t got;
+  int step = f->type == TYPE_DEC ? f->dec : 1;
+  int num = 0;
+  int n;
+  int i;
+
+  for (i = 0; i < outputs; i++)
+    {
+      n = i * step;
+      expect = model(qcoeffs, qtaps, shift, q31, n);
+      got = q31 ? g_out31[i] : g_out15[i];
+      if (llabs(got - expect) > ((int64_t)1 << shift))
+        {
+          fail(f, q31 ? "q31 output" : "q15 output", i);
+        }
+
+      if (n < SIGNAL_LEN)
+        {
+          err = got / scale - g_outf[i];
+          sum += err * err;
+          num++;
+        }
+    }
+
+  err = sum > 0.0 ? 10.0 * log10(sum / num) : -999.0;
+  if (err > (q31 ? MAX_ERR_Q31 : MAX_ERR_Q15))
+    {
+      fail(f, q31 ? "q31 error against float" : "q15 error against float",
+           (long)err);
+    }
+
+  if (err > g_worst_err[f->type][q31])
+    {
+      g_worst_err[f->type][q31] = err;
+    }
+}
+
+static void test_filter(const struct filter_s *f)
+{
+  fir_instancef_t *ff = NULL;
+  fir_instanceq15_t *f15 = NULL;
+  fir_instanceq31_t *f31 = NULL;
+  long allocs = g_allocs;
+  int len;
+  int i;
+
+  switch (f->type)
+    {
+      case TYPE_LPF:
+        if (f->taps)
+          {
+            ff = fir_create_lpff_tap(f->fs, f->f1, f->taps, f->blocksz);
+            f15 = fir_create_lpfq15_tap(f->fs, f->f1, f->taps, f->blocksz);
+            f31 = fir_create_lpfq31_tap(f->fs, f->f1, f->taps, f->blocksz);
+          }
+        else
+          {
+            ff = fir_create_lpff(f->fs, f->f1, f->tr_width, f->blocksz);
+            f15 = fir_create_lpfq15(f->fs, f->f1, f->tr_width, f->blocksz);
+            f31 = fir_create_lpfq31(f->fs, f->f1, f->tr_width, f->blocksz);
+          }
+        break;
+
+      case TYPE_HPF:
+        if (f->taps)
+          {
+            ff = fir_create_hpff_tap(f->fs, f->f1, f->taps, f->blocksz);
+            f15 = fir_create_hpfq15_tap(f->fs, f->f1, f->taps, f->blocksz);
+            f31 = fir_create_hpfq31_tap(f->fs, f->f1, f->taps, f->blocksz);
+          }
+        else
+          {
+            ff = fir_create_hpff(f->fs, f->f1, f->tr_width, f->blocksz);
+            f15 = fir_create_hpfq15(f->fs, f->f1, f->tr_width, f->blocksz);
+            f31 = fir_create_hpfq31(f->fs, f->f1, f->tr_width, f->blocksz);
+          }
+        break;
+
+      case TYPE_BPF:
+        if (f->taps)
+          {
+            ff = fir_create_bpff_tap(f->fs, f->f1, f->f2, f->taps,
+                                     f->blocksz);
+            f15 = fir_create_bpfq15_tap(f->fs, f->f1, f->f2, f->taps,
+                                        f->blocksz);
+            f31 = fir_create_bpfq31_tap(f->fs, f->f1, f->f2, f->taps,
+                                        f->blocksz);
+          }
+        else
+          {
+            ff = fir_create_bpff(f->fs, f->f1, f->f2, f->tr_width,
+                                 f->blocksz);
+            f15 = fir_create_bpfq15(f->fs, f->f1, f->f2, f->tr_width,
+                                    f->blocksz);
+            f31 = fir_create_bpfq31(f->fs, f->f1, f->f2, f->tr_width,
+                                    f->blocksz);
+          }
+        break;
+
+      default:
+        if (f->taps)
+          {
+            ff = fir_create_beff_tap(f->fs, f->f1, f->f2, f->taps,
+                                     f->blocksz);
+            f15 = fir_create_befq15_tap(f->fs, f->f1, f->f2, f->taps,
+                                        f->blocksz);
+            f31 = fir_create_befq31_tap(f->fs, f->f1, f->f2, f->taps,
+                                        f->blocksz);
+          }
+        else
+          {
+            ff = fir_create_beff(f->fs, f->f1, f->f2, f->tr_width,
+                                 f->blocksz);
+            f15 = fir_create_befq15(f->fs, f->f1, f->f2, f->tr_width,
+                                    f->blocksz);
+            f31 = fir_create_befq31(f->fs, f->f1, f->f2, f->tr_width,
+                                    f->blocksz);
+          }
+        break;
+    }
+
+  if (ff == NULL || f15 == NULL || f31 == NULL)
+    {
+      fail(f, "create", 0);
+      goto out;
+    }
+
+  g_cases++;
+  make_input(ff->pCoeffs, ff->numTaps, 1);
+  check_design(f, ff->pCoeffs, ff->numTaps, f15->inst.pCoeffs,
+               fir_get_tapnumq15(f15), f15->shift, 0);
+  check_design(f, ff->pCoeffs, ff->numTaps, f31->inst.pCoeffs,
+               fir_get_tapnumq31(f31), f31->shift, 1);
+
+  for (i = 0; i < INPUT_LEN; i += len)
+    {
+      len = 1 + rnd() % f->blocksz;
+      len = len < INPUT_LEN - i ? len : INPUT_LEN - i;
+      fir_executef(ff, g_inf + i, g_outf + i, len);
+      fir_executeq15(f15, g_in15 + i, g_out15 + i, len);
+      fir_executeq31(f31, g_in31 + i, g_out31 + i, len);
+    }
+
+  check_outputs(f, f15->inst.pCoeffs, f15->inst.numTaps, f15->shift, 0,
+                INPUT_LEN);
+  check_outputs(f, f31->inst.pCoeffs, f31->inst.numTaps, f31->shift, 1,
+                INPUT_LEN);
+
+out:
+  fir_deletef(ff);
+  fir_deleteq15(f15);
+  fir_deleteq31(f31);
+  if (g_allocs != allocs)
+    {
+      fail(f, "memory left after delete", g_allocs - allocs);
+      g_allocs = allocs;
+    }
+}
+
+static void test_decimator(const struct filter_s *f)
+{
+  decimator_instancef_t *df;
+  decimator_instanceq15_t *d15;
+  decimator_instanceq31_t *d31;
+  long allocs = g_allocs;
+  int out = 0;
+  int len;
+  int n;
+  int i;
+
+  if (f->taps)
+    {
+      df = create_decimatorf_tap(f->fs, f->dec, f->taps, f->blocksz);
+      d15 = create_decimatorq15_tap(f->fs, f->dec, f->taps, f->blocksz);
+      d31 = create_decimatorq31_tap(f->fs, f->dec, f->taps, f->blocksz);
+    }
+  else
+    {
+      df = create_decimatorf(f->fs, f->dec, f->tr_width, f->blocksz);
+      d15 = create_decimatorq15(f->fs, f->dec, f->tr_width, f->blocksz);
+      d31 = create_decimatorq31(f->fs, f->dec, f->tr_width, f->blocksz);
+    }
+  if (df == NULL || d15 == NULL || d31 == NULL)
+    {
+      fail(f, "create", 0);
+      goto out;
+    }
+
+  g_cases++;
+  make_input(df->inst.pCoeffs, df->inst.numTaps, f->dec);
+  check_design(f, df->inst.pCoeffs, df->inst.numTaps, d15->inst.pCoeffs,
+               decimator_tapnumq15(d15), d15->shift, 0);
+  check_design(f, df->inst.pCoeffs, df->inst.numTaps, d31->inst.pCoeffs,
+               decimator_tapnumq31(d31), d31->shift, 1);
+
+  /* Call lengths are multiples of the factor up to the block size */
+
+  for (i = 0; i + f->dec <= INPUT_LEN; i += len)
+    {
+      len = f->dec * (1 + rnd() % (f->blocksz / f->dec));
+      len = len <= INPUT_LEN - i ? len : (INPUT_LEN - i) / f->dec * f->dec;
+      n = decimator_executef(df, g_inf + i, len, g_outf + out, len);
+      if (decimator_executeq15(d15, g_in15 + i, len, g_out15 + out, len)
+          != n ||
+          decimator_executeq31(d31, g_in31 + i, len, g_out31 + out, len)
+          != n || n != len / f->dec)
+        {
+          fail(f, "output number", i);
+          goto out;
+        }
+
+      out += n;
+    }
+
+  check_outputs(f, d15->inst.pCoeffs, d15->inst.numTaps, d15->shift, 0,
+                out);
+  check_outputs(f, d31->inst.pCoeffs, d31->inst.numTaps, d31->shift, 1,
+                out);
+
+out:
+  decimator_deletef(df);
+  decimator_deleteq15(d15);
+  decimator_deleteq31(d31);
+  if (g_allocs != allocs)
+    {
+      fail(f, "memory left after delete", g_allocs - allocs);
+      g_allocs = allocs;
+    }
+}
+
+/* Without taps the decimators only pick every dec-th sample */
+
+static void test_no_taps(void)
+{
+  struct filter_s f =
+  {
+    TYPE_DEC, 1000, 0, 0, 0, 0, 3, 12
+  };
+
+  decimator_instanceq15_t *d15;
+  decimator_instanceq31_t *d31;
+  long allocs = g_allocs;
+  int i;
+
+  d15 = create_decimatorq15_tap(f.fs, f.dec, 0, f.blocksz);
+  d31 = create_decimatorq31_tap(f.fs, f.dec, 0, f.blocksz);
+  for (i = 0; i < f.blocksz; i++)
+    {
+      g_in15[i] = (q15_t)(i * 1000);
+      g_in31[i] = i * 100000;
+    }
+
+  if (d15 == NULL || d31 == NULL ||
+      decimator_executeq15(d15, g_in15, f.blocksz, g_out15, 3) != -1 ||
+      decimator_executeq15(d15, g_in15, f.blocksz, g_out15, 4) != 4 ||
+      decimator_executeq31(d31, g_in31, f.blocksz, g_out31, 4) != 4)
+    {
+      fail(&f, "no taps", 0);
+    }
+  else
+    {
+      for (i = 0; i < 4; i++)
+        {
+          if (g_out15[i] != g_in15[i * 3] || g_out31[i] != g_in31[i * 3])
+            {
+              fail(&f, "no taps output", i);
+            }
+        }
+    }
+
+  decimator_deleteq15(d15);
+  decimator_deleteq31(d31);
+  if (g_allocs != allocs)
+    {
+      fail(&f, "memory left after delete", g_allocs - allocs);
+      g_allocs = allocs;
+    }
+}
+
+static void test_invalid(void)
+{
+  struct filter_s f =
+  {
+    TYPE_LPF, 0, 0, 0, 0, 0, 0, 0
+  };
+
+  if (fir_create_lpfq15(0, 100, 10, 8) || fir_create_lpfq31(1000, 100, 0, 8)
+      || fir_create_hpfq15(1000, 100, 10, 0) ||
+      fir_create_bpfq31_tap(1000, 100, 200, 0, 8) ||
+      fir_create_befq15_tap(-1, 100, 200, 11, 8) ||
+      create_decimatorq15(1000, 0, 10, 8) ||
+      create_decimatorq31_tap(1000, 2, 11, 0))
+    {
+      fail(&f, "invalid parameters accepted", 0);
+    }
+}
+
+static void random_filter(struct filter_s *f, enum type_e type)
+{
+  static const int rates[] =
+  {
+    100, 1000, 8000, 16000, 48000
+  };
+
+  int taps;
+
+  f->type = type;
+  f->fs = rates[rnd() % (sizeof(rates) / sizeof(rates[0]))];
+
+  /* Transition widths for 7 to MAX_TAPS taps, or 1 to 8 taps given */
+
+  do
+    {
+      f->tr_width = 1 + rnd() % (f->fs / 2);
+      taps = fir_calc_tapnumber(f->fs, f->tr_width);
+    }
+  while (taps > MAX_TAPS);
+
+  f->taps = (rnd() % 8) ? 0 : 1 + rnd() % 8;
+
+  f->f1 = 1 + rnd() % (f->fs / 2 - 2);
+  f->f2 = f->f1 + 1 + rnd() % (f->fs / 2 - f->f1 - 1);
+  f->dec = 2 + rnd() % 7;
+  f->blocksz = 1 + rnd() % 128;
+  if (type == TYPE_DEC)
+    {
+      f->blocksz = f->dec * (1 + rnd() % 16);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  struct filter_s f;
+  int type;
+  int i;
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+
+  for (type = 0; type < TYPE_NUM; type++)
+    {
+      g_worst_err[type][0] = -999.0;
+      g_worst_err[type][1] = -999.0;
+    }
+
+  for (i = 0; i < 200; i++)
+    {
+      for (type = 0; type < TYPE_NUM; type++)
+        {
+          random_filter(&f, (enum type_e)type);
+          if (type == TYPE_DEC)
+            {
+              test_decimator(&f);
+            }
+          else
+            {
+              test_filter(&f);
+            }
+        }
+    }
+
+  test_no_taps();
+  test_invalid();
+
+  for (type = 0; type < TYPE_NUM; type++)
+    {
+      printf("%-9s worst RMS error against float: q15 %.1f dBFS, "
+             "q31 %.1f dBFS\n", g_type_name[type], g_worst_err[type][0],
+             g_worst_err[type][1]);
+    }
+
+  printf("%lu filters, %lu errors\n", g_cases, g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * modules/digital_filter/host/fir_bench.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of the q15 and q31 FIR filters and decimators against
+ * the float ones.
+ *
+ * Each filter runs over the same signal in blocks of BLOCK_SIZE samples,
+ * for several tap numbers. The time per sample is given in ns, and in
+ * cycles when the clock of the CPU is given in MHz. The ratio to float
+ * is the figure to look at, the CMSIS kernels take their plain C paths
+ * on the host.
+ *
+ *   fir_bench [cpu_mhz]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <digital_filter/fir_filter.h>
+#include <digital_filter/fir_decimator.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FS          16000
+#define BLOCK_SIZE  64
+#define DEC_FACTOR  4
+#define SIGNAL_LEN  (BLOCK_SIZE * 256)
+#define MIN_TIME    0.2       /* Seconds of each measure */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s
+{
+  fir_instancef_t *ff;
+  fir_instanceq15_t *f15;
+  fir_instanceq31_t *f31;
+  decimator_instancef_t *df;
+  decimator_instanceq15_t *d15;
+  decimator_instanceq31_t *d31;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static float g_inf[SIGNAL_LEN];
+static float g_outf[SIGNAL_LEN];
+static q15_t g_in15[SIGNAL_LEN];
+static q15_t g_out15[SIGNAL_LEN];
+static q31_t g_in31[SIGNAL_LEN];
+static q31_t g_out31[SIGNAL_LEN];
+static double g_mhz;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void run(struct bench_s *b, int variant)
+{
+  int i;
+
+  for (i = 0; i < SIGNAL_LEN; i += BLOCK_SIZE)
+    {
+      switch (variant)
+        {
+          case 0:
+            fir_executef(b->ff, g_inf + i, g_outf + i, BLOCK_SIZE);
+            break;
+
+          case 1:
+            fir_executeq15(b->f15, g_in15 + i, g_out15 + i, BLOCK_SIZE);
+            break;
+
+          case 2:
+            fir_executeq31(b->f31, g_in31 + i, g_out31 + i, BLOCK_SIZE);
+            break;
+
+          case 3:
+            decimator_executef(b->df, g_inf + i, BLOCK_SIZE, g_outf + i,
+                               BLOCK_SIZE);
+            break;
+
+          case 4:
+            decimator_executeq15(b->d15, g_in15 + i, BLOCK_SIZE,
+                                 g_out15 + i, BLOCK_SIZE);
+            break;
+
+          default:
+            decimator_executeq31(b->d31, g_in31 + i, BLOCK_SIZE,
+                                 g_out31 + i, BLOCK_SIZE);
+            break;
+        }
+    }
+}
+
+/* Return ns per input sample */
+
+static double measure(struct bench_s *b, int variant)
+{
+  double start;
+  double elapsed;
+  long rounds = 0;
+
+  run(b, variant);
+  start = now();
+  do
+    {
+      run(b, variant);
+      rounds++;
+      elapsed = now() - start;
+    }
+  while (elapsed < MIN_TIME);
+
+  return elapsed * 1e9 / ((double)rounds * SIGNAL_LEN);
+}
+
+static void print_row(const char *name, int taps, const double *ns)
+{
+  int i;
+
+  printf("%-9s %5d", name, taps);
+  for (i = 0; i < 3; i++)
+    {
+      if (g_mhz > 0.0)
+        {
+          printf("  %8.1f", ns[i] * g_mhz / 1000.0);
+        }
+      else
+        {
+          printf("  %8.2f", ns[i]);
+        }
+    }
+
+  printf("  %5.2f  %5.2f\n", ns[1] / ns[0], ns[2] / ns[0]);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const int taps[] =
+  {
+    15, 31, 63, 127, 255
+  };
+
+  struct bench_s b;
+  double ns[6];
+  size_t i;
+  int v;
+
+  g_mhz = (argc > 1) ? atof(argv[1]) : 0.0;
+
+  for (i = 0; i < SIGNAL_LEN; i++)
+    {
+      g_inf[i] = 0.3f * sinf(0.05f * i) + 0.2f * sinf(1.3f * i);
+      g_in15[i] = (q15_t)lrintf(g_inf[i] * 32768.f);
+      g_in31[i] = (q31_t)g_in15[i] << 16;
+    }
+
+  printf("%s per input sample, blocks of %d samples\n",
+         g_mhz > 0.0 ? "cycles" : "ns", BLOCK_SIZE);
+  printf("%-9s %5s  %8s  %8s  %8s  %5s  %5s\n", "filter", "taps",
+         "float", "q15", "q31", "q15/f", "q31/f");
+
+  for (i = 0; i < sizeof(taps) / sizeof(taps[0]); i++)
+    {
+      b.ff = fir_create_lpff_tap(FS, FS / 8, taps[i], BLOCK_SIZE);
+      b.f15 = fir_create_lpfq15_tap(FS, FS / 8, taps[i], BLOCK_SIZE);
+      b.f31 = fir_create_lpfq31_tap(FS, FS / 8, taps[i], BLOCK_SIZE);
+      b.df = create_decimatorf_tap(FS, DEC_FACTOR, taps[i], BLOCK_SIZE);
+      b.d15 = create_decimatorq15_tap(FS, DEC_FACTOR, taps[i], BLOCK_SIZE);
+      b.d31 = create_decimatorq31_tap(FS, DEC_FACTOR, taps[i], BLOCK_SIZE);
+      if (!b.ff || !b.f15 || !b.f31 || !b.df || !b.d15 || !b.d31)
+        {
+          printf("create failed\n");
+          return EXIT_FAILURE;
+        }
+
+      for (v = 0; v < 6; v++)
+        {
+          ns[v] = measure(&b, v);
+        }
+
+      print_row("fir", taps[i], ns);
+      print_row("decimator", taps[i], ns + 3);
+
+      fir_deletef(b.ff);
+      fir_deleteq15(b.f15);
+      fir_deleteq31(b.f31);
+      decimator_deletef(b.df);
+      decimator_deleteq15(b.d15);
+      decimator_deleteq31(b.d31);
+    }
+
+  return EXIT_SUCCESS;
+}
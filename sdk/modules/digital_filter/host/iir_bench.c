@@ -0,0 +1,274 @@
+/****************************************************************************
+ * modules/digital_filter/host/iir_bench.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of the IIR biquad filters and the altitude Kalman filter.
+ *
+ * Butterworth low pass filters of several orders run over the same
+ * signal in blocks of BLOCK_SIZE samples, in float and q31, next to the
+ * FIR filter of the same cut off. The time per sample is given in ns, and
+ * in cycles when the clock of the CPU is given in MHz, with the group
+ * delay at DC measured on the impulse response. The Kalman filter is
+ * timed per predict and per correct call.
+ *
+ *   iir_bench [cpu_mhz]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <digital_filter/fir_filter.h>
+#include <digital_filter/iir_filter.h>
+#include <digital_filter/kalman_altitude.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FS          200
+#define CUTOFF      5
+#define FIR_TAPS    125
+#define BLOCK_SIZE  64
+#define SIGNAL_LEN  (BLOCK_SIZE * 256)
+#define MIN_TIME    0.2       /* Seconds of each measure */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s
+{
+  fir_instancef_t *fir;
+  iir_instancef_t *ff;
+  iir_instanceq31_t *f31;
+  kalman_altitude_t kf;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static float g_inf[SIGNAL_LEN];
+static float g_outf[SIGNAL_LEN];
+static q31_t g_in31[SIGNAL_LEN];
+static q31_t g_out31[SIGNAL_LEN];
+static double g_mhz;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void run(struct bench_s *b, int variant)
+{
+  int i;
+
+  for (i = 0; i < SIGNAL_LEN; i += BLOCK_SIZE)
+    {
+      switch (variant)
+        {
+          case 0:
+            fir_executef(b->fir, g_inf + i, g_outf + i, BLOCK_SIZE);
+            break;
+
+          case 1:
+            iir_executef(b->ff, g_inf + i, g_outf + i, BLOCK_SIZE);
+            break;
+
+          case 2:
+            iir_executeq31(b->f31, g_in31 + i, g_out31 + i, BLOCK_SIZE);
+            break;
+
+          case 3:
+
+            /* One sample per call, as from the accelerometer */
+
+            for (int j = 0; j < BLOCK_SIZE; j++)
+              {
+                kalman_altitude_predict(&b->kf, g_inf[i + j], 0.005f);
+              }
+            break;
+
+          default:
+            for (int j = 0; j < BLOCK_SIZE; j++)
+              {
+                kalman_altitude_correct(&b->kf, g_inf[i + j]);
+              }
+            break;
+        }
+    }
+}
+
+/* Return ns per sample or per call */
+
+static double measure(struct bench_s *b, int variant)
+{
+  double start;
+  double elapsed;
+  long rounds = 0;
+
+  run(b, variant);
+  start = now();
+  do
+    {
+      run(b, variant);
+      rounds++;
+      elapsed = now() - start;
+    }
+  while (elapsed < MIN_TIME);
+
+  return elapsed * 1e9 / ((double)rounds * SIGNAL_LEN);
+}
+
+static double cost(double ns)
+{
+  return (g_mhz > 0.0) ? ns * g_mhz / 1000.0 : ns;
+}
+
+/* Group delay at DC of the impulse response [samples] */
+
+static double dc_delay(const float *h, int len)
+{
+  double sum = 0.0;
+  double moment = 0.0;
+  int n;
+
+  for (n = 0; n < len; n++)
+    {
+      sum += h[n];
+      moment += (double)n * h[n];
+    }
+
+  return moment / sum;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const int orders[] =
+  {
+    2, 4, 8
+  };
+
+  struct bench_s b;
+  double ns[3];
+  double delay;
+  size_t i;
+  int v;
+
+  g_mhz = (argc > 1) ? atof(argv[1]) : 0.0;
+
+  for (i = 0; i < SIGNAL_LEN; i++)
+    {
+      g_inf[i] = 0.3f * sinf(0.05f * i) + 0.2f * sinf(1.3f * i);
+      g_in31[i] = (q31_t)lrintf(g_inf[i] * 2147483648.f);
+    }
+
+  b.fir = fir_create_lpff_tap(FS, CUTOFF, FIR_TAPS, BLOCK_SIZE);
+  if (!b.fir)
+    {
+      printf("create failed\n");
+      return EXIT_FAILURE;
+    }
+
+  ns[0] = measure(&b, 0);
+  fir_deletef(b.fir);
+
+  printf("%s per sample, %d Hz low pass at %d Hz, blocks of %d samples\n",
+         g_mhz > 0.0 ? "cycles" : "ns", CUTOFF, FS, BLOCK_SIZE);
+  printf("%-12s %5s  %8s  %8s  %8s\n", "filter", "order", "float", "q31",
+         "delay");
+  printf("%-12s %5d  %8.2f  %8s  %8.1f\n", "fir", FIR_TAPS, cost(ns[0]),
+         "-", (FIR_TAPS - 1) / 2.0);
+
+  for (i = 0; i < sizeof(orders) / sizeof(orders[0]); i++)
+    {
+      b.ff = iir_create_lpff(FS, CUTOFF, orders[i], IIR_DESIGN_BUTTERWORTH,
+                             0.f);
+      b.f31 = iir_create_lpfq31(FS, CUTOFF, orders[i],
+                                IIR_DESIGN_BUTTERWORTH, 0.f);
+      if (!b.ff || !b.f31)
+        {
+          printf("create failed\n");
+          return EXIT_FAILURE;
+        }
+
+      for (v = 1; v < 3; v++)
+        {
+          ns[v] = measure(&b, v);
+        }
+
+      /* Impulse response, the filter has died out after SIGNAL_LEN */
+
+      iir_resetf(b.ff);
+      memset(g_outf, 0, sizeof(g_outf));
+      g_outf[0] = 1.f;
+      iir_executef(b.ff, g_outf, g_outf, SIGNAL_LEN);
+      delay = dc_delay(g_outf, SIGNAL_LEN);
+
+      printf("%-12s %5d  %8.2f  %8.2f  %8.1f\n", "iir", orders[i],
+             cost(ns[1]), cost(ns[2]), delay);
+
+      iir_deletef(b.ff);
+      iir_deleteq31(b.f31);
+    }
+
+  kalman_altitude_init(&b.kf, 0.f, 0.3f, 0.01f, 0.5f);
+  ns[1] = measure(&b, 3);
+  ns[2] = measure(&b, 4);
+
+  printf("kalman predict %.2f, correct %.2f %s per call\n", cost(ns[1]),
+         cost(ns[2]), g_mhz > 0.0 ? "cycles" : "ns");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,705 @@
+/****************************************************************************
+ * modules/digital_filter/host/iir_response.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of the IIR biquad filters and of the altitude Kalman filter.
+ *
+ * Every IIR design of a fixed list is checked for:
+ *
+ *   response : the magnitude of the impulse response against the
+ *              Butterworth or Chebyshev target, |H|^2 = 1 / (1 + x^2n)
+ *              or 1 / (1 + eps^2 Tn(x)^2), where x is the prewarped
+ *              frequency mapped to the low pass prototype
+ *   delay    : the group delay at DC measured on the impulse response of
+ *              low pass filters, against the sum of -Re(1/p) over the
+ *              poles of the design
+ *   step     : the step response fed in random block lengths, against
+ *              the running sum of the impulse response, and its final
+ *              value against the gain at DC
+ *   q31      : the RMS error of the q31 impulse response against float
+ *
+ * The Kalman filter is run on simulated hovers and descents with noisy
+ * acceleration, accelerometer bias and barometric altitude.
+ *
+ *   iir_response [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <digital_filter/iir_filter.h>
+#include <digital_filter/kalman_altitude.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IMPULSE_LEN 8192      /* Samples of impulse and step responses */
+#define FREQ_NUM    97        /* Frequencies of the response check */
+#define Q31_INPUT   (1 << 27) /* Impulse of q31 filters, 2^-4 full scale */
+
+/* Response tolerance: in dB where the target is above -40 dB, otherwise
+ * absolute.
+ */
+
+#define MAX_ERR_DB  0.02
+#define MAX_ERR_ABS 2e-4
+
+/* Maximum RMS error of q31 against float [dBFS] */
+
+#define MAX_ERR_Q31 -120.0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum band_e
+{
+  BAND_LPF = 0,
+  BAND_HPF,
+  BAND_BPF
+};
+
+struct design_s
+{
+  enum band_e band;
+  int design;
+  int fs;
+  int f1;
+  int f2;
+  int order;
+  float ripple;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_band_name[] =
+{
+  "lpf", "hpf", "bpf"
+};
+
+static const struct design_s g_designs[] =
+{
+  { BAND_LPF, IIR_DESIGN_BUTTERWORTH,  200,   5,   0, 4, 0.f  },
+  { BAND_LPF, IIR_DESIGN_BUTTERWORTH,  200,  20,   0, 1, 0.f  },
+  { BAND_LPF, IIR_DESIGN_BUTTERWORTH,  200,  40,   0, 7, 0.f  },
+  { BAND_LPF, IIR_DESIGN_BUTTERWORTH, 1000,  10,   0, 8, 0.f  },
+  { BAND_LPF, IIR_DESIGN_CHEBYSHEV,    200,   5,   0, 4, 1.f  },
+  { BAND_LPF, IIR_DESIGN_CHEBYSHEV,    200,  20,   0, 5, 0.5f },
+  { BAND_LPF, IIR_DESIGN_CHEBYSHEV,    200,  60,   0, 2, 3.f  },
+  { BAND_HPF, IIR_DESIGN_BUTTERWORTH,  200,  10,   0, 4, 0.f  },
+  { BAND_HPF, IIR_DESIGN_BUTTERWORTH,  200,  50,   0, 3, 0.f  },
+  { BAND_HPF, IIR_DESIGN_CHEBYSHEV,    200,  30,   0, 3, 1.f  },
+  { BAND_HPF, IIR_DESIGN_CHEBYSHEV,    200,  10,   0, 6, 0.5f },
+  { BAND_BPF, IIR_DESIGN_BUTTERWORTH,  200,  10,  30, 2, 0.f  },
+  { BAND_BPF, IIR_DESIGN_BUTTERWORTH, 1000, 100, 200, 4, 0.f  },
+  { BAND_BPF, IIR_DESIGN_CHEBYSHEV,    200,   5,  15, 3, 1.f  },
+  { BAND_BPF, IIR_DESIGN_CHEBYSHEV,    200,  40,  60, 2, 0.5f },
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+static double g_worst_q31 = -999.0;
+
+static float g_in[IMPULSE_LEN];
+static float g_impulse[IMPULSE_LEN];
+static float g_step[IMPULSE_LEN];
+static q31_t g_in31[IMPULSE_LEN];
+static q31_t g_out31[IMPULSE_LEN];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static double frnd(void)
+{
+  return ((double)(rnd() & 0xffff) + 0.5) / 65536.0;
+}
+
+static double grnd(void)
+{
+  return sqrt(-2.0 * log(frnd())) * cos(2.0 * M_PI * frnd());
+}
+
+static void fail(const struct design_s *d, const char *what, double v)
+{
+  if (g_errors++ < 8)
+    {
+      if (d)
+        {
+          printf("%s %s fs %d f1 %d f2 %d order %d ripple %.1f: ",
+                 g_band_name[d->band],
+                 d->design == IIR_DESIGN_CHEBYSHEV ? "chebyshev" :
+                 "butterworth", d->fs, d->f1, d->f2, d->order, d->ripple);
+        }
+
+      printf("%s (%g)\n", what, v);
+    }
+}
+
+static int iir_stages(const struct design_s *d)
+{
+  return (d->band == BAND_BPF) ? d->order : (d->order + 1) / 2;
+}
+
+/* Target magnitude at frequency f */
+
+static double target(const struct design_s *d, double f)
+{
+  double w = tan(M_PI * f / d->fs);
+  double w1 = tan(M_PI * d->f1 / d->fs);
+  double w2 = d->band == BAND_BPF ? tan(M_PI * d->f2 / d->fs) : w1;
+  double eps;
+  double t;
+  double x;
+
+  switch (d->band)
+    {
+      case BAND_LPF:
+        x = w / w1;
+        break;
+
+      case BAND_HPF:
+        x = w1 / w;
+        break;
+
+      default:
+        x = fabs((w * w - w1 * w2) / (w * (w2 - w1)));
+        break;
+    }
+
+  if (d->design == IIR_DESIGN_BUTTERWORTH)
+    {
+      return 1.0 / sqrt(1.0 + pow(x, 2 * d->order));
+    }
+
+  eps = sqrt(pow(10.0, d->ripple / 10.0) - 1.0);
+  t = (x <= 1.0) ? cos(d->order * acos(x)) : cosh(d->order * acosh(x));
+  return 1.0 / sqrt(1.0 + eps * eps * t * t);
+}
+
+/* Group delay at DC of a low pass design [samples]. With the bilinear
+ * transform s = (1 - z^-1) / (1 + z^-1), it is half the delay of the
+ * analog filter with poles at w1 * p.
+ */
+
+static double target_delay(const struct design_s *d)
+{
+  double w1 = tan(M_PI * d->f1 / d->fs);
+  double eps;
+  double sh = 1.0;
+  double ch = 1.0;
+  double theta;
+  double pr;
+  double pi;
+  double sum = 0.0;
+  int k;
+
+  if (d->design == IIR_DESIGN_CHEBYSHEV)
+    {
+      eps = sqrt(pow(10.0, d->ripple / 10.0) - 1.0);
+      sh = sinh(asinh(1.0 / eps) / d->order);
+      ch = cosh(asinh(1.0 / eps) / d->order);
+    }
+
+  for (k = 0; k < d->order; k++)
+    {
+      theta = M_PI * (2 * k + 1) / (2 * d->order);
+      pr = -sh * sin(theta);
+      pi = ch * cos(theta);
+      sum += -pr / (pr * pr + pi * pi);
+    }
+
+  return sum / (2.0 * w1);
+}
+
+static iir_instancef_t *create_f32(const struct design_s *d)
+{
+  switch (d->band)
+    {
+      case BAND_LPF:
+        return iir_create_lpff(d->fs, d->f1, d->order, d->design, d->ripple);
+
+      case BAND_HPF:
+        return iir_create_hpff(d->fs, d->f1, d->order, d->design, d->ripple);
+
+      default:
+        return iir_create_bpff(d->fs, d->f1, d->f2, d->order, d->design,
+                               d->ripple);
+    }
+}
+
+static iir_instanceq31_t *create_q31(const struct design_s *d)
+{
+  switch (d->band)
+    {
+      case BAND_LPF:
+        return iir_create_lpfq31(d->fs, d->f1, d->order, d->design,
+                                 d->ripple);
+
+      case BAND_HPF:
+        return iir_create_hpfq31(d->fs, d->f1, d->order, d->design,
+                                 d->ripple);
+
+      default:
+        return iir_create_bpfq31(d->fs, d->f1, d->f2, d->order, d->design,
+                                 d->ripple);
+    }
+}
+
+/* Magnitude of the DFT of the impulse response at frequency f */
+
+static double magnitude(const struct design_s *d, double f)
+{
+  double w = 2.0 * M_PI * f / d->fs;
+  double re = 0.0;
+  double im = 0.0;
+  int n;
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      re += g_impulse[n] * cos(w * n);
+      im -= g_impulse[n] * sin(w * n);
+    }
+
+  return sqrt(re * re + im * im);
+}
+
+static void check_response(const struct design_s *d)
+{
+  double f;
+  double h;
+  double t;
+  int i;
+
+  for (i = 0; i < FREQ_NUM + 2; i++)
+    {
+      /* A grid over the band, and the cut off frequencies */
+
+      f = (i < FREQ_NUM) ? 0.5 * d->fs * i / FREQ_NUM :
+          (i == FREQ_NUM) ? d->f1 : d->f2;
+      if ((f == 0.0 && d->band != BAND_LPF) ||
+          (i == FREQ_NUM + 1 && d->band != BAND_BPF))
+        {
+          continue;
+        }
+
+      h = magnitude(d, f);
+      t = target(d, f);
+
+      if (t > 0.01 ? fabs(20.0 * log10(h / t)) > MAX_ERR_DB :
+          fabs(h - t) > MAX_ERR_ABS)
+        {
+          fail(d, "response error at Hz", f);
+          return;
+        }
+    }
+}
+
+static void check_delay(const struct design_s *d)
+{
+  double sum = 0.0;
+  double moment = 0.0;
+  double delay;
+  double expect = target_delay(d);
+  int n;
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      sum += g_impulse[n];
+      moment += (double)n * g_impulse[n];
+    }
+
+  delay = moment / sum;
+  if (fabs(delay - expect) > 1e-3 * expect + 0.01)
+    {
+      fail(d, "group delay at DC", delay);
+    }
+
+  printf("%s %-11s fs %4d f1 %3d order %d: DC group delay %.2f samples "
+         "(design %.2f)\n", g_band_name[d->band],
+         d->design == IIR_DESIGN_CHEBYSHEV ? "chebyshev" : "butterworth",
+         d->fs, d->f1, d->order, delay, expect);
+}
+
+/* Step response in random blocks, which also checks the state kept
+ * between calls, against the running sum of the impulse response.
+ */
+
+static void check_step(const struct design_s *d, iir_instancef_t *iir)
+{
+  double sum = 0.0;
+  double err = 0.0;
+  double final;
+  int len;
+  int n;
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      g_in[n] = 1.f;
+    }
+
+  iir_resetf(iir);
+  for (n = 0; n < IMPULSE_LEN; n += len)
+    {
+      len = 1 + rnd() % 300;
+      if (len > IMPULSE_LEN - n)
+        {
+          len = IMPULSE_LEN - n;
+        }
+
+      iir_executef(iir, g_in + n, g_step + n, len);
+    }
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      sum += g_impulse[n];
+      if (fabs(g_step[n] - sum) > err)
+        {
+          err = fabs(g_step[n] - sum);
+        }
+    }
+
+  if (err > 1e-4)
+    {
+      fail(d, "step against impulse response", err);
+    }
+
+  final = (d->band == BAND_LPF) ? target(d, 0.0) : 0.0;
+  if (fabs(g_step[IMPULSE_LEN - 1] - final) > 1e-4)
+    {
+      fail(d, "final value of step response", g_step[IMPULSE_LEN - 1]);
+    }
+}
+
+static void check_q31(const struct design_s *d)
+{
+  iir_instanceq31_t *iir = create_q31(d);
+  double scale = (double)Q31_INPUT / 2147483648.0;
+  double err = 0.0;
+  double e;
+  int n;
+
+  if (!iir || iir_get_stagenumq31(iir) != iir_stages(d))
+    {
+      fail(d, "q31 create", 0);
+      iir_deleteq31(iir);
+      return;
+    }
+
+  /* Dirty the state, so that reset is checked too */
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      g_in31[n] = Q31_INPUT;
+    }
+
+  iir_executeq31(iir, g_in31, g_out31, IMPULSE_LEN);
+  iir_resetq31(iir);
+
+  memset(g_in31, 0, sizeof(g_in31));
+  g_in31[0] = Q31_INPUT;
+  iir_executeq31(iir, g_in31, g_out31, IMPULSE_LEN);
+
+  for (n = 0; n < IMPULSE_LEN; n++)
+    {
+      e = g_out31[n] / 2147483648.0 - scale * g_impulse[n];
+      err += e * e;
+    }
+
+  err = 10.0 * log10(err / IMPULSE_LEN + 1e-30);
+  if (err > g_worst_q31)
+    {
+      g_worst_q31 = err;
+    }
+
+  if (err > MAX_ERR_Q31)
+    {
+      fail(d, "q31 RMS error against float [dBFS]", err);
+    }
+
+  iir_deleteq31(iir);
+}
+
+static void test_design(const struct design_s *d)
+{
+  iir_instancef_t *iir = create_f32(d);
+  double tail = 0.0;
+  int n;
+
+  if (!iir || iir_get_stagenumf(iir) != iir_stages(d))
+    {
+      fail(d, "create", 0);
+      iir_deletef(iir);
+      return;
+    }
+
+  memset(g_in, 0, sizeof(g_in));
+  g_in[0] = 1.f;
+  iir_executef(iir, g_in, g_impulse, IMPULSE_LEN);
+
+  /* The response must have died out for the checks to hold */
+
+  for (n = IMPULSE_LEN - 64; n < IMPULSE_LEN; n++)
+    {
+      tail += fabs(g_impulse[n]);
+    }
+
+  if (tail > 1e-6)
+    {
+      fail(d, "impulse response too long", tail);
+    }
+
+  check_response(d);
+  if (d->band == BAND_LPF)
+    {
+      check_delay(d);
+    }
+
+  check_step(d, iir);
+  check_q31(d);
+
+  iir_deletef(iir);
+}
+
+static void test_invalid(void)
+{
+  static const struct design_s bad[] =
+  {
+    { BAND_LPF, IIR_DESIGN_BUTTERWORTH, 200,   0,   0, 4, 0.f },
+    { BAND_LPF, IIR_DESIGN_BUTTERWORTH, 200, 100,   0, 4, 0.f },
+    { BAND_LPF, IIR_DESIGN_BUTTERWORTH, 200,  10,   0, 0, 0.f },
+    { BAND_LPF, IIR_DESIGN_CHEBYSHEV,   200,  10,   0, 4, 0.f },
+    { BAND_LPF, 2,                      200,  10,   0, 4, 1.f },
+    { BAND_HPF, IIR_DESIGN_BUTTERWORTH,   0,  10,   0, 4, 0.f },
+    { BAND_BPF, IIR_DESIGN_BUTTERWORTH, 200,  30,  10, 2, 0.f },
+    { BAND_BPF, IIR_DESIGN_BUTTERWORTH, 200,  10, 100, 2, 0.f },
+  };
+
+  iir_instancef_t *f;
+  iir_instanceq31_t *q;
+  size_t i;
+
+  for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+      f = create_f32(&bad[i]);
+      q = create_q31(&bad[i]);
+      if (f || q)
+        {
+          fail(&bad[i], "invalid design created", 0);
+        }
+
+      iir_deletef(f);
+      iir_deleteq31(q);
+    }
+}
+
+/* Fly a vertical profile at 200 Hz with barometer samples at 10 Hz, and
+ * return the RMS errors of altitude and velocity over the second half.
+ */
+
+static void fly(float velocity, float bias, float acc_noise,
+                float baro_noise, double *alt_rms, double *vel_rms,
+                float *bias_est)
+{
+  const float dt = 1.f / 200.f;
+  const int samples = 200 * 120;
+  kalman_altitude_t kf;
+  double alt = 1000.0;
+  double vel = 0.0;
+  double acc;
+  double ea = 0.0;
+  double ev = 0.0;
+  int n;
+
+  kalman_altitude_init(&kf, alt + baro_noise * grnd(), acc_noise, 0.01f,
+                       baro_noise);
+
+  for (n = 0; n < samples; n++)
+    {
+      /* Accelerate to the velocity in the first 10 s, with a wobble */
+
+      acc = (n < 2000) ? velocity / 10.0 : 0.0;
+      acc += 0.5 * sin(2.0 * M_PI * 0.3 * n * dt);
+
+      alt += vel * dt + 0.5 * acc * dt * dt;
+      vel += acc * dt;
+
+      kalman_altitude_predict(&kf, acc + bias + acc_noise * grnd(), dt);
+
+      if (n % 20 == 19)
+        {
+          kalman_altitude_update(&kf, alt + baro_noise * grnd());
+        }
+
+      if (kf.p[0] <= 0.f || kf.p[3] <= 0.f || kf.p[5] <= 0.f ||
+          kf.p[1] * kf.p[1] > kf.p[0] * kf.p[3] * 1.0001f ||
+          isnan(kf.altitude))
+        {
+          fail(NULL, "Kalman covariance not positive at sample", n);
+          break;
+        }
+
+      if (n >= samples / 2)
+        {
+          ea += (kf.altitude - alt) * (kf.altitude - alt);
+          ev += (kf.velocity - vel) * (kf.velocity - vel);
+        }
+    }
+
+  *alt_rms = sqrt(ea / (samples / 2));
+  *vel_rms = sqrt(ev / (samples / 2));
+  *bias_est = kf.bias;
+}
+
+static void test_kalman(void)
+{
+  static const struct
+  {
+    float velocity;
+    float bias;
+    float acc_noise;
+    float baro_noise;
+  }
+  runs[] =
+  {
+    {   0.f,  0.2f, 0.3f, 0.5f },
+    {  -8.f,  0.2f, 0.3f, 0.5f },
+    {  -8.f, -0.3f, 1.0f, 1.0f },
+    {  20.f,  0.0f, 0.3f, 0.2f },
+  };
+
+  kalman_altitude_t kf;
+  kalman_altitude_t kc;
+  double alt_rms;
+  double vel_rms;
+  float bias;
+  float h;
+  size_t i;
+
+  for (i = 0; i < sizeof(runs) / sizeof(runs[0]); i++)
+    {
+      fly(runs[i].velocity, runs[i].bias, runs[i].acc_noise,
+          runs[i].baro_noise, &alt_rms, &vel_rms, &bias);
+
+      printf("kalman v %5.1f bias %4.1f noise %.1f/%.1f: altitude %.2f m, "
+             "velocity %.2f m/s RMS, bias %.2f\n", runs[i].velocity,
+             runs[i].bias, runs[i].acc_noise, runs[i].baro_noise,
+             alt_rms, vel_rms, bias);
+
+      /* Far better than the barometer alone, and the bias is found */
+
+      if (alt_rms > 0.5 * runs[i].baro_noise)
+        {
+          fail(NULL, "Kalman altitude RMS error", alt_rms);
+        }
+
+      if (vel_rms > 0.2)
+        {
+          fail(NULL, "Kalman velocity RMS error", vel_rms);
+        }
+
+      if (fabsf(bias - runs[i].bias) > 0.05f)
+        {
+          fail(NULL, "Kalman bias", bias);
+        }
+    }
+
+  /* update() is correct() with the innovation to the current estimate */
+
+  kalman_altitude_init(&kf, 10.f, 0.3f, 0.01f, 0.5f);
+  kalman_altitude_predict(&kf, 1.f, 0.1f);
+  kc = kf;
+  kalman_altitude_update(&kf, 12.f);
+  kalman_altitude_correct(&kc, 12.f - kc.altitude);
+  if (memcmp(&kf, &kc, sizeof(kf)) != 0)
+    {
+      fail(NULL, "Kalman update differs from correct", 0);
+    }
+
+  /* Standard atmosphere: 1000 m at 89874.6 Pa */
+
+  h = kalman_altitude_pressure(101325.f, 101325.f);
+  if (fabsf(h) > 0.01f)
+    {
+      fail(NULL, "altitude at reference pressure", h);
+    }
+
+  h = kalman_altitude_pressure(89874.6f, 101325.f);
+  if (fabsf(h - 1000.f) > 1.f)
+    {
+      fail(NULL, "altitude at 89874.6 Pa", h);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  size_t i;
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+
+  for (i = 0; i < sizeof(g_designs) / sizeof(g_designs[0]); i++)
+    {
+      test_design(&g_designs[i]);
+    }
+
+  test_invalid();
+  test_kalman();
+
+  printf("worst q31 RMS error against float: %.1f dBFS\n", g_worst_q31);
+  printf("%zu designs, %lu errors\n",
+         sizeof(g_designs) / sizeof(g_designs[0]), g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,496 @@
+/****************************************************************************
+ * modules/digital_filter/iir_base_filters.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <arm_math.h>
+
+#include <digital_filter/iir_filter.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IIR_BAND_LPF (0)
+#define IIR_BAND_HPF (1)
+#define IIR_BAND_BPF (2)
+
+#define IIR_STAGE_COEFFS (5)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The filters are designed from the poles of an analog low pass prototype
+ * with cut off at 1 rad/s. The band transformation is done on prewarped
+ * frequencies W = tan(pi * f / fs), and each analog section
+ * (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0) is turned into a biquad by
+ * the bilinear transform s = (1 - z^-1) / (1 + z^-1).
+ */
+
+static void bilinear(double n2, double n1, double n0,
+                     double d2, double d1, double d0, float *coeffs)
+{
+  double a0;
+
+  if (d2 == 0.)
+    {
+      /* First order section */
+
+      a0 = d1 + d0;
+      coeffs[0] = (n1 + n0) / a0;
+      coeffs[1] = (n0 - n1) / a0;
+      coeffs[2] = 0.f;
+      coeffs[3] = -(d0 - d1) / a0;
+      coeffs[4] = 0.f;
+    }
+  else
+    {
+      a0 = d2 + d1 + d0;
+      coeffs[0] = (n2 + n1 + n0) / a0;
+      coeffs[1] = 2. * (n0 - n2) / a0;
+      coeffs[2] = (n2 - n1 + n0) / a0;
+
+      /* CMSIS DSP adds the feedback terms, so they are negated */
+
+      coeffs[3] = -2. * (d0 - d2) / a0;
+      coeffs[4] = -(d2 - d1 + d0) / a0;
+    }
+}
+
+static int iir_stage_number(int band, int order)
+{
+  return (band == IIR_BAND_BPF) ? order : (order + 1) / 2;
+}
+
+static int iir_design(int band, int fs, int f1, int f2, int order,
+                      int design, float ripple, float *coeffs)
+{
+  int k;
+  int stage = 0;
+  double eps;
+  double sh = 1.;
+  double ch = 1.;
+  double gain = 1.;
+  double theta;
+  double pr;
+  double pi;
+  double b;
+  double w1;
+  double w2;
+  double w0sq;
+  double bw;
+  double qr;
+  double qi;
+  double dr;
+  double di;
+  double r;
+  double sr;
+  double si;
+
+  if ((order < 1) || (fs <= 0) || (f1 <= 0) || (f1 * 2 >= fs))
+    {
+      return -1;
+    }
+
+  if ((band == IIR_BAND_BPF) && ((f2 <= f1) || (f2 * 2 >= fs)))
+    {
+      return -1;
+    }
+
+  if (design == IIR_DESIGN_CHEBYSHEV)
+    {
+      if (ripple <= 0.f)
+        {
+          return -1;
+        }
+
+      eps = sqrt(pow(10., ripple / 10.) - 1.);
+      sh = sinh(asinh(1. / eps) / order);
+      ch = cosh(asinh(1. / eps) / order);
+
+      /* Even order ripples down from the pass band gain at DC */
+
+      if (!(order & 1))
+        {
+          gain = 1. / sqrt(1. + eps * eps);
+        }
+    }
+  else if (design != IIR_DESIGN_BUTTERWORTH)
+    {
+      return -1;
+    }
+
+  w1 = tan(M_PI * f1 / fs);
+  w2 = (band == IIR_BAND_BPF) ? tan(M_PI * f2 / fs) : w1;
+  w0sq = w1 * w2;
+  bw = w2 - w1;
+
+  /* Poles in the upper half plane, and the real pole of odd order */
+
+  for (k = 0; k < (order + 1) / 2; k++)
+    {
+      theta = M_PI * (2 * k + 1) / (2 * order);
+      pr = -sh * sin(theta);
+      pi = (2 * k + 1 == order) ? 0. : ch * cos(theta);
+      b = pr * pr + pi * pi;
+
+      if (pi == 0.)
+        {
+          switch (band)
+            {
+              case IIR_BAND_LPF:
+                bilinear(0., 0., -pr * w1, 0., 1., -pr * w1,
+                         &coeffs[stage * IIR_STAGE_COEFFS]);
+                break;
+
+              case IIR_BAND_HPF:
+                bilinear(0., 1., 0., 0., 1., w1 / -pr,
+                         &coeffs[stage * IIR_STAGE_COEFFS]);
+                break;
+
+              default:
+                bilinear(0., -pr * bw, 0., 1., -pr * bw, w0sq,
+                         &coeffs[stage * IIR_STAGE_COEFFS]);
+                break;
+            }
+
+          stage++;
+          continue;
+        }
+
+      switch (band)
+        {
+          case IIR_BAND_LPF:
+            bilinear(0., 0., b * w1 * w1, 1., -2. * pr * w1, b * w1 * w1,
+                     &coeffs[stage * IIR_STAGE_COEFFS]);
+            stage++;
+            break;
+
+          case IIR_BAND_HPF:
+            bilinear(1., 0., 0., 1., -2. * pr * w1 / b, w1 * w1 / b,
+                     &coeffs[stage * IIR_STAGE_COEFFS]);
+            stage++;
+            break;
+
+          default:
+
+            /* A prototype pole p gives the roots of s^2 - p bw s + w0^2,
+             * each of them makes a section with its conjugate.
+             */
+
+            qr = pr * bw / 2.;
+            qi = pi * bw / 2.;
+            dr = qr * qr - qi * qi - w0sq;
+            di = 2. * qr * qi;
+            r = sqrt(dr * dr + di * di);
+            sr = sqrt((r + dr) / 2.);
+            si = copysign(sqrt((r - dr) / 2.), di);
+
+            bilinear(0., sqrt(b) * bw, 0., 1., -2. * (qr + sr),
+                     (qr + sr) * (qr + sr) + (qi + si) * (qi + si),
+                     &coeffs[stage * IIR_STAGE_COEFFS]);
+            stage++;
+            bilinear(0., sqrt(b) * bw, 0., 1., -2. * (qr - sr),
+                     (qr - sr) * (qr - sr) + (qi - si) * (qi - si),
+                     &coeffs[stage * IIR_STAGE_COEFFS]);
+            stage++;
+            break;
+        }
+    }
+
+  coeffs[0] *= gain;
+  coeffs[1] *= gain;
+  coeffs[2] *= gain;
+
+  return stage;
+}
+
+static iir_instancef_t *iir_create_f32(int band, int fs, int f1, int f2,
+    int order, int design, float ripple)
+{
+  int stages;
+  iir_instancef_t *S;
+  float *coeffs;
+  float *state;
+
+  if (order < 1)
+    {
+      return NULL;
+    }
+
+  stages = iir_stage_number(band, order);
+
+  S = (iir_instancef_t *)malloc(sizeof(iir_instancef_t));
+  coeffs = (float *)malloc(sizeof(float) * IIR_STAGE_COEFFS * stages);
+  state = (float *)malloc(sizeof(float) * 2 * stages);
+  if (!S || !coeffs || !state)
+    {
+      goto error;
+    }
+
+  if (iir_design(band, fs, f1, f2, order, design, ripple, coeffs) != stages)
+    {
+      goto error;
+    }
+
+  arm_biquad_cascade_df2T_init_f32(S, stages, coeffs, state);
+
+  return S;
+
+error:
+  free(state);
+  free(coeffs);
+  free(S);
+
+  return NULL;
+}
+
+static iir_instanceq31_t *iir_create_q31(int band, int fs, int f1, int f2,
+    int order, int design, float ripple)
+{
+  int i;
+  int stages;
+  int8_t shift = 0;
+  float bound = 0.f;
+  double scale;
+  double v;
+  iir_instanceq31_t *S = NULL;
+  float *coeffs;
+  q31_t *qcoeffs = NULL;
+  q31_t *state = NULL;
+
+  if (order < 1)
+    {
+      return NULL;
+    }
+
+  stages = iir_stage_number(band, order);
+
+  coeffs = (float *)malloc(sizeof(float) * IIR_STAGE_COEFFS * stages);
+  if (!coeffs)
+    {
+      return NULL;
+    }
+
+  if (iir_design(band, fs, f1, f2, order, design, ripple, coeffs) != stages)
+    {
+      goto error;
+    }
+
+  S = (iir_instanceq31_t *)malloc(sizeof(iir_instanceq31_t));
+  qcoeffs = (q31_t *)malloc(sizeof(q31_t) * IIR_STAGE_COEFFS * stages);
+  state = (q31_t *)malloc(sizeof(q31_t) * 4 * stages);
+  if (!S || !qcoeffs || !state)
+    {
+      goto error;
+    }
+
+  /* Feedback coefficients reach 2, all of them are scaled down by the
+   * same power of 2 which is given back by postShift.
+   */
+
+  for (i = 0; i < IIR_STAGE_COEFFS * stages; i++)
+    {
+      if (fabsf(coeffs[i]) > bound)
+        {
+          bound = fabsf(coeffs[i]);
+        }
+    }
+
+  while (bound >= 1.f)
+    {
+      bound *= 0.5f;
+      shift++;
+    }
+
+  scale = 2147483648.0 / (double)(1 << shift);
+  for (i = 0; i < IIR_STAGE_COEFFS * stages; i++)
+    {
+      v = round((double)coeffs[i] * scale);
+      qcoeffs[i] = (v >= 2147483647.0) ? 0x7fffffff :
+                   (v <= -2147483648.0) ? (q31_t)0x80000000 : (q31_t)v;
+    }
+
+  free(coeffs);
+
+  arm_biquad_cascade_df1_init_q31(S, stages, qcoeffs, state, shift);
+
+  return S;
+
+error:
+  free(state);
+  free(qcoeffs);
+  free(S);
+  free(coeffs);
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_DIGITAL_FILTER_IIR
+
+/** iir_create_lpff() */
+
+iir_instancef_t * iir_create_lpff(int fs, int cutoff_freq, int order,
+    int design, float ripple)
+{
+  return iir_create_f32(IIR_BAND_LPF, fs, cutoff_freq, 0, order, design,
+                        ripple);
+}
+
+/** iir_create_hpff() */
+
+iir_instancef_t * iir_create_hpff(int fs, int cutoff_freq, int order,
+    int design, float ripple)
+{
+  return iir_create_f32(IIR_BAND_HPF, fs, cutoff_freq, 0, order, design,
+                        ripple);
+}
+
+/** iir_create_bpff() */
+
+iir_instancef_t * iir_create_bpff(int fs, int lower_cutfreq,
+    int higher_cutfreq, int order, int design, float ripple)
+{
+  return iir_create_f32(IIR_BAND_BPF, fs, lower_cutfreq, higher_cutfreq,
+                        order, design, ripple);
+}
+
+/** iir_get_stagenumf() */
+
+int iir_get_stagenumf(iir_instancef_t *iir)
+{
+  return iir->numStages;
+}
+
+/** iir_executef() */
+
+void iir_executef(iir_instancef_t *iir, float *input, float *output, int len)
+{
+  arm_biquad_cascade_df2T_f32(iir, input, output, len);
+}
+
+/** iir_resetf() */
+
+void iir_resetf(iir_instancef_t *iir)
+{
+  memset(iir->pState, 0, sizeof(float) * 2 * iir->numStages);
+}
+
+/** iir_deletef() */
+
+void iir_deletef(iir_instancef_t *iir)
+{
+  if (iir)
+    {
+      free(iir->pState);
+      free((void *)iir->pCoeffs);
+      free(iir);
+    }
+}
+
+/** iir_create_lpfq31() */
+
+iir_instanceq31_t * iir_create_lpfq31(int fs, int cutoff_freq, int order,
+    int design, float ripple)
+{
+  return iir_create_q31(IIR_BAND_LPF, fs, cutoff_freq, 0, order, design,
+                        ripple);
+}
+
+/** iir_create_hpfq31() */
+
+iir_instanceq31_t * iir_create_hpfq31(int fs, int cutoff_freq, int order,
+    int design, float ripple)
+{
+  return iir_create_q31(IIR_BAND_HPF, fs, cutoff_freq, 0, order, design,
+                        ripple);
+}
+
+/** iir_create_bpfq31() */
+
+iir_instanceq31_t * iir_create_bpfq31(int fs, int lower_cutfreq,
+    int higher_cutfreq, int order, int design, float ripple)
+{
+  return iir_create_q31(IIR_BAND_BPF, fs, lower_cutfreq, higher_cutfreq,
+                        order, design, ripple);
+}
+
+/** iir_get_stagenumq31() */
+
+int iir_get_stagenumq31(iir_instanceq31_t *iir)
+{
+  return iir->numStages;
+}
+
+/** iir_executeq31() */
+
+void iir_executeq31(iir_instanceq31_t *iir, q31_t *input, q31_t *output,
+    int len)
+{
+  arm_biquad_cascade_df1_q31(iir, input, output, len);
+}
+
+/** iir_resetq31() */
+
+void iir_resetq31(iir_instanceq31_t *iir)
+{
+  memset(iir->pState, 0, sizeof(q31_t) * 4 * iir->numStages);
+}
+
+/** iir_deleteq31() */
+
+void iir_deleteq31(iir_instanceq31_t *iir)
+{
+  if (iir)
+    {
+      free(iir->pState);
+      free((void *)iir->pCoeffs);
+      free(iir);
+    }
+}
+
+#endif  /* CONFIG_DIGITAL_FILTER_IIR */
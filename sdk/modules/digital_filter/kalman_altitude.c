@@ -0,0 +1,163 @@
+/****************************************************************************
+ * modules/digital_filter/kalman_altitude.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include <digital_filter/kalman_altitude.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Index of the covariance upper triangle */
+
+#define P00 0
+#define P01 1
+#define P02 2
+#define P11 3
+#define P12 4
+#define P22 5
+
+/* Initial uncertainty of velocity and bias */
+
+#define KALMAN_ALTITUDE_VELOCITY_VAR (1.f)
+#define KALMAN_ALTITUDE_BIAS_VAR     (0.25f)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* The model is h' = v, v' = acc - bias and bias' = 0 with noise on the
+ * acceleration and the bias. The covariance is symmetric, so only its
+ * upper triangle is kept and propagated with the products written out,
+ * which keeps a prediction at a few dozens of multiplications.
+ */
+
+/** kalman_altitude_init() */
+
+void kalman_altitude_init(kalman_altitude_t *kf, float altitude,
+    float acc_noise, float bias_noise, float baro_noise)
+{
+  kf->altitude = altitude;
+  kf->velocity = 0.f;
+  kf->bias     = 0.f;
+
+  kf->acc_var  = acc_noise * acc_noise;
+  kf->bias_var = bias_noise * bias_noise;
+  kf->baro_var = baro_noise * baro_noise;
+
+  kf->p[P00] = kf->baro_var;
+  kf->p[P01] = 0.f;
+  kf->p[P02] = 0.f;
+  kf->p[P11] = KALMAN_ALTITUDE_VELOCITY_VAR;
+  kf->p[P12] = 0.f;
+  kf->p[P22] = KALMAN_ALTITUDE_BIAS_VAR;
+}
+
+/** kalman_altitude_predict() */
+
+void kalman_altitude_predict(kalman_altitude_t *kf, float acc, float dt)
+{
+  float *p = kf->p;
+  float hdt2 = 0.5f * dt * dt;
+  float a = acc - kf->bias;
+  float a00;
+  float a01;
+  float a02;
+  float a11;
+  float a12;
+
+  kf->altitude += kf->velocity * dt + a * hdt2;
+  kf->velocity += a * dt;
+
+  /* P = F P F' + Q with F = [1 dt -dt^2/2; 0 1 -dt; 0 0 1] */
+
+  a00 = p[P00] + dt * p[P01] - hdt2 * p[P02];
+  a01 = p[P01] + dt * p[P11] - hdt2 * p[P12];
+  a02 = p[P02] + dt * p[P12] - hdt2 * p[P22];
+  a11 = p[P11] - dt * p[P12];
+  a12 = p[P12] - dt * p[P22];
+
+  p[P00] = a00 + dt * a01 - hdt2 * a02 + hdt2 * hdt2 * kf->acc_var;
+  p[P01] = a01 - dt * a02 + hdt2 * dt * kf->acc_var;
+  p[P02] = a02;
+  p[P11] = a11 - dt * a12 + dt * dt * kf->acc_var;
+  p[P12] = a12;
+  p[P22] += dt * kf->bias_var;
+}
+
+/** kalman_altitude_correct() */
+
+void kalman_altitude_correct(kalman_altitude_t *kf, float innovation)
+{
+  float *p = kf->p;
+  float s = p[P00] + kf->baro_var;
+  float k0 = p[P00] / s;
+  float k1 = p[P01] / s;
+  float k2 = p[P02] / s;
+
+  kf->altitude += k0 * innovation;
+  kf->velocity += k1 * innovation;
+  kf->bias     += k2 * innovation;
+
+  /* P = (I - K H) P with H = [1 0 0] */
+
+  p[P11] -= k1 * p[P01];
+  p[P12] -= k1 * p[P02];
+  p[P22] -= k2 * p[P02];
+  p[P00] -= k0 * p[P00];
+  p[P01] -= k0 * p[P01];
+  p[P02] -= k0 * p[P02];
+}
+
+/** kalman_altitude_update() */
+
+void kalman_altitude_update(kalman_altitude_t *kf, float altitude)
+{
+  kalman_altitude_correct(kf, altitude - kf->altitude);
+}
+
+/** kalman_altitude_pressure() */
+
+float kalman_altitude_pressure(float pressure, float reference)
+{
+  return 44330.f * (1.f - powf(pressure / reference, 1.f / 5.255f));
+}
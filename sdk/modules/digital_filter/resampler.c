@@ -0,0 +1,383 @@
+/****************************************************************************
+ * modules/digital_filter/resampler.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <arm_math.h>
+
+#include <digital_filter/resampler.h>
+
+#include "fir_design.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int gcd(int a, int b)
+{
+  int t;
+
+  while (b != 0)
+    {
+      t = a % b;
+      a = b;
+      b = t;
+    }
+
+  return a;
+}
+
+/* Tap number of a stage decimating by factor from rate fs_in in a
+ * cascade ending at rate fs_out with a transition band tr_width. Only
+ * the final pass band has to be kept from aliasing, everything up to
+ * fs_in / factor - pass band is removed by the later stages.
+ */
+
+static int stage_taps(int fs_in, int factor, int fs_out, int tr_width)
+{
+  return fir_tap_number(fs_in, fs_in / factor - fs_out + tr_width);
+}
+
+static void plan_stages(int fs, int remain, int fs_out, int tr_width,
+                        float scale, float cost, int depth, int *factors,
+                        float *best_cost, int *best, int *best_num)
+{
+  int f;
+  int i;
+  float c;
+
+  if (remain == 1)
+    {
+      if (cost < *best_cost)
+        {
+          *best_cost = cost;
+          *best_num = depth;
+          for (i = 0; i < depth; i++)
+            {
+              best[i] = factors[i];
+            }
+        }
+
+      return;
+    }
+
+  if (depth == DECIMATOR_CASCADE_MAX_STAGES)
+    {
+      return;
+    }
+
+  for (f = 2; f <= remain; f++)
+    {
+      if (remain % f != 0)
+        {
+          continue;
+        }
+
+      /* The stage spends taps MACs on every scale * f cascade inputs */
+
+      c = cost + (float)stage_taps(fs, f, fs_out, tr_width) / (scale * f);
+      if (c >= *best_cost)
+        {
+          continue;
+        }
+
+      factors[depth] = f;
+      plan_stages(fs / f, remain / f, fs_out, tr_width, scale * f, c,
+                  depth + 1, factors, best_cost, best, best_num);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/** create_resamplerf() */
+
+resampler_instancef_t *create_resamplerf(int fs_in, int fs_out, int tr_width,
+    int blocksz)
+{
+  resampler_instancef_t *S;
+  float *h;
+  int taps;
+  int div;
+  int p;
+  int j;
+  int k;
+
+  if ((fs_in <= 0) || (fs_out <= 0) || (tr_width <= 0) || (blocksz <= 0))
+    {
+      return NULL;
+    }
+
+  S = (resampler_instancef_t *)malloc(sizeof(resampler_instancef_t));
+  if (S == NULL)
+    {
+      return NULL;
+    }
+
+  div        = gcd(fs_in, fs_out);
+  S->up      = fs_out / div;
+  S->down    = fs_in / div;
+  S->blocksz = blocksz;
+  S->phase   = 0;
+  S->pos     = 0;
+
+  /* Design the anti-aliasing / anti-imaging filter at the rate L * fs_in
+   * and cut it off at the lower of the two Nyquist frequencies.
+   */
+
+  taps = fir_tap_number(fs_in * S->up, tr_width);
+  S->phase_taps = (taps + S->up - 1) / S->up;
+
+  h = fir_coeffs_lpf(1.f / (float)(2 * (S->up > S->down ? S->up : S->down)),
+                     taps);
+  S->coeffs = (float *)malloc(sizeof(float) * S->up * S->phase_taps);
+  S->state = (float *)calloc(S->phase_taps - 1 + blocksz, sizeof(float));
+  if (h == NULL || S->coeffs == NULL || S->state == NULL)
+    {
+      free(h);
+      resampler_deletef(S);
+      return NULL;
+    }
+
+  /* Phase p holds h[p], h[p + L], ... in reverse order, so one output is
+   * a dot product with phase_taps contiguous input samples. The gain of
+   * L makes up for the zeros stuffed by the interpolation.
+   */
+
+  for (p = 0; p < S->up; p++)
+    {
+      for (j = 0; j < S->phase_taps; j++)
+        {
+          k = p + (S->phase_taps - 1 - j) * S->up;
+          S->coeffs[p * S->phase_taps + j] =
+            (k < taps) ? h[k] * (float)S->up : 0.f;
+        }
+    }
+
+  free(h);
+
+  return S;
+}
+
+/** resampler_executef() */
+
+int resampler_executef(resampler_instancef_t *rs, float *input, int input_len,
+    float *output, int output_len)
+{
+  int hist = rs->phase_taps - 1;
+  int n = 0;
+
+  if ((input_len < 0) || (input_len > rs->blocksz) ||
+      (output_len < input_len * rs->up / rs->down + 1))
+    {
+      return -1;
+    }
+
+  /* state[i] holds input[i - hist] */
+
+  memcpy(rs->state + hist, input, sizeof(float) * input_len);
+
+  while (rs->pos < input_len)
+    {
+      arm_dot_prod_f32(rs->coeffs + rs->phase * rs->phase_taps,
+                       rs->state + rs->pos, rs->phase_taps, &output[n++]);
+
+      rs->phase += rs->down;
+      rs->pos   += rs->phase / rs->up;
+      rs->phase %= rs->up;
+    }
+
+  rs->pos -= input_len;
+  memmove(rs->state, rs->state + input_len, sizeof(float) * hist);
+
+  return n;
+}
+
+/** resampler_deletef() */
+
+void resampler_deletef(resampler_instancef_t *rs)
+{
+  if (rs)
+    {
+      free(rs->coeffs);
+      free(rs->state);
+      free(rs);
+    }
+}
+
+/** decimator_plan_stages() */
+
+int decimator_plan_stages(int fs, int dec_factor, int tr_width, int *factors)
+{
+  int work[DECIMATOR_CASCADE_MAX_STAGES];
+  float best_cost = 3.4e38f;
+  int num = -1;
+
+  if ((fs <= 0) || (dec_factor <= 0) || (tr_width <= 0) ||
+      (tr_width >= fs / dec_factor) || (fs % dec_factor != 0))
+    {
+      return -1;
+    }
+
+  plan_stages(fs, dec_factor, fs / dec_factor, tr_width, 1.f, 0.f, 0, work,
+              &best_cost, factors, &num);
+
+  return num;
+}
+
+/** create_decimator_cascadef() */
+
+decimator_cascadef_t *create_decimator_cascadef(int fs, int dec_factor,
+    int tr_width, int blocksz)
+{
+  decimator_cascadef_t *S;
+  int factors[DECIMATOR_CASCADE_MAX_STAGES];
+  int fs_out;
+  int len;
+  int i;
+
+  if ((blocksz <= 0) || (dec_factor <= 0) || (blocksz % dec_factor != 0))
+    {
+      return NULL;
+    }
+
+  S = (decimator_cascadef_t *)calloc(1, sizeof(decimator_cascadef_t));
+  if (S == NULL)
+    {
+      return NULL;
+    }
+
+  S->num_stages = decimator_plan_stages(fs, dec_factor, tr_width, factors);
+  if (S->num_stages < 0)
+    {
+      free(S);
+      return NULL;
+    }
+
+  S->factor = dec_factor;
+  fs_out = fs / dec_factor;
+  len = blocksz;
+
+  for (i = 0; i < S->num_stages; i++)
+    {
+      S->stage[i] = create_decimatorf_tap(fs, factors[i],
+                      stage_taps(fs, factors[i], fs_out, tr_width), len);
+      if (S->stage[i] == NULL)
+        {
+          decimator_cascade_deletef(S);
+          return NULL;
+        }
+
+      fs  /= factors[i];
+      len /= factors[i];
+    }
+
+  /* Intermediate outputs ping-pong between the output of the first stage
+   * and the smaller one of the second stage.
+   */
+
+  if (S->num_stages > 1)
+    {
+      len = blocksz / factors[0];
+      S->work = (float *)malloc(sizeof(float) * (len + len / factors[1]));
+      if (S->work == NULL)
+        {
+          decimator_cascade_deletef(S);
+          return NULL;
+        }
+    }
+
+  return S;
+}
+
+/** decimator_cascade_executef() */
+
+int decimator_cascade_executef(decimator_cascadef_t *dec, float *input,
+    int input_len, float *output, int output_len)
+{
+  float *buf[2];
+  float *src = input;
+  float *dst;
+  int len = input_len;
+  int i;
+
+  if (output_len < input_len / dec->factor)
+    {
+      return -1;
+    }
+
+  if (dec->num_stages == 0)
+    {
+      memcpy(output, input, sizeof(float) * input_len);
+      return input_len;
+    }
+
+  buf[0] = dec->work;
+  buf[1] = dec->work + input_len / dec->stage[0]->inst.M;
+
+  for (i = 0; i < dec->num_stages; i++)
+    {
+      dst = (i == dec->num_stages - 1) ? output : buf[i & 1];
+      len = decimator_executef(dec->stage[i], src, len, dst, len);
+      src = dst;
+    }
+
+  return len;
+}
+
+/** decimator_cascade_deletef() */
+
+void decimator_cascade_deletef(decimator_cascadef_t *dec)
+{
+  int i;
+
+  if (dec)
+    {
+      for (i = 0; i < DECIMATOR_CASCADE_MAX_STAGES; i++)
+        {
+          decimator_deletef(dec->stage[i]);
+        }
+
+      free(dec->work);
+      free(dec);
+    }
+}
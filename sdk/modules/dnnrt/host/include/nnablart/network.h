@@ -0,0 +1,84 @@
+/****************************************************************************
+ * modules/dnnrt/host/include/nnablart/network.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Subset of nnablart/network.h of nnabla-c-runtime, with the members used
+ * by the variable buffer planner. The layout follows the original so the
+ * test builds networks the same way the converter does.
+ */
+
+#ifndef HOST_NNABLART_NETWORK_H
+#define HOST_NNABLART_NETWORK_H
+
+#include <stdint.h>
+
+#define NN_GET(N, X) ((void *)((uint8_t *)(N) + (X)))
+
+typedef struct
+{
+  int32_t size;
+  int32_t list;
+} nn_list_t;
+
+typedef struct
+{
+  int32_t version;
+  int32_t api_level;
+  nn_list_t buffers;
+  nn_list_t variables;
+  nn_list_t functions;
+  nn_list_t inputs;
+  nn_list_t outputs;
+  nn_list_t memory_data;
+  int32_t data[];
+} nn_network_t;
+
+typedef struct
+{
+  uint32_t id;
+  nn_list_t shape;
+  unsigned int type : 4;
+  unsigned int fp_pos : 4;
+  int32_t data_index;
+} nn_variable_t;
+
+typedef struct
+{
+  uint16_t type;
+  uint16_t impl;
+  nn_list_t inputs;
+  nn_list_t outputs;
+} nn_function_t;
+
+#endif /* HOST_NNABLART_NETWORK_H */
@@ -0,0 +1,56 @@
+/****************************************************************************
+ * modules/dnnrt/host/include/nnablart/runtime.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Subset of nnablart/runtime.h of nnabla-c-runtime */
+
+#ifndef HOST_NNABLART_RUNTIME_H
+#define HOST_NNABLART_RUNTIME_H
+
+#include <nnablart/network.h>
+
+typedef enum
+{
+  RT_RET_ERROR_VERSION_UNMATCH = -899,
+  RT_RET_ERROR_ALLOCATE_CONTEXT,
+  RT_RET_ERROR_INITIALIZE_CONTEXT_TWICE,
+  RT_RET_ERROR_INVALID_BUFFER_INDEX,
+  RT_RET_ERROR_INIT_VARIABLE,
+  RT_RET_ERROR_UNKNOWN_FUNCTION,
+  RT_RET_ERROR_NO_MATCHING_FUNCTION,
+  RT_RET_FUNCTION_MATCH = 0,
+  RT_RET_NOERROR = 0
+} rt_return_value_t;
+
+#endif /* HOST_NNABLART_RUNTIME_H */
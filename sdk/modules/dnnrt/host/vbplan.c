@@ -0,0 +1,492 @@
+/****************************************************************************
+ * modules/dnnrt/host/vbplan.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of the variable buffer allocation of shared_chunk.c.
+ *
+ * Networks are built in memory the way the converter lays them out, run
+ * through dnn_peek_vbuffers() and dnn_preallocate_chunks(), and the
+ * addresses are checked against lifetimes computed here:
+ *
+ *  - buffers live at the same time never overlap,
+ *  - every buffer is 4 bytes aligned and inside a chunk,
+ *  - with DNN_RT_VBUFFER_PLANNER, the planned size is at least the largest
+ *    live set and at most the sum of the buffers, and a hand-checked chain
+ *    network gets its optimal size,
+ *  - all chunks are freed when the buffers are released.
+ *
+ *   vbplan [networks]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "runtime_common.h"
+
+#define MAX_VARS   48
+#define MAX_FUNCS  32
+#define MAX_EDGES  3
+#define MAX_IO     2
+#define NET_SIZE   8192
+
+#define ROUND4(x)  (((x) + 3) & ~3)
+
+struct netdesc
+{
+  int nbuf;
+  int bsize[MAX_VBUFFER_NUM];
+  int nvar;
+  int vbuf[MAX_VARS];
+  int nfunc;
+  int nin[MAX_FUNCS];
+  int in[MAX_FUNCS][MAX_EDGES];
+  int nout[MAX_FUNCS];
+  int out[MAX_FUNCS][MAX_EDGES];
+  int nnin;
+  int nins[MAX_IO];
+  int nnout;
+  int nouts[MAX_IO];
+};
+
+static dnn_global_context_t g_ctx;
+static int32_t g_net[NET_SIZE / 4];
+static int g_pos;
+static uint32_t g_seed = 0x2545f491;
+static int g_errors;
+
+dnn_global_context_t *dnn_get_global_context(void)
+{
+  return &g_ctx;
+}
+
+static uint32_t rnd(uint32_t n)
+{
+  g_seed ^= g_seed << 13;
+  g_seed ^= g_seed >> 17;
+  g_seed ^= g_seed << 5;
+  return g_seed % n;
+}
+
+static int put(const void *data, int size)
+{
+  int pos = g_pos;
+
+  memcpy((uint8_t *)g_net + pos, data, size);
+  g_pos += ROUND4(size);
+  return pos;
+}
+
+static void put_list(nn_list_t *l, const int *ids, int num)
+{
+  l->size = num;
+  l->list = put(ids, num * sizeof(int));
+}
+
+static nn_network_t *build(const struct netdesc *d)
+{
+  nn_network_t *n = (nn_network_t *)g_net;
+  int voffs[MAX_VARS];
+  int foffs[MAX_FUNCS];
+  int i;
+
+  memset(g_net, 0, sizeof(g_net));
+  g_pos = ROUND4(sizeof(nn_network_t));
+
+  n->version = 3;
+  put_list(&n->buffers, d->bsize, d->nbuf);
+
+  for (i = 0; i < d->nvar; i++)
+    {
+      nn_variable_t v;
+
+      memset(&v, 0, sizeof(v));
+      v.id = i;
+      v.data_index = -(d->vbuf[i] + 1);
+      voffs[i] = put(&v, sizeof(v));
+    }
+
+  put_list(&n->variables, voffs, d->nvar);
+
+  for (i = 0; i < d->nfunc; i++)
+    {
+      nn_function_t f;
+
+      memset(&f, 0, sizeof(f));
+      put_list(&f.inputs, d->in[i], d->nin[i]);
+      put_list(&f.outputs, d->out[i], d->nout[i]);
+      foffs[i] = put(&f, sizeof(f));
+    }
+
+  put_list(&n->functions, foffs, d->nfunc);
+  put_list(&n->inputs, d->nins, d->nnin);
+  put_list(&n->outputs, d->nouts, d->nnout);
+
+  return n;
+}
+
+/* Lifetimes as documented by dnn_plan_vbuffers() */
+
+static void lifetimes(const struct netdesc *d, int *first, int *last)
+{
+  int i;
+  int j;
+
+  for (i = 0; i < d->nbuf; i++)
+    {
+      first[i] = d->nfunc + 1;
+      last[i] = -2;
+    }
+
+#define TOUCH(var, step) \
+  do { \
+    int b = d->vbuf[var]; \
+    first[b] = (step) < first[b] ? (step) : first[b]; \
+    last[b] = (step) > last[b] ? (step) : last[b]; \
+  } while (0)
+
+  for (i = 0; i < d->nfunc; i++)
+    {
+      for (j = 0; j < d->nin[i]; j++)
+        {
+          TOUCH(d->in[i][j], i);
+        }
+
+      for (j = 0; j < d->nout[i]; j++)
+        {
+          TOUCH(d->out[i][j], i);
+        }
+    }
+
+  for (j = 0; j < d->nnin; j++)
+    {
+      TOUCH(d->nins[j], -1);
+    }
+
+  for (j = 0; j < d->nnout; j++)
+    {
+      TOUCH(d->nouts[j], d->nfunc);
+    }
+
+#undef TOUCH
+
+  for (i = 0; i < d->nbuf; i++)
+    {
+      if (last[i] < first[i])
+        {
+          first[i] = -1;
+          last[i] = d->nfunc;
+        }
+    }
+}
+
+static int in_chunk(const uint8_t *p, size_t size)
+{
+  dnn_shared_chunk_t *c;
+
+  for (c = g_ctx.chunks; c != NULL; c = c->next)
+    {
+      const uint8_t *begin = c->data;
+
+      if (begin <= p && p + size <= begin + c->allocated_bsize)
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+static void fail(const char *name, const char *what, int a, int b)
+{
+  if (g_errors++ < 10)
+    {
+      printf("%s: %s (%d, %d)\n", name, what, a, b);
+    }
+}
+
+/* Place the buffers of a network, as dnn_runtime_initialize() does, and
+ * check them. Returns the planned size.
+ */
+
+static size_t place(const char *name, const struct netdesc *d,
+                    dnn_vbuffer_alloc_info_t *ai)
+{
+  nn_network_t *n = build(d);
+  int first[MAX_VBUFFER_NUM];
+  int last[MAX_VBUFFER_NUM];
+  size_t sum = 0;
+  size_t maxlive = 0;
+  int i;
+  int j;
+  int t;
+
+  g_ctx.alloc_info = ai;
+
+  if (dnn_peek_vbuffers(n, ai) != RT_RET_NOERROR)
+    {
+      fail(name, "peek failed", d->nbuf, 0);
+      return 0;
+    }
+
+  dnn_reset_chunk_usage(&g_ctx);
+  if (dnn_preallocate_chunks(&g_ctx, ai) != RT_RET_NOERROR)
+    {
+      fail(name, "preallocate failed", d->nbuf, 0);
+      return 0;
+    }
+
+  lifetimes(d, first, last);
+
+  for (i = 0; i < d->nbuf; i++)
+    {
+      uint8_t *pi = ai->addr_list[i];
+      size_t si = ROUND4(d->bsize[i]);
+
+      sum += si;
+
+      if (((uintptr_t)pi & 3) != 0 || !in_chunk(pi, si))
+        {
+          fail(name, "buffer outside of chunks or unaligned", i, 0);
+        }
+
+      for (j = 0; j < i; j++)
+        {
+          uint8_t *pj = ai->addr_list[j];
+          size_t sj = ROUND4(d->bsize[j]);
+
+          if (first[i] <= last[j] && first[j] <= last[i] &&
+              pi < pj + sj && pj < pi + si)
+            {
+              fail(name, "live buffers overlap", i, j);
+            }
+        }
+    }
+
+  for (t = -1; t <= d->nfunc; t++)
+    {
+      size_t live = 0;
+
+      for (i = 0; i < d->nbuf; i++)
+        {
+          if (first[i] <= t && t <= last[i])
+            {
+              live += ROUND4(d->bsize[i]);
+            }
+        }
+
+      maxlive = live > maxlive ? live : maxlive;
+    }
+
+#ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+  if (ai->planned_bsize < maxlive || ai->planned_bsize > sum)
+    {
+      fail(name, "planned size out of bounds", (int)ai->planned_bsize,
+           (int)maxlive);
+    }
+#else
+  if (ai->planned_bsize != sum)
+    {
+      fail(name, "size is not the sum of buffers", (int)ai->planned_bsize,
+           (int)sum);
+    }
+#endif
+
+  /* Take the buffers, as rt_initialize_context() does */
+
+  for (i = 0; i < d->nbuf; i++)
+    {
+      dnn_variable_malloc(d->bsize[i]);
+    }
+
+  return ai->planned_bsize;
+}
+
+static void release(dnn_vbuffer_alloc_info_t *ai)
+{
+  int i;
+
+  for (i = 0; i < (int)ai->vbuffer_num; i++)
+    {
+      dnn_variable_free(ai->addr_list[i]);
+    }
+}
+
+/* in -> f0 -> b1 -> f1 -> b2 -> f2 -> b3 -> f3 -> b1 -> f4 -> out
+ * The largest live set is b1 + b2 + b3 while f2 runs.
+ */
+
+static void test_chain(void)
+{
+  static const struct netdesc d =
+  {
+    .nbuf  = 5,
+    .bsize = { 400, 1000, 2000, 600, 40 },
+    .nvar  = 6,
+    .vbuf  = { 0, 1, 2, 3, 4, 1 },
+    .nfunc = 5,
+    .nin   = { 1, 1, 1, 1, 1 },
+    .in    = { { 0 }, { 1 }, { 2 }, { 3 }, { 5 } },
+    .nout  = { 1, 1, 1, 1, 1 },
+    .out   = { { 1 }, { 2 }, { 3 }, { 5 }, { 4 } },
+    .nnin  = 1,
+    .nins  = { 0 },
+    .nnout = 1,
+    .nouts = { 4 },
+  };
+
+  dnn_vbuffer_alloc_info_t ai;
+  size_t size = place("chain", &d, &ai);
+
+#ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+  if (size != 3600)
+    {
+      fail("chain", "planned size", (int)size, 3600);
+    }
+#else
+  if (size != 4040)
+    {
+      fail("chain", "size", (int)size, 4040);
+    }
+#endif
+
+  release(&ai);
+}
+
+static void random_net(struct netdesc *d)
+{
+  int i;
+  int j;
+
+  memset(d, 0, sizeof(*d));
+
+  d->nbuf = 1 + rnd(MAX_VBUFFER_NUM);
+  for (i = 0; i < d->nbuf; i++)
+    {
+      d->bsize[i] = 1 + rnd(rnd(8) ? 1024 : 4096);
+    }
+
+  d->nvar = d->nbuf + rnd(MAX_VARS - d->nbuf + 1);
+  for (i = 0; i < d->nvar; i++)
+    {
+      d->vbuf[i] = rnd(d->nbuf);
+    }
+
+  d->nfunc = rnd(MAX_FUNCS + 1);
+  for (i = 0; i < d->nfunc; i++)
+    {
+      d->nin[i] = 1 + rnd(MAX_EDGES);
+      d->nout[i] = 1 + rnd(MAX_EDGES - 1);
+      for (j = 0; j < d->nin[i]; j++)
+        {
+          d->in[i][j] = rnd(d->nvar);
+        }
+
+      for (j = 0; j < d->nout[i]; j++)
+        {
+          d->out[i][j] = rnd(d->nvar);
+        }
+    }
+
+  d->nnin = rnd(MAX_IO + 1);
+  for (j = 0; j < d->nnin; j++)
+    {
+      d->nins[j] = rnd(d->nvar);
+    }
+
+  d->nnout = rnd(MAX_IO + 1);
+  for (j = 0; j < d->nnout; j++)
+    {
+      d->nouts[j] = rnd(d->nvar);
+    }
+}
+
+/* Random networks, two runtimes alive at a time so the second one is
+ * placed in the chunks of the first one when it fits.
+ */
+
+static void test_random(int count)
+{
+  static struct netdesc d[2];
+  dnn_vbuffer_alloc_info_t ai[2];
+  size_t planned = 0;
+  size_t sum = 0;
+  int i;
+
+  random_net(&d[0]);
+  place("random", &d[0], &ai[0]);
+
+  for (i = 1; i < count; i++)
+    {
+      int cur = i & 1;
+      int j;
+
+      random_net(&d[cur]);
+      planned += place("random", &d[cur], &ai[cur]);
+      for (j = 0; j < d[cur].nbuf; j++)
+        {
+          sum += ROUND4(d[cur].bsize[j]);
+        }
+
+      release(&ai[cur ^ 1]);
+    }
+
+  release(&ai[(count - 1) & 1]);
+
+  if (g_ctx.chunks != NULL)
+    {
+      fail("random", "chunks left after release", 0, 0);
+    }
+
+  printf("random: %d networks, planned %zu of %zu bytes (%zu%%)\n",
+         count, planned, sum, sum ? planned * 100 / sum : 0);
+}
+
+int main(int argc, char *argv[])
+{
+  int count = (argc > 1) ? atoi(argv[1]) : 20000;
+
+  test_chain();
+  test_random(count < 2 ? 2 : count);
+
+  if (g_errors)
+    {
+      printf("FAILED: %d errors\n", g_errors);
+      return 1;
+    }
+
+  printf("OK\n");
+  return 0;
+}
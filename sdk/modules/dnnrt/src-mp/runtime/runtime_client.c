@@ -172,6 +172,7 @@ int dnn_nuttx_mallinfo(dnn_mallinfo_t * info)
   info->total_bytes = mem.arena;
   info->used_bytes = mem.uordblks;
   info->largest_bytes = mem.mxordblk;
+  info->planned_bytes = 0;
 
   return 0;
 }
@@ -37,8 +37,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <errno.h>
 #include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <mpcomm/supervisor.h>
@@ -52,6 +55,10 @@
 
 static mpcomm_supervisor_context_t *ctx = NULL;
 
+#ifdef CONFIG_DNN_RT_PROFILE
+static dnn_profile_t *s_dnn_profile;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -101,6 +108,7 @@ static int dnn_supervisor_send_msg(int id, int num_args, ...)
 int dnn_initialize(dnn_config_t *config)
 {
   dnn_config_t cfg = {.cpu_num = 1};
+  int ret;
 
   if (config == NULL)
     {
@@ -112,13 +120,32 @@ int dnn_initialize(dnn_config_t *config)
       return -EINVAL;
     }
 
-  return mpcomm_supervisor_init(&ctx, CONFIG_DNN_RT_MPCOMM_PATH,
-                                config->cpu_num - 1);
+  ret = mpcomm_supervisor_init(&ctx, CONFIG_DNN_RT_MPCOMM_PATH,
+                               config->cpu_num - 1);
+
+#ifdef CONFIG_DNN_RT_PROFILE
+  /* The controller is a new instance, give it the ring set before */
+
+  if (ret == 0 && s_dnn_profile)
+    {
+      dnn_supervisor_send_msg(DNNRT_MSG_NRT_SET_PROFILE, 1, s_dnn_profile);
+    }
+#endif
+
+  return ret;
 }
 
 int dnn_finalize(void)
 {
-  return mpcomm_supervisor_deinit(ctx);
+  int ret;
+
+  ret = mpcomm_supervisor_deinit(ctx);
+  if (ret == 0)
+    {
+      ctx = NULL;
+    }
+
+  return ret;
 }
 
 int dnn_runtime_initialize(dnn_runtime_t *rt, const nn_network_t *network)
@@ -228,6 +255,46 @@ int dnn_nuttx_mallinfo(dnn_mallinfo_t *info)
   info->total_bytes = mem.arena;
   info->used_bytes = mem.uordblks;
   info->largest_bytes = mem.mxordblk;
+  info->planned_bytes = 0;
 
   return 0;
 }
+
+#ifdef CONFIG_DNN_RT_PROFILE
+int dnn_set_profile(dnn_profile_t *profile)
+{
+  int ret = 0;
+
+  if (profile)
+    {
+      if (profile->records == NULL || profile->capacity == 0)
+        {
+          return -EINVAL;
+        }
+
+      profile->count = 0;
+      profile->forwards = 0;
+    }
+
+  /* The controller records into the ring. Before dnn_initialize() it is
+   * given the ring when it starts.
+   */
+
+  if (ctx)
+    {
+      ret = dnn_supervisor_send_msg(DNNRT_MSG_NRT_SET_PROFILE, 1, profile);
+      if (ret)
+        {
+          return ret;
+        }
+    }
+
+  s_dnn_profile = profile;
+  return 0;
+}
+
+dnn_profile_t *dnn_get_profile(void)
+{
+  return s_dnn_profile;
+}
+#endif /* CONFIG_DNN_RT_PROFILE */
@@ -41,6 +41,7 @@
 #include <string.h>
 
 #include <mpcomm/mpcomm.h>
+#include <utils/cyclecount.h>
 
 #include <nnablart/network.h>
 #include <nnablart/runtime.h>
@@ -49,6 +50,7 @@
 
 #include "dnn_controller.h"
 #include "dnn_exec_function.h"
+#include "runtime_profile.h"
 
 /****************************************************************************
  * Private Data
@@ -229,6 +231,32 @@ static int dnn_runtime_finalize(dnn_runtime_t *rt)
   return (int)rt_free_context((rt_context_pointer *)&(rt->impl_ctx));
 }
 
+static uint32_t dnn_profile_scratch_bsize(rt_function_t *f)
+{
+  if (f->exec_func == dnn_controller_exec_convolution)
+    {
+      return dnnrt_convolution_scratch_bsize(f);
+    }
+  else if (f->exec_func == dnn_controller_exec_affine)
+    {
+      return dnnrt_affine_scratch_bsize(f);
+    }
+
+  return 0;
+}
+
+static int dnn_set_profile(dnn_profile_t *profile)
+{
+  dnn_controller_context_t *ctx = dnn_controller_get_context();
+
+  /* The counter of this CPU, the application CPU enables its own */
+
+  cyclecount_enable();
+  ctx->profile = profile;
+
+  return 0;
+}
+
 static int dnn_runtime_forward(dnn_runtime_t *rt,
                                const void *inputs[],
                                unsigned char input_num)
@@ -251,6 +279,12 @@ static int dnn_runtime_forward(dnn_runtime_t *rt,
       c->variables[c->input_variable_ids[i]].data = (void *)inputs[i];
     }
 
+  dnn_profile_t *prof = dnn_controller_get_context()->profile;
+  if (prof)
+    {
+      return dnn_profile_forward(prof, c, dnn_profile_scratch_bsize);
+    }
+
   return (int)rt_forward(ctx);
 }
 
@@ -470,6 +504,10 @@ void dnn_controller_handle_msg(void *data)
                                            (unsigned char)dnn_msg->arg[1]);
         break;
 
+      case DNNRT_MSG_NRT_SET_PROFILE:
+        dnn_msg->ret = dnn_set_profile((dnn_profile_t *)dnn_msg->arg[0]);
+        break;
+
       default:
         dnn_msg->ret = -EINVAL;
         break;
@@ -68,6 +68,8 @@ typedef enum
   DNNRT_MSG_NRT_OUTPUT_SHAPE,
   DNNRT_MSG_NRT_OUTPUT_BUFFER,
   DNNRT_MSG_NRT_OUTPUT_VARIABLE,
+  DNNRT_MSG_NRT_ASMP_MALLINFO,
+  DNNRT_MSG_NRT_SET_PROFILE,
 } dnn_msg_id_t;
 
 typedef enum
@@ -75,6 +77,7 @@ typedef enum
   DNN_HELPER_MSG_INIT,
   DNN_HELPER_EXEC_AFFINE,
   DNN_HELPER_EXEC_CONVOLUTION,
+  DNN_HELPER_EXEC_CONVOLUTION_GROUPS,
 } dnn_helper_msg_id_t;
 
 typedef struct dnn_msg
@@ -84,12 +87,35 @@ typedef struct dnn_msg
   int ret;
 } dnn_msg_t;
 
+/* Same layout as dnn_profile_record_t and dnn_profile_t of
+ * dnnrt/runtime.h, the ring is given by the application.
+ */
+
+typedef struct dnn_profile_record
+{
+  uint32_t forward;
+  uint16_t index;
+  uint16_t type;
+  uint32_t cycles;
+  uint32_t scratch_bytes;
+  uint32_t output_bytes;
+} dnn_profile_record_t;
+
+typedef struct dnn_profile
+{
+  dnn_profile_record_t *records;
+  uint32_t capacity;
+  uint32_t count;
+  uint32_t forwards;
+} dnn_profile_t;
+
 typedef struct dnn_controller_context
 {
   uint8_t helpers_num;
   dnn_shared_chunk_t *chunks;
   dnn_vbuffer_alloc_info_t *alloc_info;
   void *helpers_exec_function[MAX_HELPERS_NUM];
+  dnn_profile_t *profile;
 } dnn_controller_context_t;
 
 /****************************************************************************
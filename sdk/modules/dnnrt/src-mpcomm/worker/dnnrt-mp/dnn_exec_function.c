@@ -38,7 +38,6 @@
  ****************************************************************************/
 
 #include <errno.h>
-#include <math.h>
 #include <string.h>
 
 #include <mpcomm/mpcomm.h>
@@ -66,6 +65,9 @@ static int controller_exec_function(rt_function_t *rt_func,
       case DNN_HELPER_EXEC_CONVOLUTION:
         dnnrt_exec_convolution(rt_func, begin, end);
         break;
+      case DNN_HELPER_EXEC_CONVOLUTION_GROUPS:
+        dnnrt_exec_convolution_groups(rt_func, begin, end);
+        break;
       default:
         break;
     }
@@ -81,29 +83,33 @@ static int exec_dnn_tasks(rt_function_t *rt_func,
   int i;
   dnn_msg_t dnn_msg[MAX_HELPERS_NUM];
 
-  for (i = 0; i < task_num; ++i)
+  /* helpers take the first tasks and the controller takes the last one.
+   * helpers without a task are left idle, they are already done for
+   * mpcomm_wait_helpers_done().
+   */
+
+  for (i = 0; i < task_num - 1; ++i)
     {
-      if (i < mpcomm_get_helpers_num())
-        {
-          dnn_msg[i].id = func_type;
-          dnn_msg[i].arg[0] = (int)rt_func;
-          dnn_msg[i].arg[1] = tasks[i].begin;
-          dnn_msg[i].arg[2] = tasks[i].end;
-          mpcomm_send_helper(i, MEM_V2P(&dnn_msg[i]));
-        }
-      else
-        {
-          controller_exec_function(rt_func, func_type,
-                                   tasks[i].begin,
-                                   tasks[i].end);
-        }
+      dnn_msg[i].id = func_type;
+      dnn_msg[i].arg[0] = (int)rt_func;
+      dnn_msg[i].arg[1] = tasks[i].begin;
+      dnn_msg[i].arg[2] = tasks[i].end;
+      mpcomm_send_helper(i, MEM_V2P(&dnn_msg[i]));
     }
 
+  controller_exec_function(rt_func, func_type,
+                           tasks[task_num - 1].begin,
+                           tasks[task_num - 1].end);
+
   mpcomm_wait_helpers_done();
 
   return 0;
 }
 
+/* split [0, total) into at most task_num tasks whose sizes differ by one
+ * at most, and return the number of tasks.
+ */
+
 static int split_load(int total, dnn_task_t *tasks, int task_num)
 {
   if (total <= 0)
@@ -111,25 +117,24 @@ static int split_load(int total, dnn_task_t *tasks, int task_num)
       return -EINVAL;
     }
 
-  int load = (int)ceilf((float)total / task_num);
+  if (task_num > total)
+    {
+      task_num = total;
+    }
+
+  int load = total / task_num;
+  int remain = total % task_num;
   int i;
   int offset = 0;
 
-  memset(tasks, 0, sizeof(dnn_task_t) * task_num);
-
   for (i = 0; i < task_num; ++i)
     {
       tasks[i].begin = offset;
-      offset += load;
+      offset += load + (i < remain ? 1 : 0);
       tasks[i].end = offset;
-
-      if ((total - offset) < load)
-        {
-          load = total - offset;
-        }
     }
 
-  return 0;
+  return task_num;
 }
 
 static int var_buf_size(rt_variable_t *var)
@@ -168,8 +173,12 @@ rt_function_error_t dnn_controller_exec_affine(rt_function_t *f)
   memset(p->output->data, 0, var_buf_size(p->output));
 
   dnn_task_t tasks[MAX_HELPERS_NUM + 1];
-  int task_num = mpcomm_get_helpers_num() + 1;
-  split_load(p->output_loop_size, tasks, task_num);
+  int task_num = split_load(p->output_loop_size, tasks,
+                            mpcomm_get_helpers_num() + 1);
+  if (task_num < 0)
+    {
+      return RT_FUNCTION_ERROR_NOERROR;
+    }
 
   return exec_dnn_tasks(f, DNN_HELPER_EXEC_AFFINE, tasks, task_num);
 }
@@ -182,9 +191,31 @@ rt_function_error_t dnn_controller_exec_convolution(rt_function_t *f)
 
   memset(p->out_var.v->data, 0, var_buf_size(p->out_var.v));
 
+  /* split output channels of each group, or groups if there are more
+   * groups than channels in a group, such as depthwise convolution.
+   */
+
   dnn_task_t tasks[MAX_HELPERS_NUM + 1];
-  int task_num = mpcomm_get_helpers_num() + 1;
-  split_load(p->out_var.shape.data[I], tasks, task_num);
+  int channels = p->out_var.shape.data[I];
+  int task_num;
+
+  if (c->group > channels)
+    {
+      task_num = split_load(c->group, tasks, mpcomm_get_helpers_num() + 1);
+      if (task_num < 0)
+        {
+          return RT_FUNCTION_ERROR_NOERROR;
+        }
+
+      return exec_dnn_tasks(f, DNN_HELPER_EXEC_CONVOLUTION_GROUPS, tasks,
+                            task_num);
+    }
+
+  task_num = split_load(channels, tasks, mpcomm_get_helpers_num() + 1);
+  if (task_num < 0)
+    {
+      return RT_FUNCTION_ERROR_NOERROR;
+    }
 
   return exec_dnn_tasks(f, DNN_HELPER_EXEC_CONVOLUTION, tasks, task_num);
 }
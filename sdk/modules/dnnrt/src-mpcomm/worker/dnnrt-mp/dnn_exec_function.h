@@ -59,6 +59,8 @@ typedef struct dnn_task
 
 rt_function_error_t dnnrt_exec_convolution(rt_function_t *f,
                                            int begin, int end);
+rt_function_error_t dnnrt_exec_convolution_groups(rt_function_t *f,
+                                                  int begin, int end);
 rt_function_error_t dnnrt_exec_affine(rt_function_t *f, int begin, int end);
 rt_function_error_t dnn_controller_exec_affine(rt_function_t *f);
 rt_function_error_t dnn_controller_exec_convolution(rt_function_t *f);
@@ -66,5 +68,7 @@ rt_return_value_t dnnrt_affine_alloc(nn_network_t *net,
                                      void *function_context);
 rt_return_value_t dnnrt_convolution_alloc(nn_network_t *net,
                                           void *function_context);
+int dnnrt_affine_scratch_bsize(rt_function_t *f);
+int dnnrt_convolution_scratch_bsize(rt_function_t *f);
 
 #endif /* _DNNRT_MPCOMM_WORKER_DNN_EXEC_FUNCTION_H_ */
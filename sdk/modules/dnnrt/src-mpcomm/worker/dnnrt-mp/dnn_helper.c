@@ -67,6 +67,12 @@ static int dnn_helper_exec_convolution(rt_function_t *f, int begin, int end)
   return dnnrt_exec_convolution(f, begin, end);
 }
 
+static int dnn_helper_exec_convolution_groups(rt_function_t *f,
+                                              int begin, int end)
+{
+  return dnnrt_exec_convolution_groups(f, begin, end);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -90,6 +96,12 @@ void dnn_helper_handle_msg(void *data)
           dnn_helper_exec_convolution((rt_function_t *)dnn_msg->arg[0],
                                       dnn_msg->arg[1], dnn_msg->arg[2]);
         break;
+      case DNN_HELPER_EXEC_CONVOLUTION_GROUPS:
+        dnn_msg->ret =
+          dnn_helper_exec_convolution_groups((rt_function_t *)dnn_msg->arg[0],
+                                             dnn_msg->arg[1],
+                                             dnn_msg->arg[2]);
+        break;
       default:
         dnn_msg->ret = -EINVAL;
         break;
@@ -326,6 +326,12 @@ rt_return_value_t dnnrt_affine_alloc(nn_network_t *net,
   rt_function_t *f = (rt_function_t *)(&func->func);
   f->exec_func = dnn_controller_exec_affine;
 
+  dnn_scratch_buffer_request_size(dnnrt_affine_scratch_bsize(f));
+  return RT_RET_FUNCTION_MATCH;
+}
+
+int dnnrt_affine_scratch_bsize(rt_function_t *f)
+{
   int scratch_buf_bsize = 0;
   if ((f->inputs[X]->type == f->inputs[WEIGHT]->type) &&
       (f->inputs[X]->type == f->inputs[BIAS]->type) &&
@@ -338,6 +344,5 @@ rt_return_value_t dnnrt_affine_alloc(nn_network_t *net,
       scratch_buf_bsize = sizeof(q15_t) * p->input_loop_size;
     }
 
-  dnn_scratch_buffer_request_size(scratch_buf_bsize);
-  return RT_RET_FUNCTION_MATCH;
+  return scratch_buf_bsize;
 }
@@ -97,6 +97,8 @@ static inline void var_setpos(var_t *var, int *pos, int size)
 }
 
 static rt_function_error_t dnnrt_exec_convolution_fixed(rt_function_t *f,
+                                                        int g_begin,
+                                                        int g_end,
                                                         int begin, int end)
 {
   convolution_local_context_t *c =
@@ -117,7 +119,7 @@ static rt_function_error_t dnnrt_exec_convolution_fixed(rt_function_t *f,
 
   for (b = 0; b < p->in_var.shape.data[0]; ++b)
     {
-      for (g = 0; g < c->group; ++g)
+      for (g = g_begin; g < g_end; ++g)
         {
           if (fixed16)
             {
@@ -208,6 +210,8 @@ static rt_function_error_t dnnrt_exec_convolution_fixed(rt_function_t *f,
 }
 
 static rt_function_error_t dnnrt_exec_convolution_float(rt_function_t *f,
+                                                        int g_begin,
+                                                        int g_end,
                                                         int begin, int end)
 {
   convolution_local_context_t *c =
@@ -215,7 +219,6 @@ static rt_function_error_t dnnrt_exec_convolution_float(rt_function_t *f,
   convolution_private_t ctx_copy;
   ctx_copy = *(convolution_private_t *)(c->data);
   convolution_private_t *p = &ctx_copy;
-  nn_size_t group = c->group;
   nn_size_t batch_size = p->in_var.shape.data[0];
   nn_size_t g, b;
   var_t *out_var = &p->out_var;
@@ -226,7 +229,7 @@ static rt_function_error_t dnnrt_exec_convolution_float(rt_function_t *f,
 
   for (b = 0; b < batch_size; ++b)
     {
-      for (g = 0; g < group; ++g)
+      for (g = g_begin; g < g_end; ++g)
         {
           int i_pos[] = {b, g, 0};
           var_setpos(in_var, i_pos, _S(i_pos));
@@ -269,19 +272,45 @@ static rt_function_error_t dnnrt_exec_convolution_float(rt_function_t *f,
   return RT_FUNCTION_ERROR_NOERROR;
 }
 
-rt_function_error_t dnnrt_exec_convolution(rt_function_t *f,
-                                           int begin, int end)
+static rt_function_error_t dnnrt_exec_convolution_range(rt_function_t *f,
+                                                        int g_begin,
+                                                        int g_end,
+                                                        int begin, int end)
 {
   if (f->inputs[X]->type == NN_DATA_TYPE_FLOAT)
     {
-      return dnnrt_exec_convolution_float(f, begin, end);
+      return dnnrt_exec_convolution_float(f, g_begin, g_end, begin, end);
     }
   else
     {
-      return dnnrt_exec_convolution_fixed(f, begin, end);
+      return dnnrt_exec_convolution_fixed(f, g_begin, g_end, begin, end);
     }
 }
 
+/* compute output channels [begin, end) of every group */
+
+rt_function_error_t dnnrt_exec_convolution(rt_function_t *f,
+                                           int begin, int end)
+{
+  convolution_local_context_t *c =
+      (convolution_local_context_t *)f->local_context;
+
+  return dnnrt_exec_convolution_range(f, 0, c->group, begin, end);
+}
+
+/* compute every output channel of groups [begin, end) */
+
+rt_function_error_t dnnrt_exec_convolution_groups(rt_function_t *f,
+                                                  int begin, int end)
+{
+  convolution_local_context_t *c =
+      (convolution_local_context_t *)f->local_context;
+  convolution_private_t *p = (convolution_private_t *)(c->data);
+
+  return dnnrt_exec_convolution_range(f, begin, end, 0,
+                                      p->out_var.shape.data[I]);
+}
+
 static inline int validate_params(rt_function_t *f, int *scratch_buf_bsize)
 {
   convolution_local_context_t *c;
@@ -357,3 +386,11 @@ rt_return_value_t dnnrt_convolution_alloc(nn_network_t *net,
   dnn_scratch_buffer_request_size(scratch_buf_bsize);
   return RT_RET_FUNCTION_MATCH;
 }
+
+int dnnrt_convolution_scratch_bsize(rt_function_t *f)
+{
+  int scratch_buf_bsize = 0;
+
+  validate_params(f, &scratch_buf_bsize);
+  return scratch_buf_bsize;
+}
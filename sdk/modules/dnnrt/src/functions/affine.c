@@ -318,6 +318,12 @@ rt_return_value_t dnnrt_affine_alloc(nn_network_t * net, void *function_context)
   rt_function_t *f = (rt_function_t *) (&func->func);
   f->exec_func = dnnrt_exec_affine;
 
+  dnn_req_scratch_buf(dnnrt_affine_scratch_bsize(f));
+  return RT_RET_FUNCTION_MATCH;
+}
+
+int dnnrt_affine_scratch_bsize(rt_function_t * f)
+{
   int scratch_buf_bsize = 0;
   if ((f->inputs[X]->type == f->inputs[WEIGHT]->type) &&
       (f->inputs[X]->type == f->inputs[BIAS]->type) &&
@@ -330,6 +336,5 @@ rt_return_value_t dnnrt_affine_alloc(nn_network_t * net, void *function_context)
       scratch_buf_bsize = sizeof(q15_t) * p->input_loop_size;
     }
 
-  dnn_req_scratch_buf(scratch_buf_bsize);
-  return RT_RET_FUNCTION_MATCH;
+  return scratch_buf_bsize;
 }
@@ -362,3 +362,11 @@ dnnrt_convolution_alloc(nn_network_t * net, void *function_context)
   dnn_req_scratch_buf(scratch_buf_bsize);
   return RT_RET_FUNCTION_MATCH;
 }
+
+int dnnrt_convolution_scratch_bsize(rt_function_t * f)
+{
+  int scratch_buf_bsize = 0;
+
+  validate_params(f, &scratch_buf_bsize);
+  return scratch_buf_bsize;
+}
@@ -84,6 +84,11 @@ extern "C"
   {
     size_t bsize_list[MAX_VBUFFER_NUM]; /* size of each variable buffer in bytes */
     void *addr_list[MAX_VBUFFER_NUM];   /* address of pre-allocated buffer */
+#  ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+    size_t offset_list[MAX_VBUFFER_NUM]; /* offset of each variable buffer
+                                          * in the planned area */
+#  endif
+    size_t planned_bsize;       /* size of all the variable buffers */
     size_t vbuffer_num;         /* length of bsize_list/addr_list */
     uint8_t actual_alloc_count; /* how many times to allocate a shared_chunk to
                                  * variable buffers in rt_initialize_context() */
@@ -96,6 +101,8 @@ extern "C"
     int scratch_buf_bsize;
     void *scratch_buf;
     dnn_shared_chunk_t *chunks;
+    size_t planned_bsize;       /* largest planned_bsize of
+                                 * initialized runtimes */
     dnn_vbuffer_alloc_info_t *alloc_info;       /* allocation info of current
                                                  * network. the alloc_info is
                                                  * placed on stack of
@@ -113,6 +120,8 @@ extern "C"
                                        void *function_context);
   rt_return_value_t dnnrt_convolution_alloc(nn_network_t * net,
                                             void *function_context);
+  int dnnrt_affine_scratch_bsize(rt_function_t * f);
+  int dnnrt_convolution_scratch_bsize(rt_function_t * f);
 
   void dnn_req_scratch_buf(int size);
   void *dnn_scratch_buf(void);
@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <dnnrt/runtime.h>
+#include <utils/cyclecount.h>
 
 /* header inclusion under $(SDKDIR)/../externals/nnabla-c-runtime/include */
 #include "nnablart/runtime.h"
@@ -47,6 +48,29 @@
 
 static struct dnn_global_context s_dnn_gctx;
 
+#ifdef CONFIG_DNN_RT_PROFILE
+#include "runtime_profile.h"
+
+static dnn_profile_t *s_dnn_profile;
+
+static uint32_t dnn_profile_scratch_bsize(rt_function_t * f)
+{
+  if (f->exec_func == dnnrt_exec_convolution)
+    {
+      return dnnrt_convolution_scratch_bsize(f);
+    }
+  else if (f->exec_func == dnnrt_exec_affine)
+    {
+      return dnnrt_affine_scratch_bsize(f);
+    }
+
+  /* functions of nnabla-c-runtime do not use the shared scratch buffer */
+
+  return 0;
+}
+
+#endif /* CONFIG_DNN_RT_PROFILE */
+
 int dnn_initialize(dnn_config_t * config)
 {
   if (config != NULL && config->cpu_num != 1u)
@@ -137,6 +161,10 @@ int dnn_runtime_initialize(dnn_runtime_t * rt, const nn_network_t * network)
       s_dnn_gctx.scratch_buf = tmp_buf;
       s_dnn_gctx.scratch_buf_bsize = s_dnn_gctx.req_scratch_buf_bsize;
     }
+  if (alloc_info.planned_bsize > s_dnn_gctx.planned_bsize)
+    {
+      s_dnn_gctx.planned_bsize = alloc_info.planned_bsize;
+    }
   ++s_dnn_gctx.rt_count;
 
   return RT_RET_NOERROR;
@@ -162,6 +190,7 @@ int dnn_runtime_finalize(dnn_runtime_t * rt)
       s_dnn_gctx.scratch_buf = NULL;
       s_dnn_gctx.scratch_buf_bsize = 0;
       s_dnn_gctx.req_scratch_buf_bsize = 0;
+      s_dnn_gctx.planned_bsize = 0;
     }
 
   return (int)rt_free_context((rt_context_pointer *) & (rt->impl_ctx));
@@ -183,6 +212,14 @@ int dnn_runtime_forward(dnn_runtime_t * rt, const void *inputs[],
       c->variables[c->input_variable_ids[i]].data = (void *)inputs[i];
     }
 
+#ifdef CONFIG_DNN_RT_PROFILE
+  dnn_profile_t *prof = s_dnn_profile;
+  if (prof)
+    {
+      return dnn_profile_forward(prof, c, dnn_profile_scratch_bsize);
+    }
+#endif
+
   return (int)rt_forward(ctx);
 }
 
@@ -298,6 +335,33 @@ int dnn_nuttx_mallinfo(dnn_mallinfo_t * info)
   info->total_bytes = mem.arena;
   info->used_bytes = mem.uordblks;
   info->largest_bytes = mem.mxordblk;
+  info->planned_bytes = s_dnn_gctx.planned_bsize;
 
   return RT_RET_NOERROR;;
 }
+
+#ifdef CONFIG_DNN_RT_PROFILE
+int dnn_set_profile(dnn_profile_t * profile)
+{
+  if (profile)
+    {
+      if (profile->records == NULL || profile->capacity == 0)
+        {
+          return -EINVAL;
+        }
+
+      profile->count = 0;
+      profile->forwards = 0;
+
+      cyclecount_enable();
+    }
+
+  s_dnn_profile = profile;
+  return RT_RET_NOERROR;
+}
+
+dnn_profile_t *dnn_get_profile(void)
+{
+  return s_dnn_profile;
+}
+#endif /* CONFIG_DNN_RT_PROFILE */
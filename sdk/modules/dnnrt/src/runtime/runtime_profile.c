@@ -0,0 +1,84 @@
+/****************************************************************************
+ * modules/dnnrt/src/runtime/runtime_profile.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <dnnrt/runtime.h>
+
+#ifdef CONFIG_DNN_RT_PROFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Same for the nnabla runtime and the MPCOMM runtime client, the ring is
+ * in the memory of the application.
+ */
+
+int dnn_profile_export_csv(const dnn_profile_t *profile, FILE *stream)
+{
+  const dnn_profile_record_t *rec;
+  uint32_t num;
+  uint32_t i;
+
+  if (!profile || !stream)
+    {
+      return -EINVAL;
+    }
+
+  num = profile->count < profile->capacity ?
+    profile->count : profile->capacity;
+
+  fprintf(stream, "forward,index,type,cycles,scratch_bytes,output_bytes\n");
+  for (i = profile->count - num; i != profile->count; i++)
+    {
+      rec = &profile->records[i % profile->capacity];
+      fprintf(stream, "%lu,%u,%u,%lu,%lu,%lu\n",
+              (unsigned long)rec->forward, rec->index, rec->type,
+              (unsigned long)rec->cycles,
+              (unsigned long)rec->scratch_bytes,
+              (unsigned long)rec->output_bytes);
+    }
+
+  return (int)num;
+}
+
+#endif /* CONFIG_DNN_RT_PROFILE */
@@ -0,0 +1,140 @@
+/****************************************************************************
+ * modules/dnnrt/src/runtime/runtime_profile.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Profiled forward propagation, shared by the nnabla runtime and the
+ * controller of the MPCOMM worker. The including file provides
+ * dnn_profile_t and dnn_profile_record_t, from dnnrt/runtime.h or, on the
+ * worker, from dnn_controller.h, and the context of nnabla-c-runtime.
+ */
+
+#ifndef RUNTIME_PROFILE_H
+#  define RUNTIME_PROFILE_H
+
+#  include <errno.h>
+#  include <stdint.h>
+#  include <utils/cyclecount.h>
+
+#  include <nnablart/runtime.h>
+#  include "context.h"
+
+/* Scratch buffer used by a function, which depends on how the runtime
+ * executes it.
+ */
+
+typedef uint32_t (*dnn_profile_scratch_bsize_t)(rt_function_t * f);
+
+static inline uint32_t dnn_profile_output_bsize(rt_function_t * f)
+{
+  uint32_t bsize = 0;
+  uint32_t size;
+  int i;
+  int j;
+
+  for (i = 0; i < f->num_of_outputs; i++)
+    {
+      rt_variable_t *v = f->outputs[i];
+
+      size = 1;
+      for (j = 0; j < v->shape.size; j++)
+        {
+          size *= v->shape.data[j];
+        }
+
+      switch (v->type)
+        {
+        case NN_DATA_TYPE_FLOAT:
+          bsize += size * sizeof(float);
+          break;
+        case NN_DATA_TYPE_INT16:
+          bsize += size * sizeof(int16_t);
+          break;
+        case NN_DATA_TYPE_INT8:
+          bsize += size;
+          break;
+        default:
+          /* NN_DATA_TYPE_SIGN packs 8 elements in a byte */
+
+          bsize += (size + 7) / 8;
+          break;
+        }
+    }
+
+  return bsize;
+}
+
+/* Same loop as rt_forward() with every function timed. The sizes are
+ * computed after the cycle counter is read so they do not add to it.
+ * On the worker, a function split across the helpers is timed until the
+ * last helper is done.
+ */
+
+static inline int dnn_profile_forward(dnn_profile_t * prof, rt_context_t * c,
+                                      dnn_profile_scratch_bsize_t scratch)
+{
+  rt_function_context_t *func;
+  dnn_profile_record_t *rec;
+  rt_function_error_t ret;
+  uint32_t start;
+  uint32_t cycles;
+  int i;
+
+  prof->forwards++;
+  for (i = 0; i < c->num_of_functions; i++)
+    {
+      func = &c->functions[i];
+
+      start = cyclecount_get();
+      ret = func->func.exec_func(&func->func);
+      cycles = cyclecount_get() - start;
+
+      rec = &prof->records[prof->count % prof->capacity];
+      rec->forward = prof->forwards;
+      rec->index = i;
+      rec->type = func->info->type;
+      rec->cycles = cycles;
+      rec->scratch_bytes = scratch(&func->func);
+      rec->output_bytes = dnn_profile_output_bsize(&func->func);
+      prof->count++;
+
+      if (ret != RT_FUNCTION_ERROR_NOERROR)
+        {
+          return -EPERM;
+        }
+    }
+
+  return RT_RET_NOERROR;
+}
+
+#endif                          /* RUNTIME_PROFILE_H */
@@ -122,6 +122,121 @@ void dnn_variable_free(void *p)
     }
 }
 
+#ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+static int dnn_vbuffer_index(const nn_network_t * n, int variable_id)
+{
+  int *list = (int *)NN_GET(n, n->variables.list);
+  nn_variable_t *v = (nn_variable_t *) NN_GET(n, list[variable_id]);
+
+  /* negative data_index refers to a variable buffer */
+  return v->data_index < 0 ? -1 * v->data_index - 1 : -1;
+}
+
+static void dnn_vbuffer_update_lifetime(const nn_network_t * n,
+                                        const nn_list_t * variables,
+                                        int step, int *first, int *last)
+{
+  int *list = (int *)NN_GET(n, variables->list);
+
+  for (int i = 0; i < variables->size; i++)
+    {
+      int idx = dnn_vbuffer_index(n, list[i]);
+      if (idx >= 0 && idx < n->buffers.size)
+        {
+          first[idx] = step < first[idx] ? step : first[idx];
+          last[idx] = step > last[idx] ? step : last[idx];
+        }
+    }
+}
+
+/*
+ * determine offsets of variable buffers in a single area, so that buffers
+ * which are never live at the same time overlap each other.
+ *  1. find the first and the last function which refer each buffer.
+ *     network inputs are live from the beginning since they may be filled
+ *     through dnn_input_buffer() before forward propagation, and outputs
+ *     are live until the end since they are read after it.
+ *  2. place buffers in descending order of size at the lowest offset
+ *     which doesn't collide with already placed buffers live at the same
+ *     time (greedy-by-size).
+ */
+static void dnn_plan_vbuffers(const nn_network_t * n,
+                              dnn_vbuffer_alloc_info_t * alloc_info)
+{
+  int first[MAX_VBUFFER_NUM];
+  int last[MAX_VBUFFER_NUM];
+  uint8_t order[MAX_VBUFFER_NUM];
+  int *list = (int *)NN_GET(n, n->functions.list);
+  int num = alloc_info->vbuffer_num;
+  int end = n->functions.size;
+  int i, j, k;
+
+  // step 1
+  for (i = 0; i < num; i++)
+    {
+      first[i] = INT_MAX;
+      last[i] = -1;
+    }
+
+  for (i = 0; i < end; i++)
+    {
+      nn_function_t *f = (nn_function_t *) NN_GET(n, list[i]);
+      dnn_vbuffer_update_lifetime(n, &f->inputs, i, first, last);
+      dnn_vbuffer_update_lifetime(n, &f->outputs, i, first, last);
+    }
+
+  dnn_vbuffer_update_lifetime(n, &n->inputs, -1, first, last);
+  dnn_vbuffer_update_lifetime(n, &n->outputs, end, first, last);
+
+  // step 2
+  for (i = 0; i < num; i++)
+    {
+      if (last[i] < first[i])
+        {
+          /* not referred by any function, keep it for the whole run */
+          first[i] = -1;
+          last[i] = end;
+        }
+
+      for (j = i; j > 0 && alloc_info->bsize_list[order[j - 1]] <
+           alloc_info->bsize_list[i]; j--)
+        {
+          order[j] = order[j - 1];
+        }
+      order[j] = i;
+    }
+
+  alloc_info->planned_bsize = 0u;
+  for (k = 0; k < num; k++)
+    {
+      size_t bsize = round_up(alloc_info->bsize_list[order[k]], 4u);
+      size_t offset = 0u;
+
+      i = order[k];
+      for (j = 0; j < k; j++)
+        {
+          int p = order[j];
+          size_t p_end = alloc_info->offset_list[p] +
+                         round_up(alloc_info->bsize_list[p], 4u);
+
+          if (first[i] <= last[p] && first[p] <= last[i] &&
+              offset < p_end && alloc_info->offset_list[p] < offset + bsize)
+            {
+              /* collided, retry just after the placed buffer */
+              offset = p_end;
+              j = -1;
+            }
+        }
+
+      alloc_info->offset_list[i] = offset;
+      if (offset + bsize > alloc_info->planned_bsize)
+        {
+          alloc_info->planned_bsize = offset + bsize;
+        }
+    }
+}
+#endif
+
 int dnn_peek_vbuffers(const nn_network_t * n,
                       dnn_vbuffer_alloc_info_t * alloc_info)
 {
@@ -146,8 +261,13 @@ int dnn_peek_vbuffers(const nn_network_t * n,
         {
           alloc_info->bsize_list[i] = *(list + i) * sizeof(float);
         }
+      alloc_info->planned_bsize += round_up(alloc_info->bsize_list[i], 4u);
     }
 
+#ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+  dnn_plan_vbuffers(n, alloc_info);
+#endif
+
   return RT_RET_NOERROR;
 }
 
@@ -179,6 +299,7 @@ static inline
   return ret;
 }
 
+#ifndef CONFIG_DNN_RT_VBUFFER_PLANNER
 static
   size_t dnn_vbuffer_alloc_info_remaining_bsize(dnn_vbuffer_alloc_info_t * info)
 {
@@ -192,16 +313,17 @@ static
     }
   return ret;
 }
+#endif
 
 static inline
   dnn_shared_chunk_t * dnn_create_chunk(dnn_global_context_t * ctx,
-                                        dnn_vbuffer_alloc_info_t * alloc_info)
+                                        size_t data_bsize)
 {
   /* reserve memory for new_chunk */
   dnn_shared_chunk_t *new_chunk = NULL, *last;
   size_t chunk_bsize = 0u;
   chunk_bsize += sizeof(dnn_shared_chunk_t);
-  chunk_bsize += dnn_vbuffer_alloc_info_remaining_bsize(alloc_info);
+  chunk_bsize += data_bsize;
   chunk_bsize += (4u - 1u);     // padding to 4-byte align new_chunk->data
   new_chunk = (dnn_shared_chunk_t *) malloc(chunk_bsize);
   if (new_chunk != NULL)
@@ -259,6 +381,52 @@ void dnn_deallocate_chunks(dnn_global_context_t * ctx,
  *  3. slice the new single shared_chunk and allocate sliced pieces to
  *     variable buffers which didn't fit in existing shared_chunk in 1
  */
+#ifdef CONFIG_DNN_RT_VBUFFER_PLANNER
+/*
+ * allocate the area planned by dnn_plan_vbuffers() from the first
+ * shared_chunk which can accommodate it or from a new shared_chunk,
+ * and store the address of each variable buffer in the area into
+ * dnn_vbuffer_alloc_info_t::addr_list.
+ */
+int dnn_preallocate_chunks(dnn_global_context_t * ctx,
+                           dnn_vbuffer_alloc_info_t * alloc_info)
+{
+  dnn_shared_chunk_t *chunk;
+  void *area;
+
+  if (alloc_info->planned_bsize == 0u)
+    {
+      return RT_RET_NOERROR;
+    }
+
+  for (chunk = ctx->chunks; chunk != NULL; chunk = chunk->next)
+    {
+      if (dnn_shared_chunk_accommodate(chunk, alloc_info->planned_bsize))
+        {
+          break;
+        }
+    }
+
+  if (chunk == NULL)
+    {
+      chunk = dnn_create_chunk(ctx, alloc_info->planned_bsize);
+      if (chunk == NULL)
+        {
+          dnn_err("no enough memory to create variable buffer\n");
+          return -ENOMEM;
+        }
+    }
+
+  area = chunk->data + chunk->used_bsize;
+  chunk->used_bsize += alloc_info->planned_bsize;
+  for (uint8_t idx = 0; idx < alloc_info->vbuffer_num; idx++)
+    {
+      alloc_info->addr_list[idx] = area + alloc_info->offset_list[idx];
+    }
+
+  return RT_RET_NOERROR;
+}
+#else
 int dnn_preallocate_chunks(dnn_global_context_t * ctx,
                            dnn_vbuffer_alloc_info_t * alloc_info)
 {
@@ -281,7 +449,9 @@ int dnn_preallocate_chunks(dnn_global_context_t * ctx,
   /* count the total size of variable buffers that preallocation is NOT done */
   if (dnn_vbuffer_alloc_info_remaining_bsize(alloc_info) != 0u)
     {
-      new_chunk = dnn_create_chunk(ctx, alloc_info);    // step 2
+      new_chunk = dnn_create_chunk(ctx,
+                                   dnn_vbuffer_alloc_info_remaining_bsize
+                                   (alloc_info));       // step 2
       if (new_chunk != NULL)
         {
           // step 3
@@ -303,3 +473,4 @@ int dnn_preallocate_chunks(dnn_global_context_t * ctx,
 
   return ret;
 }
+#endif
@@ -80,6 +80,35 @@ typedef struct mpmq
   uint32_t    flags;            /**< Flags */
 } mpmq_t;
 
+/**
+ * @typedef mpmq_ringhdr_t
+ * Shared part of MP message ring, placed at the start of the ring memory
+ */
+
+typedef struct mpmq_ringhdr
+{
+  volatile uint32_t head;       /**< Bytes written, owned by the sender */
+  volatile uint32_t tail;       /**< Bytes read, owned by the receiver */
+  volatile uint32_t wait;       /**< Doorbell requests, owned by the receiver */
+  volatile uint32_t woken;      /**< Doorbells taken, owned by the receiver */
+} mpmq_ringhdr_t;
+
+/**
+ * @typedef mpmq_ring_t
+ * MP message ring object, one per side and direction
+ */
+
+typedef struct mpmq_ring
+{
+  mpmq_t         *mq;           /**< Message queue for the doorbell */
+  mpmq_ringhdr_t *hdr;          /**< Shared header */
+  uint8_t        *data;         /**< Record area */
+  uint32_t        size;         /**< Size of record area (power of 2) */
+  int8_t          doorbell;     /**< Doorbell message ID */
+  uint32_t        rung;         /**< Request of the last doorbell (sender) */
+  uint32_t        sent;         /**< Doorbells sent (sender) */
+} mpmq_ring_t;
+
 /** @} mpmq_datatypes */
 
 #ifdef __cplusplus
@@ -237,6 +266,112 @@ int mpmq_tryreceive(mpmq_t *mq, uint32_t *data);
 
 int mpmq_notify(mpmq_t *mq, int signo, void *sigdata);
 
+/**
+ * Initialize MP message ring
+ *
+ * MP message ring carries variable size messages in shared memory from one
+ * sender to one receiver. The CPU FIFO is only used for a doorbell message
+ * sent through @a mq when the receiver waits in mpmq_ring_receive(), so a
+ * burst of messages costs a single FIFO interrupt and a receiver which polls
+ * with mpmq_ring_tryreceive() costs none. For both directions use two
+ * rings.
+ *
+ * Both sides call mpmq_ring_init() with the same memory (e.g. attached
+ * mpshm) and size. The memory must be zero filled before either side uses
+ * the ring. While a task waits in mpmq_ring_receive(), @a mq must not carry
+ * other messages to it.
+ *
+ * @param [in,out] ring: MP message ring object
+ * @param [in] mq: MP message queue for the doorbell
+ * @param [in] doorbell: Doorbell message ID (0-127)
+ * @param [in] mem: Shared memory for the ring, 4 bytes aligned
+ * @param [in] size: Size of @a mem
+ *
+ * @return On success, mpmq_ring_init() returns 0. On error, it returns an
+ * error number.
+ * @retval -EINVAL: Invalid argument
+ */
+
+int mpmq_ring_init(mpmq_ring_t *ring, mpmq_t *mq, int8_t doorbell,
+                   void *mem, size_t size);
+
+/**
+ * Try send message via MP message ring
+ *
+ * @param [in,out] ring: MP message ring object
+ * @param [in] msgid: User defined message ID (0-127)
+ * @param [in] buf: Message payload, may be NULL if @a len is 0
+ * @param [in] len: Payload size, up to 65535 and with the 4 bytes record
+ * header up to half of the ring size
+ *
+ * mpmq_ring_trysend() never waits for the CPU FIFO. If the doorbell doesn't
+ * fit in it, the message is sent anyway and the doorbell is retried by the
+ * next mpmq_ring_trysend() or by mpmq_ring_flush(). A sender which may stop
+ * sending while the CPU FIFO is full should call mpmq_ring_flush() until it
+ * returns 0.
+ *
+ * @return On success, mpmq_ring_trysend() returns 0. On error, it returns
+ * an error number.
+ * @retval -EINVAL: Invalid argument or message too large for the ring
+ * @retval -EAGAIN: Not enough space in the ring now
+ */
+
+int mpmq_ring_trysend(mpmq_ring_t *ring, int8_t msgid, const void *buf,
+                      size_t len);
+
+/**
+ * Send pending doorbell of MP message ring
+ *
+ * @param [in,out] ring: MP message ring object
+ *
+ * @return On success, mpmq_ring_flush() returns 0, no doorbell is pending.
+ * On error, it returns an error number.
+ * @retval -EINVAL: Invalid argument
+ * @retval -EAGAIN: The CPU FIFO is still full
+ */
+
+int mpmq_ring_flush(mpmq_ring_t *ring);
+
+/**
+ * Receive message via MP message ring
+ *
+ * Wait for the doorbell when the ring is empty.
+ *
+ * @param [in,out] ring: MP message ring object
+ * @param [out] buf: Message payload
+ * @param [in,out] len: Size of @a buf on input, payload size on output
+ *
+ * @return On success, mpmq_ring_receive() returns message ID. On error, it
+ * returns an error number.
+ * @retval -EINVAL: Invalid argument
+ * @retval -EMSGSIZE: @a buf is too small, the message stays in the ring and
+ * @a len is set to its size
+ */
+
+int mpmq_ring_receive(mpmq_ring_t *ring, void *buf, size_t *len);
+
+/**
+ * Try receive message via MP message ring
+ *
+ * mpmq_ring_tryreceive() doesn't ask for a doorbell, so polling leaves
+ * nothing in @a mq. A doorbell that arrives after mpmq_ring_receive()
+ * found a message without waiting is taken by the next wait in
+ * mpmq_ring_receive(), which then looks at the ring again.
+ *
+ * @param [in,out] ring: MP message ring object
+ * @param [out] buf: Message payload
+ * @param [in,out] len: Size of @a buf on input, payload size on output
+ *
+ * @return On success, mpmq_ring_tryreceive() returns message ID. On error,
+ * it returns an error number.
+ * @retval -EINVAL: Invalid argument
+ * @retval -EAGAIN: Try again when data hasn't come
+ * @retval -EMSGSIZE: @a buf is too small, the message stays in the ring and
+ * @a len is set to its size
+ */
+
+int mpmq_ring_tryreceive(mpmq_ring_t *ring, void *buf, size_t *len);
+
 /** @} mpmq_funcs */
 
 #undef EXTERN
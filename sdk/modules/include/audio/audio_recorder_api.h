@@ -155,6 +155,10 @@ typedef enum
   /*! \brief RAM */
 
   AS_SETRECDR_STS_OUTPUTDEVICE_RAM,
+
+  /*! \brief File, written in the background by the recorder */
+
+  AS_SETRECDR_STS_OUTPUTDEVICE_FILE,
   AS_SETRECDR_STS_OUTPUTDEVICE_NUM
 } AsSetRecorderStsOutputDevice;
 
@@ -218,6 +222,47 @@ typedef enum
 
 typedef void (*AudioSimpleFifoWriteDoneCallbackFunction)(uint32_t size);
 
+/** Statistics of file output (#AS_SETRECDR_STS_OUTPUTDEVICE_FILE)
+ *
+ * Updated by the recorder without locking and cleared at the start of
+ * each recording.
+ */
+
+typedef struct
+{
+  /*! \brief [out] Bytes written to the file */
+
+  uint32_t written_bytes;
+
+  /*! \brief [out] Number of write() calls */
+
+  uint32_t write_count;
+
+  /*! \brief [out] Number of failed write() calls */
+
+  uint32_t write_errors;
+
+  /*! \brief [out] Frames dropped because both buffers were not written yet */
+
+  uint32_t overrun_frames;
+
+  /*! \brief [out] Bytes of the dropped frames */
+
+  uint32_t overrun_bytes;
+
+  /*! \brief [out] Time taken by the latest write() in microseconds */
+
+  uint32_t last_latency_us;
+
+  /*! \brief [out] Longest time taken by write() in microseconds */
+
+  uint32_t max_latency_us;
+
+  /*! \brief [out] Total time taken by write() in microseconds */
+
+  uint64_t total_latency_us;
+} AsRecorderFileStatistics;
+
 /** internal of output_device_handler
  * (used in AsSetRecorderStatusParam) parameter
  */
@@ -233,10 +278,48 @@ typedef struct
 
   /*! \brief [in] Set callback function
    *
-   * Call this function when SimpleFifo was read
+   * Call this function when SimpleFifo was read.
+   * On #AS_SETRECDR_STS_OUTPUTDEVICE_FILE, it is called with the written
+   * size after each write to the file, and may be NULL.
    */
 
   AudioSimpleFifoWriteDoneCallbackFunction callback_function;
+
+  /* Following members are used on #AS_SETRECDR_STS_OUTPUTDEVICE_FILE.
+   * Encoded data is gathered in two buffers, and each full buffer is
+   * written from a low priority thread, so that the file sees large
+   * writes aligned to the buffer size.
+   */
+
+  /*! \brief [in] File descriptor to write
+   *
+   * Read at the start of each recording, so it may be changed while the
+   * recorder is stopped. Flush stdio buffers of it before start.
+   * Data is written from the current file position.
+   */
+
+  int fd;
+
+  /*! \brief [in] Size of each of two buffers in bytes
+   *
+   * Rounded up to a multiple of 512 bytes. Cluster size of the file
+   * system is recommended. 0 selects 16 KiB.
+   */
+
+  uint32_t buffer_size;
+
+  /*! \brief [in] Bytes to reserve in the file at the start of recording
+   *
+   * Avoids cluster allocation while recording. The file is extended
+   * before start is replied, which takes time as the file system fills it
+   * with zeros, and truncated to the written size at stop. 0 disables it.
+   */
+
+  uint32_t prealloc_size;
+
+  /*! \brief [out] Statistics, may be NULL */
+
+  AsRecorderFileStatistics *stats;
 } AsRecorderOutputDeviceHdlr;
 
 /** SetRecorderStatus Command (#AUDCMD_SETRECORDERSTATUS) parameter */
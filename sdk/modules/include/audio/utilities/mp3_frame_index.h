@@ -0,0 +1,288 @@
+/****************************************************************************
+ * modules/include/audio/utilities/mp3_frame_index.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef MODULES_INCLUDE_AUDIO_UTILITIES_MP3_FRAME_INDEX_H
+#define MODULES_INCLUDE_AUDIO_UTILITIES_MP3_FRAME_INDEX_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of index entries kept in memory.
+ * When a file has more frames than this, the interval between entries is
+ * doubled, so the index never takes more than 4 * this value bytes.
+ */
+
+#define MP3_FRAME_INDEX_MAX_ENTRIES 2048
+
+/* Maximum number of Xing/VBRI TOC points kept in memory */
+
+#define MP3_FRAME_INDEX_MAX_TOC     128
+
+/** Frame index of an MP3 file
+ *
+ * The player reads MP3 files itself and pushes the data to the player
+ * object, which only sees a stream. This class gives the application
+ * what a stream can not : the file offset of a play time (seek and
+ * resume) and the duration of the file.
+ *
+ * The index records the offset of every N-th frame, where N is a power of
+ * two. It is built while the file is played (feed()), or at once by
+ * build(), and is saved as "<file>.idx" so the next open() of an unchanged
+ * file gets exact answers immediately. Until the index is complete, a
+ * Xing/Info or VBRI TOC, or the bitrate of a CBR stream, is used instead.
+ *
+ * The class is not thread safe.
+ */
+
+class Mp3FrameIndex
+{
+public:
+  /** Accuracy of a result */
+
+  enum Accuracy
+  {
+    /*! \brief No result */
+
+    AccuracyNone = 0,
+
+    /*! \brief Estimated from the bitrate of the first frame */
+
+    AccuracyEstimated,
+
+    /*! \brief Interpolated from a Xing/Info or VBRI TOC */
+
+    AccuracyToc,
+
+    /*! \brief Exact, taken from the frame index */
+
+    AccuracyExact
+  };
+
+  Mp3FrameIndex();
+  ~Mp3FrameIndex();
+
+  /**
+   * @brief Open MP3 file
+   *
+   * @details Find the first frame, read the Xing/Info or VBRI header if
+   *          any, and load "<file>.idx" if it matches the size and the
+   *          modification time of the file.
+   *
+   * @param[in] file_path: Path of MP3 file
+   *
+   * @retval     true  : success
+   * @retval     false : failure (no MP3 frame found)
+   */
+
+  bool open(const char *file_path);
+
+  /**
+   * @brief Close MP3 file
+   *
+   * @details Save the index if it was completed since open(), and free
+   *          internal memory area.
+   */
+
+  void close(void);
+
+  /**
+   * @brief Feed file data
+   *
+   * @details Index the frames in data read from the file for playback.
+   *          Data must be fed in file order, from the offset returned by
+   *          getAudioOffset(). Data which was already indexed is skipped,
+   *          and indexing stops at the first gap.
+   *
+   * @param[in] offset: File offset of data
+   * @param[in] data:   Data read from the file
+   * @param[in] size:   Size of data
+   */
+
+  void feed(uint32_t offset, const void *data, uint32_t size);
+
+  /**
+   * @brief Build index
+   *
+   * @details Read the rest of the file and complete the index.
+   *
+   * @retval     true  : success
+   * @retval     false : failure
+   */
+
+  bool build(void);
+
+  /**
+   * @brief Save index
+   *
+   * @details Write the index to "<file>.idx". The index must be complete.
+   *
+   * @retval     true  : success
+   * @retval     false : failure
+   */
+
+  bool save(void);
+
+  /**
+   * @brief Seek by time
+   *
+   * @details Find the frame which contains the designated play time.
+   *
+   * @param[in]  time_ms:  Play time [ms]
+   * @param[out] offset:   File offset of the frame
+   * @param[out] frame_ms: Play time at the start of the frame [ms]
+   *
+   * @retval     Accuracy of the result
+   */
+
+  Accuracy seek(uint32_t time_ms, uint32_t *offset, uint32_t *frame_ms);
+
+  /**
+   * @brief Get time of offset
+   *
+   * @details Get the play time of the frame which contains the designated
+   *          file offset, e.g. to resume playback at a saved offset.
+   *
+   * @param[in]  offset:  File offset
+   * @param[out] time_ms: Play time at the start of the frame [ms]
+   *
+   * @retval     Accuracy of the result
+   */
+
+  Accuracy getTime(uint32_t offset, uint32_t *time_ms);
+
+  /**
+   * @brief Get duration
+   *
+   * @param[out] duration_ms: Duration of the file [ms]
+   *
+   * @retval     Accuracy of the result
+   */
+
+  Accuracy getDuration(uint32_t *duration_ms);
+
+  /**
+   * @brief Get offset of the first audio frame
+   *
+   * @retval     File offset
+   */
+
+  uint32_t getAudioOffset(void) { return m_audio_start; }
+
+  /**
+   * @brief Get sampling rate
+   *
+   * @retval     Sampling rate [Hz]
+   */
+
+  uint32_t getSamplingRate(void) { return m_sampling_rate; }
+
+  /**
+   * @brief Check if the index is complete
+   *
+   * @retval     true  : complete
+   * @retval     false : not complete
+   */
+
+  bool isComplete(void) { return m_complete; }
+
+private:
+  struct TocPoint
+  {
+    uint32_t frame;
+    uint32_t offset;
+  };
+
+  FILE     *m_fp;
+  char     *m_index_path;
+  uint32_t  m_file_size;
+  uint32_t  m_file_mtime;
+
+  /* Stream properties taken from the first frame.
+   * m_audio_start is the first frame, m_audio_first is the first frame
+   * with audio (it follows the Xing/Info or VBRI frame if any).
+   */
+
+  uint32_t  m_signature;
+  uint32_t  m_sampling_rate;
+  uint32_t  m_samples_per_frame;
+  uint32_t  m_audio_start;
+  uint32_t  m_audio_first;
+  uint32_t  m_audio_end;
+
+  /* Points (frame, offset) of Xing/Info or VBRI TOC, or of the bitrate
+   * estimation. m_toc_frames is 0 if they are estimated.
+   */
+
+  uint32_t  m_toc_frames;
+  uint32_t  m_toc_num;
+  TocPoint  m_toc[MP3_FRAME_INDEX_MAX_TOC];
+
+  /* Frame index.
+   * m_entry[i] is the offset of frame (i * m_interval), m_next is the
+   * offset of the frame following the m_frames indexed frames.
+   */
+
+  uint32_t *m_entry;
+  uint32_t  m_entry_num;
+  uint32_t  m_interval;
+  uint32_t  m_frames;
+  uint32_t  m_next;
+  uint32_t  m_fed_end;
+  uint8_t   m_head[4];
+  uint32_t  m_head_len;
+  bool      m_indexing;
+  bool      m_complete;
+  bool      m_saved;
+
+  bool parseFirstFrame(void);
+  void parseXing(const uint8_t *frame, uint32_t size);
+  void parseVbri(const uint8_t *frame, uint32_t size);
+  void addTocPoint(uint32_t frame, uint32_t offset);
+  bool loadIndex(void);
+  void resetIndex(void);
+  void addFrame(uint32_t offset);
+  void finishIndex(void);
+  bool readAt(uint32_t offset, void *buf, uint32_t size);
+  bool findFrame(uint32_t offset, bool strict, uint32_t *found);
+  bool walkFrames(uint32_t offset, uint32_t count, uint32_t limit,
+                  uint32_t *end, uint32_t *walked);
+  uint32_t tocOffset(uint32_t frame);
+  uint32_t tocFrame(uint32_t offset);
+  uint32_t frameToMs(uint32_t frame);
+  uint32_t msToFrame(uint32_t time_ms);
+};
+
+#endif /* MODULES_INCLUDE_AUDIO_UTILITIES_MP3_FRAME_INDEX_H */
@@ -135,7 +135,8 @@ public:
     m_repeat_mode(RepeatModeOff),
     m_list_type(ListTypeAllTrack),
     m_play_idx(-1),
-    m_track_db_fp(NULL)
+    m_track_db_fp(NULL),
+    m_track_db_index(NULL)
   {
     strncpy(m_track_db_file_name, file_name, sizeof(m_track_db_file_name));
     memset(m_playlist_path, 0, sizeof(m_playlist_path));
@@ -319,6 +320,12 @@ private:
                    FAR const char *key_str,
                    FAR char       *file_name,
                    uint8_t        max_length);
+  bool readTrack(uint32_t offset, FAR Track *track);
+  bool loadTrackDbIndex(void);
+  bool buildTrackDbIndex(FAR const char *index_path,
+                         uint32_t       csv_size,
+                         uint32_t       csv_mtime);
+  void freeTrackDbIndex(void);
 
   static const int  FileNameMaxLength = 128;
   static const int  LineMaxLength     = 256;
@@ -333,6 +340,12 @@ private:
   char       m_track_db_file_name[FileNameMaxLength];
   FAR FILE   *m_track_db_fp;
 
+  /* Binary index of the track database, loaded with a single read.
+   * NULL if not available, then the CSV is parsed on each access.
+   */
+
+  FAR uint8_t *m_track_db_index;
+
   s_std::Queue<uint32_t, 256> m_alias_list;
 };
 
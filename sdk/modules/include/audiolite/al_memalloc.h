@@ -52,6 +52,31 @@
 #include <mossfw/mossfw_lock.h>
 #include <mossfw/mossfw_data.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_AL_MEMPOOL_LOCKFREE) && defined(CONFIG_SMP)
+#  define AL_MEMPOOL_CPU_CACHE_SLOTS \
+            (CONFIG_SMP_NCPUS * CONFIG_AL_MEMPOOL_CPU_CACHE)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Usage statistics of a memory pool */
+
+struct audiolite_mempool_stats_s
+{
+  int blocks;            /* Number of blocks in the pool */
+  int used;              /* Blocks in use now */
+  int peak;              /* Highest used since create or reset */
+  uint32_t allocs;       /* Successful allocate() calls */
+  uint32_t alloc_fails;  /* allocate() calls returned NULL */
+  uint32_t frees;        /* Blocks returned to the pool */
+};
+
 /****************************************************************************
  * Class Pre-definitions
  ****************************************************************************/
@@ -189,6 +214,33 @@ class audiolite_mempoolapbuf : public audiolite_mempool
     mossfw_lock_t _lock;
     mossfw_condition_t _cond;
 
+    /* Number of free blocks, and statistics */
+
+    int _free_cnt;
+    int _peak;
+    uint32_t _allocs;
+    uint32_t _alloc_fails;
+    uint32_t _frees;
+
+#ifdef CONFIG_AL_MEMPOOL_LOCKFREE
+    /* Free blocks are on a lock-free stack of block numbers (index of
+     * _insts + 1, 0 is none). The top word has a tag in upper 16 bits
+     * against ABA.
+     */
+
+    uint16_t *_free_next;
+    uint32_t _free_top;
+    int _waiters;
+#  ifdef AL_MEMPOOL_CPU_CACHE_SLOTS
+    uint16_t _cpu_cache[AL_MEMPOOL_CPU_CACHE_SLOTS];
+#  endif
+
+    audiolite_memapbuf *_pop_freemem(void);
+    uint16_t _pop_stack(void);
+    void _push_stack(uint16_t blk);
+    void _update_peak(int used);
+#endif
+
     void _add_freemem(audiolite_memapbuf *mem);
     bool _create_instance(int block_size, int block_num,
                           char *mem, int memsize);
@@ -203,6 +255,8 @@ class audiolite_mempoolapbuf : public audiolite_mempool
     virtual void memfree(audiolite_mem *mem);
     void disable_pool();
     void enable_pool();
+    void get_stats(struct audiolite_mempool_stats_s *stats);
+    void reset_stats(void);
 };
 
 /****************************************************************************
@@ -69,9 +69,10 @@ struct edge_detectf_s {
   int type;
   uint32_t prev_width;
   uint32_t width;
+  uint32_t pos;      /**< Position of the oldest sample in history */
+  uint32_t run;      /**< Number of the latest samples past boundary */
   float *boundary;
-  float *sub_buf;
-  float *remain_data;
+  float *history;    /**< Latest width input samples */
 };
 
 /**
@@ -91,9 +92,10 @@ struct edge_detects_s {
   int type;
   uint32_t prev_width;
   uint32_t width;
+  uint32_t pos;      /**< Position of the oldest sample in history */
+  uint32_t run;      /**< Number of the latest samples past boundary */
   int16_t *boundary;
-  int16_t *sub_buf;
-  int16_t *remain_data;
+  int16_t *history;  /**< Latest width input samples */
 };
 
 /**
@@ -153,11 +155,30 @@ void edge_detection_deletef(edge_detectf_t *detector);
  * @param [in] len: Length of data array.
  *
  * @return 0 or positive value is offset position of detected edge.
+ *         The data after the edge is not checked yet.
  *         Negative value when no edge detected.
  */
 
 int edge_detectf(edge_detectf_t *detector, float *input, uint32_t len);
 
+/**
+ * Detect all edges from float data array.
+ *
+ * @param [in] detector: Instance of edge_detect
+ * @param [in] input: Data array to detect edge.
+ * @param [in] len: Length of data array.
+ * @param [out] edges: Offset positions of detected edges.
+ * @param [in] max_edges: Number of elements of edges. When edges becomes
+ *                        full, the data after the last edge is not
+ *                        checked yet.
+ *
+ * @return Number of detected edges. Negative value is returned when
+ *         any error is occured.
+ */
+
+int edge_detect_allf(edge_detectf_t *detector, float *input, uint32_t len,
+    uint32_t *edges, int max_edges);
+
 /**
  * Reset an edge detection instance for reflesh.
  *
@@ -200,11 +221,30 @@ void edge_detection_deletes(edge_detects_t *detector);
  * @param [in] len: Length of data array.
  *
  * @return 0 or positive value is offset position of detected edge.
+ *         The data after the edge is not checked yet.
  *         Negative value when no edge detected.
  */
 
 int edge_detects(edge_detects_t *detector, int16_t *input, uint32_t len);
 
+/**
+ * Detect all edges from int16_t data array.
+ *
+ * @param [in] detector: Instance of edge_detect
+ * @param [in] input: Data array to detect edge.
+ * @param [in] len: Length of data array.
+ * @param [out] edges: Offset positions of detected edges.
+ * @param [in] max_edges: Number of elements of edges. When edges becomes
+ *                        full, the data after the last edge is not
+ *                        checked yet.
+ *
+ * @return Number of detected edges. Negative value is returned when
+ *         any error is occured.
+ */
+
+int edge_detect_alls(edge_detects_t *detector, int16_t *input, uint32_t len,
+    uint32_t *edges, int max_edges);
+
 /**
  * Reset an edge detection instance for reflesh.
  *
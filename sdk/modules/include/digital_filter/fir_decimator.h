@@ -62,6 +62,18 @@ typedef struct
   arm_fir_decimate_instance_f32 inst;
 } decimator_instancef_t;
 
+typedef struct
+{
+  arm_fir_decimate_instance_q15 inst;
+  uint8_t shift;  /**< Coefficient scale down undone on the outputs */
+} decimator_instanceq15_t;
+
+typedef struct
+{
+  arm_fir_decimate_instance_q31 inst;
+  uint8_t shift;  /**< Coefficient scale down undone on the outputs */
+} decimator_instanceq31_t;
+
 /** @} fir_decimator_datatype */
 
 #else
@@ -148,6 +160,128 @@ int decimator_tapnumf(decimator_instancef_t *dec);
  */
 void decimator_deletef(decimator_instancef_t *dec);
 
+/**
+ * Create Q15 FIR Decimator intance
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Decimation factor.
+ * @param [in] tr_width: Transition frequency band width of Low Pass Filter(Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return decimator_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by decimator_deleteq15().
+ */
+decimator_instanceq15_t *create_decimatorq15(int fs, int dec_factor,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q15 FIR Decimator intance with Tap size
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Decimation factor.
+ * @param [in] taps: Tap size of FIR filter.
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return decimator_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by decimator_deleteq15().
+ */
+decimator_instanceq15_t *create_decimatorq15_tap(int fs, int dec_factor,
+    int taps, int blocksz);
+
+/**
+ * Execute Q15 Decimation
+ *
+ * @param [in] dec: Instance of decimator_instanceq15_t.
+ * @param [in] input: q15_t array of input data.
+ * @param [in] input_len: Length of input array. This size must be multiple of
+ *                  blocksz set by create_decimatorq15().
+ * @param [out] output: q15_t array of output data.
+ * @param [in] output_len: Length of output array.
+ *
+ * @return Decimated data length, means size of output data.
+ */
+int decimator_executeq15(decimator_instanceq15_t *dec, q15_t *input,
+    int input_len, q15_t *output, int output_len);
+
+/**
+ * Get tap number of Q15 Decimator instance
+ *
+ * @param [in] dec: Instance of decimator_instanceq15_t.
+ *
+ * @return Tap number of the FIR filter.
+ */
+int decimator_tapnumq15(decimator_instanceq15_t *dec);
+
+/**
+ * Delete Q15 Decimator instance
+ *
+ * @param [in] dec: Instance of decimator_instanceq15_t.
+ */
+void decimator_deleteq15(decimator_instanceq15_t *dec);
+
+/**
+ * Create Q31 FIR Decimator intance
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Decimation factor.
+ * @param [in] tr_width: Transition frequency band width of Low Pass Filter(Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return decimator_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by decimator_deleteq31().
+ */
+decimator_instanceq31_t *create_decimatorq31(int fs, int dec_factor,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q31 FIR Decimator intance with Tap size
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Decimation factor.
+ * @param [in] taps: Tap size of FIR filter.
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return decimator_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by decimator_deleteq31().
+ */
+decimator_instanceq31_t *create_decimatorq31_tap(int fs, int dec_factor,
+    int taps, int blocksz);
+
+/**
+ * Execute Q31 Decimation
+ *
+ * @param [in] dec: Instance of decimator_instanceq31_t.
+ * @param [in] input: q31_t array of input data.
+ * @param [in] input_len: Length of input array. This size must be multiple of
+ *                  blocksz set by create_decimatorq31().
+ * @param [out] output: q31_t array of output data.
+ * @param [in] output_len: Length of output array.
+ *
+ * @return Decimated data length, means size of output data.
+ */
+int decimator_executeq31(decimator_instanceq31_t *dec, q31_t *input,
+    int input_len, q31_t *output, int output_len);
+
+/**
+ * Get tap number of Q31 Decimator instance
+ *
+ * @param [in] dec: Instance of decimator_instanceq31_t.
+ *
+ * @return Tap number of the FIR filter.
+ */
+int decimator_tapnumq31(decimator_instanceq31_t *dec);
+
+/**
+ * Delete Q31 Decimator instance
+ *
+ * @param [in] dec: Instance of decimator_instanceq31_t.
+ */
+void decimator_deleteq31(decimator_instanceq31_t *dec);
+
 /** @} fir_decimator_funcs */
 
 #  undef EXTERN
@@ -63,6 +63,26 @@
  */
 typedef arm_fir_instance_f32 fir_instancef_t;
 
+/**
+ * @typedef fir_instanceq15_t
+ * Q15 FIR filter. The coefficients are designed in float and quantized.
+ */
+typedef struct
+{
+  arm_fir_instance_q15 inst;
+  uint8_t shift;  /**< Coefficient scale down undone on the outputs */
+} fir_instanceq15_t;
+
+/**
+ * @typedef fir_instanceq31_t
+ * Q31 FIR filter. The coefficients are designed in float and quantized.
+ */
+typedef struct
+{
+  arm_fir_instance_q31 inst;
+  uint8_t shift;  /**< Coefficient scale down undone on the outputs */
+} fir_instanceq31_t;
+
 /** @} fir_datatype */
 
 #else
@@ -262,6 +282,338 @@ void firabs_executef(fir_instancef_t *fir, float *input, float *output, int len)
  */
 void fir_deletef(fir_instancef_t *fir);
 
+/**
+ * Create Q15 FIR Low Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_lpfq15(int fs, int cutoff_freq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q15 FIR Low Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_lpfq15_tap(int fs, int cutoff_freq,
+    int taps, int blocksz);
+
+/**
+ * Create Q15 FIR High Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_hpfq15(int fs, int cutoff_freq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q15 FIR High Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_hpfq15_tap(int fs, int cutoff_freq,
+    int taps, int blocksz);
+
+/**
+ * Create Q15 FIR Band Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_bpfq15(int fs, int lower_cutfreq, int higher_cutfreq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q15 FIR Band Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_bpfq15_tap(int fs, int lower_cutfreq, int higher_cutfreq,
+    int taps, int blocksz);
+
+/**
+ * Create Q15 FIR Band Elimination Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_befq15(int fs, int lower_cutfreq, int higher_cutfreq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q15 FIR Band Elimination Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq15_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq15().
+ */
+fir_instanceq15_t * fir_create_befq15_tap(int fs, int lower_cutfreq, int higher_cutfreq,
+    int taps, int blocksz);
+
+/**
+ * Get tap number of created Q15 FIR filter instance
+ *
+ * @param [in] fir: Target instance of fir_instanceq15_t to get tap number from.
+ *
+ * @return Tap number. It is rounded up to even by a zero coefficient.
+ */
+int fir_get_tapnumq15(fir_instanceq15_t *fir);
+
+/**
+ * Execute Q15 FIR filter
+ *
+ * @param [in] fir: Instance of fir_instanceq15_t.
+ * @param [in] input: q15_t array of input data.
+ * @param [out] output: q15_t array of output data.
+ * @param [in] len: Length of arrays. This size must be multiple of blocksz set
+ *                  by fir_create_xxxq15().
+ *
+ * @note Outputs saturate instead of wrapping around.
+ */
+void fir_executeq15(fir_instanceq15_t *fir, q15_t *input, q15_t *output,
+    int len);
+
+/**
+ * Execute Q15 FIR filter and calculate the absolute value
+ *
+ * @param [in] fir: Instance of fir_instanceq15_t.
+ * @param [in] input: q15_t array of input data.
+ * @param [out] output: q15_t array of output data.
+ * @param [in] len: Length of arrays. This size must be multiple of blocksz set
+ *                  by fir_create_xxxq15().
+ */
+void firabs_executeq15(fir_instanceq15_t *fir, q15_t *input, q15_t *output,
+    int len);
+
+/**
+ * Delete Q15 FIR instance
+ *
+ * @param [in] fir: Instance of fir_instanceq15_t.
+ */
+void fir_deleteq15(fir_instanceq15_t *fir);
+
+/**
+ * Create Q31 FIR Low Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_lpfq31(int fs, int cutoff_freq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q31 FIR Low Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_lpfq31_tap(int fs, int cutoff_freq,
+    int taps, int blocksz);
+
+/**
+ * Create Q31 FIR High Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_hpfq31(int fs, int cutoff_freq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q31 FIR High Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cuttoff_freq: Cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_hpfq31_tap(int fs, int cutoff_freq,
+    int taps, int blocksz);
+
+/**
+ * Create Q31 FIR Band Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_bpfq31(int fs, int lower_cutfreq, int higher_cutfreq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q31 FIR Band Pass Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_bpfq31_tap(int fs, int lower_cutfreq, int higher_cutfreq,
+    int taps, int blocksz);
+
+/**
+ * Create Q31 FIR Band Elimination Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] tr_width: Transition frequency band width. (Hz)
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_befq31(int fs, int lower_cutfreq, int higher_cutfreq,
+    int tr_width, int blocksz);
+
+/**
+ * Create Q31 FIR Band Elimination Filter with Tap size
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] taps: Tap size
+ * @param [in] blocksz: Block size to execute filter calcuation in one time. (samples)
+ *
+ * @return fir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note Free the instance by fir_deleteq31().
+ */
+fir_instanceq31_t * fir_create_befq31_tap(int fs, int lower_cutfreq, int higher_cutfreq,
+    int taps, int blocksz);
+
+/**
+ * Get tap number of created Q31 FIR filter instance
+ *
+ * @param [in] fir: Target instance of fir_instanceq31_t to get tap number from.
+ *
+ * @return Tap number.
+ */
+int fir_get_tapnumq31(fir_instanceq31_t *fir);
+
+/**
+ * Execute Q31 FIR filter
+ *
+ * @param [in] fir: Instance of fir_instanceq31_t.
+ * @param [in] input: q31_t array of input data.
+ * @param [out] output: q31_t array of output data.
+ * @param [in] len: Length of arrays. This size must be multiple of blocksz set
+ *                  by fir_create_xxxq31().
+ *
+ * @note Outputs saturate instead of wrapping around.
+ */
+void fir_executeq31(fir_instanceq31_t *fir, q31_t *input, q31_t *output,
+    int len);
+
+/**
+ * Execute Q31 FIR filter and calculate the absolute value
+ *
+ * @param [in] fir: Instance of fir_instanceq31_t.
+ * @param [in] input: q31_t array of input data.
+ * @param [out] output: q31_t array of output data.
+ * @param [in] len: Length of arrays. This size must be multiple of blocksz set
+ *                  by fir_create_xxxq31().
+ */
+void firabs_executeq31(fir_instanceq31_t *fir, q31_t *input, q31_t *output,
+    int len);
+
+/**
+ * Delete Q31 FIR instance
+ *
+ * @param [in] fir: Instance of fir_instanceq31_t.
+ */
+void fir_deleteq31(fir_instanceq31_t *fir);
+
 /** @} fir_funcs */
 
 #  undef EXTERN
@@ -0,0 +1,276 @@
+/****************************************************************************
+ * modules/include/digital_filter/iir_filter.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file iir_filter.h
+ */
+
+#ifndef __INCLUDE_FILTERS_IIR_FILTER_H
+#define __INCLUDE_FILTERS_IIR_FILTER_H
+
+/**
+ * @defgroup iir_filter IIR Filter
+ * @{
+ *
+ * Butterworth and Chebyshev IIR filters as biquad cascades using CMSIS DSP
+ */
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_EXTERNALS_CMSIS_DSP
+#include <arm_math.h>
+
+#define IIR_DESIGN_BUTTERWORTH (0) /**< Maximally flat pass band */
+#define IIR_DESIGN_CHEBYSHEV   (1) /**< Pass band ripple for sharper edge */
+
+/**
+ * @defgroup iir_datatype Data Types
+ * @{
+ */
+
+/**
+ * @typedef iir_instancef_t
+ * Wrap type of arm_biquad_cascade_df2T_instance_f32
+ */
+typedef arm_biquad_cascade_df2T_instance_f32 iir_instancef_t;
+
+/**
+ * @typedef iir_instanceq31_t
+ * Wrap type of arm_biquad_casd_df1_inst_q31.
+ * The coefficients are designed in float and quantized.
+ */
+typedef arm_biquad_casd_df1_inst_q31 iir_instanceq31_t;
+
+/** @} iir_datatype */
+
+#else
+#error "IIR filter needs CMSIS DSP library"
+#endif
+
+#  ifdef __cplusplus
+#    define EXTERN extern "C"
+extern "C"
+{
+#  else
+#    define EXTERN extern
+#  endif
+
+/********************************************************************************
+ * Public Function Prototypes
+ ********************************************************************************/
+
+/**
+ * @defgroup iir_funcs Functions
+ * @{
+ */
+
+/**
+ * Create IIR Low Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cutoff_freq: Cut off frequency. (Hz)
+ * @param [in] order: Filter order. One biquad is used per 2 orders.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *                     Not used in Butterworth design.
+ *
+ * @return iir_instancef_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note For Butterworth design, the gain at cutoff_freq is -3dB.
+ *       For Chebyshev design, it is the edge of the ripple band.
+ */
+iir_instancef_t * iir_create_lpff(int fs, int cutoff_freq, int order,
+    int design, float ripple);
+
+/**
+ * Create IIR High Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cutoff_freq: Cut off frequency. (Hz)
+ * @param [in] order: Filter order. One biquad is used per 2 orders.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *
+ * @return iir_instancef_t instance is returned on success, otherwise returns NULL.
+ */
+iir_instancef_t * iir_create_hpff(int fs, int cutoff_freq, int order,
+    int design, float ripple);
+
+/**
+ * Create IIR Band Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] order: Order of the low pass prototype. One biquad is used
+ *                    per order.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *
+ * @return iir_instancef_t instance is returned on success, otherwise returns NULL.
+ */
+iir_instancef_t * iir_create_bpff(int fs, int lower_cutfreq,
+    int higher_cutfreq, int order, int design, float ripple);
+
+/**
+ * Get number of biquad stages
+ *
+ * @param [in] iir: IIR Filter instance
+ *
+ * @return Number of stages.
+ */
+int iir_get_stagenumf(iir_instancef_t *iir);
+
+/**
+ * Execute IIR Filter
+ *
+ * @param [in] iir: IIR Filter instance
+ * @param [in] input: Input data array
+ * @param [out] output: Output data array
+ * @param [in] len: Length of input/output data array
+ */
+void iir_executef(iir_instancef_t *iir, float *input, float *output, int len);
+
+/**
+ * Clear the internal state of IIR Filter
+ *
+ * @param [in] iir: IIR Filter instance
+ */
+void iir_resetf(iir_instancef_t *iir);
+
+/**
+ * Delete IIR Filter instance
+ *
+ * @param [in] iir: IIR Filter instance
+ */
+void iir_deletef(iir_instancef_t *iir);
+
+/**
+ * Create Q31 IIR Low Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cutoff_freq: Cut off frequency. (Hz)
+ * @param [in] order: Filter order. One biquad is used per 2 orders.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *
+ * @return iir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ *
+ * @note The Q31 biquads wrap around on overflow. Leave headroom in the
+ *       input for the gain peaks of high order and Chebyshev designs.
+ */
+iir_instanceq31_t * iir_create_lpfq31(int fs, int cutoff_freq, int order,
+    int design, float ripple);
+
+/**
+ * Create Q31 IIR High Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] cutoff_freq: Cut off frequency. (Hz)
+ * @param [in] order: Filter order. One biquad is used per 2 orders.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *
+ * @return iir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ */
+iir_instanceq31_t * iir_create_hpfq31(int fs, int cutoff_freq, int order,
+    int design, float ripple);
+
+/**
+ * Create Q31 IIR Band Pass Filter
+ *
+ * @param [in] fs: Sampling rate of target signals.
+ * @param [in] lower_cutfreq: Lower cut off frequency. (Hz)
+ * @param [in] higher_cutfreq: Higher cut off frequency. (Hz)
+ * @param [in] order: Order of the low pass prototype. One biquad is used
+ *                    per order.
+ * @param [in] design: @ref IIR_DESIGN_BUTTERWORTH or
+ *                     @ref IIR_DESIGN_CHEBYSHEV
+ * @param [in] ripple: Pass band ripple of Chebyshev design. (dB)
+ *
+ * @return iir_instanceq31_t instance is returned on success, otherwise returns NULL.
+ */
+iir_instanceq31_t * iir_create_bpfq31(int fs, int lower_cutfreq,
+    int higher_cutfreq, int order, int design, float ripple);
+
+/**
+ * Get number of biquad stages
+ *
+ * @param [in] iir: IIR Filter instance
+ *
+ * @return Number of stages.
+ */
+int iir_get_stagenumq31(iir_instanceq31_t *iir);
+
+/**
+ * Execute Q31 IIR Filter
+ *
+ * @param [in] iir: IIR Filter instance
+ * @param [in] input: Input data array
+ * @param [out] output: Output data array
+ * @param [in] len: Length of input/output data array
+ */
+void iir_executeq31(iir_instanceq31_t *iir, q31_t *input, q31_t *output,
+    int len);
+
+/**
+ * Clear the internal state of Q31 IIR Filter
+ *
+ * @param [in] iir: IIR Filter instance
+ */
+void iir_resetq31(iir_instanceq31_t *iir);
+
+/**
+ * Delete Q31 IIR Filter instance
+ *
+ * @param [in] iir: IIR Filter instance
+ */
+void iir_deleteq31(iir_instanceq31_t *iir);
+
+/** @} iir_funcs */
+
+#  undef EXTERN
+#  ifdef __cplusplus
+}
+#  endif
+
+/** @} iir_filter */
+
+#endif  /* __INCLUDE_FILTERS_IIR_FILTER_H */
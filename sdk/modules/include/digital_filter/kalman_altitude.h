@@ -0,0 +1,154 @@
+/****************************************************************************
+ * modules/include/digital_filter/kalman_altitude.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file kalman_altitude.h
+ */
+
+#ifndef __INCLUDE_FILTERS_KALMAN_ALTITUDE_H
+#define __INCLUDE_FILTERS_KALMAN_ALTITUDE_H
+
+/**
+ * @defgroup kalman_altitude Altitude Kalman Filter
+ * @{
+ *
+ * Kalman filter fusing barometric altitude with vertical acceleration.
+ * The state is altitude, vertical velocity and accelerometer bias.
+ * Acceleration drives the prediction at its own rate and barometric
+ * altitude corrects it whenever it is available.
+ */
+
+#include <nuttx/config.h>
+
+/**
+ * @defgroup kalman_altitude_datatype Data Types
+ * @{
+ */
+
+/**
+ * @typedef kalman_altitude_t
+ * Instance of altitude Kalman filter
+ */
+typedef struct
+{
+  float altitude;    /**< Estimated altitude [m] */
+  float velocity;    /**< Estimated vertical velocity, upward [m/s] */
+  float bias;        /**< Estimated acceleration bias [m/s^2] */
+  float p[6];        /**< Covariance, upper triangle row by row */
+  float acc_var;     /**< Acceleration noise variance [(m/s^2)^2] */
+  float bias_var;    /**< Bias random walk variance per second */
+  float baro_var;    /**< Barometric altitude noise variance [m^2] */
+} kalman_altitude_t;
+
+/** @} kalman_altitude_datatype */
+
+#  ifdef __cplusplus
+#    define EXTERN extern "C"
+extern "C"
+{
+#  else
+#    define EXTERN extern
+#  endif
+
+/********************************************************************************
+ * Public Function Prototypes
+ ********************************************************************************/
+
+/**
+ * @defgroup kalman_altitude_funcs Functions
+ * @{
+ */
+
+/**
+ * Initialize altitude Kalman filter
+ *
+ * @param [out] kf: Instance of altitude Kalman filter
+ * @param [in] altitude: Initial altitude. (m)
+ * @param [in] acc_noise: Standard deviation of acceleration. (m/s^2)
+ * @param [in] bias_noise: Drift of acceleration bias. (m/s^2 per sqrt(s))
+ * @param [in] baro_noise: Standard deviation of barometric altitude. (m)
+ */
+void kalman_altitude_init(kalman_altitude_t *kf, float altitude,
+    float acc_noise, float bias_noise, float baro_noise);
+
+/**
+ * Predict the state after an acceleration sample
+ *
+ * @param [in] kf: Instance of altitude Kalman filter
+ * @param [in] acc: Vertical acceleration without gravity, upward. (m/s^2)
+ * @param [in] dt: Time from the previous prediction. (s)
+ */
+void kalman_altitude_predict(kalman_altitude_t *kf, float acc, float dt);
+
+/**
+ * Correct the state with a barometric altitude
+ *
+ * @param [in] kf: Instance of altitude Kalman filter
+ * @param [in] innovation: Measured altitude minus the estimated altitude
+ *                         at the time of measurement. (m)
+ *
+ * @note Measurements which arrive late can be applied with the altitude
+ *       estimated at their time, the correction goes to the current state.
+ */
+void kalman_altitude_correct(kalman_altitude_t *kf, float innovation);
+
+/**
+ * Correct the state with a barometric altitude of the current time
+ *
+ * @param [in] kf: Instance of altitude Kalman filter
+ * @param [in] altitude: Measured altitude. (m)
+ */
+void kalman_altitude_update(kalman_altitude_t *kf, float altitude);
+
+/**
+ * Convert pressure to altitude by the international standard atmosphere
+ *
+ * @param [in] pressure: Pressure. (Pa)
+ * @param [in] reference: Pressure at altitude 0. (Pa)
+ *
+ * @return Altitude. (m)
+ */
+float kalman_altitude_pressure(float pressure, float reference);
+
+/** @} kalman_altitude_funcs */
+
+#  undef EXTERN
+#  ifdef __cplusplus
+}
+#  endif
+
+/** @} kalman_altitude */
+
+#endif  /* __INCLUDE_FILTERS_KALMAN_ALTITUDE_H */
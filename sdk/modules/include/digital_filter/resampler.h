@@ -0,0 +1,222 @@
+/****************************************************************************
+ * modules/include/digital_filter/resampler.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file resampler.h
+ */
+
+#ifndef __INCLUDE_FILTERS_RESAMPLER_H
+#define __INCLUDE_FILTERS_RESAMPLER_H
+
+/**
+ * @defgroup resampler Sampling Rate Converter
+ * @{
+ *
+ * Polyphase rational resampler and multi-stage decimator
+ */
+
+#include <nuttx/config.h>
+
+#include <digital_filter/fir_decimator.h>
+
+/** Maximum number of stages of a decimator cascade */
+
+#define DECIMATOR_CASCADE_MAX_STAGES (4)
+
+/**
+ * @defgroup resampler_datatype Data Types
+ * @{
+ */
+
+/**
+ * @typedef resampler_instancef_t
+ * Rational L/M resampler for float data
+ */
+typedef struct
+{
+  int up;            /**< Interpolation factor L */
+  int down;          /**< Decimation factor M */
+  int phase_taps;    /**< Coefficients per phase */
+  int blocksz;       /**< Maximum input length of one call */
+  int phase;         /**< Phase of the next output, 0 to L - 1 */
+  int pos;           /**< Input index of the next output in next call */
+  float *coeffs;     /**< L phases of phase_taps coefficients */
+  float *state;      /**< phase_taps - 1 history + blocksz samples */
+} resampler_instancef_t;
+
+/**
+ * @typedef decimator_cascadef_t
+ * Chain of decimators planned by create_decimator_cascadef()
+ */
+typedef struct
+{
+  int num_stages;
+  int factor;        /**< Total decimation factor */
+  decimator_instancef_t *stage[DECIMATOR_CASCADE_MAX_STAGES];
+  float *work;       /**< Output of the intermediate stages */
+} decimator_cascadef_t;
+
+/** @} resampler_datatype */
+
+#  ifdef __cplusplus
+#    define EXTERN extern "C"
+extern "C"
+{
+#  else
+#    define EXTERN extern
+#  endif
+
+/********************************************************************************
+ * Public Function Prototypes
+ ********************************************************************************/
+
+/**
+ * @defgroup resampler_funcs Functions
+ * @{
+ */
+
+/**
+ * Create rational resampler instance
+ *
+ * @param [in] fs_in: Sampling rate of input signals.
+ * @param [in] fs_out: Sampling rate of output signals.
+ * @param [in] tr_width: Transition frequency band width of the anti-aliasing
+ *                       filter. (Hz)
+ * @param [in] blocksz: Maximum number of input samples in one call of
+ *                      resampler_executef().
+ *
+ * @return resampler_instancef_t instance is returned on success, otherwise
+ *         returns NULL.
+ *
+ * @note The rate is changed by L/M = fs_out/fs_in reduced to lowest terms.
+ *       Only the output samples are computed, each with one phase of
+ *       the filter, so the cost per output is about the tap number / L.
+ *       For large integer decimations create_decimator_cascadef() is
+ *       cheaper.
+ */
+resampler_instancef_t *create_resamplerf(int fs_in, int fs_out, int tr_width,
+    int blocksz);
+
+/**
+ * Execute resampling
+ *
+ * @param [in] rs: Instance of resampler_instancef_t.
+ * @param [in] input: float array of input data.
+ * @param [in] input_len: Length of input array, up to blocksz.
+ * @param [out] output: float array of output data.
+ * @param [in] output_len: Length of output array. It must be at least
+ *                         input_len * L / M + 1.
+ *
+ * @return Number of output samples, -1 on a bad length.
+ *
+ * @note The filter state and the phase carry over to the next call, so
+ *       a stream can be fed in blocks of any length.
+ */
+int resampler_executef(resampler_instancef_t *rs, float *input, int input_len,
+    float *output, int output_len);
+
+/**
+ * Delete resampler instance
+ *
+ * @param [in] rs: Instance of resampler_instancef_t.
+ */
+void resampler_deletef(resampler_instancef_t *rs);
+
+/**
+ * Plan the stages of a multi-stage decimator
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Total decimation factor.
+ * @param [in] tr_width: Transition frequency band width at the output. (Hz)
+ * @param [out] factors: Decimation factor of each stage, first stage first.
+ *                       It must have DECIMATOR_CASCADE_MAX_STAGES elements.
+ *
+ * @return Number of stages, -1 on a bad parameter.
+ *
+ * @note Every ordered factorization of dec_factor is costed as the
+ *       multiply-accumulates per input sample. An early stage only has to
+ *       keep the band below (fs / dec_factor - tr_width) / 2 from
+ *       aliasing, so its filter can be much shorter than one
+ *       decimating in a single step.
+ */
+int decimator_plan_stages(int fs, int dec_factor, int tr_width, int *factors);
+
+/**
+ * Create multi-stage decimator instance
+ *
+ * @param [in] fs: Sampling rate of input signals.
+ * @param [in] dec_factor: Total decimation factor.
+ * @param [in] tr_width: Transition frequency band width at the output. (Hz)
+ * @param [in] blocksz: Input block size. This size must be multiple of
+ *                      dec_factor.
+ *
+ * @return decimator_cascadef_t instance is returned on success, otherwise
+ *         returns NULL.
+ */
+decimator_cascadef_t *create_decimator_cascadef(int fs, int dec_factor,
+    int tr_width, int blocksz);
+
+/**
+ * Execute multi-stage decimation
+ *
+ * @param [in] dec: Instance of decimator_cascadef_t.
+ * @param [in] input: float array of input data.
+ * @param [in] input_len: Length of input array. This size must be the
+ *                        blocksz set by create_decimator_cascadef().
+ * @param [out] output: float array of output data.
+ * @param [in] output_len: Length of output array.
+ *
+ * @return Decimated data length, -1 if output_len is too short.
+ */
+int decimator_cascade_executef(decimator_cascadef_t *dec, float *input,
+    int input_len, float *output, int output_len);
+
+/**
+ * Delete multi-stage decimator instance
+ *
+ * @param [in] dec: Instance of decimator_cascadef_t.
+ */
+void decimator_cascade_deletef(decimator_cascadef_t *dec);
+
+/** @} resampler_funcs */
+
+#  undef EXTERN
+#  ifdef __cplusplus
+}
+#  endif
+
+/** @} resampler */
+
+#endif  /* __INCLUDE_FILTERS_RESAMPLER_H */
@@ -46,6 +46,8 @@
  * dnnrt is an Deep Neural Networks RunTime optimized for for CXD5602
  */
 
+#  include <stdint.h>
+#  include <stdio.h>
 #  include <malloc.h>
 #  include <asmp/types.h>
 #  include <dnnrt/nnablart/network.h>
@@ -89,8 +91,37 @@ typedef struct dnn_mallinfo
   size_t total_bytes;
   size_t used_bytes;
   size_t largest_bytes;
+  size_t planned_bytes; /**< variable buffers planned by dnn_runtime_initialize() */
 } dnn_mallinfo_t;
 
+/**
+ * @typedef dnn_profile_record_t
+ * cost of one function executed by dnn_runtime_forward()
+ */
+typedef struct dnn_profile_record
+{
+  uint32_t forward;       /**< Sequence number of the forward propagation */
+  uint16_t index;         /**< Position of the function in the network */
+  uint16_t type;          /**< nn_function_type_t of the function */
+  uint32_t cycles;        /**< CPU cycles spent in the function */
+  uint32_t scratch_bytes; /**< Scratch buffer used by the function */
+  uint32_t output_bytes;  /**< Total size of the output variables */
+} dnn_profile_record_t;
+
+/**
+ * @typedef dnn_profile_t
+ * ring of dnn_profile_record_t provided by the application
+ */
+typedef struct dnn_profile
+{
+  dnn_profile_record_t *records; /**< Array of capacity records */
+  uint32_t capacity;             /**< Number of elements in records */
+  uint32_t count;                /**< Number of records written so far. <br>
+                                  *   The newest one is
+                                  *   records[(count - 1) % capacity] */
+  uint32_t forwards;             /**< Number of profiled forward calls */
+} dnn_profile_t;
+
 /** @} dnnrt_datatype */
 
 /********************************************************************************
@@ -312,6 +343,39 @@ int dnn_nuttx_mallinfo(dnn_mallinfo_t * info);
  */
 int dnn_asmp_mallinfo(unsigned char array_length, dnn_mallinfo_t * info_array);
 
+/**
+ * Start or stop recording the cost of each function into a ring.
+ *
+ * @param [in] profile: ring to record into, or NULL to stop recording. <br>
+ *                      dnn_profile_t::records and dnn_profile_t::capacity
+ *                      must be set, the other members are reset.
+ *
+ * @return 0 on success, -EINVAL if the ring is empty.
+ *
+ * @note Available if CONFIG_DNN_RT_PROFILE=y. <br>
+ *       Every dnn_runtime_forward() after this call appends one record
+ *       per function of the network. The oldest records are overwritten
+ *       when the ring is full.
+ */
+int dnn_set_profile(dnn_profile_t * profile);
+
+/**
+ * Return the ring given to dnn_set_profile()
+ *
+ * @return pointer to the ring, NULL if no ring is set.
+ */
+dnn_profile_t *dnn_get_profile(void);
+
+/**
+ * Write the records of a ring, oldest first, as CSV text
+ *
+ * @param [in] profile: ring to export
+ * @param [in] stream:  stream to write to
+ *
+ * @return number of records written, otherwise -EINVAL.
+ */
+int dnn_profile_export_csv(const dnn_profile_t * profile, FILE * stream);
+
 /** @} dnnrt_funcs */
 
 #  undef EXTERN
@@ -93,7 +93,12 @@ public:
     */
   static err_t  initPerCpu(void* manager_area, uint32_t pool_num);
 
-  static err_t  initPerCpu(void* manager_area, MemPool ** static_pools[], uint8_t* pool_num, uint8_t* layout_no);
+  /** The 2nd initialize method on boot, with the layouts of mem_layout.h.
+    * @param[in] sec_num Number of sections in static_pools, pool_num and
+    *                    layout_no, i.e. NUM_MEM_SECTIONS.
+    */
+  static err_t  initPerCpu(void* manager_area, MemPool ** static_pools[], uint8_t* pool_num, uint8_t* layout_no,
+                           NumSection sec_num = 1);
 
   /* MemoryManager Finalize Process */
   /** The finalize method on power-off. 
@@ -154,6 +159,38 @@ public:
   static PoolSize  getPoolSize(PoolId id) { return findPool(id)->getPoolSize(); }
   static NumSeg  getPoolNumSegs(PoolId id) { return findPool(id)->getPoolNumSegs(); }
   static NumSeg  getPoolNumAvailSegs(PoolId id) { return findPool(id)->getPoolNumAvailSegs(); }
+
+  /** The getter method for the number of pool IDs of a section.
+    * @param[in] sec_no A section number.
+    * @return Number of pool IDs including the reserved ID 0.
+    */
+  static uint8_t  getPoolNum(uint8_t sec_no) { return theManager->m_pool_num[sec_no]; }
+
+  /** The getter method for the number of sections given to initPerCpu().
+    * @return Number of sections.
+    */
+  static NumSection  getSectionNum() { return theManager->m_sec_num; }
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  /** Take a snapshot of the usage statistics of a pool.
+    * The counters are read one by one without a lock.
+    * @param[in]  id    Pool ID.
+    * @param[out] stats Copy of the statistics.
+    * @return ERR_OK  : success
+    * @return ERR_STS : error, memory manager is not initialized
+    * @return ERR_ARG : error, the pool does not exist
+    */
+  static err_t  getPoolStats(PoolId id, PoolStats* stats);
+
+  /** Clear the counters of a pool and restart the peak from the
+    * current number of segments in use.
+    * @param[in] id Pool ID.
+    * @return ERR_OK  : success
+    * @return ERR_STS : error, memory manager is not initialized
+    * @return ERR_ARG : error, the pool does not exist
+    */
+  static err_t  resetPoolStats(PoolId id);
+#endif
 #ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_USE_FENCE
   static bool  isPoolFenceEnable(PoolId id) { return findPool(id)->isPoolFenceEnable(); }
 #endif
@@ -223,6 +260,7 @@ private:
   uint8_t    m_signature[3]; /* Initialize determination and
                               * mark for dumping.
                               */
+  NumSection m_sec_num;      /* Number of sections. */
   uint32_t   m_fix_fene_num; /* Number of fence. */
 
   uint8_t*   m_layout_no;    /* Current memory layout number. */
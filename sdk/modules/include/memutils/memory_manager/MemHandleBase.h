@@ -133,6 +133,9 @@ public:
 
 private:
   friend class MemPool;
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+  friend class SizeClassPool;
+#endif
 
   struct SegInfo {
     PoolId    pool_id;
@@ -105,6 +105,8 @@ enum
   /** the type number of fixed pools. (Now only support this type.) */
   BasicType,
   RingBufType,
+  /** the type number of pools with several segment sizes. */
+  SizeClassType,
   /** Number of types. */
   NumPoolTypes  /* number of pool types */
 };
@@ -143,8 +145,20 @@ const CpuId    MaskCpuId = 0x0f;  /* Lower 4 bits are valid. */
 const CpuId    MaxCpuId = MaskCpuId;
 #endif
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
 /*****************************************************************
- * Memory Pool Attributes (12 or 16bytes)
+ * Size Class of a SizeClassType pool (8bytes)
+ * The classes of a pool are listed in ascending order of seg_size
+ * and the list ends with {0, 0}.
+ *****************************************************************/
+struct SizeClassAttr {
+  PoolSize  seg_size;  /* segment size (bytes), multiple of 4 */
+  NumSeg    num_segs;  /* number of memory segments of this size */
+}; /* struct SizeClassAttr */
+#endif
+
+/*****************************************************************
+ * Memory Pool Attributes (12 or 16bytes, 4 more with size classes)
  *****************************************************************/
 struct PoolAttr {
   uint8_t   id;
@@ -158,6 +172,9 @@ struct PoolAttr {
 #endif
   PoolAddr  addr;    /* pool address */
   PoolSize  size;    /* pool size (bytes) */
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+  const SizeClassAttr*  classes;  /* size classes, SizeClassType only */
+#endif
 
 #ifdef USE_MEMMGR_DEBUG_OUTPUT
   void printInfo(bool newline = true) const {
@@ -186,6 +203,9 @@ struct PoolSectionAttr {
 #endif
   PoolAddr  addr;    /* pool address */
   PoolSize  size;    /* pool size (bytes) */
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+  const SizeClassAttr*  classes;  /* size classes, SizeClassType only */
+#endif
 
 #ifdef USE_MEMMGR_DEBUG_OUTPUT
   void printInfo(bool newline = true) const {
@@ -202,6 +222,23 @@ struct PoolSectionAttr {
 #endif /* USE_MEMMGR_DEBUG_OUTPUT */
 }; /* struct PoolAttr */
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+/*****************************************************************
+ * Memory Pool Usage Statistics (32bytes)
+ *****************************************************************/
+struct PoolStats {
+  uint32_t  allocs;          /* successful allocSeg calls */
+  uint32_t  alloc_fails;     /* allocSeg calls refused, pool empty */
+  uint32_t  frees;           /* freeSeg calls */
+  uint32_t  alloc_time_max;  /* longest allocSeg (cycles) */
+  uint32_t  alloc_time_sum;  /* total allocSeg time (cycles, wraps) */
+  uint32_t  free_time_max;   /* longest freeSeg (cycles) */
+  uint32_t  free_time_sum;   /* total freeSeg time (cycles, wraps) */
+  NumSeg    used;            /* segments in use now */
+  NumSeg    peak;            /* highest used since create or reset */
+}; /* struct PoolStats */
+#endif
+
 inline bool operator == (PoolId id1, PoolId id2)
 {
   return (id1.sec == id2.sec && id1.pool == id2.pool);
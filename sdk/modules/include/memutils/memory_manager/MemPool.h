@@ -38,6 +38,28 @@
 #include "memutils/memory_manager/RuntimeQue.h"
 #include "memutils/memory_manager/MemMgrTypes.h"
 
+/* With CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE the segment number queue is
+ * replaced by a lock-free stack.  Its links use the queue data area and the
+ * tagged top index takes the place of the queue indexes, so the pool work
+ * area size is unchanged.  SMP builds add a small per-CPU cache in front of
+ * the stack.
+ */
+
+/* The lock-free path does not take the inter-core spinlock of ScopedLock,
+ * so pools shared by several cores with USE_MEMMGR_MULTI_CORE would lose
+ * their mutual exclusion.
+ */
+
+#if defined(CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE) && \
+    defined(USE_MEMMGR_MULTI_CORE)
+#error "MEMUTILS_MEMORY_MANAGER_LOCKFREE can not be used with UseMultiCore"
+#endif
+
+#if defined(CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE) && defined(CONFIG_SMP)
+#define MEMMGR_CPU_CACHE_SLOTS \
+	(CONFIG_SMP_NCPUS * CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE)
+#endif
+
 /* Virtual function is prohibited for the following reason.
  * - Text Non-shared multicore can not use virtual function.
  * - By using virtual function 4 bytes size increases for each instance.
@@ -59,9 +81,20 @@ protected:
    */
 
 	bool isFailed() {
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+		if (m_seg_next == NULL || m_ref_cnt_array == NULL) {
+			return true;
+		}
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+		if (m_cpu_cache == NULL) {
+			return true;
+		}
+#endif
+#else
 		if (m_seg_no_que.que_area() == NULL || m_ref_cnt_array == NULL) {
 			return true;
 		}
+#endif
 		return false;
 	}
 
@@ -70,7 +103,12 @@ protected:
 	PoolAddr	getPoolAddr() const { return m_attr.addr; }
 	PoolSize	getPoolSize() const { return m_attr.size; }
 	NumSeg		getPoolNumSegs() const { return m_attr.num_segs; }
+#if defined(CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
+	NumSeg		getPoolNumAvailSegs() const;
+#else
 	NumSeg		getPoolNumAvailSegs() const { return m_seg_no_que.size(); }
+#endif
 #ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_USE_FENCE
 	bool		isPoolFenceEnable() const { return m_attr.fence; }
 	void		initPoolFence();
@@ -96,18 +134,44 @@ protected:
 	uint32_t	getUsedSegs(MemHandleBase* mhs, uint32_t num_mhs);
 
   /* Get a segment from the memory pool.
-   * Exclusive control should be done on the caller side.
+   * Exclusive control should be done on the caller side,
+   * unless CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE is enabled.
    */
 
 	MemHandleProxy	allocSeg();
 
   /* Subtract the reference counter and return the segment
    * if there is no reference.
-   * Exclusive control should be done on the caller side.
+   * Exclusive control should be done on the caller side,
+   * unless CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE is enabled.
    */
 
 	void	freeSeg(MemHandleBase& mh);
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  /* Usage statistics. Times are taken with getStatsTime(). */
+
+	void	getStats(PoolStats* stats) const;
+	void	resetStats();
+	void	statsAlloc(bool success, uint32_t start_time);
+	void	statsFree(uint32_t start_time);
+	void	statsUsed(int diff);
+#endif
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  /* Lock-free free list of segment numbers. */
+
+	NumSeg	popFreeSeg();
+	void	pushFreeSeg(NumSeg seg_no);
+
+  /* Tagged-index stack primitives, top is m_free_top or the top of
+   * one size class.
+   */
+
+	NumSeg	popSegStack(uint32_t* top);
+	void	pushSegStack(uint32_t* top, NumSeg seg_no);
+#endif
+
 protected:
   /* In the case of a static pool, it points to the corresponding part
    * of MemoryPoolLayouts.
@@ -121,7 +185,19 @@ protected:
    * It is necessary to separately prepare the area for queue data.
    */
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  /* Lock-free stack (8 bytes) of usable segment numbers (1 origin).
+   * m_seg_next[n - 1] is the segment below segment n on the stack,
+   * m_free_top holds a modification tag in the upper 16 bits and the
+   * top segment number in the lower 16 bits, the tag makes a pop that
+   * raced with a pop and push of the same segment fail its CAS.
+   */
+
+	NumSeg* const	m_seg_next;
+	uint32_t	m_free_top;
+#else
 	RuntimeQue<NumSeg, NumSeg>	m_seg_no_que;
+#endif
 
   /* Pointer to segment reference counter array.
    * If you do not store the pointer and set it to
@@ -130,6 +206,22 @@ protected:
    */
 
 	SegRefCnt* const	m_ref_cnt_array;
+
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+  /* Per-CPU segment caches, CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE
+   * slots per CPU.  A slot is either NullSegNo or a free segment.
+   */
+
+	NumSeg* const	m_cpu_cache;
+#endif
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  /* Usage statistics (32 bytes), updated with atomic operations so that
+   * they need no lock in either allocation mode.
+   */
+
+	PoolStats	m_stats;
+#endif
 }; /* class MemPool */
 
 } /* namespace MemMgrLite */
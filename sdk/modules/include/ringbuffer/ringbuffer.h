@@ -67,6 +67,23 @@ struct ringbuf_s
   bool full;         /**< Buffer full */
 };
 
+/**
+ * Single producer / single consumer Ring Buffer.
+ *
+ * One context may only write and one may only read, e.g. a sensor ISR
+ * and a logging task; no further locking is needed. Indexes run freely
+ * and are masked on access, so the size must be a power of two.
+ */
+
+struct ringbuf_spsc_s
+{
+  FAR uint8_t *buf;  /**< Pointer to buffer */
+  size_t mask;       /**< Buffer size - 1 */
+  size_t head;       /**< Read index, written by the consumer only */
+  size_t tail;       /**< Write index, written by the producer only */
+  bool owned;        /**< Buffer was allocated by ringbuf_spsc_new() */
+};
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -160,6 +177,134 @@ size_t ringbuf_bytesused(FAR struct ringbuf_s *rb);
 
 size_t ringbuf_bytesavail(FAR struct ringbuf_s *rb);
 
+/**
+ * Initialize a single producer / single consumer Ring Buffer on a
+ * caller provided buffer.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ * @param [in] buf: Storage for the Ring Buffer.
+ * @param [in] size: Size of buf, must be a power of two.
+ *
+ * @return On success, 0 is returned.
+ * On failure, negative value is returned according to <errno.h>.
+ */
+
+int ringbuf_spsc_init(FAR struct ringbuf_spsc_s *rb, FAR void *buf,
+                      size_t size);
+
+/**
+ * Allocates a new single producer / single consumer Ring Buffer.
+ *
+ * @param [in] size: Size of Ring Buffer to allocate, must be a power of two.
+ *
+ * @return On success, the allocated Ring Buffer is returned.
+ * On failure, NULL is returned.
+ */
+
+FAR struct ringbuf_spsc_s *ringbuf_spsc_new(size_t size);
+
+/**
+ * Release a Ring Buffer allocated by ringbuf_spsc_new().
+ *
+ * @param [in] rb: Pointer to a Ring Buffer to release.
+ */
+
+void ringbuf_spsc_free(FAR struct ringbuf_spsc_s *rb);
+
+/**
+ * Write to a single producer / single consumer Ring Buffer.
+ * Producer side only.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer to write.
+ * @param [in] buf: Data to write.
+ * @param [in] count: Bytes to write.
+ *
+ * @return On success, The number of bytes written.
+ * -ENOSPC if count bytes do not fit, nothing is written in that case.
+ */
+
+ssize_t ringbuf_spsc_write(FAR struct ringbuf_spsc_s *rb,
+                           FAR const void *buf, size_t count);
+
+/**
+ * Read from a single producer / single consumer Ring Buffer.
+ * Consumer side only.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer to read.
+ * @param [in] buf: Pointer to buffer to store data.
+ * @param [in] count: Maximum bytes to read.
+ *
+ * @return The number of bytes read.
+ */
+
+ssize_t ringbuf_spsc_read(FAR struct ringbuf_spsc_s *rb, FAR void *buf,
+                          size_t count);
+
+/**
+ * Get a contiguous writable span without copying. Producer side only.
+ * The span ends at the physical end of the buffer, so it can be shorter
+ * than ringbuf_spsc_bytesavail().
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ * @param [out] span: Start of the writable span.
+ *
+ * @return Length of the span in bytes, 0 if the buffer is full.
+ */
+
+size_t ringbuf_spsc_reserve(FAR struct ringbuf_spsc_s *rb,
+                            FAR uint8_t **span);
+
+/**
+ * Publish bytes written into a span from ringbuf_spsc_reserve().
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ * @param [in] count: Bytes to publish, at most the reserved length.
+ */
+
+void ringbuf_spsc_commit(FAR struct ringbuf_spsc_s *rb, size_t count);
+
+/**
+ * Get a contiguous readable span without copying. Consumer side only.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ * @param [out] span: Start of the readable span.
+ *
+ * @return Length of the span in bytes, 0 if the buffer is empty.
+ */
+
+size_t ringbuf_spsc_peek(FAR struct ringbuf_spsc_s *rb, FAR uint8_t **span);
+
+/**
+ * Release bytes obtained from ringbuf_spsc_peek().
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ * @param [in] count: Bytes to release, at most the peeked length.
+ */
+
+void ringbuf_spsc_consume(FAR struct ringbuf_spsc_s *rb, size_t count);
+
+/**
+ * Gets the number of bytes used. While the other side is active the
+ * value is a snapshot.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ *
+ * @return The number of bytes used.
+ */
+
+size_t ringbuf_spsc_bytesused(FAR struct ringbuf_spsc_s *rb);
+
+/**
+ * Gets the number of bytes free. While the other side is active the
+ * value is a snapshot.
+ *
+ * @param [in] rb: Pointer to a Ring Buffer.
+ *
+ * @return The number of bytes free.
+ */
+
+size_t ringbuf_spsc_bytesavail(FAR struct ringbuf_spsc_s *rb);
+
 /** @} */
 
 /** @} */
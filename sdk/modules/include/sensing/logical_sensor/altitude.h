@@ -0,0 +1,218 @@
+/****************************************************************************
+ * modules/include/sensing/logical_sensor/altitude.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SENSING_ALTITUDE_H
+#define __INCLUDE_SENSING_ALTITUDE_H
+
+/**
+ * @defgroup logical_altitude Altitude API
+ * @{
+ *
+ * Altitude and vertical velocity estimation by a Kalman filter of
+ * accelerometer and barometer data. Register altitudeID to the sensor
+ * manager with subscriptions of accelID and barometerID, and pass the
+ * received data to AltitudeWrite(). Accelerometer data is an array of
+ * ThreeAxisSample and barometer data is the compensated pressure sent by
+ * BarometerClass. The estimate is sent as AltitudeResult on altitudeID
+ * after each accelerometer data.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+#include <digital_filter/kalman_altitude.h>
+#include "memutils/memory_manager/MemHandle.h"
+#include "sensing/sensor_api.h"
+#include "sensing/sensor_id.h"
+#include "sensing/sensor_ecode.h"
+#include "sensing/logical_sensor/barometer.h"
+#include "sensing/logical_sensor/physical_command.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ALTITUDE_BARO_QUEUE_NUM  BAROMETER_PRESSURE_WATERMARK_NUM  /**< Barometer samples waiting for accelerometer */
+#define ALTITUDE_HISTORY_NUM     CONFIG_SENSING_ALTITUDE_HISTORY   /**< Accelerometer samples kept for late barometer samples */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/**
+ * @struct AltitudeSetting
+ * @brief Parameters of altitude estimation.
+ */
+
+typedef struct
+{
+  float reference;   /**< Pressure at altitude 0 [Pa]. 0 to use the first
+                      *   barometer sample, which gives height above it.
+                      */
+  float acc_noise;   /**< Standard deviation of acceleration [m/s^2] */
+  float bias_noise;  /**< Drift of acceleration bias [m/s^2 per sqrt(s)] */
+  float baro_noise;  /**< Standard deviation of barometric altitude [m] */
+} AltitudeSetting;
+
+/**
+ * @struct AltitudeResult
+ * @brief Estimated altitude sent to subscribers.
+ */
+
+typedef struct
+{
+  uint32_t time;     /**< Time of the estimate [ms] */
+  float altitude;    /**< Altitude [m] */
+  float velocity;    /**< Vertical velocity, upward [m/s] */
+} AltitudeResult;
+
+/*--------------------------------------------------------------------*/
+/*  Altitude Class                                                    */
+/*--------------------------------------------------------------------*/
+
+class AltitudeClass
+{
+public:
+
+  /* public methods */
+  int open(FAR AltitudeSetting *setting);
+  int close(void);
+  int write(FAR sensor_command_data_mh_t *command);
+
+  AltitudeClass(MemMgrLite::PoolId rst_pool_id)
+    : m_rst_pool_id(rst_pool_id), m_initialized(false), m_has_accel(false)
+  {
+  };
+
+  ~AltitudeClass(){};
+
+private:
+
+  struct sample_s
+    {
+      uint32_t time;
+      float    altitude;
+    };
+
+  struct accel_s
+    {
+      uint32_t time;
+      float    acc;   /* Vertical acceleration [m/s^2] */
+      float    dt;    /* Time from the previous sample [s] */
+    };
+
+  /* private members */
+
+  MemMgrLite::PoolId m_rst_pool_id;
+
+  AltitudeSetting   m_setting;
+  kalman_altitude_t m_kf;
+
+  bool     m_initialized;
+  bool     m_has_accel;
+  uint32_t m_time;        /* Time of the last prediction [ms] */
+  float    m_gravity[3];  /* Low passed acceleration [G] */
+
+  /* Barometer samples newer than the last prediction */
+
+  struct sample_s m_baro[ALTITUDE_BARO_QUEUE_NUM];
+  int m_baro_head;
+  int m_baro_num;
+
+  /* State at the last applied barometer sample and the accelerometer
+   * samples predicted after it, to replay them with late barometer
+   * samples.
+   */
+
+  kalman_altitude_t m_checkpoint;
+  struct accel_s m_history[ALTITUDE_HISTORY_NUM];
+  int m_hist_head;
+  int m_hist_num;
+
+  /* private methods */
+
+  void writeAccel(FAR sensor_command_data_mh_t *command);
+  void writeBarometer(FAR sensor_command_data_mh_t *command);
+  void predict(float acc, float dt, uint32_t time);
+  void flushBarometer(uint32_t time);
+  void replay(FAR struct sample_s *baro, int num);
+  int send(void);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/**
+ * @brief Create AltitudeClass instance.
+ * @param[in] rst_pool_id : Pool id for AltitudeResult
+ * @return Address for instance of AltitudeClass
+ *
+ */
+AltitudeClass* AltitudeCreate(MemMgrLite::PoolId rst_pool_id);
+
+AltitudeClass* AltitudeCreate(uint8_t rst_pool_id);
+
+/**
+ * @brief     Open AltitudeClass.
+ * @param[in] ins : instance address of AltitudeClass
+ * @param[in] setting : parameters of estimation
+ * @return    result of process.
+ */
+int AltitudeOpen(FAR AltitudeClass *ins, FAR AltitudeSetting *setting);
+
+/**
+ * @brief     Close AltitudeClass.
+ * @param[in] ins : instance address of AltitudeClass
+ * @return    result of process.
+ */
+int AltitudeClose(FAR AltitudeClass *ins);
+
+/**
+ * @brief     Send accelerometer or barometer data to AltitudeClass.
+ * @param[in] ins : instance address of AltitudeClass
+ * @param[in] command : command including data to send
+ * @return    result of process
+ */
+int AltitudeWrite(FAR AltitudeClass *ins,
+                  FAR sensor_command_data_mh_t *command);
+
+/**
+ * @}
+ */
+
+#endif /* __INCLUDE_SENSING_ALTITUDE_H */
@@ -113,6 +113,10 @@ public:
   BarometerClass(SensorClientID id)
     : m_id(id), isReceivedPressureData(false), isReceivedTemperatureData(false)
   {
+    pressCache.valid = false;
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+    isValidTemperature = false;
+#endif /* CONFIG_SENSING_BAROMETER_STREAMING */
   };
 
   ~BarometerClass(){};
@@ -130,7 +134,24 @@ private:
   bool isReceivedTemperatureData;
   MemMgrLite::MemHandle  pressureDate;
   MemMgrLite::MemHandle  temperatureData;
+
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+  bool    isValidTemperature;
+  int32_t lastTemperature;
+#endif /* CONFIG_SENSING_BAROMETER_STREAMING */
+
+  /* compensatePressure() terms of the last temperature */
+
+  struct
+  {
+    bool     valid;
+    int32_t  comp_T;
+    int32_t  offset;
+    uint32_t divisor;
+    uint32_t reciprocal;
+  } pressCache;
   
+  void send(uint32_t time);
   void compemsate(void);
   uint32_t compensatePressure(int32_t adc_P, int32_t comp_T);
   int32_t compensateTemperature(int32_t adc_T);
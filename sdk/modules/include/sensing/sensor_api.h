@@ -142,6 +142,12 @@ typedef struct
 
   MemMgrLite::MemHandle  mh;       /**< mem handle for send data */
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  uint32_t     publish_time;       /**< set by SS_SendSensorDataMH [us] */
+  uint32_t     reserved;           /**< set by SS_SendSensorDataMH,
+                                    *   subscribers holding a queue slot */
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
   unsigned int get_self(void)
     {
       return self;
@@ -174,6 +180,39 @@ typedef bool (*sensor_data_mh_callback_t)(sensor_command_data_mh_t&);
 typedef bool (*sensor_power_callback_t)(bool);
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+/*--------------------------------------------------------------------------*/
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+/**
+ * @enum  SensorDeliveryPolicy
+ * @brief How data with MemHandle is delivered to a subscriber.
+ *        Queued subscribers are called back on their own thread and
+ *        share the MemHandle of the publisher, the data is not copied.
+ */
+enum SensorDeliveryPolicy
+{
+  SensorDeliverySync = 0,    /**< call back on the manager thread         */
+  SensorDeliveryDropOldest,  /**< queue, drop the oldest data when full   */
+  SensorDeliveryBlock,       /**< queue, the publisher waits for room     */
+  SensorDeliveryCoalesce,    /**< queue, replace the newest data when full */
+
+  SensorDeliveryPolicyNum
+};
+
+/**
+ * @struct sensor_delivery_stats_t
+ * @brief  Delivery statistics of a subscriber.
+ */
+typedef struct
+{
+  uint32_t delivered;     /**< number of callbacks                       */
+  uint32_t dropped;       /**< data dropped by SensorDeliveryDropOldest  */
+  uint32_t coalesced;     /**< data replaced by SensorDeliveryCoalesce   */
+  uint32_t last_latency;  /**< publish to callback of the last data [us] */
+  uint32_t max_latency;   /**< maximum publish to callback latency [us]  */
+} sensor_delivery_stats_t;
+
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 /*--------------------------------------------------------------------------*/
 /**
  * @typedef api_response_callback_t
@@ -201,6 +240,10 @@ typedef struct
   sensor_power_callback_t   callback_pw;  /**< callback for setpower event */
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  unsigned int delivery = SensorDeliverySync; /**< SensorDeliveryPolicy of callback_mh */
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
   unsigned int get_self(void)
     {
       return self;
@@ -420,6 +463,20 @@ extern void SS_SendSensorRelease(FAR sensor_command_release_t *packet);
  */
 extern void SS_SendSensorChangeSubscription(FAR sensor_command_change_subscription_t *packet);
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+/**
+ * @brief      Get delivery statistics of a subscriber.
+ * @param[in]  id    Sensor ID of the subscriber
+ * @param[out] stats Statistics
+ * @param[in]  reset Clear the statistics after reading
+ * @return     true: success, false: the subscriber is not registered
+ */
+extern bool SS_GetSensorDeliveryStats(unsigned int id,
+                                      FAR sensor_delivery_stats_t *stats,
+                                      bool reset);
+
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 #ifdef __cplusplus
 
 /**
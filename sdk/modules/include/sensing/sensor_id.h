@@ -63,7 +63,7 @@ enum SensorClientID
   vadID,          /* 16 */
   wuwsrID,        /* 17 */
   adcID,          /* 18 */
-  reserve19ID,    /* 19 */
+  altitudeID,     /* 19 */
   app0ID,         /* 20 */
   app1ID,         /* 21 */
   app2ID,         /* 22 */
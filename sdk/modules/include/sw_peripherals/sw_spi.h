@@ -69,6 +69,15 @@ extern "C"
 /**
  * Create software emulated SPI driver.
  *
+ * All four SPI modes are supported, the driver starts in mode 0 at 1MHz.
+ * The SPI clock is calibrated here by toggling SCK and MOSI with CS
+ * deasserted for about 4 * CONFIG_SW_PERIPHERALS_SPI_CALIBRATION ms, and
+ * SPI_SETFREQUENCY() returns the closest frequency not above the request.
+ * On the CXD56xx the calibration is timed with the CPU cycle counter.
+ * Elsewhere it is timed with CLOCK_MONOTONIC; if that only has the
+ * resolution of the system tick, the frequency may be above the request
+ * by up to one tick over the calibration time.
+ *
  * @param [in] cs_pin: Chip Select pin number.
  * @param [in] sck_pin: SCK signal pin number.
  * @param [in] mosi_pin: MOSI signal pin number.
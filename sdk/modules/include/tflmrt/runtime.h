@@ -54,6 +54,8 @@ extern "C" {
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
+#include <stdio.h>
 #include <asmp/types.h>
 
 #include "tensorflow/lite/c/common.h"
@@ -96,6 +98,81 @@ typedef struct tflm_mallinfo
   size_t largest_bytes;
 } tflm_mallinfo_t;
 
+/**
+ * @typedef tflm_profile_record_t
+ * cost of one operator executed by tflm_runtime_forward()
+ */
+
+typedef struct tflm_profile_record
+{
+  uint32_t forward;      /**< Sequence number of the forward propagation */
+  uint16_t index;        /**< Position of the operator in the model */
+  const char *op;        /**< Name of the operator */
+  uint32_t cycles;       /**< CPU cycles spent in the operator */
+  uint32_t output_bytes; /**< Total size of the output tensors */
+} tflm_profile_record_t;
+
+/**
+ * @typedef tflm_profile_t
+ * ring of tflm_profile_record_t provided by the application
+ */
+
+typedef struct tflm_profile
+{
+  tflm_profile_record_t *records; /**< Array of capacity records */
+  uint32_t capacity;              /**< Number of elements in records */
+  uint32_t count;                 /**< Number of records written so far.
+                                   *   <br> The newest one is
+                                   *   records[(count - 1) % capacity] */
+  uint32_t forwards;              /**< Number of profiled forward calls */
+  uint32_t arena_bytes;           /**< Tensor arena used by the last
+                                   *   profiled runtime, operator scratch
+                                   *   buffers included */
+} tflm_profile_t;
+
+/**
+ * @typedef tflm_stream_state_t
+ * pair of tensors carrying the state of a streaming model from one
+ * forward propagation to the next
+ */
+
+typedef struct tflm_stream_state
+{
+  unsigned char output_index; /**< Output holding the next state */
+  unsigned char input_index;  /**< Input fed with it */
+} tflm_stream_state_t;
+
+/**
+ * @typedef tflm_stream_config_t
+ * structure to configure a tflm_stream_t
+ */
+
+typedef struct tflm_stream_config
+{
+  unsigned char input_index;  /**< Input fed with the window of samples */
+  uint16_t sample_bytes;      /**< Size of one sample, all channels */
+  uint32_t hop;               /**< Number of new samples between
+                               *   forward propagations */
+  unsigned char state_num;    /**< Number of elements in states */
+  const tflm_stream_state_t *states; /**< State tensors, may be NULL */
+} tflm_stream_config_t;
+
+/**
+ * @typedef tflm_stream_t
+ * sliding window of samples feeding one input of a tflm_runtime_t
+ */
+
+typedef struct tflm_stream
+{
+  tflm_runtime_t *rt;
+  tflm_stream_config_t config;
+  uint32_t window;    /**< Number of samples in the input */
+  uint32_t head;      /**< Position of the oldest sample in ring */
+  uint32_t filled;    /**< Number of valid samples, up to window */
+  uint32_t pending;   /**< Samples pushed since the last forward */
+  uint8_t *ring;      /**< Two copies of the window back to back */
+} tflm_stream_t;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -352,6 +429,107 @@ int tflm_nuttx_mallinfo(tflm_mallinfo_t *info);
 int tflm_asmp_mallinfo(unsigned char array_length,
                        tflm_mallinfo_t *info_array);
 
+/**
+ * Bind a sliding window of samples to an input of a runtime.
+ *
+ * @param [out] stream: tflm_stream_t object
+ * @param [in]  rt:     initialized tflm_runtime_t object
+ * @param [in]  config: configuration of the stream. <br>
+ *                      The window is the input size divided by
+ *                      tflm_stream_config_t::sample_bytes.
+ *
+ * @return 0 on success, -EINVAL on a bad configuration or -ENOMEM.
+ *
+ * @note Available if CONFIG_TFLM_RT_STREAM=y. <br>
+ *       A model exported for streaming computes only the newest samples
+ *       and returns the activations it needs later, e.g. the last
+ *       columns of each causal convolution, as extra outputs. List them
+ *       in tflm_stream_config_t::states and they are fed back to the
+ *       matching inputs before every forward propagation. Such a model
+ *       usually has window == hop. The other inputs keep what the
+ *       application wrote with tflm_input_buffer().
+ */
+
+int tflm_stream_initialize(tflm_stream_t *stream, tflm_runtime_t *rt,
+                           const tflm_stream_config_t *config);
+
+/**
+ * Free the window of a stream
+ *
+ * @param [in,out] stream: tflm_stream_t object
+ *
+ * @return 0 on success, otherwise -EINVAL.
+ */
+
+int tflm_stream_finalize(tflm_stream_t *stream);
+
+/**
+ * Append samples to the window and run a forward propagation every
+ * tflm_stream_config_t::hop samples once the window is full.
+ *
+ * @param [in,out] stream:   tflm_stream_t object
+ * @param [in]     samples:  samples, oldest first
+ * @param [in]     nsamples: number of samples
+ *
+ * @return number of forward propagations run, otherwise returns error
+ *         code in errno_t.
+ *
+ * @note The outputs hold the result of the last forward propagation.
+ *       Push no more than hop samples at a time to see every result.
+ */
+
+int tflm_stream_push(tflm_stream_t *stream, const void *samples,
+                     uint32_t nsamples);
+
+/**
+ * Drop the samples in the window and clear the state inputs
+ *
+ * @param [in,out] stream: tflm_stream_t object
+ *
+ * @return 0 on success, otherwise -EINVAL.
+ */
+
+int tflm_stream_reset(tflm_stream_t *stream);
+
+/**
+ * Start or stop recording the cost of each operator into a ring.
+ *
+ * @param [in] profile: ring to record into, or NULL to stop recording.
+ *                      <br> tflm_profile_t::records and
+ *                      tflm_profile_t::capacity must be set, the other
+ *                      members are reset.
+ *
+ * @return 0 on success, -EINVAL if the ring is empty.
+ *
+ * @note Available if CONFIG_TFLM_RT_PROFILE=y. <br>
+ *       Every tflm_runtime_forward() after this call appends one record
+ *       per operator of the model. The oldest records are overwritten
+ *       when the ring is full. TensorFlow Lite Micro places the scratch
+ *       buffers of the operators in the tensor arena, so they are only
+ *       reported as part of tflm_profile_t::arena_bytes.
+ */
+
+int tflm_set_profile(tflm_profile_t *profile);
+
+/**
+ * Return the ring given to tflm_set_profile()
+ *
+ * @return pointer to the ring, NULL if no ring is set.
+ */
+
+tflm_profile_t *tflm_get_profile(void);
+
+/**
+ * Write the records of a ring, oldest first, as CSV text
+ *
+ * @param [in] profile: ring to export
+ * @param [in] stream:  stream to write to
+ *
+ * @return number of records written, otherwise -EINVAL.
+ */
+
+int tflm_profile_export_csv(const tflm_profile_t *profile, FILE *stream);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * modules/include/utils/cyclecount.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __MODULES_INCLUDE_UTILS_CYCLECOUNT_H
+#define __MODULES_INCLUDE_UTILS_CYCLECOUNT_H
+
+/**
+ * @file cyclecount.h
+ * @brief CPU cycle counter for profiling
+ *
+ * On ARMv7-M this is the DWT cycle counter, a single load which wraps
+ * every 2^32 cycles. Other targets (e.g. host builds) always read 0.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#  define CYCLECOUNT_AVAILABLE 1
+
+#  define CYCLECOUNT_DWT_CTRL   (*(volatile uint32_t *)0xe0001000)
+#  define CYCLECOUNT_DWT_CYCCNT (*(volatile uint32_t *)0xe0001004)
+#  define CYCLECOUNT_DEMCR      (*(volatile uint32_t *)0xe000edfc)
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/**
+ * Start the cycle counter. It is never stopped, so several users may call
+ * this.
+ */
+
+static inline void cyclecount_enable(void)
+{
+#ifdef CYCLECOUNT_AVAILABLE
+  CYCLECOUNT_DEMCR    |= 1u << 24;  /* TRCENA */
+  CYCLECOUNT_DWT_CTRL |= 1u;        /* CYCCNTENA */
+#endif
+}
+
+/**
+ * Read the cycle counter
+ */
+
+static inline uint32_t cyclecount_get(void)
+{
+#ifdef CYCLECOUNT_AVAILABLE
+  return CYCLECOUNT_DWT_CYCCNT;
+#else
+  return 0;
+#endif
+}
+
+#endif /* __MODULES_INCLUDE_UTILS_CYCLECOUNT_H */
@@ -0,0 +1,162 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/host/host_os.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <pthread.h>
+#include <time.h>
+
+#include <sdk/config.h>
+#include <nuttx/arch.h>
+
+#include "host_os.h"
+
+using namespace MemMgrLite;
+
+/****************************************************************************
+ * NuttX functions
+ ****************************************************************************/
+
+/* The lock taken by ScopedLock.  It is recursive like nested interrupt
+ * disabling, and every thread takes the same one, like every context of
+ * a single core target.
+ */
+
+static pthread_mutex_t s_irq_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+/* Threads are spread round robin over CONFIG_SMP_NCPUS pseudo CPUs so
+ * that the per-CPU caches are shared, and stolen from, as on the target.
+ */
+
+#ifdef CONFIG_SMP_NCPUS
+static int s_next_cpu;
+#endif
+static __thread int s_cpu = -1;
+
+int up_cpu_index(void)
+{
+  if (s_cpu < 0)
+    {
+#ifdef CONFIG_SMP_NCPUS
+      s_cpu = __atomic_fetch_add(&s_next_cpu, 1, __ATOMIC_RELAXED) %
+              CONFIG_SMP_NCPUS;
+#else
+      s_cpu = 0;
+#endif
+    }
+
+  return s_cpu;
+}
+
+void up_irq_disable(void)
+{
+  pthread_mutex_lock(&s_irq_lock);
+}
+
+void up_irq_enable(void)
+{
+  pthread_mutex_unlock(&s_irq_lock);
+}
+
+void up_enable_irq(int irq)
+{
+}
+
+void up_disable_irq(int irq)
+{
+}
+
+int sched_lock(void)
+{
+  return 0;
+}
+
+int sched_unlock(void)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Layout data
+ ****************************************************************************/
+
+/* These are generated into mem_layout.h on the target */
+
+namespace MemMgrLite {
+MemPool* static_pools[NUM_HOST_POOLS];
+extern const PoolAddr FixedAreaFences[] = { 0 };
+}
+
+static PoolSectionAttr s_attr[2];
+static uint32_t s_manager_area[64];
+static uint32_t s_work_area[256];
+static MemPool *s_pools[NUM_HOST_POOLS];
+static MemPool **s_sections[1] = { s_pools };
+static uint8_t s_pool_num[1] = { NUM_HOST_POOLS };
+static uint8_t s_layout_no[1] = { BadLayoutNo };
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+bool host_create_pool(NumSeg num_segs, PoolSize seg_size)
+{
+  /* The pools keep a reference to their attribute */
+
+  s_attr[0].id.pool  = HOST_POOL_ID;
+  s_attr[0].type     = BasicType;
+  s_attr[0].num_segs = num_segs;
+  s_attr[0].addr     = HOST_POOL_ADDR;
+  s_attr[0].size     = num_segs * seg_size;
+
+  return Manager::initFirst(s_manager_area, sizeof(s_manager_area)) ==
+           ERR_OK &&
+         Manager::initPerCpu(s_manager_area, s_sections, s_pool_num,
+                             s_layout_no) == ERR_OK &&
+         Manager::createStaticPools(0, 0, s_work_area, sizeof(s_work_area),
+                                    s_attr) == ERR_OK;
+}
+
+void host_destroy_pool(void)
+{
+  Manager::destroyStaticPools(0);
+  Manager::finalize();
+}
+
+uint64_t host_time_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
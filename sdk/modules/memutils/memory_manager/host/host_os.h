@@ -0,0 +1,63 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/host/host_os.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef HOST_OS_H_INCLUDED
+#define HOST_OS_H_INCLUDED
+
+#include "memutils/memory_manager/MemHandle.h"
+#include "memutils/memory_manager/Manager.h"
+
+/* The host programs use one basic pool of section 0 */
+
+#define NUM_HOST_POOLS  2
+#define HOST_POOL_ID    1
+#define HOST_POOL_ADDR  0x10000
+
+/* Initialize the manager and create the pool.
+ * The segments are not accessed, HOST_POOL_ADDR is only a number.
+ */
+
+bool host_create_pool(MemMgrLite::NumSeg num_segs,
+                      MemMgrLite::PoolSize seg_size);
+
+/* Destroy the pool and finalize the manager */
+
+void host_destroy_pool(void);
+
+/* Monotonic time [ns] */
+
+uint64_t host_time_ns(void);
+
+#endif /* HOST_OS_H_INCLUDED */
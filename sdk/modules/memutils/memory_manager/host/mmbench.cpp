@@ -0,0 +1,162 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/host/mmbench.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Allocation benchmark of BasicPool.  Every thread allocates a burst of
+ * segments and frees them again, and the total number of allocations per
+ * second is printed.  Build it with and without the lock-free path to
+ * compare them, see the Makefile.
+ *
+ *   mmbench [threads] [burst] [seconds]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_os.h"
+
+using namespace MemMgrLite;
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NUM_SEGS   64
+#define SEG_SIZE   64
+#define BURST_MAX  8
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const PoolId s_id = { HOST_POOL_ID, 0 };
+static int s_burst = 1;
+static volatile bool s_start;
+static volatile bool s_stop;
+static uint64_t s_allocs;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void *bench_thread(void *arg)
+{
+  MemHandle mh[BURST_MAX];
+  uint64_t allocs = 0;
+
+  while (!s_start)
+    {
+    }
+
+  while (!s_stop)
+    {
+      for (int i = 0; i < s_burst; i++)
+        {
+          if (mh[i].allocSeg(s_id, SEG_SIZE) == ERR_OK)
+            {
+              allocs++;
+            }
+        }
+
+      for (int i = 0; i < s_burst; i++)
+        {
+          mh[i].freeSeg();
+        }
+    }
+
+  __atomic_add_fetch(&s_allocs, allocs, __ATOMIC_RELAXED);
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  int threads = (argc > 1) ? atoi(argv[1]) : 1;
+  double seconds = (argc > 3) ? atof(argv[3]) : 1.0;
+  pthread_t tid[NUM_SEGS];
+
+  if (argc > 2)
+    {
+      s_burst = atoi(argv[2]);
+    }
+
+  if (threads < 1 || threads * s_burst > NUM_SEGS ||
+      s_burst < 1 || s_burst > BURST_MAX || seconds <= 0)
+    {
+      fprintf(stderr, "usage: %s [threads] [burst(1-%d)] [seconds]\n"
+              "       threads * burst <= %d\n",
+              argv[0], BURST_MAX, NUM_SEGS);
+      return 2;
+    }
+
+  if (!host_create_pool(NUM_SEGS, SEG_SIZE))
+    {
+      fprintf(stderr, "pool creation failed\n");
+      return 1;
+    }
+
+  for (int i = 0; i < threads; i++)
+    {
+      pthread_create(&tid[i], NULL, bench_thread, NULL);
+    }
+
+  uint64_t start = host_time_ns();
+  s_start = true;
+
+  while (host_time_ns() - start < (uint64_t)(seconds * 1e9))
+    {
+      struct timespec ts = { 0, 10 * 1000 * 1000 };
+      nanosleep(&ts, NULL);
+    }
+
+  s_stop = true;
+
+  for (int i = 0; i < threads; i++)
+    {
+      pthread_join(tid[i], NULL);
+    }
+
+  double elapsed = (host_time_ns() - start) / 1e9;
+
+  host_destroy_pool();
+
+  printf("%s: %d threads, burst %d: %.2f M allocs/s\n",
+         argv[0], threads, s_burst, s_allocs / elapsed / 1e6);
+
+  return 0;
+}
@@ -0,0 +1,307 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/host/mmstress.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Stress test of BasicPool.  Threads allocate, copy and free segments of
+ * one small pool at random and hand some of them over to other threads.
+ * Every segment number is claimed in an owner table when it is allocated,
+ * so a segment handed out twice, or freed while referenced, is detected.
+ *
+ *   mmstress [threads] [iterations]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_os.h"
+
+using namespace MemMgrLite;
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NUM_SEGS   16
+#define SEG_SIZE   64
+#define HOLD_MAX   4
+#define MAILBOX    8
+#define MAILED     (-1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const PoolId s_id = { HOST_POOL_ID, 0 };
+static int s_iterations = 200000;
+static int s_owner[NUM_SEGS + 1];
+static int s_errors;
+static uint32_t s_allocs;
+static uint32_t s_empty;
+
+static pthread_mutex_t s_mailbox_lock = PTHREAD_MUTEX_INITIALIZER;
+static MemHandle s_mailbox[MAILBOX];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void error(const char *msg, NumSeg seg_no, int expect, int owner)
+{
+  fprintf(stderr, "segment %u: %s (expected owner %d, owner %d)\n",
+          seg_no, msg, expect, owner);
+  __atomic_add_fetch(&s_errors, 1, __ATOMIC_RELAXED);
+}
+
+static void claim(MemHandle &mh, int from, int to)
+{
+  int owner = __atomic_exchange_n(&s_owner[mh.getSegNo()], to,
+                                  __ATOMIC_ACQ_REL);
+  if (owner != from)
+    {
+      error(from ? "owner changed" : "allocated twice",
+            mh.getSegNo(), from, owner);
+    }
+}
+
+static uint32_t xorshift(uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+/* Remove handle k of n, the last one takes its place */
+
+static void drop(MemHandle *held, int k, int n)
+{
+  held[k].freeSeg();
+  if (k != n - 1)
+    {
+      held[k] = held[n - 1];
+      held[n - 1].freeSeg();
+    }
+}
+
+static void *stress_thread(void *arg)
+{
+  int self = (int)(intptr_t)arg;
+  uint32_t state = 0x9e3779b9u * (self + 1);
+  MemHandle held[HOLD_MAX];
+  int n = 0;
+  uint32_t allocs = 0;
+  uint32_t empty = 0;
+
+  for (int i = 0; i < s_iterations; i++)
+    {
+      uint32_t r = xorshift(&state);
+
+      switch (r % 8)
+        {
+          case 0:
+          case 1:
+          case 2:
+            if (n < HOLD_MAX)
+              {
+                if (held[n].allocSeg(s_id, SEG_SIZE) != ERR_OK)
+                  {
+                    empty++;
+                    break;
+                  }
+
+                if (held[n].getRefCnt() != 1)
+                  {
+                    error("new segment is referenced",
+                          held[n].getSegNo(), 1, held[n].getRefCnt());
+                  }
+
+                claim(held[n++], 0, self);
+                allocs++;
+              }
+            break;
+
+          case 3:
+          case 4:
+            if (n > 0)
+              {
+                int k = (r >> 8) % n;
+
+                /* A copy must not release the segment */
+
+                {
+                  MemHandle copy(held[k]);
+                }
+
+                claim(held[k], self, 0);
+                drop(held, k, n--);
+              }
+            break;
+
+          case 5:
+            if (n > 0)
+              {
+                int k = (r >> 8) % n;
+                int slot = (r >> 16) % MAILBOX;
+
+                /* Hand over to whoever empties the slot */
+
+                pthread_mutex_lock(&s_mailbox_lock);
+                if (s_mailbox[slot].isNull())
+                  {
+                    claim(held[k], self, MAILED);
+                    s_mailbox[slot] = held[k];
+                    drop(held, k, n--);
+                  }
+                pthread_mutex_unlock(&s_mailbox_lock);
+              }
+            break;
+
+          default:
+            if (n < HOLD_MAX)
+              {
+                int slot = (r >> 16) % MAILBOX;
+
+                pthread_mutex_lock(&s_mailbox_lock);
+                if (s_mailbox[slot].isAvail())
+                  {
+                    held[n] = s_mailbox[slot];
+                    s_mailbox[slot].freeSeg();
+                    claim(held[n++], MAILED, self);
+                  }
+                pthread_mutex_unlock(&s_mailbox_lock);
+              }
+            break;
+        }
+    }
+
+  while (n > 0)
+    {
+      claim(held[n - 1], self, 0);
+      drop(held, n - 1, n);
+      n--;
+    }
+
+  __atomic_add_fetch(&s_allocs, allocs, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&s_empty, empty, __ATOMIC_RELAXED);
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+  int threads = (argc > 1) ? atoi(argv[1]) : 4;
+  pthread_t tid[64];
+
+  if (argc > 2)
+    {
+      s_iterations = atoi(argv[2]);
+    }
+
+  if (threads < 1 || threads > 64 || s_iterations < 1)
+    {
+      fprintf(stderr, "usage: %s [threads(1-64)] [iterations]\n", argv[0]);
+      return 2;
+    }
+
+  if (!host_create_pool(NUM_SEGS, SEG_SIZE))
+    {
+      fprintf(stderr, "pool creation failed\n");
+      return 1;
+    }
+
+  for (int i = 0; i < threads; i++)
+    {
+      pthread_create(&tid[i], NULL, stress_thread, (void *)(intptr_t)(i + 1));
+    }
+
+  for (int i = 0; i < threads; i++)
+    {
+      pthread_join(tid[i], NULL);
+    }
+
+  for (int i = 0; i < MAILBOX; i++)
+    {
+      if (s_mailbox[i].isAvail())
+        {
+          claim(s_mailbox[i], MAILED, 0);
+          s_mailbox[i].freeSeg();
+        }
+    }
+
+  NumSeg avail = Manager::getPoolNumAvailSegs(s_id);
+  if (avail != NUM_SEGS)
+    {
+      fprintf(stderr, "%u of %u segments free at the end\n",
+              avail, NUM_SEGS);
+      s_errors++;
+    }
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  PoolStats stats;
+  Manager::getPoolStats(s_id, &stats);
+  if (stats.allocs != s_allocs || stats.alloc_fails != s_empty ||
+      stats.used != 0 || stats.peak > NUM_SEGS)
+    {
+      fprintf(stderr, "statistics: allocs %u/%u fails %u/%u used %u "
+              "peak %u\n", stats.allocs, s_allocs, stats.alloc_fails,
+              s_empty, stats.used, stats.peak);
+      s_errors++;
+    }
+
+  /* Only one section was given to initPerCpu(), as mmstat -s 4 asks */
+
+  PoolId other = s_id;
+  for (other.sec = 1; other.sec != 0; other.sec++)
+    {
+      if (Manager::getPoolStats(other, &stats) != ERR_ARG)
+        {
+          fprintf(stderr, "statistics of section %u\n", other.sec);
+          s_errors++;
+        }
+    }
+#endif
+
+  host_destroy_pool();
+
+  printf("%s: %d threads, %u allocs, %u empty, %d errors\n",
+         argv[0], threads, s_allocs, s_empty, s_errors);
+
+  return s_errors ? 1 : 0;
+}
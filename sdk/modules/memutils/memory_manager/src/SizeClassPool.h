@@ -0,0 +1,117 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/src/SizeClassPool.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef SIZECLASSPOOL_H_INCLUDED
+#define SIZECLASSPOOL_H_INCLUDED
+
+#include "memutils/common_utils/common_errcode.h"
+#include "memutils/memory_manager/MemPool.h"
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+
+namespace MemMgrLite {
+
+/*****************************************************************
+ * Size class memory pool class (24 or 28bytes)
+ *
+ * The pool area is split into several classes of equally sized
+ * segments, in the order of PoolSectionAttr::classes.  Segment
+ * numbers run through all classes, so reference counters and
+ * memory handles are the same as in BasicPool.  Each class keeps
+ * its free segments on its own stack, the links use the segment
+ * number area of MemPool.
+ *****************************************************************/
+class SizeClassPool : public MemPool {
+	friend class Manager;
+protected:
+	SizeClassPool(const PoolSectionAttr& attr, FastMemAlloc& fma);
+	~SizeClassPool();
+
+	bool isFailed() { return m_classes == NULL || MemPool::isFailed(); }
+
+  /* allocate a segment of the smallest class holding size_for_check,
+   * a larger class is used when that one is empty.
+   */
+
+	err_t allocSeg(size_t size_for_check, MemHandleProxy &proxy);
+
+	/* free a memory segment */
+	void 		freeSeg(MemHandleBase& mh);
+
+	PoolAddr	getSegAddr(const MemHandleBase& mh) const;
+	PoolSize	getSegSize(const MemHandleBase& mh) const;
+
+	static const uint8_t MaxClasses = 8;
+
+private:
+	struct SizeClass {
+		PoolAddr	addr;		/* address of the first segment */
+		PoolSize	seg_size;
+		uint32_t	free_top;	/* tag << 16 | top segment number */
+		NumSeg		first_seg;	/* segment number of the first segment */
+		NumSeg		num_segs;
+	};
+
+	SizeClass& findClass(NumSeg seg_no) const {
+		D_ASSERT(seg_no != NullSegNo && seg_no <= getPoolNumSegs());
+		uint8_t i = m_num_classes - 1;
+		while (seg_no < m_classes[i].first_seg) {
+			--i;
+		}
+		return m_classes[i];
+	}
+
+	NumSeg*	segLinks() {
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+		return m_seg_next;
+#else
+		/* The queue stays empty, its data area holds the links */
+		return static_cast<NumSeg*>(const_cast<void*>(m_seg_no_que.que_area()));
+#endif
+	}
+
+	NumSeg	popSeg(SizeClass& sc);
+	void	pushSeg(SizeClass& sc, NumSeg seg_no);
+
+	SizeClass*	m_classes;
+	uint8_t		m_num_classes;
+}; /* class SizeClassPool */
+
+} /* namespace MemMgrLite */
+
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL */
+
+#endif /* SIZECLASSPOOL_H_INCLUDED */
@@ -36,6 +36,13 @@
 #include "ScopedLock.h"
 #include "memutils/memory_manager/MemHandleBase.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+#include "StatsTime.h"
+#endif
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+#include <nuttx/arch.h>
+#endif
 
 namespace MemMgrLite {
 
@@ -56,16 +63,23 @@ err_t Manager::allocSeg(PoolId id, size_t size_for_check, MemHandleProxy &proxy)
 {
   MemPool* pool = findPool(id);
 
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
   /* 仮想関数を使用しない方針なので、該当プール型にダウンキャストする */
   switch (pool->getPoolType()) {
   case BasicType:
-    return static_cast<BasicPool*>(pool)->allocSeg(size_for_check);
+    return static_cast<BasicPool*>(pool)->allocSeg(size_for_check, proxy);
+#ifdef USE_MEMMGR_RINGBUF_POOL
   case RingBufType:
     return static_cast<RingBufPool*>(pool)->allocSeg(size_for_check);
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+  case SizeClassType:
+    return static_cast<SizeClassPool*>(pool)->allocSeg(size_for_check, proxy);
+#endif
   default:
     D_ASSERT(false);
-    return MemHandleProxy();  /* default constructor */
+    return ERR_ARG;
   }
 #else
   /* BasicPoolのみ使用時は、各種チェックを省略する */
@@ -83,8 +97,19 @@ err_t BasicPool::allocSeg(size_t size_for_check, MemHandleProxy &proxy)
       return ERR_DATA_SIZE;
     }
 
-  ScopedLock lock;
-  proxy = MemPool::allocSeg();
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  uint32_t start_time = getStatsTime();
+#endif
+  {
+#ifndef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+    ScopedLock lock;
+#endif
+    proxy = MemPool::allocSeg();
+  }
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  statsAlloc(proxy != 0, start_time);
+#endif
 
   if (proxy == 0)
     {
@@ -94,6 +119,73 @@ err_t BasicPool::allocSeg(size_t size_for_check, MemHandleProxy &proxy)
   return ERR_OK;
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Get a segment handle of a size class pool.
+ * Classes are in ascending order of segment size, so the first
+ * class that fits and is not empty is the best one.
+ *****************************************************************/
+err_t SizeClassPool::allocSeg(size_t size_for_check, MemHandleProxy &proxy)
+{
+  if (size_for_check > m_classes[m_num_classes - 1].seg_size)
+    {
+      return ERR_DATA_SIZE;
+    }
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  uint32_t start_time = getStatsTime();
+#endif
+  NumSeg seg_no = NullSegNo;
+  {
+#ifndef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+    ScopedLock lock;
+#endif
+    for (uint8_t i = 0; i < m_num_classes && seg_no == NullSegNo; ++i)
+      {
+        if (m_classes[i].seg_size >= size_for_check)
+          {
+            seg_no = popSeg(m_classes[i]);
+          }
+      }
+
+    if (seg_no != NullSegNo)
+      {
+        D_ASSERT(m_ref_cnt_array[seg_no - 1] == 0);
+        __atomic_store_n(&m_ref_cnt_array[seg_no - 1], 1, __ATOMIC_RELAXED);
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+        statsUsed(1);
+#endif
+      }
+  }
+
+  proxy = (seg_no != NullSegNo) ?
+          MemHandleBase::makeMemHandleProxy(getPoolId(), seg_no, 0) : 0;
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  statsAlloc(proxy != 0, start_time);
+#endif
+
+  return (proxy == 0) ? ERR_MEM_EMPTY : ERR_OK;
+}
+
+/*****************************************************************
+ * Take a free segment of a class.
+ * The caller holds the lock unless the pool is lock-free.
+ *****************************************************************/
+NumSeg SizeClassPool::popSeg(SizeClass& sc)
+{
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  return popSegStack(&sc.free_top);
+#else
+  NumSeg seg_no = static_cast<NumSeg>(sc.free_top);
+  if (seg_no != NullSegNo) {
+    sc.free_top = segLinks()[seg_no - 1];
+  }
+  return seg_no;
+#endif
+}
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL */
+
 /*****************************************************************
  * メモリプールからセグメントハンドルを取得する
  * 排他制御は呼出し側で行うこと
@@ -102,6 +194,19 @@ MemHandleProxy MemPool::allocSeg()
 {
   MemHandleProxy  mhp = 0;
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  NumSeg seg_no = popFreeSeg();
+  if (seg_no != NullSegNo) {
+    /* The segment is owned by this caller only, a plain store is enough */
+    D_ASSERT(m_ref_cnt_array[seg_no - 1] == 0);  /* 未使用のはず */
+    __atomic_store_n(&m_ref_cnt_array[seg_no - 1], 1, __ATOMIC_RELAXED);
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+    statsUsed(1);
+#endif
+
+    mhp = MemHandleBase::makeMemHandleProxy(getPoolId(), seg_no, 0);
+  }
+#else
   if (m_seg_no_que.size()) {
     /* セグメント番号を割り当てる */
     NumSeg seg_no = m_seg_no_que.top();
@@ -110,12 +215,108 @@ MemHandleProxy MemPool::allocSeg()
     /* セグメント参照カウンタを設定する */
     D_ASSERT(m_ref_cnt_array[seg_no - 1] == 0);  /* 未使用のはず */
     m_ref_cnt_array[seg_no - 1] = 1;  /* インクリメントより代入の方が効率が良い */
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+    statsUsed(1);
+#endif
 
     mhp = MemHandleBase::makeMemHandleProxy(getPoolId(), seg_no, 0);
   }
+#endif
   return mhp;
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+/*****************************************************************
+ * Take a free segment number without locking.
+ * Try the cache of the current CPU first, then the shared stack,
+ * and finally the caches of the other CPUs.
+ *****************************************************************/
+NumSeg MemPool::popFreeSeg()
+{
+  NumSeg seg_no;
+
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+  NumSeg* cache = m_cpu_cache +
+                  up_cpu_index() * CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE;
+
+  for (int i = 0; i < CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE; ++i) {
+    /* Check before exchanging to avoid writing an empty slot */
+    if (__atomic_load_n(&cache[i], __ATOMIC_RELAXED) != NullSegNo) {
+      seg_no = __atomic_exchange_n(&cache[i], NullSegNo, __ATOMIC_ACQUIRE);
+      if (seg_no != NullSegNo) {
+        return seg_no;
+      }
+    }
+  }
+#endif
+
+  seg_no = popSegStack(&m_free_top);
+
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+  /* Segments parked in other caches are still free, do not report an
+   * empty pool while one is available.
+   */
+
+  for (int i = 0; seg_no == NullSegNo && i < MEMMGR_CPU_CACHE_SLOTS; ++i) {
+    if (__atomic_load_n(&m_cpu_cache[i], __ATOMIC_RELAXED) != NullSegNo) {
+      seg_no = __atomic_exchange_n(&m_cpu_cache[i], NullSegNo,
+                                   __ATOMIC_ACQUIRE);
+    }
+  }
+#endif
+
+  return seg_no;
+}
+
+/*****************************************************************
+ * Pop the top of a lock-free segment stack
+ *****************************************************************/
+NumSeg MemPool::popSegStack(uint32_t* top_word)
+{
+  uint32_t top = __atomic_load_n(top_word, __ATOMIC_ACQUIRE);
+  uint32_t next;
+  NumSeg seg_no;
+
+  do {
+    seg_no = static_cast<NumSeg>(top & 0xffff);
+    if (seg_no == NullSegNo) {
+      break;
+    }
+
+    /* The link may be stale if another context popped seg_no meanwhile,
+     * the tag then differs and the CAS below fails.
+     */
+
+    next = ((top + 0x10000) & 0xffff0000) |
+           __atomic_load_n(&m_seg_next[seg_no - 1], __ATOMIC_RELAXED);
+  } while (!__atomic_compare_exchange_n(top_word, &top, next, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+  return seg_no;
+}
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE */
+
+#if defined(CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
+
+/*****************************************************************
+ * Count free segments.  Unused segments have a zero reference
+ * count wherever they are kept, so this does not walk the stack.
+ * The result is a snapshot.
+ *****************************************************************/
+NumSeg MemPool::getPoolNumAvailSegs() const
+{
+  NumSeg n = 0;
+
+  for (uint32_t i = 0; i < getPoolNumSegs(); ++i) {
+    if (__atomic_load_n(&m_ref_cnt_array[i], __ATOMIC_RELAXED) == 0) {
+      ++n;
+    }
+  }
+  return n;
+}
+#endif
+
 } /* end of namespace MemMgrLite */
 
 /* allocSeg.cxx */
@@ -37,6 +37,7 @@
 #include "FastMemAlloc.h"  /* FastMemAlloc class */
 #include "memutils/memory_manager/Manager.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
 
 namespace MemMgrLite {
 
@@ -46,14 +47,25 @@ namespace MemMgrLite {
 MemPool* Manager::createPool(const PoolSectionAttr& attr, FastMemAlloc& fma)
 {
   MemPool* pool = NULL;
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
   switch (attr.type) {
   case BasicType:
     pool = new(fma, sizeof(uint32_t)) BasicPool(attr, fma);
     break;
+#ifdef USE_MEMMGR_RINGBUF_POOL
   case RingBufType:
     pool = new(fma, sizeof(uint32_t)) RingBufPool(attr, fma);
     break;
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+  case SizeClassType:
+    {
+      SizeClassPool* sc_pool = new(fma, sizeof(uint32_t)) SizeClassPool(attr, fma);
+      pool = (sc_pool && sc_pool->isFailed()) ? NULL : sc_pool;
+    }
+    break;
+#endif
   default:
     D_ASSERT(false);  /* Unsupport pool type */
     break;
@@ -85,23 +97,131 @@ BasicPool::BasicPool(const PoolSectionAttr& attr, FastMemAlloc& fma) :
 #endif
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Constructor of a size class pool.
+ * On error m_classes stays NULL and isFailed() returns true.
+ *****************************************************************/
+SizeClassPool::SizeClassPool(const PoolSectionAttr& attr, FastMemAlloc& fma) :
+  MemPool(attr, fma),
+  m_classes(NULL),
+  m_num_classes(0)
+{
+  if (MemPool::isFailed() || attr.classes == NULL) {
+    D_ASSERT(attr.classes);
+    return;
+  }
+
+  /* Check the class table against the pool attributes */
+
+  uint8_t  n = 0;
+  uint32_t segs = 0;
+  PoolSize size = 0;
+  PoolSize prev_size = 0;
+
+  for (; attr.classes[n].num_segs != 0; ++n) {
+    const SizeClassAttr& ca = attr.classes[n];
+    if (n == MaxClasses || ca.seg_size <= prev_size ||
+        ca.seg_size % sizeof(uint32_t) != 0) {
+      D_ASSERT(false);  /* Bad size class table */
+      return;
+    }
+    prev_size = ca.seg_size;
+    segs += ca.num_segs;
+    size += ca.seg_size * ca.num_segs;
+  }
+
+  if (n == 0 || segs != attr.num_segs || size > attr.size) {
+    D_ASSERT(false);  /* Size classes do not match the pool */
+    return;
+  }
+
+  SizeClass* classes = static_cast<SizeClass*>(fma.alloc(sizeof(SizeClass) * n, sizeof(uint32_t)));
+  if (classes == NULL) {
+    return;
+  }
+
+  /* MemPool put every segment on one free list, drop it and build
+   * one stack per class.
+   */
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  m_free_top = NullSegNo;
+#else
+  m_seg_no_que.clear();
+#endif
+
+  NumSeg*  links = segLinks();
+  PoolAddr addr = attr.addr;
+  uint32_t first = 1;
+
+  for (uint8_t i = 0; i < n; ++i) {
+    const SizeClassAttr& ca = attr.classes[i];
+
+    classes[i].addr      = addr;
+    classes[i].seg_size  = ca.seg_size;
+    classes[i].first_seg = static_cast<NumSeg>(first);
+    classes[i].num_segs  = ca.num_segs;
+    classes[i].free_top  = first;
+
+    for (uint32_t seg = first; seg < first + ca.num_segs; ++seg) {
+      links[seg - 1] = (seg + 1 < first + ca.num_segs) ? static_cast<NumSeg>(seg + 1) : NullSegNo;
+    }
+
+    addr  += ca.seg_size * ca.num_segs;
+    first += ca.num_segs;
+  }
+
+  m_classes     = classes;
+  m_num_classes = n;
+
+#ifdef USE_MEMMGR_DEBUG_OUTPUT
+  printf("SizeClassPool: created. classes=%d [fma.rest=%08x] ", n, fma.rest());
+  attr.printInfo();
+#endif
+}
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL */
+
 /*****************************************************************
  * メモリプールのコンストラクタ
  *****************************************************************/
 MemPool::MemPool(const PoolSectionAttr& attr, FastMemAlloc& fma) :
   m_attr(attr),
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+  m_seg_next(static_cast<NumSeg*>(fma.alloc(sizeof(NumSeg) * attr.num_segs, sizeof(NumSeg)))),
+  m_free_top(0),
+#else
   m_seg_no_que(fma.alloc(sizeof(NumSeg) * attr.num_segs, sizeof(NumSeg)), attr.num_segs),
+#endif
   m_ref_cnt_array(static_cast<SegRefCnt*>(fma.alloc(sizeof(SegRefCnt) * attr.num_segs, sizeof(SegRefCnt))))
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+  , m_cpu_cache(static_cast<NumSeg*>(fma.alloc(sizeof(NumSeg) * MEMMGR_CPU_CACHE_SLOTS, sizeof(NumSeg))))
+#endif
 {
-  if (m_seg_no_que.que_area() && m_ref_cnt_array) { /* alloc成功 ? */
+  if (!isFailed()) { /* alloc成功 ? */
     /* 使用可能なセグメント番号(1 origin)を設定 */
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+    /* Build the stack with segment 1 on top, same order as the queue */
+    for (uint32_t i = 1; i <= static_cast<uint32_t>(attr.num_segs); ++i) {
+      m_seg_next[i - 1] = (i < attr.num_segs) ? static_cast<NumSeg>(i + 1) : NullSegNo;
+    }
+    m_free_top = (attr.num_segs > 0) ? 1 : NullSegNo;
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+    memset(m_cpu_cache, 0x00, sizeof(NumSeg) * MEMMGR_CPU_CACHE_SLOTS);
+#endif
+#else
     for (uint32_t i = 1; i <= static_cast<uint32_t>(attr.num_segs); ++i) {
       (void)m_seg_no_que.push(static_cast<NumSeg>(i));
     }
+#endif
 
     /* 参照カウンタ配列を初期化 */
     memset(m_ref_cnt_array, 0x00, sizeof(SegRefCnt) * attr.num_segs);
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+    memset(&m_stats, 0x00, sizeof(m_stats));
+#endif
+
 #ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_USE_FENCE
     if (isPoolFenceEnable()) {
       initPoolFence();  /* プールフェンスを初期化 */
@@ -35,6 +35,7 @@
 
 #include "memutils/memory_manager/Manager.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
 
 namespace MemMgrLite {
 
@@ -44,15 +45,23 @@ namespace MemMgrLite {
  *****************************************************************/
 void Manager::destroyPool(MemPool* pool)
 {
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
 	/* 仮想関数を使用しない方針なので、該当プール型にダウンキャストする */
 	switch (pool->getPoolType()) {
 	case BasicType:
 		static_cast<BasicPool*>(pool)->~BasicPool();
 		break;
+#ifdef USE_MEMMGR_RINGBUF_POOL
 	case RingBufType:
 		static_cast<RingBufPool*>(pool)->~RingBufPool();
 		break;
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+	case SizeClassType:
+		static_cast<SizeClassPool*>(pool)->~SizeClassPool();
+		break;
+#endif
 	default:
 		D_ASSERT(false);	/* Unsupport pool type */
 		break;
@@ -73,6 +82,18 @@ BasicPool::~BasicPool()
 #endif
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Destructor of a size class pool
+ *****************************************************************/
+SizeClassPool::~SizeClassPool()
+{
+#ifdef USE_MEMMGR_DEBUG_OUTPUT
+	printf("~SizeClassPool: PoolId=%d\n", getPoolId());
+#endif
+}
+#endif
+
 /*****************************************************************
  * メモリプールのデストラクタ
  *****************************************************************/
@@ -84,7 +105,12 @@ MemPool::~MemPool()
 	}
 #endif
 
+#if defined(CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
+	if (getPoolNumAvailSegs() != getPoolNumSegs()) {
+#else
 	if (!m_seg_no_que.full()) {
+#endif
 #ifdef USE_MEMMGR_DEBUG_OUTPUT
 		printf("~MemPool: Segment leak found. PoolId=%d\n", getPoolId());
 		for (int i = 0; i < getPoolNumSegs(); ++i) {
@@ -36,6 +36,13 @@
 #include "ScopedLock.h"
 #include "memutils/memory_manager/MemHandleBase.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+#include "StatsTime.h"
+#endif
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+#include <nuttx/arch.h>
+#endif
 
 namespace MemMgrLite {
 
@@ -46,15 +53,23 @@ void Manager::freeSeg(MemHandleBase& mh)
 {
 	MemPool* pool = findPool(mh.getPoolId());
 
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
 	/* 仮想関数を使用しない方針なので、該当プール型にダウンキャストする */
 	switch (pool->getPoolType()) {
 	case BasicType:
 		static_cast<BasicPool*>(pool)->freeSeg(mh);
 		break;
+#ifdef USE_MEMMGR_RINGBUF_POOL
 	case RingBufType:
 		static_cast<RingBufPool*>(pool)->freeSeg(mh);
 		break;
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+	case SizeClassType:
+		static_cast<SizeClassPool*>(pool)->freeSeg(mh);
+		break;
+#endif
 	default:
 		D_ASSERT(false);
 		break;
@@ -70,10 +85,69 @@ void Manager::freeSeg(MemHandleBase& mh)
  *****************************************************************/
 void BasicPool::freeSeg(MemHandleBase& mh)
 {
-	ScopedLock lock;
-	MemPool::freeSeg(mh);
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+	uint32_t start_time = getStatsTime();
+#endif
+	{
+#ifndef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+		ScopedLock lock;
+#endif
+		MemPool::freeSeg(mh);
+	}
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+	statsFree(start_time);
+#endif
+}
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Release a segment of a size class pool to its class
+ *****************************************************************/
+void SizeClassPool::freeSeg(MemHandleBase& mh)
+{
+	NumSeg seg_no = mh.getSegNo();
+	D_ASSERT(seg_no != NullSegNo && seg_no <= getPoolNumSegs());
+	D_ASSERT(m_ref_cnt_array[seg_no - 1] != 0);	/* 使用中のはず */
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+	uint32_t start_time = getStatsTime();
+#endif
+	{
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+		if (__atomic_sub_fetch(&m_ref_cnt_array[seg_no - 1], 1, __ATOMIC_ACQ_REL) == 0) {
+#else
+		ScopedLock lock;
+		if (--m_ref_cnt_array[seg_no - 1] == 0) {
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+			statsUsed(-1);
+#endif
+			pushSeg(findClass(seg_no), seg_no);
+		}
+	}
+	mh.clear();
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+	statsFree(start_time);
+#endif
 }
 
+/*****************************************************************
+ * Return a free segment to its class.
+ * The caller holds the lock unless the pool is lock-free.
+ *****************************************************************/
+void SizeClassPool::pushSeg(SizeClass& sc, NumSeg seg_no)
+{
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+	pushSegStack(&sc.free_top, seg_no);
+#else
+	segLinks()[seg_no - 1] = static_cast<NumSeg>(sc.free_top);
+	sc.free_top = seg_no;
+#endif
+}
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL */
+
 /*****************************************************************
  * 参照カウンタを減算し、参照がなくなった場合はセグメントを返却する
  * 排他制御は呼出し側で行うこと
@@ -84,17 +158,71 @@ void MemPool::freeSeg(MemHandleBase& mh)
 	D_ASSERT(seg_no != NullSegNo && seg_no <= getPoolNumSegs());
 	D_ASSERT(m_ref_cnt_array[seg_no - 1] != 0);	/* 使用中のはず */
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+	/* Only the context that drops the last reference returns the segment */
+	if (__atomic_sub_fetch(&m_ref_cnt_array[seg_no - 1], 1, __ATOMIC_ACQ_REL) == 0) {
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+		statsUsed(-1);
+#endif
+		pushFreeSeg(seg_no);
+	}
+#else
 	--m_ref_cnt_array[seg_no - 1];
 	if (m_ref_cnt_array[seg_no - 1] == 0) {
 		D_ASSERT(m_seg_no_que.full() == false);
 #ifdef USE_MEMMGR_SEG_DELETER
 //		notifyFreeSeg(mh);
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+		statsUsed(-1);
 #endif
 		(void)m_seg_no_que.push(seg_no);
 	}
+#endif
 	mh.clear();	/* メモリハンドルを初期状態に戻す */
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+/*****************************************************************
+ * Return a free segment number without locking.
+ * Park it in the cache of the current CPU if a slot is empty,
+ * otherwise push it on the shared stack.
+ *****************************************************************/
+void MemPool::pushFreeSeg(NumSeg seg_no)
+{
+#ifdef MEMMGR_CPU_CACHE_SLOTS
+	NumSeg* cache = m_cpu_cache +
+	                up_cpu_index() * CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE;
+
+	for (int i = 0; i < CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE; ++i) {
+		NumSeg empty = NullSegNo;
+		if (__atomic_compare_exchange_n(&cache[i], &empty, seg_no, false,
+		                                __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			return;
+		}
+	}
+#endif
+
+	pushSegStack(&m_free_top, seg_no);
+}
+
+/*****************************************************************
+ * Push a segment on a lock-free segment stack
+ *****************************************************************/
+void MemPool::pushSegStack(uint32_t* top_word, NumSeg seg_no)
+{
+	uint32_t top = __atomic_load_n(top_word, __ATOMIC_RELAXED);
+	uint32_t next;
+
+	do {
+		__atomic_store_n(&m_seg_next[seg_no - 1],
+		                 static_cast<NumSeg>(top & 0xffff), __ATOMIC_RELAXED);
+		next = ((top + 0x10000) & 0xffff0000) | seg_no;
+	} while (!__atomic_compare_exchange_n(top_word, &top, next, true,
+	                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE */
+
 } /* end of namespace MemMgrLite */
 
 /* freeSeg.cxx */
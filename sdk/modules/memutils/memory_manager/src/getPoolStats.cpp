@@ -0,0 +1,193 @@
+/****************************************************************************
+ * modules/memutils/memory_manager/src/getPoolStats.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <string.h>
+#include "memutils/memory_manager/Manager.h"
+#include "StatsTime.h"
+
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+
+namespace MemMgrLite {
+
+/*****************************************************************
+ * Find a pool without asserting, for the statistics API
+ *****************************************************************/
+static err_t checkStatsPool(Manager* manager, PoolId id)
+{
+  if (manager == NULL)
+    {
+      return ERR_STS;
+    }
+
+  if (id.sec >= Manager::getSectionNum() ||
+      id.pool == 0 || id.pool >= Manager::getPoolNum(id.sec) ||
+      !Manager::isPoolAvailable(id))
+    {
+      return ERR_ARG;
+    }
+
+  return ERR_OK;
+}
+
+/*****************************************************************
+ * Take a snapshot of the usage statistics of a pool
+ *****************************************************************/
+err_t Manager::getPoolStats(PoolId id, PoolStats* stats)
+{
+  err_t err = checkStatsPool(theManager, id);
+
+  if (err == ERR_OK)
+    {
+      findPool(id)->getStats(stats);
+    }
+
+  return err;
+}
+
+/*****************************************************************
+ * Clear the usage statistics of a pool
+ *****************************************************************/
+err_t Manager::resetPoolStats(PoolId id)
+{
+  err_t err = checkStatsPool(theManager, id);
+
+  if (err == ERR_OK)
+    {
+      findPool(id)->resetStats();
+    }
+
+  return err;
+}
+
+/*****************************************************************
+ * Copy the counters one by one, each load is atomic
+ *****************************************************************/
+void MemPool::getStats(PoolStats* stats) const
+{
+  stats->allocs         = __atomic_load_n(&m_stats.allocs, __ATOMIC_RELAXED);
+  stats->alloc_fails    = __atomic_load_n(&m_stats.alloc_fails, __ATOMIC_RELAXED);
+  stats->frees          = __atomic_load_n(&m_stats.frees, __ATOMIC_RELAXED);
+  stats->alloc_time_max = __atomic_load_n(&m_stats.alloc_time_max, __ATOMIC_RELAXED);
+  stats->alloc_time_sum = __atomic_load_n(&m_stats.alloc_time_sum, __ATOMIC_RELAXED);
+  stats->free_time_max  = __atomic_load_n(&m_stats.free_time_max, __ATOMIC_RELAXED);
+  stats->free_time_sum  = __atomic_load_n(&m_stats.free_time_sum, __ATOMIC_RELAXED);
+  stats->used           = __atomic_load_n(&m_stats.used, __ATOMIC_RELAXED);
+  stats->peak           = __atomic_load_n(&m_stats.peak, __ATOMIC_RELAXED);
+}
+
+/*****************************************************************
+ * Clear the counters, the peak restarts from the current usage
+ *****************************************************************/
+void MemPool::resetStats()
+{
+  NumSeg used = __atomic_load_n(&m_stats.used, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&m_stats.allocs, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.alloc_fails, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.frees, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.alloc_time_max, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.alloc_time_sum, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.free_time_max, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.free_time_sum, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&m_stats.peak, used, __ATOMIC_RELAXED);
+}
+
+/*****************************************************************
+ * Raise *max to val if it is larger
+ *****************************************************************/
+template <typename T>
+static inline void updateMax(T* max, T val)
+{
+  T cur = __atomic_load_n(max, __ATOMIC_RELAXED);
+
+  while (val > cur &&
+         !__atomic_compare_exchange_n(max, &cur, val, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/*****************************************************************
+ * Account one allocSeg call that started at start_time
+ *****************************************************************/
+void MemPool::statsAlloc(bool success, uint32_t start_time)
+{
+  uint32_t elapsed = getStatsTime() - start_time;
+
+  if (success)
+    {
+      __atomic_add_fetch(&m_stats.allocs, 1, __ATOMIC_RELAXED);
+    }
+  else
+    {
+      __atomic_add_fetch(&m_stats.alloc_fails, 1, __ATOMIC_RELAXED);
+    }
+
+  __atomic_add_fetch(&m_stats.alloc_time_sum, elapsed, __ATOMIC_RELAXED);
+  updateMax(&m_stats.alloc_time_max, elapsed);
+}
+
+/*****************************************************************
+ * Account one freeSeg call that started at start_time
+ *****************************************************************/
+void MemPool::statsFree(uint32_t start_time)
+{
+  uint32_t elapsed = getStatsTime() - start_time;
+
+  __atomic_add_fetch(&m_stats.frees, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&m_stats.free_time_sum, elapsed, __ATOMIC_RELAXED);
+  updateMax(&m_stats.free_time_max, elapsed);
+}
+
+/*****************************************************************
+ * A segment left (diff = 1) or returned to (diff = -1) the pool
+ *****************************************************************/
+void MemPool::statsUsed(int diff)
+{
+  NumSeg used = __atomic_add_fetch(&m_stats.used, static_cast<NumSeg>(diff),
+                                   __ATOMIC_RELAXED);
+
+  if (diff > 0)
+    {
+      updateMax(&m_stats.peak, used);
+    }
+}
+
+} /* end of namespace MemMgrLite */
+
+#endif /* CONFIG_MEMUTILS_MEMORY_MANAGER_STATS */
+
+/* getPoolStats.cxx */
@@ -35,6 +35,7 @@
 
 #include "memutils/memory_manager/MemHandleBase.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
 
 namespace MemMgrLite {
 
@@ -45,13 +46,20 @@ PoolAddr Manager::getSegAddr(const MemHandleBase& mh)
 {
 	MemPool* pool = findPool(mh.getPoolId());
 
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
 	/* 仮想関数を使用しない方針なので、該当プール型にダウンキャストする */
 	switch (pool->getPoolType()) {
 	case BasicType:
 		return static_cast<BasicPool*>(pool)->getSegAddr(mh);
+#ifdef USE_MEMMGR_RINGBUF_POOL
 	case RingBufType:
 		return static_cast<RingBufPool*>(pool)->getSegAddr(mh);
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+	case SizeClassType:
+		return static_cast<SizeClassPool*>(pool)->getSegAddr(mh);
+#endif
 	default:
 		D_ASSERT(false);
 		return BadPoolAddr;
@@ -73,6 +81,19 @@ PoolAddr BasicPool::getSegAddr(const MemHandleBase& mh) const
 	return getPoolAddr() + ((seg_no - 1) * getSegSize());
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Get the address of a segment of a size class pool
+ *****************************************************************/
+PoolAddr SizeClassPool::getSegAddr(const MemHandleBase& mh) const
+{
+	NumSeg seg_no = mh.getSegNo();
+	const SizeClass& sc = findClass(seg_no);
+
+	return sc.addr + ((seg_no - sc.first_seg) * sc.seg_size);
+}
+#endif
+
 } /* end of namespace MemMgrLite */
 
 /* getSegAddr.cxx */
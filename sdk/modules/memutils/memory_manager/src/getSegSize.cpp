@@ -35,6 +35,7 @@
 
 #include "memutils/memory_manager/MemHandleBase.h"
 #include "BasicPool.h"
+#include "SizeClassPool.h"
 
 namespace MemMgrLite {
 
@@ -45,15 +46,24 @@ PoolSize Manager::getSegSize(const MemHandleBase& mh)
 {
 	MemPool* pool = findPool(mh.getPoolId());
 
-#ifdef USE_MEMMGR_RINGBUF_POOL
+#if defined(USE_MEMMGR_RINGBUF_POOL) || \
+    defined(CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL)
 	/* 仮想関数を使用しない方針なので、該当プール型にダウンキャストする */
 	PoolSize size = 0;
 	switch (pool->getPoolType()) {
 	case BasicType:
 		size = static_cast<BasicPool*>(pool)->getSegSize();
 		break;
+#ifdef USE_MEMMGR_RINGBUF_POOL
 	case RingBufType:
 		size = static_cast<RingBufPool*>(pool)->getSegSize();
+		break;
+#endif
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+	case SizeClassType:
+		size = static_cast<SizeClassPool*>(pool)->getSegSize(mh);
+		break;
+#endif
 	default:
 		D_ASSERT(false);
 		break;
@@ -65,6 +75,16 @@ PoolSize Manager::getSegSize(const MemHandleBase& mh)
 #endif
 }
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL
+/*****************************************************************
+ * Get the size of a segment of a size class pool
+ *****************************************************************/
+PoolSize SizeClassPool::getSegSize(const MemHandleBase& mh) const
+{
+	return findClass(mh.getSegNo()).seg_size;
+}
+#endif
+
 } /* end of namespace MemMgrLite */
 
 /* getSegSize.cxx */
@@ -63,9 +63,15 @@ void MemPool::incSegRefCnt(NumSeg seg_no)
 	NumSeg ref_idx = seg_no - 1;
 	D_ASSERT(m_ref_cnt_array[ref_idx] != 0);	/* 使用中のはず */
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE
+	SegRefCnt cnt = __atomic_add_fetch(&m_ref_cnt_array[ref_idx], 1, __ATOMIC_RELAXED);
+	D_ASSERT(cnt != 0);	/* ラップチェック */
+	(void)cnt;
+#else
 	ScopedLock lock;
 	++m_ref_cnt_array[ref_idx];
 	D_ASSERT(m_ref_cnt_array[ref_idx] != 0);	/* ラップチェック */
+#endif
 }
 
 } /* end of namespace MemMgrLite */
@@ -36,6 +36,9 @@
 #include <new>
 #include <string.h>
 #include "memutils/memory_manager/Manager.h"
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+#include "StatsTime.h"
+#endif
 
 namespace MemMgrLite {
 
@@ -67,6 +70,12 @@ err_t Manager::initFirst(void* manager_area, uint32_t area_size)
 
   new(manager_area) Manager;
 
+#ifdef CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+  /* Start the time base of the allocation latency statistics */
+
+  enableStatsTime();
+#endif
+
   return ERR_OK;
 }
 
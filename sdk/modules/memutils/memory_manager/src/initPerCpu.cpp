@@ -45,7 +45,8 @@ extern MemPool* static_pools[];
 /*****************************************************************
  * MemoryManagerのCPU毎の初期化。各CPUで1回だけ呼出すこと
  *****************************************************************/
-err_t Manager::initPerCpu(void* manager_area, MemPool** pools[], uint8_t* pool_num, uint8_t* layout_no)
+err_t Manager::initPerCpu(void* manager_area, MemPool** pools[], uint8_t* pool_num, uint8_t* layout_no,
+                          NumSection sec_num)
 {
 #ifdef USE_MEMMGR_DEBUG_OUTPUT
   printf("Manager::initPerCpu(addr=%08x)\n", manager_area);
@@ -61,6 +62,7 @@ err_t Manager::initPerCpu(void* manager_area, MemPool** pools[], uint8_t* pool_n
   theManager = static_cast<Manager*>(manager_area);
 
   theManager->m_fix_fene_num = CONFIG_MEMUTILS_MEMORY_MANAGER_NUM_FIXED_AREA_FENCES;
+  theManager->m_sec_num      = sec_num;
   theManager->m_pool_num     = pool_num;
   theManager->m_layout_no    = layout_no;
   theManager->m_static_pools = pools;
@@ -53,6 +53,42 @@ UseSegThreshold     = false
 UseRingBufPool      = false
 UseRingBufThreshold = false
 
+#####################################################################
+# Per-CPU segment cache of the lock-free pool
+#
+# With CONFIG_MEMUTILS_MEMORY_MANAGER_LOCKFREE and CONFIG_SMP, set it
+# in the config file to CONFIG_SMP_NCPUS *
+# CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE.
+#
+
+CpuCacheSlots = 0 unless defined?(CpuCacheSlots)
+
+#####################################################################
+# Pool usage statistics
+#
+# With CONFIG_MEMUTILS_MEMORY_MANAGER_STATS, set UsePoolStats to true
+# in the config file.
+#
+# PoolPeaks names a file of "section pool_id peak" lines as printed by
+# "mmstat -p".  The number of segments of every fixed size pool is then
+# trimmed to its observed peak plus PoolPeakMargin.  Concatenate the
+# output of several runs to keep the largest peak of each pool.
+#
+
+UsePoolStats   = false unless defined?(UsePoolStats)
+PoolPeaks      = nil   unless defined?(PoolPeaks)
+PoolPeakMargin = 1     unless defined?(PoolPeakMargin)
+
+#####################################################################
+# Size class pools
+#
+# With CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL, set
+# UseSizeClassPool to true in the config file.  PoolAttr then has the
+# pointer to the size classes.
+#
+
+UseSizeClassPool = false unless defined?(UseSizeClassPool)
+
 #####################################################################
 # Fixed parameters of pool layout
 #
@@ -416,21 +452,59 @@ end
 
 # When creating a memory pool, the necessary work area size for each pool
 #  - Alignment adjustment of MemPool area         : 0-3
-#  - Pool attribute area(Usually in static pool 0): 0, 12 or 16
+#  - Pool attribute area(Usually in static pool 0): 0, 12, 16 or 20
 #  - BasicPool(=MemPool) area                      : 12 + 4 * sizeof(NumSeg)
+#  - Per-CPU cache pointer and slots               : 0 or 4 + CpuCacheSlots * sizeof(NumSeg)
+#  - Usage statistics                              : 0 or 32
 #  - RingBufPool area                              : To be determined(MemPool Area+alpha)
 #  - Data area of the segment number queue         : Number of segments * sizeof(NumSeg)
 #  - Reference counter area                        : Number of segments * sizeof(SegRefCnt)
 NumSegSize              = UseOver255Segments ? 2 : 1
 SegRefCntSize           = 1
-PoolAttrSize            = round_up(10 + NumSegSize + (UseFence ? 1 : 0) + (UseMultiCore ? 1 : 0), 4)
-MemPoolDataSize         = 12 + 4 * NumSegSize   # 16 or 20
+PoolStatsSize           = UsePoolStats ? 32 : 0
+PoolAttrSize            = round_up(10 + NumSegSize + (UseFence ? 1 : 0) + (UseMultiCore ? 1 : 0), 4) +
+                          (UseSizeClassPool ? 4 : 0)  # Size classes pointer
+MemPoolDataSize         = 12 + 4 * NumSegSize +  # 16 or 20
+                          ((CpuCacheSlots > 0) ? 4 + CpuCacheSlots * NumSegSize : 0) +
+                          PoolStatsSize
 BasicPoolDataSize       = MemPoolDataSize
 RingBufPoolDataSize     = MemPoolDataSize + 32  # Tentative value for details unexamined
 RingBufPoolSegDataSize  = 8                     # Tentative value for details unexamined
 
+#######################################################################
+# Observed peaks, pool_id => peak (section 0 only)
+def load_pool_peaks(file)
+  peaks = {}
+  File.foreach(file) do |line|
+    next if line =~ /^\s*(#|$)/
+    sec, id, peak = line.split.collect {|v| Integer(v)}
+    abort("Bad line found in #{file}: #{line}") if peak == nil
+    peaks[id] = [peaks[id] || 0, peak].max if sec == 0
+  end
+  return peaks
+end
+
+PoolPeakTable = PoolPeaks ? load_pool_peaks(PoolPeaks) : nil
+
+# Reduce the number of segments of a fixed size pool to the observed peak.
+# The segment size is kept.
+def trim_pool_arg(arg, id)
+  name, area, align, size, seg, fence = arg
+  peak = PoolPeakTable[id]
+  return arg if !peak or size == RemainderSize
+
+  new_seg = [[peak + PoolPeakMargin, 1].max, seg].min
+  return arg if new_seg == seg
+
+  new_size = round_up((size / seg) * new_seg, MinAlign)
+  $stderr.print("Trim #{name}: seg #{seg} -> #{new_seg} (peak #{peak}), size 0x#{size.to_s(16)} -> 0x#{new_size.to_s(16)}\n")
+  return [name, area, align, new_size, new_seg, fence]
+end
+
 #######################################################################
 class PoolLayout
+  @@names = []   # Pool names in the order of their IDs
+
   def initialize(*args)
     @pools = []
     args.each do |arg|
@@ -445,6 +519,8 @@ class PoolLayout
 
   def check_and_set_arg(arg)
     if UseFixedPoolLayout
+      @@names.push(arg[0]) if !@@names.include?(arg[0])
+      arg = trim_pool_arg(arg, @@names.index(arg[0]) + 1) if PoolPeakTable
       new_pool = PoolEntryFixParam.new(*arg)
     else
       new_pool = PoolEntry.new(*arg)
@@ -0,0 +1,305 @@
+/****************************************************************************
+ * modules/ringbuffer/host/spsc_bench.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host benchmark of the SPSC ring buffer against the locked one.
+ *
+ * Three variants move the same stream in chunks of several sizes:
+ *
+ *   locked : ringbuf_write()/ringbuf_read() with a mutex held around each
+ *            call, which is what users of struct ringbuf_s shared between
+ *            two tasks have to do
+ *   copy   : ringbuf_spsc_write()/ringbuf_spsc_read()
+ *   span   : ringbuf_spsc_reserve()/commit() and peek()/consume(), with
+ *            the data copied in and out of the spans
+ *
+ * "1 thread" alternates a write and a read of one chunk in a single thread
+ * and gives the cost of the pair without contention. "2 threads" runs a
+ * producer and a consumer thread and gives the throughput; on a host with
+ * a single CPU it mostly measures the scheduler.
+ *
+ *   spsc_bench [megabytes]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ringbuffer/ringbuffer.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b)  (((a) < (b)) ? (a) : (b))
+#endif
+
+#define RING_SIZE  16384
+#define MAX_CHUNK  4096
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum variant_e
+{
+  VARIANT_LOCKED = 0,
+  VARIANT_COPY,
+  VARIANT_SPAN,
+  VARIANT_NUM
+};
+
+struct bench_s
+{
+  enum variant_e variant;
+  FAR struct ringbuf_s *locked;
+  FAR struct ringbuf_spsc_s *spsc;
+  pthread_mutex_t lock;
+  size_t chunk;
+  size_t total;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Put up to count bytes, return the number of bytes put */
+
+static size_t put(struct bench_s *b, const uint8_t *data, size_t count)
+{
+  FAR uint8_t *span;
+  ssize_t ret;
+  size_t n;
+
+  switch (b->variant)
+    {
+      case VARIANT_LOCKED:
+        pthread_mutex_lock(&b->lock);
+        ret = ringbuf_write(b->locked, (FAR void *)data, count);
+        pthread_mutex_unlock(&b->lock);
+        return ret < 0 ? 0 : ret;
+
+      case VARIANT_COPY:
+        ret = ringbuf_spsc_write(b->spsc, data, count);
+        return ret < 0 ? 0 : ret;
+
+      default:
+        n = ringbuf_spsc_reserve(b->spsc, &span);
+        n = MIN(n, count);
+        memcpy(span, data, n);
+        ringbuf_spsc_commit(b->spsc, n);
+        return n;
+    }
+}
+
+/* Get up to count bytes, return the number of bytes got */
+
+static size_t get(struct bench_s *b, uint8_t *data, size_t count)
+{
+  FAR uint8_t *span;
+  ssize_t ret;
+  size_t n;
+
+  switch (b->variant)
+    {
+      case VARIANT_LOCKED:
+        pthread_mutex_lock(&b->lock);
+        ret = ringbuf_read(b->locked, data, count);
+        pthread_mutex_unlock(&b->lock);
+        return ret < 0 ? 0 : ret;
+
+      case VARIANT_COPY:
+        ret = ringbuf_spsc_read(b->spsc, data, count);
+        return ret < 0 ? 0 : ret;
+
+      default:
+        n = ringbuf_spsc_peek(b->spsc, &span);
+        n = MIN(n, count);
+        memcpy(data, span, n);
+        ringbuf_spsc_consume(b->spsc, n);
+        return n;
+    }
+}
+
+static void *producer(void *arg)
+{
+  static uint8_t data[MAX_CHUNK];
+  struct bench_s *b = (struct bench_s *)arg;
+  size_t pos = 0;
+  size_t n;
+
+  while (pos < b->total)
+    {
+      n = put(b, data, MIN(b->chunk, b->total - pos));
+      if (!n)
+        {
+          sched_yield();
+        }
+
+      pos += n;
+    }
+
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  static uint8_t data[MAX_CHUNK];
+  struct bench_s *b = (struct bench_s *)arg;
+  size_t pos = 0;
+  size_t n;
+
+  while (pos < b->total)
+    {
+      n = get(b, data, b->chunk);
+      if (!n)
+        {
+          sched_yield();
+        }
+
+      pos += n;
+    }
+
+  return NULL;
+}
+
+/* Return ns per write and read pair */
+
+static double bench_single(struct bench_s *b)
+{
+  static uint8_t data[MAX_CHUNK];
+  size_t count = b->total / b->chunk;
+  double start;
+  size_t i;
+
+  start = now();
+  for (i = 0; i < count; i++)
+    {
+      put(b, data, b->chunk);
+      get(b, data, b->chunk);
+    }
+
+  return (now() - start) * 1e9 / count;
+}
+
+/* Return MB/s */
+
+static double bench_threads(struct bench_s *b)
+{
+  pthread_t prod;
+  pthread_t cons;
+  double start;
+
+  start = now();
+  pthread_create(&prod, NULL, producer, b);
+  pthread_create(&cons, NULL, consumer, b);
+  pthread_join(prod, NULL);
+  pthread_join(cons, NULL);
+
+  return b->total / (now() - start) / 1e6;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const size_t chunks[] =
+  {
+    16, 64, 256, 1024, MAX_CHUNK
+  };
+
+  struct bench_s b;
+  size_t mb = (argc > 1) ? strtoul(argv[1], NULL, 0) : 64;
+  double single[VARIANT_NUM];
+  double threads[VARIANT_NUM];
+  int v;
+  int i;
+
+  memset(&b, 0, sizeof(b));
+  pthread_mutex_init(&b.lock, NULL);
+  b.locked = ringbuf_new(RING_SIZE);
+  b.spsc   = ringbuf_spsc_new(RING_SIZE);
+  b.total  = mb << 20;
+  if (!b.locked || !b.spsc)
+    {
+      printf("no memory\n");
+      return EXIT_FAILURE;
+    }
+
+  printf("%zu MB through a %d byte ring\n\n", mb, RING_SIZE);
+  printf("        1 thread [ns per write+read]  2 threads [MB/s]\n");
+  printf("chunk   locked    copy    span        locked    copy    span\n");
+
+  for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+    {
+      b.chunk = chunks[i];
+
+      for (v = 0; v < VARIANT_NUM; v++)
+        {
+          b.variant  = (enum variant_e)v;
+          single[v]  = bench_single(&b);
+          threads[v] = bench_threads(&b);
+        }
+
+      printf("%5zu  %7.1f %7.1f %7.1f     %9.0f %7.0f %7.0f\n", b.chunk,
+             single[VARIANT_LOCKED], single[VARIANT_COPY],
+             single[VARIANT_SPAN], threads[VARIANT_LOCKED],
+             threads[VARIANT_COPY], threads[VARIANT_SPAN]);
+    }
+
+  ringbuf_free(b.locked);
+  ringbuf_spsc_free(b.spsc);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,367 @@
+/****************************************************************************
+ * modules/ringbuffer/host/spsc_stress.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host two thread stress test of ringbuffer_spsc.c.
+ *
+ * A producer and a consumer thread move a byte stream through rings of
+ * several sizes. Each side picks at random between the copy API (write,
+ * read) and the span API (reserve/commit, peek/consume), with random sizes
+ * and partial commits and consumes, so transfers start and end anywhere
+ * and wrap often. The consumer checks every byte against the stream
+ * position, which also catches data read before it was published or
+ * overwritten before it was consumed. Guard bytes around the ring buffer
+ * catch writes outside of it.
+ *
+ * Each side also checks that a span never reaches past the end of the
+ * ring, and that the level seen afterwards by bytesavail() or bytesused()
+ * is not below the span it got, as the other side can only make it grow.
+ *
+ * The test is killed by SIGALRM if a side stops making progress.
+ *
+ *   spsc_stress [bytes per ring size]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ringbuffer/ringbuffer.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b)  (((a) < (b)) ? (a) : (b))
+#endif
+
+#define GUARD_SIZE   64
+#define GUARD_BYTE   0xa5
+#define MAX_RING     65536
+#define TIMEOUT_SEC  300
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct stress_s
+{
+  struct ringbuf_spsc_s rb;
+  FAR uint8_t *ring;
+  size_t size;
+  size_t total;
+  int stop;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned long g_errors;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(uint32_t *seed)
+{
+  *seed = *seed * 1103515245 + 12345;
+  return *seed >> 8;
+}
+
+/* Byte at stream position pos. Not periodic in any ring size, so a byte
+ * taken from the wrong lap of the ring does not match.
+ */
+
+static uint8_t pattern(size_t pos)
+{
+  return (uint8_t)(((uint32_t)pos * 0x9e3779b1u) >> 24);
+}
+
+static void fail(struct stress_s *st, const char *what, size_t pos)
+{
+  pthread_mutex_lock(&g_lock);
+  if (g_errors++ < 8)
+    {
+      printf("%s: ring %zu, position %zu\n", what, st->size, pos);
+    }
+
+  pthread_mutex_unlock(&g_lock);
+  __atomic_store_n(&st->stop, 1, __ATOMIC_RELAXED);
+}
+
+static bool stopped(struct stress_s *st)
+{
+  return __atomic_load_n(&st->stop, __ATOMIC_RELAXED) != 0;
+}
+
+static bool check_span(struct stress_s *st, FAR uint8_t *span, size_t n)
+{
+  return span >= st->ring && span + n <= st->ring + st->size &&
+         n <= st->size;
+}
+
+static void *producer(void *arg)
+{
+  static uint8_t tmp[MAX_RING];
+  struct stress_s *st = (struct stress_s *)arg;
+  uint32_t seed = 1 + (uint32_t)st->size;
+  size_t pos = 0;
+  FAR uint8_t *span;
+  size_t n;
+  size_t m;
+  size_t k;
+  ssize_t ret;
+
+  while (pos < st->total && !stopped(st))
+    {
+      if (rnd(&seed) & 1)
+        {
+          n = ringbuf_spsc_reserve(&st->rb, &span);
+          if (!check_span(st, span, n) ||
+              ringbuf_spsc_bytesavail(&st->rb) < n)
+            {
+              fail(st, "reserve", pos);
+              break;
+            }
+
+          m = rnd(&seed) % (n + 1);
+          m = MIN(m, st->total - pos);
+          for (k = 0; k < m; k++)
+            {
+              span[k] = pattern(pos + k);
+            }
+
+          ringbuf_spsc_commit(&st->rb, m);
+        }
+      else
+        {
+          m = 1 + rnd(&seed) % st->size;
+          m = MIN(m, st->total - pos);
+          for (k = 0; k < m; k++)
+            {
+              tmp[k] = pattern(pos + k);
+            }
+
+          ret = ringbuf_spsc_write(&st->rb, tmp, m);
+          if (ret == -ENOSPC)
+            {
+              m = 0;
+            }
+          else if (ret != (ssize_t)m)
+            {
+              fail(st, "write", pos);
+              break;
+            }
+        }
+
+      pos += m;
+      if (!m)
+        {
+          sched_yield();
+        }
+    }
+
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  static uint8_t tmp[MAX_RING];
+  struct stress_s *st = (struct stress_s *)arg;
+  uint32_t seed = 2 + (uint32_t)st->size;
+  size_t pos = 0;
+  FAR uint8_t *span;
+  FAR uint8_t *data;
+  size_t n;
+  size_t m;
+  size_t k;
+  ssize_t ret;
+
+  while (pos < st->total && !stopped(st))
+    {
+      if (rnd(&seed) & 1)
+        {
+          n = ringbuf_spsc_peek(&st->rb, &span);
+          if (!check_span(st, span, n) ||
+              ringbuf_spsc_bytesused(&st->rb) < n)
+            {
+              fail(st, "peek", pos);
+              break;
+            }
+
+          m = rnd(&seed) % (n + 1);
+          data = span;
+        }
+      else
+        {
+          ret = ringbuf_spsc_read(&st->rb, tmp, 1 + rnd(&seed) % st->size);
+          if (ret < 0 || ret > (ssize_t)st->size)
+            {
+              fail(st, "read", pos);
+              break;
+            }
+
+          m = ret;
+          data = tmp;
+        }
+
+      if (pos + m > st->total)
+        {
+          fail(st, "data past the end of the stream", pos);
+          break;
+        }
+
+      for (k = 0; k < m; k++)
+        {
+          if (data[k] != pattern(pos + k))
+            {
+              fail(st, "data", pos + k);
+              return NULL;
+            }
+        }
+
+      if (data == span)
+        {
+          ringbuf_spsc_consume(&st->rb, m);
+        }
+
+      pos += m;
+      if (!m)
+        {
+          sched_yield();
+        }
+    }
+
+  return NULL;
+}
+
+static void run(size_t size, size_t total)
+{
+  static uint8_t mem[MAX_RING + 2 * GUARD_SIZE];
+  struct stress_s st;
+  pthread_t prod;
+  pthread_t cons;
+  size_t k;
+
+  memset(&st, 0, sizeof(st));
+  memset(mem, GUARD_BYTE, sizeof(mem));
+  st.ring  = mem + GUARD_SIZE;
+  st.size  = size;
+  st.total = total;
+
+  if (ringbuf_spsc_init(&st.rb, st.ring, size) != 0)
+    {
+      fail(&st, "init", 0);
+      return;
+    }
+
+  pthread_create(&prod, NULL, producer, &st);
+  pthread_create(&cons, NULL, consumer, &st);
+  pthread_join(prod, NULL);
+  pthread_join(cons, NULL);
+
+  if (!stopped(&st) && ringbuf_spsc_bytesused(&st.rb) != 0)
+    {
+      fail(&st, "bytes left", total);
+    }
+
+  for (k = 0; k < GUARD_SIZE; k++)
+    {
+      if (mem[k] != GUARD_BYTE || mem[GUARD_SIZE + size + k] != GUARD_BYTE)
+        {
+          fail(&st, "guard", k);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const size_t sizes[] =
+  {
+    2, 8, 64, 4096, MAX_RING
+  };
+
+  struct ringbuf_spsc_s rb;
+  uint8_t buf[8];
+  size_t total = (argc > 1) ? strtoul(argv[1], NULL, 0) : 4 << 20;
+  FAR struct ringbuf_spsc_s *owned;
+  int i;
+
+  alarm(TIMEOUT_SEC);
+
+  if (ringbuf_spsc_init(&rb, buf, 6) != -EINVAL ||
+      ringbuf_spsc_init(&rb, buf, 1) != -EINVAL ||
+      ringbuf_spsc_new(12) != NULL)
+    {
+      printf("size which is not a power of two accepted\n");
+      g_errors++;
+    }
+
+  owned = ringbuf_spsc_new(64);
+  if (!owned || ringbuf_spsc_bytesavail(owned) != 64 ||
+      ringbuf_spsc_bytesused(owned) != 0)
+    {
+      printf("ringbuf_spsc_new\n");
+      g_errors++;
+    }
+
+  ringbuf_spsc_free(owned);
+
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+      run(sizes[i], total);
+    }
+
+  printf("%zu bytes through %d ring sizes, %lu errors\n",
+         total, i, g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
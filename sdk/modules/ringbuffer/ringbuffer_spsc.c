@@ -0,0 +1,415 @@
+/****************************************************************************
+ * modules/ringbuffer/ringbuffer_spsc.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "ringbuffer/ringbuffer.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#  define MIN(a,b)  (((a) < (b)) ? (a) : (b))
+#endif
+
+/* The producer owns tail and the consumer owns head.  Each side reads its
+ * own index relaxed and the other side's index with acquire, and publishes
+ * its own index with release after touching the data.
+ */
+
+#define load_own(p)       __atomic_load_n((p), __ATOMIC_RELAXED)
+#define load_other(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define publish(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_spsc_size
+ ****************************************************************************/
+
+static inline size_t ringbuf_spsc_size(FAR struct ringbuf_spsc_s *rb)
+{
+  return rb->mask + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_spsc_init
+ *
+ * Description:
+ *   Initialize a single producer / single consumer Ring Buffer on a caller
+ *   provided buffer.
+ *
+ * Input Parameters:
+ *   rb    Pointer to a Ring Buffer.
+ *   buf   Storage for the Ring Buffer.
+ *   size  Size of buf, must be a power of two.
+ *
+ * Returned Value:
+ *   On success, 0 is returned.
+ *   On failure, negative value is returned according to <errno.h>.
+ *
+ ****************************************************************************/
+
+int ringbuf_spsc_init(FAR struct ringbuf_spsc_s *rb, FAR void *buf,
+                      size_t size)
+{
+  if (!rb || !buf || size < 2 || (size & (size - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  rb->buf   = (FAR uint8_t *)buf;
+  rb->mask  = size - 1;
+  rb->head  = 0;
+  rb->tail  = 0;
+  rb->owned = false;
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_new
+ *
+ * Description:
+ *   Allocates a new single producer / single consumer Ring Buffer.
+ *
+ * Input Parameters:
+ *   size  Size of Ring Buffer to allocate, must be a power of two.
+ *
+ * Returned Value:
+ *   On success, the allocated Ring Buffer is returned.
+ *   On failure, NULL is returned.
+ *
+ ****************************************************************************/
+
+FAR struct ringbuf_spsc_s *ringbuf_spsc_new(size_t size)
+{
+  FAR struct ringbuf_spsc_s *rb;
+  FAR void *buf;
+
+  if (size < 2 || (size & (size - 1)) != 0)
+    {
+      return NULL;
+    }
+
+  rb = (FAR struct ringbuf_spsc_s *)malloc(sizeof(struct ringbuf_spsc_s));
+  if (rb)
+    {
+      buf = calloc(1, size);
+      if (buf)
+        {
+          ringbuf_spsc_init(rb, buf, size);
+          rb->owned = true;
+        }
+      else
+        {
+          free(rb);
+          rb = NULL;
+        }
+    }
+
+  return rb;
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_free
+ *
+ * Description:
+ *   Release a Ring Buffer allocated by ringbuf_spsc_new().
+ *
+ * Input Parameters:
+ *   rb  Pointer to a Ring Buffer to release.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ringbuf_spsc_free(FAR struct ringbuf_spsc_s *rb)
+{
+  if (rb && rb->owned)
+    {
+      free(rb->buf);
+      free(rb);
+    }
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_reserve
+ *
+ * Description:
+ *   Get a contiguous writable span. Producer side only.
+ *
+ * Input Parameters:
+ *   rb    Pointer to a Ring Buffer.
+ *   span  Returns the start of the writable span.
+ *
+ * Returned Value:
+ *   Length of the span in bytes, 0 if the buffer is full.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_spsc_reserve(FAR struct ringbuf_spsc_s *rb,
+                            FAR uint8_t **span)
+{
+  size_t tail = load_own(&rb->tail);
+  size_t head = load_other(&rb->head);
+  size_t offset = tail & rb->mask;
+  size_t avail = ringbuf_spsc_size(rb) - (tail - head);
+
+  *span = rb->buf + offset;
+  return MIN(avail, ringbuf_spsc_size(rb) - offset);
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_commit
+ *
+ * Description:
+ *   Publish bytes written into a reserved span. Producer side only.
+ *
+ * Input Parameters:
+ *   rb     Pointer to a Ring Buffer.
+ *   count  Bytes to publish.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ringbuf_spsc_commit(FAR struct ringbuf_spsc_s *rb, size_t count)
+{
+  publish(&rb->tail, load_own(&rb->tail) + count);
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_peek
+ *
+ * Description:
+ *   Get a contiguous readable span. Consumer side only.
+ *
+ * Input Parameters:
+ *   rb    Pointer to a Ring Buffer.
+ *   span  Returns the start of the readable span.
+ *
+ * Returned Value:
+ *   Length of the span in bytes, 0 if the buffer is empty.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_spsc_peek(FAR struct ringbuf_spsc_s *rb, FAR uint8_t **span)
+{
+  size_t head = load_own(&rb->head);
+  size_t tail = load_other(&rb->tail);
+  size_t offset = head & rb->mask;
+
+  *span = rb->buf + offset;
+  return MIN(tail - head, ringbuf_spsc_size(rb) - offset);
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_consume
+ *
+ * Description:
+ *   Release bytes obtained from a peeked span. Consumer side only.
+ *
+ * Input Parameters:
+ *   rb     Pointer to a Ring Buffer.
+ *   count  Bytes to release.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ringbuf_spsc_consume(FAR struct ringbuf_spsc_s *rb, size_t count)
+{
+  publish(&rb->head, load_own(&rb->head) + count);
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_write
+ *
+ * Description:
+ *   Write to a single producer / single consumer Ring Buffer.
+ *
+ * Input Parameters:
+ *   rb     Pointer to a Ring Buffer to write.
+ *   buf    Data to write.
+ *   count  Bytes to write.
+ *
+ * Returned Value:
+ *   On success, The number of bytes written.
+ *   -ENOSPC if count bytes do not fit.
+ *
+ ****************************************************************************/
+
+ssize_t ringbuf_spsc_write(FAR struct ringbuf_spsc_s *rb,
+                           FAR const void *buf, size_t count)
+{
+  size_t tail;
+  size_t offset;
+  size_t first;
+
+  if (!rb)
+    {
+      return -EINVAL;
+    }
+
+  tail = load_own(&rb->tail);
+  if (ringbuf_spsc_size(rb) - (tail - load_other(&rb->head)) < count)
+    {
+      return -ENOSPC;
+    }
+
+  offset = tail & rb->mask;
+  first  = MIN(count, ringbuf_spsc_size(rb) - offset);
+
+  memcpy(rb->buf + offset, buf, first);
+  memcpy(rb->buf, (FAR const uint8_t *)buf + first, count - first);
+
+  publish(&rb->tail, tail + count);
+  return count;
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_read
+ *
+ * Description:
+ *   Read from a single producer / single consumer Ring Buffer.
+ *
+ * Input Parameters:
+ *   rb     Pointer to a Ring Buffer to read.
+ *   buf    Pointer to buffer to store data.
+ *   count  Maximum bytes to read.
+ *
+ * Returned Value:
+ *   The number of bytes read.
+ *
+ ****************************************************************************/
+
+ssize_t ringbuf_spsc_read(FAR struct ringbuf_spsc_s *rb, FAR void *buf,
+                          size_t count)
+{
+  size_t head;
+  size_t tail;
+  size_t offset;
+  size_t first;
+
+  if (!rb)
+    {
+      return -EINVAL;
+    }
+
+  /* Load tail once, MIN() evaluates its arguments twice */
+
+  head   = load_own(&rb->head);
+  tail   = load_other(&rb->tail);
+  count  = MIN(count, tail - head);
+  offset = head & rb->mask;
+  first  = MIN(count, ringbuf_spsc_size(rb) - offset);
+
+  memcpy(buf, rb->buf + offset, first);
+  memcpy((FAR uint8_t *)buf + first, rb->buf, count - first);
+
+  publish(&rb->head, head + count);
+  return count;
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_bytesused
+ *
+ * Description:
+ *   Gets the number of bytes used.
+ *
+ * Input Parameters:
+ *   rb  Pointer to a Ring Buffer.
+ *
+ * Returned Value:
+ *   The number of bytes used.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_spsc_bytesused(FAR struct ringbuf_spsc_s *rb)
+{
+  if (!rb)
+    {
+      return 0;
+    }
+
+  size_t head = load_other(&rb->head);
+
+  /* Load head first so a concurrent consumer can never make it pass the
+   * tail value read afterwards.
+   */
+
+  return load_other(&rb->tail) - head;
+}
+
+/****************************************************************************
+ * Name: ringbuf_spsc_bytesavail
+ *
+ * Description:
+ *   Gets the number of bytes free.
+ *
+ * Input Parameters:
+ *   rb  Pointer to a Ring Buffer.
+ *
+ * Returned Value:
+ *   The number of bytes free.
+ *
+ ****************************************************************************/
+
+size_t ringbuf_spsc_bytesavail(FAR struct ringbuf_spsc_s *rb)
+{
+  if (!rb)
+    {
+      return 0;
+    }
+
+  return ringbuf_spsc_size(rb) - ringbuf_spsc_bytesused(rb);
+}
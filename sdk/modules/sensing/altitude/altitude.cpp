@@ -0,0 +1,427 @@
+/****************************************************************************
+ * modules/sensing/altitude/altitude.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <math.h>
+#include <debug.h>
+
+#include "sensing/logical_sensor/altitude.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ALTITUDE_GRAVITY         9.80665f /* [m/s^2] per [G] */
+#define ALTITUDE_GRAVITY_TC      1.f      /* Gravity direction tracking [s] */
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Time stamps of sensor commands are 24 bit milliseconds */
+
+static inline int32_t time_diff(uint32_t a, uint32_t b)
+{
+  return (int32_t)((a - b) << 8) >> 8;
+}
+
+static inline uint32_t sample_time(uint32_t time, int index, int fs)
+{
+  return (time + (uint32_t)index * 1000 / fs) & 0xffffff;
+}
+
+/*--------------------------------------------------------------------*/
+int AltitudeClass::open(FAR AltitudeSetting *setting)
+{
+  if (setting == NULL || setting->acc_noise <= 0.f ||
+      setting->baro_noise <= 0.f || setting->bias_noise < 0.f)
+    {
+      return SS_ECODE_PARAM_ERROR;
+    }
+
+  m_setting     = *setting;
+  m_initialized = false;
+  m_has_accel   = false;
+  m_baro_head   = 0;
+  m_baro_num    = 0;
+  m_hist_head   = 0;
+  m_hist_num    = 0;
+
+  return SS_ECODE_OK;
+}
+
+/*--------------------------------------------------------------------*/
+int AltitudeClass::close(void)
+{
+  return SS_ECODE_OK;
+}
+
+/*--------------------------------------------------------------------*/
+int AltitudeClass::write(FAR sensor_command_data_mh_t *command)
+{
+  if (command->fs == 0)
+    {
+      return SS_ECODE_PARAM_ERROR;
+    }
+
+  switch (command->self)
+    {
+      case accelID:
+        this->writeAccel(command);
+        break;
+
+      case barometerID:
+        this->writeBarometer(command);
+        break;
+
+      default:
+        return SS_ECODE_PARAM_ERROR;
+    }
+
+  if (!m_initialized || !m_has_accel || command->self != accelID)
+    {
+      return SS_ECODE_OK;
+    }
+
+  return this->send();
+}
+
+/*--------------------------------------------------------------------*/
+void AltitudeClass::writeAccel(FAR sensor_command_data_mh_t *command)
+{
+  FAR ThreeAxisSample *acc =
+    reinterpret_cast<FAR ThreeAxisSample *>(command->mh.getVa());
+  float alpha;
+  float norm;
+  float dt;
+  uint32_t time;
+
+  for (int i = 0; i < command->size; i++, acc++)
+    {
+      time = sample_time(command->time, i, command->fs);
+
+      if (!m_has_accel)
+        {
+          m_gravity[0] = acc->ax;
+          m_gravity[1] = acc->ay;
+          m_gravity[2] = acc->az;
+          m_has_accel  = true;
+          m_time       = time;
+          continue;
+        }
+
+      dt = time_diff(time, m_time) / 1000.f;
+      if (dt <= 0.f)
+        {
+          dt = 1.f / command->fs;
+        }
+
+      /* Gravity is the slow part of acceleration, the rest of it along
+       * gravity is the vertical acceleration. The filter takes any
+       * remaining offset as bias.
+       */
+
+      alpha = dt / (ALTITUDE_GRAVITY_TC + dt);
+      m_gravity[0] += alpha * (acc->ax - m_gravity[0]);
+      m_gravity[1] += alpha * (acc->ay - m_gravity[1]);
+      m_gravity[2] += alpha * (acc->az - m_gravity[2]);
+
+      norm = sqrtf(m_gravity[0] * m_gravity[0] +
+                   m_gravity[1] * m_gravity[1] +
+                   m_gravity[2] * m_gravity[2]);
+
+      m_time = time;
+      if (!m_initialized || norm == 0.f)
+        {
+          continue;
+        }
+
+      /* Barometer samples up to this time correct the state before it
+       * moves forward.
+       */
+
+      this->flushBarometer(time);
+
+      this->predict(((acc->ax * m_gravity[0] + acc->ay * m_gravity[1] +
+                      acc->az * m_gravity[2]) / norm - norm) *
+                    ALTITUDE_GRAVITY, dt, time);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void AltitudeClass::writeBarometer(FAR sensor_command_data_mh_t *command)
+{
+  FAR uint32_t *pressure =
+    reinterpret_cast<FAR uint32_t *>(command->mh.getVa());
+  struct sample_s late[ALTITUDE_BARO_QUEUE_NUM];
+  struct sample_s baro;
+  int num = 0;
+
+  for (int i = 0; i < command->size; i++, pressure++)
+    {
+      if (*pressure == 0)
+        {
+          continue;
+        }
+
+      if (m_setting.reference <= 0.f)
+        {
+          m_setting.reference = (float)*pressure;
+        }
+
+      baro.time     = sample_time(command->time, i, command->fs);
+      baro.altitude = kalman_altitude_pressure((float)*pressure,
+                                               m_setting.reference);
+
+      if (!m_initialized)
+        {
+          kalman_altitude_init(&m_kf, baro.altitude, m_setting.acc_noise,
+                               m_setting.bias_noise, m_setting.baro_noise);
+          m_checkpoint  = m_kf;
+          m_hist_num    = 0;
+          m_initialized = true;
+          continue;
+        }
+
+      if (!m_has_accel)
+        {
+          kalman_altitude_update(&m_kf, baro.altitude);
+          m_checkpoint = m_kf;
+          continue;
+        }
+
+      /* Barometer watermarks are long, so most samples are older than
+       * the last prediction and are replayed together. Newer ones wait
+       * for the accelerometer to reach them.
+       */
+
+      if (time_diff(baro.time, m_time) <= 0)
+        {
+          if (num == ALTITUDE_BARO_QUEUE_NUM)
+            {
+              this->replay(late, num);
+              num = 0;
+            }
+
+          late[num++] = baro;
+          continue;
+        }
+
+      if (m_baro_num == ALTITUDE_BARO_QUEUE_NUM)
+        {
+          this->flushBarometer(m_baro[m_baro_head].time);
+        }
+
+      m_baro[(m_baro_head + m_baro_num) % ALTITUDE_BARO_QUEUE_NUM] = baro;
+      m_baro_num++;
+    }
+
+  if (num > 0)
+    {
+      this->replay(late, num);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void AltitudeClass::predict(float acc, float dt, uint32_t time)
+{
+  FAR struct accel_s *entry;
+
+  kalman_altitude_predict(&m_kf, acc, dt);
+
+  /* When the history is full, its oldest sample is committed to the
+   * checkpoint. Barometer samples older than the remaining history
+   * cannot be placed in time any more.
+   */
+
+  if (m_hist_num == ALTITUDE_HISTORY_NUM)
+    {
+      entry = &m_history[m_hist_head];
+      kalman_altitude_predict(&m_checkpoint, entry->acc, entry->dt);
+      m_hist_head = (m_hist_head + 1) % ALTITUDE_HISTORY_NUM;
+      m_hist_num--;
+    }
+
+  entry = &m_history[(m_hist_head + m_hist_num) % ALTITUDE_HISTORY_NUM];
+  entry->time = time;
+  entry->acc  = acc;
+  entry->dt   = dt;
+  m_hist_num++;
+}
+
+/*--------------------------------------------------------------------*/
+void AltitudeClass::flushBarometer(uint32_t time)
+{
+  while (m_baro_num > 0 &&
+         time_diff(m_baro[m_baro_head].time, time) <= 0)
+    {
+      kalman_altitude_update(&m_kf, m_baro[m_baro_head].altitude);
+      m_baro_head = (m_baro_head + 1) % ALTITUDE_BARO_QUEUE_NUM;
+      m_baro_num--;
+
+      /* Everything before is final now */
+
+      m_checkpoint = m_kf;
+      m_hist_num   = 0;
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void AltitudeClass::replay(FAR struct sample_s *baro, int num)
+{
+  FAR struct accel_s *entry;
+  kalman_altitude_t kf = m_checkpoint;
+  int consumed = 0;
+  int i;
+  int j = 0;
+
+  /* Run the accelerometer samples since the checkpoint again with the
+   * barometer samples put in place, as if they had arrived in time.
+   * The checkpoint moves to the last barometer sample.
+   */
+
+  for (i = 0; i < m_hist_num; i++)
+    {
+      entry = &m_history[(m_hist_head + i) % ALTITUDE_HISTORY_NUM];
+
+      if (j < num && time_diff(baro[j].time, entry->time) <= 0)
+        {
+          while (j < num && time_diff(baro[j].time, entry->time) <= 0)
+            {
+              kalman_altitude_update(&kf, baro[j++].altitude);
+            }
+
+          m_checkpoint = kf;
+          consumed     = i;
+        }
+
+      kalman_altitude_predict(&kf, entry->acc, entry->dt);
+    }
+
+  if (j < num)
+    {
+      while (j < num)
+        {
+          kalman_altitude_update(&kf, baro[j++].altitude);
+        }
+
+      m_checkpoint = kf;
+      consumed     = m_hist_num;
+    }
+
+  m_hist_head = (m_hist_head + consumed) % ALTITUDE_HISTORY_NUM;
+  m_hist_num -= consumed;
+  m_kf = kf;
+}
+
+/*--------------------------------------------------------------------*/
+int AltitudeClass::send(void)
+{
+  MemMgrLite::MemHandle mh;
+
+  if (mh.allocSeg(m_rst_pool_id, sizeof(AltitudeResult)) != ERR_OK)
+    {
+      _err("allocSeg() failure.\n");
+      return SS_ECODE_MEMHANDLE_ALLOC_ERROR;
+    }
+
+  FAR AltitudeResult *result = static_cast<FAR AltitudeResult *>(mh.getVa());
+
+  result->time     = m_time;
+  result->altitude = m_kf.altitude;
+  result->velocity = m_kf.velocity;
+
+  sensor_command_data_mh_t packet;
+  packet.header.size = 0;
+  packet.header.code = SendData;
+  packet.self        = altitudeID;
+  packet.time        = m_time;
+  packet.fs          = 0;
+  packet.size        = 1;
+  packet.mh          = mh;
+
+  SS_SendSensorDataMH(&packet);
+
+  return SS_ECODE_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+AltitudeClass* AltitudeCreate(MemMgrLite::PoolId rst_pool_id)
+{
+  return new AltitudeClass(rst_pool_id);
+}
+
+AltitudeClass* AltitudeCreate(uint8_t rst_pool_id)
+{
+  MemMgrLite::PoolId pool_id;
+  pool_id.sec  = 0;
+  pool_id.pool = rst_pool_id;
+  return new AltitudeClass(pool_id);
+}
+
+int AltitudeOpen(FAR AltitudeClass *ins, FAR AltitudeSetting *setting)
+{
+  int ret;
+
+  ret = ins->open(setting);
+
+  return ret;
+}
+
+int AltitudeClose(FAR AltitudeClass *ins)
+{
+  int ret;
+
+  ret = ins->close();
+  delete ins;
+
+  return ret;
+}
+
+int AltitudeWrite(FAR AltitudeClass *ins,
+                  FAR sensor_command_data_mh_t *command)
+{
+  int ret;
+
+  ret = ins->write(command);
+
+  return ret;
+}
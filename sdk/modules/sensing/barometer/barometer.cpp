@@ -66,6 +66,29 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: divide
+ *
+ * Description:
+ *   n / d by a precomputed reciprocal r = 0xffffffff / d.
+ *   The estimate is at most one below the quotient and corrected, so the
+ *   result is identical to the division.
+ *
+ ****************************************************************************/
+
+static inline uint32_t divide(uint32_t n, uint32_t d, uint32_t r)
+{
+  uint32_t q = (uint32_t)(((uint64_t)n * r) >> 32);
+
+  if (n - q * d >= d)
+    {
+      q++;
+    }
+
+  return q;
+}
+
+/*--------------------------------------------------------------------*/
 int BarometerClass::open(void)
 {
   return 0;
@@ -129,8 +152,21 @@ int BarometerClass::write(sensor_command_data_mh_t* command)
 
       case tempID:
         {
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+          /* Only the newest temperature is kept, pressure of following
+           * watermarks is compensated with it.
+           */
+
+          int32_t* p_temp = (int32_t*)command->mh.getVa();
+
+          this->lastTemperature =
+            this->compensateTemperature(
+              p_temp[BAROMETER_TEMPERATURE_WATERMARK_NUM - 1]);
+          this->isValidTemperature = true;
+#else
           this->temperatureData = command->mh;
           this->isReceivedTemperatureData = true;
+#endif /* CONFIG_SENSING_BAROMETER_STREAMING */
         }
         break;
 
@@ -138,47 +174,70 @@ int BarometerClass::write(sensor_command_data_mh_t* command)
         break;
     }
 
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+  if (this->isReceivedPressureData && this->isValidTemperature)
+    {
+      this->compemsate();
+      this->send(command->time);
+    }
+#else
   if (this->isReceivedPressureData && this->isReceivedTemperatureData)
     {
       this->compemsate();
+      this->send(command->time);
 
-      sensor_command_data_mh_t packet;
-      packet.header.size = 0;
-      packet.header.code = SendData;
-      packet.self        = barometerID;
-      packet.time        = command->time;
-      packet.fs          = BAROMETER_PRESSURE_SAMPLING_FREQUENCY;
-      packet.size        = BAROMETER_PRESSURE_WATERMARK_NUM;
-      packet.mh          = this->pressureDate;
-
-      SS_SendSensorDataMH(&packet);
-
-      this->pressureDate.freeSeg();
       this->temperatureData.freeSeg();
-      this->isReceivedPressureData = false;
       this->isReceivedTemperatureData = false;
     }
+#endif /* CONFIG_SENSING_BAROMETER_STREAMING */
   
   return 0;
 }
 
+/*--------------------------------------------------------------------*/
+void BarometerClass::send(uint32_t time)
+{
+  sensor_command_data_mh_t packet;
+  packet.header.size = 0;
+  packet.header.code = SendData;
+  packet.self        = barometerID;
+  packet.time        = time;
+  packet.fs          = BAROMETER_PRESSURE_SAMPLING_FREQUENCY;
+  packet.size        = BAROMETER_PRESSURE_WATERMARK_NUM;
+  packet.mh          = this->pressureDate;
+
+  SS_SendSensorDataMH(&packet);
+
+  this->pressureDate.freeSeg();
+  this->isReceivedPressureData = false;
+}
+
 /*--------------------------------------------------------------------*/
 void BarometerClass::compemsate(void)
 {
-  int32_t* p_temp = (int32_t*)this->temperatureData.getVa();
   uint32_t* p_pres = (uint32_t*)this->pressureDate.getVa();
+
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+  for (int i = 0; i < BAROMETER_PRESSURE_WATERMARK_NUM; i++, p_pres++)
+    {
+      *p_pres = this->compensatePressure(*p_pres, this->lastTemperature);
+    }
+#else
+  int32_t* p_temp = (int32_t*)this->temperatureData.getVa();
   
   for (int i = 0; i < BAROMETER_PRESSURE_WATERMARK_NUM; i++, p_temp++, p_pres++)
     {
       int t = this->compensateTemperature(*p_temp);
       *p_pres = this->compensatePressure(*p_pres, t);
     }
+#endif /* CONFIG_SENSING_BAROMETER_STREAMING */
  }
 
 /*--------------------------------------------------------------------*/
 void BarometerClass::setAdjustParam(struct bmp280_press_adj_s* param)
 {
   this->press_adj = *param;
+  this->pressCache.valid = false;
 }
   
 /*--------------------------------------------------------------------*/
@@ -241,30 +300,43 @@ uint32_t BarometerClass::compensatePressure(int32_t adc_P, int32_t comp_T)
   int32_t var2;
   uint32_t p;
 
-  var1 = (((int32_t)comp_T) >> 1) - (int32_t)64000;
-  var2 = (((var1 >> 2) * (var1 >> 2)) >> 11 ) * ((int32_t)press_adj.dig_P6);
-  var2 = var2 + ((var1 * ((int32_t)press_adj.dig_P5)) << 1);
-  var2 = (var2 >> 2) + (((int32_t)press_adj.dig_P4) << 16);
-  var1 = (((press_adj.dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13 )) >> 3) +
-          ((((int32_t)press_adj.dig_P2) * var1) >> 1)) >> 18;
-  var1 = ((((32768 + var1)) * ((int32_t)press_adj.dig_P1)) >> 15);
+  /* The terms depending only on the temperature are kept while it does
+   * not change, which is usual between consecutive samples.
+   */
+
+  if (!pressCache.valid || pressCache.comp_T != comp_T)
+    {
+      var1 = (((int32_t)comp_T) >> 1) - (int32_t)64000;
+      var2 = (((var1 >> 2) * (var1 >> 2)) >> 11 ) * ((int32_t)press_adj.dig_P6);
+      var2 = var2 + ((var1 * ((int32_t)press_adj.dig_P5)) << 1);
+      var2 = (var2 >> 2) + (((int32_t)press_adj.dig_P4) << 16);
+      var1 = (((press_adj.dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13 )) >> 3) +
+              ((((int32_t)press_adj.dig_P2) * var1) >> 1)) >> 18;
+      var1 = ((((32768 + var1)) * ((int32_t)press_adj.dig_P1)) >> 15);
+
+      pressCache.valid      = true;
+      pressCache.comp_T     = comp_T;
+      pressCache.offset     = var2 >> 12;
+      pressCache.divisor    = (uint32_t)var1;
+      pressCache.reciprocal = var1 ? 0xffffffff / (uint32_t)var1 : 0;
+    }
 
   /* avoid exception caused by division by zero */
 
-  if (var1 == 0)
+  if (pressCache.divisor == 0)
     {
       return 0;
     }
 
-  p = (((uint32_t)(((int32_t)1048576) - adc_P) - (var2 >> 12))) * 3125;
+  p = (((uint32_t)(((int32_t)1048576) - adc_P) - pressCache.offset)) * 3125;
 
   if (p < 0x80000000)
     {
-      p = (p << 1) / ((uint32_t)var1);
+      p = divide(p << 1, pressCache.divisor, pressCache.reciprocal);
     }
   else
     {
-      p = (p / (uint32_t)var1) * 2;
+      p = divide(p, pressCache.divisor, pressCache.reciprocal) * 2;
     }
 
   var1 = (((int32_t)press_adj.dig_P9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
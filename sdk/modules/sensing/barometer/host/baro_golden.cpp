@@ -0,0 +1,427 @@
+/****************************************************************************
+ * modules/sensing/barometer/host/baro_golden.cpp
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host golden test of the barometer pressure compensation.
+ *
+ * barometer.cpp keeps the terms of compensatePressure() that depend only
+ * on the temperature, and replaces the division by a multiplication with a
+ * cached reciprocal (divide()). Both must give exactly the result of the
+ * Bosch 32 bit integer formula, which is kept here as the reference.
+ *
+ *  - divide() is compared with the division over divisors spread across
+ *    the 32 bit range, with numerators at and around multiples of them.
+ *  - The datasheet example calibration and readings must give t_fine
+ *    128422 and 100656 Pa.
+ *  - Watermarks of pressure and temperature samples go through write()
+ *    and the data sent to the sensor manager is compared with the
+ *    reference, for random and typical calibrations. The temperature is
+ *    kept for runs of samples and the calibration is changed between
+ *    watermarks, with and without a change of t_fine, to check that the
+ *    cache is refreshed when it must be.
+ *
+ * The file includes barometer.cpp to reach the static divide().
+ * baro_golden_streaming is built with CONFIG_SENSING_BAROMETER_STREAMING,
+ * where the last temperature of a watermark applies to the following
+ * pressure watermarks.
+ *
+ *   baro_golden [watermarks]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../barometer.cpp"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NSAMPLES  BAROMETER_PRESSURE_WATERMARK_NUM
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+
+/* Data of the last SS_SendSensorDataMH() */
+
+static uint32_t g_sent[NSAMPLES];
+static unsigned long g_sent_num;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static uint32_t rnd32(void)
+{
+  return rnd() << 16 ^ rnd();
+}
+
+static void fail(const char *what, unsigned long index)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%s: %lu\n", what, index);
+    }
+}
+
+/* Bosch 32 bit integer compensation, as barometer.cpp had it before the
+ * cache.
+ */
+
+static int32_t ref_temperature(const struct bmp280_temp_adj_s *adj,
+                               int32_t adc_T)
+{
+  int32_t var1;
+  int32_t var2;
+
+  var1 = ((((adc_T >> 3) - ((int32_t)adj->dig_T1 << 1))) *
+          ((int32_t)adj->dig_T2)) >> 11;
+  var2 = (((((adc_T >> 4) - ((int32_t)adj->dig_T1)) *
+          ((adc_T >> 4) - ((int32_t)adj->dig_T1))) >> 12) *
+            ((int32_t)adj->dig_T3)) >> 14;
+
+  return var1 + var2;
+}
+
+static uint32_t ref_pressure(const struct bmp280_press_adj_s *adj,
+                             int32_t adc_P, int32_t comp_T)
+{
+  int32_t var1;
+  int32_t var2;
+  uint32_t p;
+
+  var1 = (((int32_t)comp_T) >> 1) - (int32_t)64000;
+  var2 = (((var1 >> 2) * (var1 >> 2)) >> 11 ) * ((int32_t)adj->dig_P6);
+  var2 = var2 + ((var1 * ((int32_t)adj->dig_P5)) << 1);
+  var2 = (var2 >> 2) + (((int32_t)adj->dig_P4) << 16);
+  var1 = (((adj->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13 )) >> 3) +
+          ((((int32_t)adj->dig_P2) * var1) >> 1)) >> 18;
+  var1 = ((((32768 + var1)) * ((int32_t)adj->dig_P1)) >> 15);
+
+  if (var1 == 0)
+    {
+      return 0;
+    }
+
+  p = (((uint32_t)(((int32_t)1048576) - adc_P) - (var2 >> 12))) * 3125;
+
+  if (p < 0x80000000)
+    {
+      p = (p << 1) / ((uint32_t)var1);
+    }
+  else
+    {
+      p = (p / (uint32_t)var1) * 2;
+    }
+
+  var1 = (((int32_t)adj->dig_P9) *
+          ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+  var2 = (((int32_t)(p >> 2)) * ((int32_t)adj->dig_P8)) >> 13;
+  p = (uint32_t)((int32_t)p + ((var1 + var2 + adj->dig_P7) >> 4));
+
+  return p;
+}
+
+static void check_divide(uint32_t n, uint32_t d)
+{
+  if (divide(n, d, 0xffffffff / d) != n / d)
+    {
+      fail("divide", d);
+    }
+}
+
+static void test_divide(void)
+{
+  uint64_t d;
+  uint32_t m;
+  int i;
+
+  for (d = 1; d <= 0xffffffff; d = d * 9 / 8 + 1)
+    {
+      check_divide(0, d);
+      check_divide(0xffffffff, d);
+      check_divide(d - 1, d);
+      check_divide(d, d);
+
+      for (i = 0; i < 200; i++)
+        {
+          /* Around a multiple of d, or anywhere */
+
+          m = (uint32_t)(0xffffffff / d);
+          m = (uint32_t)(rnd32() % ((uint64_t)m + 1) * d);
+          check_divide(m, d);
+          check_divide(m - 1, d);
+          check_divide(m + 1, d);
+          check_divide(rnd32(), d);
+        }
+    }
+
+  for (i = 0; i < 32; i++)
+    {
+      d = (uint64_t)1 << i;
+      check_divide(rnd32(), d);
+      check_divide(rnd32(), d - 1 ? d - 1 : 1);
+      check_divide(rnd32(), d + 1);
+    }
+}
+
+static void datasheet_adj(struct bmp280_press_adj_s *press,
+                          struct bmp280_temp_adj_s *temp)
+{
+  temp->dig_T1  = 27504;
+  temp->dig_T2  = 26435;
+  temp->dig_T3  = -1000;
+  press->dig_P1 = 36477;
+  press->dig_P2 = -10685;
+  press->dig_P3 = 3024;
+  press->dig_P4 = 2855;
+  press->dig_P5 = 140;
+  press->dig_P6 = -7;
+  press->dig_P7 = 15500;
+  press->dig_P8 = -14600;
+  press->dig_P9 = 6000;
+}
+
+static void random_adj(struct bmp280_press_adj_s *press,
+                       struct bmp280_temp_adj_s *temp)
+{
+  /* Typical: the datasheet calibration with some spread on the terms
+   * which vary most between parts. Otherwise any value.
+   */
+
+  if (rnd() & 1)
+    {
+      datasheet_adj(press, temp);
+      temp->dig_T1  += rnd() % 2001 - 1000;
+      temp->dig_T2  += rnd() % 2001 - 1000;
+      press->dig_P1 += rnd() % 4001 - 2000;
+      press->dig_P2 += rnd() % 401 - 200;
+    }
+  else
+    {
+      temp->dig_T1  = rnd();
+      temp->dig_T2  = rnd();
+      temp->dig_T3  = rnd();
+      press->dig_P1 = rnd();
+      press->dig_P2 = rnd();
+      press->dig_P3 = rnd();
+      press->dig_P4 = rnd();
+      press->dig_P5 = rnd();
+      press->dig_P6 = rnd();
+      press->dig_P7 = rnd();
+      press->dig_P8 = rnd();
+      press->dig_P9 = rnd();
+    }
+}
+
+/* Send one watermark of each sensor through write(), return true if the
+ * barometer sent compensated data.
+ */
+
+static bool feed(BarometerClass *baro, uint32_t *pres, uint32_t *temp)
+{
+  sensor_command_data_mh_t command = sensor_command_data_mh_t();
+  unsigned long sent = g_sent_num;
+
+  command.self = tempID;
+  command.mh   = MemMgrLite::MemHandle(temp);
+  baro->write(&command);
+
+  command.self = pressureID;
+  command.mh   = MemMgrLite::MemHandle(pres);
+  baro->write(&command);
+
+  return g_sent_num == sent + 1;
+}
+
+static void test_datasheet(void)
+{
+  struct bmp280_press_adj_s press;
+  struct bmp280_temp_adj_s temp;
+  BarometerClass baro(barometerID);
+  uint32_t pres_data[NSAMPLES];
+  uint32_t temp_data[NSAMPLES];
+  int i;
+
+  datasheet_adj(&press, &temp);
+  baro.setAdjustParam(&press);
+  baro.setAdjustParam(&temp);
+
+  if (ref_temperature(&temp, 519888) != 128422 ||
+      ref_pressure(&press, 415148, 128422) != 100656)
+    {
+      fail("datasheet reference", 0);
+    }
+
+  for (i = 0; i < NSAMPLES; i++)
+    {
+      pres_data[i] = 415148;
+      temp_data[i] = 519888;
+    }
+
+  if (!feed(&baro, pres_data, temp_data))
+    {
+      fail("datasheet not sent", 0);
+      return;
+    }
+
+  for (i = 0; i < NSAMPLES; i++)
+    {
+      if (g_sent[i] != 100656)
+        {
+          fail("datasheet pressure", i);
+        }
+    }
+}
+
+static void test_random(unsigned long watermarks)
+{
+  struct bmp280_press_adj_s press;
+  struct bmp280_temp_adj_s temp;
+  BarometerClass baro(barometerID);
+  uint32_t pres_data[NSAMPLES];
+  uint32_t temp_data[NSAMPLES];
+  uint32_t adc_P[NSAMPLES];
+  uint32_t adc_T = 0;
+  int32_t t_fine;
+  unsigned long w;
+  int i;
+
+  random_adj(&press, &temp);
+  baro.setAdjustParam(&press);
+  baro.setAdjustParam(&temp);
+
+  for (w = 0; w < watermarks; w++)
+    {
+      /* New calibration. Keeping the temperature calibration, and the
+       * temperature below, keeps t_fine, so only the new pressure
+       * calibration can refresh the cache.
+       */
+
+      if (rnd() % 8 == 0)
+        {
+          struct bmp280_temp_adj_s keep = temp;
+
+          random_adj(&press, &temp);
+          if (rnd() & 1)
+            {
+              temp = keep;
+            }
+
+          baro.setAdjustParam(&press);
+          baro.setAdjustParam(&temp);
+        }
+
+      for (i = 0; i < NSAMPLES; i++)
+        {
+          if (i == 0 ? rnd() % 4 == 0 : rnd() % 16 == 0)
+            {
+              adc_T = rnd() & 0xfffff;
+            }
+
+          temp_data[i] = adc_T;
+          adc_P[i]     = rnd() & 0xfffff;
+          pres_data[i] = adc_P[i];
+        }
+
+      if (!feed(&baro, pres_data, temp_data))
+        {
+          fail("not sent", w);
+          continue;
+        }
+
+      for (i = 0; i < NSAMPLES; i++)
+        {
+#ifdef CONFIG_SENSING_BAROMETER_STREAMING
+          t_fine = ref_temperature(&temp, temp_data[NSAMPLES - 1]);
+#else
+          t_fine = ref_temperature(&temp, temp_data[i]);
+#endif
+          if (g_sent[i] != ref_pressure(&press, adc_P[i], t_fine))
+            {
+              fail("pressure, watermark", w);
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void SS_SendSensorDataMH(FAR sensor_command_data_mh_t *packet)
+{
+  if (packet->self == barometerID && packet->size == NSAMPLES)
+    {
+      memcpy(g_sent, packet->mh.getVa(), sizeof(g_sent));
+      g_sent_num++;
+    }
+}
+
+void SS_SendSensorSetPower(FAR sensor_command_power_t *packet)
+{
+}
+
+void SS_SendSensorClearPower(FAR sensor_command_power_t *packet)
+{
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned long watermarks = (argc > 1) ? strtoul(argv[1], NULL, 0) :
+                                          100000;
+
+  test_divide();
+  test_datasheet();
+  test_random(watermarks);
+
+  printf("%lu samples, %lu errors\n", watermarks * NSAMPLES, g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+ * modules/sensing/barometer/host/include/memutils/memory_manager/MemHandle.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host build: a handle which only points to the sample buffer given by
+ * the test, there is no memory pool.
+ */
+
+#ifndef HOST_MEMUTILS_MEMORY_MANAGER_MEMHANDLE_H
+#define HOST_MEMUTILS_MEMORY_MANAGER_MEMHANDLE_H
+
+#include <stddef.h>
+
+namespace MemMgrLite {
+
+class MemHandle
+{
+public:
+  MemHandle() : m_va(NULL) {}
+  MemHandle(void *va) : m_va(va) {}
+
+  void *getVa() const { return m_va; }
+  bool  isAvail() const { return m_va != NULL; }
+  void  freeSeg() { m_va = NULL; }
+
+private:
+  void *m_va;
+};
+
+} /* namespace MemMgrLite */
+
+#endif /* HOST_MEMUTILS_MEMORY_MANAGER_MEMHANDLE_H */
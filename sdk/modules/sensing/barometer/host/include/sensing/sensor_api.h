@@ -0,0 +1,90 @@
+/****************************************************************************
+ * modules/sensing/barometer/host/include/sensing/sensor_api.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host build: the part of sensor_api.h used by the logical sensors, the
+ * sensor manager functions are implemented by the test.
+ */
+
+#ifndef __INCLUDE_SENSING_SENSOR_API_H
+#define __INCLUDE_SENSING_SENSOR_API_H
+
+#include <sdk/config.h>
+
+#include <stdint.h>
+
+#include "memutils/memory_manager/MemHandle.h"
+
+typedef struct
+{
+  unsigned int size    : 8;
+  unsigned int code    : 8;
+  unsigned int reserve : 16;
+} sensor_command_header_t;
+
+typedef struct
+{
+  sensor_command_header_t header;
+  unsigned int self : 8;
+  unsigned int time : 24;
+  unsigned int fs   : 16;
+  unsigned int size : 16;
+  MemMgrLite::MemHandle mh;
+} sensor_command_data_mh_t;
+
+typedef struct
+{
+  sensor_command_header_t header;
+  unsigned int self: 8;
+  unsigned int subscriptions: 24;
+} sensor_command_power_t;
+
+enum SensorCommandCode
+{
+  ResisterClient = 0,
+  ReleaseClient,
+  ChangeSubscription,
+  SetPower,
+  ClearPower,
+  SendData,
+  SendDataMH,
+  SendResult,
+  SensorCommandMum
+};
+
+void SS_SendSensorDataMH(FAR sensor_command_data_mh_t *packet);
+void SS_SendSensorSetPower(FAR sensor_command_power_t *packet);
+void SS_SendSensorClearPower(FAR sensor_command_power_t *packet);
+
+#endif /* __INCLUDE_SENSING_SENSOR_API_H */
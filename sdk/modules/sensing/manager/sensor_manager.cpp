@@ -40,6 +40,10 @@
 #include <nuttx/config.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+#include <time.h>
+#include <new>
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
 
 #include "sensor_manager.h"
 
@@ -72,6 +76,17 @@ static MsgQueId s_selfMid = 0xFF; /* Invalid ID */
 static api_response_callback_t s_response_callback = NULL;
 static pthread_t s_smng_pid = INVALID_PROCESS_ID;
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+/*--------------------------------------------------------------------*/
+static uint32_t delivery_time(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -162,27 +177,33 @@ void SensorManager::register_client(MsgPacket* packet)
 
   /* Regist as a subscriptors of required SensorID. */
 
-  for (int i = 0, j = reg.get_subscriptions(); (j != 0) || (i < 24); i++)
+  for (uint32_t j = reg.get_subscriptions(); j != 0; j &= j - 1)
     {
-      if (j & (0x01<<i))
-        {
-          /* If required SensorID is not active, take as a error. */
+      int i = __builtin_ctz(j);
 
-          if (client_table[i].status == 0)
-            {
-              response(reg.header.code,
-                       SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
-                       reg.get_self());
-              return;
-            }
+      /* If required SensorID is not active, take as a error. */
 
-          client_table[i].subscribers |= (0x01 << reg.get_self());
-          j &= ~(0x01 << i);
-              
-          _info("sesor id : %2d >> %08x\n", i, client_table[i].subscribers);
+      if (client_table[i].status == 0)
+        {
+          response(reg.header.code,
+                   SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
+                   reg.get_self());
+          return;
         }
 
+      client_table[i].subscribers |= (0x01 << reg.get_self());
+
+      _info("sesor id : %2d >> %08x\n", i, client_table[i].subscribers);
+    }
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  unsigned int ercd = start_delivery(reg.get_self(), reg.delivery);
+  if (ercd != SS_ECODE_OK)
+    {
+      response(reg.header.code, ercd, reg.get_self());
+      return;
     }
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
 
   response(reg.header.code, SS_ECODE_OK, reg.get_self());
 }
@@ -202,6 +223,10 @@ void SensorManager::release_client(MsgPacket* packet)
       return;
     }
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  stop_delivery(rel.get_self());
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
   /* Delete from subscribers of every SensorID. */
 
   for (int i = 0; i < 24; i++)
@@ -231,35 +256,32 @@ void SensorManager::change_subscription(MsgPacket* packet)
   sensor_command_change_subscription_t chg =
     packet->moveParam<sensor_command_change_subscription_t>();
 
-  for (int i = 0, j = chg.get_subscriptions(); (j != 0) || (i < 24); i++)
+  for (uint32_t j = chg.get_subscriptions(); j != 0; j &= j - 1)
     {
-      if (j & (0x01<<i))
-        {
-          /* If required SensorID is not active, take as a error. */
+      int i = __builtin_ctz(j);
 
-          if (client_table[i].status == 0)
-            {
-              response(chg.header.code,
-                       SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
-                       chg.get_self());
-              return;
-            }
+      /* If required SensorID is not active, take as a error. */
 
-          /* Regist/delete subscribers accoding to "add" parameter. */
-
-          if (chg.add)
-            {
-              client_table[i].subscribers |= (0x01 << chg.get_self());
-            }
-          else
-            {
-              client_table[i].subscribers &= ~(0x01 << chg.get_self());
-            }
+      if (client_table[i].status == 0)
+        {
+          response(chg.header.code,
+                   SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
+                   chg.get_self());
+          return;
+        }
 
-          j &= ~(0x01 << i);
+      /* Regist/delete subscribers accoding to "add" parameter. */
 
-          _info("sesor id : %2d >> %08x\n", i, client_table[i].subscribers);
+      if (chg.add)
+        {
+          client_table[i].subscribers |= (0x01 << chg.get_self());
+        }
+      else
+        {
+          client_table[i].subscribers &= ~(0x01 << chg.get_self());
         }
+
+      _info("sesor id : %2d >> %08x\n", i, client_table[i].subscribers);
     }
 
   response(chg.header.code, SS_ECODE_OK, chg.get_self());
@@ -278,22 +300,20 @@ void SensorManager::send_data(MsgPacket* packet)
       return;
     }
 
-  for (int i = 0, j = client_table[data.get_self()].subscribers;
-        (j != 0) || (i < 24); i++)
+  for (uint32_t j = client_table[data.get_self()].subscribers;
+       j != 0; j &= j - 1)
     {
-      if (j & (0x01 << i))
-        {
-          if (!client_table[i].callback)
-            {
-              response(data.header.code,
-                       SS_ECODE_NOTIFICATION_DST_UNDEFINED,
-                       data.get_self());
-              return;
-            }
+      int i = __builtin_ctz(j);
 
-          client_table[i].callback(data);/* callback */
-          j &= ~(0x01 << i);
+      if (!client_table[i].callback)
+        {
+          response(data.header.code,
+                   SS_ECODE_NOTIFICATION_DST_UNDEFINED,
+                   data.get_self());
+          return;
         }
+
+      client_table[i].callback(data);/* callback */
     }
 
   response(data.header.code, SS_ECODE_OK, data.get_self());
@@ -307,30 +327,51 @@ void SensorManager::send_data_mh(MsgPacket* packet)
 
   if (client_table[data.get_self()].status == 0x00)
     {
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+      release_delivery(data.reserved);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
       response(data.header.code,
                SS_ECODE_REQUIRED_SENSOR_NOT_ACTIVE,
                data.get_self());
       return;
     }
 
-  for (int i = 0, j = client_table[data.get_self()].subscribers;
-        (j != 0) || (i < 24); i++)
+  for (uint32_t j = client_table[data.get_self()].subscribers;
+       j != 0; j &= j - 1)
     {
-      if (j & (0x01 << i))
+      int i = __builtin_ctz(j);
+
+      if (!client_table[i].callback_mh)
         {
-          if (!client_table[i].callback_mh)
-            {
-              response(data.header.code,
-                       SS_ECODE_NOTIFICATION_DST_UNDEFINED,
-                       data.get_self());
-              return;
-            }
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+          release_delivery(data.reserved);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+          response(data.header.code,
+                   SS_ECODE_NOTIFICATION_DST_UNDEFINED,
+                   data.get_self());
+          return;
+        }
 
-          client_table[i].callback_mh(data);/* callback */
-          j &= ~(0x01 << i);
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+      /* Queued subscribers get a reference to the same segment. */
+
+      if (queue_table[i] && !queue_table[i]->stop)
+        {
+          push_delivery(queue_table[i], data, data.reserved & (0x01 << i));
+          data.reserved &= ~(0x01 << i);
+          continue;
         }
+
+      record_delivery(i, data);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
+      client_table[i].callback_mh(data);/* callback */
     }
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  release_delivery(data.reserved);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
   response(data.header.code, SS_ECODE_OK, data.get_self());
 }
 #endif /* __cplusplus */
@@ -348,15 +389,6 @@ void SensorManager::send_result(MsgPacket* packet)
       return;
     }
 
-  for (int i = 0, j=client_table[res.get_self()].subscribers;
-        (j != 0)||(i < 24); i++)
-    {
-      if (j & (0x01 << i))
-        {
-          j &= ~(0x01 << i);
-        }
-    }
-
   response(res.header.code, SS_ECODE_OK, res.get_self());
 }
 
@@ -456,6 +488,361 @@ void SensorManager::response(unsigned int code, unsigned int ercd, unsigned int
   return;
 }
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+#define SS_DELIVERY_QUEUE_DEPTH CONFIG_SENSING_MANAGER_DELIVERY_QUEUE_DEPTH
+
+/*--------------------------------------------------------------------*/
+unsigned int SensorManager::start_delivery(unsigned int id,
+                                           unsigned int policy)
+{
+  /* Registering again replaces the pending data. */
+
+  stop_delivery(id);
+
+  pthread_mutex_lock(&stats_lock);
+  memset(&stats_table[id], 0, sizeof(sensor_delivery_stats_t));
+  pthread_mutex_unlock(&stats_lock);
+
+  if (policy >= SensorDeliveryPolicyNum)
+    {
+      return SS_ECODE_PARAM_ERROR;
+    }
+
+  if (policy == SensorDeliverySync)
+    {
+      return SS_ECODE_OK;
+    }
+
+  delivery_queue_t *queue = queue_table[id];
+
+  if (queue == NULL)
+    {
+      queue = new (std::nothrow) delivery_queue_t;
+      if (queue == NULL)
+        {
+          return SS_ECODE_TASK_CREATE_ERROR;
+        }
+
+      queue->manager  = this;
+      queue->id       = id;
+      queue->running  = false;
+      queue->stop     = true;
+      queue->reserved = 0;
+      queue->head     = 0;
+      queue->count    = 0;
+      pthread_mutex_init(&queue->lock, NULL);
+      pthread_cond_init(&queue->ready, NULL);
+      pthread_cond_init(&queue->space, NULL);
+
+      /* Publishers look up the queue without the manager. */
+
+      __atomic_store_n(&queue_table[id], queue, __ATOMIC_RELEASE);
+    }
+
+  pthread_mutex_lock(&queue->lock);
+
+  queue->policy      = policy;
+  queue->callback_mh = client_table[id].callback_mh;
+  queue->stop        = false;
+
+  /* The thread of a previous registration keeps running if it has not
+   * seen the stop yet.
+   */
+
+  if (!queue->running)
+    {
+      pthread_attr_t     attr;
+      struct sched_param sch_param;
+      pthread_attr_init(&attr);
+      sch_param.sched_priority = CONFIG_SENSING_MANAGER_DELIVERY_PRIORITY;
+      attr.stacksize           = CONFIG_SENSING_MANAGER_DELIVERY_STACK_SIZE;
+      pthread_attr_setschedparam(&attr, &sch_param);
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+      if (pthread_create(&queue->pid,
+                         &attr,
+                         (pthread_startroutine_t)delivery_entry,
+                         (pthread_addr_t)queue) != 0)
+        {
+          sensor_err("ERROR delivery thread of %d\n", id);
+          queue->stop = true;
+          pthread_mutex_unlock(&queue->lock);
+          return SS_ECODE_TASK_CREATE_ERROR;
+        }
+
+      queue->running = true;
+    }
+
+  pthread_mutex_unlock(&queue->lock);
+  return SS_ECODE_OK;
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::stop_delivery(unsigned int id)
+{
+  delivery_queue_t *queue = queue_table[id];
+
+  if (queue == NULL || queue->stop)
+    {
+      return;
+    }
+
+  /* The manager does not wait for the delivery thread, a callback in
+   * progress may still be sending commands to it. The thread exits by
+   * itself when the callback returns.
+   */
+
+  pthread_mutex_lock(&queue->lock);
+
+  queue->stop = true;
+
+  /* Undelivered data release their references here. */
+
+  for (; queue->count > 0; queue->count--)
+    {
+      queue->data[queue->head].mh.freeSeg();
+      queue->head = (queue->head + 1) % SS_DELIVERY_QUEUE_DEPTH;
+    }
+
+  pthread_cond_signal(&queue->ready);
+  pthread_cond_broadcast(&queue->space);
+  pthread_mutex_unlock(&queue->lock);
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::delete_delivery(unsigned int id)
+{
+  delivery_queue_t *queue = queue_table[id];
+
+  if (queue == NULL)
+    {
+      return;
+    }
+
+  stop_delivery(id);
+
+  pthread_mutex_lock(&queue->lock);
+  while (queue->running)
+    {
+      pthread_cond_wait(&queue->space, &queue->lock);
+    }
+  pthread_mutex_unlock(&queue->lock);
+
+  queue_table[id] = NULL;
+
+  pthread_cond_destroy(&queue->space);
+  pthread_cond_destroy(&queue->ready);
+  pthread_mutex_destroy(&queue->lock);
+
+  delete queue;
+}
+
+/*--------------------------------------------------------------------*/
+uint32_t SensorManager::reserve_delivery(unsigned int id)
+{
+  uint32_t reserved = 0;
+
+  /* Runs on the publisher. Every blocking subscriber with a full queue
+   * holds the publisher here, not the manager, and a slot is reserved so
+   * that the manager finds room when the data arrives.
+   */
+
+  for (uint32_t j = client_table[id].subscribers; j != 0; j &= j - 1)
+    {
+      int i = __builtin_ctz(j);
+
+      delivery_queue_t *queue =
+        __atomic_load_n(&queue_table[i], __ATOMIC_ACQUIRE);
+
+      if (queue == NULL)
+        {
+          continue;
+        }
+
+      pthread_mutex_lock(&queue->lock);
+
+      /* A subscriber publishing to itself would wait for ever. */
+
+      if (queue->policy == SensorDeliveryBlock && !queue->stop &&
+          !pthread_equal(queue->pid, pthread_self()))
+        {
+          while (queue->count + queue->reserved >= SS_DELIVERY_QUEUE_DEPTH &&
+                 !queue->stop)
+            {
+              pthread_cond_wait(&queue->space, &queue->lock);
+            }
+
+          if (!queue->stop)
+            {
+              queue->reserved++;
+              reserved |= (0x01 << i);
+            }
+        }
+
+      pthread_mutex_unlock(&queue->lock);
+    }
+
+  return reserved;
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::release_delivery(uint32_t reserved)
+{
+  /* Give back the slots of data which were not pushed, e.g. because the
+   * subscriber was released after SS_SendSensorDataMH.
+   */
+
+  for (uint32_t j = reserved; j != 0; j &= j - 1)
+    {
+      delivery_queue_t *queue = queue_table[__builtin_ctz(j)];
+
+      pthread_mutex_lock(&queue->lock);
+      if (queue->reserved > 0)
+        {
+          queue->reserved--;
+        }
+      pthread_cond_broadcast(&queue->space);
+      pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::push_delivery(delivery_queue_t *queue,
+                                  sensor_command_data_mh_t &data,
+                                  bool reserved)
+{
+  pthread_mutex_lock(&queue->lock);
+
+  if (reserved && queue->reserved > 0)
+    {
+      queue->reserved--;
+    }
+
+  if (queue->count == SS_DELIVERY_QUEUE_DEPTH)
+    {
+      switch (queue->policy)
+        {
+          case SensorDeliveryCoalesce:
+            queue->data[(queue->head + queue->count - 1) %
+                        SS_DELIVERY_QUEUE_DEPTH] = data;
+
+            pthread_mutex_lock(&stats_lock);
+            stats_table[queue->id].coalesced++;
+            pthread_mutex_unlock(&stats_lock);
+
+            pthread_mutex_unlock(&queue->lock);
+            return;
+
+          case SensorDeliveryBlock:
+
+            /* Only data without a reserved slot, e.g. of a subscription
+             * added after SS_SendSensorDataMH, finds a blocking queue
+             * full. The manager never waits, it is dropped as below.
+             */
+
+          case SensorDeliveryDropOldest:
+            queue->data[queue->head].mh.freeSeg();
+            queue->head = (queue->head + 1) % SS_DELIVERY_QUEUE_DEPTH;
+            queue->count--;
+
+            pthread_mutex_lock(&stats_lock);
+            stats_table[queue->id].dropped++;
+            pthread_mutex_unlock(&stats_lock);
+            break;
+        }
+    }
+
+  /* Copying the command takes a reference, the data is not copied. */
+
+  queue->data[(queue->head + queue->count) % SS_DELIVERY_QUEUE_DEPTH] = data;
+  queue->count++;
+  pthread_cond_signal(&queue->ready);
+
+  pthread_mutex_unlock(&queue->lock);
+}
+
+/*--------------------------------------------------------------------*/
+void SensorManager::record_delivery(unsigned int id,
+                                    sensor_command_data_mh_t &data)
+{
+  uint32_t latency = delivery_time() - data.publish_time;
+
+  pthread_mutex_lock(&stats_lock);
+  stats_table[id].delivered++;
+  stats_table[id].last_latency = latency;
+  if (latency > stats_table[id].max_latency)
+    {
+      stats_table[id].max_latency = latency;
+    }
+  pthread_mutex_unlock(&stats_lock);
+}
+
+/*--------------------------------------------------------------------*/
+void *SensorManager::delivery_entry(void *arg)
+{
+  delivery_queue_t *queue = (delivery_queue_t *)arg;
+  sensor_command_data_mh_t  data;
+  sensor_data_mh_callback_t callback_mh;
+
+  pthread_mutex_lock(&queue->lock);
+
+  while (1)
+    {
+      while (queue->count == 0 && !queue->stop)
+        {
+          pthread_cond_wait(&queue->ready, &queue->lock);
+        }
+
+      if (queue->stop)
+        {
+          break;
+        }
+
+      data = queue->data[queue->head];
+      queue->data[queue->head].mh.freeSeg();
+      queue->head = (queue->head + 1) % SS_DELIVERY_QUEUE_DEPTH;
+      queue->count--;
+      callback_mh = queue->callback_mh;
+      pthread_cond_broadcast(&queue->space);
+
+      pthread_mutex_unlock(&queue->lock);
+
+      queue->manager->record_delivery(queue->id, data);
+      callback_mh(data);/* callback */
+      data.mh.freeSeg();
+
+      pthread_mutex_lock(&queue->lock);
+    }
+
+  queue->running = false;
+  pthread_cond_broadcast(&queue->space);
+
+  pthread_mutex_unlock(&queue->lock);
+  return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+bool SensorManager::get_delivery_stats(unsigned int id,
+                                       sensor_delivery_stats_t *stats,
+                                       bool reset)
+{
+  if (id >= 24 || client_table[id].status == 0)
+    {
+      return false;
+    }
+
+  pthread_mutex_lock(&stats_lock);
+  *stats = stats_table[id];
+  if (reset)
+    {
+      memset(&stats_table[id], 0, sizeof(sensor_delivery_stats_t));
+    }
+  pthread_mutex_unlock(&stats_lock);
+
+  return true;
+}
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -606,6 +993,21 @@ void SS_SendSensorClearPower(FAR sensor_command_power_t *packet)
 }
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+/*--------------------------------------------------------------------*/
+bool SS_GetSensorDeliveryStats(unsigned int id,
+                               FAR sensor_delivery_stats_t *stats,
+                               bool reset)
+{
+  if (TheSensorManager == NULL || stats == NULL)
+    {
+      return false;
+    }
+
+  return TheSensorManager->get_delivery_stats(id, stats, reset);
+}
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 }/* extern "C"  */
 
 #ifdef __cplusplus
@@ -615,6 +1017,14 @@ void SS_SendSensorClearPower(FAR sensor_command_power_t *packet)
 */
 void SS_SendSensorDataMH(FAR sensor_command_data_mh_t *packet)
 {
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  packet->publish_time = delivery_time();
+
+  /* Wait here for the subscribers with SensorDeliveryBlock. */
+
+  packet->reserved = TheSensorManager->reserve_delivery(packet->get_self());
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
   err_t er = MsgLib::send<sensor_command_data_mh_t>(
                TheSensorManager->get_mid(),
                MsgPriNormal,
@@ -42,6 +42,11 @@
 
 #include <sdk/config.h>
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+#include <pthread.h>
+#include <string.h>
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 #include "memutils/message/Message.h"
 #include "sensing/sensor_message_types.h"
 #include "sensing/sensor_id.h"
@@ -63,7 +68,25 @@ public:
     return m_selfMId;
   }
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  ~SensorManager()
+  {
+    for (int i = 0; i < 24; i++)
+      {
+        delete_delivery(i);
+      }
+
+    pthread_mutex_destroy(&stats_lock);
+  };
+
+  bool get_delivery_stats(unsigned int id,
+                          sensor_delivery_stats_t *stats,
+                          bool reset);
+
+  uint32_t reserve_delivery(unsigned int id);
+#else
   ~SensorManager(){};
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
 
 private:
   SensorManager(MsgQueId selfMId, api_response_callback_t callback)
@@ -82,7 +105,16 @@ private:
         power_table[i].subscribers  = 0;
         power_table[i].callback     = NULL;
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */ 
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+        queue_table[i] = NULL;
+        memset(&stats_table[i], 0, sizeof(sensor_delivery_stats_t));
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
       }
+
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+    pthread_mutex_init(&stats_lock, NULL);
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
   };
 
   /*** private members ***/
@@ -136,6 +168,49 @@ private:
 
 #endif /* CONFIG_SENSING_MANAGER_POWERCTRL */ 
 
+#ifdef CONFIG_SENSING_MANAGER_ASYNC_DELIVERY
+  /** delivery queue of a subscriber
+   *  A queue is kept until the manager is deleted once it is created,
+   *  so that publishers can wait on it without holding the manager.
+   */
+  typedef struct
+  {
+    SensorManager            *manager;  /** owner */
+    unsigned int              id;       /** subscriber sensor ID */
+    unsigned int              policy;   /** SensorDeliveryPolicy */
+    sensor_data_mh_callback_t callback_mh;
+    pthread_t                 pid;
+    pthread_mutex_t           lock;
+    pthread_cond_t            ready;    /** signaled on push and stop */
+    pthread_cond_t            space;    /** signaled on pop, stop and exit */
+    bool                      running;  /** delivery thread is alive */
+    bool                      stop;     /** queue is not in use */
+    unsigned int              reserved; /** slots reserved by publishers */
+    unsigned int              head;     /** oldest data */
+    unsigned int              count;
+    sensor_command_data_mh_t  data[CONFIG_SENSING_MANAGER_DELIVERY_QUEUE_DEPTH];
+  } delivery_queue_t;
+
+  /** delivery queues, NULL until a queued policy is registered */
+  delivery_queue_t *queue_table[24];
+
+  /** delivery statistics */
+  sensor_delivery_stats_t stats_table[24];
+  pthread_mutex_t         stats_lock;
+
+  unsigned int start_delivery(unsigned int id, unsigned int policy);
+  void    stop_delivery(unsigned int id);
+  void    delete_delivery(unsigned int id);
+  void    push_delivery(delivery_queue_t *queue,
+                        sensor_command_data_mh_t &data,
+                        bool reserved);
+  void    release_delivery(uint32_t reserved);
+  void    record_delivery(unsigned int id, sensor_command_data_mh_t &data);
+
+  static void *delivery_entry(void *arg);
+
+#endif /* CONFIG_SENSING_MANAGER_ASYNC_DELIVERY */
+
 };
 
 /****************************************************************************
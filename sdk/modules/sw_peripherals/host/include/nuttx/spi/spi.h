@@ -0,0 +1,92 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/include/nuttx/spi/spi.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef HOST_NUTTX_SPI_SPI_H
+#define HOST_NUTTX_SPI_SPI_H
+
+/* The subset of the NuttX SPI interface used by sw_spi.c and the test */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SPI_LOCK(d,l)            (d)->ops->lock(d,l)
+#define SPI_SELECT(d,id,s)       (d)->ops->select(d,id,s)
+#define SPI_SETFREQUENCY(d,f)    (d)->ops->setfrequency(d,f)
+#define SPI_SETMODE(d,m)         (d)->ops->setmode(d,m)
+#define SPI_SETBITS(d,b)         (d)->ops->setbits(d,b)
+#define SPI_SEND(d,wd)           (d)->ops->send(d,(uint16_t)(wd))
+#ifdef CONFIG_SPI_EXCHANGE
+#  define SPI_EXCHANGE(d,t,r,l)  (d)->ops->exchange(d,t,r,l)
+#else
+#  define SPI_SNDBLOCK(d,b,l)    (d)->ops->sndblock(d,b,l)
+#  define SPI_RECVBLOCK(d,b,l)   (d)->ops->recvblock(d,b,l)
+#endif
+
+enum spi_mode_e
+{
+  SPIDEV_MODE0 = 0,
+  SPIDEV_MODE1,
+  SPIDEV_MODE2,
+  SPIDEV_MODE3
+};
+
+struct spi_dev_s;
+
+struct spi_ops_s
+{
+  int      (*lock)(struct spi_dev_s *dev, bool lock);
+  void     (*select)(struct spi_dev_s *dev, uint32_t devid, bool selected);
+  uint32_t (*setfrequency)(struct spi_dev_s *dev, uint32_t frequency);
+  void     (*setmode)(struct spi_dev_s *dev, enum spi_mode_e mode);
+  void     (*setbits)(struct spi_dev_s *dev, int nbits);
+  uint32_t (*send)(struct spi_dev_s *dev, uint16_t wd);
+#ifdef CONFIG_SPI_EXCHANGE
+  void     (*exchange)(struct spi_dev_s *dev, const void *txbuffer,
+                       void *rxbuffer, size_t nwords);
+#else
+  void     (*sndblock)(struct spi_dev_s *dev, const void *buffer,
+                       size_t nwords);
+  void     (*recvblock)(struct spi_dev_s *dev, void *buffer,
+                        size_t nwords);
+#endif
+};
+
+struct spi_dev_s
+{
+  const struct spi_ops_s *ops;
+};
+
+#endif /* HOST_NUTTX_SPI_SPI_H */
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/include/nuttx/spi/spi_bitbang.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef HOST_NUTTX_SPI_SPI_BITBANG_H
+#define HOST_NUTTX_SPI_SPI_BITBANG_H
+
+/* The subset of the NuttX bitbang SPI interface used by sw_spi.c.
+ * spi_bitbang.c here is a minimal upper half: buffer transfers call the
+ * lower half exchange() once per word, like the NuttX one does.
+ */
+
+#include <nuttx/spi/spi.h>
+
+struct spi_bitbang_s;
+
+struct spi_bitbang_ops_s
+{
+  void     (*select)(struct spi_bitbang_s *priv, uint32_t devid,
+                     bool selected);
+  uint32_t (*setfrequency)(struct spi_bitbang_s *priv, uint32_t frequency);
+  void     (*setmode)(struct spi_bitbang_s *priv, enum spi_mode_e mode);
+  uint16_t (*exchange)(struct spi_bitbang_s *priv, uint16_t dataout);
+  uint8_t  (*status)(struct spi_bitbang_s *priv, uint32_t devid);
+};
+
+struct spi_bitbang_s
+{
+  struct spi_dev_s dev;
+  const struct spi_bitbang_ops_s *low;
+  void *priv;
+  uint8_t nbit;
+};
+
+struct spi_dev_s *spi_create_bitbang(const struct spi_bitbang_ops_s *low,
+                                     void *priv);
+void spi_destroy_bitbang(struct spi_dev_s *dev);
+
+#endif /* HOST_NUTTX_SPI_SPI_BITBANG_H */
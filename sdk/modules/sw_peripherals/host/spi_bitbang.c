@@ -0,0 +1,192 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/spi_bitbang.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Minimal bitbang SPI upper half for the host build of sw_spi.c. Like
+ * drivers/spi/spi_bitbang.c, buffer transfers go through the lower half
+ * exchange() one word at a time; sw_spi.c replaces them by its burst
+ * routine.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+
+#include <nuttx/spi/spi_bitbang.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int bb_lock(struct spi_dev_s *dev, bool lock)
+{
+  return OK;
+}
+
+static void bb_select(struct spi_dev_s *dev, uint32_t devid, bool selected)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+
+  priv->low->select(priv, devid, selected);
+}
+
+static uint32_t bb_setfrequency(struct spi_dev_s *dev, uint32_t frequency)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+
+  return priv->low->setfrequency(priv, frequency);
+}
+
+static void bb_setmode(struct spi_dev_s *dev, enum spi_mode_e mode)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+
+  priv->low->setmode(priv, mode);
+}
+
+static void bb_setbits(struct spi_dev_s *dev, int nbits)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+
+  priv->nbit = (uint8_t)nbits;
+}
+
+static uint32_t bb_send(struct spi_dev_s *dev, uint16_t wd)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+
+  return priv->low->exchange(priv, wd);
+}
+
+static void bb_exchange(struct spi_dev_s *dev, const void *txbuffer,
+                        void *rxbuffer, size_t nwords)
+{
+  struct spi_bitbang_s *priv = (struct spi_bitbang_s *)dev;
+  const uint8_t *src = (const uint8_t *)txbuffer;
+  uint8_t *dest = (uint8_t *)rxbuffer;
+  uint16_t dataout;
+  uint16_t datain;
+
+  while (nwords-- > 0)
+    {
+      if (priv->nbit <= 8)
+        {
+          dataout = src ? *src++ : 0xff;
+        }
+      else if (src)
+        {
+          dataout = (uint16_t)src[0] | ((uint16_t)src[1] << 8);
+          src += 2;
+        }
+      else
+        {
+          dataout = 0xffff;
+        }
+
+      datain = priv->low->exchange(priv, dataout);
+
+      if (dest && priv->nbit <= 8)
+        {
+          *dest++ = (uint8_t)datain;
+        }
+      else if (dest)
+        {
+          dest[0] = (uint8_t)datain;
+          dest[1] = (uint8_t)(datain >> 8);
+          dest += 2;
+        }
+    }
+}
+
+#ifndef CONFIG_SPI_EXCHANGE
+static void bb_sndblock(struct spi_dev_s *dev, const void *buffer,
+                        size_t nwords)
+{
+  bb_exchange(dev, buffer, NULL, nwords);
+}
+
+static void bb_recvblock(struct spi_dev_s *dev, void *buffer, size_t nwords)
+{
+  bb_exchange(dev, NULL, buffer, nwords);
+}
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct spi_ops_s g_bb_ops =
+{
+  bb_lock,
+  bb_select,
+  bb_setfrequency,
+  bb_setmode,
+  bb_setbits,
+  bb_send,
+#ifdef CONFIG_SPI_EXCHANGE
+  bb_exchange,
+#else
+  bb_sndblock,
+  bb_recvblock,
+#endif
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+struct spi_dev_s *spi_create_bitbang(const struct spi_bitbang_ops_s *low,
+                                     void *priv)
+{
+  struct spi_bitbang_s *dev = calloc(1, sizeof(struct spi_bitbang_s));
+
+  if (dev)
+    {
+      dev->dev.ops = &g_bb_ops;
+      dev->low     = low;
+      dev->priv    = priv;
+      dev->nbit    = 8;
+    }
+
+  return dev ? &dev->dev : NULL;
+}
+
+void spi_destroy_bitbang(struct spi_dev_s *dev)
+{
+  free(dev);
+}
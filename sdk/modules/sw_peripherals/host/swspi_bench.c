@@ -0,0 +1,185 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/swspi_bench.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host throughput benchmark of sw_spi.c on the simulated bus.
+ *
+ * Compares the burst path with the per word path of the bitbang layer at
+ * the fastest clock, then for a range of requested frequencies prints the
+ * frequency SPI_SETFREQUENCY() returned and the one measured over a long
+ * burst. On the host the GPIO "access" is a function call into the bus
+ * model, so only the ratios carry over to the target.
+ *
+ *   swspi_bench [words]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <sw_peripherals/sw_spi.h>
+
+#include "swspi_bus.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_buf[BUS_MAX_WORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Clock words bytes and return the bit rate */
+
+static double run(FAR struct spi_dev_s *spi, uint32_t words, bool per_word)
+{
+  uint64_t start;
+  uint32_t done;
+  uint32_t n;
+  uint32_t i;
+
+  SPI_SELECT(spi, 0, true);
+  start = now_ns();
+
+  for (done = 0; done < words; done += n)
+    {
+      n = (words - done < BUS_MAX_WORDS) ? words - done : BUS_MAX_WORDS;
+      bus_reset(SPIDEV_MODE0, 8);
+
+      if (per_word)
+        {
+          for (i = 0; i < n; i++)
+            {
+              SPI_SEND(spi, g_buf[i]);
+            }
+        }
+      else
+        {
+#ifdef CONFIG_SPI_EXCHANGE
+          SPI_EXCHANGE(spi, g_buf, NULL, n);
+#else
+          SPI_SNDBLOCK(spi, g_buf, n);
+#endif
+        }
+    }
+
+  start = now_ns() - start;
+  SPI_SELECT(spi, 0, false);
+
+  return (double)words * 8 * 1e9 / start;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const uint32_t freqs[] =
+  {
+    100000, 400000, 1000000, 4000000, 10000000, 20000000
+  };
+
+  FAR struct spi_dev_s *spi;
+  uint32_t words = (argc > 1) ? atoi(argv[1]) : 200000;
+  uint32_t actual;
+  double burst;
+  double per_word;
+  double measured;
+  double rate;
+  int i;
+  int j;
+
+  spi = create_swspi(BUS_PIN_CS, BUS_PIN_SCK, BUS_PIN_MOSI, BUS_PIN_MISO);
+  if (!spi)
+    {
+      printf("create_swspi failed\n");
+      return EXIT_FAILURE;
+    }
+
+  SPI_SETMODE(spi, SPIDEV_MODE0);
+  SPI_SETBITS(spi, 8);
+
+  actual   = SPI_SETFREQUENCY(spi, UINT32_MAX);
+  burst    = run(spi, words, false);
+  per_word = run(spi, words, true);
+
+  printf("fastest clock: %u Hz returned\n", actual);
+  printf("  burst    %10.0f bit/s\n", burst);
+  printf("  per word %10.0f bit/s (burst is %.2fx)\n", per_word,
+         burst / per_word);
+
+  printf("%10s %10s %10s %8s\n", "request", "returned", "measured",
+         "error");
+
+  for (i = 0; i < (int)(sizeof(freqs) / sizeof(freqs[0])); i++)
+    {
+      actual = SPI_SETFREQUENCY(spi, freqs[i]);
+
+      /* Fastest of 5 runs of about 10 ms, host scheduling only ever makes
+       * a run slower.
+       */
+
+      for (j = 0, measured = 0; j < 5; j++)
+        {
+          rate = run(spi, actual / 800 + 1, false);
+          if (rate > measured)
+            {
+              measured = rate;
+            }
+        }
+
+      printf("%10u %10u %10.0f %+7.2f%%\n", freqs[i], actual, measured,
+             (measured - actual) * 100.0 / actual);
+    }
+
+  destroy_swspi(spi);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/swspi_bus.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <arch/board/board.h>
+
+#include "swspi_bus.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct bus_s g_bus =
+{
+  .cs = 1,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void bus_error(const char *what)
+{
+  if (g_bus.errors++ < 8)
+    {
+      printf("bus: %s\n", what);
+    }
+}
+
+/* Put bit g_bus.bit of the current word on MISO */
+
+static void bus_drive(void)
+{
+  uint16_t word = (g_bus.tx_pos < BUS_MAX_WORDS) ?
+                  g_bus.tx[g_bus.tx_pos] : 0;
+
+  g_bus.miso = (word >> (g_bus.nbits - 1 - g_bus.bit)) & 1;
+}
+
+static void bus_sample(void)
+{
+  g_bus.shift = (uint16_t)((g_bus.shift << 1) | g_bus.mosi);
+
+  if (++g_bus.bit == g_bus.nbits)
+    {
+      if (g_bus.rx_len < BUS_MAX_WORDS)
+        {
+          g_bus.rx[g_bus.rx_len++] = g_bus.shift &
+                                     ((1u << g_bus.nbits) - 1);
+        }
+
+      g_bus.tx_pos++;
+      g_bus.bit   = 0;
+      g_bus.shift = 0;
+    }
+}
+
+static void bus_sck(int level)
+{
+  bool lead;
+
+  if (level == g_bus.sck)
+    {
+      return;
+    }
+
+  g_bus.sck = level;
+  if (g_bus.cs)
+    {
+      return;
+    }
+
+  g_bus.edges++;
+  lead = (level != (int)g_bus.cpol);
+
+  if (lead != !g_bus.cpha)
+    {
+      /* Shifting edge: trailing for CPHA = 0, leading for CPHA = 1. With
+       * CPHA = 0 it drives the bit after the one just sampled.
+       */
+
+      bus_drive();
+    }
+  else
+    {
+      bus_sample();
+    }
+}
+
+static void bus_cs(int level)
+{
+  if (level == g_bus.cs)
+    {
+      return;
+    }
+
+  if (g_bus.sck != (int)g_bus.cpol)
+    {
+      bus_error("CS changed with SCK not idle");
+    }
+
+  g_bus.cs = level;
+
+  if (!level)
+    {
+      g_bus.bit   = 0;
+      g_bus.shift = 0;
+      if (!g_bus.cpha)
+        {
+          bus_drive();
+        }
+    }
+  else if (g_bus.bit != 0)
+    {
+      bus_error("CS released in the middle of a word");
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void bus_reset(int mode, int nbits)
+{
+  g_bus.cpol   = (mode & 2) != 0;
+  g_bus.cpha   = (mode & 1) != 0;
+  g_bus.nbits  = nbits;
+  g_bus.tx_pos = 0;
+  g_bus.rx_len = 0;
+  g_bus.bit    = 0;
+  g_bus.shift  = 0;
+  g_bus.edges  = 0;
+}
+
+void board_gpio_write(uint32_t pin, int value)
+{
+  value = value ? 1 : 0;
+
+  switch (pin)
+    {
+      case BUS_PIN_CS:
+        bus_cs(value);
+        break;
+
+      case BUS_PIN_SCK:
+        bus_sck(value);
+        break;
+
+      case BUS_PIN_MOSI:
+        g_bus.mosi = value;
+        break;
+
+      default:
+        bus_error("write to an input or unknown pin");
+        break;
+    }
+}
+
+int board_gpio_read(uint32_t pin)
+{
+  if (pin != BUS_PIN_MISO)
+    {
+      bus_error("read from an output or unknown pin");
+      return 0;
+    }
+
+  return g_bus.miso;
+}
+
+int board_gpio_config(uint32_t pin, int mode, bool input, bool drive,
+                      int pull)
+{
+  if (input != (pin == BUS_PIN_MISO))
+    {
+      bus_error("wrong pin direction");
+    }
+
+  return 0;
+}
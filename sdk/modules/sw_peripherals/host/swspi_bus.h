@@ -0,0 +1,113 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/swspi_bus.h
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Simulated GPIO bus with an SPI slave, for the host build of sw_spi.c.
+ *
+ * board_gpio_write() and board_gpio_read() act on four simulated pins. The
+ * slave follows the bus like a device would: it only sees SCK edges while
+ * CS is low, samples MOSI on the latching edge of the configured mode and
+ * changes MISO on the other edge (or when CS falls, for CPHA = 0). Protocol
+ * violations are counted in g_bus.errors.
+ */
+
+#ifndef HOST_SWSPI_BUS_H
+#define HOST_SWSPI_BUS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BUS_PIN_CS     10
+#define BUS_PIN_SCK    11
+#define BUS_PIN_MOSI   12
+#define BUS_PIN_MISO   13
+
+#define BUS_MAX_WORDS  1024
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct bus_s
+{
+  /* Pin levels */
+
+  int cs;
+  int sck;
+  int mosi;
+  int miso;
+
+  /* Slave configuration */
+
+  bool cpol;
+  bool cpha;
+  int  nbits;
+
+  /* Words the slave sends, and words it received */
+
+  uint16_t tx[BUS_MAX_WORDS];
+  uint16_t rx[BUS_MAX_WORDS];
+  size_t   tx_pos;
+  size_t   rx_len;
+  int      bit;           /* Bits sampled in the current word */
+  uint16_t shift;
+
+  unsigned long edges;    /* SCK edges seen while selected */
+  unsigned long errors;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct bus_s g_bus;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Set the slave mode and word size, and forget all words */
+
+void bus_reset(int mode, int nbits);
+
+#endif /* HOST_SWSPI_BUS_H */
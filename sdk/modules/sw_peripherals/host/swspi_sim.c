@@ -0,0 +1,281 @@
+/****************************************************************************
+ * modules/sw_peripherals/host/swspi_sim.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host bit level test of sw_spi.c.
+ *
+ * create_swspi() runs on the simulated bus of swspi_bus.c. For every SPI
+ * mode and word sizes of 8, 12 and 16 bits, random buffers are exchanged
+ * with the simulated slave through the burst path (exchange, or sndblock
+ * and recvblock) and through the per word path of the bitbang layer
+ * (SPI_SEND), and both directions are compared bit for bit. The bus also
+ * checks that CS only changes with SCK idle and on word boundaries.
+ *
+ * SPI_SETFREQUENCY() is checked to return a frequency not above the
+ * request, down to the fastest one the GPIO access allows.
+ *
+ *   swspi_sim [iterations]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sw_peripherals/sw_spi.h>
+
+#include "swspi_bus.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static void fail(const char *what, int mode, int nbits, size_t len)
+{
+  if (g_errors++ < 8)
+    {
+      printf("%s: mode %d, %d bits, %zu words\n", what, mode, nbits, len);
+    }
+}
+
+static void put_word(uint8_t *buf, size_t i, int nbits, uint16_t word)
+{
+  if (nbits <= 8)
+    {
+      buf[i] = (uint8_t)word;
+    }
+  else
+    {
+      buf[2 * i]     = (uint8_t)word;
+      buf[2 * i + 1] = (uint8_t)(word >> 8);
+    }
+}
+
+static uint16_t get_word(const uint8_t *buf, size_t i, int nbits)
+{
+  if (nbits <= 8)
+    {
+      return buf[i];
+    }
+
+  return (uint16_t)(buf[2 * i] | (buf[2 * i + 1] << 8));
+}
+
+/* Run one transfer of len words. send_ones selects a NULL tx buffer,
+ * per_word the bitbang layer instead of the burst path.
+ */
+
+static void transfer(FAR struct spi_dev_s *spi, int mode, int nbits,
+                     size_t len, bool send_ones, bool per_word)
+{
+  static uint8_t tx[2 * BUS_MAX_WORDS];
+  static uint8_t rx[2 * BUS_MAX_WORDS];
+  uint16_t mask = (uint16_t)((1u << nbits) - 1);
+  size_t rx_first = 0;      /* Slave word the master reads first */
+  size_t clocked = len;     /* Words clocked in total */
+  size_t i;
+
+  bus_reset(mode, nbits);
+
+  for (i = 0; i < len; i++)
+    {
+      put_word(tx, i, nbits, send_ones ? mask : (uint16_t)rnd() & mask);
+    }
+
+  for (i = 0; i < 2 * len; i++)
+    {
+      g_bus.tx[i] = (uint16_t)rnd() & mask;
+    }
+
+  memset(rx, 0x5a, sizeof(rx));
+
+  SPI_SELECT(spi, 0, true);
+
+  if (per_word)
+    {
+      for (i = 0; i < len; i++)
+        {
+          put_word(rx, i, nbits,
+                   (uint16_t)SPI_SEND(spi, get_word(tx, i, nbits)));
+        }
+    }
+#ifdef CONFIG_SPI_EXCHANGE
+  else
+    {
+      SPI_EXCHANGE(spi, send_ones ? NULL : tx, rx, len);
+    }
+#else
+  else if (send_ones)
+    {
+      SPI_RECVBLOCK(spi, rx, len);
+    }
+  else
+    {
+      /* sndblock drops MISO, recvblock sends ones */
+
+      SPI_SNDBLOCK(spi, tx, len);
+      SPI_RECVBLOCK(spi, rx, len);
+      rx_first = len;
+      clocked  = 2 * len;
+    }
+#endif
+
+  SPI_SELECT(spi, 0, false);
+
+  if (g_bus.rx_len != clocked ||
+      g_bus.edges != 2 * (unsigned long)nbits * clocked)
+    {
+      fail("wrong number of clocks", mode, nbits, len);
+      return;
+    }
+
+  for (i = 0; i < clocked; i++)
+    {
+      if (g_bus.rx[i] != ((i < len) ? get_word(tx, i, nbits) : mask))
+        {
+          fail("slave received wrong data", mode, nbits, len);
+          break;
+        }
+    }
+
+  for (i = 0; i < len; i++)
+    {
+      if (get_word(rx, i, nbits) != g_bus.tx[rx_first + i])
+        {
+          fail("master received wrong data", mode, nbits, len);
+          break;
+        }
+    }
+}
+
+static void test_frequency(FAR struct spi_dev_s *spi)
+{
+  uint32_t fastest = SPI_SETFREQUENCY(spi, UINT32_MAX);
+  uint32_t prev = 0;
+  uint32_t freq;
+  uint32_t actual;
+
+  for (freq = 1000; freq < 100000000; freq += freq / 7 + 1)
+    {
+      actual = SPI_SETFREQUENCY(spi, freq);
+      if (actual > freq && actual != fastest)
+        {
+          if (g_errors++ < 8)
+            {
+              printf("frequency %u: got %u\n", freq, actual);
+            }
+        }
+
+      if (actual < prev)
+        {
+          if (g_errors++ < 8)
+            {
+              printf("frequency %u: %u is below %u\n", freq, actual, prev);
+            }
+        }
+
+      prev = actual;
+    }
+
+  printf("fastest clock %u Hz\n", fastest);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  static const int widths[] =
+  {
+    8, 12, 16
+  };
+
+  FAR struct spi_dev_s *spi;
+  int iterations = (argc > 1) ? atoi(argv[1]) : 2000;
+  int mode;
+  int w;
+  int i;
+
+  spi = create_swspi(BUS_PIN_CS, BUS_PIN_SCK, BUS_PIN_MOSI, BUS_PIN_MISO);
+  if (!spi)
+    {
+      printf("create_swspi failed\n");
+      return EXIT_FAILURE;
+    }
+
+  test_frequency(spi);
+  SPI_SETFREQUENCY(spi, UINT32_MAX);
+
+  for (mode = 0; mode < 4; mode++)
+    {
+      SPI_SETMODE(spi, (enum spi_mode_e)mode);
+
+      for (w = 0; w < 3; w++)
+        {
+          SPI_SETBITS(spi, widths[w]);
+
+          for (i = 0; i < iterations; i++)
+            {
+              size_t len = 1 + rnd() % 64;
+
+              transfer(spi, mode, widths[w], len, (rnd() & 3) == 0, false);
+              transfer(spi, mode, widths[w], len, false, true);
+            }
+        }
+    }
+
+  destroy_swspi(spi);
+
+  printf("%lu errors, %lu bus errors\n", g_errors, g_bus.errors);
+  return (g_errors || g_bus.errors) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
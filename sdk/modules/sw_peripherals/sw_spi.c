@@ -39,6 +39,10 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
 #include <nuttx/arch.h>
 #include <arch/board/board.h>
 #include <arch/chip/pin.h>
@@ -46,6 +50,12 @@
 #include <nuttx/kmalloc.h>
 
 #include <sw_peripherals/sw_spi.h>
+#include <utils/cyclecount.h>
+
+#ifdef CONFIG_SW_PERIPHERALS_SPI_DIRECT
+#include "arm_internal.h"
+#include "hardware/cxd5602_topreg.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -57,6 +67,38 @@
 #define BIT_PER_WORD(dev)  (8)
 #endif
 
+#ifdef CONFIG_SW_PERIPHERALS_SPI_DIRECT
+/* One register per pin, same layout as arch/arm/src/cxd56xx/cxd56_gpio.c */
+
+#define GPIO_REGADDR(pin)  (CXD56_TOPREG_GP_I2C4_BCK + \
+                            (((pin) - ((pin) < PIN_IS_CLK ? 1 : 7)) * 4))
+#define GPIO_OUTPUT_HIGH   (1u << 8)
+#define GPIO_INPUT_MASK    (1u << 0)
+#endif
+
+/* Calibration, see swspi_calibrate() */
+
+#define CALIB_NSEC         ((uint64_t)CONFIG_SW_PERIPHERALS_SPI_CALIBRATION \
+                            * 1000000)
+#define CALIB_LOOPS        (64)
+#define CALIB_MAX_WORDS    (1 << 20)
+
+/* With a fine timer the measurement is split into CALIB_RUNS runs and the
+ * fastest is kept, so that interrupts taken during calibration do not make
+ * the clock look slower than it is. The CPU cycle counter is used where
+ * there is one, otherwise CLOCK_MONOTONIC, which usually only has the
+ * resolution of the tick and then needs a single long run.
+ */
+
+#define CALIB_RUNS         (8)
+#define CALIB_FINE_NSEC    (1000)
+
+#if defined(CYCLECOUNT_AVAILABLE) && defined(CONFIG_ARCH_CHIP_CXD56XX)
+#  define CALIB_CYCLECOUNT
+#endif
+
+#define PSEC_PER_SEC       (1000000000000ull)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -75,6 +117,24 @@ static int swspi_cmddata(FAR struct spi_bitbang_s *priv, uint32_t devid,
     bool cmd);
 #endif
 
+#ifdef CONFIG_SPI_EXCHANGE
+static void swspi_burst_exchange(FAR struct spi_dev_s *spi,
+    FAR const void *txbuffer, FAR void *rxbuffer, size_t nwords);
+#else
+static void swspi_burst_sndblock(FAR struct spi_dev_s *spi,
+    FAR const void *buffer, size_t nwords);
+static void swspi_burst_recvblock(FAR struct spi_dev_s *spi,
+    FAR void *buffer, size_t nwords);
+#endif
+
+#ifdef CALIB_CYCLECOUNT
+/* From cxd56_clock.h, which is only on the include path with
+ * CONFIG_SW_PERIPHERALS_SPI_DIRECT.
+ */
+
+extern uint32_t cxd56_get_cpu_baseclk(void);
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -85,6 +145,36 @@ struct swspi_s
   int sck;
   int mosi;
   int miso;
+
+  bool cpol;            /* SCK level while idle */
+  bool cpha;            /* MISO is sampled on the trailing edge */
+
+  uint32_t frequency;   /* Last requested frequency */
+  uint32_t actual;      /* Achieved frequency for it */
+  uint32_t delay;       /* Delay loops per half clock */
+  uint32_t bit_ps;      /* Cost of one bit without delay */
+  uint32_t loop_ps;     /* Cost of one delay loop */
+
+  struct spi_ops_s ops; /* Bitbang ops with the burst transfer */
+};
+
+/* Everything one bit needs, prepared once per transfer.
+ * With CONFIG_SW_PERIPHERALS_SPI_DIRECT the pins are register addresses and
+ * the levels are whole register values, otherwise they are pin numbers and
+ * 0/1 for board_gpio_write().
+ */
+
+struct swspi_io_s
+{
+  uint32_t sck;
+  uint32_t mosi;
+  uint32_t miso;
+  uint32_t sck_lead;    /* SCK after the leading edge */
+  uint32_t sck_trail;   /* SCK after the trailing edge, i.e. idle */
+  uint32_t mosi_low;
+  uint32_t mosi_high;
+  uint32_t delay;
+  bool     cpha;
 };
 
 /****************************************************************************
@@ -106,43 +196,360 @@ static struct spi_bitbang_ops_s swspi_ops =
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
- 
+
 /****************************************************************************
  * Name: set_pin_default
  ****************************************************************************/
 
 static void set_pin_default(FAR struct swspi_s *dev)
 {
-  /* Now mode0 is suppoeted only */
-
   board_gpio_write(dev->cs, 1);
-  board_gpio_write(dev->sck, 0);
+  board_gpio_write(dev->sck, dev->cpol ? 1 : 0);
+}
+
+/****************************************************************************
+ * Name: swspi_io_prepare
+ ****************************************************************************/
+
+static void swspi_io_prepare(FAR struct swspi_s *dev,
+    FAR struct swspi_io_s *io)
+{
+#ifdef CONFIG_SW_PERIPHERALS_SPI_DIRECT
+  uint32_t sck;
+  uint32_t mosi;
+
+  io->sck  = GPIO_REGADDR(dev->sck);
+  io->mosi = GPIO_REGADDR(dev->mosi);
+  io->miso = GPIO_REGADDR(dev->miso);
+
+  /* Keep the rest of the pin configuration as it is */
+
+  sck  = getreg32(io->sck) & ~GPIO_OUTPUT_HIGH;
+  mosi = getreg32(io->mosi) & ~GPIO_OUTPUT_HIGH;
+
+  io->sck_lead  = dev->cpol ? sck : sck | GPIO_OUTPUT_HIGH;
+  io->sck_trail = dev->cpol ? sck | GPIO_OUTPUT_HIGH : sck;
+  io->mosi_low  = mosi;
+  io->mosi_high = mosi | GPIO_OUTPUT_HIGH;
+#else
+  io->sck  = dev->sck;
+  io->mosi = dev->mosi;
+  io->miso = dev->miso;
+
+  io->sck_lead  = dev->cpol ? 0 : 1;
+  io->sck_trail = dev->cpol ? 1 : 0;
+  io->mosi_low  = 0;
+  io->mosi_high = 1;
+#endif
+
+  io->delay = dev->delay;
+  io->cpha  = dev->cpha;
+}
+
+/****************************************************************************
+ * Name: swspi_io_write
+ ****************************************************************************/
+
+static inline void swspi_io_write(uint32_t pin, uint32_t value)
+{
+#ifdef CONFIG_SW_PERIPHERALS_SPI_DIRECT
+  putreg32(value, pin);
+#else
+  board_gpio_write(pin, value);
+#endif
+}
+
+/****************************************************************************
+ * Name: swspi_io_read
+ ****************************************************************************/
+
+static inline bool swspi_io_read(uint32_t pin)
+{
+#ifdef CONFIG_SW_PERIPHERALS_SPI_DIRECT
+  return (getreg32(pin) & GPIO_INPUT_MASK) != 0;
+#else
+  return board_gpio_read(pin) != 0;
+#endif
+}
+
+/****************************************************************************
+ * Name: swspi_io_delay
+ ****************************************************************************/
+
+static inline void swspi_io_delay(uint32_t loops)
+{
+  for (; loops > 0; loops--)
+    {
+      __asm__ __volatile__("");
+    }
+}
+
+/****************************************************************************
+ * Name: swspi_io_word
+ ****************************************************************************/
+
+static inline uint16_t swspi_io_word(FAR const struct swspi_io_s *io,
+    uint16_t dataout, int nbits)
+{
+  uint16_t rxdata = 0;
+  uint16_t bitmask;
+
+  for (bitmask = (1 << (nbits - 1)); bitmask != 0; bitmask >>= 1)
+    {
+      if (!io->cpha)
+        {
+          /* Data set while idle, latched on the leading edge */
+
+          swspi_io_write(io->mosi,
+                         (dataout & bitmask) ? io->mosi_high : io->mosi_low);
+          swspi_io_delay(io->delay);
+          swspi_io_write(io->sck, io->sck_lead);
+          rxdata |= swspi_io_read(io->miso) ? bitmask : 0;
+          swspi_io_delay(io->delay);
+          swspi_io_write(io->sck, io->sck_trail);
+        }
+      else
+        {
+          /* Data set on the leading edge, latched on the trailing edge */
+
+          swspi_io_write(io->sck, io->sck_lead);
+          swspi_io_write(io->mosi,
+                         (dataout & bitmask) ? io->mosi_high : io->mosi_low);
+          swspi_io_delay(io->delay);
+          swspi_io_write(io->sck, io->sck_trail);
+          rxdata |= swspi_io_read(io->miso) ? bitmask : 0;
+          swspi_io_delay(io->delay);
+        }
+    }
+
+  return rxdata;
+}
+
+/****************************************************************************
+ * Name: swspi_burst
+ *
+ * Description:
+ *   Transfer a whole buffer. The pin registers and levels are looked up
+ *   once here instead of once per bit, and the words are clocked without
+ *   going through the bitbang layer. A NULL txbuffer sends all ones, a NULL
+ *   rxbuffer drops the received data.
+ *
+ ****************************************************************************/
+
+static void swspi_burst(FAR struct spi_dev_s *spi, FAR const void *txbuffer,
+    FAR void *rxbuffer, size_t nwords)
+{
+  FAR struct spi_bitbang_s *bitbang = (FAR struct spi_bitbang_s *)spi;
+  FAR const uint8_t *src = (FAR const uint8_t *)txbuffer;
+  FAR uint8_t *dest = (FAR uint8_t *)rxbuffer;
+  struct swspi_io_s io;
+  int nbits = BIT_PER_WORD(bitbang);
+  uint16_t dataout;
+  uint16_t datain;
+
+  swspi_io_prepare((FAR struct swspi_s *)bitbang->priv, &io);
+
+  if (nbits <= 8)
+    {
+      while (nwords-- > 0)
+        {
+          dataout = src ? *src++ : 0xff;
+          datain  = swspi_io_word(&io, dataout, nbits);
+          if (dest)
+            {
+              *dest++ = (uint8_t)datain;
+            }
+        }
+    }
+  else
+    {
+      while (nwords-- > 0)
+        {
+          if (src)
+            {
+              dataout = (uint16_t)src[0] | ((uint16_t)src[1] << 8);
+              src += 2;
+            }
+          else
+            {
+              dataout = 0xffff;
+            }
+
+          datain = swspi_io_word(&io, dataout, nbits);
+          if (dest)
+            {
+              dest[0] = (uint8_t)datain;
+              dest[1] = (uint8_t)(datain >> 8);
+              dest += 2;
+            }
+        }
+    }
+}
+
+#ifdef CONFIG_SPI_EXCHANGE
+/****************************************************************************
+ * Name: swspi_burst_exchange
+ ****************************************************************************/
+
+static void swspi_burst_exchange(FAR struct spi_dev_s *spi,
+    FAR const void *txbuffer, FAR void *rxbuffer, size_t nwords)
+{
+  swspi_burst(spi, txbuffer, rxbuffer, nwords);
+}
+#else
+/****************************************************************************
+ * Name: swspi_burst_sndblock
+ ****************************************************************************/
+
+static void swspi_burst_sndblock(FAR struct spi_dev_s *spi,
+    FAR const void *buffer, size_t nwords)
+{
+  swspi_burst(spi, buffer, NULL, nwords);
 }
 
 /****************************************************************************
- * Name: exchange_one_bit
+ * Name: swspi_burst_recvblock
  ****************************************************************************/
 
-static bool exchange_one_bit(FAR struct swspi_s *dev, bool bit)
+static void swspi_burst_recvblock(FAR struct spi_dev_s *spi,
+    FAR void *buffer, size_t nwords)
 {
-  int recv_bit;
+  swspi_burst(spi, NULL, buffer, nwords);
+}
+#endif
 
-  /* Now mode0 is suppoered only. */
+/****************************************************************************
+ * Name: swspi_run
+ *
+ * Description:
+ *   Clock nwords bytes and return the time taken in nanoseconds.
+ *
+ ****************************************************************************/
 
-  /* Clock Low */
+static uint64_t swspi_run(FAR const struct swspi_io_s *io, uint32_t nwords)
+{
+#ifdef CALIB_CYCLECOUNT
+  uint32_t start;
+  uint32_t cycles;
+  uint32_t i;
 
-  board_gpio_write(dev->mosi, bit ? 1 : 0); /* Data set on MOSI */
+  start = cyclecount_get();
 
-  /* Clock High */
+  for (i = 0; i < nwords; i++)
+    {
+      swspi_io_word(io, 0xff, 8);
+    }
 
-  board_gpio_write(dev->sck, 1); /* Latch timing */
-  recv_bit = board_gpio_read(dev->miso); /* Latch MIOSO */
+  cycles = cyclecount_get() - start;
 
-  /* Clock Low */
+  return (uint64_t)cycles * 1000000000 / cxd56_get_cpu_baseclk();
+#else
+  struct timespec start;
+  struct timespec end;
+  uint32_t i;
+
+  /* Start right after a tick, then the clock resolution only costs
+   * accuracy at the end of the measurement.
+   */
 
-  board_gpio_write(dev->sck, 0); /* Shift timing */
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  do
+    {
+      clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+  while (start.tv_sec == end.tv_sec && start.tv_nsec == end.tv_nsec);
 
-  return (recv_bit != 0);
+  for (i = 0; i < nwords; i++)
+    {
+      swspi_io_word(io, 0xff, 8);
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  return (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 +
+         end.tv_nsec - start.tv_nsec;
+#endif
+}
+
+/****************************************************************************
+ * Name: swspi_measure
+ *
+ * Description:
+ *   Return the cost of one bit in picoseconds with the given delay. The
+ *   clock runs with CS deasserted, so no device sees it.
+ *
+ ****************************************************************************/
+
+static uint32_t swspi_measure(FAR struct swspi_s *dev, uint32_t delay)
+{
+  struct swspi_io_s io;
+  uint64_t elapsed;
+  uint64_t run;
+  uint32_t nwords;
+  int runs = CALIB_RUNS;
+  int i;
+#ifndef CALIB_CYCLECOUNT
+  struct timespec res;
+
+  if (clock_getres(CLOCK_MONOTONIC, &res) < 0 || res.tv_sec > 0 ||
+      res.tv_nsec > CALIB_FINE_NSEC)
+    {
+      runs = 1;
+    }
+#endif
+
+  swspi_io_prepare(dev, &io);
+  io.delay = delay;
+
+  /* Size a run to CALIB_NSEC / runs, then keep the fastest */
+
+  for (nwords = 16; ; nwords <<= 1)
+    {
+      elapsed = swspi_run(&io, nwords);
+      if (elapsed >= CALIB_NSEC / runs || nwords >= CALIB_MAX_WORDS)
+        {
+          break;
+        }
+    }
+
+  for (i = 1; i < runs; i++)
+    {
+      run = swspi_run(&io, nwords);
+      if (run < elapsed)
+        {
+          elapsed = run;
+        }
+    }
+
+  return (uint32_t)(elapsed * 1000 / ((uint64_t)nwords * 8));
+}
+
+/****************************************************************************
+ * Name: swspi_calibrate
+ *
+ * Description:
+ *   Measure the bit cost without delay and with CALIB_LOOPS delay loops per
+ *   half clock. swspi_setfrequency() derives the delay from both.
+ *
+ ****************************************************************************/
+
+static void swspi_calibrate(FAR struct swspi_s *dev)
+{
+  uint32_t slow;
+
+#ifdef CALIB_CYCLECOUNT
+  cyclecount_enable();
+#endif
+
+  dev->bit_ps = swspi_measure(dev, 0);
+  slow = swspi_measure(dev, CALIB_LOOPS);
+
+  dev->loop_ps = slow > dev->bit_ps ?
+                 (slow - dev->bit_ps) / (2 * CALIB_LOOPS) : 0;
+  if (dev->loop_ps == 0)
+    {
+      dev->loop_ps = 1;
+    }
 }
 
 /****************************************************************************
@@ -163,22 +570,81 @@ static void swspi_select(FAR struct spi_bitbang_s *priv,
  * Name: swspi_setmode
  ****************************************************************************/
 
-static void swspi_setmode(FAR struct spi_bitbang_s *dev,
+static void swspi_setmode(FAR struct spi_bitbang_s *priv,
     enum spi_mode_e mode)
 {
-  /* Do nothing, just MODE0 is supported. */
+  FAR struct swspi_s *dev = (FAR struct swspi_s *)priv->priv;
+
+  switch (mode)
+    {
+      case SPIDEV_MODE0:
+        dev->cpol = false;
+        dev->cpha = false;
+        break;
+
+      case SPIDEV_MODE1:
+        dev->cpol = false;
+        dev->cpha = true;
+        break;
+
+      case SPIDEV_MODE2:
+        dev->cpol = true;
+        dev->cpha = false;
+        break;
+
+      case SPIDEV_MODE3:
+        dev->cpol = true;
+        dev->cpha = true;
+        break;
+
+      default:
+        return;
+    }
+
+  /* Move SCK to its new idle level before the next CS assertion */
+
+  board_gpio_write(dev->sck, dev->cpol ? 1 : 0);
 }
 
 /****************************************************************************
  * Name: swspi_setfrequency
+ *
+ * Description:
+ *   Pick the smallest delay that does not exceed the requested frequency
+ *   and return the frequency that delay achieves. Requests above what the
+ *   GPIO access allows return that maximum.
+ *
  ****************************************************************************/
 
-static uint32_t swspi_setfrequency(FAR struct spi_bitbang_s *dev,
+static uint32_t swspi_setfrequency(FAR struct spi_bitbang_s *priv,
     uint32_t freq)
 {
-  /* Support only 1Mbps now */
+  FAR struct swspi_s *dev = (FAR struct swspi_s *)priv->priv;
+  uint64_t period;
+  uint64_t delay = 0;
 
-  return 1000000;
+  if (freq == 0 || freq == dev->frequency)
+    {
+      return dev->actual;
+    }
+
+  period = PSEC_PER_SEC / freq;
+  if (period > dev->bit_ps)
+    {
+      delay = (period - dev->bit_ps + 2 * dev->loop_ps - 1) /
+              (2 * dev->loop_ps);
+      if (delay > UINT32_MAX)
+        {
+          delay = UINT32_MAX;
+        }
+    }
+
+  dev->frequency = freq;
+  dev->delay     = (uint32_t)delay;
+  dev->actual    = (uint32_t)(PSEC_PER_SEC /
+                              (dev->bit_ps + 2 * delay * dev->loop_ps));
+
+  return dev->actual;
 }
 
 /****************************************************************************
@@ -188,18 +654,10 @@ static uint32_t swspi_setfrequency(FAR struct spi_bitbang_s *dev,
 static uint16_t swspi_exchange(FAR struct spi_bitbang_s *dev,
   uint16_t dataout)
 {
-  uint16_t rxdata;
-  uint16_t bitmask;
+  struct swspi_io_s io;
 
-  rxdata = 0;
-  for (bitmask = (1<<(BIT_PER_WORD(dev) - 1)); bitmask != 0; bitmask >>= 1)
-    {
-      rxdata |= exchange_one_bit((struct swspi_s *)dev->priv,
-          (dataout & bitmask) ? true : false)
-        ? bitmask : 0;
-    }
-
-  return rxdata;
+  swspi_io_prepare((FAR struct swspi_s *)dev->priv, &io);
+  return swspi_io_word(&io, dataout, BIT_PER_WORD(dev));
 }
 
 /****************************************************************************
@@ -262,9 +720,24 @@ FAR struct spi_dev_s *create_swspi(int cs_pin,
 
           board_gpio_config(miso_pin, 0 , true, true, PIN_FLOAT);
 
-          /* Default parameter settings */
+          /* Default parameter settings, mode 0 at 1MHz */
 
           set_pin_default(priv);
+          swspi_calibrate(priv);
+          swspi_setfrequency((FAR struct spi_bitbang_s *)dev, 1000000);
+
+          /* Route buffer transfers to the burst path, everything else
+           * stays with the bitbang layer.
+           */
+
+          priv->ops = *dev->ops;
+#ifdef CONFIG_SPI_EXCHANGE
+          priv->ops.exchange  = swspi_burst_exchange;
+#else
+          priv->ops.sndblock  = swspi_burst_sndblock;
+          priv->ops.recvblock = swspi_burst_recvblock;
+#endif
+          dev->ops = &priv->ops;
         }
       else
         {
@@ -282,13 +755,17 @@ FAR struct spi_dev_s *create_swspi(int cs_pin,
 void destroy_swspi(FAR struct spi_dev_s *spi)
 {
   FAR struct spi_bitbang_s *dev = (FAR struct spi_bitbang_s *)spi;
+  FAR void *priv;
 
   if (dev)
     {
-      if (dev->priv)
+      /* The device may still point at the ops in priv */
+
+      priv = dev->priv;
+      spi_destroy_bitbang(spi);
+      if (priv)
         {
-          kmm_free(dev->priv);
+          kmm_free(priv);
         }
-      spi_destroy_bitbang(spi);
     }
 }
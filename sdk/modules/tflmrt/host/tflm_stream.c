@@ -0,0 +1,745 @@
+/****************************************************************************
+ * modules/tflmrt/host/tflm_stream.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/* Host test of the streaming input of the TFLM runtime.
+ *
+ * tf_runtime.h is implemented here by a model with four inputs and three
+ * outputs:
+ *
+ *   input 0   untouched by the stream, must keep its contents
+ *   input 1   window of samples, its size gives the window
+ *   input 2   state A: number of propagations since the reset and a
+ *             hash chained over their windows
+ *   input 3   state B: 3 bytes, each incremented by a propagation
+ *   outputs   hash of the window, next state A, next state B
+ *
+ * Every propagation logs what the model sees. The pushes are replayed on
+ * a plain list of samples, and each propagation must come after the same
+ * sample, see the newest window, and get the state of the propagation
+ * before it. Window and sample sizes, hops, push lengths and resets are
+ * random, with and without the state tensors. A failing propagation must
+ * be returned by tflm_stream_push(), and a reset must start the stream
+ * again.
+ * Invalid configurations must be refused.
+ *
+ * With CONFIG_TFLM_RT_PROFILE, the streamed propagations must be
+ * profiled.
+ *
+ *   tflm_stream [seed]
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tflmrt/runtime.h>
+
+#include "tf_runtime.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROUNDS          300
+#define PUSHES          60
+#define MAX_LOG         4096
+
+#define IN_OTHER        0
+#define IN_WINDOW       1
+#define IN_STATE_A      2
+#define IN_STATE_B      3
+#define INPUT_NUM       4
+
+#define OUT_RESULT      0
+#define OUT_STATE_A     1
+#define OUT_STATE_B     2
+#define OUTPUT_NUM      3
+
+#define OTHER_BYTE      0xa5
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Given to tf_rt_initialize_context() as the network */
+
+struct network_s
+{
+  int window_bytes;
+};
+
+struct state_a_s
+{
+  uint32_t count;
+  uint32_t chain;
+};
+
+struct model_s
+{
+  int in_size[INPUT_NUM];
+  int out_size[OUTPUT_NUM];
+  uint8_t *in[INPUT_NUM];
+  uint8_t *out[OUTPUT_NUM];
+  const tf_rt_op_hook_t *hook;
+};
+
+/* What a propagation saw */
+
+struct seen_s
+{
+  uint32_t hash;
+  struct state_a_s a;
+  uint8_t b[3];
+};
+
+/* Replay of a stream on the list of samples */
+
+struct replay_s
+{
+  uint8_t *samples;
+  uint32_t total;       /* Samples since the reset */
+  struct state_a_s a;
+  uint8_t b;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct model_s g_model;
+static struct seen_s g_log[MAX_LOG];
+static int g_log_num;
+static unsigned long g_forwards;        /* Calls of tf_rt_forward() */
+static unsigned long g_failed;
+static unsigned long g_fail_at = ~0ul;  /* Call which fails */
+static unsigned long g_hooked;
+
+static const tflm_stream_state_t g_states[] =
+{
+  { OUT_STATE_A, IN_STATE_A },
+  { OUT_STATE_B, IN_STATE_B },
+};
+
+static uint32_t g_seed = 1;
+static unsigned long g_errors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t rnd(void)
+{
+  g_seed = g_seed * 1103515245 + 12345;
+  return g_seed >> 8;
+}
+
+static void fail(int round, const char *what, long a, long b)
+{
+  if (g_errors++ < 8)
+    {
+      printf("round %d: %s (%ld, %ld)\n", round, what, a, b);
+    }
+}
+
+static uint32_t hash(const uint8_t *data, size_t len)
+{
+  uint32_t h = 2166136261u;
+
+  while (len-- > 0)
+    {
+      h = (h ^ *data++) * 16777619u;
+    }
+
+  return h;
+}
+
+/****************************************************************************
+ * Model
+ ****************************************************************************/
+
+void RegisterDebugLogCallback(DebugLogCallback callback)
+{
+}
+
+int tf_rt_allocate_context(tf_rt_context_pointer *context)
+{
+  *context = &g_model;
+  return 0;
+}
+
+int tf_rt_initialize_context(tf_rt_context_pointer context,
+                             const void *n, int size)
+{
+  struct model_s *m = (struct model_s *)context;
+  const struct network_s *net = (const struct network_s *)n;
+  int i;
+
+  m->in_size[IN_OTHER]    = 4;
+  m->in_size[IN_WINDOW]   = net->window_bytes;
+  m->in_size[IN_STATE_A]  = sizeof(struct state_a_s);
+  m->in_size[IN_STATE_B]  = 3;
+  m->out_size[OUT_RESULT]  = 4;
+  m->out_size[OUT_STATE_A] = sizeof(struct state_a_s);
+  m->out_size[OUT_STATE_B] = 3;
+
+  for (i = 0; i < INPUT_NUM; i++)
+    {
+      m->in[i] = calloc(1, m->in_size[i]);
+    }
+
+  for (i = 0; i < OUTPUT_NUM; i++)
+    {
+      m->out[i] = calloc(1, m->out_size[i]);
+    }
+
+  memset(m->in[IN_OTHER], OTHER_BYTE, m->in_size[IN_OTHER]);
+  return 0;
+}
+
+int tf_rt_free_context(tf_rt_context_pointer *context)
+{
+  struct model_s *m = (struct model_s *)*context;
+  int i;
+
+  for (i = 0; i < INPUT_NUM; i++)
+    {
+      free(m->in[i]);
+    }
+
+  for (i = 0; i < OUTPUT_NUM; i++)
+    {
+      free(m->out[i]);
+    }
+
+  memset(m, 0, sizeof(*m));
+  *context = NULL;
+  return 0;
+}
+
+int tf_rt_num_of_input(tf_rt_context_pointer context)
+{
+  return INPUT_NUM;
+}
+
+int tf_rt_input_size(tf_rt_context_pointer context, size_t index)
+{
+  return ((struct model_s *)context)->in_size[index];
+}
+
+int tf_rt_input_dimension(tf_rt_context_pointer context, size_t index)
+{
+  return 1;
+}
+
+int tf_rt_input_shape(tf_rt_context_pointer context, size_t index,
+                      size_t shape_index)
+{
+  return tf_rt_input_size(context, index);
+}
+
+void *tf_rt_input_buffer(tf_rt_context_pointer context, size_t index)
+{
+  return ((struct model_s *)context)->in[index];
+}
+
+int tf_rt_num_of_output(tf_rt_context_pointer context)
+{
+  return OUTPUT_NUM;
+}
+
+int tf_rt_output_size(tf_rt_context_pointer context, size_t index)
+{
+  return ((struct model_s *)context)->out_size[index];
+}
+
+int tf_rt_output_dimension(tf_rt_context_pointer context, size_t index)
+{
+  return 1;
+}
+
+int tf_rt_output_shape(tf_rt_context_pointer context, size_t index,
+                       size_t shape_index)
+{
+  return tf_rt_output_size(context, index);
+}
+
+void *tf_rt_output_buffer(tf_rt_context_pointer context, size_t index)
+{
+  return ((struct model_s *)context)->out[index];
+}
+
+TfLiteTensor *tf_rt_input_variable(tf_rt_context_pointer context,
+                                   size_t index)
+{
+  return NULL;
+}
+
+TfLiteTensor *tf_rt_output_variable(tf_rt_context_pointer context,
+                                    size_t index)
+{
+  return NULL;
+}
+
+int tf_rt_forward(tf_rt_context_pointer context)
+{
+  struct model_s *m = (struct model_s *)context;
+  struct seen_s *seen = &g_log[g_log_num];
+  struct state_a_s a;
+  int i;
+
+  if (g_forwards++ == g_fail_at)
+    {
+      g_failed++;
+      return -EIO;
+    }
+
+  if (m->hook)
+    {
+      m->hook->begin(m->hook->arg, 0);
+    }
+
+  seen->hash = hash(m->in[IN_WINDOW], m->in_size[IN_WINDOW]);
+  memcpy(&seen->a, m->in[IN_STATE_A], sizeof(seen->a));
+  memcpy(seen->b, m->in[IN_STATE_B], sizeof(seen->b));
+
+  memcpy(m->out[OUT_RESULT], &seen->hash, sizeof(seen->hash));
+  a.count = seen->a.count + 1;
+  a.chain = seen->a.chain * 31 + seen->hash;
+  memcpy(m->out[OUT_STATE_A], &a, sizeof(a));
+  for (i = 0; i < 3; i++)
+    {
+      m->out[OUT_STATE_B][i] = seen->b[i] + 1;
+    }
+
+  if (m->hook)
+    {
+      m->hook->end(m->hook->arg, 0, "MOCK", 4);
+      g_hooked++;
+    }
+
+  if (g_log_num < MAX_LOG - 1)
+    {
+      g_log_num++;
+    }
+
+  return 0;
+}
+
+void tf_rt_set_malloc(void *(*user_malloc)(size_t size))
+{
+}
+
+void tf_rt_set_free(void (*user_free)(void *ptr))
+{
+}
+
+size_t tf_rt_arenasize(tf_rt_context_pointer context)
+{
+  return 1024;
+}
+
+void tf_rt_set_op_hook(tf_rt_context_pointer context,
+                       const tf_rt_op_hook_t *hook)
+{
+  ((struct model_s *)context)->hook = hook;
+}
+
+/****************************************************************************
+ * Test
+ ****************************************************************************/
+
+/* Replay a push. The propagations it must run are appended to expect. */
+
+static int replay_push(struct replay_s *r, const uint8_t *samples,
+                       uint32_t nsamples, uint32_t window, uint32_t hop,
+                       uint16_t bytes, bool states, struct seen_s *expect)
+{
+  int num = 0;
+  uint32_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      memcpy(r->samples + r->total * bytes, samples + i * bytes, bytes);
+      r->total++;
+
+      if (r->total == window ||
+          (r->total > window && (r->total - window) % hop == 0))
+        {
+          struct seen_s *e = &expect[num++];
+
+          e->hash = hash(r->samples + (r->total - window) * bytes,
+                         window * bytes);
+          e->a = r->a;
+          memset(e->b, r->b, sizeof(e->b));
+
+          /* Without the state tensors the state inputs stay cleared */
+
+          if (states)
+            {
+              r->a.count++;
+              r->a.chain = r->a.chain * 31 + e->hash;
+              r->b++;
+            }
+        }
+    }
+
+  return num;
+}
+
+static void replay_reset(struct replay_s *r)
+{
+  r->total = 0;
+  memset(&r->a, 0, sizeof(r->a));
+  r->b = 0;
+}
+
+static void test_round(int round)
+{
+  static struct seen_s expect[MAX_LOG];
+  struct network_s net;
+  struct replay_s r;
+  tflm_runtime_t rt;
+  tflm_stream_t stream;
+  tflm_stream_config_t config;
+  uint16_t bytes = 1 + rnd() % 7;
+  uint32_t window = 1 + rnd() % ((rnd() % 4) ? 40 : 300);
+  uint32_t hop = 1 + rnd() % (window + 4);
+  bool states = rnd() % 4 != 0;
+  uint8_t *samples;
+  int num;
+  int ret;
+  int p;
+  int i;
+
+  net.window_bytes = window * bytes;
+  if (tflm_runtime_initialize(&rt, &net, sizeof(net)) != 0)
+    {
+      fail(round, "runtime", 0, 0);
+      return;
+    }
+
+  memset(&config, 0, sizeof(config));
+  config.input_index  = IN_WINDOW;
+  config.sample_bytes = bytes;
+  config.hop          = hop;
+  config.state_num    = states ? 2 : 0;
+  config.states       = states ? g_states : NULL;
+
+  /* The state inputs are cleared by the initialization */
+
+  memset(g_model.in[IN_STATE_A], 0xff, g_model.in_size[IN_STATE_A]);
+  memset(g_model.in[IN_STATE_B], 0xff, g_model.in_size[IN_STATE_B]);
+  if (!states)
+    {
+      memset(g_model.in[IN_STATE_A], 0, g_model.in_size[IN_STATE_A]);
+      memset(g_model.in[IN_STATE_B], 0, g_model.in_size[IN_STATE_B]);
+    }
+
+  ret = tflm_stream_initialize(&stream, &rt, &config);
+  if (ret != 0)
+    {
+      fail(round, "initialize", ret, 0);
+      tflm_runtime_finalize(&rt);
+      return;
+    }
+
+  if (stream.window != window)
+    {
+      fail(round, "window", stream.window, window);
+    }
+
+  memset(&r, 0, sizeof(r));
+  r.samples = malloc((size_t)PUSHES * 3 * (window + hop) * bytes);
+  samples = malloc((size_t)3 * (window + hop) * bytes);
+
+  for (p = 0; p < PUSHES; p++)
+    {
+      uint32_t n;
+
+      /* Mostly up to a few hops, sometimes whole windows or nothing */
+
+      switch (rnd() % 8)
+        {
+          case 0:
+            n = rnd() % (3 * window + 1);
+            break;
+
+          case 1:
+            n = 0;
+            break;
+
+          default:
+            n = rnd() % (3 * hop + 1);
+            break;
+        }
+
+      for (i = 0; i < (int)(n * bytes); i++)
+        {
+          samples[i] = rnd();
+        }
+
+      if (rnd() % 40 == 0)
+        {
+          g_fail_at = g_forwards + rnd() % 4;
+        }
+
+      num = replay_push(&r, samples, n, window, hop, bytes, states, expect);
+      g_log_num = 0;
+      ret = tflm_stream_push(&stream, n ? samples : NULL, n);
+
+      if (g_fail_at != ~0ul && g_fail_at < g_forwards)
+        {
+          /* The propagations before the failing one are done */
+
+          num = g_log_num;
+          if (ret != -EIO)
+            {
+              fail(round, "failure not returned", ret, p);
+            }
+        }
+      else if (ret != num)
+        {
+          fail(round, "propagations", ret, num);
+        }
+
+      if (g_log_num != num)
+        {
+          fail(round, "propagations seen", g_log_num, num);
+          num = g_log_num < num ? g_log_num : num;
+        }
+
+      for (i = 0; i < num; i++)
+        {
+          if (g_log[i].hash != expect[i].hash)
+            {
+              fail(round, "window", p, i);
+              break;
+            }
+
+          if (memcmp(&g_log[i].a, &expect[i].a, sizeof(g_log[i].a)) != 0 ||
+              memcmp(g_log[i].b, expect[i].b, sizeof(g_log[i].b)) != 0)
+            {
+              fail(round, "state", g_log[i].a.count, expect[i].a.count);
+              break;
+            }
+        }
+
+      for (i = 0; i < g_model.in_size[IN_OTHER]; i++)
+        {
+          if (g_model.in[IN_OTHER][i] != OTHER_BYTE)
+            {
+              fail(round, "other input changed", p, i);
+              break;
+            }
+        }
+
+      /* Start again after a failure, else now and then */
+
+      if (ret < 0 || rnd() % 10 == 0)
+        {
+          g_fail_at = ~0ul;
+          if (tflm_stream_reset(&stream) != 0)
+            {
+              fail(round, "reset", p, 0);
+            }
+
+          replay_reset(&r);
+        }
+    }
+
+  if (tflm_stream_finalize(&stream) != 0 ||
+      tflm_stream_push(&stream, samples, 1) != -EINVAL)
+    {
+      fail(round, "finalize", 0, 0);
+    }
+
+  free(samples);
+  free(r.samples);
+  tflm_runtime_finalize(&rt);
+}
+
+static void test_invalid(void)
+{
+  static const tflm_stream_state_t bad_states[][1] =
+  {
+    { { OUT_STATE_A, IN_WINDOW } },     /* Window input as state */
+    { { OUTPUT_NUM, IN_STATE_A } },     /* No such output */
+    { { OUT_STATE_A, INPUT_NUM } },     /* No such input */
+    { { OUT_STATE_A, IN_STATE_B } },    /* Sizes differ */
+  };
+
+  struct network_s net;
+  tflm_runtime_t rt;
+  tflm_stream_t stream;
+  tflm_stream_config_t good;
+  tflm_stream_config_t c;
+  uint8_t sample[2];
+  size_t i;
+
+  net.window_bytes = 16;
+  tflm_runtime_initialize(&rt, &net, sizeof(net));
+
+  memset(&good, 0, sizeof(good));
+  good.input_index  = IN_WINDOW;
+  good.sample_bytes = 2;
+  good.hop          = 3;
+  good.state_num    = 2;
+  good.states       = g_states;
+
+  c = good;
+  c.input_index = INPUT_NUM;
+  if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+    {
+      fail(-1, "bad input accepted", 0, 0);
+    }
+
+  c = good;
+  c.sample_bytes = 0;
+  if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+    {
+      fail(-1, "no sample size accepted", 0, 0);
+    }
+
+  c = good;
+  c.sample_bytes = 3;
+  if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+    {
+      fail(-1, "partial sample accepted", 0, 0);
+    }
+
+  c = good;
+  c.hop = 0;
+  if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+    {
+      fail(-1, "no hop accepted", 0, 0);
+    }
+
+  c = good;
+  c.states = NULL;
+  if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+    {
+      fail(-1, "no states accepted", 0, 0);
+    }
+
+  for (i = 0; i < sizeof(bad_states) / sizeof(bad_states[0]); i++)
+    {
+      c = good;
+      c.state_num = 1;
+      c.states = bad_states[i];
+      if (tflm_stream_initialize(&stream, &rt, &c) != -EINVAL)
+        {
+          fail(-1, "bad state accepted", i, 0);
+        }
+    }
+
+  if (tflm_stream_initialize(NULL, &rt, &good) != -EINVAL ||
+      tflm_stream_initialize(&stream, NULL, &good) != -EINVAL ||
+      tflm_stream_initialize(&stream, &rt, NULL) != -EINVAL)
+    {
+      fail(-1, "null accepted", 0, 0);
+    }
+
+  if (tflm_stream_initialize(&stream, &rt, &good) != 0)
+    {
+      fail(-1, "good configuration refused", 0, 0);
+    }
+  else
+    {
+      if (tflm_stream_push(&stream, NULL, 0) != 0 ||
+          tflm_stream_push(&stream, NULL, 1) != -EINVAL ||
+          tflm_stream_push(NULL, sample, 1) != -EINVAL ||
+          tflm_stream_reset(NULL) != -EINVAL)
+        {
+          fail(-1, "null push accepted", 0, 0);
+        }
+
+      tflm_stream_finalize(&stream);
+    }
+
+  tflm_runtime_finalize(&rt);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+#ifdef CONFIG_TFLM_RT_PROFILE
+  static tflm_profile_record_t records[16];
+  tflm_profile_t prof;
+#endif
+  int round;
+
+  g_seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1;
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+  prof.records  = records;
+  prof.capacity = sizeof(records) / sizeof(records[0]);
+  tflm_set_profile(&prof);
+#endif
+
+  test_invalid();
+
+  for (round = 0; round < ROUNDS; round++)
+    {
+      test_round(round);
+    }
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+  /* Failed propagations are counted, but their operators did not end */
+
+  if (prof.forwards != g_forwards || prof.count != g_hooked ||
+      g_hooked != g_forwards - g_failed ||
+      strcmp(records[(prof.count - 1) % prof.capacity].op, "MOCK") != 0)
+    {
+      fail(-1, "profile", prof.forwards, g_forwards);
+    }
+
+  tflm_set_profile(NULL);
+#endif
+
+  printf("%d rounds, %lu propagations, %lu failed, %lu errors\n", ROUNDS,
+         g_forwards, g_failed, g_errors);
+  return g_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -44,11 +44,21 @@
 #include <malloc.h>
 
 #include <tflmrt/runtime.h>
+#include <utils/cyclecount.h>
 
 #include "runtime_common.h"
 
 #include "tf_runtime.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+static tflm_profile_t *g_tflm_profile;
+static uint32_t g_tflm_op_start;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -58,6 +68,96 @@ static void debug_log_printf(const char *s)
   printf(s);
 }
 
+#ifdef CONFIG_TFLM_RT_PROFILE
+static void profile_op_begin(void *arg, int index)
+{
+  g_tflm_op_start = cyclecount_get();
+}
+
+static void profile_op_end(void *arg, int index, const char *tag,
+                           size_t output_bytes)
+{
+  uint32_t cycles = cyclecount_get() - g_tflm_op_start;
+  tflm_profile_t *prof = (tflm_profile_t *)arg;
+  tflm_profile_record_t *rec;
+
+  rec = &prof->records[prof->count % prof->capacity];
+  rec->forward      = prof->forwards;
+  rec->index        = index;
+  rec->op           = tag;
+  rec->cycles       = cycles;
+  rec->output_bytes = output_bytes;
+  prof->count++;
+}
+#endif
+
+static int runtime_forward(tf_rt_context_pointer ctx)
+{
+#ifdef CONFIG_TFLM_RT_PROFILE
+  tflm_profile_t *prof = g_tflm_profile;
+  int ret;
+  tf_rt_op_hook_t hook =
+    {
+      profile_op_begin, profile_op_end, prof
+    };
+
+  if (prof)
+    {
+      prof->forwards++;
+      prof->arena_bytes = tf_rt_arenasize(ctx);
+      tf_rt_set_op_hook(ctx, &hook);
+      ret = tf_rt_forward(ctx);
+      tf_rt_set_op_hook(ctx, NULL);
+      return ret;
+    }
+#endif
+
+  return tf_rt_forward(ctx);
+}
+
+#ifdef CONFIG_TFLM_RT_STREAM
+static void stream_clear_states(tflm_stream_t *stream)
+{
+  tf_rt_context_pointer ctx = stream->rt->impl_ctx;
+  int in;
+  int i;
+
+  for (i = 0; i < stream->config.state_num; i++)
+    {
+      in = stream->config.states[i].input_index;
+      memset(tf_rt_input_buffer(ctx, in), 0, tf_rt_input_size(ctx, in));
+    }
+}
+
+static int stream_forward(tflm_stream_t *stream)
+{
+  tf_rt_context_pointer ctx = stream->rt->impl_ctx;
+  const tflm_stream_state_t *st;
+  int ret;
+  int i;
+
+  memcpy(tf_rt_input_buffer(ctx, stream->config.input_index),
+         stream->ring + stream->head * stream->config.sample_bytes,
+         stream->window * stream->config.sample_bytes);
+
+  ret = runtime_forward(ctx);
+  if (ret != 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < stream->config.state_num; i++)
+    {
+      st = &stream->config.states[i];
+      memcpy(tf_rt_input_buffer(ctx, st->input_index),
+             tf_rt_output_buffer(ctx, st->output_index),
+             tf_rt_input_size(ctx, st->input_index));
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -151,7 +251,7 @@ int tflm_runtime_forward(tflm_runtime_t *rt, const void *inputs[],
              tf_rt_input_size(ctx, i));
     }
 
-  return tf_rt_forward(ctx);
+  return runtime_forward(ctx);
 }
 
 int tflm_runtime_input_num(tflm_runtime_t *rt)
@@ -329,3 +429,233 @@ int tflm_nuttx_mallinfo(tflm_mallinfo_t *info)
 
   return 0;
 }
+
+#ifdef CONFIG_TFLM_RT_STREAM
+int tflm_stream_initialize(tflm_stream_t *stream, tflm_runtime_t *rt,
+                           const tflm_stream_config_t *config)
+{
+  tf_rt_context_pointer ctx;
+  const tflm_stream_state_t *st;
+  int size;
+  int i;
+
+  if (!stream || !rt || !rt->impl_ctx || !config)
+    {
+      tflm_err("stream, rt or config is null.\n");
+      return -EINVAL;
+    }
+
+  ctx = (tf_rt_context_pointer) rt->impl_ctx;
+  if (config->input_index >= tf_rt_num_of_input(ctx) ||
+      config->sample_bytes == 0 || config->hop == 0 ||
+      (config->state_num > 0 && !config->states))
+    {
+      tflm_err("invalid stream configuration.\n");
+      return -EINVAL;
+    }
+
+  size = tf_rt_input_size(ctx, config->input_index);
+  if (size % config->sample_bytes != 0)
+    {
+      tflm_err("input size %d is not a multiple of %u.\n",
+               size, config->sample_bytes);
+      return -EINVAL;
+    }
+
+  for (i = 0; i < config->state_num; i++)
+    {
+      st = &config->states[i];
+      if (st->input_index >= tf_rt_num_of_input(ctx) ||
+          st->output_index >= tf_rt_num_of_output(ctx) ||
+          st->input_index == config->input_index ||
+          tf_rt_input_size(ctx, st->input_index) !=
+          tf_rt_output_size(ctx, st->output_index))
+        {
+          tflm_err("state %d does not match the model.\n", i);
+          return -EINVAL;
+        }
+    }
+
+  /* Every sample is stored twice, window samples apart, so the newest
+   * window is always contiguous and is copied with a single memcpy().
+   */
+
+  stream->ring = (uint8_t *)malloc(2 * size);
+  if (!stream->ring)
+    {
+      return -ENOMEM;
+    }
+
+  stream->rt     = rt;
+  stream->config = *config;
+  stream->window = size / config->sample_bytes;
+
+  return tflm_stream_reset(stream);
+}
+
+int tflm_stream_finalize(tflm_stream_t *stream)
+{
+  if (!stream)
+    {
+      tflm_err("stream is null.\n");
+      return -EINVAL;
+    }
+
+  free(stream->ring);
+  stream->ring = NULL;
+
+  return 0;
+}
+
+int tflm_stream_push(tflm_stream_t *stream, const void *samples,
+                     uint32_t nsamples)
+{
+  const uint8_t *src = (const uint8_t *)samples;
+  uint16_t bytes;
+  uint32_t window;
+  uint32_t tail;
+  uint32_t n;
+  int count = 0;
+  int ret;
+
+  if (!stream || !stream->ring || (!samples && nsamples > 0))
+    {
+      tflm_err("stream or samples is null.\n");
+      return -EINVAL;
+    }
+
+  bytes  = stream->config.sample_bytes;
+  window = stream->window;
+
+  while (nsamples > 0)
+    {
+      /* Copy up to the next forward propagation or the end of the first
+       * copy of the ring, whichever comes first. head stays 0 until the
+       * window is full, so this also stops when it becomes full.
+       */
+
+      tail = (stream->head + stream->filled) % window;
+      n = window - tail;
+      if (stream->filled == window &&
+          n > stream->config.hop - stream->pending)
+        {
+          n = stream->config.hop - stream->pending;
+        }
+
+      if (n > nsamples)
+        {
+          n = nsamples;
+        }
+
+      memcpy(stream->ring + tail * bytes, src, n * bytes);
+      memcpy(stream->ring + (tail + window) * bytes, src, n * bytes);
+      src      += n * bytes;
+      nsamples -= n;
+
+      if (stream->filled < window)
+        {
+          stream->filled += n;
+          if (stream->filled < window)
+            {
+              continue;
+            }
+
+          /* The first full window is always propagated */
+
+          stream->pending = stream->config.hop;
+        }
+      else
+        {
+          stream->head = (stream->head + n) % window;
+          stream->pending += n;
+        }
+
+      if (stream->pending >= stream->config.hop)
+        {
+          stream->pending = 0;
+          ret = stream_forward(stream);
+          if (ret != 0)
+            {
+              return ret;
+            }
+
+          count++;
+        }
+    }
+
+  return count;
+}
+
+int tflm_stream_reset(tflm_stream_t *stream)
+{
+  if (!stream || !stream->ring)
+    {
+      tflm_err("stream is null.\n");
+      return -EINVAL;
+    }
+
+  stream->head    = 0;
+  stream->filled  = 0;
+  stream->pending = 0;
+  stream_clear_states(stream);
+
+  return 0;
+}
+#endif /* CONFIG_TFLM_RT_STREAM */
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+int tflm_set_profile(tflm_profile_t *profile)
+{
+  if (profile)
+    {
+      if (!profile->records || profile->capacity == 0)
+        {
+          tflm_err("profile ring is empty.\n");
+          return -EINVAL;
+        }
+
+      profile->count       = 0;
+      profile->forwards    = 0;
+      profile->arena_bytes = 0;
+
+      cyclecount_enable();
+    }
+
+  g_tflm_profile = profile;
+  return 0;
+}
+
+tflm_profile_t *tflm_get_profile(void)
+{
+  return g_tflm_profile;
+}
+
+int tflm_profile_export_csv(const tflm_profile_t *profile, FILE *stream)
+{
+  const tflm_profile_record_t *rec;
+  uint32_t num;
+  uint32_t i;
+
+  if (!profile || !stream)
+    {
+      tflm_err("profile or stream is null.\n");
+      return -EINVAL;
+    }
+
+  num = profile->count < profile->capacity ?
+        profile->count : profile->capacity;
+
+  fprintf(stream, "forward,index,op,cycles,output_bytes\n");
+  for (i = profile->count - num; i != profile->count; i++)
+    {
+      rec = &profile->records[i % profile->capacity];
+      fprintf(stream, "%lu,%u,%s,%lu,%lu\n",
+              (unsigned long)rec->forward, rec->index,
+              rec->op ? rec->op : "",
+              (unsigned long)rec->cycles,
+              (unsigned long)rec->output_bytes);
+    }
+
+  return (int)num;
+}
+#endif /* CONFIG_TFLM_RT_PROFILE */
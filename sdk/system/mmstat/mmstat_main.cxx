@@ -0,0 +1,165 @@
+/****************************************************************************
+ * system/mmstat/mmstat_main.cxx
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "memutils/memory_manager/MemManager.h"
+
+using namespace MemMgrLite;
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* PoolId::pool is a 6 bit field, ID 0 is reserved */
+
+#define MMSTAT_MAX_POOL_ID  63
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname)
+{
+  printf("Usage: %s [-s nsections] [-r] [-p]\n", progname);
+  printf("  -s: Number of memory sections to show, up to 4 (default 1)\n");
+  printf("      Only the sections given to Manager::initPerCpu() are shown\n");
+  printf("  -r: Reset the counters after showing them\n");
+  printf("  -p: Print \"section id peak\" lines for mem_layout.py --peaks\n");
+}
+
+static void show_pool(PoolId id, FAR const PoolStats *st)
+{
+  uint32_t alloc_avg = st->allocs ? st->alloc_time_sum / st->allocs : 0;
+  uint32_t free_avg  = st->frees ? st->free_time_sum / st->frees : 0;
+
+  printf("%3d %3d %5d %5d %5d %9lu %6lu %8lu %8lu %8lu %8lu\n",
+         id.sec, id.pool, Manager::getPoolNumSegs(id), st->used, st->peak,
+         (unsigned long)st->allocs, (unsigned long)st->alloc_fails,
+         (unsigned long)st->alloc_time_max, (unsigned long)alloc_avg,
+         (unsigned long)st->free_time_max, (unsigned long)free_avg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+extern "C" int main(int argc, FAR char *argv[])
+{
+  PoolStats stats;
+  PoolId id;
+  bool reset = false;
+  bool peaks = false;
+  int nsections = 1;
+  int sec;
+  int pool;
+  int opt;
+  err_t err;
+
+  while ((opt = getopt(argc, argv, "s:rph")) != ERROR)
+    {
+      switch (opt)
+        {
+          case 's':
+            nsections = atoi(optarg);
+            break;
+          case 'r':
+            reset = true;
+            break;
+          case 'p':
+            peaks = true;
+            break;
+          default:
+            show_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+  if (nsections < 1 || nsections > 4)
+    {
+      show_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+
+  if (!peaks)
+    {
+      printf("sec  id  segs  used  peak    allocs  fails"
+             " allocmax allocavg  freemax  freeavg\n");
+    }
+
+  for (sec = 0; sec < nsections; sec++)
+    {
+      for (pool = 1; pool <= MMSTAT_MAX_POOL_ID; pool++)
+        {
+          id.sec  = sec;
+          id.pool = pool;
+
+          err = Manager::getPoolStats(id, &stats);
+          if (err == ERR_STS)
+            {
+              printf("Memory manager is not initialized\n");
+              return EXIT_FAILURE;
+            }
+          else if (err != ERR_OK)
+            {
+              continue;
+            }
+
+          if (peaks)
+            {
+              printf("%d %d %d\n", id.sec, id.pool, stats.peak);
+            }
+          else
+            {
+              show_pool(id, &stats);
+            }
+
+          if (reset)
+            {
+              Manager::resetPoolStats(id);
+            }
+        }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * system/nnprof/nnprof_main.c
+ *
+ *   Copyright 2023 Sony Semiconductor Solutions Corporation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of Sony Semiconductor Solutions Corporation nor
+ *    the names of its contributors may be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sdk/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifdef CONFIG_DNN_RT_PROFILE
+#  include <dnnrt/runtime.h>
+#endif
+#ifdef CONFIG_TFLM_RT_PROFILE
+#  include <tflmrt/runtime.h>
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname)
+{
+  printf("Usage: %s [-c] [-r]\n", progname);
+  printf("  -c: Print the records as CSV\n");
+  printf("  -r: Clear the records after showing them\n");
+}
+
+#ifdef CONFIG_DNN_RT_PROFILE
+static void show_dnn(FAR dnn_profile_t *prof, bool csv)
+{
+  FAR const dnn_profile_record_t *rec;
+  uint32_t total = 0;
+  uint32_t num;
+  uint32_t i;
+
+  if (csv)
+    {
+      dnn_profile_export_csv(prof, stdout);
+      return;
+    }
+
+  num = prof->count < prof->capacity ? prof->count : prof->capacity;
+
+  printf("dnnrt: %lu forwards, %lu of %lu records\n",
+         (unsigned long)prof->forwards, (unsigned long)num,
+         (unsigned long)prof->count);
+  printf("forward index type     cycles  scratch   output\n");
+
+  for (i = prof->count - num; i != prof->count; i++)
+    {
+      rec = &prof->records[i % prof->capacity];
+      printf("%7lu %5u %4u %10lu %8lu %8lu\n",
+             (unsigned long)rec->forward, rec->index, rec->type,
+             (unsigned long)rec->cycles,
+             (unsigned long)rec->scratch_bytes,
+             (unsigned long)rec->output_bytes);
+
+      if (rec->forward == prof->forwards)
+        {
+          total += rec->cycles;
+        }
+    }
+
+  printf("last forward: %lu cycles\n", (unsigned long)total);
+}
+#endif
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+static void show_tflm(FAR tflm_profile_t *prof, bool csv)
+{
+  FAR const tflm_profile_record_t *rec;
+  uint32_t total = 0;
+  uint32_t num;
+  uint32_t i;
+
+  if (csv)
+    {
+      tflm_profile_export_csv(prof, stdout);
+      return;
+    }
+
+  num = prof->count < prof->capacity ? prof->count : prof->capacity;
+
+  printf("tflmrt: %lu forwards, %lu of %lu records, arena %lu bytes\n",
+         (unsigned long)prof->forwards, (unsigned long)num,
+         (unsigned long)prof->count, (unsigned long)prof->arena_bytes);
+  printf("forward index op                       cycles   output\n");
+
+  for (i = prof->count - num; i != prof->count; i++)
+    {
+      rec = &prof->records[i % prof->capacity];
+      printf("%7lu %5u %-20s %10lu %8lu\n",
+             (unsigned long)rec->forward, rec->index,
+             rec->op ? rec->op : "-",
+             (unsigned long)rec->cycles,
+             (unsigned long)rec->output_bytes);
+
+      if (rec->forward == prof->forwards)
+        {
+          total += rec->cycles;
+        }
+    }
+
+  printf("last forward: %lu cycles\n", (unsigned long)total);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  bool found = false;
+  bool reset = false;
+  bool csv = false;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "crh")) != ERROR)
+    {
+      switch (opt)
+        {
+          case 'c':
+            csv = true;
+            break;
+          case 'r':
+            reset = true;
+            break;
+          default:
+            show_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifdef CONFIG_DNN_RT_PROFILE
+  FAR dnn_profile_t *dnn = dnn_get_profile();
+  if (dnn)
+    {
+      show_dnn(dnn, csv);
+      if (reset)
+        {
+          dnn_set_profile(dnn);
+        }
+
+      found = true;
+    }
+#endif
+
+#ifdef CONFIG_TFLM_RT_PROFILE
+  FAR tflm_profile_t *tflm = tflm_get_profile();
+  if (tflm)
+    {
+      show_tflm(tflm, csv);
+      if (reset)
+        {
+          tflm_set_profile(tflm);
+        }
+
+      found = true;
+    }
+#endif
+
+  if (!found)
+    {
+      printf("No profile ring is set\n");
+      return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -84,8 +84,9 @@ EnableOutputMacro = False
 # Constants
 #
 
-Basic   = "BasicType"
-RingBuf = "RingBufType"
+Basic     = "BasicType"
+RingBuf   = "RingBufType"
+SizeClass = "SizeClassType"
 
 MinNameSize   = 3
 FenceSize     = 4
@@ -93,6 +94,7 @@ MinAlign      = 4
 MaxPoolId     = 255  # Max pool ID including dynamically generated pool
 MaxSegs       = 65535 if UseOver255Segments else 255
 RemainderSize = -1
+MaxSizeClasses = 8
 
 AREA_FENCES_IS_KCONFIG = True
 
@@ -110,6 +112,27 @@ IsNotUsedshareMemory = False
 
 MemoryPoolAreaName = "StaticMemoryPoolArea"
 
+# Per-CPU segment cache slots of the lock-free pool (--cpu_cache_slots)
+# CONFIG_SMP_NCPUS * CONFIG_MEMUTILS_MEMORY_MANAGER_CPU_CACHE
+
+CpuCacheSlots = 0
+
+# Pool usage statistics (--pool_stats)
+# Set with CONFIG_MEMUTILS_MEMORY_MANAGER_STATS
+
+UsePoolStats = False
+
+# Size class pools (--size_class_pool)
+# Set with CONFIG_MEMUTILS_MEMORY_MANAGER_SIZECLASS_POOL, a layout with a
+# SizeClassType pool sets it too.
+
+UseSizeClassPool = False
+
+# Observed peaks (--peaks), {(section, pool_id): peak}
+
+PoolPeaks      = None
+PoolPeakMargin = 1
+
 #
 # class and method
 #
@@ -463,10 +486,16 @@ class PoolEntry(BaseEntry):
         super().__init__(name, addr, size)
 
 
+# A list of (seg_size, num_segs) as the pool size defines a size class
+# pool, seg must then be the total number of segments.
+
 class PoolEntryFixParam(BaseEntry):
     def __init__(self, section, layout_no, name, area, align, size, seg, fence):
+        global UseSizeClassPool
+
         self.area_entry = FixedAreas.at(area)
         self.type       = Basic
+        self.classes    = None
         self.align      = align
         self.num_seg    = seg
         self.skip_size  = 0
@@ -493,6 +522,27 @@ class PoolEntryFixParam(BaseEntry):
         if align >= self.area_entry.last_addr:
             sys.stderr.write("Too big pool align at {0}".format(name))
             sys.exit()
+        if isinstance(size, (list, tuple)):
+            self.type    = SizeClass
+            self.classes = list(size)
+            if len(self.classes) == 0 or len(self.classes) > MaxSizeClasses:
+                sys.stderr.write("Bad number of size classes found at {0}".format(name))
+                sys.exit()
+            prev_size = 0
+            for seg_size, num_segs in self.classes:
+                if (seg_size % MinAlign) != 0 or seg_size <= prev_size or num_segs <= 0:
+                    sys.stderr.write("Bad size class found at {0}".format(name))
+                    sys.exit()
+                prev_size = seg_size
+            if seg != sum(n for s, n in self.classes):
+                sys.stderr.write("Bad pool seg found at {0}".format(name))
+                sys.exit()
+            size = sum(s * n for s, n in self.classes)
+
+            # PoolAttr has the classes pointer
+
+            UseSizeClassPool = True
+            update_pool_data_size()
         if size != RemainderSize:
             if (size % MinAlign) != 0 or size == 0:
                 sys.stderr.write("Bad pool size found at {0}".format(name))
@@ -518,23 +568,78 @@ class PoolEntryFixParam(BaseEntry):
 
 # When creating a memory pool, the necessary work area size for each pool
 #  - Alignment adjustment of MemPool area         : 0-3
-#  - Pool attribute area(Usually in static pool 0): 0, 12 or 16
+#  - Pool attribute area(Usually in static pool 0): 0, 12, 16 or 20
 #  - BasicPool(=MemPool) area                      : 12 + 4 * sizeof(NumSeg)
+#  - Per-CPU cache pointer and slots               : 0 or 4 + CpuCacheSlots * sizeof(NumSeg)
+#  - Usage statistics                              : 0 or 32
 #  - RingBufPool area                              : To be determined(MemPool Area+alpha)
+#  - SizeClassPool area                            : MemPool area + 8 + 16 * number of classes
 #  - Data area of the segment number queue         : Number of segments * sizeof(NumSeg)
 #  - Reference counter area                        : Number of segments * sizeof(SegRefCnt)
 
 NumSegSize              = 2 if UseOver255Segments else 1
 SegRefCntSize           = 1
-PoolAttrSize            = round_up(10 + NumSegSize + (1 if UseFence else 0) + (1 if UseMultiCore else 0), 4)
-MemPoolDataSize         = 12 + 4 * NumSegSize   # 16 or 20
-BasicPoolDataSize       = MemPoolDataSize
-RingBufPoolDataSize     = MemPoolDataSize + 32  # Tentative value for details unexamined
 RingBufPoolSegDataSize  = 8                     # Tentative value for details unexamined
 
+# Depends on the command line options, set by update_pool_data_size()
+
+def update_pool_data_size():
+    global PoolAttrSize, MemPoolDataSize, BasicPoolDataSize, RingBufPoolDataSize
+    global SizeClassPoolDataSize, SizeClassDataSize
+    PoolAttrSize        = round_up(10 + NumSegSize + (1 if UseFence else 0) + (1 if UseMultiCore else 0), 4)
+    if UseSizeClassPool:
+        PoolAttrSize    += 4                    # Size classes pointer
+    MemPoolDataSize     = 12 + 4 * NumSegSize   # 16 or 20
+    if CpuCacheSlots > 0:
+        MemPoolDataSize += 4 + CpuCacheSlots * NumSegSize
+    if UsePoolStats:
+        MemPoolDataSize += 32
+    BasicPoolDataSize   = MemPoolDataSize
+    RingBufPoolDataSize = MemPoolDataSize + 32  # Tentative value for details unexamined
+    SizeClassPoolDataSize = MemPoolDataSize + 8
+    SizeClassDataSize     = 16
+
+update_pool_data_size()
+
+# Read "section pool_id peak" lines as printed by "mmstat -p".
+# Several runs may be concatenated, the largest peak is kept.
+
+def load_pool_peaks(filename):
+    peaks = {}
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if line == "" or line.startswith("#"):
+                continue
+            try:
+                sec, id, peak = [int(v) for v in line.split()]
+            except ValueError:
+                sys.stderr.write("Bad line found in {0}: {1}\n".format(filename, line))
+                sys.exit()
+            peaks[(sec, id)] = max(peaks.get((sec, id), 0), peak)
+    return peaks
+
+# Reduce the number of segments of a fixed size pool to the observed peak.
+# The segment size is kept.
+
+def trim_pool_arg(section, layout_no, id, arg):
+    name, area, align, size, seg, fence = arg
+    peak = PoolPeaks.get((section, id))
+    if peak is None or not isinstance(size, int) or size == RemainderSize:
+        return arg
+
+    new_seg = min(max(peak + PoolPeakMargin, 1), seg)
+    if new_seg == seg:
+        return arg
+
+    new_size = round_up((size // seg) * new_seg, MinAlign)
+    sys.stderr.write("Trim S{0} L{1} {2}: seg {3} -> {4} (peak {5}), size 0x{6:x} -> 0x{7:x}\n".format(section, layout_no, name, seg, new_seg, peak, size, new_size))
+    return (name, area, align, new_size, new_seg, fence)
+
 
 class PoolLayout:
     section = 0
+    id_names = {}  # Pool names of each section in the order of their IDs
     def __init__(self, section, layout_no, *args):
         if section == self.section:
             FixedAreas.reset_areas()
@@ -552,6 +657,11 @@ class PoolLayout:
 
     def check_and_set_arg(self, section, layout_no, *arg):
         if UseFixedPoolLayout:
+            names = self.id_names.setdefault(section, [])
+            if arg[0] not in names:
+                names.append(arg[0])
+            if PoolPeaks is not None:
+                arg = trim_pool_arg(section, layout_no, names.index(arg[0]) + 1, arg)
             new_pool = PoolEntryFixParam(section, layout_no, *arg)
         else:
             new_pool = PoolEntry(*arg)
@@ -568,7 +678,12 @@ class PoolLayout:
         for pool in self.pools:
             if section == pool.section:
                 pool_work_size  = PoolAttrSize if UseCopiedPoolAttr else 0
-                pool_work_size += BasicPoolDataSize if pool.type == Basic else RingBufPoolDataSize
+                if pool.type == Basic:
+                    pool_work_size += BasicPoolDataSize
+                elif pool.type == SizeClass:
+                    pool_work_size += SizeClassPoolDataSize + len(pool.classes) * SizeClassDataSize
+                else:
+                    pool_work_size += RingBufPoolDataSize
                 pool_work_size += pool.num_seg * NumSegSize    # Data area of the segment number queue
                 pool_work_size += pool.num_seg * SegRefCntSize # Reference counter area
 
@@ -719,6 +834,10 @@ class PoolAreas:
                 io.write("#define S{0}_L{1}_{2}_NUM_SEG  0x{3:08x}\n".format(pool.section, pool.layout, pool.name, pool.num_seg))
                 if pool.type == Basic:
                     io.write("#define S{0}_L{1}_{2}_SEG_SIZE 0x{3:08x}\n".format(pool.section, pool.layout, pool.name, int(pool.size / pool.num_seg)))
+                elif pool.type == SizeClass:
+                    for num, (seg_size, num_segs) in enumerate(pool.classes):
+                        io.write("#define S{0}_L{1}_{2}_CLASS{3}_SEG_SIZE 0x{4:08x}\n".format(pool.section, pool.layout, pool.name, num, seg_size))
+                        io.write("#define S{0}_L{1}_{2}_CLASS{3}_NUM_SEG  0x{4:08x}\n".format(pool.section, pool.layout, pool.name, num, num_segs))
                 io.write("\n")
             for name_remainder in layout.used_area_info:
                 io.write("/* Remainder {0}=0x{1:08x} */\n".format(name_remainder[0], name_remainder[1]))
@@ -739,6 +858,14 @@ class PoolAreas:
             io.write("  NUM_MEM_S{}_POOLS,\n".format(num))
         io.write("};\n")
 
+        for layout in self.layouts:
+            for pool in layout.pools:
+                if pool.type == SizeClass:
+                    io.write("const SizeClassAttr S%d_L%d_%s_CLASSES[] = {\n" % (pool.section, pool.layout, pool.name))
+                    for seg_size, num_segs in pool.classes:
+                        io.write("  { 0x%08x, %3u },\n" % (seg_size, num_segs))
+                    io.write("  { 0, 0 },\n};\n\n")
+
         io.write("extern const PoolSectionAttr MemoryPoolLayouts[NUM_MEM_SECTIONS][NUM_MEM_LAYOUTS][%d] = {\n" % (self.max_pool_num() + 1))
         for num in range(self.section):
             io.write("  {  /* Section:%d */\n" % num)
@@ -762,6 +889,8 @@ class PoolAreas:
                             io.write(", (PoolAddr){0} + 0x{1:08x}, 0x{2:08x}".format(MemoryPoolAreaName, pool.begin_addr, pool.size))
                         else:
                             io.write(", 0x{0:08x}, 0x{1:08x}".format(pool.begin_addr, pool.size))
+                        if pool.type == SizeClass:
+                            io.write(", S%d_L%d_%s_CLASSES" % (pool.section, pool.layout, pool.name))
                         io.write(" },  /* %s */\n" % (pool.area_entry.name))
                     io.write("      { S%d_NULL_POOL, 0, 0, false, 0, 0 },\n" % (layout.section))
                     io.write("    },\n")
@@ -896,8 +1025,16 @@ def generate_files():
 
 def usage():
     print("usage: {} [--not_shared_memory | -n] [--help | -h]".format(sys.argv[0]))
+    print("                       [--cpu_cache_slots N] [--pool_stats]")
+    print("                       [--size_class_pool]")
+    print("                       [--peaks file] [--peak_margin N]")
     print("                       [mem_layout] [fixed_fence] [pool_layout]\n")
     print("-n, --not_shared_memory  Layout creation without using shared memory")
+    print("--cpu_cache_slots N      Per-CPU cache slots of the lock-free pool")
+    print("--pool_stats             Pool usage statistics are enabled")
+    print("--size_class_pool        Size class pools are enabled")
+    print("--peaks file             Trim pools to the peaks printed by 'mmstat -p'")
+    print("--peak_margin N          Segments kept above the peak (default 1)")
     print("-h, --help               Show this usage and exit")
     sys.exit()
 
@@ -907,7 +1044,8 @@ def usage():
 
 try:
     shortopt = "hn"
-    longopt  = ["help", "not_shared_memory"]
+    longopt  = ["help", "not_shared_memory", "cpu_cache_slots=", "pool_stats",
+                "size_class_pool", "peaks=", "peak_margin="]
     opts, args = getopt.getopt(sys.argv[1:], shortopt, longopt)
 except getopt.GetoptError as err:
     print(err)
@@ -916,9 +1054,21 @@ except getopt.GetoptError as err:
 for o, a in opts:
     if o in ('-n', '--not_shared_memory'):
         IsNotUsedshareMemory = True
+    elif o == '--cpu_cache_slots':
+        CpuCacheSlots = int(a)
+    elif o == '--pool_stats':
+        UsePoolStats = True
+    elif o == '--size_class_pool':
+        UseSizeClassPool = True
+    elif o == '--peaks':
+        PoolPeaks = load_pool_peaks(a)
+    elif o == '--peak_margin':
+        PoolPeakMargin = int(a)
     elif o in ('-h', '--help'):
         usage()
 
+update_pool_data_size()
+
 if len(args):
     MemLayout   = args[0]
     args.pop(0)